@@ -3,8 +3,8 @@
 
    \file       main.c
    
-   \version    V0.3
-   \date       28.08.14
+   \version    V0.4
+   \date       17.10.26
    \brief      Demonstration of tag pinting code
    
    \copyright  (c) UCL / Dr. Andrew C. R. Martin 1988-2014
@@ -51,6 +51,8 @@
 -  V0.3  28.08.14 Bugfix: added missing global and prototype.
                   Added pdb write functions and option of output pdb or 
                   pdbml. Removed gPDBTagWrite : CTP
+-  V0.4  17.10.26 pdbtagvars.c and pdbtagvars.h are now part of the
+                  library   By: ACRM
 
 *************************************************************************/
 /* Includes
@@ -63,7 +65,7 @@
 #include "bioplib/pdb.h"
 #include "bioplib/macros.h"
 
-#include "pdbtagvars.h"
+#include "bioplib/pdbtagvars.h"
 
 
 /************************************************************************/
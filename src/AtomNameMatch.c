@@ -3,11 +3,11 @@
 
    \file       AtomNameMatch.c
    
-   \version    V1.8
-   \date       07.07.14
+   \version    V1.9
+   \date       17.10.26
    \brief      Tests for matching atom names with wild cards
    
-   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1993-9
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1993-2026
    \author     Dr. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -60,6 +60,10 @@
                   default blank chain name is used). Allows negative 
                   residue numbers
 -  V1.8  07.07.14 Use bl prefix for functions By: CTP
+-  V1.9  17.10.26 Added blCompileAtomNamePattern(), 
+                  blMatchAtomNamePattern(), blMatchAtomNamePatternPDB()
+                  and blFindAtomNamePattern(). % now works as a single
+                  character wildcard as documented   By: ACRM
 
 *************************************************************************/
 /* Doxygen
@@ -81,6 +85,20 @@
    Normally it checks against the second character onwards unless the
    spec starts with a < in which case it checks from the beginning of
    the string.
+
+   #FUNCTION  blCompileAtomNamePattern()
+   Compiles an atom name specification into a fixed mask and value so
+   that it can be tested against many atoms without being re-parsed
+
+   #FUNCTION  blMatchAtomNamePattern()
+   Tests an atom name against a compiled specification
+
+   #FUNCTION  blMatchAtomNamePatternPDB()
+   Tests the atom name of a PDB record against a compiled specification
+
+   #FUNCTION  blFindAtomNamePattern()
+   Finds the first atom in a range of a PDB linked list which matches a
+   compiled specification
 */
 /************************************************************************/
 /* Includes
@@ -104,6 +122,7 @@
 /************************************************************************/
 /* Prototypes
 */
+static BOOL MatchField(char *field, ATOMNAMEPATTERN *pattern);
 
 /************************************************************************/
 /*>BOOL blAtomNameMatch(char *atnam, char *spec, BOOL *ErrorWarn)
@@ -133,8 +152,13 @@
                 O5\* matches an atom called O5*
                 ?B* matches all beta atoms
 
+   To test the same specification against many atoms, 
+   blCompileAtomNamePattern() and blMatchAtomNamePattern() are much
+   faster.
+
 -  23.07.96 Original   By: ACRM
 -  07.07.14 Use bl prefix for functions By: CTP
+-  17.10.26 % now matches a single character   By: ACRM
 */
 BOOL blAtomNameMatch(char *atnam, char *spec, BOOL *ErrorWarn)
 {
@@ -153,8 +177,10 @@ BOOL blAtomNameMatch(char *atnam, char *spec, BOOL *ErrorWarn)
          specp++;
          break;
       case '?':
+      case '%':
          /* A query in the specification matches anything, so just
             continue
+            17.10.26 Added % as documented
          */
          continue;
       case '*':
@@ -265,6 +291,219 @@ BOOL blAtomNameRawMatch(char *atnam, char *spec, BOOL *ErrorWarn)
    return(blAtomNameMatch(atnam, spec, ErrorWarn));
 }
 
+/************************************************************************/
+/*>BOOL blCompileAtomNamePattern(char *spec, BOOL raw, 
+                                 ATOMNAMEPATTERN *pattern)
+   -------------------------------------------------------
+*//**
+
+   \param[in]     *spec      The atom specification
+   \param[in]     raw        Match against the raw atom name as
+                             blAtomNameRawMatch() does
+   \param[out]    *pattern   The compiled specification
+   \return                   FALSE if the specification is too long to
+                             be compiled
+
+   Compiles an atom name specification, with the same wildcards and
+   escapes as blAtomNameMatch() (or blAtomNameRawMatch() if raw is 
+   set), into a mask and value for each of the first 
+   ATOMNAMEPATTERN_SIZE bytes of the atom name. An atom name then 
+   matches if (name[i] ^ value[i]) & mask[i] is zero for every byte,
+   which needs no branches and no re-parsing of the specification.
+
+   Wildcards give a zero mask. The end of the specification must be
+   followed by a space or the end of the atom name: these differ only
+   in bit 5 so are tested with a mask of 0xDF and a value of 0.
+
+   Errors (characters following a *) are ignored as they are by 
+   blAtomNameMatch() when ErrorWarn is NULL. Specifications that would
+   need to test beyond ATOMNAMEPATTERN_SIZE bytes can't be compiled;
+   blAtomNameMatch() must be used for these.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blCompileAtomNamePattern(char *spec, BOOL raw, 
+                              ATOMNAMEPATTERN *pattern)
+{
+   int pos = 0;
+
+   memset(pattern, 0, sizeof(ATOMNAMEPATTERN));
+   pattern->raw = raw;
+
+   /* Raw names are tested from the second character unless the spec
+      starts with a <
+   */
+   if(raw)
+   {
+      if(*spec == '<')
+         spec++;
+      else
+         pos = 1;
+   }
+
+   for(; ; spec++, pos++)
+   {
+      if(pos >= ATOMNAMEPATTERN_SIZE)
+         return(FALSE);
+
+      switch(*spec)
+      {
+      case '\0':
+         /* End of the spec - atom name must have ended too             */
+         pattern->mask[pos]  = (UBYTE)0xDF;
+         pattern->value[pos] = (UBYTE)0;
+         pattern->nbytes     = pos+1;
+         return(TRUE);
+      case '*':
+         /* Matches the rest of the name                                */
+         pattern->nbytes = pos;
+         return(TRUE);
+      case '?':
+      case '%':
+         /* Matches any character                                       */
+         continue;
+      case '\\':
+         /* Escapes the next character                                  */
+         spec++;
+         break;
+      default:
+         break;
+      }
+
+      pattern->mask[pos]  = (UBYTE)0xFF;
+      pattern->value[pos] = (UBYTE)(*spec);
+
+      /* A space (or an escaped end of string) ends the match           */
+      if((*spec == ' ') || (*spec == '\0'))
+      {
+         pattern->nbytes = pos+1;
+         return(TRUE);
+      }
+   }
+}
+
+
+/************************************************************************/
+/*>static BOOL MatchField(char *field, ATOMNAMEPATTERN *pattern)
+   -------------------------------------------------------------
+*//**
+
+   \param[in]     *field     An atom name field of a PDB record
+   \param[in]     *pattern   Compiled specification
+   \return                   Does the name match?
+
+   Compares all ATOMNAMEPATTERN_SIZE bytes of the field. The loop has
+   a fixed length and no branches so the compiler can unroll and 
+   vectorize it.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL MatchField(char *field, ATOMNAMEPATTERN *pattern)
+{
+   UBYTE diff = 0;
+   int   i;
+
+   for(i=0; i<ATOMNAMEPATTERN_SIZE; i++)
+      diff |= (UBYTE)(((UBYTE)field[i] ^ pattern->value[i]) & 
+                      pattern->mask[i]);
+   return(diff == 0);
+}
+
+
+/************************************************************************/
+/*>BOOL blMatchAtomNamePattern(char *atnam, ATOMNAMEPATTERN *pattern)
+   ------------------------------------------------------------------
+*//**
+
+   \param[in]     *atnam     The atom name to test
+   \param[in]     *pattern   Specification compiled with
+                             blCompileAtomNamePattern()
+   \return                   Does the name match?
+
+   Tests an atom name against a compiled specification. Gives the same
+   result as blAtomNameMatch() or blAtomNameRawMatch() with the 
+   original specification. pattern->nbytes bytes of atnam are read 
+   (at most ATOMNAMEPATTERN_SIZE), so the atnam and atnam_raw fields
+   of a PDB record can always be used.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blMatchAtomNamePattern(char *atnam, ATOMNAMEPATTERN *pattern)
+{
+   UBYTE diff = 0;
+   int   i;
+
+   for(i=0; i<pattern->nbytes; i++)
+      diff |= (UBYTE)(((UBYTE)atnam[i] ^ pattern->value[i]) & 
+                      pattern->mask[i]);
+   return(diff == 0);
+}
+
+
+/************************************************************************/
+/*>BOOL blMatchAtomNamePatternPDB(PDB *p, ATOMNAMEPATTERN *pattern)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in]     *p         PDB record
+   \param[in]     *pattern   Specification compiled with
+                             blCompileAtomNamePattern()
+   \return                   Does the atom name match?
+
+   Tests the atom name (or the raw atom name if the pattern was 
+   compiled with raw set) of a PDB record
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blMatchAtomNamePatternPDB(PDB *p, ATOMNAMEPATTERN *pattern)
+{
+   return(MatchField(pattern->raw ? p->atnam_raw : p->atnam, pattern));
+}
+
+
+/************************************************************************/
+/*>PDB *blFindAtomNamePattern(PDB *start, PDB *stop, 
+                              ATOMNAMEPATTERN *pattern)
+   ----------------------------------------------------
+*//**
+
+   \param[in]     *start     First atom to test
+   \param[in]     *stop      Atom after the last one to test (NULL for
+                             the end of the list)
+   \param[in]     *pattern   Specification compiled with
+                             blCompileAtomNamePattern()
+   \return                   First matching atom or NULL
+
+   Finds the first atom in part of a linked list (typically a residue)
+   whose name matches a compiled specification
+
+-  17.10.26 Original   By: ACRM
+*/
+PDB *blFindAtomNamePattern(PDB *start, PDB *stop, 
+                           ATOMNAMEPATTERN *pattern)
+{
+   PDB *p;
+
+   if(pattern->raw)
+   {
+      for(p=start; p!=stop; NEXT(p))
+      {
+         if(MatchField(p->atnam_raw, pattern))
+            return(p);
+      }
+   }
+   else
+   {
+      for(p=start; p!=stop; NEXT(p))
+      {
+         if(MatchField(p->atnam, pattern))
+            return(p);
+      }
+   }
+   return(NULL);
+}
+
+
 #ifdef TEST_MAIN
 int main(int argc, char **argv)
 {
@@ -0,0 +1,161 @@
+/************************************************************************/
+/**
+
+   \file       compact.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Benchmark memory use and traversal of compact atom storage
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+   Reports the memory used per atom by a PDB linked list and by the
+   same atoms in a PDBCOMPACT, and compares the time taken to find the
+   centre of geometry and the sequence of each.
+
+**************************************************************************
+
+   Usage:
+   ======
+   bench_compact file.pdb [repeats]
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "SysDefs.h"
+#include "pdb.h"
+#include "seq.h"
+#include "macros.h"
+#include "pdbcompact.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define DEFAULT_REPEATS 20
+
+/************************************************************************/
+/* Prototypes
+*/
+int main(int argc, char **argv);
+
+
+/************************************************************************/
+int main(int argc, char **argv)
+{
+   FILE       *fp;
+   PDB        *pdb;
+   PDBCOMPACT *cpdb;
+   VEC3F      cg;
+   char       *seq;
+   clock_t    start;
+   double     tList, tCompact, tSeqList, tSeqCompact;
+   ULONG      memList, memCompact;
+   int        repeats = DEFAULT_REPEATS,
+              natoms  = 0,
+              i;
+
+   if(argc < 2)
+   {
+      fprintf(stderr,"Usage: bench_compact file.pdb [repeats]\n");
+      return(1);
+   }
+   if(argc > 2)
+      repeats = atoi(argv[2]);
+   if(repeats < 1)
+      repeats = 1;
+
+   if(((fp=fopen(argv[1], "r"))==NULL) ||
+      ((pdb=blReadPDB(fp, &natoms))==NULL))
+   {
+      fprintf(stderr,"Unable to read %s\n", argv[1]);
+      return(1);
+   }
+   fclose(fp);
+
+   if((cpdb=blPDBToCompact(pdb))==NULL)
+   {
+      fprintf(stderr,"No memory for compact storage\n");
+      return(1);
+   }
+
+   memList    = blPDBMemory(pdb);
+   memCompact = blPDBCompactMemory(cpdb);
+
+   start = clock();
+   for(i=0; i<repeats; i++)
+      blGetCofGPDB(pdb, &cg);
+   tList = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+   start = clock();
+   for(i=0; i<repeats; i++)
+      blGetCofGPDBCompact(cpdb, &cg);
+   tCompact = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+   start = clock();
+   for(i=0; i<repeats; i++)
+   {
+      if((seq=blDoPDB2Seq(pdb, FALSE, FALSE, FALSE))!=NULL)
+         free(seq);
+   }
+   tSeqList = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+   start = clock();
+   for(i=0; i<repeats; i++)
+   {
+      if((seq=blDoPDB2SeqCompact(cpdb, FALSE, FALSE, FALSE))!=NULL)
+         free(seq);
+   }
+   tSeqCompact = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+   printf("atoms                %10d\n", natoms);
+   printf("PDB linked list      %10.1f bytes/atom  %12lu bytes\n",
+          (double)memList / natoms, memList);
+   printf("PDBCOMPACT           %10.1f bytes/atom  %12lu bytes\n",
+          (double)memCompact / natoms, memCompact);
+   printf("blGetCofGPDB         %10.2f ms\n", 1000.0 * tList / repeats);
+   printf("blGetCofGPDBCompact  %10.2f ms\n", 1000.0 * tCompact / repeats);
+   printf("blDoPDB2Seq          %10.2f ms\n", 1000.0 * tSeqList / repeats);
+   printf("blDoPDB2SeqCompact   %10.2f ms\n",
+          1000.0 * tSeqCompact / repeats);
+
+   blFreePDBCompact(cpdb);
+   FREELIST(pdb, PDB);
+
+   return(0);
+}
@@ -0,0 +1,249 @@
+/************************************************************************/
+/**
+
+   \file       coorarchive.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Benchmark coordinate archives against PDB files
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+   Makes a trajectory by moving the atoms of the first model of a PDB
+   file in small random steps and writes it as a multi-model PDB file
+   and as a coordinate archive. Reports the size of each, the time to
+   write each, the time to read the PDB file back and the time to read
+   every frame of the archive into a PDB linked list in order and in a
+   random order.
+
+**************************************************************************
+
+   Usage:
+   ======
+   bench_coorarchive file.pdb [frames]
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+#include "macros.h"
+#include "coorarchive.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define DEFAULT_FRAMES  20
+#define STEP            0.05      /* Largest move per frame (A)         */
+
+/************************************************************************/
+/* Globals
+*/
+static unsigned long sSeed = 12345;
+
+/************************************************************************/
+/* Prototypes
+*/
+int main(int argc, char **argv);
+static REAL Random(void);
+static void NextFrame(PDB *pdb);
+static void PrintResult(char *name, double seconds, int nframes,
+                        int natoms);
+
+
+/************************************************************************/
+/* Linear congruential generator giving -1 to 1, so every run moves the
+   atoms the same way
+*/
+static REAL Random(void)
+{
+   sSeed = (sSeed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+   return((REAL)sSeed / (REAL)0x3fffffffUL - 1.0);
+}
+
+
+/************************************************************************/
+static void NextFrame(PDB *pdb)
+{
+   PDB *p;
+
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      p->x += STEP * Random();
+      p->y += STEP * Random();
+      p->z += STEP * Random();
+   }
+}
+
+
+/************************************************************************/
+static void PrintResult(char *name, double seconds, int nframes,
+                        int natoms)
+{
+   printf("%-28s %10.2f ms %10.2f frames/s %12.0f atoms/s\n",
+          name, 1000.0 * seconds,
+          (seconds > 0.0) ? nframes / seconds : 0.0,
+          (seconds > 0.0) ? (double)nframes * natoms / seconds : 0.0);
+}
+
+
+/************************************************************************/
+int main(int argc, char **argv)
+{
+   FILE        *fp, *pdbFp, *arcFp;
+   PDB         *pdb, *all;
+   COORARCHIVE *arc;
+   clock_t     start;
+   double      tWritePDB    = 0.0,
+               tWriteArc    = 0.0,
+               tReadPDB, tReadArc, tRandomArc;
+   long        pdbSize, arcSize;
+   int         nframes      = DEFAULT_FRAMES,
+               natoms       = 0,
+               nread        = 0,
+               frame, i;
+   BOOL        ok           = TRUE;
+
+   if(argc < 2)
+   {
+      fprintf(stderr,"Usage: bench_coorarchive file.pdb [frames]\n");
+      return(1);
+   }
+   if(argc > 2)
+      nframes = atoi(argv[2]);
+   if(nframes < 1)
+      nframes = 1;
+
+   if(((fp=fopen(argv[1], "r"))==NULL) ||
+      ((pdb=blReadPDB(fp, &natoms))==NULL))
+   {
+      fprintf(stderr,"Unable to read %s\n", argv[1]);
+      return(1);
+   }
+   fclose(fp);
+
+   if(((pdbFp = tmpfile())==NULL) || ((arcFp = tmpfile())==NULL) ||
+      ((arc = blCreateCoorArchive(arcFp, natoms, COORARC_PRECISION))
+       ==NULL))
+   {
+      fprintf(stderr,"Unable to create temporary files\n");
+      return(1);
+   }
+
+   /* Write the frames both ways                                        */
+   for(frame=0; frame<nframes; frame++)
+   {
+      NextFrame(pdb);
+
+      start = clock();
+      fprintf(pdbFp, "MODEL     %4d\n", frame+1);
+      blWritePDB(pdbFp, pdb);
+      fprintf(pdbFp, "ENDMDL\n");
+      tWritePDB += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+      start = clock();
+      ok = blWriteCoorArchiveFramePDB(arc, pdb) && ok;
+      tWriteArc += (double)(clock() - start) / CLOCKS_PER_SEC;
+   }
+   start = clock();
+   ok = blCloseCoorArchive(arc) && ok;
+   tWriteArc += (double)(clock() - start) / CLOCKS_PER_SEC;
+   if(!ok)
+   {
+      fprintf(stderr,"Error writing the archive\n");
+      return(1);
+   }
+   fflush(pdbFp);
+   fseek(pdbFp, 0L, SEEK_END);
+   pdbSize = ftell(pdbFp);
+   fseek(arcFp, 0L, SEEK_END);
+   arcSize = ftell(arcFp);
+
+   /* Read the PDB file back                                            */
+   rewind(pdbFp);
+   start = clock();
+   all = blReadPDBAll(pdbFp, &nread);
+   tReadPDB = (double)(clock() - start) / CLOCKS_PER_SEC;
+   if(all != NULL)
+      FREELIST(all, PDB);
+
+   /* Read the archive back into the list in order and at random        */
+   if((arc = blOpenCoorArchive(arcFp))==NULL)
+   {
+      fprintf(stderr,"Error reading the archive\n");
+      return(1);
+   }
+   start = clock();
+   for(frame=0; frame<nframes; frame++)
+      ok = blReadCoorArchiveFramePDB(arc, frame, pdb) && ok;
+   tReadArc = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+   start = clock();
+   for(i=0; i<nframes; i++)
+   {
+      frame = (int)((Random() + 1.0) * 0.5 * nframes) % nframes;
+      ok = blReadCoorArchiveFramePDB(arc, frame, pdb) && ok;
+   }
+   tRandomArc = (double)(clock() - start) / CLOCKS_PER_SEC;
+   blCloseCoorArchive(arc);
+   if(!ok)
+   {
+      fprintf(stderr,"Error reading a frame\n");
+      return(1);
+   }
+
+   printf("atoms per frame  %10d\n", natoms);
+   printf("frames           %10d\n", nframes);
+   printf("PDB file         %10.1f bytes/atom  %12ld bytes\n",
+          (double)pdbSize / ((double)natoms * nframes), pdbSize);
+   printf("Archive          %10.1f bytes/atom  %12ld bytes\n",
+          (double)arcSize / ((double)natoms * nframes), arcSize);
+   PrintResult("blWritePDB", tWritePDB, nframes, natoms);
+   PrintResult("blWriteCoorArchiveFramePDB", tWriteArc, nframes, natoms);
+   PrintResult("blReadPDBAll", tReadPDB, nframes, natoms);
+   PrintResult("blReadCoorArchiveFramePDB", tReadArc, nframes, natoms);
+   PrintResult("  (random order)", tRandomArc, nframes, natoms);
+
+   fclose(pdbFp);
+   fclose(arcFp);
+   FREELIST(pdb, PDB);
+
+   return(0);
+}
@@ -0,0 +1,538 @@
+/************************************************************************/
+/**
+
+   \file       genpdb.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Generate large synthetic PDB files for the benchmarks
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+   Writes a large PDB file built from copies of one or more template
+   structures. The copies are tiled on a grid so that they do not
+   overlap, each with its own chain label (once the 62 single character
+   labels are used up, labels are reused with residue numbers offset by
+   1000). Each copy is followed by sulphate ions, with CONECT records,
+   and waters placed around it. Later models are the first model with
+   every atom moved by up to 0.2A.
+
+   The output depends only on the templates and the options, so the
+   same file is produced on every machine.
+
+**************************************************************************
+
+   Usage:
+   ======
+   bench_genpdb [-c copies] [-m models] [-l ligands] [-w waters]
+                [-s seed] out.pdb template.pdb [template.pdb ...]
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "pdb.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define DEFAULT_COPIES   100
+#define DEFAULT_MODELS   5
+#define DEFAULT_LIGANDS  4
+#define DEFAULT_WATERS   50
+#define DEFAULT_SEED     12345
+#define MAXTEMPLATES     16
+#define MARGIN           8.0    /* Space around each copy in the grid   */
+#define SO_BOND          1.47   /* S-O bond length in sulphate          */
+#define MODEL_SHIFT      0.2    /* Maximum coordinate change per model  */
+#define CHAIN_LABELS     \
+   "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789"
+
+/************************************************************************/
+/* Globals
+*/
+static unsigned long sSeed = DEFAULT_SEED;
+
+/************************************************************************/
+/* Prototypes
+*/
+int main(int argc, char **argv);
+static BOOL ParseCmdLine(int argc, char **argv, int *copies, int *models,
+                         int *ligands, int *waters, char **outFile,
+                         char **templates, int *ntemplates);
+static void Usage(void);
+static REAL Random(void);
+static PDB *ReadTemplate(char *file, VEC3F *size);
+static PDB *AddAtom(PDB **pdb, PDB *p, char *record, char *atnam,
+                    char *resnam, char *chain, int resnum,
+                    REAL x, REAL y, REAL z);
+static PDB *BuildModel(PDB **templates, int ntemplates, VEC3F cell,
+                       int copies, int ligands, int waters);
+static BOOL AddCopy(PDB **pdb, PDB **last, PDB *template, VEC3F cell,
+                    int copy, int gridSize, int ligands, int waters);
+static void ShiftModel(PDB *pdb);
+
+
+/************************************************************************/
+int main(int argc, char **argv)
+{
+   PDB      *templates[MAXTEMPLATES],
+            *pdb,
+            *model;
+   char     *outFile,
+            *templateFiles[MAXTEMPLATES];
+   VEC3F    size,
+            cell;
+   WHOLEPDB wpdb;
+   FILE     *fp;
+   int      copies  = DEFAULT_COPIES,
+            models  = DEFAULT_MODELS,
+            ligands = DEFAULT_LIGANDS,
+            waters  = DEFAULT_WATERS,
+            ntemplates,
+            natoms  = 0,
+            numTer  = 0,
+            i;
+
+   if(!ParseCmdLine(argc, argv, &copies, &models, &ligands, &waters,
+                    &outFile, templateFiles, &ntemplates))
+   {
+      Usage();
+      return(0);
+   }
+
+   /* Read the templates and find the grid cell that holds any of them */
+   cell.x = cell.y = cell.z = 0.0;
+   for(i=0; i<ntemplates; i++)
+   {
+      if((templates[i] = ReadTemplate(templateFiles[i], &size))==NULL)
+         return(1);
+      cell.x = MAX(cell.x, size.x + 2*MARGIN);
+      cell.y = MAX(cell.y, size.y + 2*MARGIN);
+      cell.z = MAX(cell.z, size.z + 2*MARGIN);
+   }
+
+   if((pdb = BuildModel(templates, ntemplates, cell, copies, ligands,
+                        waters))==NULL)
+   {
+      fprintf(stderr,"No memory for the structure\n");
+      return(1);
+   }
+
+   if((fp = fopen(outFile, "w"))==NULL)
+   {
+      fprintf(stderr,"Unable to write %s\n", outFile);
+      return(1);
+   }
+
+   fprintf(fp,"REMARK   1 SYNTHETIC BENCHMARK STRUCTURE: %d COPIES OF %d \
+TEMPLATES\n", copies, ntemplates);
+
+   /* Write each model with the CONECTs of the first model at the end  */
+   for(i=1; i<=models; i++)
+   {
+      if(i==1)
+      {
+         model = pdb;
+      }
+      else
+      {
+         if((model = blDupePDB(pdb))==NULL)
+         {
+            fprintf(stderr,"No memory for model %d\n", i);
+            return(1);
+         }
+         ShiftModel(model);
+      }
+
+      fprintf(fp,"MODEL     %4d\n", i);
+      numTer += blWritePDB(fp, model);
+      fprintf(fp,"ENDMDL\n");
+
+      if(model != pdb)
+         FREELIST(model, PDB);
+   }
+
+   wpdb.pdb     = pdb;
+   wpdb.header  = NULL;
+   wpdb.trailer = NULL;
+   wpdb.bonds   = NULL;
+   wpdb.natoms  = 0;
+   blWriteWholePDBTrailer(fp, &wpdb, numTer);
+   fclose(fp);
+
+   for(model=pdb; model!=NULL; NEXT(model))
+      natoms++;
+   fprintf(stderr,"Wrote %d models of %d atoms to %s\n",
+           models, natoms, outFile);
+
+   FREELIST(pdb, PDB);
+   for(i=0; i<ntemplates; i++)
+      FREELIST(templates[i], PDB);
+
+   return(0);
+}
+
+
+/************************************************************************/
+static BOOL ParseCmdLine(int argc, char **argv, int *copies, int *models,
+                         int *ligands, int *waters, char **outFile,
+                         char **templates, int *ntemplates)
+{
+   argc--;
+   argv++;
+
+   while(argc && argv[0][0] == '-')
+   {
+      if((argc < 2) || (argv[0][1] == '\0') || (argv[0][2] != '\0'))
+         return(FALSE);
+
+      switch(argv[0][1])
+      {
+      case 'c':
+         *copies = atoi(argv[1]);
+         break;
+      case 'm':
+         *models = atoi(argv[1]);
+         break;
+      case 'l':
+         *ligands = atoi(argv[1]);
+         break;
+      case 'w':
+         *waters = atoi(argv[1]);
+         break;
+      case 's':
+         sSeed = (unsigned long)atol(argv[1]);
+         break;
+      default:
+         return(FALSE);
+      }
+      argc -= 2;
+      argv += 2;
+   }
+
+   if((argc < 2) || (*copies < 1) || (*models < 1) ||
+      (*ligands < 0) || (*waters < 0))
+      return(FALSE);
+
+   *outFile = argv[0];
+   for(*ntemplates=0; (argc > 1) && (*ntemplates < MAXTEMPLATES); argc--)
+   {
+      templates[(*ntemplates)++] = argv[1];
+      argv++;
+   }
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+static void Usage(void)
+{
+   fprintf(stderr,"\nUsage: bench_genpdb [-c copies] [-m models] \
+[-l ligands] [-w waters]\n");
+   fprintf(stderr,"                    [-s seed] out.pdb template.pdb \
+[template.pdb ...]\n");
+   fprintf(stderr,"       -c Number of copies of the templates [%d]\n",
+           DEFAULT_COPIES);
+   fprintf(stderr,"       -m Number of models [%d]\n", DEFAULT_MODELS);
+   fprintf(stderr,"       -l Sulphate ions per copy [%d]\n",
+           DEFAULT_LIGANDS);
+   fprintf(stderr,"       -w Waters per copy [%d]\n", DEFAULT_WATERS);
+   fprintf(stderr,"       -s Random number seed [%d]\n\n", DEFAULT_SEED);
+   fprintf(stderr,"Writes a synthetic structure built from copies of \
+the templates (used\n");
+   fprintf(stderr,"in turn) for use by the benchmarks. The same options \
+always give the\n");
+   fprintf(stderr,"same file.\n\n");
+}
+
+
+/************************************************************************/
+/* A linear congruential generator so that the output does not depend
+   on the C library. Returns a value in the range [0, 1)
+*/
+static REAL Random(void)
+{
+   sSeed = (sSeed * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+   return((REAL)sSeed / (REAL)0x80000000UL);
+}
+
+
+/************************************************************************/
+/* Reads the ATOM records of a template and moves it to start at the
+   origin, returning the size of its bounding box
+*/
+static PDB *ReadTemplate(char *file, VEC3F *size)
+{
+   PDB   *pdb, *p;
+   FILE  *fp;
+   VEC3F min, max;
+   int   natoms;
+
+   if((fp = fopen(file, "r"))==NULL)
+   {
+      fprintf(stderr,"Unable to read template %s\n", file);
+      return(NULL);
+   }
+   pdb = blReadPDBAtoms(fp, &natoms);
+   fclose(fp);
+   if(pdb == NULL)
+   {
+      fprintf(stderr,"No atoms read from template %s\n", file);
+      return(NULL);
+   }
+
+   min.x = max.x = pdb->x;
+   min.y = max.y = pdb->y;
+   min.z = max.z = pdb->z;
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      min.x = MIN(min.x, p->x);  max.x = MAX(max.x, p->x);
+      min.y = MIN(min.y, p->y);  max.y = MAX(max.y, p->y);
+      min.z = MIN(min.z, p->z);  max.z = MAX(max.z, p->z);
+   }
+
+   min.x = -min.x;
+   min.y = -min.y;
+   min.z = -min.z;
+   blTranslatePDB(pdb, min);
+
+   size->x = max.x + min.x;
+   size->y = max.y + min.y;
+   size->z = max.z + min.z;
+
+   return(pdb);
+}
+
+
+/************************************************************************/
+/* Appends an atom after p (or starts the list in *pdb if p is NULL)
+   and returns it
+*/
+static PDB *AddAtom(PDB **pdb, PDB *p, char *record, char *atnam,
+                    char *resnam, char *chain, int resnum,
+                    REAL x, REAL y, REAL z)
+{
+   if(p == NULL)
+   {
+      INIT((*pdb), PDB);
+      p = *pdb;
+   }
+   else
+   {
+      ALLOCNEXT(p, PDB);
+   }
+   if(p == NULL)
+      return(NULL);
+
+   CLEAR_PDB(p);
+   strcpy(p->record_type, record);
+   sprintf(p->atnam,      "%-4s", atnam);
+   sprintf(p->atnam_raw,  " %-3s", atnam);
+   p->atnam_raw[4] = '\0';
+   strcpy(p->resnam,      resnam);
+   strcpy(p->chain,       chain);
+   p->resnum = resnum;
+   p->x      = x;
+   p->y      = y;
+   p->z      = z;
+   p->occ    = 1.0;
+   p->bval   = 30.0;
+   strcpy(p->element, (atnam[0] == 'S') ? "S" : "O");
+
+   return(p);
+}
+
+
+/************************************************************************/
+/* Builds the first model from copies of the templates
+*/
+static PDB *BuildModel(PDB **templates, int ntemplates, VEC3F cell,
+                       int copies, int ligands, int waters)
+{
+   PDB *pdb  = NULL,
+       *last = NULL;
+   int gridSize,
+       i;
+
+   for(gridSize=1; gridSize*gridSize*gridSize < copies; gridSize++);
+
+   for(i=0; i<copies; i++)
+   {
+      if(!AddCopy(&pdb, &last, templates[i % ntemplates], cell, i,
+                  gridSize, ligands, waters))
+      {
+         if(pdb != NULL)
+            FREELIST(pdb, PDB);
+         return(NULL);
+      }
+   }
+
+   blRenumAtomsPDB(pdb, 1);
+   return(pdb);
+}
+
+
+/************************************************************************/
+/* Adds one copy of a template, with its sulphates and waters, to the
+   end of the list
+*/
+static BOOL AddCopy(PDB **pdb, PDB **last, PDB *template, VEC3F cell,
+                    int copy, int gridSize, int ligands, int waters)
+{
+   static char *oxygens[] = {"O1", "O2", "O3", "O4"};
+   static REAL tetra[4][3] = {{ 1.0,  1.0,  1.0},
+                              { 1.0, -1.0, -1.0},
+                              {-1.0,  1.0, -1.0},
+                              {-1.0, -1.0,  1.0}};
+   PDB   *copyPDB,
+         *p,
+         *s,
+         *prev;
+   VEC3F offset;
+   char  chain[8];
+   int   resnum = 0,
+         prevResnum = 0,
+         resOffset,
+         i, j;
+
+   if((copyPDB = blDupePDB(template))==NULL)
+      return(FALSE);
+
+   offset.x = cell.x * (copy % gridSize) + MARGIN;
+   offset.y = cell.y * ((copy / gridSize) % gridSize) + MARGIN;
+   offset.z = cell.z * (copy / (gridSize * gridSize)) + MARGIN;
+   blTranslatePDB(copyPDB, offset);
+
+   chain[0]  = CHAIN_LABELS[copy % strlen(CHAIN_LABELS)];
+   chain[1]  = '\0';
+   resOffset = 1000 * (copy / strlen(CHAIN_LABELS));
+
+   /* Templates may have several chains so number the residues of the
+      copy in sequence
+   */
+   for(p=copyPDB, prev=NULL; p!=NULL; NEXT(p))
+   {
+      if((prev == NULL) || (p->resnum != prevResnum) ||
+         !PDBINSERTMATCH(p, prev) || !PDBCHAINMATCH(p, prev))
+         resnum++;
+      prevResnum = p->resnum;
+      prev       = p;
+      p->resnum  = resOffset + resnum;
+      strcpy(p->insert, " ");
+   }
+   for(p=copyPDB; p!=NULL; NEXT(p))
+      strcpy(p->chain, chain);
+   resnum += resOffset;
+
+   if(*last == NULL)
+      *pdb = copyPDB;
+   else
+      (*last)->next = copyPDB;
+   for(p=copyPDB; p->next!=NULL; NEXT(p));
+
+   /* Sulphates and waters fill the margin around the protein          */
+   for(i=0; i<ligands+waters; i++)
+   {
+      REAL x, y, z;
+      int  face = (int)(Random() * 6);
+
+      x = offset.x - MARGIN + Random() * cell.x;
+      y = offset.y - MARGIN + Random() * cell.y;
+      z = offset.z - MARGIN + Random() * cell.z;
+      switch(face)
+      {
+      case 0: x = offset.x - MARGIN + Random() * (MARGIN - 2.0);  break;
+      case 1: y = offset.y - MARGIN + Random() * (MARGIN - 2.0);  break;
+      case 2: z = offset.z - MARGIN + Random() * (MARGIN - 2.0);  break;
+      case 3: x = offset.x - MARGIN + cell.x - Random() * (MARGIN-2.0);
+         break;
+      case 4: y = offset.y - MARGIN + cell.y - Random() * (MARGIN-2.0);
+         break;
+      default:
+         z = offset.z - MARGIN + cell.z - Random() * (MARGIN-2.0);
+         break;
+      }
+
+      if(i < ligands)
+      {
+         if((s = p = AddAtom(pdb, p, "HETATM", "S", "SO4", chain,
+                             ++resnum, x, y, z))==NULL)
+            return(FALSE);
+         for(j=0; j<4; j++)
+         {
+            REAL d = SO_BOND / sqrt(3.0);
+            if((p = AddAtom(pdb, p, "HETATM", oxygens[j], "SO4", chain,
+                            resnum, x + d*tetra[j][0], y + d*tetra[j][1],
+                            z + d*tetra[j][2]))==NULL)
+               return(FALSE);
+            blAddConect(s, p);
+         }
+      }
+      else
+      {
+         if((p = AddAtom(pdb, p, "HETATM", "O", "HOH", chain, ++resnum,
+                         x, y, z))==NULL)
+            return(FALSE);
+      }
+   }
+
+   *last = p;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/* Moves every atom by up to MODEL_SHIFT in each direction
+*/
+static void ShiftModel(PDB *pdb)
+{
+   PDB *p;
+
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      p->x += MODEL_SHIFT * (2.0 * Random() - 1.0);
+      p->y += MODEL_SHIFT * (2.0 * Random() - 1.0);
+      p->z += MODEL_SHIFT * (2.0 * Random() - 1.0);
+   }
+}
@@ -0,0 +1,145 @@
+/************************************************************************/
+/**
+
+   \file       metalsite.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Benchmark the metal site template search
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+   Searches every PDB file in a directory for the zinc, copper and
+   calcium site templates with blFindMetalSitesDir() using 1, 2, 4...
+   threads and reports the throughput in structures per second. Wall
+   clock time is reported since clock() adds together the time used by
+   all threads. The library must be compiled with PTHREAD_SUPPORT for
+   more than one thread to be used. The template files are found in
+   the current directory or $DATADIR.
+
+**************************************************************************
+
+   Usage:
+   ======
+   bench_metalsite directory [maxthreads]
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Defines required for includes
+*/
+#define _POSIX_C_SOURCE 199309L  /* For clock_gettime()                 */
+
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "SysDefs.h"
+#include "pdb.h"
+#include "metalsite.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define DEFAULT_MAXTHREADS 8
+
+/************************************************************************/
+/* Prototypes
+*/
+int main(int argc, char **argv);
+static double WallTime(void);
+
+
+/************************************************************************/
+static double WallTime(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return((double)ts.tv_sec + (double)ts.tv_nsec / 1.0e9);
+}
+
+
+/************************************************************************/
+int main(int argc, char **argv)
+{
+   METALSITELIB *lib;
+   METALSITEHIT *hits,
+                *hit;
+   double       start,
+                elapsed;
+   int          maxthreads = DEFAULT_MAXTHREADS,
+                nthreads,
+                nscanned,
+                nhits;
+
+   if(argc < 2)
+   {
+      fprintf(stderr,"Usage: bench_metalsite directory [maxthreads]\n");
+      return(1);
+   }
+   if(argc > 2)
+      maxthreads = atoi(argv[2]);
+   if(maxthreads < 1)
+      maxthreads = 1;
+
+   if((lib = blReadDefaultMetalSiteLib())==NULL)
+   {
+      fprintf(stderr,"Unable to read the metal site templates\n");
+      return(1);
+   }
+   printf("templates            %10d\n", lib->ntemplates);
+
+   for(nthreads=1; nthreads<=maxthreads; nthreads*=2)
+   {
+      start = WallTime();
+      hits  = blFindMetalSitesDir(lib, argv[1], METALSITE_DEFDISTTOL,
+                                  METALSITE_DEFRMSD, FALSE, nthreads,
+                                  &nscanned);
+      elapsed = WallTime() - start;
+
+      for(nhits=0, hit=hits; hit!=NULL; hit=hit->next)
+         nhits++;
+      blFreeMetalSiteHits(hits);
+
+      printf("threads %2d  structures %6d  hits %8d  %10.1f \
+structures/s\n", nthreads, nscanned, nhits,
+             (elapsed > 0.0) ? nscanned / elapsed : 0.0);
+   }
+
+   blFreeMetalSiteLib(lib);
+   return(0);
+}
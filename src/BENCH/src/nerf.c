@@ -0,0 +1,261 @@
+/************************************************************************/
+/**
+
+   \file       nerf.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Benchmark building chains from internal coordinates
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+   Reports how many times per second a full-atom chain can be built
+   from its internal coordinates by blBuildNeRFChain() and by calling
+   blTorToCoor() for each atom, how many times its last 10 residues can
+   be rebuilt and how many times a 10-residue backbone fragment can be
+   built. The reference coordinates file is found in the current
+   directory or $DATADIR.
+
+**************************************************************************
+
+   Usage:
+   ======
+   bench_nerf [nres [repeats]]
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "angle.h"
+#include "nerf.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define DEFAULT_NRES    100
+#define DEFAULT_REPEATS 20000
+#define FRAGMENT_NRES   10
+#define LOOP_NRES       10
+#define AMINO_ACIDS     "ACDEFGHIKLMNPQRSTVWY"
+
+/************************************************************************/
+/* Prototypes
+*/
+int main(int argc, char **argv);
+static void BuildTorToCoor(NERFCHAIN *chain);
+static char *MakeSequence(int nres);
+static void Perturb(NERFCHAIN *chain, int firstRes, int repeat);
+
+
+/************************************************************************/
+/* Builds the chain one atom at a time with blTorToCoor()
+*/
+static void BuildTorToCoor(NERFCHAIN *chain)
+{
+   VEC3F ant1, ant2, ant3, coords;
+   REAL  torsion;
+   int   i, a, b, c;
+
+   for(i=3; i<chain->natoms; i++)
+   {
+      a = chain->ref[3*i];
+      b = chain->ref[3*i+1];
+      c = chain->ref[3*i+2];
+      ant1.x = chain->x[a]; ant1.y = chain->y[a]; ant1.z = chain->z[a];
+      ant2.x = chain->x[b]; ant2.y = chain->y[b]; ant2.z = chain->z[b];
+      ant3.x = chain->x[c]; ant3.y = chain->y[c]; ant3.z = chain->z[c];
+      torsion = chain->torsion[i];
+      if(chain->dof[i] >= 0)
+         torsion += chain->dofs[chain->dof[i]];
+
+      blTorToCoor(ant1, ant2, ant3, chain->bond[i], chain->angle[i],
+                  torsion, &coords);
+      chain->x[i] = coords.x;
+      chain->y[i] = coords.y;
+      chain->z[i] = coords.z;
+   }
+}
+
+
+/************************************************************************/
+static char *MakeSequence(int nres)
+{
+   char *seq;
+   int  i;
+
+   if((seq = (char *)malloc(nres+1))==NULL)
+      return(NULL);
+   for(i=0; i<nres; i++)
+      seq[i] = AMINO_ACIDS[i % 20];
+   seq[nres] = '\0';
+   return(seq);
+}
+
+
+/************************************************************************/
+/* Changes the phi and psi angles of residues from firstRes onwards
+*/
+static void Perturb(NERFCHAIN *chain, int firstRes, int repeat)
+{
+   int r;
+
+   for(r=firstRes; r<chain->nres; r++)
+   {
+      NERFDOF(chain, r, NERF_PHI) = -1.1 + 0.001 * (repeat % 100);
+      NERFDOF(chain, r, NERF_PSI) = -0.7 - 0.001 * (repeat % 100);
+   }
+}
+
+
+/************************************************************************/
+int main(int argc, char **argv)
+{
+   NERFCHAIN *chain,
+             *fragment;
+   REAL      *x, *y, *z,
+             maxDiff = 0.0;
+   char      *seq;
+   clock_t   start;
+   double    tNeRF, tTorCoor, tLoop, tFragment, tExtract;
+   int       nres    = DEFAULT_NRES,
+             repeats = DEFAULT_REPEATS,
+             i;
+
+   if(argc > 1)
+      nres = atoi(argv[1]);
+   if(argc > 2)
+      repeats = atoi(argv[2]);
+   if(nres < LOOP_NRES)
+      nres = LOOP_NRES;
+   if(repeats < 1)
+      repeats = 1;
+
+   if(((seq = MakeSequence(nres))==NULL) ||
+      ((chain = blCreateNeRFChain(seq, NERF_REFCOORDS))==NULL) ||
+      ((fragment = blCreateNeRFChain(seq+nres-FRAGMENT_NRES, NULL))
+       ==NULL))
+   {
+      fprintf(stderr,"Unable to create the chains\n");
+      return(1);
+   }
+
+   start = clock();
+   for(i=0; i<repeats; i++)
+   {
+      Perturb(chain, 0, i);
+      blBuildNeRFChain(chain, 0);
+   }
+   tNeRF = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+   /* Keep the NeRF coordinates to check blTorToCoor() gives the same   */
+   x = (REAL *)malloc(chain->natoms * sizeof(REAL));
+   y = (REAL *)malloc(chain->natoms * sizeof(REAL));
+   z = (REAL *)malloc(chain->natoms * sizeof(REAL));
+   if((x == NULL) || (y == NULL) || (z == NULL))
+   {
+      fprintf(stderr,"No memory\n");
+      return(1);
+   }
+   for(i=0; i<chain->natoms; i++)
+   {
+      x[i] = chain->x[i];
+      y[i] = chain->y[i];
+      z[i] = chain->z[i];
+   }
+
+   start = clock();
+   for(i=0; i<repeats; i++)
+   {
+      Perturb(chain, 0, i);
+      BuildTorToCoor(chain);
+   }
+   tTorCoor = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+   for(i=0; i<chain->natoms; i++)
+   {
+      REAL d = fabs(x[i] - chain->x[i]) + fabs(y[i] - chain->y[i]) +
+               fabs(z[i] - chain->z[i]);
+      if(d > maxDiff)
+         maxDiff = d;
+   }
+
+   start = clock();
+   for(i=0; i<repeats; i++)
+   {
+      Perturb(chain, nres-LOOP_NRES, i);
+      blBuildNeRFChain(chain, nres-LOOP_NRES);
+   }
+   tLoop = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+   start = clock();
+   for(i=0; i<repeats; i++)
+      blExtractNeRFTorsions(chain);
+   tExtract = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+   start = clock();
+   for(i=0; i<repeats; i++)
+   {
+      Perturb(fragment, 0, i);
+      blBuildNeRFChain(fragment, 0);
+   }
+   tFragment = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+   printf("residues             %10d\n", nres);
+   printf("atoms                %10d\n", chain->natoms);
+   printf("blBuildNeRFChain     %10.0f builds/s  %12.0f atoms/s\n",
+          repeats / tNeRF, repeats * chain->natoms / tNeRF);
+   printf("blTorToCoor          %10.0f builds/s  %12.0f atoms/s\n",
+          repeats / tTorCoor, repeats * chain->natoms / tTorCoor);
+   printf("max difference       %10.2e\n", maxDiff);
+   printf("last %d residues     %10.0f builds/s\n", LOOP_NRES,
+          repeats / tLoop);
+   printf("blExtractNeRFTorsions%10.0f calls/s\n", repeats / tExtract);
+   printf("%d-residue backbone  %10.0f builds/s\n", FRAGMENT_NRES,
+          repeats / tFragment);
+
+   free(x);
+   free(y);
+   free(z);
+   free(seq);
+   blFreeNeRFChain(chain);
+   blFreeNeRFChain(fragment);
+   return(0);
+}
@@ -0,0 +1,170 @@
+/************************************************************************/
+/**
+
+   \file       readfilter.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Benchmark CA-only reading with and without a read filter
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+   Compares reading just the CA atoms of a PDB file with
+   blReadPDBFiltered() against the traditional approach of reading 
+   everything with blReadPDB() and then calling blSelectCaPDB().
+
+**************************************************************************
+
+   Usage:
+   ======
+   bench_readfilter file.pdb [repeats]
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "SysDefs.h"
+#include "pdb.h"
+#include "macros.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define DEFAULT_REPEATS 5
+
+/************************************************************************/
+/* Prototypes
+*/
+int main(int argc, char **argv);
+static double ReadAllThenSelect(char *filename, int repeats, int *natoms);
+static double ReadFiltered(char *filename, int repeats, int *natoms);
+
+
+/************************************************************************/
+int main(int argc, char **argv)
+{
+   int    repeats = DEFAULT_REPEATS,
+          nAll    = 0,
+          nFilter = 0;
+   double tAll, tFilter;
+
+   if(argc < 2)
+   {
+      fprintf(stderr,"Usage: bench_readfilter file.pdb [repeats]\n");
+      return(1);
+   }
+   if(argc > 2)
+      repeats = atoi(argv[2]);
+   if(repeats < 1)
+      repeats = 1;
+
+   tAll    = ReadAllThenSelect(argv[1], repeats, &nAll);
+   tFilter = ReadFiltered(argv[1], repeats, &nFilter);
+   if((tAll < 0.0) || (tFilter < 0.0))
+   {
+      fprintf(stderr,"Unable to read %s\n", argv[1]);
+      return(1);
+   }
+
+   printf("read+blSelectCaPDB   %10.2f ms/read  %8d CA atoms\n",
+          1000.0 * tAll / repeats, nAll);
+   printf("blReadPDBFiltered    %10.2f ms/read  %8d CA atoms\n",
+          1000.0 * tFilter / repeats, nFilter);
+   if(tFilter > 0.0)
+      printf("speedup              %10.2f\n", tAll / tFilter);
+
+   return(0);
+}
+
+
+/************************************************************************/
+static double ReadAllThenSelect(char *filename, int repeats, int *natoms)
+{
+   FILE    *fp;
+   PDB     *pdb;
+   clock_t start;
+   int     i;
+
+   start = clock();
+   for(i=0; i<repeats; i++)
+   {
+      if((fp=fopen(filename, "r"))==NULL)
+         return(-1.0);
+      pdb = blReadPDB(fp, natoms);
+      fclose(fp);
+      pdb = blSelectCaPDB(pdb);
+      *natoms = 0;
+      if(pdb!=NULL)
+      {
+         PDB *p;
+         for(p=pdb; p!=NULL; NEXT(p))
+            (*natoms)++;
+         FREELIST(pdb, PDB);
+      }
+   }
+   return((double)(clock() - start) / CLOCKS_PER_SEC);
+}
+
+
+/************************************************************************/
+static double ReadFiltered(char *filename, int repeats, int *natoms)
+{
+   FILE          *fp;
+   PDB           *pdb;
+   PDBREADFILTER filter;
+   char          *names[1];
+   clock_t       start;
+   int           i;
+
+   names[0] = "CA";
+   blInitPDBReadFilter(&filter);
+   filter.atnams  = names;
+   filter.natnams = 1;
+
+   start = clock();
+   for(i=0; i<repeats; i++)
+   {
+      if((fp=fopen(filename, "r"))==NULL)
+         return(-1.0);
+      pdb = blReadPDBFiltered(fp, natoms, &filter);
+      fclose(fp);
+      if(pdb!=NULL)
+         FREELIST(pdb, PDB);
+   }
+   return((double)(clock() - start) / CLOCKS_PER_SEC);
+}
@@ -0,0 +1,281 @@
+/************************************************************************/
+/**
+
+   \file       readmmap.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Benchmark stdio and memory mapped PDB reading
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+   Compares reading a PDB file with blReadPDB(), which reads a line at 
+   a time through stdio, against blReadPDBFile(), which memory maps the
+   file, and against blDoReadPDBBuffer() on a file already in memory.
+   For each the wall clock time, throughput and the number of read()
+   system calls (and bytes they return) are reported. The system call
+   counts come from /proc/self/io so are only available on Linux.
+
+**************************************************************************
+
+   Usage:
+   ======
+   bench_readmmap file.pdb [repeats]
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Defines required for includes
+*/
+#define _POSIX_C_SOURCE 199309L  /* For clock_gettime()                 */
+
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "SysDefs.h"
+#include "pdb.h"
+#include "macros.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define DEFAULT_REPEATS 5
+#define MODE_STDIO      0
+#define MODE_MMAP       1
+#define MODE_BUFFER     2
+
+/************************************************************************/
+/* Prototypes
+*/
+int main(int argc, char **argv);
+static double WallTime(void);
+static BOOL GetReadCounts(long *syscr, long *rchar);
+static char *ReadFileToMemory(char *filename, long *length);
+static double TimeRead(char *filename, char *buffer, long length, 
+                       int mode, int repeats, int *natoms, 
+                       long *syscr, long *rchar);
+static void Report(char *label, double t, int repeats, long length, 
+                   int natoms, long syscr, long rchar, BOOL gotCounts);
+
+
+/************************************************************************/
+int main(int argc, char **argv)
+{
+   int    repeats = DEFAULT_REPEATS,
+          natoms  = 0;
+   long   length  = 0,
+          syscr, rchar;
+   double t;
+   char   *buffer;
+   BOOL   gotCounts;
+
+   if(argc < 2)
+   {
+      fprintf(stderr,"Usage: bench_readmmap file.pdb [repeats]\n");
+      return(1);
+   }
+   if(argc > 2)
+      repeats = atoi(argv[2]);
+   if(repeats < 1)
+      repeats = 1;
+
+   if((buffer = ReadFileToMemory(argv[1], &length))==NULL)
+   {
+      fprintf(stderr,"Unable to read %s\n", argv[1]);
+      return(1);
+   }
+   gotCounts = GetReadCounts(&syscr, &rchar);
+
+   printf("                      ms/read     MB/s     atoms  \
+read()/read  bytes/read\n");
+   
+   t = TimeRead(argv[1], NULL, 0, MODE_STDIO, repeats, &natoms, 
+                &syscr, &rchar);
+   Report("blReadPDB (stdio)", t, repeats, length, natoms, syscr, rchar,
+          gotCounts);
+
+   t = TimeRead(argv[1], NULL, 0, MODE_MMAP, repeats, &natoms, 
+                &syscr, &rchar);
+   Report("blReadPDBFile (mmap)", t, repeats, length, natoms, syscr, 
+          rchar, gotCounts);
+
+   t = TimeRead(argv[1], buffer, length, MODE_BUFFER, repeats, &natoms, 
+                &syscr, &rchar);
+   Report("blDoReadPDBBuffer", t, repeats, length, natoms, syscr, rchar,
+          gotCounts);
+
+   free(buffer);
+   return(0);
+}
+
+
+/************************************************************************/
+static double WallTime(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return((double)ts.tv_sec + (double)ts.tv_nsec / 1.0e9);
+}
+
+
+/************************************************************************/
+/* Gets the number of read() system calls made by this process so far,
+   and the number of bytes they returned, from /proc/self/io
+*/
+static BOOL GetReadCounts(long *syscr, long *rchar)
+{
+   FILE *fp;
+   char buffer[160];
+   BOOL gotSyscr = FALSE,
+        gotRchar = FALSE;
+
+   if((fp=fopen("/proc/self/io", "r"))==NULL)
+      return(FALSE);
+   while(fgets(buffer, 159, fp))
+   {
+      if(!strncmp(buffer, "syscr:", 6))
+         gotSyscr = (sscanf(buffer+6, "%ld", syscr) == 1);
+      else if(!strncmp(buffer, "rchar:", 6))
+         gotRchar = (sscanf(buffer+6, "%ld", rchar) == 1);
+   }
+   fclose(fp);
+   
+   return(gotSyscr && gotRchar);
+}
+
+
+/************************************************************************/
+static char *ReadFileToMemory(char *filename, long *length)
+{
+   FILE *fp;
+   char *buffer;
+
+   if((fp=fopen(filename, "r"))==NULL)
+      return(NULL);
+   fseek(fp, 0L, SEEK_END);
+   *length = ftell(fp);
+   rewind(fp);
+   
+   if((buffer=(char *)malloc(*length + 1))!=NULL)
+   {
+      if(fread(buffer, 1, *length, fp) != (size_t)(*length))
+      {
+         free(buffer);
+         buffer = NULL;
+      }
+   }
+   fclose(fp);
+   return(buffer);
+}
+
+
+/************************************************************************/
+/* Times repeated reads and returns the change in the read() counts.
+   The counts include the single read of /proc/self/io
+*/
+static double TimeRead(char *filename, char *buffer, long length, 
+                       int mode, int repeats, int *natoms, 
+                       long *syscr, long *rchar)
+{
+   FILE     *fp;
+   PDB      *pdb = NULL;
+   WHOLEPDB *wpdb;
+   double   start, t;
+   long     syscr0 = 0,
+            rchar0 = 0;
+   int      i;
+
+   GetReadCounts(&syscr0, &rchar0);
+   start = WallTime();
+   for(i=0; i<repeats; i++)
+   {
+      switch(mode)
+      {
+      case MODE_STDIO:
+         if((fp=fopen(filename, "r"))==NULL)
+            return(-1.0);
+         pdb = blReadPDB(fp, natoms);
+         fclose(fp);
+         break;
+      case MODE_MMAP:
+         pdb = blReadPDBFile(filename, natoms);
+         break;
+      case MODE_BUFFER:
+         pdb = NULL;
+         if((wpdb = blDoReadPDBBuffer(buffer, length, 1, FALSE, NULL, 
+                                      1))!=NULL)
+         {
+            *natoms = wpdb->natoms;
+            pdb     = wpdb->pdb;
+            wpdb->pdb = NULL;
+            blFreeWholePDB(wpdb);
+         }
+         break;
+      }
+      if(pdb!=NULL)
+         FREELIST(pdb, PDB);
+   }
+   t = WallTime() - start;
+
+   GetReadCounts(syscr, rchar);
+   *syscr -= syscr0;
+   *rchar -= rchar0;
+   return(t);
+}
+
+
+/************************************************************************/
+static void Report(char *label, double t, int repeats, long length, 
+                   int natoms, long syscr, long rchar, BOOL gotCounts)
+{
+   if(t < 0.0)
+   {
+      printf("%-20s  failed\n", label);
+      return;
+   }
+
+   printf("%-20s %9.2f %8.1f %9d", label, 1000.0 * t / repeats,
+          (t > 0.0) ? (length * (double)repeats / (1024.0*1024.0)) / t 
+                    : 0.0,
+          natoms);
+   if(gotCounts)
+      printf(" %12.1f %11.0f", (double)syscr / repeats, 
+             (double)rchar / repeats);
+   printf("\n");
+}
@@ -0,0 +1,161 @@
+/************************************************************************/
+/**
+
+   \file       readparallel.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Benchmark parallel chunked PDB reading
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+   Times blReadPDB() and then blReadPDBParallel() with 1, 2, 4, 8 and 16
+   threads. Wall clock time is reported since clock() adds together 
+   the time used by all threads. The library must be compiled with
+   PTHREAD_SUPPORT for the threads to be used.
+
+**************************************************************************
+
+   Usage:
+   ======
+   bench_readparallel file.pdb [repeats]
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Defines required for includes
+*/
+#define _POSIX_C_SOURCE 199309L  /* For clock_gettime()                 */
+
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "SysDefs.h"
+#include "pdb.h"
+#include "macros.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define DEFAULT_REPEATS 5
+#define MAXTHREADS     16
+
+/************************************************************************/
+/* Prototypes
+*/
+int main(int argc, char **argv);
+static double WallTime(void);
+static double TimeRead(char *filename, int repeats, int nThreads, 
+                       int *natoms);
+
+
+/************************************************************************/
+int main(int argc, char **argv)
+{
+   int    repeats = DEFAULT_REPEATS,
+          natoms  = 0,
+          nThreads;
+   double tSerial, t;
+
+   if(argc < 2)
+   {
+      fprintf(stderr,"Usage: bench_readparallel file.pdb [repeats]\n");
+      return(1);
+   }
+   if(argc > 2)
+      repeats = atoi(argv[2]);
+   if(repeats < 1)
+      repeats = 1;
+
+   if((tSerial = TimeRead(argv[1], repeats, 0, &natoms)) < 0.0)
+   {
+      fprintf(stderr,"Unable to read %s\n", argv[1]);
+      return(1);
+   }
+   printf("blReadPDB            %10.2f ms/read  %8d atoms\n",
+          1000.0 * tSerial / repeats, natoms);
+
+   for(nThreads=1; nThreads<=MAXTHREADS; nThreads*=2)
+   {
+      if((t = TimeRead(argv[1], repeats, nThreads, &natoms)) < 0.0)
+         return(1);
+      printf("blReadPDBParallel %2d %10.2f ms/read  %8d atoms  \
+speedup %6.2f\n",
+             nThreads, 1000.0 * t / repeats, natoms, 
+             (t > 0.0) ? tSerial / t : 0.0);
+   }
+
+   return(0);
+}
+
+
+/************************************************************************/
+static double WallTime(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return((double)ts.tv_sec + (double)ts.tv_nsec / 1.0e9);
+}
+
+
+/************************************************************************/
+/* nThreads of 0 uses blReadPDB()
+*/
+static double TimeRead(char *filename, int repeats, int nThreads, 
+                       int *natoms)
+{
+   FILE   *fp;
+   PDB    *pdb;
+   double start;
+   int    i;
+
+   start = WallTime();
+   for(i=0; i<repeats; i++)
+   {
+      if((fp=fopen(filename, "r"))==NULL)
+         return(-1.0);
+      if(nThreads == 0)
+         pdb = blReadPDB(fp, natoms);
+      else
+         pdb = blReadPDBParallel(fp, natoms, nThreads);
+      fclose(fp);
+      if(pdb!=NULL)
+         FREELIST(pdb, PDB);
+   }
+   return(WallTime() - start);
+}
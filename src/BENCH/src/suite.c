@@ -0,0 +1,592 @@
+/************************************************************************/
+/**
+
+   \file       suite.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Microbenchmarks for the main library operations
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+   Times reading (PDB, all models, whole PDB with CONECTs, PDBML and
+   gzipped PDB), writing (PDB and PDBML), building CONECTs, solvent
+   accessibility, secondary structure, listing H-bonds, fitting,
+   sequence alignment and hashing on a PDB file, normally one written
+   by bench_genpdb. Operations that need a structure use the first
+   model; fitting fits the second model onto the first.
+
+   Each benchmark is run a number of times and the fastest run is
+   reported. The results are written as JSON so that they can be
+   compared between releases. If bioplib was compiled with
+   INSTRUMENT_SUPPORT, the library's own counters and timers for the
+   whole run are included. A benchmark that cannot be run (e.g.
+   reading gzipped files when bioplib was compiled without
+   GUNZIP_SUPPORT) is reported with "ok": false.
+
+   Radii and the mutation matrix are found in the current directory or
+   $DATADIR.
+
+**************************************************************************
+
+   Usage:
+   ======
+   bench_suite file.pdb [repeats]
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Reports the library's instrumentation counters
+
+*************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "pdb.h"
+#include "access.h"
+#include "secstr.h"
+#include "hbond.h"
+#include "seq.h"
+#include "hash.h"
+#include "general.h"
+#include "instrument.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define DEFAULT_REPEATS 3
+#define RADII_FILE      "radii.dat"
+#define MDM_FILE        "mdm78.mat"
+#define DATAENV         "DATADIR"
+#define ACCESS_ACCURACY 0.05
+#define PROBE_RADIUS    1.4
+#define CONECT_TOL      0.1
+#define GAP_OPEN        10
+#define GAP_EXTEND      2
+#define MAXKEY          32
+#define MAXBUFF         256
+
+typedef struct
+{
+   char *pdbFile,
+        pdbmlFile[MAXBUFF],
+        gzFile[MAXBUFF];
+   PDB  *pdb,                /* First model                             */
+        *model2;             /* Second model (or a copy of the first)   */
+   int  natoms,
+        nmodels;
+}  BENCHDATA;
+
+typedef struct
+{
+   char *name,
+        *unit;
+   BOOL (*func)(BENCHDATA *data, ULONG *items);
+}  BENCHMARK;
+
+/************************************************************************/
+/* Prototypes
+*/
+int main(int argc, char **argv);
+static BOOL Setup(BENCHDATA *data);
+static void Cleanup(BENCHDATA *data);
+static BOOL ReadFile(char *file, ULONG *items, BOOL allModels,
+                     BOOL whole);
+static BOOL BenchReadPDB(BENCHDATA *data, ULONG *items);
+static BOOL BenchReadAll(BENCHDATA *data, ULONG *items);
+static BOOL BenchReadWhole(BENCHDATA *data, ULONG *items);
+static BOOL BenchReadPDBML(BENCHDATA *data, ULONG *items);
+static BOOL BenchReadGzip(BENCHDATA *data, ULONG *items);
+static BOOL BenchWritePDB(BENCHDATA *data, ULONG *items);
+static BOOL BenchWritePDBML(BENCHDATA *data, ULONG *items);
+static BOOL BenchConect(BENCHDATA *data, ULONG *items);
+static BOOL BenchAccess(BENCHDATA *data, ULONG *items);
+static BOOL BenchSecStr(BENCHDATA *data, ULONG *items);
+static BOOL BenchHBonds(BENCHDATA *data, ULONG *items);
+static BOOL BenchFit(BENCHDATA *data, ULONG *items);
+static BOOL BenchAlign(BENCHDATA *data, ULONG *items);
+static BOOL BenchHash(BENCHDATA *data, ULONG *items);
+
+/************************************************************************/
+/* Globals
+*/
+static BENCHMARK sBenchmarks[] =
+{
+   {"read_pdb",        "atoms",          BenchReadPDB},
+   {"read_all_models", "atoms",          BenchReadAll},
+   {"read_whole_pdb",  "atoms",          BenchReadWhole},
+   {"read_pdbml",      "atoms",          BenchReadPDBML},
+   {"read_gzip",       "atoms",          BenchReadGzip},
+   {"write_pdb",       "atoms",          BenchWritePDB},
+   {"write_pdbml",     "atoms",          BenchWritePDBML},
+   {"build_conect",    "atoms",          BenchConect},
+   {"access",          "atoms",          BenchAccess},
+   {"secstr",          "atoms",          BenchSecStr},
+   {"hbonds",          "residue_pairs",  BenchHBonds},
+   {"fit",             "atoms",          BenchFit},
+   {"align",           "cells",          BenchAlign},
+   {"hash",            "operations",     BenchHash},
+   {NULL,              NULL,             NULL}
+};
+
+
+/************************************************************************/
+int main(int argc, char **argv)
+{
+   BENCHDATA data;
+   clock_t   start;
+   double    t, best;
+   ULONG     items;
+   BOOL      ok;
+   int       repeats = DEFAULT_REPEATS,
+             b, i;
+
+   if(argc < 2)
+   {
+      fprintf(stderr,"Usage: bench_suite file.pdb [repeats]\n");
+      return(0);
+   }
+   data.pdbFile = argv[1];
+   if(argc > 2)
+      repeats = atoi(argv[2]);
+   if(repeats < 1)
+      repeats = 1;
+
+   if(!Setup(&data))
+      return(1);
+
+   printf("{\n");
+   printf("  \"file\": \"%s\",\n", data.pdbFile);
+   printf("  \"atoms\": %d,\n", data.natoms);
+   printf("  \"models\": %d,\n", data.nmodels);
+   printf("  \"repeats\": %d,\n", repeats);
+   printf("  \"results\": [\n");
+
+   for(b=0; sBenchmarks[b].name != NULL; b++)
+   {
+      best  = 0.0;
+      items = 0;
+      ok    = TRUE;
+      for(i=0; ok && (i<repeats); i++)
+      {
+         start = clock();
+         ok    = (*sBenchmarks[b].func)(&data, &items);
+         t     = (double)(clock() - start) / CLOCKS_PER_SEC;
+         if((i==0) || (t < best))
+            best = t;
+      }
+
+      printf("    {\"name\": \"%s\", \"ok\": %s, \"items\": %lu, \
+\"unit\": \"%s\", \"seconds\": %.6f, \"rate\": %.1f}%s\n",
+             sBenchmarks[b].name, (ok ? "true" : "false"),
+             (ok ? items : 0), sBenchmarks[b].unit, (ok ? best : 0.0),
+             ((ok && (best > 0.0)) ? items / best : 0.0),
+             (sBenchmarks[b+1].name != NULL) ? "," : "");
+      fflush(stdout);
+   }
+
+   if(blInstrumentEnabled())
+   {
+      INSTRUMENTSTATS stats;
+
+      blGetInstrumentStats(&stats, FALSE);
+      printf("  ],\n");
+      printf("  \"instrument\":\n");
+      blPrintInstrumentStats(stdout, &stats, INSTRUMENT_JSON);
+   }
+   else
+   {
+      printf("  ]\n");
+   }
+   printf("}\n");
+
+   Cleanup(&data);
+   return(0);
+}
+
+
+/************************************************************************/
+/* Reads the first two models and writes the PDBML and gzipped copies
+   of the file used by the read benchmarks
+*/
+static BOOL Setup(BENCHDATA *data)
+{
+   WHOLEPDB *wpdb;
+   FILE     *fp;
+   PDB      *p;
+   char     cmd[MAXBUFF*3];
+   int      natoms;
+
+   data->pdbmlFile[0] = '\0';
+   data->gzFile[0]    = '\0';
+
+   if((fp = fopen(data->pdbFile, "r"))==NULL)
+   {
+      fprintf(stderr,"Unable to read %s\n", data->pdbFile);
+      return(FALSE);
+   }
+   if((data->pdb = blReadPDB(fp, &(data->natoms)))==NULL)
+   {
+      fprintf(stderr,"No atoms read from %s\n", data->pdbFile);
+      return(FALSE);
+   }
+
+   rewind(fp);
+   if(((wpdb = blDoReadPDB(fp, TRUE, 0, 2, FALSE))!=NULL) &&
+      (wpdb->pdb != NULL))
+   {
+      data->model2 = wpdb->pdb;
+      free(wpdb);
+   }
+   else
+   {
+      if(wpdb != NULL)
+         free(wpdb);
+      data->model2 = blDupePDB(data->pdb);
+   }
+
+   rewind(fp);
+   p = blReadPDBAll(fp, &natoms);
+   data->nmodels = (data->natoms > 0) ? natoms / data->natoms : 0;
+   if(p != NULL)
+      FREELIST(p, PDB);
+   fclose(fp);
+
+   if(data->model2 == NULL)
+   {
+      fprintf(stderr,"No memory\n");
+      return(FALSE);
+   }
+
+   sprintf(data->pdbmlFile, "/tmp/bench_suite_%d.xml", (int)getpid());
+   if((fp = fopen(data->pdbmlFile, "w"))!=NULL)
+   {
+      if(!blWritePDBAsPDBML(fp, data->pdb))
+         data->pdbmlFile[0] = '\0';
+      fclose(fp);
+   }
+
+   sprintf(data->gzFile, "/tmp/bench_suite_%d.pdb.gz", (int)getpid());
+   sprintf(cmd, "gzip -c %s >%s", data->pdbFile, data->gzFile);
+   if(system(cmd))
+      data->gzFile[0] = '\0';
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+static void Cleanup(BENCHDATA *data)
+{
+   if(data->pdbmlFile[0])
+      unlink(data->pdbmlFile);
+   if(data->gzFile[0])
+      unlink(data->gzFile);
+   FREELIST(data->pdb, PDB);
+   FREELIST(data->model2, PDB);
+}
+
+
+/************************************************************************/
+static BOOL ReadFile(char *file, ULONG *items, BOOL allModels,
+                     BOOL whole)
+{
+   WHOLEPDB *wpdb;
+   FILE     *fp;
+
+   if((file[0] == '\0') || ((fp = fopen(file, "r"))==NULL))
+      return(FALSE);
+   wpdb = blDoReadPDB(fp, TRUE, 0, (allModels ? 0 : 1), whole);
+   fclose(fp);
+
+   if(wpdb == NULL)
+      return(FALSE);
+   *items = wpdb->natoms;
+   if(whole)
+   {
+      blFreeWholePDB(wpdb);
+   }
+   else
+   {
+      if(wpdb->pdb != NULL)
+         FREELIST(wpdb->pdb, PDB);
+      free(wpdb);
+   }
+   return(*items > 0);
+}
+
+
+/************************************************************************/
+static BOOL BenchReadPDB(BENCHDATA *data, ULONG *items)
+{
+   return(ReadFile(data->pdbFile, items, FALSE, FALSE));
+}
+
+
+/************************************************************************/
+static BOOL BenchReadAll(BENCHDATA *data, ULONG *items)
+{
+   return(ReadFile(data->pdbFile, items, TRUE, FALSE));
+}
+
+
+/************************************************************************/
+static BOOL BenchReadWhole(BENCHDATA *data, ULONG *items)
+{
+   return(ReadFile(data->pdbFile, items, FALSE, TRUE));
+}
+
+
+/************************************************************************/
+static BOOL BenchReadPDBML(BENCHDATA *data, ULONG *items)
+{
+   return(ReadFile(data->pdbmlFile, items, FALSE, FALSE));
+}
+
+
+/************************************************************************/
+static BOOL BenchReadGzip(BENCHDATA *data, ULONG *items)
+{
+   return(ReadFile(data->gzFile, items, FALSE, FALSE));
+}
+
+
+/************************************************************************/
+static BOOL BenchWritePDB(BENCHDATA *data, ULONG *items)
+{
+   FILE *fp;
+
+   if((fp = tmpfile())==NULL)
+      return(FALSE);
+   blWritePDB(fp, data->pdb);
+   fclose(fp);
+   *items = data->natoms;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+static BOOL BenchWritePDBML(BENCHDATA *data, ULONG *items)
+{
+   FILE *fp;
+   BOOL ok;
+
+   if((fp = tmpfile())==NULL)
+      return(FALSE);
+   ok = blWritePDBAsPDBML(fp, data->pdb);
+   fclose(fp);
+   *items = data->natoms;
+   return(ok);
+}
+
+
+/************************************************************************/
+static BOOL BenchConect(BENCHDATA *data, ULONG *items)
+{
+   *items = data->natoms;
+   return(blBuildConectData(data->pdb, CONECT_TOL));
+}
+
+
+/************************************************************************/
+static BOOL BenchAccess(BENCHDATA *data, ULONG *items)
+{
+   RESRAD *resrad;
+   FILE   *fp;
+   BOOL   noenv,
+          ok;
+
+   if((fp = blOpenFile(RADII_FILE, DATAENV, "r", &noenv))==NULL)
+      return(FALSE);
+   resrad = blSetAtomRadii(data->pdb, fp);
+   fclose(fp);
+   if(resrad == NULL)
+      return(FALSE);
+
+   ok = blCalcAccess(data->pdb, data->natoms, ACCESS_ACCURACY,
+                     PROBE_RADIUS, TRUE);
+   FREELIST(resrad, RESRAD);
+   *items = data->natoms;
+   return(ok);
+}
+
+
+/************************************************************************/
+static BOOL BenchSecStr(BENCHDATA *data, ULONG *items)
+{
+   *items = data->natoms;
+   return(blCalcSecStrucPDB(data->pdb, NULL, FALSE) == 0);
+}
+
+
+/************************************************************************/
+/* Lists the H-bonds between every pair of residues in each chain
+*/
+static BOOL BenchHBonds(BENCHDATA *data, ULONG *items)
+{
+   PDB    *chain, *nextChain,
+          *res1, *res2;
+   HBLIST *hbonds;
+
+   *items = 0;
+   for(chain=data->pdb; chain!=NULL; chain=nextChain)
+   {
+      nextChain = blFindNextChain(chain);
+      for(res1=chain; res1!=nextChain; res1=blFindNextResidue(res1))
+      {
+         for(res2=chain; res2!=nextChain; res2=blFindNextResidue(res2))
+         {
+            if(res1 != res2)
+            {
+               if((hbonds = blListAllHBonds(res1, res2))!=NULL)
+                  FREELIST(hbonds, HBLIST);
+               (*items)++;
+            }
+         }
+      }
+   }
+   return(TRUE);
+}
+
+
+/************************************************************************/
+static BOOL BenchFit(BENCHDATA *data, ULONG *items)
+{
+   REAL rm[3][3];
+
+   *items = data->natoms;
+   return(blFitPDB(data->pdb, data->model2, rm));
+}
+
+
+/************************************************************************/
+/* Aligns the sequence of each chain with that of the next chain
+*/
+static BOOL BenchAlign(BENCHDATA *data, ULONG *items)
+{
+   static BOOL mdmRead = FALSE;
+   char        *seq,
+               *seq1, *seq2,
+               *end,
+               *align1 = NULL,
+               *align2 = NULL;
+   int         len1, len2,
+               alignLen,
+               maxLen = 0;
+
+   if(!mdmRead)
+   {
+      if(!blReadMDM(MDM_FILE))
+         return(FALSE);
+      mdmRead = TRUE;
+   }
+
+   if((seq = blPDB2Seq(data->pdb))==NULL)
+      return(FALSE);
+
+   *items = 0;
+   for(seq1=seq; (end=strchr(seq1, '*'))!=NULL; seq1=seq2)
+   {
+      *end = '\0';
+      seq2 = end+1;
+      if(*seq2 == '\0')
+         break;
+      len1 = strlen(seq1);
+      len2 = ((end = strchr(seq2, '*'))!=NULL) ? (int)(end - seq2)
+                                                : (int)strlen(seq2);
+
+      if(len1 + len2 > maxLen)
+      {
+         maxLen = len1 + len2;
+         FREE(align1);
+         FREE(align2);
+         if(((align1 = (char *)malloc(maxLen+1))==NULL) ||
+            ((align2 = (char *)malloc(maxLen+1))==NULL))
+         {
+            FREE(align1);
+            free(seq);
+            return(FALSE);
+         }
+      }
+
+      blAffinealign(seq1, len1, seq2, len2, FALSE, FALSE,
+                    GAP_OPEN, GAP_EXTEND, align1, align2, &alignLen);
+      *items += (ULONG)len1 * (ULONG)len2;
+   }
+
+   FREE(align1);
+   FREE(align2);
+   free(seq);
+   return(*items > 0);
+}
+
+
+/************************************************************************/
+/* Stores an identifier for every atom in a hash and looks each one up
+*/
+static BOOL BenchHash(BENCHDATA *data, ULONG *items)
+{
+   HASHTABLE *hash;
+   PDB       *p;
+   char      key[MAXKEY];
+   int       i;
+   BOOL      ok = TRUE;
+
+   if((hash = blInitializeHash(data->natoms))==NULL)
+      return(FALSE);
+
+   for(p=data->pdb, i=0; p!=NULL; NEXT(p), i++)
+   {
+      sprintf(key, "%s.%d%s.%s", p->chain, p->resnum, p->insert,
+              p->atnam);
+      if(!blSetHashValueInt(hash, key, i))
+         ok = FALSE;
+   }
+   for(p=data->pdb, i=0; p!=NULL; NEXT(p), i++)
+   {
+      sprintf(key, "%s.%d%s.%s", p->chain, p->resnum, p->insert,
+              p->atnam);
+      if(blGetHashValueInt(hash, key) != i)
+         ok = FALSE;
+   }
+
+   blFreeHash(hash);
+   *items = 2 * (ULONG)data->natoms;
+   return(ok);
+}
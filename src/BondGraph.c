@@ -0,0 +1,620 @@
+/************************************************************************/
+/**
+
+   \file       BondGraph.c
+
+   \version    V1.2
+   \date       17.10.26
+   \brief      Compressed sparse row bond graph for PDB linked lists
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Each PDB record holds up to MAXCONECT CONECT pointers. A BONDGRAPH
+   holds the bonds of a whole structure instead, in compressed sparse
+   row form. Each atom's bonds are a contiguous, sorted, row of atom
+   indexes so neighbours are iterated in O(degree) and a bond is looked
+   up by binary search. There is no limit on the number of bonds to an
+   atom.
+
+   A graph is built from CONECT records, from the per-atom CONECT data
+   or geometrically (see blBuildBondGraph() in BuildConect.c). The 
+   whole PDB readers (blReadWholePDB() etc.) store the graph built from
+   the CONECT records in wpdb->bonds. blSetConectsFromBondGraph() then 
+   copies the bonds into the per-atom arrays, which are a view of the 
+   graph holding at most MAXCONECT bonds per atom, so that the existing
+   CONECT routines (blAddConect(), blIsConected(), 
+   blDeleteAtomConects(), blCopyConects()) and writers continue to 
+   work. Changes made through those routines are not copied back to 
+   the graph.
+
+   The graph refers to the atoms of the linked list. It must be rebuilt
+   if atoms are added to or removed from the list.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   BONDGRAPH *graph;
+   int       i, k;
+
+   graph = blBuildBondGraphWholePDB(wpdb);
+   for(i=0; i<graph->natoms; i++)
+   {
+      for(k=0; k<BONDGRAPH_DEGREE(graph, i); k++)
+      {
+         PDB *q = graph->atoms[BONDGRAPH_NEIGHBOUR(graph, i, k)];
+         ...
+      }
+   }
+   blFreeBondGraph(graph);
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 blGetConectPairsWholePDB() uses 
+                  blCreateAtomNumberIndex() and reads hybrid-36 atom
+                  numbers
+-  V1.2  17.10.26 The whole PDB readers keep a graph in wpdb->bonds
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP Bond graphs
+
+   #FUNCTION  blBuildBondGraphPairs()
+   Builds a bond graph from an array of bonded atom pairs
+
+   #FUNCTION  blBuildBondGraphConect()
+   Builds a bond graph from the per-atom CONECT data
+
+   #FUNCTION  blBuildBondGraphWholePDB()
+   Builds a bond graph from the CONECT records of a WHOLEPDB
+
+   #FUNCTION  blFreeBondGraph()
+   Frees a bond graph
+
+   #FUNCTION  blBondGraphAtomIndex()
+   Finds the index of an atom in a bond graph
+
+   #FUNCTION  blBondGraphIsBonded()
+   Tests whether two atoms are bonded
+
+   #FUNCTION  blSetConectsFromBondGraph()
+   Copies the bonds into the per-atom CONECT arrays
+
+   #FUNCTION  blGetConectPairsWholePDB()
+   Gets the bonded atom pairs from the CONECT records of a WHOLEPDB
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdlib.h>
+#include <string.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "pdb.h"
+#include "general.h"
+#include "bondgraph.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static int CmpAtomPointer(const void *a, const void *b);
+static int CmpInt(const void *a, const void *b);
+
+
+/************************************************************************/
+/*>static int CmpAtomPointer(const void *a, const void *b)
+   -------------------------------------------------------
+*//**
+
+   qsort()/bsearch() comparison on the atom pointer of a BONDGRAPHATOM
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CmpAtomPointer(const void *a, const void *b)
+{
+   PDB *pa = ((BONDGRAPHATOM *)a)->atom,
+       *pb = ((BONDGRAPHATOM *)b)->atom;
+
+   if(pa < pb) return(-1);
+   if(pa > pb) return(1);
+   return(0);
+}
+
+
+/************************************************************************/
+/*>static int CmpInt(const void *a, const void *b)
+   -----------------------------------------------
+*//**
+
+   qsort()/bsearch() comparison of ints
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CmpInt(const void *a, const void *b)
+{
+   int ia = *(int *)a,
+       ib = *(int *)b;
+
+   if(ia < ib) return(-1);
+   if(ia > ib) return(1);
+   return(0);
+}
+
+
+/************************************************************************/
+/*>BONDGRAPH *blBuildBondGraphPairs(PDB *pdb, PDB **pairs, int npairs)
+   -------------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \param[in]     **pairs  Bonded atoms: pairs[2*n] is bonded to 
+                           pairs[2*n+1]
+   \param[in]     npairs   Number of pairs
+   \return                 Malloc'd bond graph or NULL on error
+
+   Builds a bond graph for the atoms of a linked list from an array of
+   bonded pairs of atoms. Duplicate pairs and pairs involving a NULL
+   pointer or an atom that is not in the linked list are ignored.
+
+-  17.10.26 Original   By: ACRM
+*/
+BONDGRAPH *blBuildBondGraphPairs(PDB *pdb, PDB **pairs, int npairs)
+{
+   BONDGRAPH     *graph;
+   BONDGRAPHATOM key,
+                 *found;
+   PDB           *p;
+   int           *pairIndex = NULL,
+                 *fill      = NULL,
+                 i, j, k,
+                 nstored;
+
+   if((graph=(BONDGRAPH *)malloc(sizeof(BONDGRAPH)))==NULL)
+      return(NULL);
+   graph->atoms      = NULL;
+   graph->byPointer  = NULL;
+   graph->start      = NULL;
+   graph->neighbours = NULL;
+   graph->natoms     = 0;
+   graph->nbonds     = 0;
+
+   for(p=pdb; p!=NULL; NEXT(p))
+      graph->natoms++;
+
+   if(((graph->atoms=(PDB **)malloc((graph->natoms+1) * 
+                                    sizeof(PDB *)))==NULL) ||
+      ((graph->byPointer=(BONDGRAPHATOM *)malloc((graph->natoms+1) *
+                                         sizeof(BONDGRAPHATOM)))==NULL) ||
+      ((graph->start=(int *)calloc(graph->natoms+1, sizeof(int)))==NULL) ||
+      ((graph->neighbours=(int *)malloc((2*npairs+1) * sizeof(int)))
+       ==NULL) ||
+      ((pairIndex=(int *)malloc((2*npairs+1) * sizeof(int)))==NULL) ||
+      ((fill=(int *)malloc((graph->natoms+1) * sizeof(int)))==NULL))
+   {
+      if(pairIndex!=NULL) free(pairIndex);
+      blFreeBondGraph(graph);
+      return(NULL);
+   }
+
+   for(p=pdb, i=0; p!=NULL; NEXT(p), i++)
+   {
+      graph->atoms[i]           = p;
+      graph->byPointer[i].atom  = p;
+      graph->byPointer[i].index = i;
+   }
+   qsort(graph->byPointer, graph->natoms, sizeof(BONDGRAPHATOM),
+         CmpAtomPointer);
+
+   /* Convert the pairs to atom indexes and count the bonds to each atom
+      (start[i+1] holds the count for atom i at this stage)
+   */
+   for(k=0; k<2*npairs; k++)
+   {
+      pairIndex[k] = -1;
+      if((key.atom = pairs[k])!=NULL)
+      {
+         if((found=(BONDGRAPHATOM *)bsearch(&key, graph->byPointer,
+                                            graph->natoms,
+                                            sizeof(BONDGRAPHATOM),
+                                            CmpAtomPointer))!=NULL)
+            pairIndex[k] = found->index;
+      }
+   }
+   for(k=0; k<npairs; k++)
+   {
+      i = pairIndex[2*k];
+      j = pairIndex[2*k+1];
+      if((i >= 0) && (j >= 0) && (i != j))
+      {
+         graph->start[i+1]++;
+         graph->start[j+1]++;
+      }
+   }
+   for(i=0; i<graph->natoms; i++)
+   {
+      graph->start[i+1] += graph->start[i];
+      fill[i] = graph->start[i];
+   }
+
+   /* Fill in the rows                                                  */
+   for(k=0; k<npairs; k++)
+   {
+      i = pairIndex[2*k];
+      j = pairIndex[2*k+1];
+      if((i >= 0) && (j >= 0) && (i != j))
+      {
+         graph->neighbours[fill[i]++] = j;
+         graph->neighbours[fill[j]++] = i;
+      }
+   }
+   free(pairIndex);
+   free(fill);
+
+   /* Sort each row and squeeze out duplicates                          */
+   nstored = 0;
+   for(i=0; i<graph->natoms; i++)
+   {
+      int rowStart = graph->start[i],
+          rowEnd   = graph->start[i+1];
+
+      qsort(graph->neighbours+rowStart, rowEnd-rowStart, sizeof(int),
+            CmpInt);
+      graph->start[i] = nstored;
+      for(k=rowStart; k<rowEnd; k++)
+      {
+         if((k==rowStart) || 
+            (graph->neighbours[k] != graph->neighbours[k-1]))
+            graph->neighbours[nstored++] = graph->neighbours[k];
+      }
+   }
+   graph->start[graph->natoms] = nstored;
+   graph->nbonds = nstored / 2;
+
+   return(graph);
+}
+
+
+/************************************************************************/
+/*>BONDGRAPH *blBuildBondGraphConect(PDB *pdb)
+   -------------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \return                 Malloc'd bond graph or NULL on error
+
+   Builds a bond graph from the per-atom CONECT data of a linked list.
+   A CONECT stored in only one direction gives a bond in both
+   directions in the graph.
+
+-  17.10.26 Original   By: ACRM
+*/
+BONDGRAPH *blBuildBondGraphConect(PDB *pdb)
+{
+   BONDGRAPH *graph;
+   PDB       *p,
+             **pairs;
+   int       i,
+             npairs = 0;
+
+   for(p=pdb; p!=NULL; NEXT(p))
+      npairs += p->nConect;
+
+   if((pairs=(PDB **)malloc((2*npairs+1) * sizeof(PDB *)))==NULL)
+      return(NULL);
+
+   npairs = 0;
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      for(i=0; i<p->nConect; i++)
+      {
+         pairs[2*npairs]   = p;
+         pairs[2*npairs+1] = p->conect[i];
+         npairs++;
+      }
+   }
+
+   graph = blBuildBondGraphPairs(pdb, pairs, npairs);
+   free(pairs);
+
+   return(graph);
+}
+
+
+/************************************************************************/
+/*>PDB **blGetConectPairsWholePDB(WHOLEPDB *wpdb, int *npairs)
+   -----------------------------------------------------------
+*//**
+
+   \param[in]     *wpdb    Whole PDB structure
+   \param[out]    *npairs  Number of pairs found (-1 on error)
+   \return                 Malloc'd array of bonded atoms: pairs[2*n]
+                           is bonded to pairs[2*n+1]. NULL if there
+                           are no pairs or on error
+
+   Reads the CONECT records stored in the trailer of a WHOLEPDB and
+   returns the pairs of atoms that they link in the order that they
+   appear. Each atom number refers to the first atom in the linked list
+   with that number. Atom numbers that are not found (for example
+   because the atom was an alternate position that was not kept) are
+   skipped.
+
+   Atoms are found through an index sorted by atom number, so the cost
+   is O(NlogN) rather than a scan of the linked list for each CONECT
+   record.
+
+-  17.10.26 Original   By: ACRM
+-  17.10.26 Uses blCreateAtomNumberIndex(). Reads hybrid-36 atom 
+            numbers
+*/
+PDB **blGetConectPairsWholePDB(WHOLEPDB *wpdb, int *npairs)
+{
+   PDBATOMNUMINDEX *index = NULL;
+   STRINGLIST      *s;
+   PDB             *first,
+                   *other,
+                   **pairs  = NULL;
+   int             atoms[5],
+                   maxpairs = 0,
+                   len,
+                   i;
+
+   *npairs = 0;
+
+   /* Count the possible pairs                                          */
+   for(s=wpdb->trailer; s!=NULL; NEXT(s))
+   {
+      if(!strncmp(s->string, "CONECT", 6))
+         maxpairs += 4;
+   }
+   if(maxpairs == 0)
+      return(NULL);
+
+   if(((index=blCreateAtomNumberIndex(wpdb->pdb))==NULL) ||
+      ((pairs=(PDB **)malloc(2 * maxpairs * sizeof(PDB *)))==NULL))
+   {
+      blFreeAtomNumberIndex(index);
+      *npairs = (-1);
+      return(NULL);
+   }
+
+   for(s=wpdb->trailer; s!=NULL; NEXT(s))
+   {
+      if(strncmp(s->string, "CONECT", 6))
+         continue;
+
+      /* Atom numbers are in 5-column fields from column 7 and may be
+         hybrid-36
+      */
+      len = strlen(s->string);
+      for(i=0; i<5; i++)
+      {
+         atoms[i] = 0;
+         if(len > 6+5*i)
+            blDecodeHybrid36(s->string+6+5*i, 5, &atoms[i]);
+      }
+
+      if((atoms[0] == 0) ||
+         ((first = blFindAtomNumber(index, atoms[0]))==NULL))
+         continue;
+
+      for(i=1; i<5; i++)
+      {
+         if(atoms[i] == 0)
+            break;
+         if((other = blFindAtomNumber(index, atoms[i]))!=NULL)
+         {
+            pairs[2*(*npairs)]   = first;
+            pairs[2*(*npairs)+1] = other;
+            (*npairs)++;
+         }
+      }
+   }
+   blFreeAtomNumberIndex(index);
+
+   if(*npairs == 0)
+   {
+      free(pairs);
+      return(NULL);
+   }
+   return(pairs);
+}
+
+
+/************************************************************************/
+/*>BONDGRAPH *blBuildBondGraphWholePDB(WHOLEPDB *wpdb)
+   ---------------------------------------------------
+*//**
+
+   \param[in]     *wpdb    Whole PDB structure
+   \return                 Malloc'd bond graph or NULL on error
+
+   Builds a bond graph from the CONECT records of a PDB file read with
+   one of the whole PDB readers. Unlike the per-atom CONECT data, there
+   is no limit on the number of bonds to an atom. The readers already
+   store such a graph in wpdb->bonds; this is needed only if atoms have
+   since been added or removed.
+
+-  17.10.26 Original   By: ACRM
+*/
+BONDGRAPH *blBuildBondGraphWholePDB(WHOLEPDB *wpdb)
+{
+   BONDGRAPH *graph;
+   PDB       **pairs;
+   int       npairs;
+
+   pairs = blGetConectPairsWholePDB(wpdb, &npairs);
+   if(npairs < 0)
+      return(NULL);
+
+   graph = blBuildBondGraphPairs(wpdb->pdb, pairs, npairs);
+   if(pairs!=NULL)
+      free(pairs);
+
+   return(graph);
+}
+
+
+/************************************************************************/
+/*>void blFreeBondGraph(BONDGRAPH *graph)
+   --------------------------------------
+*//**
+
+   \param[in]     *graph   Bond graph to free
+
+   Frees a bond graph. The atoms are not touched.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeBondGraph(BONDGRAPH *graph)
+{
+   if(graph!=NULL)
+   {
+      if(graph->atoms!=NULL)      free(graph->atoms);
+      if(graph->byPointer!=NULL)  free(graph->byPointer);
+      if(graph->start!=NULL)      free(graph->start);
+      if(graph->neighbours!=NULL) free(graph->neighbours);
+      free(graph);
+   }
+}
+
+
+/************************************************************************/
+/*>int blBondGraphAtomIndex(BONDGRAPH *graph, PDB *p)
+   --------------------------------------------------
+*//**
+
+   \param[in]     *graph   Bond graph
+   \param[in]     *p       An atom
+   \return                 Index of the atom in the graph or -1 if it
+                           is not there
+
+-  17.10.26 Original   By: ACRM
+*/
+int blBondGraphAtomIndex(BONDGRAPH *graph, PDB *p)
+{
+   BONDGRAPHATOM key,
+                 *found;
+
+   key.atom = p;
+   if((found=(BONDGRAPHATOM *)bsearch(&key, graph->byPointer,
+                                      graph->natoms,
+                                      sizeof(BONDGRAPHATOM),
+                                      CmpAtomPointer))!=NULL)
+      return(found->index);
+   return(-1);
+}
+
+
+/************************************************************************/
+/*>BOOL blBondGraphIsBonded(BONDGRAPH *graph, int i, int j)
+   --------------------------------------------------------
+*//**
+
+   \param[in]     *graph   Bond graph
+   \param[in]     i        Index of first atom
+   \param[in]     j        Index of second atom
+   \return                 Are they bonded?
+
+   Tests whether two atoms are bonded with a binary search of the
+   bonds of the first atom
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blBondGraphIsBonded(BONDGRAPH *graph, int i, int j)
+{
+   if((i < 0) || (i >= graph->natoms))
+      return(FALSE);
+
+   if(bsearch(&j, graph->neighbours+graph->start[i], 
+              BONDGRAPH_DEGREE(graph, i), sizeof(int), CmpInt)!=NULL)
+      return(TRUE);
+   return(FALSE);
+}
+
+
+/************************************************************************/
+/*>int blSetConectsFromBondGraph(BONDGRAPH *graph)
+   -----------------------------------------------
+*//**
+
+   \param[in]     *graph   Bond graph
+   \return                 Number of bonds that could not be stored
+
+   Replaces the per-atom CONECT data of the atoms in the graph with the
+   bonds from the graph. An atom can only store MAXCONECT bonds; any
+   more are left out and counted in the return value.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blSetConectsFromBondGraph(BONDGRAPH *graph)
+{
+   PDB *p;
+   int i, k,
+       nDropped = 0;
+
+   for(i=0; i<graph->natoms; i++)
+   {
+      p = graph->atoms[i];
+      p->nConect = 0;
+      for(k=0; k<BONDGRAPH_DEGREE(graph, i); k++)
+      {
+         if(p->nConect < MAXCONECT)
+         {
+            p->conect[p->nConect++] =
+               graph->atoms[BONDGRAPH_NEIGHBOUR(graph, i, k)];
+         }
+         else
+         {
+            nDropped++;
+         }
+      }
+   }
+
+   return(nDropped);
+}
+
@@ -3,12 +3,12 @@
 
    \file       BuildAtomNeighbourPDBList.c
    
-   \version    V1.4
-   \date       19.08.14
+   \version    V1.5
+   \date       17.10.26
    \brief      Build a new PDB linked list containing atos within a given
                distance of a specified residue
    
-   \copyright  (c) Dr. Andrew C. R. Martin, UCL, 1996-2014
+   \copyright  (c) Dr. Andrew C. R. Martin, UCL, 1996-2026
    \author     Dr. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -54,6 +54,11 @@
 -  V1.3  07.07.14 Use bl prefix for functions By: CTP
 -  V1.4  19.08.14 Renamed blBuildAtomNeighbourPDBListAsCopy to 
                   blBuildAtomNeighbourPDBListAsCopy() By: CTP
+-  V1.5  17.10.26 blBuildAtomNeighbourPDBListAsCopy() only examines
+                  residues whose bounds are in range and copies just
+                  the neighbours. CONECTs no longer point to freed
+                  atoms. Added blBuildAtomNeighbourPDBListResBounds()
+                  By: ACRM
 
 *************************************************************************/
 /* Doxygen
@@ -63,6 +68,10 @@
    #FUNCTION  blBuildAtomNeighbourPDBListAsCopy()
    Builds a PDB linked list of atoms neighbouring those in a specified
    residue. 
+
+   #FUNCTION  blBuildAtomNeighbourPDBListResBounds()
+   Builds a PDB linked list of atoms neighbouring those in a residue
+   using residue bounds that have already been calculated
 */
 /************************************************************************/
 /* Includes
@@ -70,10 +79,14 @@
 #include <stdlib.h>
 #include "pdb.h"
 #include "macros.h"
+#include "resbounds.h"
 
 /************************************************************************/
 /* Defines and macros
 */
+#define NULLCOORD(p) (((p)->x > 9999.0) && \
+                      ((p)->y > 9999.0) && \
+                      ((p)->z > 9999.0))
 
 /************************************************************************/
 /* Globals
@@ -82,6 +95,9 @@
 /************************************************************************/
 /* Prototypes
 */
+static BOOL AddNeighbours(PDB **pdbN, PDB **tail, RESBOUND *rb,
+                          RESBOUND *other, REAL NeighbDist);
+static BOOL FixNeighbourConects(PDB *pdbN, PDB *pdb);
 
 /************************************************************************/
 /*>PDB *blBuildAtomNeighbourPDBListAsCopy(PDB *pdb, PDB *pRes,
@@ -99,7 +115,9 @@
                               (NULL if allocations failed)
 
    Builds a PDB linked list of atoms neighbouring those in a specified
-   residue. The input list is unmodified.
+   residue. The input list is unmodified. The atoms are in the order of
+   the input list with their occupancies set to 1.0, and keep their
+   CONECTs to other atoms in the new list.
 
 -  27.08.96 Original   By: ACRM
 -  17.11.05 Fixed freed memory access
@@ -109,67 +127,203 @@
 -  07.07.14 Use bl prefix for functions By: CTP
 -  19.08.14 Renamed function to blBuildAtomNeighbourPDBListAsCopy() 
             By: CTP
+-  17.10.26 Works a residue at a time, skipping residues whose bounds
+            are out of range, and copies just the neighbours. CONECTs
+            to atoms that are not copied are removed   By: ACRM
 */
 PDB *blBuildAtomNeighbourPDBListAsCopy(PDB *pdb, PDB *pRes, 
                                        REAL NeighbDist)
 {
-   PDB  *pdbN  = NULL,
-        *prev  = NULL,
-        *p, *q,
-        *pNext = NULL;
-   REAL DCutSq = NeighbDist * NeighbDist;
-   
-   /* First, simply duplicate the PDB linked list                       */
-   if(!(pdbN = blDupePDB(pdb)))
-      return(NULL);
+   PDBRESIDUE res,
+              otherRes;
+   RESBOUND   rb,
+              other;
+   PDB        *pdbN = NULL,
+              *tail = NULL,
+              *start,
+              *stop;
 
-   /* We'll use the Occ column as a flag                                */
-   for(p=pdbN; p!=NULL; NEXT(p))
-      p->occ = 0.0;
-   
-   /* Find the atom after the residue in which we are interested        */
-   pNext = blFindNextResidue(pRes);
+   /* Find the bounds of the residue in which we are interested         */
+   blSetResBoundRange(&rb, &res, pRes, blFindNextResidue(pRes));
 
-   /* Look at each atom in our residue in turn flagging atoms in the
-      duplicate list which are in range
-   */
-   for(p=pRes; p!=pNext; NEXT(p))
+   /* Work through the residues of the whole structure                  */
+   for(start=pdb; start!=NULL; start=stop)
    {
-      for(q=pdbN; q!=NULL; NEXT(q))
+      stop = blFindNextResidue(start);
+      blSetResBoundRange(&other, &otherRes, start, stop);
+
+      if(!AddNeighbours(&pdbN, &tail, &rb, &other, NeighbDist))
       {
-         if(DISTSQ(p,q) <= DCutSq)
-            q->occ = (REAL)1.0;
+         FREELIST(pdbN, PDB);
+         return(NULL);
       }
    }
-   
-   /* Now run through the linked list removing any items which do not
-      have the Occ flag set
-   */
-   for(p=pdbN, prev=NULL; p!=NULL;)
+
+   if(!FixNeighbourConects(pdbN, pdb))
+   {
+      FREELIST(pdbN, PDB);
+      return(NULL);
+   }
+
+   /* Return the reduced list                                           */
+   return(pdbN);
+}
+
+
+/************************************************************************/
+/*>PDB *blBuildAtomNeighbourPDBListResBounds(RESBOUNDS *bounds,
+                                             RESBOUND *rb,
+                                             REAL NeighbDist)
+   ------------------------------------------------------------
+*//**
+   \param[in]   *bounds      The residue bounds of the whole structure
+   \param[in]   *rb          The bounds of the residue of interest (may
+                             be from a separate structure providing it's
+                             in the same coordinate frame)
+   \param[in]   NeighbDist   Cutoff neighbour distance
+   \return                   PDB linked list of atoms within cutoff
+                             distance of the residue of interest.
+                             (NULL if none or allocations failed)
+
+   As blBuildAtomNeighbourPDBListAsCopy(), but uses bounds that have
+   already been calculated with blAllocResBounds()
+
+-  17.10.26 Original   By: ACRM
+*/
+PDB *blBuildAtomNeighbourPDBListResBounds(RESBOUNDS *bounds,
+                                          RESBOUND *rb,
+                                          REAL NeighbDist)
+{
+   PDB *pdbN = NULL,
+       *tail = NULL;
+   int i;
+
+   for(i=0; i<bounds->nres; i++)
    {
-      if(p->occ < (REAL)0.5)
+      if(!AddNeighbours(&pdbN, &tail, rb, &(bounds->residues[i]),
+                        NeighbDist))
       {
-         if(prev==NULL)
-         {
-            pdbN = p->next;
-            free(p);
-            p=pdbN;
-            continue;
-         }
-         else
-         {
-            prev->next = p->next;
-            free(p);
-            p=prev->next;   /* 17.11.05              Fixed from p->next */
-            continue;
-         }
+         FREELIST(pdbN, PDB);
+         return(NULL);
       }
-      prev = p;
-      NEXT(p);
    }
 
-   /* Return the reduced list                                           */
+   if(!FixNeighbourConects(pdbN, bounds->pdbs->pdb))
+   {
+      FREELIST(pdbN, PDB);
+      return(NULL);
+   }
+
    return(pdbN);
 }
 
 
+/************************************************************************/
+/*>static BOOL AddNeighbours(PDB **pdbN, PDB **tail, RESBOUND *rb,
+                             RESBOUND *other, REAL NeighbDist)
+   ---------------------------------------------------------------
+*//**
+   \param[in,out] **pdbN       Start of the list of neighbours
+   \param[in,out] **tail       Last item in the list of neighbours
+   \param[in]     *rb          Bounds of the residue of interest
+   \param[in]     *other       Bounds of the residue to search
+   \param[in]     NeighbDist   Cutoff neighbour distance
+   \return                     Success?
+
+   Appends copies of the atoms in the other residue that are within
+   NeighbDist of an atom of the residue of interest. Their occupancies
+   are set to 1.0. A real atom can only be in range of a real atom if
+   it lies within NeighbDist of the sphere bounding the residue of
+   interest. Atoms with NULL coordinates are not in the bounds, so are
+   always tested.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL AddNeighbours(PDB **pdbN, PDB **tail, RESBOUND *rb,
+                          RESBOUND *other, REAL NeighbDist)
+{
+   PDB  *p, *q,
+        *n      = *tail;
+   REAL DCutSq  = NeighbDist * NeighbDist,
+        reach   = rb->radius + NeighbDist;
+   BOOL inRange = blResBoundsWithin(rb, other, NeighbDist);
+
+   if(!inRange && !rb->nullAtoms && !other->nullAtoms)
+      return(TRUE);
+
+   for(q=other->residue->start; q!=other->residue->stop; NEXT(q))
+   {
+      BOOL qNull = NULLCOORD(q),
+           near  = (inRange && !qNull &&
+                    (DISTSQ(q, &(rb->cg)) <= reach*reach));
+
+      if(!near && !qNull && !rb->nullAtoms)
+         continue;
+
+      for(p=rb->residue->start; p!=rb->residue->stop; NEXT(p))
+      {
+         if((near || qNull || NULLCOORD(p)) && (DISTSQ(p, q) <= DCutSq))
+            break;
+      }
+      if(p == rb->residue->stop)
+         continue;
+
+      if(n == NULL)
+      {
+         INIT(n, PDB);
+         *pdbN = n;
+      }
+      else
+      {
+         ALLOCNEXT(n, PDB);
+      }
+      if(n == NULL)
+         return(FALSE);
+      *tail = n;
+
+      blCopyPDB(n, q);
+      n->occ = (REAL)1.0;
+   }
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static BOOL FixNeighbourConects(PDB *pdbN, PDB *pdb)
+   ----------------------------------------------------
+*//**
+   \param[in,out] *pdbN    List of neighbours copied from pdb
+   \param[in]     *pdb     The original list
+   \return                 Success?
+
+   Points the CONECTs of the copied atoms at the copies and removes
+   those to atoms that were not copied.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL FixNeighbourConects(PDB *pdbN, PDB *pdb)
+{
+   PDB *p;
+
+   if(pdbN == NULL)
+      return(TRUE);
+
+   if(!blCopyConects(pdbN, pdb))
+      return(FALSE);
+
+   for(p=pdbN; p!=NULL; NEXT(p))
+   {
+      int i, j;
+
+      for(i=j=0; i<p->nConect; i++)
+      {
+         if(p->conect[i] != NULL)
+            p->conect[j++] = p->conect[i];
+      }
+      p->nConect = j;
+   }
+
+   return(TRUE);
+}
+
@@ -3,11 +3,11 @@
 
    \file       BuildConect.c
    
-   \version    V1.7
-   \date       05.11.21
+   \version    V1.12
+   \date       17.10.26
    \brief      Build connectivity information in PDB linked list
    
-   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2002-2021
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2002-2026
    \author     Prof. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -56,6 +56,15 @@
 -  V1.5  03.10.16 Added <stdlib.h>
 -  V1.6  29.08.18 Added check on MAXCONECT in blDeleteAConectByNum()
 -  V1.7  05.11.21 blIsBonded() checks for dummy coordinates
+-  V1.8  17.10.26 Added blBuildBondGraph(). blBuildConectData() now uses
+                  it so atoms are paired through a spatial grid rather
+                  than by testing every pair of atoms
+-  V1.9  17.10.26 blCopyConects() uses blCreateAtomNumberIndex()
+-  V1.10 17.10.26 blBuildBondGraph() counts the neighbour pairs tested
+                  and is timed when compiled with INSTRUMENT_SUPPORT
+-  V1.11 17.10.26 Added blCovalentRadius()
+-  V1.12 17.10.26 blAreResiduePointersBonded() rejects distant residues
+                  using their bounds. Added blAreResBoundsBonded()
 
 *************************************************************************/
 /* Doxygen
@@ -66,6 +75,9 @@
    #FUNCTION blBuildConectData()
    Rebuild all CONECT data using covalent radii of the atoms
 
+   #FUNCTION blBuildBondGraph()
+   Build a bond graph using covalent radii of the atoms
+
    #FUNCTION blAddConect()
    Adds a CONECT in both directions between two specified atoms
 
@@ -103,6 +115,12 @@
 
    #FUNCTION blIsConected()
    Tests whether two atoms are listed as connected in the CONECT records
+
+   #FUNCTION blCovalentRadius()
+   Returns the covalent radius used for an element
+
+   #FUNCTION blAreResBoundsBonded()
+   Tests whether two residues are bonded using their bounds
 */
 /************************************************************************/
 /* Includes
@@ -111,6 +129,10 @@
 #include <stdlib.h>
 #include "macros.h"
 #include "pdb.h"
+#include "atomgrid.h"
+#include "bondgraph.h"
+#include "instrument.h"
+#include "resbounds.h"
 
 /************************************************************************/
 /* Defines and macros
@@ -156,6 +178,7 @@ static struct _covalentradii covalentRadii[] =
 /* Prototypes
 */
 static REAL findCovalentRadius(char *element);
+static BOOL ResBoundsBonded(RESBOUND *rb1, RESBOUND *rb2, REAL tol);
 
 
 /************************************************************************/
@@ -243,20 +266,21 @@ BOOL blAddOneDirectionConect(PDB *p, PDB *q)
    Deletes all current connectivity data and rebuilds it using covalent
    radii data. A return of FALSE indicates that there were too many
    connections for an atom. If this happens, MAXCONECT needs to be 
-   increased in pdb.h
+   increased in pdb.h or the bonds should be obtained with 
+   blBuildBondGraph() which has no limit.
 
 -  19.02.15  Original   By: ACRM
 -  26.02.15  Added tol paramater
 -  12.05.15  Conects are built involving backbone C and N if either atom
              is a HETATM
+-  17.10.26  Now builds a bond graph with blBuildBondGraph() and copies
+             it to the CONECT arrays
 */
 BOOL blBuildConectData(PDB *pdb, REAL tol)
 {
-   PDB  *p, 
-        *q,
-        *res,
-        *nextRes;
-   BOOL retval=TRUE;
+   BONDGRAPH *graph;
+   PDB       *p;
+   int       nDropped;
 
    /* Clear all current connect data                                    */
    for(p=pdb; p!=NULL; NEXT(p))
@@ -264,50 +288,166 @@ BOOL blBuildConectData(PDB *pdb, REAL tol)
       p->nConect = 0;
    }
 
+   if((graph = blBuildBondGraph(pdb, tol))==NULL)
+      return(FALSE);
+
+   nDropped = blSetConectsFromBondGraph(graph);
+   blFreeBondGraph(graph);
+
+   return((nDropped==0)?TRUE:FALSE);
+}
+
+
+/************************************************************************/
+/*>BONDGRAPH *blBuildBondGraph(PDB *pdb, REAL tol)
+   -----------------------------------------------
+*//**
+   \param[in]       *pdb   PDB linked list
+   \param[in]       tol    Tolerence for distance between atoms
+   \return                 Malloc'd bond graph or NULL on error
+
+   Builds a bond graph using covalent radii data, with the same rules
+   as blBuildConectData(): bonds within a residue are only made if one
+   of the atoms is a HETATM and the peptide bond between a backbone C
+   and the N of a following residue is left out unless one of them is 
+   a HETATM. Candidate atoms are found with a spatial grid so the time
+   taken is proportional to the number of atoms.
+
+-  17.10.26  Original   By: ACRM
+*/
+BONDGRAPH *blBuildBondGraph(PDB *pdb, REAL tol)
+{
+   BONDGRAPH *graph     = NULL;
+   ATOMGRID  *grid      = NULL;
+   PDB       *p, *q,
+             *res,
+             *nextRes,
+             **atoms    = NULL,
+             **gridAtoms = NULL,
+             **pairs    = NULL;
+   REAL      *radius    = NULL,
+             maxRadius  = (REAL)0.0;
+   int       *resIndex  = NULL,
+             *gridIndex = NULL,
+             *neighbours = NULL,
+             maxNeighb  = 0,
+             natoms     = 0,
+             nGrid      = 0,
+             npairs     = 0,
+             maxpairs   = 0,
+             nNeighb,
+             i, j, k;
+
+   BLTIMERSTART(BLTIMER_CONECT);
+
+   for(p=pdb; p!=NULL; NEXT(p))
+      natoms++;
+
+   if(((atoms=(PDB **)malloc((natoms+1) * sizeof(PDB *)))==NULL)      ||
+      ((gridAtoms=(PDB **)malloc((natoms+1) * sizeof(PDB *)))==NULL)  ||
+      ((gridIndex=(int *)malloc((natoms+1) * sizeof(int)))==NULL)     ||
+      ((resIndex=(int *)malloc((natoms+1) * sizeof(int)))==NULL)      ||
+      ((radius=(REAL *)malloc((natoms+1) * sizeof(REAL)))==NULL))
+      goto Cleanup;
+
+   /* Number the residues and find the covalent radius of each atom. 
+      Atoms with dummy coordinates are left out of the grid as they can
+      not be bonded
+   */
+   i = 0;
+   k = 0;
    for(res=pdb; res!=NULL; res=nextRes)
    {
       nextRes = blFindNextResidue(res);
-
-      /* Check for any HETATM connections within this residue           */
       for(p=res; p!=nextRes; NEXT(p))
       {
-         for(q=p->next; q!=nextRes; NEXT(q))
+         atoms[i]    = p;
+         resIndex[i] = k;
+         radius[i]   = findCovalentRadius(p->element);
+         if(radius[i] > maxRadius)
+            maxRadius = radius[i];
+         if(!((p->x > 9999.0) && (p->y > 9999.0) && (p->z > 9999.0)))
          {
-            if(!strncmp(p->record_type, "HETATM", 6) ||
-               !strncmp(q->record_type, "HETATM", 6))
-            {
-               if(blIsBonded(p, q, tol))
-               {
-                  if(!blAddConect(p,q))
-                     retval=FALSE;
-               }
-            }
+            gridAtoms[nGrid] = p;
+            gridIndex[nGrid] = i;
+            nGrid++;
          }
+         i++;
       }
+      k++;
+   }
 
-      /* Check for connections between residues which don't involve backbone
-         C or N, or do involve HETATMS
-      */
-      for(p=res; p!=nextRes; NEXT(p))
+   if((grid = blBuildAtomGrid(gridAtoms, nGrid, 
+                              2*maxRadius + tol))==NULL)
+      goto Cleanup;
+
+   /* Find the bonds. Each pair is tested from its first atom           */
+   for(k=0; k<nGrid; k++)
+   {
+      i = gridIndex[k];
+      p = atoms[i];
+      nNeighb = blFindAtomGridNeighbours(grid, p->x, p->y, p->z,
+                                         radius[i] + maxRadius + tol,
+                                         &neighbours, &maxNeighb);
+      if(nNeighb < 0)
+         goto Cleanup;
+      BLCOUNT(BLCOUNT_PAIRS_TESTED, nNeighb);
+
+      for(j=0; j<nNeighb; j++)
       {
-         for(q=nextRes; q!=NULL; NEXT(q))
+         int  jAtom = gridIndex[neighbours[j]];
+         BOOL hetatm;
+
+         if(jAtom <= i)
+            continue;
+         q = atoms[jAtom];
+
+         hetatm = (!strncmp(p->record_type, "HETATM", 6) ||
+                   !strncmp(q->record_type, "HETATM", 6));
+         if(resIndex[i] == resIndex[jAtom])
+         {
+            if(!hetatm)
+               continue;
+         }
+         else if(!strncmp(p->atnam, "C   ", 4) &&
+                 !strncmp(q->atnam, "N   ", 4) &&
+                 !hetatm)
          {
-            if(strncmp(p->atnam, "C   ", 4) ||
-               strncmp(q->atnam, "N   ", 4) ||
-               !strncmp(p->record_type, "HETATM", 6) ||
-               !strncmp(q->record_type, "HETATM", 6))
+            continue;
+         }
+
+         if(blIsBonded(p, q, tol))
+         {
+            if(npairs >= maxpairs)
             {
-               if(blIsBonded(p, q, tol))
-               {
-                  if(!blAddConect(p,q))
-                     retval=FALSE;
-               }
+               PDB **tmp;
+               maxpairs = (maxpairs < 1024) ? 1024 : 2 * maxpairs;
+               if((tmp=(PDB **)realloc(pairs, 2 * maxpairs * 
+                                       sizeof(PDB *)))==NULL)
+                  goto Cleanup;
+               pairs = tmp;
             }
+            pairs[2*npairs]   = p;
+            pairs[2*npairs+1] = q;
+            npairs++;
          }
       }
    }
 
-   return(retval);
+   graph = blBuildBondGraphPairs(pdb, pairs, npairs);
+
+Cleanup:
+   if(atoms!=NULL)      free(atoms);
+   if(gridAtoms!=NULL)  free(gridAtoms);
+   if(gridIndex!=NULL)  free(gridIndex);
+   if(resIndex!=NULL)   free(resIndex);
+   if(radius!=NULL)     free(radius);
+   if(neighbours!=NULL) free(neighbours);
+   if(pairs!=NULL)      free(pairs);
+   if(grid!=NULL)       blFreeAtomGrid(grid);
+
+   BLTIMERSTOP(BLTIMER_CONECT);
+   return(graph);
 }
 
 
@@ -402,35 +542,98 @@ BOOL blAreResiduesBonded(PDB *pdb,
    residues
 
 -  23.06.15 Original   By: ACRM
+-  17.10.26 Rejects residues whose bounds are too far apart before
+            testing the atoms   By: ACRM
 */
 BOOL blAreResiduePointersBonded(PDB *res1, PDB *res2, REAL tol)
 {
-   PDB *res1next,
-       *res2next,
-       *p,
+   PDBRESIDUE r1, r2;
+   RESBOUND   rb1, rb2;
+
+   if((res1 == NULL) || (res2 == NULL))
+      return(FALSE);
+
+   blSetResBoundRange(&rb1, &r1, res1, blFindNextResidue(res1));
+   blSetResBoundRange(&rb2, &r2, res2, blFindNextResidue(res2));
+   return(ResBoundsBonded(&rb1, &rb2, tol));
+}
+
+
+/************************************************************************/
+/*>BOOL blAreResBoundsBonded(RESBOUND *rb1, RESBOUND *rb2, REAL tol)
+   -----------------------------------------------------------------
+*//**
+   \param[in]   *rb1     The bounds of the first residue
+   \param[in]   *rb2     The bounds of the second residue
+   \param[in]   tol      Tolerance for distances
+   \return               Are they bonded
+
+   As blAreResiduePointersBonded(), but uses bounds that have already
+   been calculated with blAllocResBounds()
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blAreResBoundsBonded(RESBOUND *rb1, RESBOUND *rb2, REAL tol)
+{
+   return(ResBoundsBonded(rb1, rb2, tol));
+}
+
+
+/************************************************************************/
+/*>static BOOL ResBoundsBonded(RESBOUND *rb1, RESBOUND *rb2, REAL tol)
+   -------------------------------------------------------------------
+*//**
+   \param[in]   *rb1     The bounds of the first residue
+   \param[in]   *rb2     The bounds of the second residue
+   \param[in]   tol      Tolerance for distances
+   \return               Are they bonded
+
+   Residues further apart than the longest bond their atoms could make
+   are rejected; otherwise the atoms are tested in turn. blIsBonded()
+   ignores atoms with NULL coordinates, as do the bounds.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL ResBoundsBonded(RESBOUND *rb1, RESBOUND *rb2, REAL tol)
+{
+   PDB *p,
        *q;
 
-   if((res1 != NULL) && (res2 != NULL))
-   {
-      /* Find the following residues                                    */
-      res1next = blFindNextResidue(res1);
-      res2next = blFindNextResidue(res2);
+   if(!blResBoundsWithin(rb1, rb2, rb1->maxCovRad + rb2->maxCovRad + tol))
+      return(FALSE);
 
-      /* Step through the atoms in each residue and see if they are
-         bonded
-      */
-      for(p=res1; p!=res1next; NEXT(p))
+   /* Step through the atoms in each residue and see if they are
+      bonded
+   */
+   for(p=rb1->residue->start; p!=rb1->residue->stop; NEXT(p))
+   {
+      for(q=rb2->residue->start; q!=rb2->residue->stop; NEXT(q))
       {
-         for(q=res2; q!=res2next; NEXT(q))
-         {
-            if(blIsBonded(p, q, tol))
-               return(TRUE);
-         }
+         if(blIsBonded(p, q, tol))
+            return(TRUE);
       }
    }
    return(FALSE);
 }
 
+/************************************************************************/
+/*>REAL blCovalentRadius(char *element)
+   ------------------------------------
+*//**
+   \param[in]   *element   The element type
+   \return                 The covalent bonding radius of the atom
+
+   Returns the covalent radius used when building CONECTs. Unknown
+   elements are given a radius of 1.0
+
+-  17.10.26  Original   By: ACRM
+*/
+REAL blCovalentRadius(char *element)
+{
+   return(findCovalentRadius(element));
+}
+
+
 /************************************************************************/
 /*>static REAL findCovalentRadius(char *element)
    ---------------------------------------------
@@ -584,15 +787,16 @@ void blDeleteAtomConects(PDB *pdb)
    old one.
 
 -  17.04.15  Original   By: ACRM
+-  17.10.26  Uses blCreateAtomNumberIndex() so memory no longer grows
+             with the largest atom number   By: ACRM
 */
 BOOL blCopyConects(PDB *out, PDB *in)
 {
-   PDB **idxOut = NULL,
-       *p;
-   int indexSize = 0;
+   PDBATOMNUMINDEX *idxOut = NULL;
+   PDB             *p;
    
-   /* Create an indices by atom number                                  */
-   if((idxOut = blIndexAtomNumbersPDB(out, &indexSize))==NULL)
+   /* Create an index by atom number                                    */
+   if((idxOut = blCreateAtomNumberIndex(out))==NULL)
       return(FALSE);
    
    /* Step through the output linked list                               */
@@ -607,23 +811,16 @@ BOOL blCopyConects(PDB *out, PDB *in)
       {
          if(p->conect[i] != NULL)
          {
-            int atomNum;
-            PDB *newPtr = NULL;
-         
-            /* Find the atom number from old linked list                */
-            atomNum = (p->conect[i])->atnum;
-            
-            /* Look up the pointer for this in the new linked list index*/
-            if(atomNum < indexSize)
-               newPtr = idxOut[atomNum];
-
-            /* Reset pointer                                            */
-            p->conect[i] = newPtr;
+            /* Look up the atom number from the old linked list in the
+               new linked list
+            */
+            p->conect[i] = blFindAtomNumber(idxOut, 
+                                            (p->conect[i])->atnum);
          }
       }
    }
 
-   free(idxOut);
+   blFreeAtomNumberIndex(idxOut);
    return(TRUE);
 }
 
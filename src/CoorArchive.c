@@ -0,0 +1,969 @@
+/************************************************************************/
+/**
+
+   \file       CoorArchive.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Compressed multi-model coordinate archives
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Stores many frames of coordinates that share one topology (an NMR
+   ensemble or the snapshots of a molecular dynamics run) in a compact
+   binary file from which any frame can be read directly. Only the
+   coordinates are stored; the atoms themselves are kept in an ordinary
+   PDB file and each frame is decoded into a PDB linked list (or an
+   array) read from that file.
+
+   Coordinates are rounded to a fixed precision (0.001A by default, as
+   in a PDB file) and held as integers. A key frame stores the 
+   difference of each coordinate from the same coordinate of the 
+   previous atom, which is small since neighbouring atoms in the list 
+   are close in space. Any other frame stores the differences from the
+   coordinates of its key frame. Each difference is written as a 
+   variable length integer of 7 bits per byte, so most take one or two
+   bytes rather than the 8 characters of a PDB file. Every frame is
+   encoded both ways and the shorter is kept; when the encoding as
+   differences from the key frame becomes the longer, as a simulation
+   drifts away from it, the frame becomes the new key frame.
+
+   An index of the offset and key frame of each frame is written at the
+   end of the file, so a frame is read with at most two seeks. The 
+   most recent key frame is cached, so frames read in order normally
+   need only one.
+
+   The file is laid out as follows. All integers are unsigned and
+   little-endian.
+
+   Header     "BLCA", version (4 bytes), number of atoms (4 bytes),
+              quantised units per Angstrom (4 bytes)
+   Frames     Type (1 byte; 0 = key frame, 1 = differences from the key
+              frame) followed by 3 variable-length integers per atom 
+              (zigzag coded so small negative numbers are also short)
+   Index      For each frame, its offset (8 bytes) and key frame 
+              (4 bytes)
+   Trailer    Offset of the index (8 bytes), number of frames (4 bytes),
+              "BLCI"
+
+   The whole file must be the archive and it must be opened in binary
+   mode. Reading needs a file which can be seeked; writing does not.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   arc = blCreateCoorArchive(fp, natoms, COORARC_PRECISION);
+   nframes = blWriteCoorArchiveModelsPDB(arc, pdb);
+   blCloseCoorArchive(arc);
+\endcode
+
+   writes each model of a PDB linked list read with blReadPDBAll() as a
+   frame; blWriteCoorArchiveFramePDB() and blWriteCoorArchiveFrame()
+   write one frame at a time. Then
+
+\code
+   arc = blOpenCoorArchive(fp);
+   for(i=0; i<arc->nframes; i++)
+   {
+      blReadCoorArchiveFramePDB(arc, i, pdb);
+      ...
+   }
+   blCloseCoorArchive(arc);
+\endcode
+
+   overwrites the coordinates of the first arc->natoms atoms of a PDB
+   linked list with each frame in turn.
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP File IO
+
+   #FUNCTION  blCreateCoorArchive()
+   Starts writing a coordinate archive
+
+   #FUNCTION  blWriteCoorArchiveFrame()
+   Writes a frame from an array of coordinates
+
+   #FUNCTION  blWriteCoorArchiveFramePDB()
+   Writes a frame from a PDB linked list
+
+   #FUNCTION  blWriteCoorArchiveModelsPDB()
+   Writes each model of a PDB linked list as a frame
+
+   #FUNCTION  blOpenCoorArchive()
+   Opens a coordinate archive for reading
+
+   #FUNCTION  blReadCoorArchiveFrame()
+   Reads a frame into an array of coordinates
+
+   #FUNCTION  blReadCoorArchiveFramePDB()
+   Reads a frame into a PDB linked list
+
+   #FUNCTION  blCloseCoorArchive()
+   Finishes writing or reading a coordinate archive
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "pdb.h"
+#include "coorarchive.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define HEADER_MAGIC   "BLCA"
+#define TRAILER_MAGIC  "BLCI"
+#define ARCHIVE_VERSION 1
+#define HEADER_SIZE    16
+#define TRAILER_SIZE   16
+#define INDEX_SIZE     12             /* Bytes per frame in the index   */
+#define FRAME_KEY      0
+#define FRAME_DELTA    1
+#define FRAMES_STEP    64
+
+/* Largest encoded frame: a type byte and 3 integers of up to 5 bytes
+   per atom
+*/
+#define FRAMESIZE(natoms) (1 + 15 * (long)(natoms))
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static void PutUnsigned(UBYTE *buffer, ULONG value, int nbytes);
+static ULONG GetUnsigned(UBYTE *buffer, int nbytes);
+static int PutVarint(UBYTE *buffer, long value);
+static BOOL GetVarint(UBYTE **pBuffer, UBYTE *end, long *value);
+static COORARCHIVE *AllocArchive(FILE *fp, int natoms, BOOL writing);
+static BOOL Quantise(REAL x, long scale, long *q);
+static BOOL QuantisePDB(COORARCHIVE *arc, PDB **pPDB);
+static BOOL EncodeFrame(COORARCHIVE *arc);
+static long ReadFrame(COORARCHIVE *arc, int frame, int type);
+static long *DecodeFrame(COORARCHIVE *arc, int frame);
+
+
+/************************************************************************/
+/*>static void PutUnsigned(UBYTE *buffer, ULONG value, int nbytes)
+   ---------------------------------------------------------------
+*//**
+
+   \param[out]    *buffer   Buffer of at least nbytes
+   \param[in]     value     Value to store
+   \param[in]     nbytes    Number of bytes to use
+
+   Stores an unsigned value least significant byte first. Bytes beyond
+   the size of a ULONG are zero.
+
+-  17.10.26 Original   By: ACRM
+*/
+static void PutUnsigned(UBYTE *buffer, ULONG value, int nbytes)
+{
+   int i;
+
+   for(i=0; i<nbytes; i++)
+   {
+      buffer[i] = (UBYTE)(value & 0xff);
+      value >>= 8;
+   }
+}
+
+
+/************************************************************************/
+/*>static ULONG GetUnsigned(UBYTE *buffer, int nbytes)
+   ---------------------------------------------------
+*//**
+
+   \param[in]     *buffer   Buffer of at least nbytes
+   \param[in]     nbytes    Number of bytes to read
+   \return                  The value
+
+   Reads an unsigned value stored least significant byte first.
+
+-  17.10.26 Original   By: ACRM
+*/
+static ULONG GetUnsigned(UBYTE *buffer, int nbytes)
+{
+   ULONG value = 0;
+   int   i;
+
+   for(i=nbytes-1; i>=0; i--)
+      value = (value << 8) | buffer[i];
+   
+   return(value);
+}
+
+
+/************************************************************************/
+/*>static int PutVarint(UBYTE *buffer, long value)
+   -----------------------------------------------
+*//**
+
+   \param[out]    *buffer   Buffer of at least 5 bytes
+   \param[in]     value     Value to store (|value| < 2^31)
+   \return                  Number of bytes used
+
+   Stores a signed value as a variable length integer. The value is
+   zigzag coded (0, -1, 1, -2, 2... become 0, 1, 2, 3, 4...) and then
+   written 7 bits per byte, least significant first, with the top bit
+   set on all but the last byte.
+
+-  17.10.26 Original   By: ACRM
+*/
+static int PutVarint(UBYTE *buffer, long value)
+{
+   ULONG zz;
+   int   n = 0;
+
+   zz = (value >= 0) ? ((ULONG)value << 1) 
+                     : (((ULONG)(-(value + 1)) << 1) | 1);
+   while(zz >= 0x80)
+   {
+      buffer[n++] = (UBYTE)((zz & 0x7f) | 0x80);
+      zz >>= 7;
+   }
+   buffer[n++] = (UBYTE)zz;
+
+   return(n);
+}
+
+
+/************************************************************************/
+/*>static BOOL GetVarint(UBYTE **pBuffer, UBYTE *end, long *value)
+   ---------------------------------------------------------------
+*//**
+
+   \param[in,out] **pBuffer Position in the buffer. Updated past the
+                            value
+   \param[in]     *end      End of the buffer
+   \param[out]    *value    The value
+   \return                  Success (FALSE if the buffer ends in the
+                            value or it is too long)
+
+   Reads a value written by PutVarint()
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL GetVarint(UBYTE **pBuffer, UBYTE *end, long *value)
+{
+   UBYTE *p    = *pBuffer;
+   ULONG zz    = 0;
+   int   shift = 0;
+
+   do
+   {
+      if((p >= end) || (shift > 28))
+         return(FALSE);
+      zz |= (ULONG)(*p & 0x7f) << shift;
+      shift += 7;
+   }  while(*(p++) & 0x80);
+
+   *value   = (zz & 1) ? -(long)(zz >> 1) - 1 : (long)(zz >> 1);
+   *pBuffer = p;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static COORARCHIVE *AllocArchive(FILE *fp, int natoms, BOOL writing)
+   --------------------------------------------------------------------
+*//**
+
+   \param[in]     *fp       Archive file
+   \param[in]     natoms    Atoms per frame
+   \param[in]     writing   Opened for writing
+   \return                  Archive with coordinate and frame buffers
+                            but no frame index (NULL if no memory)
+
+-  17.10.26 Original   By: ACRM
+*/
+static COORARCHIVE *AllocArchive(FILE *fp, int natoms, BOOL writing)
+{
+   COORARCHIVE *arc;
+   
+   if((arc = (COORARCHIVE *)malloc(sizeof(COORARCHIVE)))==NULL)
+      return(NULL);
+
+   arc->fp        = fp;
+   arc->offsets   = NULL;
+   arc->keyFrame  = NULL;
+   arc->natoms    = natoms;
+   arc->nframes   = 0;
+   arc->maxFrames = 0;
+   arc->cachedKey = -1;
+   arc->scale     = 1;
+   arc->offset    = 0;
+   arc->writing   = writing;
+   arc->key       = (long *)malloc(3 * natoms * sizeof(long));
+   arc->work      = (long *)malloc(3 * natoms * sizeof(long));
+   /* Writing needs room for a frame encoded both ways                  */
+   arc->buffer    = (UBYTE *)malloc((writing ? 2 : 1) * 
+                                    FRAMESIZE(natoms) * sizeof(UBYTE));
+   
+   if((arc->key == NULL) || (arc->work == NULL) || (arc->buffer == NULL))
+   {
+      arc->writing = FALSE;
+      blCloseCoorArchive(arc);
+      return(NULL);
+   }
+   
+   return(arc);
+}
+
+
+/************************************************************************/
+/*>static BOOL Quantise(REAL x, long scale, long *q)
+   -------------------------------------------------
+*//**
+
+   \param[in]     x         Coordinate
+   \param[in]     scale     Quantised units per Angstrom
+   \param[out]    *q        Nearest quantised coordinate
+   \return                  Success (FALSE if out of range)
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL Quantise(REAL x, long scale, long *q)
+{
+   REAL v = x * scale;
+   
+   if((v > (REAL)COORARC_MAXCOOR) || (v < -(REAL)COORARC_MAXCOOR))
+      return(FALSE);
+   *q = (long)floor(v + 0.5);
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static BOOL QuantisePDB(COORARCHIVE *arc, PDB **pPDB)
+   -----------------------------------------------------
+*//**
+
+   \param[in,out] *arc      Archive. The coordinates are placed in 
+                            arc->work
+   \param[in,out] **pPDB    First atom of the frame. Updated to the atom
+                            after the frame
+   \return                  Success (FALSE if the list has too few atoms
+                            or a coordinate is out of range)
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL QuantisePDB(COORARCHIVE *arc, PDB **pPDB)
+{
+   PDB  *p = *pPDB;
+   long *q = arc->work;
+   int  i;
+   
+   for(i=0; i<arc->natoms; i++, NEXT(p))
+   {
+      if((p == NULL)                      ||
+         !Quantise(p->x, arc->scale, q)   ||
+         !Quantise(p->y, arc->scale, q+1) ||
+         !Quantise(p->z, arc->scale, q+2))
+         return(FALSE);
+      q += 3;
+   }
+
+   *pPDB = p;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static BOOL EncodeFrame(COORARCHIVE *arc)
+   -----------------------------------------
+*//**
+
+   \param[in,out] *arc      Archive with the quantised frame in 
+                            arc->work
+   \return                  Success
+
+   Encodes the frame both as a key frame and as differences from the 
+   current key frame and writes the shorter. If it is written as a key
+   frame, it becomes the current key frame.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL EncodeFrame(COORARCHIVE *arc)
+{
+   UBYTE *keyBuff   = arc->buffer,
+         *deltaBuff = arc->buffer + FRAMESIZE(arc->natoms),
+         *out;
+   long  prev[3],
+         nKey       = 1,
+         nDelta     = 0,
+         nOut;
+   int   ncoor      = 3 * arc->natoms,
+         i;
+
+   /* Make room in the index                                            */
+   if(arc->nframes == arc->maxFrames)
+   {
+      long *offsets;
+      int  *keyFrame;
+      
+      if((offsets = (long *)realloc(arc->offsets, 
+                                    (arc->maxFrames + FRAMES_STEP) * 
+                                    sizeof(long)))==NULL)
+         return(FALSE);
+      arc->offsets = offsets;
+      if((keyFrame = (int *)realloc(arc->keyFrame, 
+                                    (arc->maxFrames + FRAMES_STEP) *
+                                    sizeof(int)))==NULL)
+         return(FALSE);
+      arc->keyFrame   = keyFrame;
+      arc->maxFrames += FRAMES_STEP;
+   }
+
+   /* As a key frame: differences between consecutive atoms             */
+   keyBuff[0] = FRAME_KEY;
+   prev[0] = prev[1] = prev[2] = 0;
+   for(i=0; i<ncoor; i++)
+   {
+      nKey       += PutVarint(keyBuff + nKey, arc->work[i] - prev[i%3]);
+      prev[i%3]   = arc->work[i];
+   }
+   
+   /* As differences from the key frame, giving up once it is longer    */
+   if(arc->cachedKey >= 0)
+   {
+      deltaBuff[0] = FRAME_DELTA;
+      nDelta       = 1;
+      for(i=0; (i<ncoor) && (nDelta < nKey); i++)
+         nDelta += PutVarint(deltaBuff + nDelta, 
+                             arc->work[i] - arc->key[i]);
+   }
+
+   if((nDelta > 0) && (nDelta < nKey))
+   {
+      out  = deltaBuff;
+      nOut = nDelta;
+      arc->keyFrame[arc->nframes] = arc->cachedKey;
+   }
+   else
+   {
+      out  = keyBuff;
+      nOut = nKey;
+      memcpy(arc->key, arc->work, ncoor * sizeof(long));
+      arc->cachedKey = arc->nframes;
+      arc->keyFrame[arc->nframes] = arc->nframes;
+   }
+
+   if(fwrite(out, sizeof(UBYTE), (size_t)nOut, arc->fp) != (size_t)nOut)
+      return(FALSE);
+   
+   arc->offsets[arc->nframes++] = arc->offset;
+   arc->offset += nOut;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static long ReadFrame(COORARCHIVE *arc, int frame, int type)
+   ------------------------------------------------------------
+*//**
+
+   \param[in,out] *arc      Archive
+   \param[in]     frame     Frame number
+   \param[in]     type      Expected type of frame
+   \return                  Bytes read into arc->buffer after the type
+                            byte (-1 on error)
+
+-  17.10.26 Original   By: ACRM
+*/
+static long ReadFrame(COORARCHIVE *arc, int frame, int type)
+{
+   long size = arc->offsets[frame+1] - arc->offsets[frame];
+   
+   if(fseek(arc->fp, arc->offsets[frame], SEEK_SET) ||
+      (fread(arc->buffer, sizeof(UBYTE), (size_t)size, arc->fp) != 
+       (size_t)size) ||
+      (arc->buffer[0] != type))
+      return(-1);
+   
+   return(size - 1);
+}
+
+
+/************************************************************************/
+/*>static long *DecodeFrame(COORARCHIVE *arc, int frame)
+   -----------------------------------------------------
+*//**
+
+   \param[in,out] *arc      Archive
+   \param[in]     frame     Frame number
+   \return                  The quantised coordinates (arc->key or 
+                            arc->work; NULL on error)
+
+   Decodes a frame, first decoding its key frame unless it is already
+   cached.
+
+-  17.10.26 Original   By: ACRM
+*/
+static long *DecodeFrame(COORARCHIVE *arc, int frame)
+{
+   UBYTE *p, *end;
+   long  prev[3],
+         size,
+         value;
+   int   key   = arc->keyFrame[frame],
+         ncoor = 3 * arc->natoms,
+         i;
+
+   if(arc->cachedKey != key)
+   {
+      arc->cachedKey = -1;
+      if((size = ReadFrame(arc, key, FRAME_KEY)) < 0)
+         return(NULL);
+      p   = arc->buffer + 1;
+      end = p + size;
+      prev[0] = prev[1] = prev[2] = 0;
+      for(i=0; i<ncoor; i++)
+      {
+         if(!GetVarint(&p, end, &value))
+            return(NULL);
+         arc->key[i] = prev[i%3] + value;
+         prev[i%3]   = arc->key[i];
+      }
+      if(p != end)
+         return(NULL);
+      arc->cachedKey = key;
+   }
+
+   if(frame == key)
+      return(arc->key);
+
+   if((size = ReadFrame(arc, frame, FRAME_DELTA)) < 0)
+      return(NULL);
+   p   = arc->buffer + 1;
+   end = p + size;
+   for(i=0; i<ncoor; i++)
+   {
+      if(!GetVarint(&p, end, &value))
+         return(NULL);
+      arc->work[i] = arc->key[i] + value;
+   }
+
+   return((p == end) ? arc->work : NULL);
+}
+
+
+/************************************************************************/
+/*>COORARCHIVE *blCreateCoorArchive(FILE *fp, int natoms, REAL precision)
+   ----------------------------------------------------------------------
+*//**
+
+   \param[in]     *fp        File opened for binary writing
+   \param[in]     natoms     Atoms in each frame
+   \param[in]     precision  Precision of the coordinates in Angstroms 
+                             (0.0 for COORARC_PRECISION). Rounded to
+                             1/n for some integer n
+   \return                   Archive (NULL if no memory or the header
+                             could not be written)
+
+   Writes the header of a coordinate archive at the current position,
+   which must be the start of the file. Add frames with 
+   blWriteCoorArchiveFrame(), blWriteCoorArchiveFramePDB() or
+   blWriteCoorArchiveModelsPDB() and finish with blCloseCoorArchive().
+
+-  17.10.26 Original   By: ACRM
+*/
+COORARCHIVE *blCreateCoorArchive(FILE *fp, int natoms, REAL precision)
+{
+   COORARCHIVE *arc;
+   UBYTE       header[HEADER_SIZE];
+   
+   if((fp == NULL) || (natoms < 1))
+      return(NULL);
+   if(precision <= (REAL)0.0)
+      precision = COORARC_PRECISION;
+   
+   if((arc = AllocArchive(fp, natoms, TRUE))==NULL)
+      return(NULL);
+
+   arc->scale = (long)(1.0 / precision + 0.5);
+   if(arc->scale < 1)
+      arc->scale = 1;
+   else if(arc->scale > COORARC_MAXSCALE)
+      arc->scale = COORARC_MAXSCALE;
+
+   memcpy(header, HEADER_MAGIC, 4);
+   PutUnsigned(header+4,  (ULONG)ARCHIVE_VERSION, 4);
+   PutUnsigned(header+8,  (ULONG)natoms,          4);
+   PutUnsigned(header+12, (ULONG)arc->scale,      4);
+   if(fwrite(header, sizeof(UBYTE), HEADER_SIZE, fp) != HEADER_SIZE)
+   {
+      arc->writing = FALSE;
+      blCloseCoorArchive(arc);
+      return(NULL);
+   }
+   arc->offset = HEADER_SIZE;
+   
+   return(arc);
+}
+
+
+/************************************************************************/
+/*>BOOL blWriteCoorArchiveFrame(COORARCHIVE *arc, REAL *xyz)
+   ---------------------------------------------------------
+*//**
+
+   \param[in,out] *arc      Archive from blCreateCoorArchive()
+   \param[in]     *xyz      3*arc->natoms coordinates (x,y,z of each
+                            atom in turn)
+   \return                  Success (FALSE if a coordinate is out of 
+                            range, no memory or a write error)
+
+   Writes a frame from an array of coordinates
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blWriteCoorArchiveFrame(COORARCHIVE *arc, REAL *xyz)
+{
+   int i;
+
+   if((arc == NULL) || !arc->writing || (xyz == NULL))
+      return(FALSE);
+
+   for(i=0; i<3*arc->natoms; i++)
+   {
+      if(!Quantise(xyz[i], arc->scale, arc->work+i))
+         return(FALSE);
+   }
+   
+   return(EncodeFrame(arc));
+}
+
+
+/************************************************************************/
+/*>BOOL blWriteCoorArchiveFramePDB(COORARCHIVE *arc, PDB *pdb)
+   -----------------------------------------------------------
+*//**
+
+   \param[in,out] *arc      Archive from blCreateCoorArchive()
+   \param[in]     *pdb      PDB linked list
+   \return                  Success (FALSE if the list has fewer than
+                            arc->natoms atoms, a coordinate is out of
+                            range, no memory or a write error)
+
+   Writes the coordinates of the first arc->natoms atoms of a PDB linked
+   list as a frame
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blWriteCoorArchiveFramePDB(COORARCHIVE *arc, PDB *pdb)
+{
+   if((arc == NULL) || !arc->writing || !QuantisePDB(arc, &pdb))
+      return(FALSE);
+
+   return(EncodeFrame(arc));
+}
+
+
+/************************************************************************/
+/*>int blWriteCoorArchiveModelsPDB(COORARCHIVE *arc, PDB *pdb)
+   -----------------------------------------------------------
+*//**
+
+   \param[in,out] *arc      Archive from blCreateCoorArchive()
+   \param[in]     *pdb      PDB linked list of several models, as read
+                            by blReadPDBAll()
+   \return                  Number of frames written
+
+   Writes each successive block of arc->natoms atoms in a PDB linked
+   list as a frame. Stops at the first error or if the last block is
+   incomplete, so the return is less than the number of atoms divided
+   by arc->natoms if there is a problem.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blWriteCoorArchiveModelsPDB(COORARCHIVE *arc, PDB *pdb)
+{
+   int nframes = 0;
+   
+   if((arc == NULL) || !arc->writing)
+      return(0);
+   
+   while(pdb != NULL)
+   {
+      if(!QuantisePDB(arc, &pdb) || !EncodeFrame(arc))
+         break;
+      nframes++;
+   }
+
+   return(nframes);
+}
+
+
+/************************************************************************/
+/*>COORARCHIVE *blOpenCoorArchive(FILE *fp)
+   ----------------------------------------
+*//**
+
+   \param[in]     *fp       Archive file opened for binary reading
+   \return                  Archive (NULL if no memory or the file is
+                            not a valid archive)
+
+   Reads the header and the frame index of a coordinate archive. The
+   number of atoms and frames are in arc->natoms and arc->nframes.
+
+-  17.10.26 Original   By: ACRM
+*/
+COORARCHIVE *blOpenCoorArchive(FILE *fp)
+{
+   COORARCHIVE *arc = NULL;
+   UBYTE       buffer[HEADER_SIZE];
+   long        indexOffset,
+               scale,
+               size;
+   int         natoms,
+               nframes,
+               i;
+
+   /* Header                                                            */
+   if((fp == NULL)                  ||
+      fseek(fp, 0L, SEEK_SET)       ||
+      (fread(buffer, sizeof(UBYTE), HEADER_SIZE, fp) != HEADER_SIZE) ||
+      strncmp((char *)buffer, HEADER_MAGIC, 4) ||
+      (GetUnsigned(buffer+4, 4) != ARCHIVE_VERSION))
+      return(NULL);
+   natoms = (int)GetUnsigned(buffer+8, 4);
+   scale  = (long)GetUnsigned(buffer+12, 4);
+   if((natoms < 1) || (scale < 1) || (scale > COORARC_MAXSCALE))
+      return(NULL);
+   
+   /* Trailer                                                           */
+   if(fseek(fp, -(long)TRAILER_SIZE, SEEK_END) ||
+      (fread(buffer, sizeof(UBYTE), TRAILER_SIZE, fp) != TRAILER_SIZE) ||
+      strncmp((char *)buffer+12, TRAILER_MAGIC, 4))
+      return(NULL);
+   indexOffset = (long)GetUnsigned(buffer, 8);
+   nframes     = (int)GetUnsigned(buffer+8, 4);
+   if((indexOffset < HEADER_SIZE) || (nframes < 0))
+      return(NULL);
+
+   if((arc = AllocArchive(fp, natoms, FALSE))==NULL)
+      return(NULL);
+   arc->scale = scale;
+   
+   if(((arc->offsets  = (long *)malloc((nframes + 1) * sizeof(long)))
+       == NULL) ||
+      ((arc->keyFrame = (int *)malloc((nframes + 1) * sizeof(int)))
+       == NULL))
+      goto Cleanup;
+   arc->nframes   = nframes;
+   arc->maxFrames = nframes;
+   arc->offsets[nframes] = indexOffset;
+
+   /* Index. Each key frame must precede the frame and be a key frame
+      itself. Each frame must be between the smallest and largest 
+      possible size
+   */
+   if(fseek(fp, indexOffset, SEEK_SET))
+      goto Cleanup;
+   for(i=0; i<nframes; i++)
+   {
+      if(fread(buffer, sizeof(UBYTE), INDEX_SIZE, fp) != INDEX_SIZE)
+         goto Cleanup;
+      arc->offsets[i]  = (long)GetUnsigned(buffer, 8);
+      arc->keyFrame[i] = (int)GetUnsigned(buffer+8, 4);
+      if((arc->keyFrame[i] < 0) || (arc->keyFrame[i] > i) ||
+         (arc->keyFrame[arc->keyFrame[i]] != arc->keyFrame[i]))
+         goto Cleanup;
+   }
+   if((nframes > 0) && (arc->offsets[0] != HEADER_SIZE))
+      goto Cleanup;
+   for(i=0; i<nframes; i++)
+   {
+      size = arc->offsets[i+1] - arc->offsets[i];
+      if((size < 1 + 3 * (long)natoms) || (size > FRAMESIZE(natoms)))
+         goto Cleanup;
+   }
+   
+   return(arc);
+
+Cleanup:
+   blCloseCoorArchive(arc);
+   return(NULL);
+}
+
+
+/************************************************************************/
+/*>BOOL blReadCoorArchiveFrame(COORARCHIVE *arc, int frame, REAL *xyz)
+   -------------------------------------------------------------------
+*//**
+
+   \param[in,out] *arc      Archive from blOpenCoorArchive()
+   \param[in]     frame     Frame number (from 0)
+   \param[out]    *xyz      3*arc->natoms coordinates (x,y,z of each
+                            atom in turn)
+   \return                  Success (FALSE if there is no such frame or
+                            it could not be read)
+
+   Reads a frame into an array of coordinates
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blReadCoorArchiveFrame(COORARCHIVE *arc, int frame, REAL *xyz)
+{
+   long *q;
+   REAL scale;
+   int  i;
+
+   if((arc == NULL) || arc->writing || (xyz == NULL) ||
+      (frame < 0) || (frame >= arc->nframes) ||
+      ((q = DecodeFrame(arc, frame))==NULL))
+      return(FALSE);
+
+   scale = (REAL)arc->scale;
+   for(i=0; i<3*arc->natoms; i++)
+      xyz[i] = (REAL)q[i] / scale;
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>BOOL blReadCoorArchiveFramePDB(COORARCHIVE *arc, int frame, PDB *pdb)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in,out] *arc      Archive from blOpenCoorArchive()
+   \param[in]     frame     Frame number (from 0)
+   \param[in,out] *pdb      PDB linked list of at least arc->natoms 
+                            atoms
+   \return                  Success (FALSE if there is no such frame, it
+                            could not be read or the list is too short)
+
+   Replaces the coordinates of the first arc->natoms atoms of a PDB
+   linked list with those of a frame. Nothing else in the list is 
+   changed. If the list is too short, the atoms it has are updated.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blReadCoorArchiveFramePDB(COORARCHIVE *arc, int frame, PDB *pdb)
+{
+   PDB  *p;
+   long *q;
+   REAL scale;
+   int  i;
+
+   if((arc == NULL) || arc->writing ||
+      (frame < 0) || (frame >= arc->nframes) ||
+      ((q = DecodeFrame(arc, frame))==NULL))
+      return(FALSE);
+
+   scale = (REAL)arc->scale;
+   for(p=pdb, i=0; i<arc->natoms; i++, NEXT(p))
+   {
+      if(p == NULL)
+         return(FALSE);
+      p->x = (REAL)q[0] / scale;
+      p->y = (REAL)q[1] / scale;
+      p->z = (REAL)q[2] / scale;
+      q += 3;
+   }
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>BOOL blCloseCoorArchive(COORARCHIVE *arc)
+   -----------------------------------------
+*//**
+
+   \param[in]     *arc      Archive
+   \return                  Success (FALSE if writing the frame index
+                            failed)
+
+   Frees an archive. If it was created for writing, the frame index and
+   trailer are written first. The file is not closed.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blCloseCoorArchive(COORARCHIVE *arc)
+{
+   UBYTE buffer[TRAILER_SIZE];
+   BOOL  ok = TRUE;
+   int   i;
+
+   if(arc == NULL)
+      return(FALSE);
+   
+   if(arc->writing)
+   {
+      for(i=0; ok && (i<arc->nframes); i++)
+      {
+         PutUnsigned(buffer,   (ULONG)arc->offsets[i],  8);
+         PutUnsigned(buffer+8, (ULONG)arc->keyFrame[i], 4);
+         ok = (fwrite(buffer, sizeof(UBYTE), INDEX_SIZE, arc->fp) == 
+               INDEX_SIZE);
+      }
+      PutUnsigned(buffer,   (ULONG)arc->offset,  8);
+      PutUnsigned(buffer+8, (ULONG)arc->nframes, 4);
+      memcpy(buffer+12, TRAILER_MAGIC, 4);
+      if(ok)
+         ok = (fwrite(buffer, sizeof(UBYTE), TRAILER_SIZE, arc->fp) ==
+               TRAILER_SIZE);
+      if(fflush(arc->fp))
+         ok = FALSE;
+   }
+
+   if(arc->offsets != NULL)  free(arc->offsets);
+   if(arc->keyFrame != NULL) free(arc->keyFrame);
+   if(arc->key != NULL)      free(arc->key);
+   if(arc->work != NULL)     free(arc->work);
+   if(arc->buffer != NULL)   free(arc->buffer);
+   free(arc);
+
+   return(ok);
+}
@@ -3,11 +3,11 @@
 
    \file       FindAtomWildcardInRes.c
    
-   \version    V1.1
-   \date       07.07.14
+   \version    V1.2
+   \date       17.10.26
    \brief      Find an atom within a residue allowing wild cards
    
-   \copyright  (c) Dr. Andrew C. R. Martin, UCL, 1996-2014
+   \copyright  (c) Dr. Andrew C. R. Martin, UCL, 1996-2026
    \author     Dr. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -48,6 +48,7 @@
    =================
 -  V1.0  27.08.96 Original moved from mutmodel  By: ACRM
 -  V1.1  07.07.14 Use bl prefix for functions By: CTP
+-  V1.2  17.10.26 Uses a compiled ATOMNAMEPATTERN   By: ACRM
 
 
 *************************************************************************/
@@ -63,6 +64,8 @@
 /************************************************************************/
 /* Includes
 */
+#include <string.h>
+
 #include "pdb.h"
 #include "macros.h"
 
@@ -94,34 +97,41 @@
 
    Returns the first atom which matches
 
+   The pattern is converted to a mask and value (see 
+   blCompileAtomNamePattern()) so it is parsed once for the residue
+   rather than once per atom.
+
 -  27.08.96 Original   By: ACRM
 -  07.07.14 Use bl prefix for functions By: CTP
+-  17.10.26 Builds an ATOMNAMEPATTERN and uses blFindAtomNamePattern()
+            By: ACRM
 */
 PDB *blFindAtomWildcardInRes(PDB *pdb, char *pattern)
 {
-   PDB  *p, *pNext;
-   int  i;
-   BOOL ok;
-   
-   pNext = blFindNextResidue(pdb);
+   ATOMNAMEPATTERN compiled;
+   int             i;
    
-   for(p=pdb; p!=pNext; NEXT(p))
+   /* The first 4 characters are compared; ? matches anything. A 
+      shorter pattern must be matched by a name of the same length
+   */
+   memset(&compiled, 0, sizeof(ATOMNAMEPATTERN));
+   for(i=0; i<4; i++)
    {
-      if(!strncmp(p->atnam,pattern,4))
-         return(p);
-      ok = TRUE;
-      for(i=0; i<4; i++)
+      if(pattern[i] != '?')
       {
-         if((pattern[i] != p->atnam[i]) && pattern[i] != '?')
-         {
-            ok = FALSE;
-            break;
-         }
+         compiled.mask[i]  = (UBYTE)0xFF;
+         compiled.value[i] = (UBYTE)pattern[i];
+      }
+      if(pattern[i] == '\0')
+      {
+         i++;
+         break;
       }
-      if(ok)
-         return(p);
    }
-   return(NULL);
+   compiled.nbytes = i;
+   compiled.raw    = FALSE;
+
+   return(blFindAtomNamePattern(pdb, blFindNextResidue(pdb), &compiled));
 }
 
 
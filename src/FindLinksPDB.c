@@ -0,0 +1,688 @@
+/************************************************************************/
+/**
+
+   \file       FindLinksPDB.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Find disulphides and other covalent links between
+               residues from the coordinates
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Many PDB files lack SSBOND or LINK records for bonds which are
+   clearly present in the coordinates. These routines find them from
+   the geometry using the covalent radii used by blBuildConectData().
+   Atoms are paired through a spatial grid, so the time taken is
+   proportional to the number of atoms rather than the number of pairs
+   of residues.
+
+   Disulphides are returned as a DISULPHIDE linked list, as from
+   blReadDisulphidesPDB(), and other links as a COVALENTLINK linked
+   list. The SSBOND and LINK records in the header of a WHOLEPDB may be
+   regenerated from these.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP Miscellaneous functions
+
+   #FUNCTION blFindDisulphidesPDB()
+   Finds disulphides from the positions of the cysteine SG atoms
+
+   #FUNCTION blFindCovalentLinksPDB()
+   Finds all disulphides and other covalent links between residues
+   in one pass
+
+   #FUNCTION blSetLinkRecordsWholePDB()
+   Replaces the SSBOND and LINK records in the header of a WHOLEPDB
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "general.h"
+#include "pdb.h"
+#include "atomgrid.h"
+#include "bondgraph.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define MAXBUFF 160
+
+#define ISDUMMY(p) (((p)->x > 9999.0) && \
+                    ((p)->y > 9999.0) && \
+                    ((p)->z > 9999.0))
+#define ISCYSSG(p) (!strncmp((p)->resnam, "CYS ", 4) && \
+                    !strncmp((p)->atnam,  "SG  ", 4))
+#define FIRSTCHAR(s) ((s)[0] ? (s)[0] : ' ')
+#define SAMERES(p, q) (((p)->resnum == (q)->resnum)       && \
+                       !strcmp((p)->chain,  (q)->chain)   && \
+                       !strcmp((p)->insert, (q)->insert))
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static BOOL IsPolymerLink(PDB *p, PDB *q);
+static BOOL IsLinkOrSSBOND(char *record);
+static BOOL IsAfterLinks(char *record);
+static BOOL SetDisulphide(DISULPHIDE **dis, DISULPHIDE **last,
+                          PDB *p, PDB *q);
+static STRINGLIST *MakeLinkRecords(PDB *pdb, DISULPHIDE *disulphides,
+                                   COVALENTLINK *links);
+static BOOL AppendRecord(STRINGLIST **recs, STRINGLIST **last,
+                         char *record);
+
+
+/************************************************************************/
+/*>DISULPHIDE *blFindDisulphidesPDB(PDB *pdb, REAL tol, BOOL *error)
+   -----------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb    PDB linked list
+   \param[in]     tol     Tolerance added to the sum of the covalent
+                          radii
+   \param[out]    *error  Memory allocation failed
+   \return                Linked list of disulphides (NULL if none or
+                          on error)
+
+   Finds disulphides from the coordinates. Only the SG atoms of
+   cysteines are placed in the spatial grid, so this is cheaper than
+   blFindCovalentLinksPDB() if only the disulphides are needed. Two SG
+   atoms are bonded if they are no more than twice the covalent radius
+   of sulphur plus tol apart. The list is in the same form as that from
+   blReadDisulphidesPDB() and should be freed with FREELIST().
+
+-  17.10.26 Original   By: ACRM
+*/
+DISULPHIDE *blFindDisulphidesPDB(PDB *pdb, REAL tol, BOOL *error)
+{
+   DISULPHIDE *dis        = NULL,
+              *last       = NULL;
+   ATOMGRID   *grid       = NULL;
+   PDB        *p,
+              **atoms     = NULL;
+   REAL       cutoff;
+   int        *neighbours = NULL,
+              maxNeighb   = 0,
+              natoms      = 0,
+              nNeighb,
+              i, j;
+
+   *error = FALSE;
+   cutoff = 2 * blCovalentRadius("S") + tol;
+
+   /* Collect the cysteine SG atoms                                     */
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      if(ISCYSSG(p) && !ISDUMMY(p))
+         natoms++;
+   }
+   if(natoms < 2)
+      return(NULL);
+
+   if((atoms = (PDB **)malloc(natoms * sizeof(PDB *)))==NULL)
+   {
+      *error = TRUE;
+      return(NULL);
+   }
+   for(p=pdb, i=0; p!=NULL; NEXT(p))
+   {
+      if(ISCYSSG(p) && !ISDUMMY(p))
+         atoms[i++] = p;
+   }
+
+   if((grid = blBuildAtomGrid(atoms, natoms, cutoff))==NULL)
+   {
+      *error = TRUE;
+      free(atoms);
+      return(NULL);
+   }
+
+   /* Each pair is found from its first atom                            */
+   for(i=0; i<natoms; i++)
+   {
+      nNeighb = blFindAtomGridNeighbours(grid,
+                                         atoms[i]->x,
+                                         atoms[i]->y,
+                                         atoms[i]->z,
+                                         cutoff, &neighbours, &maxNeighb);
+      if(nNeighb < 0)
+      {
+         *error = TRUE;
+         break;
+      }
+
+      for(j=0; j<nNeighb; j++)
+      {
+         PDB *q = atoms[neighbours[j]];
+
+         /* Skip alternate positions of the same SG                     */
+         if((neighbours[j] > i) && !SAMERES(atoms[i], q))
+         {
+            if(!SetDisulphide(&dis, &last, atoms[i], q))
+            {
+               *error = TRUE;
+               break;
+            }
+         }
+      }
+      if(*error)
+         break;
+   }
+
+   free(atoms);
+   FREE(neighbours);
+   blFreeAtomGrid(grid);
+
+   return(dis);
+}
+
+
+/************************************************************************/
+/*>COVALENTLINK *blFindCovalentLinksPDB(PDB *pdb, REAL tol,
+                                        DISULPHIDE **disulphides,
+                                        BOOL *error)
+   ------------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb          PDB linked list
+   \param[in]     tol           Tolerance added to the sum of the
+                                covalent radii
+   \param[out]    **disulphides Linked list of disulphides. If this is
+                                NULL, disulphides are returned as
+                                links
+   \param[out]    *error        Memory allocation failed
+   \return                      Linked list of other links (NULL if
+                                none or on error)
+
+   Finds all the covalent bonds between residues in one pass, using
+   blBuildBondGraph(). Bonds between cysteine SG atoms are returned as
+   disulphides. The usual polymer links (the peptide bond and the O3'-P
+   bond of nucleic acids) and bonds involving hydrogens are ignored;
+   everything else, including bonds to metals, is returned as a
+   COVALENTLINK. Both lists should be freed with FREELIST().
+
+-  17.10.26 Original   By: ACRM
+*/
+COVALENTLINK *blFindCovalentLinksPDB(PDB *pdb, REAL tol,
+                                     DISULPHIDE **disulphides,
+                                     BOOL *error)
+{
+   BONDGRAPH    *graph    = NULL;
+   COVALENTLINK *links    = NULL,
+                *l        = NULL;
+   DISULPHIDE   *last     = NULL;
+   PDB          *p, *q,
+                *res,
+                *nextRes;
+   int          *resIndex = NULL,
+                i, j, k, nRes;
+
+   *error = FALSE;
+   if(disulphides != NULL)
+      *disulphides = NULL;
+
+   if(pdb == NULL)
+      return(NULL);
+
+   if((graph = blBuildBondGraph(pdb, tol))==NULL)
+   {
+      *error = TRUE;
+      return(NULL);
+   }
+
+   /* Number the residues. The graph holds the atoms in linked list
+      order
+   */
+   if((resIndex = (int *)malloc(graph->natoms * sizeof(int)))==NULL)
+   {
+      *error = TRUE;
+      blFreeBondGraph(graph);
+      return(NULL);
+   }
+   i    = 0;
+   nRes = 0;
+   for(res=pdb; res!=NULL; res=nextRes)
+   {
+      nextRes = blFindNextResidue(res);
+      for(p=res; p!=nextRes; NEXT(p))
+         resIndex[i++] = nRes;
+      nRes++;
+   }
+
+   /* Each bond is found from its first atom                            */
+   for(i=0; (i<graph->natoms) && !(*error); i++)
+   {
+      p = graph->atoms[i];
+      if(!strcmp(p->element, "H") || !strcmp(p->element, "D"))
+         continue;
+
+      for(k=0; k<BONDGRAPH_DEGREE(graph, i); k++)
+      {
+         j = BONDGRAPH_NEIGHBOUR(graph, i, k);
+         if((j <= i) || (resIndex[i] == resIndex[j]))
+            continue;
+
+         q = graph->atoms[j];
+         if(!strcmp(q->element, "H") || !strcmp(q->element, "D") ||
+            IsPolymerLink(p, q))
+            continue;
+
+         if((disulphides != NULL) && ISCYSSG(p) && ISCYSSG(q))
+         {
+            if(!SetDisulphide(disulphides, &last, p, q))
+            {
+               *error = TRUE;
+               break;
+            }
+         }
+         else
+         {
+            if(links == NULL)
+            {
+               INIT(links, COVALENTLINK);
+               l = links;
+            }
+            else
+            {
+               ALLOCNEXT(l, COVALENTLINK);
+            }
+            if(l == NULL)
+            {
+               *error = TRUE;
+               break;
+            }
+            l->atom1    = p;
+            l->atom2    = q;
+            l->distance = (REAL)DIST(p, q);
+         }
+      }
+   }
+
+   free(resIndex);
+   blFreeBondGraph(graph);
+
+   return(links);
+}
+
+
+/************************************************************************/
+/*>BOOL blSetLinkRecordsWholePDB(WHOLEPDB *wpdb,
+                                 DISULPHIDE *disulphides,
+                                 COVALENTLINK *links)
+   ------------------------------------------------------
+*//**
+
+   \param[in,out] *wpdb          Whole PDB structure
+   \param[in]     *disulphides   Disulphides for SSBOND records
+   \param[in]     *links         Links for LINK records
+   \return                       Success?
+
+   Replaces any SSBOND, LINK and LINKR records in the header with
+   records generated from the disulphides and links. The new records
+   go where the old ones were or, if there were none, before the first
+   CISPEP, SITE or crystal records. The distances are calculated from
+   the coordinates in wpdb->pdb. If memory allocation fails, the header
+   is left unchanged.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blSetLinkRecordsWholePDB(WHOLEPDB *wpdb,
+                              DISULPHIDE *disulphides,
+                              COVALENTLINK *links)
+{
+   STRINGLIST *newRecs,
+              *header = NULL,
+              *tail   = NULL,
+              *s,
+              *next;
+   BOOL       inserted = FALSE;
+
+   if((disulphides != NULL) || (links != NULL))
+   {
+      if((newRecs = MakeLinkRecords(wpdb->pdb, disulphides, links))
+         ==NULL)
+         return(FALSE);
+   }
+   else
+   {
+      newRecs = NULL;
+   }
+
+   /* Rebuild the header list, dropping the old records and splicing in
+      the new ones
+   */
+   for(s=wpdb->header; s!=NULL; s=next)
+   {
+      next    = s->next;
+      s->next = NULL;
+
+      if((s->string != NULL) && IsLinkOrSSBOND(s->string))
+      {
+         FREE(s->string);
+         free(s);
+         s = NULL;
+      }
+
+      if(!inserted &&
+         ((s == NULL) || ((s->string != NULL) && IsAfterLinks(s->string))))
+      {
+         if(newRecs != NULL)
+         {
+            if(header == NULL)
+               header = newRecs;
+            else
+               tail->next = newRecs;
+            for(tail=newRecs; tail->next!=NULL; NEXT(tail));
+         }
+         inserted = TRUE;
+      }
+
+      if(s != NULL)
+      {
+         if(header == NULL)
+            header = s;
+         else
+            tail->next = s;
+         tail = s;
+      }
+   }
+
+   if(!inserted && (newRecs != NULL))
+   {
+      if(header == NULL)
+         header = newRecs;
+      else
+         tail->next = newRecs;
+   }
+
+   wpdb->header = header;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static BOOL SetDisulphide(DISULPHIDE **dis, DISULPHIDE **last,
+                             PDB *p, PDB *q)
+   --------------------------------------------------------------
+*//**
+
+   \param[in,out] **dis     Start of the disulphide list
+   \param[in,out] **last    Last item in the list
+   \param[in]     *p        First SG atom
+   \param[in]     *q        Second SG atom
+   \return                  Success?
+
+   Appends a disulphide between the residues of two atoms to the list
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL SetDisulphide(DISULPHIDE **dis, DISULPHIDE **last,
+                          PDB *p, PDB *q)
+{
+   DISULPHIDE *d;
+   
+   INIT(d, DISULPHIDE);
+   if(d == NULL)
+      return(FALSE);
+
+   d->res1 = p->resnum;
+   d->res2 = q->resnum;
+   strcpy(d->chain1,  p->chain);
+   strcpy(d->chain2,  q->chain);
+   strcpy(d->insert1, p->insert);
+   strcpy(d->insert2, q->insert);
+
+   if(*dis == NULL)
+      *dis = d;
+   else
+      (*last)->next = d;
+   *last = d;
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static BOOL IsPolymerLink(PDB *p, PDB *q)
+   -----------------------------------------
+*//**
+
+   \param[in]     *p        First atom
+   \param[in]     *q        Second atom
+   \return                  Is this a peptide or phosphodiester bond?
+
+   Tests whether a bond is one of the normal polymer links which do not
+   get LINK records
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL IsPolymerLink(PDB *p, PDB *q)
+{
+   if((!strncmp(p->atnam, "C   ", 4) && !strncmp(q->atnam, "N   ", 4)) ||
+      (!strncmp(p->atnam, "N   ", 4) && !strncmp(q->atnam, "C   ", 4)))
+      return(TRUE);
+
+   if(((!strncmp(p->atnam, "O3'", 3) || !strncmp(p->atnam, "O3*", 3)) &&
+       !strncmp(q->atnam, "P   ", 4)) ||
+      ((!strncmp(q->atnam, "O3'", 3) || !strncmp(q->atnam, "O3*", 3)) &&
+       !strncmp(p->atnam, "P   ", 4)))
+      return(TRUE);
+
+   return(FALSE);
+}
+
+
+/************************************************************************/
+/*>static BOOL IsLinkOrSSBOND(char *record)
+   ----------------------------------------
+*//**
+
+   \param[in]     *record   Header record
+   \return                  Is it an SSBOND, LINK or LINKR record?
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL IsLinkOrSSBOND(char *record)
+{
+   return(!strncmp(record, "SSBOND", 6) ||
+          !strncmp(record, "LINK  ", 6) ||
+          !strncmp(record, "LINKR ", 6));
+}
+
+
+/************************************************************************/
+/*>static BOOL IsAfterLinks(char *record)
+   --------------------------------------
+*//**
+
+   \param[in]     *record   Header record
+   \return                  Does this record follow the SSBOND and
+                            LINK records?
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL IsAfterLinks(char *record)
+{
+   return(!strncmp(record, "CISPEP", 6) ||
+          !strncmp(record, "SITE  ", 6) ||
+          !strncmp(record, "CRYST1", 6) ||
+          !strncmp(record, "ORIGX",  5) ||
+          !strncmp(record, "SCALE",  5) ||
+          !strncmp(record, "MTRIX",  5));
+}
+
+
+/************************************************************************/
+/*>static STRINGLIST *MakeLinkRecords(PDB *pdb, DISULPHIDE *disulphides,
+                                      COVALENTLINK *links)
+   ----------------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb          PDB linked list
+   \param[in]     *disulphides  Disulphides
+   \param[in]     *links        Other links
+   \return                      SSBOND and LINK records (NULL if no
+                                memory)
+
+   Builds SSBOND and LINK records. The SSBOND distance is left blank
+   if the SG atoms can't be found in the PDB linked list.
+
+-  17.10.26 Original   By: ACRM
+*/
+static STRINGLIST *MakeLinkRecords(PDB *pdb, DISULPHIDE *disulphides,
+                                   COVALENTLINK *links)
+{
+   STRINGLIST   *recs = NULL,
+                *last = NULL;
+   DISULPHIDE   *d;
+   COVALENTLINK *l;
+   PDB          *res1, *res2,
+                *sg1,  *sg2;
+   char         buffer[MAXBUFF],
+                dist[16];
+   int          serial = 0;
+
+   for(d=disulphides; d!=NULL; NEXT(d))
+   {
+      strcpy(dist, "");
+      if(((res1 = blFindResidue(pdb, d->chain1, d->res1, d->insert1))
+          !=NULL) &&
+         ((res2 = blFindResidue(pdb, d->chain2, d->res2, d->insert2))
+          !=NULL) &&
+         ((sg1 = blFindAtomInRes(res1, "SG"))!=NULL) &&
+         ((sg2 = blFindAtomInRes(res2, "SG"))!=NULL))
+      {
+         sprintf(dist, "%5.2f", DIST(sg1, sg2));
+      }
+
+      sprintf(buffer, "SSBOND %3d CYS %c %4d%c   CYS %c %4d%c%23s\
+  1555   1555 %s\n",
+              ++serial,
+              FIRSTCHAR(d->chain1), d->res1, FIRSTCHAR(d->insert1),
+              FIRSTCHAR(d->chain2), d->res2, FIRSTCHAR(d->insert2),
+              "", dist);
+
+      if(!AppendRecord(&recs, &last, buffer))
+      {
+         FREESTRINGLIST(recs);
+         return(NULL);
+      }
+   }
+
+   for(l=links; l!=NULL; NEXT(l))
+   {
+      sprintf(buffer, "LINK        %-4.4s%c%-3.3s %c%4d%c%15s\
+%-4.4s%c%-3.3s %c%4d%c    1555   1555 %5.2f\n",
+              l->atom1->atnam_raw, l->atom1->altpos, l->atom1->resnam,
+              FIRSTCHAR(l->atom1->chain), l->atom1->resnum,
+              FIRSTCHAR(l->atom1->insert), "",
+              l->atom2->atnam_raw, l->atom2->altpos, l->atom2->resnam,
+              FIRSTCHAR(l->atom2->chain), l->atom2->resnum,
+              FIRSTCHAR(l->atom2->insert),
+              l->distance);
+
+      if(!AppendRecord(&recs, &last, buffer))
+      {
+         FREESTRINGLIST(recs);
+         return(NULL);
+      }
+   }
+
+   return(recs);
+}
+
+
+/************************************************************************/
+/*>static BOOL AppendRecord(STRINGLIST **recs, STRINGLIST **last,
+                            char *record)
+   -------------------------------------------------------------
+*//**
+
+   \param[in,out] **recs    Start of the list
+   \param[in,out] **last    Last item in the list
+   \param[in]     *record   Record to append
+   \return                  Success?
+
+   Appends a copy of a record to a STRINGLIST. Unlike blStoreString()
+   the end of the list is tracked and the list is left intact if 
+   memory allocation fails.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL AppendRecord(STRINGLIST **recs, STRINGLIST **last,
+                         char *record)
+{
+   STRINGLIST *s;
+
+   INIT(s, STRINGLIST);
+   if(s == NULL)
+      return(FALSE);
+   if((s->string = (char *)malloc((strlen(record)+1) * sizeof(char)))
+      ==NULL)
+   {
+      free(s);
+      return(FALSE);
+   }
+   strcpy(s->string, record);
+
+   if(*recs == NULL)
+      *recs = s;
+   else
+      (*last)->next = s;
+   *last = s;
+
+   return(TRUE);
+}
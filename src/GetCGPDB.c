@@ -3,8 +3,8 @@
 
    \file       GetCGPDB.c
    
-   \version    V1.2
-   \date       07.07.14
+   \version    V1.3
+   \date       17.10.26
    \brief      Find CofG of a PDB linked list
    
    \copyright  (c) UCL / Dr. Andrew C. R. Martin 1992-4
@@ -50,6 +50,7 @@
 -  V1.1  03.10.94 Added GetCofGPDBRange(), FindCofGPDBSCRange() and 
                   fixed NULL coord search in GetCofGPDB()
 -  V1.2  07.07.14 Use bl prefix for functions By: CTP
+-  V1.3  17.10.26 blGetCofGPDB() now calls blGetCofGPDBView()  By: ACRM
 
 *************************************************************************/
 /* Doxygen
@@ -67,6 +68,7 @@
 #include "pdb.h"
 #include "macros.h"
 #include "MathType.h"
+#include "pdbview.h"
 
 /************************************************************************/
 /* Defines
@@ -94,29 +96,14 @@
 -  01.10.92 Original
 -  03.10.94 Fixed NULL coordinate ignoring
 -  07.07.14 Use bl prefix for functions By: CTP
+-  17.10.26 Now calls blGetCofGPDBView()   By: ACRM
 */
 void blGetCofGPDB(PDB   *pdb,
                   VEC3F *cg)
 {
-   int natom;
-   PDB *p;
-
-   cg->x = 0.0;   
-   cg->y = 0.0;   
-   cg->z = 0.0;   
-   natom = 0;
-   for(p=pdb; p; NEXT(p))
-   {
-      if(p->x < 9999.0 || p->y < 9999.0 || p->z < 9999.0)
-      {
-         cg->x += p->x;
-         cg->y += p->y;
-         cg->z += p->z;
-         natom++;
-      }
-   }
-   cg->x /= natom;
-   cg->y /= natom;
-   cg->z /= natom;
+   PDBVIEW view;
+
+   blInitPDBView(&view, pdb);
+   blGetCofGPDBView(&view, cg);
 }
 
@@ -3,11 +3,11 @@
 
    \file       HAddPDB.c
    
-   \version    V2.24
-   \date       13.03.19
+   \version    V2.25
+   \date       17.10.26
    \brief      Add hydrogens to a PDB linked list
    
-   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1990-2019
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1990-2026
    \author     Dr. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -137,6 +137,8 @@
 -  V2.23 07.08.18 initialized and foce-terminated variables to silence
                   gcc 7.3.1 with -O2
 -  V2.24 13.03.19 Fixed buffer sizes for sprintf()
+-  V2.25 17.10.26 StripDummyH() deletes the dummy hydrogens in a single
+                  pass with blDeleteAtomsPDB()
 
 *************************************************************************/
 /* Doxygen
@@ -221,6 +223,7 @@ static PDB *makeh(int HType, REAL BondLen, REAL alpha, REAL beta,
 static BOOL AddH(PDB *hlist, PDB **position, int HType);
 static void SetRawAtnam(char *out, char *in);
 static PDB  *StripDummyH(PDB *pdb, int *nhyd);
+static BOOL IsDummyH(PDB *p, APTR data);
 
 /************************************************************************/
 /*>int blHAddPDB(FILE *fp, PDB  *pdb)
@@ -1466,26 +1469,38 @@ static void SetRawAtnam(char *out, char *in)
    Strips any dummy hydrogens
 
 -  28.11.05 Original   By: ACRM
+-  17.10.26 Uses blDeleteAtomsPDB() rather than deleting one at a time
+            which also removes any CONECTs   By: ACRM
 */
 static PDB *StripDummyH(PDB *pdb, int *nhyd)
 {
-   PDB *p;
+   int ndeleted = 0;
+
+   pdb = blDeleteAtomsPDB(pdb, IsDummyH, NULL, &ndeleted);
+   (*nhyd) -= ndeleted;
 
-   for(p=pdb; p!=NULL;)
-   {
-      if((p->atnam[0] == 'H') && 
-         (p->x > 9998.0)      &&
-         (p->y > 9998.0)      &&
-         (p->z > 9998.0))
-      {
-         DELETE(pdb, p, PDB);
-         (*nhyd)--;
-      }
-      else
-      {
-         NEXT(p);
-      }
-   }
    return(pdb);
 }
 
+
+/************************************************************************/
+/*>static BOOL IsDummyH(PDB *p, APTR data)
+   ---------------------------------------
+*//**
+
+   \param[in]     *p       Atom to test
+   \param[in]     data     Unused
+   \return                 Is this a dummy hydrogen?
+
+   blDeleteAtomsPDB() test for StripDummyH()
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL IsDummyH(PDB *p, APTR data)
+{
+   return((p->atnam[0] == 'H') && 
+          (p->x > 9998.0)      &&
+          (p->y > 9998.0)      &&
+          (p->z > 9998.0));
+}
+
@@ -0,0 +1,740 @@
+/************************************************************************/
+/**
+
+   \file       HPBProfile.c
+
+   \version    V1.1
+   \date       17.10.26
+   \brief      Sliding-window hydrophobicity and hydrophobic moment
+               profiles
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Uses the hydrophobicity scales in the data directory to find
+   transmembrane and amphipathic segments in sequences.
+
+   A scale is read once into a table indexed by the one-letter code
+   (upper and lower case), so each residue costs a single lookup. Both
+   forms of scale file are read: the .hpb files, which give a three-
+   letter code and value on each line, and those in HPBScales/, which
+   give a one-letter code and value after a reference line starting
+   with '>' and a line of plotting colours.
+
+   For each window of a sequence, the mean hydrophobicity and the mean
+   hydrophobic moment (Eisenberg et al. (1982) Nature 299, 371-374)
+
+      muH = |sum(h[k] * (cos(k.angle), sin(k.angle)))| / n
+
+   are calculated. Because the length of the moment vector does not
+   depend on where the angle starts, the residue vectors are taken at
+   their angle within the whole sequence and both sums are updated as
+   the window slides, so a whole profile takes O(L) time. Residues
+   which are not in the scale count as 0.0 and are left out of n.
+
+   Segments are runs of consecutive windows whose mean and moment both
+   reach the thresholds. Sequences in a FASTA file may be profiled in
+   parallel. If the library is compiled with PTHREAD_SUPPORT, a pool of
+   threads takes sequences in turn; otherwise the sequences are
+   profiled one after another.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   HPBSCALE   *scale;
+   HPBSEGMENT *segs;
+   int        nseqs;
+
+   scale = blReadHPBScale(HPB_KYTEFILE);
+   segs  = blFindHPBSegmentsFASTA(scale, fp, HPB_TMWINDOW,
+                                  HPB_HELIXANGLE, HPB_TMTHRESHOLD,
+                                  (REAL)0.0, 4, &nseqs);
+   blPrintHPBSegments(stdout, segs);
+   blFreeHPBSegments(segs);
+   blFreeHPBScale(scale);
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Uses blRunThreadPool()   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling Sequence Data
+   #SUBGROUP Hydrophobicity
+
+   #FUNCTION  blReadHPBScale()
+   Reads a hydrophobicity scale into a table indexed by one-letter code
+
+   #FUNCTION  blFreeHPBScale()
+   Frees a hydrophobicity scale
+
+   #FUNCTION  blHPBProfile()
+   Calculates sliding-window mean hydrophobicity and hydrophobic moment
+
+   #FUNCTION  blFindHPBSegments()
+   Finds the segments of a sequence above hydrophobicity thresholds
+
+   #FUNCTION  blFindHPBSegmentsFASTA()
+   Finds the segments above hydrophobicity thresholds in each sequence
+   of a FASTA file
+
+   #FUNCTION  blFreeHPBSegments()
+   Frees a list of hydrophobic segments
+
+   #FUNCTION  blPrintHPBSegments()
+   Prints a list of hydrophobic segments
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "general.h"
+#include "seq.h"
+#include "sequtil.h"
+#include "threadpool.h"
+#include "hpbprofile.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define MAXBUFF      160
+#define MAXFASTABUFF 1024    /* Longest FASTA header line               */
+#define ALLOCSTEP    256
+#define DATAENV      "DATADIR"
+
+/* A scan of a set of sequences                                         */
+typedef struct
+{
+   HPBSCALE   *scale;
+   HPBSEGMENT **segs;
+   char       **seqs,
+              **ids;
+   REAL       angle,
+              minMean,
+              minMoment;
+   int        nseqs,
+              window,
+              next;
+}  HPBSCAN;
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static HPBSEGMENT *FindSegments(HPBSCALE *scale, char *seq, char *id,
+                                int seqNum, int window, REAL angle,
+                                REAL minMean, REAL minMoment,
+                                int *nsegs);
+static void *ScanSequences(void *arg);
+
+
+/************************************************************************/
+/*>HPBSCALE *blReadHPBScale(char *filename)
+   ----------------------------------------
+*//**
+
+   \param[in]     *filename  Scale file. Looked for in the current
+                             directory and then in $DATADIR
+   \return                   The scale or NULL on error
+
+   Reads a hydrophobicity scale such as kyte.hpb or
+   HPBScales/fauchere.dat. The first line is the description. Each
+   value is given after a three- or one-letter code; other lines are
+   ignored. Codes not given in the file have the value 0.0 and are
+   flagged as unknown.
+
+-  17.10.26 Original   By: ACRM
+*/
+HPBSCALE *blReadHPBScale(char *filename)
+{
+   FILE     *fp;
+   HPBSCALE *scale;
+   char     buffer[MAXBUFF],
+            code[MAXBUFF];
+   double   value;
+   int      i,
+            nvalues = 0;
+   BOOL     noenv;
+
+   if((fp=blOpenFile(filename, DATAENV, "r", &noenv))==NULL)
+      return(NULL);
+
+   if((scale=(HPBSCALE *)malloc(sizeof(HPBSCALE)))==NULL)
+   {
+      fclose(fp);
+      return(NULL);
+   }
+   for(i=0; i<256; i++)
+   {
+      scale->value[i] = (REAL)0.0;
+      scale->known[i] = FALSE;
+   }
+   scale->name[0] = '\0';
+
+   if(fgets(buffer, MAXBUFF, fp))
+   {
+      TERMINATE(buffer);
+      strncpy(scale->name, buffer, HPB_MAXNAME-1);
+      scale->name[HPB_MAXNAME-1] = '\0';
+   }
+
+   while(fgets(buffer, MAXBUFF, fp))
+   {
+      char aa;
+
+      if((sscanf(buffer, "%s %lf", code, &value) != 2) ||
+         !isalpha(code[0]))
+         continue;
+
+      if(strlen(code) == 3)
+      {
+         UPPER(code);
+         aa = blThrone(code);
+      }
+      else if(strlen(code) == 1)
+      {
+         aa = (char)toupper(code[0]);
+      }
+      else
+      {
+         continue;
+      }
+
+      scale->value[(int)aa] = (REAL)value;
+      scale->known[(int)aa] = TRUE;
+      aa = (char)tolower(aa);
+      scale->value[(int)aa] = (REAL)value;
+      scale->known[(int)aa] = TRUE;
+      nvalues++;
+   }
+   fclose(fp);
+
+   if(nvalues == 0)
+   {
+      free(scale);
+      return(NULL);
+   }
+
+   return(scale);
+}
+
+
+/************************************************************************/
+/*>void blFreeHPBScale(HPBSCALE *scale)
+   ------------------------------------
+*//**
+
+   \param[in]     *scale    Scale to free
+
+   Frees a hydrophobicity scale
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeHPBScale(HPBSCALE *scale)
+{
+   FREE(scale);
+}
+
+
+/************************************************************************/
+/*>int blHPBProfile(HPBSCALE *scale, char *seq, int window, REAL angle,
+                    REAL *mean, REAL *moment)
+   --------------------------------------------------------------------
+*//**
+
+   \param[in]     *scale    Hydrophobicity scale
+   \param[in]     *seq      Sequence (one-letter codes)
+   \param[in]     window    Window length
+   \param[in]     angle     Angle between residues in degrees (e.g.
+                            HPB_HELIXANGLE)
+   \param[out]    *mean     Mean hydrophobicity of each window
+   \param[out]    *moment   Mean hydrophobic moment of each window. May
+                            be NULL if not needed
+   \return                  Number of windows (0 if the sequence is
+                            shorter than the window)
+
+   Calculates the mean hydrophobicity and mean hydrophobic moment of
+   each window. Element i of the output arrays is the window starting
+   at residue i, so the arrays need strlen(seq)-window+1 elements.
+   Running sums are used so the time is independent of the window.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blHPBProfile(HPBSCALE *scale, char *seq, int window, REAL angle,
+                 REAL *mean, REAL *moment)
+{
+   double sumH   = 0.0,
+          sumCos = 0.0,
+          sumSin = 0.0,
+          theta;
+   int    len, k, aa,
+          nknown = 0;
+
+   if((scale == NULL) || (seq == NULL) || (window < 1))
+      return(0);
+   if((len = strlen(seq)) < window)
+      return(0);
+
+   theta = angle * PI / 180.0;
+
+   for(k=0; k<len; k++)
+   {
+      /* Add the residue entering the window                            */
+      aa = (int)((unsigned char)seq[k]);
+      if(scale->known[aa])
+      {
+         sumH   += scale->value[aa];
+         sumCos += scale->value[aa] * cos(k * theta);
+         sumSin += scale->value[aa] * sin(k * theta);
+         nknown++;
+      }
+
+      /* Remove the residue leaving the window                          */
+      if(k >= window)
+      {
+         aa = (int)((unsigned char)seq[k-window]);
+         if(scale->known[aa])
+         {
+            sumH   -= scale->value[aa];
+            sumCos -= scale->value[aa] * cos((k-window) * theta);
+            sumSin -= scale->value[aa] * sin((k-window) * theta);
+            nknown--;
+         }
+      }
+
+      if(k >= window-1)
+      {
+         int i = k - window + 1;
+
+         if(nknown)
+         {
+            mean[i] = (REAL)(sumH / nknown);
+            if(moment != NULL)
+               moment[i] = (REAL)(sqrt(sumCos*sumCos + sumSin*sumSin) /
+                                  nknown);
+         }
+         else
+         {
+            mean[i] = (REAL)0.0;
+            if(moment != NULL)
+               moment[i] = (REAL)0.0;
+         }
+      }
+   }
+
+   return(len - window + 1);
+}
+
+
+/************************************************************************/
+/*>static HPBSEGMENT *FindSegments(HPBSCALE *scale, char *seq, char *id,
+                                   int seqNum, int window, REAL angle,
+                                   REAL minMean, REAL minMoment,
+                                   int *nsegs)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *scale      Hydrophobicity scale
+   \param[in]     *seq        Sequence
+   \param[in]     *id         Identifier copied into each segment (or
+                              NULL)
+   \param[in]     seqNum      Sequence number stored in each segment
+   \param[in]     window      Window length
+   \param[in]     angle       Angle between residues in degrees
+   \param[in]     minMean     Mean hydrophobicity threshold
+   \param[in]     minMoment   Hydrophobic moment threshold
+   \param[out]    *nsegs      Number of segments (-1 on error)
+   \return                    Linked list of segments
+
+   Does the work for blFindHPBSegments() and blFindHPBSegmentsFASTA()
+
+-  17.10.26 Original   By: ACRM
+*/
+static HPBSEGMENT *FindSegments(HPBSCALE *scale, char *seq, char *id,
+                                int seqNum, int window, REAL angle,
+                                REAL minMean, REAL minMoment,
+                                int *nsegs)
+{
+   HPBSEGMENT *segs = NULL,
+              *s    = NULL;
+   REAL       *mean,
+              *moment;
+   int        nwin, i;
+   BOOL       inSeg = FALSE;
+
+   *nsegs = 0;
+   if((seq == NULL) || ((nwin = strlen(seq) - window + 1) < 1))
+      return(NULL);
+
+   mean   = (REAL *)malloc(nwin * sizeof(REAL));
+   moment = (REAL *)malloc(nwin * sizeof(REAL));
+   if((mean == NULL) || (moment == NULL))
+   {
+      FREE(mean);
+      FREE(moment);
+      *nsegs = (-1);
+      return(NULL);
+   }
+
+   nwin = blHPBProfile(scale, seq, window, angle, mean, moment);
+
+   for(i=0; i<nwin; i++)
+   {
+      if((mean[i] >= minMean) && (moment[i] >= minMoment))
+      {
+         if(inSeg)
+         {
+            /* Extend the current segment                               */
+            s->stop = i + window - 1;
+            if(mean[i] > s->maxMean)
+               s->maxMean = mean[i];
+            if(moment[i] > s->maxMoment)
+               s->maxMoment = moment[i];
+            continue;
+         }
+
+         /* Start a new segment                                         */
+         if(segs == NULL)
+         {
+            INIT(segs, HPBSEGMENT);
+            s = segs;
+         }
+         else
+         {
+            ALLOCNEXT(s, HPBSEGMENT);
+         }
+         if(s == NULL)
+         {
+            blFreeHPBSegments(segs);
+            segs   = NULL;
+            *nsegs = (-1);
+            break;
+         }
+         s->id = NULL;
+         if((id != NULL) &&
+            ((s->id = (char *)malloc(strlen(id)+1)) != NULL))
+            strcpy(s->id, id);
+         s->seqNum    = seqNum;
+         s->start     = i;
+         s->stop      = i + window - 1;
+         s->maxMean   = mean[i];
+         s->maxMoment = moment[i];
+         (*nsegs)++;
+         inSeg = TRUE;
+      }
+      else
+      {
+         inSeg = FALSE;
+      }
+   }
+
+   free(mean);
+   free(moment);
+   return(segs);
+}
+
+
+/************************************************************************/
+/*>HPBSEGMENT *blFindHPBSegments(HPBSCALE *scale, char *seq, int window,
+                                 REAL angle, REAL minMean,
+                                 REAL minMoment, int *nsegs)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *scale      Hydrophobicity scale
+   \param[in]     *seq        Sequence (one-letter codes)
+   \param[in]     window      Window length (e.g. HPB_TMWINDOW)
+   \param[in]     angle       Angle between residues in degrees (e.g.
+                              HPB_HELIXANGLE)
+   \param[in]     minMean     Mean hydrophobicity threshold (e.g.
+                              HPB_TMTHRESHOLD)
+   \param[in]     minMoment   Hydrophobic moment threshold (0.0 to find
+                              segments by hydrophobicity alone)
+   \param[out]    *nsegs      Number of segments (-1 on error)
+   \return                    Linked list of segments (NULL if none or
+                              on error)
+
+   Finds the runs of consecutive windows whose mean hydrophobicity and
+   hydrophobic moment both reach the thresholds. Each segment runs from
+   the first residue of its first window to the last residue of its
+   last window and records the best mean and moment of its windows.
+   Give a very negative minMean to find segments by moment alone.
+
+-  17.10.26 Original   By: ACRM
+*/
+HPBSEGMENT *blFindHPBSegments(HPBSCALE *scale, char *seq, int window,
+                              REAL angle, REAL minMean, REAL minMoment,
+                              int *nsegs)
+{
+   if((scale == NULL) || (window < 1))
+   {
+      *nsegs = 0;
+      return(NULL);
+   }
+
+   return(FindSegments(scale, seq, NULL, 0, window, angle, minMean,
+                       minMoment, nsegs));
+}
+
+
+/************************************************************************/
+/*>static void *ScanSequences(void *arg)
+   -------------------------------------
+*//**
+
+   \param[in,out] *arg      The HPBSCAN
+   \return                  NULL
+
+   Takes sequences from the scan in turn until none are left, storing
+   the segments for sequence i in scan->segs[i]
+
+-  17.10.26 Original   By: ACRM
+*/
+static void *ScanSequences(void *arg)
+{
+   HPBSCAN *scan = (HPBSCAN *)arg;
+   int     i, nsegs;
+
+   for(;;)
+   {
+      if((i = blThreadPoolIncrement(&(scan->next))) >= scan->nseqs)
+         break;
+
+      scan->segs[i] = FindSegments(scan->scale, scan->seqs[i],
+                                   scan->ids[i], i, scan->window,
+                                   scan->angle, scan->minMean,
+                                   scan->minMoment, &nsegs);
+   }
+
+   return(NULL);
+}
+
+
+/************************************************************************/
+/*>HPBSEGMENT *blFindHPBSegmentsFASTA(HPBSCALE *scale, FILE *in,
+                                      int window, REAL angle,
+                                      REAL minMean, REAL minMoment,
+                                      int nthreads, int *nseqs)
+   -----------------------------------------------------------------
+*//**
+
+   \param[in]     *scale      Hydrophobicity scale
+   \param[in]     *in         FASTA file
+   \param[in]     window      Window length
+   \param[in]     angle       Angle between residues in degrees
+   \param[in]     minMean     Mean hydrophobicity threshold
+   \param[in]     minMoment   Hydrophobic moment threshold
+   \param[in]     nthreads    Number of threads to use
+   \param[out]    *nseqs      Number of sequences read (-1 on error)
+   \return                    Linked list of segments
+
+   Reads all the sequences from a FASTA file and finds the segments in
+   each (as blFindHPBSegments()). The segments are returned in the
+   order of the sequences. The id of each segment is a malloc'd copy
+   of the FASTA header without the '>', which is freed by
+   blFreeHPBSegments().
+
+   If the library was compiled with PTHREAD_SUPPORT, up to nthreads
+   sequences are profiled at once.
+
+-  17.10.26 Original   By: ACRM
+*/
+HPBSEGMENT *blFindHPBSegmentsFASTA(HPBSCALE *scale, FILE *in,
+                                   int window, REAL angle,
+                                   REAL minMean, REAL minMoment,
+                                   int nthreads, int *nseqs)
+{
+   HPBSCAN    scan;
+   HPBSEGMENT *segs    = NULL,
+              *lastSeg = NULL;
+   char       header[MAXFASTABUFF],
+              buffer[MAXFASTABUFF],
+              *seq,
+              *id;
+   int        maxseqs  = 0,
+              i;
+   BOOL       ok       = TRUE;
+
+   *nseqs = 0;
+   if((scale == NULL) || (window < 1))
+      return(NULL);
+
+   scan.seqs  = NULL;
+   scan.ids   = NULL;
+   scan.segs  = NULL;
+   scan.nseqs = 0;
+
+   /* Read all the sequences                                            */
+   buffer[0] = '\0';
+   while((seq = blReadFASTAExtBuffer(in, header, MAXFASTABUFF,
+                                     buffer, MAXFASTABUFF)) != NULL)
+   {
+      if(scan.nseqs >= maxseqs)
+      {
+         char **newSeqs, **newIds;
+
+         maxseqs += ALLOCSTEP;
+         newSeqs  = (char **)realloc(scan.seqs, maxseqs*sizeof(char *));
+         if(newSeqs != NULL)
+            scan.seqs = newSeqs;
+         newIds   = (char **)realloc(scan.ids,  maxseqs*sizeof(char *));
+         if(newIds != NULL)
+            scan.ids = newIds;
+         if((newSeqs == NULL) || (newIds == NULL))
+         {
+            free(seq);
+            ok = FALSE;
+            break;
+         }
+      }
+      header[MAXFASTABUFF-1] = '\0';
+      id = (header[0] == '>') ? header+1 : header;
+      scan.seqs[scan.nseqs] = seq;
+      if((scan.ids[scan.nseqs++] = (char *)malloc(strlen(id)+1))==NULL)
+      {
+         ok = FALSE;
+         break;
+      }
+      strcpy(scan.ids[scan.nseqs-1], id);
+   }
+
+   if(ok && (scan.nseqs > 0) &&
+      ((scan.segs = (HPBSEGMENT **)calloc(scan.nseqs,
+                                          sizeof(HPBSEGMENT *)))==NULL))
+      ok = FALSE;
+
+   if(ok && (scan.nseqs > 0))
+   {
+      scan.scale     = scale;
+      scan.window    = window;
+      scan.angle     = angle;
+      scan.minMean   = minMean;
+      scan.minMoment = minMoment;
+      scan.next      = 0;
+
+      blRunThreadPool(ScanSequences, (void *)&scan, 0,
+                      MIN(nthreads, scan.nseqs));
+
+      /* Join the segments in sequence order                            */
+      for(i=0; i<scan.nseqs; i++)
+      {
+         if(scan.segs[i] == NULL)
+            continue;
+         if(lastSeg == NULL)
+            segs = scan.segs[i];
+         else
+            lastSeg->next = scan.segs[i];
+         for(lastSeg=scan.segs[i]; lastSeg->next!=NULL; NEXT(lastSeg));
+      }
+   }
+
+   for(i=0; i<scan.nseqs; i++)
+   {
+      FREE(scan.seqs[i]);
+      FREE(scan.ids[i]);
+   }
+   FREE(scan.seqs);
+   FREE(scan.ids);
+   FREE(scan.segs);
+
+   *nseqs = ok ? scan.nseqs : (-1);
+   return(segs);
+}
+
+
+/************************************************************************/
+/*>void blFreeHPBSegments(HPBSEGMENT *segs)
+   ----------------------------------------
+*//**
+
+   \param[in]     *segs     Linked list of segments
+
+   Frees a list of segments and their ids
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeHPBSegments(HPBSEGMENT *segs)
+{
+   HPBSEGMENT *s;
+
+   for(s=segs; s!=NULL; NEXT(s))
+   {
+      FREE(s->id);
+   }
+   FREELIST(segs, HPBSEGMENT);
+}
+
+
+/************************************************************************/
+/*>void blPrintHPBSegments(FILE *out, HPBSEGMENT *segs)
+   ----------------------------------------------------
+*//**
+
+   \param[in]     *out      Output file
+   \param[in]     *segs     Linked list of segments
+
+   Prints one line for each segment giving the sequence id (or number),
+   the first and last residue numbered from 1 and the best mean and
+   moment of its windows.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blPrintHPBSegments(FILE *out, HPBSEGMENT *segs)
+{
+   HPBSEGMENT *s;
+
+   for(s=segs; s!=NULL; NEXT(s))
+   {
+      if(s->id != NULL)
+         fprintf(out, "%s", s->id);
+      else
+         fprintf(out, "%d", s->seqNum + 1);
+      fprintf(out, " %5d %5d %8.3f %8.3f\n", s->start+1, s->stop+1,
+              s->maxMean, s->maxMoment);
+   }
+}
@@ -0,0 +1,268 @@
+/************************************************************************/
+/**
+
+   \file       Hybrid36.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Hybrid-36 encoding of PDB atom and residue numbers
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   The PDB format has 5 columns for atom numbers and 4 for residue
+   numbers, so structures with more than 99,999 atoms or 9,999 residues
+   can't be numbered in decimal. The hybrid-36 scheme (used by CCTBX,
+   PyMOL, Chimera and others) keeps decimal numbers where they fit and
+   then continues with base-36 numbers starting with an upper case
+   letter and then base-36 numbers starting with a lower case letter:
+
+      width 5:  -9999..99999 A0000..ZZZZZ a0000..zzzzz
+                (up to 87,440,031)
+      width 4:   -999..9999   A000..ZZZZ   a000..zzzz
+                (up to 2,436,111)
+
+   Files which only use decimal numbers are unaffected.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   char field[8];
+   int  atnum;
+
+   blEncodeHybrid36(123456, 5, field);    gives "A0H0W"
+   blDecodeHybrid36("A0H0W", 5, &atnum);  gives 123456
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP File IO
+
+   #FUNCTION  blDecodeHybrid36()
+   Reads a decimal or hybrid-36 number from a fixed width field
+
+   #FUNCTION  blEncodeHybrid36()
+   Writes a number as decimal or hybrid-36 in a fixed width field
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "SysDefs.h"
+#include "pdb.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define MAXHYBRID36WIDTH 15
+
+/************************************************************************/
+/* Globals
+*/
+static char sDigitsUpper[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+            sDigitsLower[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+/************************************************************************/
+/* Prototypes
+*/
+static long Power(long base, int exponent);
+
+
+/************************************************************************/
+/*>static long Power(long base, int exponent)
+   ------------------------------------------
+*//**
+
+   Integer power for the small values used here
+
+-  17.10.26 Original   By: ACRM
+*/
+static long Power(long base, int exponent)
+{
+   long result = 1;
+
+   while(exponent-- > 0)
+      result *= base;
+   return(result);
+}
+
+
+/************************************************************************/
+/*>BOOL blDecodeHybrid36(char *field, int width, int *value)
+   ---------------------------------------------------------
+*//**
+
+   \param[in]     *field   Start of the field (need not be terminated)
+   \param[in]     width    Field width (5 for atom numbers, 4 for 
+                           residue numbers)
+   \param[in,out] *value   Value read
+   \return                 Was the field readable?
+
+   Reads a fixed width decimal or hybrid-36 number. The field stops
+   early at a newline or the end of the string. Decimal fields are read
+   as fsscanf() does with %Nd: a blank field gives zero. If the field
+   can't be read, value is left unchanged and FALSE is returned.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blDecodeHybrid36(char *field, int width, int *value)
+{
+   char buffer[MAXHYBRID36WIDTH+1],
+        *digits,
+        *end,
+        *chp;
+   long lvalue,
+        base36 = 0;
+   int  i, n;
+
+   if(width > MAXHYBRID36WIDTH)
+      width = MAXHYBRID36WIDTH;
+
+   for(n=0; (n<width) && field[n] && (field[n]!='\n'); n++)
+      buffer[n] = field[n];
+   buffer[n] = '\0';
+
+   /* Skip leading spaces; a blank field is zero                        */
+   for(i=0; (i<n) && (buffer[i]==' '); i++);
+   if(i==n)
+   {
+      *value = 0;
+      return(TRUE);
+   }
+
+   /* Decimal                                                           */
+   if(!isalpha((int)buffer[i]))
+   {
+      lvalue = strtol(buffer, &end, 10);
+      if(end == buffer)
+         return(FALSE);
+      *value = (int)lvalue;
+      return(TRUE);
+   }
+
+   /* Hybrid-36 numbers fill the field                                  */
+   if((i != 0) || (n != width))
+      return(FALSE);
+
+   digits = isupper((int)buffer[0]) ? sDigitsUpper : sDigitsLower;
+   for(i=0; i<n; i++)
+   {
+      if((chp = strchr(digits, buffer[i]))==NULL)
+         return(FALSE);
+      base36 = base36 * 36 + (long)(chp - digits);
+   }
+
+   /* The first hybrid-36 number (A000...) follows the last decimal 
+      number
+   */
+   lvalue = base36 - 10 * Power(36, width-1) + Power(10, width);
+   if(digits == sDigitsLower)
+      lvalue += 26 * Power(36, width-1);
+
+   *value = (int)lvalue;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>BOOL blEncodeHybrid36(int value, int width, char *field)
+   --------------------------------------------------------
+*//**
+
+   \param[in]     value    Value to write
+   \param[in]     width    Field width (5 for atom numbers, 4 for 
+                           residue numbers)
+   \param[out]    *field   Terminated string of width characters
+   \return                 Was the value in range?
+
+   Writes a number right justified in a fixed width field, as decimal
+   if it fits and as hybrid-36 if not. Values which can't be written
+   give a field of asterisks and FALSE is returned.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blEncodeHybrid36(int value, int width, char *field)
+{
+   char *digits = sDigitsUpper;
+   long lvalue  = value,
+        block;
+   int  i;
+
+   if(width > MAXHYBRID36WIDTH)
+      width = MAXHYBRID36WIDTH;
+   field[width] = '\0';
+
+   /* Decimal                                                           */
+   if((lvalue > -Power(10, width-1)) && (lvalue < Power(10, width)))
+   {
+      sprintf(field, "%*d", width, value);
+      return(TRUE);
+   }
+
+   if(lvalue >= Power(10, width))
+   {
+      block   = 26 * Power(36, width-1);
+      lvalue -= Power(10, width);
+      if(lvalue >= block)
+      {
+         lvalue -= block;
+         digits  = sDigitsLower;
+      }
+      if(lvalue < block)
+      {
+         lvalue += 10 * Power(36, width-1);
+         for(i=width-1; i>=0; i--)
+         {
+            field[i] = digits[lvalue % 36];
+            lvalue  /= 36;
+         }
+         return(TRUE);
+      }
+   }
+
+   for(i=0; i<width; i++)
+      field[i] = '*';
+   return(FALSE);
+}
+
@@ -3,11 +3,11 @@
 
    \file       IndexPDB.c
    
-   \version    V2.2
-   \date       19.04.15
+   \version    V2.3
+   \date       17.10.26
    \brief      Create an array of pointers into a PDB linked list
    
-   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1993-2015
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1993-2026
    \author     Dr. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -66,6 +66,9 @@
                   has changed!! NOT BACKWARDLY COMPATIBLE!
 -  V2.1  07.07.14 Use bl prefix for functions By: CTP
 -  V2.2  19.04.15 Added blIndexAtomNumbersPDB()  By: ACRM
+-  V2.3  17.10.26 Added blCreateAtomNumberIndex(), blFindAtomNumber()
+                  and blFreeAtomNumberIndex(). blIndexAtomNumbersPDB()
+                  ignores negative atom numbers   By: ACRM
 
 *************************************************************************/
 /* Doxygen
@@ -83,6 +86,16 @@
    number:
    e.g. (indx[23])->x will give the x coordinate of atom number 23
 
+   #FUNCTION  blCreateAtomNumberIndex()
+   Creates an index for finding atoms by atom number which uses memory
+   proportional to the number of atoms however large the numbers are
+
+   #FUNCTION  blFindAtomNumber()
+   Finds an atom by atom number using an index from 
+   blCreateAtomNumberIndex()
+
+   #FUNCTION  blFreeAtomNumberIndex()
+   Frees an index from blCreateAtomNumberIndex()
 */
 /************************************************************************/
 /* Includes
@@ -95,6 +108,20 @@
 #include "pdb.h"
 #include "macros.h"
 
+/************************************************************************/
+/* Defines and macros
+*/
+/* A direct lookup table is used while the range of atom numbers is no
+   more than this multiple of the number of atoms (plus a small margin)
+*/
+#define DENSE_RANGE_FACTOR 4
+#define DENSE_RANGE_MARGIN 1024
+
+/************************************************************************/
+/* Prototypes
+*/
+static int CmpAtomNumberEntry(const void *a, const void *b);
+
 /************************************************************************/
 /*>PDB **blIndexPDB(PDB *pdb, int *natom)
    --------------------------------------
@@ -151,7 +178,12 @@ PDB **blIndexPDB(PDB *pdb, int *natom)
    number:
    e.g. (indx[23])->x will give the x coordinate of atom number 23
 
+   The index has an entry for every number up to the largest atom 
+   number so it can be very large for files with big, or hybrid-36,
+   atom numbers. blCreateAtomNumberIndex() avoids this.
+
 -  19.04.15 Original   By: ACRM
+-  17.10.26 Atoms with negative atom numbers are not indexed
 */
 PDB **blIndexAtomNumbersPDB(PDB *pdb, int *indexSize)
 {
@@ -171,7 +203,8 @@ PDB **blIndexAtomNumbersPDB(PDB *pdb, int *indexSize)
    {
       for(p=pdb; p!=NULL; NEXT(p))
       {
-         index[p->atnum] = p;
+         if(p->atnum >= 0)
+            index[p->atnum] = p;
       }
    }
    
@@ -179,3 +212,180 @@ PDB **blIndexAtomNumbersPDB(PDB *pdb, int *indexSize)
 }
 
 
+/************************************************************************/
+/*>static int CmpAtomNumberEntry(const void *a, const void *b)
+   -----------------------------------------------------------
+*//**
+
+   qsort() comparison of PDBATOMNUMENTRY items by atom number and then
+   by position in the linked list
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CmpAtomNumberEntry(const void *a, const void *b)
+{
+   PDBATOMNUMENTRY *ea = (PDBATOMNUMENTRY *)a,
+                   *eb = (PDBATOMNUMENTRY *)b;
+
+   if(ea->atnum < eb->atnum) return(-1);
+   if(ea->atnum > eb->atnum) return(1);
+   if(ea->order < eb->order) return(-1);
+   if(ea->order > eb->order) return(1);
+   return(0);
+}
+
+
+/************************************************************************/
+/*>PDBATOMNUMINDEX *blCreateAtomNumberIndex(PDB *pdb)
+   --------------------------------------------------
+*//**
+
+   \param[in]   *pdb         PDB linked list
+   \return                   Malloc'd index or NULL on allocation
+                             failure
+
+   Creates an index for finding atoms by atom number with 
+   blFindAtomNumber(). Where the atom numbers are reasonably dense
+   (the usual case) this is a direct lookup table covering the range
+   of atom numbers. Where they are sparse (e.g. hybrid-36 numbers, or
+   numbering that starts at a large value) the atoms are sorted by
+   atom number and found by binary search, so memory is always 
+   proportional to the number of atoms. Negative atom numbers are
+   handled. Where an atom number is repeated, the first atom in the 
+   linked list is found.
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBATOMNUMINDEX *blCreateAtomNumberIndex(PDB *pdb)
+{
+   PDBATOMNUMINDEX *index;
+   PDB             *p;
+   double          range;
+   int             i;
+
+   if((index=(PDBATOMNUMINDEX *)malloc(sizeof(PDBATOMNUMINDEX)))==NULL)
+      return(NULL);
+   index->dense    = NULL;
+   index->sorted   = NULL;
+   index->natoms   = 0;
+   index->minAtnum = 0;
+   index->maxAtnum = 0;
+
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      if((index->natoms == 0) || (p->atnum < index->minAtnum))
+         index->minAtnum = p->atnum;
+      if((index->natoms == 0) || (p->atnum > index->maxAtnum))
+         index->maxAtnum = p->atnum;
+      index->natoms++;
+   }
+   if(index->natoms == 0)
+      return(index);
+
+   /* Done in double as the range may overflow an int                   */
+   range = (double)index->maxAtnum - (double)index->minAtnum + 1.0;
+
+   if(range <= ((double)DENSE_RANGE_FACTOR * index->natoms +
+                DENSE_RANGE_MARGIN))
+   {
+      if((index->dense = (PDB **)calloc((size_t)range, sizeof(PDB *)))
+         ==NULL)
+      {
+         free(index);
+         return(NULL);
+      }
+
+      /* Keep the first atom with each atom number                      */
+      for(p=pdb; p!=NULL; NEXT(p))
+      {
+         if(index->dense[p->atnum - index->minAtnum] == NULL)
+            index->dense[p->atnum - index->minAtnum] = p;
+      }
+   }
+   else
+   {
+      if((index->sorted = (PDBATOMNUMENTRY *)
+          malloc(index->natoms * sizeof(PDBATOMNUMENTRY)))==NULL)
+      {
+         free(index);
+         return(NULL);
+      }
+
+      for(p=pdb, i=0; p!=NULL; NEXT(p), i++)
+      {
+         index->sorted[i].atom  = p;
+         index->sorted[i].atnum = p->atnum;
+         index->sorted[i].order = i;
+      }
+      qsort(index->sorted, index->natoms, sizeof(PDBATOMNUMENTRY),
+            CmpAtomNumberEntry);
+   }
+
+   return(index);
+}
+
+
+/************************************************************************/
+/*>PDB *blFindAtomNumber(PDBATOMNUMINDEX *index, int atnum)
+   --------------------------------------------------------
+*//**
+
+   \param[in]   *index       Index from blCreateAtomNumberIndex()
+   \param[in]   atnum        Atom number to find
+   \return                   The first atom in the linked list with
+                             this atom number, or NULL
+
+   Finds an atom by atom number in O(1) for a dense index and 
+   O(log N) for a sparse one.
+
+-  17.10.26 Original   By: ACRM
+*/
+PDB *blFindAtomNumber(PDBATOMNUMINDEX *index, int atnum)
+{
+   int lo, hi, mid;
+
+   if((index == NULL) || (index->natoms == 0) ||
+      (atnum < index->minAtnum) || (atnum > index->maxAtnum))
+      return(NULL);
+
+   if(index->dense != NULL)
+      return(index->dense[atnum - index->minAtnum]);
+
+   /* Find the first entry with atnum >= the one we want                */
+   lo = 0;
+   hi = index->natoms;
+   while(lo < hi)
+   {
+      mid = lo + (hi - lo) / 2;
+      if(index->sorted[mid].atnum < atnum)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+
+   if((lo < index->natoms) && (index->sorted[lo].atnum == atnum))
+      return(index->sorted[lo].atom);
+   return(NULL);
+}
+
+
+/************************************************************************/
+/*>void blFreeAtomNumberIndex(PDBATOMNUMINDEX *index)
+   --------------------------------------------------
+*//**
+
+   \param[in]   *index       Index from blCreateAtomNumberIndex()
+
+   Frees an atom number index. The atoms themselves are not freed.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeAtomNumberIndex(PDBATOMNUMINDEX *index)
+{
+   if(index != NULL)
+   {
+      if(index->dense  != NULL) free(index->dense);
+      if(index->sorted != NULL) free(index->sorted);
+      free(index);
+   }
+}
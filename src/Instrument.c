@@ -0,0 +1,573 @@
+/************************************************************************/
+/**
+
+   \file       Instrument.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Counters and timers for the main library operations
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   When the library is compiled with INSTRUMENT_SUPPORT, the PDB
+   readers and writers, CONECT building, secondary structure,
+   accessibility and the sequence aligners count the work they do
+   (lines parsed, atoms stored and written, neighbouring atom pairs
+   tested, alignments and matrix cells) and time themselves with a
+   monotonic clock. Without INSTRUMENT_SUPPORT, the BLCOUNT(),
+   BLTIMERSTART() and BLTIMERSTOP() macros in instrument.h are empty so
+   there is no cost.
+
+   Each thread accumulates into its own block of totals so no locking
+   is needed while counting. With PTHREAD_SUPPORT the blocks are found
+   through thread-specific data; a block is kept when its thread exits
+   and is reused by the next new thread, so totals are never lost.
+   Totals may be read for the calling thread or summed over all
+   threads. Reading or resetting while other threads are counting may
+   miss their most recent updates.
+
+   A timer which is started again before it is stopped (e.g. one timed
+   function calling another) is only timed by the outer call.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   INSTRUMENTSTATS stats;
+
+   blResetInstrumentStats();
+   wpdb = blReadWholePDB(fp);
+   blCalcSecStrucPDB(wpdb->pdb, NULL, FALSE);
+   blGetInstrumentStats(&stats, FALSE);
+   blPrintInstrumentStats(stdout, &stats, INSTRUMENT_JSON);
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    General Programming
+   #SUBGROUP Miscellaneous
+
+   #FUNCTION  blInstrumentEnabled()
+   Tests whether the library was compiled with INSTRUMENT_SUPPORT
+
+   #FUNCTION  blInstrumentCount()
+   Adds to a counter for the calling thread
+
+   #FUNCTION  blInstrumentTimerStart()
+   Starts a timer for the calling thread
+
+   #FUNCTION  blInstrumentTimerStop()
+   Stops a timer for the calling thread
+
+   #FUNCTION  blGetInstrumentStats()
+   Gets the totals for the calling thread or all threads
+
+   #FUNCTION  blResetInstrumentStats()
+   Zeros the totals for all threads
+
+   #FUNCTION  blPrintInstrumentStats()
+   Prints totals as text or JSON
+
+   #FUNCTION  blInstrumentCounterName()
+   Gets the name of a counter
+
+   #FUNCTION  blInstrumentTimerName()
+   Gets the name of a timer
+*/
+/************************************************************************/
+/* Includes
+*/
+#ifndef MS_WINDOWS        /* Required for clock_gettime()               */
+#  ifndef _POSIX_C_SOURCE
+#     define _POSIX_C_SOURCE 199309L
+#  endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef PTHREAD_SUPPORT
+#include <pthread.h>
+#endif
+
+#include "SysDefs.h"
+#include "macros.h"
+#include "instrument.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+/* Totals for one thread                                                */
+typedef struct _threadstats
+{
+   struct _threadstats *next;
+   ULONG  counts[BLCOUNT_NUM],
+          calls[BLTIMER_NUM];
+   double seconds[BLTIMER_NUM],
+          start[BLTIMER_NUM];
+   int    depth[BLTIMER_NUM];
+   BOOL   inUse;
+}  THREADSTATS;
+
+/************************************************************************/
+/* Globals
+*/
+static THREADSTATS *sThreadStats = NULL;
+#ifdef PTHREAD_SUPPORT
+static pthread_mutex_t sMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t  sOnce  = PTHREAD_ONCE_INIT;
+static pthread_key_t   sKey;
+#else
+static THREADSTATS     sOnlyThread;
+#endif
+
+static char *sCounterNames[BLCOUNT_NUM] =
+{
+   "lines_parsed",
+   "atoms_allocated",
+   "atoms_written",
+   "pairs_tested",
+   "alignments",
+   "dp_cells"
+};
+
+static char *sTimerNames[BLTIMER_NUM] =
+{
+   "read_pdb",
+   "write_pdb",
+   "conect",
+   "secstr",
+   "access",
+   "align"
+};
+
+/************************************************************************/
+/* Prototypes
+*/
+static THREADSTATS *GetThreadStats(void);
+static double Now(void);
+static void ClearStats(THREADSTATS *t);
+#ifdef PTHREAD_SUPPORT
+static void CreateKey(void);
+static void ReleaseThreadStats(void *data);
+#endif
+
+
+/************************************************************************/
+/*>BOOL blInstrumentEnabled(void)
+   ------------------------------
+*//**
+
+   \return    Was the library compiled with INSTRUMENT_SUPPORT?
+
+   If not, the library functions do not count or time themselves and
+   all totals will be zero unless blInstrumentCount() etc. are called
+   directly.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blInstrumentEnabled(void)
+{
+#ifdef INSTRUMENT_SUPPORT
+   return(TRUE);
+#else
+   return(FALSE);
+#endif
+}
+
+
+/************************************************************************/
+/*>void blInstrumentCount(int counter, ULONG n)
+   --------------------------------------------
+*//**
+
+   \param[in]  counter   Counter (BLCOUNT_xxx)
+   \param[in]  n         Amount to add
+
+   Adds to a counter for the calling thread. Normally called through
+   the BLCOUNT() macro.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blInstrumentCount(int counter, ULONG n)
+{
+   THREADSTATS *t;
+
+   if((counter >= 0) && (counter < BLCOUNT_NUM) &&
+      ((t = GetThreadStats())!=NULL))
+      t->counts[counter] += n;
+}
+
+
+/************************************************************************/
+/*>void blInstrumentTimerStart(int timer)
+   --------------------------------------
+*//**
+
+   \param[in]  timer   Timer (BLTIMER_xxx)
+
+   Starts a timer for the calling thread. Normally called through the
+   BLTIMERSTART() macro. If the timer is already running, the call is
+   just noted so that the matching stop can be ignored.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blInstrumentTimerStart(int timer)
+{
+   THREADSTATS *t;
+
+   if((timer >= 0) && (timer < BLTIMER_NUM) &&
+      ((t = GetThreadStats())!=NULL))
+   {
+      if(t->depth[timer]++ == 0)
+         t->start[timer] = Now();
+   }
+}
+
+
+/************************************************************************/
+/*>void blInstrumentTimerStop(int timer)
+   -------------------------------------
+*//**
+
+   \param[in]  timer   Timer (BLTIMER_xxx)
+
+   Stops a timer for the calling thread, adding the time since it was
+   started to its total and counting the call. Normally called through
+   the BLTIMERSTOP() macro.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blInstrumentTimerStop(int timer)
+{
+   THREADSTATS *t;
+
+   if((timer >= 0) && (timer < BLTIMER_NUM) &&
+      ((t = GetThreadStats())!=NULL) && (t->depth[timer] > 0))
+   {
+      if(--t->depth[timer] == 0)
+      {
+         t->seconds[timer] += Now() - t->start[timer];
+         t->calls[timer]++;
+      }
+   }
+}
+
+
+/************************************************************************/
+/*>void blGetInstrumentStats(INSTRUMENTSTATS *stats, BOOL thisThread)
+   ------------------------------------------------------------------
+*//**
+
+   \param[out] *stats       Totals
+   \param[in]  thisThread   Only include the calling thread
+
+   Gets a snapshot of the counters and timers, either for the calling
+   thread or summed over all threads that have used them (including
+   threads which have since exited).
+
+-  17.10.26 Original   By: ACRM
+*/
+void blGetInstrumentStats(INSTRUMENTSTATS *stats, BOOL thisThread)
+{
+   THREADSTATS *t;
+   int         i;
+
+   memset(stats, 0, sizeof(INSTRUMENTSTATS));
+
+   if(thisThread)
+   {
+      if((t = GetThreadStats())!=NULL)
+      {
+         for(i=0; i<BLCOUNT_NUM; i++)
+            stats->counts[i] = t->counts[i];
+         for(i=0; i<BLTIMER_NUM; i++)
+         {
+            stats->calls[i]   = t->calls[i];
+            stats->seconds[i] = t->seconds[i];
+         }
+         stats->nthreads = 1;
+      }
+      return;
+   }
+
+#ifdef PTHREAD_SUPPORT
+   pthread_mutex_lock(&sMutex);
+#endif
+   for(t=sThreadStats; t!=NULL; NEXT(t))
+   {
+      for(i=0; i<BLCOUNT_NUM; i++)
+         stats->counts[i] += t->counts[i];
+      for(i=0; i<BLTIMER_NUM; i++)
+      {
+         stats->calls[i]   += t->calls[i];
+         stats->seconds[i] += t->seconds[i];
+      }
+      stats->nthreads++;
+   }
+#ifdef PTHREAD_SUPPORT
+   pthread_mutex_unlock(&sMutex);
+#endif
+}
+
+
+/************************************************************************/
+/*>void blResetInstrumentStats(void)
+   ---------------------------------
+*//**
+
+   Zeros the counters and timers of all threads. Timers which are
+   running carry on and are counted when they stop.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blResetInstrumentStats(void)
+{
+   THREADSTATS *t;
+
+#ifdef PTHREAD_SUPPORT
+   pthread_mutex_lock(&sMutex);
+#endif
+   for(t=sThreadStats; t!=NULL; NEXT(t))
+      ClearStats(t);
+#ifdef PTHREAD_SUPPORT
+   pthread_mutex_unlock(&sMutex);
+#endif
+}
+
+
+/************************************************************************/
+/*>void blPrintInstrumentStats(FILE *fp, INSTRUMENTSTATS *stats,
+                               int format)
+   ---------------------------------------------------------------
+*//**
+
+   \param[in]  *fp      Output file
+   \param[in]  *stats   Totals from blGetInstrumentStats()
+   \param[in]  format   INSTRUMENT_TEXT or INSTRUMENT_JSON
+
+   Prints the totals as a table or as a JSON object.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blPrintInstrumentStats(FILE *fp, INSTRUMENTSTATS *stats, int format)
+{
+   int i;
+
+   if(format == INSTRUMENT_JSON)
+   {
+      fprintf(fp, "{\n  \"threads\": %d,\n  \"counters\": {\n",
+              stats->nthreads);
+      for(i=0; i<BLCOUNT_NUM; i++)
+      {
+         fprintf(fp, "    \"%s\": %lu%s\n", sCounterNames[i],
+                 stats->counts[i], (i<BLCOUNT_NUM-1) ? "," : "");
+      }
+      fprintf(fp, "  },\n  \"timers\": {\n");
+      for(i=0; i<BLTIMER_NUM; i++)
+      {
+         fprintf(fp, "    \"%s\": {\"calls\": %lu, \"seconds\": %.6f}%s\n",
+                 sTimerNames[i], stats->calls[i], stats->seconds[i],
+                 (i<BLTIMER_NUM-1) ? "," : "");
+      }
+      fprintf(fp, "  }\n}\n");
+   }
+   else
+   {
+      fprintf(fp, "Threads: %d\n\n", stats->nthreads);
+      fprintf(fp, "Counter                       Count\n");
+      for(i=0; i<BLCOUNT_NUM; i++)
+         fprintf(fp, "%-16s %18lu\n", sCounterNames[i], stats->counts[i]);
+      fprintf(fp, "\nTimer            Calls      Seconds\n");
+      for(i=0; i<BLTIMER_NUM; i++)
+         fprintf(fp, "%-16s %5lu %12.6f\n", sTimerNames[i],
+                 stats->calls[i], stats->seconds[i]);
+   }
+}
+
+
+/************************************************************************/
+/*>char *blInstrumentCounterName(int counter)
+   ------------------------------------------
+*//**
+
+   \param[in]  counter   Counter (BLCOUNT_xxx)
+   \return               Name used when printing (NULL if invalid)
+
+-  17.10.26 Original   By: ACRM
+*/
+char *blInstrumentCounterName(int counter)
+{
+   if((counter < 0) || (counter >= BLCOUNT_NUM))
+      return(NULL);
+   return(sCounterNames[counter]);
+}
+
+
+/************************************************************************/
+/*>char *blInstrumentTimerName(int timer)
+   --------------------------------------
+*//**
+
+   \param[in]  timer   Timer (BLTIMER_xxx)
+   \return             Name used when printing (NULL if invalid)
+
+-  17.10.26 Original   By: ACRM
+*/
+char *blInstrumentTimerName(int timer)
+{
+   if((timer < 0) || (timer >= BLTIMER_NUM))
+      return(NULL);
+   return(sTimerNames[timer]);
+}
+
+
+/************************************************************************/
+/*>static THREADSTATS *GetThreadStats(void)
+   ----------------------------------------
+*//**
+
+   \return   Totals for the calling thread (NULL if no memory)
+
+   With PTHREAD_SUPPORT, a thread's block is created (or a block left
+   by a thread which has exited is reused) the first time it is needed.
+
+-  17.10.26 Original   By: ACRM
+*/
+static THREADSTATS *GetThreadStats(void)
+{
+#ifdef PTHREAD_SUPPORT
+   THREADSTATS *t;
+
+   pthread_once(&sOnce, CreateKey);
+   if((t = (THREADSTATS *)pthread_getspecific(sKey))!=NULL)
+      return(t);
+
+   pthread_mutex_lock(&sMutex);
+   for(t=sThreadStats; t!=NULL; NEXT(t))
+   {
+      if(!t->inUse)
+         break;
+   }
+   if(t == NULL)
+   {
+      if((t = (THREADSTATS *)malloc(sizeof(THREADSTATS)))!=NULL)
+      {
+         ClearStats(t);
+         t->next      = sThreadStats;
+         sThreadStats = t;
+      }
+   }
+   if(t != NULL)
+   {
+      int i;
+      for(i=0; i<BLTIMER_NUM; i++)
+         t->depth[i] = 0;
+      t->inUse = TRUE;
+   }
+   pthread_mutex_unlock(&sMutex);
+
+   if(t != NULL)
+      pthread_setspecific(sKey, t);
+   return(t);
+#else
+   if(sThreadStats == NULL)
+   {
+      ClearStats(&sOnlyThread);
+      sOnlyThread.next  = NULL;
+      sOnlyThread.inUse = TRUE;
+      sThreadStats      = &sOnlyThread;
+   }
+   return(sThreadStats);
+#endif
+}
+
+
+/************************************************************************/
+#ifdef PTHREAD_SUPPORT
+static void CreateKey(void)
+{
+   pthread_key_create(&sKey, ReleaseThreadStats);
+}
+
+
+/************************************************************************/
+/* Called when a thread exits so that its block can be reused. The
+   totals are kept
+*/
+static void ReleaseThreadStats(void *data)
+{
+   pthread_mutex_lock(&sMutex);
+   ((THREADSTATS *)data)->inUse = FALSE;
+   pthread_mutex_unlock(&sMutex);
+}
+#endif
+
+
+/************************************************************************/
+/* Zeros the totals but not the state of running timers
+*/
+static void ClearStats(THREADSTATS *t)
+{
+   int i;
+
+   for(i=0; i<BLCOUNT_NUM; i++)
+      t->counts[i] = 0;
+   for(i=0; i<BLTIMER_NUM; i++)
+   {
+      t->calls[i]   = 0;
+      t->seconds[i] = 0.0;
+   }
+}
+
+
+/************************************************************************/
+/* Seconds from a monotonic clock (or processor time if there is none)
+*/
+static double Now(void)
+{
+#if defined(CLOCK_MONOTONIC) && !defined(MS_WINDOWS)
+   struct timespec ts;
+
+   if(clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+      return((double)ts.tv_sec + 1.0e-9 * (double)ts.tv_nsec);
+#endif
+   return((double)clock() / CLOCKS_PER_SEC);
+}
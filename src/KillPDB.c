@@ -3,11 +3,11 @@
 
    \file       KillPDB.c
    
-   \version    V1.12
-   \date       30.09.17
+   \version    V1.13
+   \date       17.10.26
    \brief      
    
-   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1992-2017
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1992-2026
    \author     Dr. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -59,6 +59,10 @@
 -  V1.10 08.10.99 Initialised some variables
 -  V1.11 07.07.14 Use bl prefix for functions By: CTP
 -  V1.12 30.09.17 Added vlDeleteResiduePDB() By: ACRM
+-  V1.13 17.10.26 Added blDeleteAtomsPDB(), blDeleteAtomsAfterPDB() and
+                  blDeleteFlaggedAtomsPDB().
+                  blDeleteAtomRangePDB() and blDeleteResiduePDB() use 
+                  the same single pass   By: ACRM
 
 *************************************************************************/
 /* Doxygen
@@ -82,6 +86,18 @@
    Deletes a residue from the linked list re-linking the list. Returns
    a pointer to the next residue and updates the start of the list if
    it's the first residue that's been deleted
+
+   #FUNCTION blDeleteAtomsPDB()
+   Deletes all atoms for which a function returns TRUE in a single pass
+   through the linked list
+
+   #FUNCTION blDeleteAtomsAfterPDB()
+   Deletes the atoms for which a function returns TRUE from part of the
+   linked list
+
+   #FUNCTION blDeleteFlaggedAtomsPDB()
+   Deletes all atoms flagged in an array in a single pass through the
+   linked list
 */
 /************************************************************************/
 /* Includes
@@ -102,6 +118,10 @@
 /************************************************************************/
 /* Prototypes
 */
+static PDB *SweepAtoms(PDB *start, PDB *stop, PDB *prev, 
+                       BOOL (*DeleteAtom)(PDB *, APTR), APTR data,
+                       BOOL *flags, int *ndeleted);
+static BOOL DeleteAll(PDB *p, APTR data);
 
 
 /************************************************************************/
@@ -118,11 +138,13 @@
    deleted)
 
 -  17.03.15  Original  By: ACRM
+-  17.10.26  Uses SweepAtoms()   By: ACRM
 */
 PDB *blDeleteAtomRangePDB(PDB *pdb, PDB *start, PDB *stop)
 {
    PDB  *p,
-        *prev = NULL;
+        *prev = NULL,
+        *next;
    BOOL found = FALSE;
  
    /* Find the atom previous to start                                   */
@@ -139,16 +161,11 @@ PDB *blDeleteAtomRangePDB(PDB *pdb, PDB *start, PDB *stop)
    if(!found)
       return(pdb);
    
-   /* Now step from start to stop deleting atoms                        */
-   for(p=start; p!=stop;)
-   {
-      PDB *next;
-      next=blKillPDB(p, prev);
-      p=next;
-   }
+   /* Now delete the atoms from start to stop                           */
+   next = SweepAtoms(start, stop, prev, DeleteAll, NULL, NULL, NULL);
 
    if(prev==NULL)
-      return(stop);
+      return(next);
    return(pdb);
 }
 
@@ -168,6 +185,10 @@ PDB *blDeleteAtomRangePDB(PDB *pdb, PDB *start, PDB *stop)
    Returns NULL of all atoms have been deleted. Returns the input
    pdb linked list unmodified if the atom isn't found.
 
+   Each call searches the linked list for the atom, so use 
+   blDeleteAtomsPDB() or blDeleteFlaggedAtomsPDB() to delete many
+   atoms.
+
 -  17.03.15  Original   By: ACRM
 */
 PDB *blDeleteAtomPDB(PDB *pdb, PDB *atom)
@@ -241,12 +262,12 @@ PDB *blKillPDB(PDB *pdb,              /* Pointer to record to kill      */
    residue has been deleted.
 
 -  30.09.17 Original
+-  17.10.26 Uses SweepAtoms()   By: ACRM
 */
 PDB *blDeleteResiduePDB(PDB **pPDB, PDB *res)
 {
    PDB *prevAtom,
-       *nextRes, 
-       *p;
+       *nextRes;
    
    if(*pPDB == NULL)  return(NULL);
 
@@ -265,22 +286,226 @@ PDB *blDeleteResiduePDB(PDB **pPDB, PDB *res)
    /* Find the next residue                                             */
    nextRes = blFindNextResidue(res);
    
-   /* Link the previous atom to the next residue                        */
+   /* Unlink and free the residue, linking the previous atom to the
+      next residue
+   */
+   SweepAtoms(res, nextRes, prevAtom, DeleteAll, NULL, NULL, NULL);
    if(prevAtom == NULL)    /* Start of linked list                      */
-   {
       *pPDB = nextRes;
+   
+   return(nextRes);
+}
+
+
+/************************************************************************/
+/*>static PDB *SweepAtoms(PDB *start, PDB *stop, PDB *prev, 
+                          BOOL (*DeleteAtom)(PDB *, APTR), APTR data,
+                          BOOL *flags, int *ndeleted)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *start      First atom to consider
+   \param[in]     *stop       Atom after the last one to consider (NULL
+                              for the end of the list)
+   \param[in]     *prev       Atom before start (NULL if start is the
+                              start of the list)
+   \param[in]     *DeleteAtom Function returning TRUE for atoms to be 
+                              deleted (used if flags is NULL)
+   \param[in]     data        Passed to DeleteAtom()
+   \param[in]     *flags      Array of flags for the atoms from start
+                              (or NULL)
+   \param[out]    *ndeleted   Number of atoms deleted (or NULL)
+   \return                    The first atom kept from start (stop if
+                              all have been deleted)
+
+   Does the work for the bulk deletion routines. The atoms to be deleted
+   are unlinked onto a separate list as the linked list is traversed so
+   the list is only walked once. The CONECTs back to each deleted atom
+   are then removed from its partners and the deleted atoms are freed.
+   This is linear in the number of atoms, whereas deleting atoms one at
+   a time with blDeleteAtomPDB() is quadratic.
+
+   DeleteAtom() is called exactly once for each atom, in order, and
+   may look at atoms which have already been deleted.
+
+-  17.10.26 Original   By: ACRM
+*/
+static PDB *SweepAtoms(PDB *start, PDB *stop, PDB *prev, 
+                       BOOL (*DeleteAtom)(PDB *, APTR), APTR data,
+                       BOOL *flags, int *ndeleted)
+{
+   PDB  *p, 
+        *q,
+        *next,
+        *first   = stop,
+        *garbage = NULL;
+   int  i, j, k,
+        count    = 0;
+   BOOL delete;
+
+   /* Unlink atoms onto the garbage list                                */
+   for(p=start, i=0; p!=stop; p=next, i++)
+   {
+      next   = p->next;
+      delete = (flags != NULL) ? flags[i] : (*DeleteAtom)(p, data);
+
+      if(delete)
+      {
+         if(prev != NULL)
+            prev->next = next;
+         p->next = garbage;
+         garbage = p;
+         count++;
+      }
+      else
+      {
+         if(first == stop)
+            first = p;
+         prev = p;
+      }
    }
-   else                    /* Elsewhere in the linked list              */
+
+   /* Remove CONECTs back to the deleted atoms. Deleted partners are 
+      updated too which does no harm as they are still allocated
+   */
+   for(p=garbage; p!=NULL; NEXT(p))
    {
-      prevAtom->next = nextRes;
+      for(i=0; i<p->nConect; i++)
+      {
+         if((q = p->conect[i]) == NULL)
+            continue;
+
+         for(j=0, k=0; j<q->nConect; j++)
+         {
+            if(q->conect[j] != p)
+               q->conect[k++] = q->conect[j];
+         }
+         for(j=k; j<q->nConect; j++)
+            q->conect[j] = NULL;
+         q->nConect = k;
+      }
    }
-   
-   for(p=res; p!=nextRes; NEXT(p))
+
+   /* Free the deleted atoms                                            */
+   for(p=garbage; p!=NULL; p=next)
    {
-      blDeleteAtomConects(p);
+      next = p->next;
       free(p);
    }
-   
-   return(nextRes);
+
+   if(ndeleted != NULL)
+      *ndeleted = count;
+   return(first);
 }
 
+
+/************************************************************************/
+/*>static BOOL DeleteAll(PDB *p, APTR data)
+   ----------------------------------------
+*//**
+
+   SweepAtoms() function to delete every atom in a range
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL DeleteAll(PDB *p, APTR data)
+{
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>PDB *blDeleteAtomsPDB(PDB *pdb, BOOL (*DeleteAtom)(PDB *, APTR), 
+                         APTR data, int *ndeleted)
+   ---------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb         Start of PDB linked list
+   \param[in]     *DeleteAtom  Function returning TRUE for atoms to be
+                               deleted
+   \param[in]     data         Passed to DeleteAtom() with each atom
+   \param[out]    *ndeleted    Number of atoms deleted (or NULL)
+   \return                     New start of PDB linked list (NULL if
+                               all atoms have been deleted)
+
+   Deletes all atoms for which DeleteAtom() returns TRUE, removing any
+   CONECTs to them. Should be called as 
+   pdb=blDeleteAtomsPDB(pdb, ...);
+   to allow for the first atom being deleted.
+
+   The linked list is walked once, so the cost is linear in the number
+   of atoms however many are deleted. DeleteAtom() is called once for
+   each atom, in order.
+
+   e.g. to remove waters:
+\code
+   static BOOL IsWater(PDB *p, APTR data)
+   {
+      return(ISWATER(p));
+   }
+   ...
+   pdb = blDeleteAtomsPDB(pdb, IsWater, NULL, &nwaters);
+\endcode
+
+-  17.10.26 Original   By: ACRM
+*/
+PDB *blDeleteAtomsPDB(PDB *pdb, BOOL (*DeleteAtom)(PDB *, APTR), 
+                      APTR data, int *ndeleted)
+{
+   return(SweepAtoms(pdb, NULL, NULL, DeleteAtom, data, NULL, ndeleted));
+}
+
+
+/************************************************************************/
+/*>int blDeleteAtomsAfterPDB(PDB *prev, PDB *stop, 
+                             BOOL (*DeleteAtom)(PDB *, APTR), APTR data)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *prev        Atom before the first one to consider.
+                               This atom is kept
+   \param[in]     *stop        Atom after the last one to consider (NULL
+                               for the end of the list)
+   \param[in]     *DeleteAtom  Function returning TRUE for atoms to be
+                               deleted
+   \param[in]     data         Passed to DeleteAtom() with each atom
+   \return                     Number of atoms deleted
+
+   As blDeleteAtomsPDB(), but only considers the atoms following prev
+   up to stop (e.g. the rest of a residue). As prev is kept, the start
+   of the linked list can't change.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blDeleteAtomsAfterPDB(PDB *prev, PDB *stop, 
+                          BOOL (*DeleteAtom)(PDB *, APTR), APTR data)
+{
+   int ndeleted = 0;
+
+   SweepAtoms(prev->next, stop, prev, DeleteAtom, data, NULL, &ndeleted);
+   return(ndeleted);
+}
+
+
+/************************************************************************/
+/*>PDB *blDeleteFlaggedAtomsPDB(PDB *pdb, BOOL *flags, int *ndeleted)
+   ------------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb         Start of PDB linked list
+   \param[in]     *flags       Array with a flag for each atom in the
+                               linked list. TRUE to delete the atom
+   \param[out]    *ndeleted    Number of atoms deleted (or NULL)
+   \return                     New start of PDB linked list (NULL if
+                               all atoms have been deleted)
+
+   Deletes the atoms flagged in an array indexed by position in the 
+   linked list (as given by blIndexPDB()), removing any CONECTs to them.
+   As for blDeleteAtomsPDB(), the linked list is only walked once.
+
+-  17.10.26 Original   By: ACRM
+*/
+PDB *blDeleteFlaggedAtomsPDB(PDB *pdb, BOOL *flags, int *ndeleted)
+{
+   return(SweepAtoms(pdb, NULL, NULL, NULL, NULL, flags, ndeleted));
+}
@@ -3,11 +3,11 @@
 
    \file       KillSidechain.c
    
-   \version    V1.11
-   \date       07.07.14
+   \version    V1.12
+   \date       17.10.26
    \brief      
    
-   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1992-2014
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1992-2026
    \author     Dr. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -58,6 +58,7 @@
 -  V1.9  14.03.96 Added FindAtomInRes()
 -  V1.10 08.10.99 Initialised some variables
 -  V1.11 07.07.14 Use bl prefix for functions By: CTP
+-  V1.12 17.10.26 blKillSidechain() uses blDeleteAtomsAfterPDB()
 
 *************************************************************************/
 /* Doxygen
@@ -71,6 +72,7 @@
 /* Includes
 */
 #include <stdlib.h>
+#include <string.h>
 
 #include "SysDefs.h"
 #include "pdb.h"
@@ -87,6 +89,7 @@
 /************************************************************************/
 /* Prototypes
 */
+static BOOL IsSidechainAtom(PDB *p, APTR doCB);
 
 
 /************************************************************************/
@@ -99,49 +102,55 @@
    \param[in]     doCB          Flag to kill CB as part of s/c
    \return                      Success?
    
-   Kills sidechains by calls to KillPDB() for residues between ResStart 
-   and NextRes. If doCB is set, will kill the CB. 
+   Kills sidechains for residues between ResStart and NextRes. If doCB
+   is set, will kill the CB. 
 
    N.B. At least 1 backbone atom must occur in the linked list before the
    sidechain.
    
 -  12.05.92 Original
 -  05.10.94 doCB is now a BOOL as is the return
+-  17.10.26 Deletes the atoms in one pass with blDeleteAtomsAfterPDB()
+            By: ACRM
 */
 BOOL blKillSidechain(PDB *ResStart, /* Pointer to start of residue      */
                      PDB *NextRes,  /* Pointer to start if next residue */
                      BOOL doCB)     /* Flag to kill the CB              */
 {
-   PDB *p,
-       *prev = NULL;
-   
-   for(p=ResStart; p && p!=NextRes; NEXT(p))
-   {
-      if(strcmp(p->atnam, "N   ") &&
-         strcmp(p->atnam, "CA  ") &&
-         strcmp(p->atnam, "C   ") &&
-         strcmp(p->atnam, "O   ") &&
-         strcmp(p->atnam, "CB  "))
-      {
-         if(prev == NULL) return(FALSE); /* No b/b atom before s/c      */
-
-         /* blKillPDB() returns the next in list, so exit if list ended */
-         if(blKillPDB(p, prev) == NULL) break;
-         p = prev;
-      }
-      
-      /* Kill the CB if required                                        */
-      if(doCB && !strcmp(p->atnam,"CB  "))
-      {
-         if(prev == NULL) return(FALSE);  /* No b/b atom before s/c     */
-
-         /* blKillPDB() returns the next in list, so exit if list ended */
-         if(blKillPDB(p, prev) == NULL) break;
-         p = prev;
-      }
-      
-      prev = p;
-   }
+   if((ResStart == NULL) || (ResStart == NextRes))
+      return(TRUE);
+
+   /* No b/b atom before s/c                                            */
+   if(IsSidechainAtom(ResStart, (APTR)&doCB))
+      return(FALSE);
+
+   blDeleteAtomsAfterPDB(ResStart, NextRes, IsSidechainAtom, 
+                         (APTR)&doCB);
    return(TRUE);
 }
 
+
+/************************************************************************/
+/*>static BOOL IsSidechainAtom(PDB *p, APTR doCB)
+   ----------------------------------------------
+*//**
+
+   \param[in]     *p      Atom to test
+   \param[in]     doCB    Pointer to the BOOL doCB flag
+   \return                Is the atom a sidechain atom?
+
+   blDeleteAtomsAfterPDB() test for blKillSidechain()
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL IsSidechainAtom(PDB *p, APTR doCB)
+{
+   if(!strcmp(p->atnam, "CB  "))
+      return(*((BOOL *)doCB));
+
+   return(strcmp(p->atnam, "N   ") &&
+          strcmp(p->atnam, "CA  ") &&
+          strcmp(p->atnam, "C   ") &&
+          strcmp(p->atnam, "O   "));
+}
+
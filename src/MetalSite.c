@@ -0,0 +1,1500 @@
+/************************************************************************/
+/**
+
+   \file       MetalSite.c
+
+   \version    V1.2
+   \date       17.10.26
+   \brief      Search for metal-binding site geometries
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Searches structures for sets of residues whose backbone geometry
+   matches a known metal-binding site. The templates are read from
+   zn_sites.dat, cu_sites.dat and ca_ef_sites.dat, where each site is
+   given as a numbered description line followed by one ATOM line for
+   each of its 3 or 4 residues. Most sites appear twice: once as C-alpha
+   and once as C-beta positions. Consecutive templates of the same 
+   residues from the same structure are partners and a site is only 
+   reported if the same residues match both of them.
+
+   When the templates are read, the distances between their atoms are
+   calculated and the templates are sorted by the distance between
+   their first two atoms. A structure is searched by placing the atoms
+   with names used in the templates on a grid. For each pair of atoms
+   within the longest template distance, a binary search finds the
+   templates whose first distance matches. The remaining template atoms
+   are then looked for among the neighbours of the first atom using the
+   distance matrix. Each complete match is fitted to the template with
+   blMatfit() and kept if the RMSD is within the cutoff. Finally, a 
+   match to a template with a partner is kept only if the same residues,
+   in the same order, also match the partner; the pair is then reported
+   as a single hit.
+
+   The residues need not be of the same type as in the template (a site
+   could be engineered by mutation) unless matchResnam is set.
+
+   Files may be searched in parallel. If the library is compiled with
+   PTHREAD_SUPPORT, a pool of threads takes files from the list in turn;
+   otherwise the files are searched one after another.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   METALSITELIB *lib;
+   METALSITEHIT *hits;
+   int          nhits;
+
+   lib  = blReadDefaultMetalSiteLib();
+   hits = blFindMetalSites(lib, pdb, METALSITE_DEFDISTTOL,
+                           METALSITE_DEFRMSD, FALSE, &nhits);
+   blPrintMetalSiteHits(stdout, lib, hits);
+   blFreeMetalSiteHits(hits);
+   blFreeMetalSiteLib(lib);
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Uses blRunThreadPool()   By: ACRM
+-  V1.2  17.10.26 A site is only reported if both its C-alpha and its
+                  C-beta templates match   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP Searching the PDB linked list
+
+   #FUNCTION  blReadMetalSiteLib()
+   Reads a file of metal site templates
+
+   #FUNCTION  blReadDefaultMetalSiteLib()
+   Reads the zinc, copper and calcium site templates
+
+   #FUNCTION  blFreeMetalSiteLib()
+   Frees a metal site template library
+
+   #FUNCTION  blFindMetalSites()
+   Searches a PDB linked list for metal site geometries
+
+   #FUNCTION  blFindMetalSitesFiles()
+   Searches a list of PDB files for metal site geometries
+
+   #FUNCTION  blFindMetalSitesDir()
+   Searches all the PDB files in a directory for metal site geometries
+
+   #FUNCTION  blFreeMetalSiteHits()
+   Frees a list of metal site matches
+
+   #FUNCTION  blPrintMetalSiteHits()
+   Prints a list of metal site matches
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+#ifndef MS_WINDOWS
+#include <dirent.h>
+#endif
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "general.h"
+#include "pdb.h"
+#include "fit.h"
+#include "matrix.h"
+#include "atomgrid.h"
+#include "threadpool.h"
+#include "metalsite.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define MAXBUFF     160
+#define ALLOCSTEP   16
+#define DATAENV     "DATADIR"
+
+/* A hit with its template and atoms in a canonical order              */
+typedef struct
+{
+   METALSITEHIT *hit;
+   REAL         rmsd;
+   int          key[METALSITE_MAXATOMS+1],
+                site[METALSITE_MAXATOMS+1],  /* Template and residues  */
+                order;
+   BOOL         keep;
+}  HITKEY;
+
+/* State of a search of one structure                                   */
+typedef struct
+{
+   METALSITELIB *lib;
+   PDB          **atoms;
+   REAL         *x, *y, *z,
+                distTol,
+                rmsdTol;
+   int          *nameIndex,
+                *residue,
+                *neighbs,
+                nneighbs,
+                natoms,
+                nhits,
+                chosen[METALSITE_MAXATOMS];
+   BOOL         matchResnam,
+                ok;
+   METALSITEHIT *hits,
+                *lastHit;
+   HITKEY       *keys;
+   int          maxkeys;
+}  SITESEARCH;
+
+/* A scan of a list of files                                            */
+typedef struct
+{
+   METALSITELIB *lib;
+   METALSITEHIT **hits;
+   char         **files;
+   REAL         distTol,
+                rmsdTol;
+   int          nfiles,
+                next,
+                nscanned;
+   BOOL         matchResnam;
+}  SITESCAN;
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static BOOL IndexTemplates(METALSITELIB *lib);
+static int  CompareEdges(const void *a, const void *b);
+static BOOL TemplateMatchesAtom(SITESEARCH *search, METALTEMPLATE *t,
+                                int k, int atom);
+static void ExtendMatch(SITESEARCH *search, int tnum, int k);
+static void FillHit(SITESEARCH *search, METALSITEHIT *hit, int tnum,
+                    REAL rmsd);
+static void StoreMatch(SITESEARCH *search, int tnum);
+static int  CompareHitKeys(const void *a, const void *b);
+static int  CompareHitOrder(const void *a, const void *b);
+static void RemoveDuplicateHits(SITESEARCH *search);
+static int  CompareSiteKeys(const void *a, const void *b);
+static void CombineSiteHits(SITESEARCH *search);
+static void LinkHits(SITESEARCH *search);
+static BOOL SameTemplateSite(METALTEMPLATE *a, METALTEMPLATE *b);
+static METALSITEHIT *SearchPDB(METALSITELIB *lib, PDB *pdb,
+                               REAL distTol, REAL rmsdTol,
+                               BOOL matchResnam, int *nhits, BOOL *ok);
+static void *ScanFiles(void *arg);
+
+
+/************************************************************************/
+/*>METALSITELIB *blReadMetalSiteLib(METALSITELIB *lib, char *filename,
+                                    char *metal)
+   -------------------------------------------------------------------
+*//**
+
+   \param[in,out] *lib       Library to add to, or NULL to create one
+   \param[in]     *filename  Template file. Looked for in the current
+                             directory and then in $DATADIR
+   \param[in]     *metal     Label for these templates (e.g. "ZN")
+   \return                   The library or NULL on error. On error, a
+                             library passed in has been freed
+
+   Reads the site templates from a file such as zn_sites.dat. Each
+   template is a line starting with a number and a closing bracket
+   followed by 3 or 4 ATOM records. The templates are indexed once they
+   have been read.
+
+-  17.10.26 Original   By: ACRM
+-  17.10.26 Records the residue of each template atom   By: ACRM
+*/
+METALSITELIB *blReadMetalSiteLib(METALSITELIB *lib, char *filename,
+                                 char *metal)
+{
+   FILE          *fp;
+   METALTEMPLATE *t      = NULL;
+   char          buffer[MAXBUFF],
+                 words[7][MAXBUFF],
+                 *ch;
+   double        x, y, z;
+   int           maxtemplates,
+                 nwords;
+   BOOL          noenv,
+                 ok      = TRUE;
+
+   if((fp=blOpenFile(filename, DATAENV, "r", &noenv))==NULL)
+   {
+      blFreeMetalSiteLib(lib);
+      return(NULL);
+   }
+
+   if(lib == NULL)
+   {
+      if((lib=(METALSITELIB *)malloc(sizeof(METALSITELIB)))==NULL)
+      {
+         fclose(fp);
+         return(NULL);
+      }
+      lib->templates  = NULL;
+      lib->edges      = NULL;
+      lib->ntemplates = 0;
+      lib->natnams    = 0;
+      lib->maxDist    = (REAL)0.0;
+   }
+   maxtemplates = lib->ntemplates;
+
+   while(ok && fgets(buffer, MAXBUFF, fp))
+   {
+      TERMINATE(buffer);
+
+      if(isdigit(buffer[0]) && ((ch=strchr(buffer, ')'))!=NULL))
+      {
+         /* Start of a new template                                     */
+         if(lib->ntemplates >= maxtemplates)
+         {
+            METALTEMPLATE *newTemplates;
+            if((newTemplates = (METALTEMPLATE *)
+                realloc(lib->templates, (maxtemplates + ALLOCSTEP) *
+                        sizeof(METALTEMPLATE)))==NULL)
+            {
+               ok = FALSE;
+               break;
+            }
+            lib->templates = newTemplates;
+            maxtemplates  += ALLOCSTEP;
+         }
+         t = &(lib->templates[lib->ntemplates++]);
+         t->natoms = 0;
+         for(ch++; *ch == ' '; ch++);
+         strncpy(t->name, ch, METALSITE_MAXDESC-1);
+         t->name[METALSITE_MAXDESC-1] = '\0';
+         strncpy(t->metal, metal, 7);
+         t->metal[7] = '\0';
+      }
+      else if(!strncmp(buffer, "ATOM  ", 6) && (t != NULL))
+      {
+         /* Atom name, residue name, optional chain, residue number and
+            coordinates
+         */
+         nwords = sscanf(buffer+11, "%s %s %s %s %s %s %s",
+                         words[0], words[1], words[2], words[3],
+                         words[4], words[5], words[6]);
+         if((nwords < 6) || (t->natoms >= METALSITE_MAXATOMS) ||
+            (strlen(words[0]) > 4) || (strlen(words[1]) > 4) ||
+            (strlen(words[nwords-4]) > 7) || (strlen(words[2]) > 7) ||
+            (sscanf(words[nwords-3], "%lf", &x) != 1) ||
+            (sscanf(words[nwords-2], "%lf", &y) != 1) ||
+            (sscanf(words[nwords-1], "%lf", &z) != 1))
+         {
+            ok = FALSE;
+            break;
+         }
+         strcpy(t->atnam[t->natoms],  words[0]);
+         strcpy(t->resnam[t->natoms], words[1]);
+         t->resid[t->natoms][0] = '\0';
+         if(nwords == 7)
+            strcpy(t->resid[t->natoms], words[2]);
+         strcat(t->resid[t->natoms], words[nwords-4]);
+         t->coor[t->natoms].x = (REAL)x;
+         t->coor[t->natoms].y = (REAL)y;
+         t->coor[t->natoms].z = (REAL)z;
+         t->natoms++;
+      }
+   }
+   fclose(fp);
+
+   if(ok)
+      ok = IndexTemplates(lib);
+   if(!ok)
+   {
+      blFreeMetalSiteLib(lib);
+      return(NULL);
+   }
+
+   return(lib);
+}
+
+
+/************************************************************************/
+/*>METALSITELIB *blReadDefaultMetalSiteLib(void)
+   ---------------------------------------------
+*//**
+
+   \return                   The library or NULL on error
+
+   Reads the zinc, copper and calcium (EF-hand) site templates from
+   METALSITE_ZNFILE, METALSITE_CUFILE and METALSITE_CAFILE, labelling
+   them ZN, CU and CA.
+
+-  17.10.26 Original   By: ACRM
+*/
+METALSITELIB *blReadDefaultMetalSiteLib(void)
+{
+   METALSITELIB *lib;
+
+   lib = blReadMetalSiteLib(NULL, METALSITE_ZNFILE, "ZN");
+   if(lib != NULL)
+      lib = blReadMetalSiteLib(lib, METALSITE_CUFILE, "CU");
+   if(lib != NULL)
+      lib = blReadMetalSiteLib(lib, METALSITE_CAFILE, "CA");
+   return(lib);
+}
+
+
+/************************************************************************/
+/*>void blFreeMetalSiteLib(METALSITELIB *lib)
+   ------------------------------------------
+*//**
+
+   \param[in]     *lib      Library
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeMetalSiteLib(METALSITELIB *lib)
+{
+   if(lib == NULL)
+      return;
+
+   FREE(lib->templates);
+   FREE(lib->edges);
+   free(lib);
+}
+
+
+/************************************************************************/
+/*>static int CompareEdges(const void *a, const void *b)
+   -----------------------------------------------------
+*//**
+
+   qsort() comparison of template edges by distance
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CompareEdges(const void *a, const void *b)
+{
+   REAL da = ((METALEDGE *)a)->dist,
+        db = ((METALEDGE *)b)->dist;
+
+   if(da < db) return(-1);
+   if(da > db) return(1);
+   return(((METALEDGE *)a)->template - ((METALEDGE *)b)->template);
+}
+
+
+/************************************************************************/
+/*>static BOOL IndexTemplates(METALSITELIB *lib)
+   ---------------------------------------------
+*//**
+
+   \param[in,out] *lib      Library
+   \return                  Success
+
+   Calculates the distance matrix of each template, centres its
+   coordinates, records the atom names used and sorts the templates by
+   the distance between their first two atoms. Consecutive templates
+   of the same site are made partners.
+
+-  17.10.26 Original   By: ACRM
+-  17.10.26 Pairs the templates of each site   By: ACRM
+*/
+static BOOL IndexTemplates(METALSITELIB *lib)
+{
+   METALTEMPLATE *t;
+   VEC3F         centre;
+   int           i, j, k;
+
+   lib->natnams = 0;
+   lib->maxDist = (REAL)0.0;
+   FREE(lib->edges);
+   if((lib->edges = (METALEDGE *)malloc((lib->ntemplates + 1) *
+                                        sizeof(METALEDGE)))==NULL)
+      return(FALSE);
+
+   for(i=0; i<lib->ntemplates; i++)
+   {
+      t = &(lib->templates[i]);
+      if(t->natoms < 3)
+         return(FALSE);
+
+      for(j=0; j<t->natoms; j++)
+      {
+         for(k=0; k<t->natoms; k++)
+         {
+            t->dist[j][k] = DIST(&(t->coor[j]), &(t->coor[k]));
+            if(t->dist[j][k] > lib->maxDist)
+               lib->maxDist = t->dist[j][k];
+         }
+
+         for(k=0; k<lib->natnams; k++)
+         {
+            if(!strcmp(lib->atnams[k], t->atnam[j]))
+               break;
+         }
+         if(k == lib->natnams)
+         {
+            if(lib->natnams >= METALSITE_MAXNAMES)
+               return(FALSE);
+            strcpy(lib->atnams[lib->natnams++], t->atnam[j]);
+         }
+         t->nameIndex[j] = k;
+      }
+
+      /* Centre the coordinates ready for fitting                       */
+      centre.x = centre.y = centre.z = (REAL)0.0;
+      for(j=0; j<t->natoms; j++)
+      {
+         centre.x += t->coor[j].x;
+         centre.y += t->coor[j].y;
+         centre.z += t->coor[j].z;
+      }
+      for(j=0; j<t->natoms; j++)
+      {
+         t->coor[j].x -= centre.x / t->natoms;
+         t->coor[j].y -= centre.y / t->natoms;
+         t->coor[j].z -= centre.z / t->natoms;
+      }
+
+      lib->edges[i].dist     = t->dist[0][1];
+      lib->edges[i].template = i;
+
+      t->partner = (-1);
+      if((i > 0) && (lib->templates[i-1].partner == (-1)) &&
+         SameTemplateSite(&(lib->templates[i-1]), t))
+      {
+         t->partner = i-1;
+         lib->templates[i-1].partner = i;
+      }
+   }
+
+   qsort(lib->edges, lib->ntemplates, sizeof(METALEDGE), CompareEdges);
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static BOOL SameTemplateSite(METALTEMPLATE *a, METALTEMPLATE *b)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in]     *a       Template
+   \param[in]     *b       Template
+   \return                 Do the templates describe the same site?
+
+   Templates describe the same site (e.g. as C-alpha and C-beta 
+   patterns) if they have the same metal, come from the same structure
+   (the first word of the description) and use the same residues but
+   not all the same atoms. (Calcium sites share carbonyl oxygens.)
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL SameTemplateSite(METALTEMPLATE *a, METALTEMPLATE *b)
+{
+   int  i;
+   BOOL sameAtoms = TRUE;
+
+   if((a->natoms != b->natoms) || strcmp(a->metal, b->metal) ||
+      strncmp(a->name, b->name, strcspn(a->name, " ")+1))
+      return(FALSE);
+
+   for(i=0; i<a->natoms; i++)
+   {
+      if(strcmp(a->resnam[i], b->resnam[i]) ||
+         strcmp(a->resid[i], b->resid[i]))
+         return(FALSE);
+      if(strcmp(a->atnam[i], b->atnam[i]))
+         sameAtoms = FALSE;
+   }
+   return(!sameAtoms);
+}
+
+
+/************************************************************************/
+/*>static BOOL TemplateMatchesAtom(SITESEARCH *search, METALTEMPLATE *t,
+                                   int k, int atom)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *search   Search state with atoms 0..k-1 chosen
+   \param[in]     *t        Template
+   \param[in]     k         Template atom
+   \param[in]     atom      Candidate atom
+   \return                  Can the atom be template atom k?
+
+   Checks the atom name, that the residue has not already been used,
+   optionally the residue name, and the distances to the atoms already
+   chosen.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL TemplateMatchesAtom(SITESEARCH *search, METALTEMPLATE *t,
+                                int k, int atom)
+{
+   int  j, other;
+   REAL dx, dy, dz, d;
+
+   if(search->nameIndex[atom] != t->nameIndex[k])
+      return(FALSE);
+   if(search->matchResnam &&
+      strncmp(search->atoms[atom]->resnam, t->resnam[k],
+              strlen(t->resnam[k])))
+      return(FALSE);
+
+   for(j=0; j<k; j++)
+   {
+      other = search->chosen[j];
+      if(search->residue[other] == search->residue[atom])
+         return(FALSE);
+
+      dx = search->x[atom] - search->x[other];
+      dy = search->y[atom] - search->y[other];
+      dz = search->z[atom] - search->z[other];
+      d  = (REAL)sqrt(dx*dx + dy*dy + dz*dz);
+      if(ABS(d - t->dist[j][k]) > search->distTol)
+         return(FALSE);
+   }
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static void ExtendMatch(SITESEARCH *search, int tnum, int k)
+   ------------------------------------------------------------
+*//**
+
+   \param[in,out] *search   Search state with atoms 0..k-1 chosen
+   \param[in]     tnum      Template
+   \param[in]     k         Next template atom to match
+
+   Tries each neighbour of the first chosen atom as template atom k.
+   When all the atoms have been chosen, the match is fitted.
+
+-  17.10.26 Original   By: ACRM
+*/
+static void ExtendMatch(SITESEARCH *search, int tnum, int k)
+{
+   METALTEMPLATE *t = &(search->lib->templates[tnum]);
+   int           i;
+
+   if((k == t->natoms) || (k >= METALSITE_MAXATOMS))
+   {
+      StoreMatch(search, tnum);
+      return;
+   }
+
+   for(i=0; (i<search->nneighbs) && search->ok; i++)
+   {
+      if(TemplateMatchesAtom(search, t, k, search->neighbs[i]))
+      {
+         search->chosen[k] = search->neighbs[i];
+         ExtendMatch(search, tnum, k+1);
+      }
+   }
+}
+
+
+/************************************************************************/
+/*>static void FillHit(SITESEARCH *search, METALSITEHIT *hit, int tnum,
+                       REAL rmsd)
+   --------------------------------------------------------------------
+*//**
+
+   \param[in]     *search   Search state with all atoms chosen
+   \param[out]    *hit      Hit to fill in
+   \param[in]     tnum      Template
+   \param[in]     rmsd      RMSD of the fit
+
+   Records the chosen atoms and their residues in a hit
+
+-  17.10.26 Original   By: ACRM
+*/
+static void FillHit(SITESEARCH *search, METALSITEHIT *hit, int tnum,
+                    REAL rmsd)
+{
+   PDB *p;
+   int i;
+
+   hit->rmsd     = rmsd;
+   hit->template = tnum;
+   hit->natoms   = search->lib->templates[tnum].natoms;
+   for(i=0; i<hit->natoms; i++)
+   {
+      p = search->atoms[search->chosen[i]];
+      hit->atoms[i]  = p;
+      hit->resnum[i] = p->resnum;
+      strcpy(hit->chain[i],  p->chain);
+      strcpy(hit->insert[i], p->insert);
+      strcpy(hit->resnam[i], p->resnam);
+      KILLTRAILSPACES(hit->insert[i]);
+      KILLTRAILSPACES(hit->resnam[i]);
+   }
+}
+
+
+/************************************************************************/
+/*>static void StoreMatch(SITESEARCH *search, int tnum)
+   ----------------------------------------------------
+*//**
+
+   \param[in,out] *search   Search state with all atoms chosen
+   \param[in]     tnum      Template
+
+   Fits the chosen atoms to the template and adds a hit to the list if
+   the RMSD is within the cutoff. A key is stored with each hit so that
+   RemoveDuplicateHits() can find the same atoms matching the template
+   in another order, and another so that CombineSiteHits() can find the
+   same residues matching the partner template.
+
+-  17.10.26 Original   By: ACRM
+-  17.10.26 Also stores the site key   By: ACRM
+*/
+static void StoreMatch(SITESEARCH *search, int tnum)
+{
+   METALTEMPLATE *t = &(search->lib->templates[tnum]);
+   METALSITEHIT  *hit;
+   COOR          site[METALSITE_MAXATOMS];
+   VEC3F         centre,
+                 rotated;
+   REAL          rm[3][3],
+                 sumsq = (REAL)0.0,
+                 rmsd;
+   int           i, j,
+                 *key;
+
+   centre.x = centre.y = centre.z = (REAL)0.0;
+   for(i=0; i<t->natoms; i++)
+   {
+      centre.x += search->x[search->chosen[i]];
+      centre.y += search->y[search->chosen[i]];
+      centre.z += search->z[search->chosen[i]];
+   }
+   for(i=0; i<t->natoms; i++)
+   {
+      site[i].x = search->x[search->chosen[i]] - centre.x / t->natoms;
+      site[i].y = search->y[search->chosen[i]] - centre.y / t->natoms;
+      site[i].z = search->z[search->chosen[i]] - centre.z / t->natoms;
+   }
+
+   if(!blMatfit(t->coor, site, rm, t->natoms, NULL, FALSE))
+      return;
+
+   for(i=0; i<t->natoms; i++)
+   {
+      blMatMult3_33(site[i], rm, &rotated);
+      sumsq += DISTSQ(&rotated, &(t->coor[i]));
+   }
+   if((rmsd = (REAL)sqrt(sumsq / t->natoms)) > search->rmsdTol)
+      return;
+
+   if(search->nhits >= search->maxkeys)
+   {
+      HITKEY *newKeys;
+      if((newKeys = (HITKEY *)realloc(search->keys,
+                                      (search->maxkeys + ALLOCSTEP) *
+                                      sizeof(HITKEY)))==NULL)
+      {
+         search->ok = FALSE;
+         return;
+      }
+      search->keys     = newKeys;
+      search->maxkeys += ALLOCSTEP;
+   }
+
+   if((hit = (METALSITEHIT *)malloc(sizeof(METALSITEHIT)))==NULL)
+   {
+      search->ok = FALSE;
+      return;
+   }
+   hit->next     = NULL;
+   hit->filename = NULL;
+   FillHit(search, hit, tnum, rmsd);
+
+   /* Key of the template and the atoms in ascending order             */
+   key = search->keys[search->nhits].key;
+   key[0] = tnum;
+   for(i=0; i<METALSITE_MAXATOMS; i++)
+   {
+      key[i+1] = (i < t->natoms) ? search->chosen[i] : (-1);
+      for(j=i; (j>0) && (key[j] > key[j+1]); j--)
+      {
+         int tmp  = key[j];
+         key[j]   = key[j+1];
+         key[j+1] = tmp;
+      }
+   }
+   /* Site of the template and the residues in template order        */
+   key = search->keys[search->nhits].site;
+   key[0] = tnum;
+   for(i=0; i<METALSITE_MAXATOMS; i++)
+      key[i+1] = (i < t->natoms) ? search->residue[search->chosen[i]]
+                                 : (-1);
+
+   search->keys[search->nhits].hit   = hit;
+   search->keys[search->nhits].rmsd  = rmsd;
+   search->keys[search->nhits].order = search->nhits;
+
+   if(search->lastHit == NULL)
+      search->hits = hit;
+   else
+      search->lastHit->next = hit;
+   search->lastHit = hit;
+   search->nhits++;
+}
+
+
+/************************************************************************/
+/*>static int CompareHitKeys(const void *a, const void *b)
+   -------------------------------------------------------
+*//**
+
+   qsort() comparison of hit keys by template and atoms, then RMSD and
+   the order they were found
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CompareHitKeys(const void *a, const void *b)
+{
+   HITKEY *ka = (HITKEY *)a,
+          *kb = (HITKEY *)b;
+   int    i;
+
+   for(i=0; i<=METALSITE_MAXATOMS; i++)
+   {
+      if(ka->key[i] != kb->key[i])
+         return((ka->key[i] < kb->key[i]) ? -1 : 1);
+   }
+   if(ka->rmsd != kb->rmsd)
+      return((ka->rmsd < kb->rmsd) ? -1 : 1);
+   return(ka->order - kb->order);
+}
+
+
+/************************************************************************/
+/*>static int CompareHitOrder(const void *a, const void *b)
+   --------------------------------------------------------
+*//**
+
+   qsort() comparison of hit keys by the order they were found
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CompareHitOrder(const void *a, const void *b)
+{
+   return(((HITKEY *)a)->order - ((HITKEY *)b)->order);
+}
+
+
+/************************************************************************/
+/*>static void RemoveDuplicateHits(SITESEARCH *search)
+   ---------------------------------------------------
+*//**
+
+   \param[in,out] *search   Search state with all hits found
+
+   The same atoms can match a template in more than one order (for
+   example when all its atoms are C-alphas). Sorting the keys brings
+   these together; the best fit of each is kept and the others are
+   freed. The remaining hits are relinked in the order they were found.
+
+-  17.10.26 Original   By: ACRM
+*/
+static void RemoveDuplicateHits(SITESEARCH *search)
+{
+   int i, nkept = 0;
+
+   if(search->nhits < 2)
+      return;
+
+   qsort(search->keys, search->nhits, sizeof(HITKEY), CompareHitKeys);
+   for(i=0; i<search->nhits; i++)
+   {
+      if((nkept > 0) &&
+         !memcmp(search->keys[i].key, search->keys[nkept-1].key,
+                 (METALSITE_MAXATOMS+1) * sizeof(int)))
+      {
+         free(search->keys[i].hit);
+         continue;
+      }
+      search->keys[nkept++] = search->keys[i];
+   }
+   qsort(search->keys, nkept, sizeof(HITKEY), CompareHitOrder);
+   search->nhits = nkept;
+   LinkHits(search);
+}
+
+
+/************************************************************************/
+/*>static void LinkHits(SITESEARCH *search)
+   ----------------------------------------
+*//**
+
+   \param[in,out] *search   Search state
+
+   Relinks the hits of the keys in the order of the keys
+
+-  17.10.26 Original   By: ACRM
+*/
+static void LinkHits(SITESEARCH *search)
+{
+   int i;
+
+   search->hits    = NULL;
+   search->lastHit = NULL;
+   for(i=0; i<search->nhits; i++)
+   {
+      search->keys[i].hit->next =
+         (i < search->nhits-1) ? search->keys[i+1].hit : NULL;
+   }
+   if(search->nhits > 0)
+   {
+      search->hits    = search->keys[0].hit;
+      search->lastHit = search->keys[search->nhits-1].hit;
+   }
+}
+
+
+/************************************************************************/
+/*>static int CompareSiteKeys(const void *a, const void *b)
+   --------------------------------------------------------
+*//**
+
+   qsort() and bsearch() comparison of hit keys by template and the
+   residues in template order
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CompareSiteKeys(const void *a, const void *b)
+{
+   HITKEY *ka = (HITKEY *)a,
+          *kb = (HITKEY *)b;
+   int    i;
+
+   for(i=0; i<=METALSITE_MAXATOMS; i++)
+   {
+      if(ka->site[i] != kb->site[i])
+         return((ka->site[i] < kb->site[i]) ? -1 : 1);
+   }
+   return(0);
+}
+
+
+/************************************************************************/
+/*>static void CombineSiteHits(SITESEARCH *search)
+   -----------------------------------------------
+*//**
+
+   \param[in,out] *search   Search state with all hits found
+
+   A site with two templates (C-alpha and C-beta) is only found if the 
+   same residues match both. Each hit to the first template of a pair
+   is kept, with the worse of the two RMSDs, if the partner template 
+   matched the same residues in the same order. All other hits to 
+   paired templates are freed. The remaining hits are relinked in the
+   order they were found.
+
+-  17.10.26 Original   By: ACRM
+*/
+static void CombineSiteHits(SITESEARCH *search)
+{
+   HITKEY probe,
+          *found;
+   int    i, tnum, partner,
+          nkept = 0;
+
+   if(search->nhits == 0)
+      return;
+
+   qsort(search->keys, search->nhits, sizeof(HITKEY), CompareSiteKeys);
+   for(i=0; i<search->nhits; i++)
+   {
+      tnum    = search->keys[i].site[0];
+      partner = search->lib->templates[tnum].partner;
+      search->keys[i].keep = (partner == (-1));
+
+      if(partner > tnum)
+      {
+         probe         = search->keys[i];
+         probe.site[0] = partner;
+         if((found = (HITKEY *)bsearch(&probe, search->keys,
+                                       search->nhits, sizeof(HITKEY),
+                                       CompareSiteKeys))!=NULL)
+         {
+            search->keys[i].keep = TRUE;
+            if(found->rmsd > search->keys[i].rmsd)
+            {
+               search->keys[i].rmsd      = found->rmsd;
+               search->keys[i].hit->rmsd = found->rmsd;
+            }
+         }
+      }
+   }
+
+   for(i=0; i<search->nhits; i++)
+   {
+      if(search->keys[i].keep)
+         search->keys[nkept++] = search->keys[i];
+      else
+         free(search->keys[i].hit);
+   }
+   qsort(search->keys, nkept, sizeof(HITKEY), CompareHitOrder);
+   search->nhits = nkept;
+   LinkHits(search);
+}
+
+
+/************************************************************************/
+/*>static METALSITEHIT *SearchPDB(METALSITELIB *lib, PDB *pdb,
+                                  REAL distTol, REAL rmsdTol,
+                                  BOOL matchResnam, int *nhits,
+                                  BOOL *ok)
+   -----------------------------------------------------------
+*//**
+
+   \param[in]     *lib          Template library
+   \param[in]     *pdb          PDB linked list
+   \param[in]     distTol       Tolerance on each distance
+   \param[in]     rmsdTol       RMSD cutoff after fitting
+   \param[in]     matchResnam   Require the template residue types
+   \param[out]    *nhits        Number of hits
+   \param[out]    *ok           Success (FALSE if memory ran out)
+   \return                      Linked list of hits
+
+   Does the work for blFindMetalSites()
+
+-  17.10.26 Original   By: ACRM
+*/
+static METALSITEHIT *SearchPDB(METALSITELIB *lib, PDB *pdb,
+                               REAL distTol, REAL rmsdTol,
+                               BOOL matchResnam, int *nhits, BOOL *ok)
+{
+   SITESEARCH search;
+   ATOMGRID   *grid = NULL;
+   PDB        *p,
+              *prev = NULL;
+   char       atnam[8];
+   int        maxNeighbs = 0,
+              natoms     = 0,
+              nres       = 0,
+              lo, hi, mid,
+              i, j, e, k;
+   REAL       dx, dy, dz, d;
+
+   *nhits            = 0;
+   *ok               = TRUE;
+   search.lib        = lib;
+   search.distTol    = distTol;
+   search.rmsdTol    = rmsdTol;
+   search.matchResnam = matchResnam;
+   search.ok         = TRUE;
+   search.hits       = NULL;
+   search.lastHit    = NULL;
+   search.nhits      = 0;
+   search.neighbs    = NULL;
+   search.natoms     = 0;
+   search.keys       = NULL;
+   search.maxkeys    = 0;
+
+   if((lib == NULL) || (lib->ntemplates == 0))
+      return(NULL);
+
+   for(p=pdb; p!=NULL; NEXT(p))
+      natoms++;
+
+   search.atoms     = (PDB **)malloc((natoms+1) * sizeof(PDB *));
+   search.x         = (REAL *)malloc((natoms+1) * sizeof(REAL));
+   search.y         = (REAL *)malloc((natoms+1) * sizeof(REAL));
+   search.z         = (REAL *)malloc((natoms+1) * sizeof(REAL));
+   search.nameIndex = (int  *)malloc((natoms+1) * sizeof(int));
+   search.residue   = (int  *)malloc((natoms+1) * sizeof(int));
+   if((search.atoms == NULL) || (search.x == NULL) ||
+      (search.y == NULL) || (search.z == NULL) ||
+      (search.nameIndex == NULL) || (search.residue == NULL))
+      search.ok = FALSE;
+
+   /* Keep protein atoms with the names used in the templates           */
+   for(p=pdb; search.ok && (p!=NULL); NEXT(p))
+   {
+      if(strncmp(p->record_type, "ATOM", 4))
+         continue;
+      if((prev == NULL) || (prev->resnum != p->resnum) ||
+         !PDBINSERTMATCH(prev, p) || !PDBCHAINMATCH(prev, p))
+         nres++;
+      prev = p;
+
+      strcpy(atnam, p->atnam);
+      KILLTRAILSPACES(atnam);
+      for(k=0; k<lib->natnams; k++)
+      {
+         if(!strcmp(atnam, lib->atnams[k]))
+            break;
+      }
+      if(k == lib->natnams)
+         continue;
+
+      i = search.natoms++;
+      search.atoms[i]     = p;
+      search.x[i]         = p->x;
+      search.y[i]         = p->y;
+      search.z[i]         = p->z;
+      search.nameIndex[i] = k;
+      search.residue[i]   = nres;
+   }
+
+   if(search.ok && (search.natoms >= 3))
+   {
+      if((grid = blBuildAtomGridXYZ(search.x, search.y, search.z,
+                                    search.natoms,
+                                    lib->maxDist + distTol))==NULL)
+         search.ok = FALSE;
+   }
+
+   for(i=0; search.ok && (grid != NULL) && (i<search.natoms); i++)
+   {
+      if((search.nneighbs =
+          blFindAtomGridNeighbours(grid, search.x[i], search.y[i],
+                                   search.z[i], lib->maxDist + distTol,
+                                   &(search.neighbs), &maxNeighbs)) < 0)
+      {
+         search.ok = FALSE;
+         break;
+      }
+      search.chosen[0] = i;
+
+      for(j=0; j<search.nneighbs; j++)
+      {
+         int b = search.neighbs[j];
+
+         if(search.residue[b] == search.residue[i])
+            continue;
+         dx = search.x[b] - search.x[i];
+         dy = search.y[b] - search.y[i];
+         dz = search.z[b] - search.z[i];
+         d  = (REAL)sqrt(dx*dx + dy*dy + dz*dz);
+
+         /* First template edge not shorter than d - distTol            */
+         lo = 0;
+         hi = lib->ntemplates;
+         while(lo < hi)
+         {
+            mid = (lo + hi) / 2;
+            if(lib->edges[mid].dist < d - distTol)
+               lo = mid + 1;
+            else
+               hi = mid;
+         }
+
+         for(e=lo; (e<lib->ntemplates) &&
+                   (lib->edges[e].dist <= d + distTol); e++)
+         {
+            int           tnum = lib->edges[e].template;
+            METALTEMPLATE *t   = &(lib->templates[tnum]);
+
+            if((search.nameIndex[i] != t->nameIndex[0]) ||
+               (search.matchResnam &&
+                strncmp(search.atoms[i]->resnam, t->resnam[0],
+                        strlen(t->resnam[0]))) ||
+               !TemplateMatchesAtom(&search, t, 1, b))
+               continue;
+
+            search.chosen[1] = b;
+            ExtendMatch(&search, tnum, 2);
+         }
+      }
+   }
+
+   if(search.ok)
+   {
+      CombineSiteHits(&search);
+      RemoveDuplicateHits(&search);
+   }
+
+   if(grid != NULL)
+      blFreeAtomGrid(grid);
+   FREE(search.keys);
+   FREE(search.neighbs);
+   FREE(search.atoms);
+   FREE(search.x);
+   FREE(search.y);
+   FREE(search.z);
+   FREE(search.nameIndex);
+   FREE(search.residue);
+
+   if(!search.ok)
+   {
+      blFreeMetalSiteHits(search.hits);
+      *ok = FALSE;
+      return(NULL);
+   }
+
+   *nhits = search.nhits;
+   return(search.hits);
+}
+
+
+/************************************************************************/
+/*>METALSITEHIT *blFindMetalSites(METALSITELIB *lib, PDB *pdb,
+                                  REAL distTol, REAL rmsdTol,
+                                  BOOL matchResnam, int *nhits)
+   -----------------------------------------------------------
+*//**
+
+   \param[in]     *lib          Template library
+   \param[in]     *pdb          PDB linked list
+   \param[in]     distTol       Tolerance on each distance between
+                                template atoms
+                                (e.g. METALSITE_DEFDISTTOL)
+   \param[in]     rmsdTol       RMSD cutoff after fitting to the
+                                template (e.g. METALSITE_DEFRMSD)
+   \param[in]     matchResnam   Require the residue types in the
+                                template
+   \param[out]    *nhits        Number of hits (-1 on error)
+   \return                      Linked list of hits (NULL if none or on
+                                error)
+
+   Finds sets of residues in the ATOM records of a PDB linked list that
+   match any of the sites. Where a site has C-alpha and C-beta 
+   templates, both must match the same residues; the hit gives the
+   first of the two templates, its atoms, and the worse of the two
+   RMSDs. The same residues may match several sites. The atoms[] of 
+   each hit point into the linked list.
+
+-  17.10.26 Original   By: ACRM
+-  17.10.26 Hits require both templates of a site to match   By: ACRM
+*/
+METALSITEHIT *blFindMetalSites(METALSITELIB *lib, PDB *pdb,
+                               REAL distTol, REAL rmsdTol,
+                               BOOL matchResnam, int *nhits)
+{
+   METALSITEHIT *hits;
+   BOOL         ok;
+
+   hits = SearchPDB(lib, pdb, distTol, rmsdTol, matchResnam, nhits, &ok);
+   if(!ok)
+      *nhits = (-1);
+   return(hits);
+}
+
+
+/************************************************************************/
+/*>static void *ScanFiles(void *arg)
+   ---------------------------------
+*//**
+
+   \param[in,out] *arg      The SITESCAN
+   \return                  NULL
+
+   Takes files from the scan in turn until none are left, storing the
+   hits for file i in scan->hits[i]
+
+-  17.10.26 Original   By: ACRM
+*/
+static void *ScanFiles(void *arg)
+{
+   SITESCAN     *scan = (SITESCAN *)arg;
+   METALSITEHIT *hit;
+   FILE         *fp;
+   PDB          *pdb;
+   int          i, natoms, nhits, k;
+   BOOL         ok;
+
+   for(;;)
+   {
+      if((i = blThreadPoolIncrement(&(scan->next))) >= scan->nfiles)
+         break;
+
+      if((fp = fopen(scan->files[i], "r"))==NULL)
+         continue;
+      pdb = blReadPDBAtoms(fp, &natoms);
+      fclose(fp);
+      if(pdb == NULL)
+         continue;
+
+      scan->hits[i] = SearchPDB(scan->lib, pdb, scan->distTol,
+                                scan->rmsdTol, scan->matchResnam,
+                                &nhits, &ok);
+      FREELIST(pdb, PDB);
+
+      for(hit=scan->hits[i]; ok && (hit!=NULL); NEXT(hit))
+      {
+         for(k=0; k<hit->natoms; k++)
+            hit->atoms[k] = NULL;
+         if((hit->filename = (char *)malloc(strlen(scan->files[i])+1))
+            ==NULL)
+            ok = FALSE;
+         else
+            strcpy(hit->filename, scan->files[i]);
+      }
+      if(!ok)
+      {
+         blFreeMetalSiteHits(scan->hits[i]);
+         scan->hits[i] = NULL;
+         continue;
+      }
+
+      blThreadPoolIncrement(&(scan->nscanned));
+   }
+
+   return(NULL);
+}
+
+
+/************************************************************************/
+/*>METALSITEHIT *blFindMetalSitesFiles(METALSITELIB *lib, char **files,
+                                       int nfiles, REAL distTol,
+                                       REAL rmsdTol, BOOL matchResnam,
+                                       int nthreads, int *nscanned)
+   --------------------------------------------------------------------
+*//**
+
+   \param[in]     *lib          Template library
+   \param[in]     **files       PDB file names
+   \param[in]     nfiles        Number of files
+   \param[in]     distTol       Tolerance on each distance
+   \param[in]     rmsdTol       RMSD cutoff after fitting
+   \param[in]     matchResnam   Require the template residue types
+   \param[in]     nthreads      Number of threads to use
+   \param[out]    *nscanned     Number of files read and searched
+   \return                      Linked list of hits
+
+   Searches each of a list of PDB files (as blFindMetalSites()). The
+   hits are returned in the order of the files. The filename of each
+   hit is a malloc'd copy which is freed by blFreeMetalSiteHits(), and
+   its atoms[] are NULL.
+
+   Files that cannot be read are skipped. If the library was compiled
+   with PTHREAD_SUPPORT, up to nthreads files are searched at once;
+   note that the global flags set while reading PDB files (such as
+   gPDBPartialOcc) are then not meaningful.
+
+-  17.10.26 Original   By: ACRM
+*/
+METALSITEHIT *blFindMetalSitesFiles(METALSITELIB *lib, char **files,
+                                    int nfiles, REAL distTol,
+                                    REAL rmsdTol, BOOL matchResnam,
+                                    int nthreads, int *nscanned)
+{
+   SITESCAN     scan;
+   METALSITEHIT *hits    = NULL,
+                *lastHit = NULL;
+   int          i;
+
+   *nscanned = 0;
+   if((lib == NULL) || (nfiles <= 0))
+      return(NULL);
+
+   if((scan.hits = (METALSITEHIT **)calloc(nfiles,
+                                           sizeof(METALSITEHIT *)))==NULL)
+      return(NULL);
+   scan.lib         = lib;
+   scan.files       = files;
+   scan.nfiles      = nfiles;
+   scan.distTol     = distTol;
+   scan.rmsdTol     = rmsdTol;
+   scan.matchResnam = matchResnam;
+   scan.next        = 0;
+   scan.nscanned    = 0;
+
+   blRunThreadPool(ScanFiles, (void *)&scan, 0, MIN(nthreads, nfiles));
+
+   /* Join the hits in file order                                       */
+   for(i=0; i<nfiles; i++)
+   {
+      if(scan.hits[i] == NULL)
+         continue;
+      if(lastHit == NULL)
+         hits = scan.hits[i];
+      else
+         lastHit->next = scan.hits[i];
+      for(lastHit=scan.hits[i]; lastHit->next!=NULL; NEXT(lastHit));
+   }
+
+   free(scan.hits);
+   *nscanned = scan.nscanned;
+   return(hits);
+}
+
+
+/************************************************************************/
+/*>METALSITEHIT *blFindMetalSitesDir(METALSITELIB *lib, char *dirname,
+                                     REAL distTol, REAL rmsdTol,
+                                     BOOL matchResnam, int nthreads,
+                                     int *nscanned)
+   -------------------------------------------------------------------
+*//**
+
+   \param[in]     *lib          Template library
+   \param[in]     *dirname      Directory of PDB files
+   \param[in]     distTol       Tolerance on each distance
+   \param[in]     rmsdTol       RMSD cutoff after fitting
+   \param[in]     matchResnam   Require the template residue types
+   \param[in]     nthreads      Number of threads to use
+   \param[out]    *nscanned     Number of files read and searched
+   \return                      Linked list of hits
+
+   Searches every file in a directory (except those whose names start
+   with a dot) as blFindMetalSitesFiles(). Not available under
+   MS_WINDOWS, where NULL is returned.
+
+-  17.10.26 Original   By: ACRM
+*/
+METALSITEHIT *blFindMetalSitesDir(METALSITELIB *lib, char *dirname,
+                                  REAL distTol, REAL rmsdTol,
+                                  BOOL matchResnam, int nthreads,
+                                  int *nscanned)
+{
+   METALSITEHIT  *hits = NULL;
+   char          **files  = NULL;
+   int           nfiles   = 0,
+                 maxfiles = 0,
+                 i;
+#ifndef MS_WINDOWS
+   DIR           *dir;
+   struct dirent *entry;
+   BOOL          ok       = TRUE;
+
+   *nscanned = 0;
+   if((dir = opendir(dirname))==NULL)
+      return(NULL);
+
+   while(ok && ((entry = readdir(dir))!=NULL))
+   {
+      if(entry->d_name[0] == '.')
+         continue;
+      if(nfiles >= maxfiles)
+      {
+         char **newFiles;
+         if((newFiles = (char **)realloc(files, (maxfiles + ALLOCSTEP) *
+                                         sizeof(char *)))==NULL)
+         {
+            ok = FALSE;
+            break;
+         }
+         files     = newFiles;
+         maxfiles += ALLOCSTEP;
+      }
+      if((files[nfiles] = (char *)malloc(strlen(dirname) +
+                                         strlen(entry->d_name) + 2))
+         ==NULL)
+      {
+         ok = FALSE;
+         break;
+      }
+      sprintf(files[nfiles++], "%s/%s", dirname, entry->d_name);
+   }
+   closedir(dir);
+
+   if(ok)
+   {
+      hits = blFindMetalSitesFiles(lib, files, nfiles, distTol, rmsdTol,
+                                   matchResnam, nthreads, nscanned);
+   }
+
+   for(i=0; i<nfiles; i++)
+      free(files[i]);
+   FREE(files);
+#else
+   *nscanned = 0;
+#endif
+
+   return(hits);
+}
+
+
+/************************************************************************/
+/*>void blFreeMetalSiteHits(METALSITEHIT *hits)
+   --------------------------------------------
+*//**
+
+   \param[in]     *hits     Linked list of hits
+
+   Frees a list of hits and their filenames
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeMetalSiteHits(METALSITEHIT *hits)
+{
+   METALSITEHIT *hit;
+
+   for(hit=hits; hit!=NULL; NEXT(hit))
+   {
+      FREE(hit->filename);
+   }
+   FREELIST(hits, METALSITEHIT);
+}
+
+
+/************************************************************************/
+/*>void blPrintMetalSiteHits(FILE *out, METALSITELIB *lib,
+                             METALSITEHIT *hits)
+   -------------------------------------------------------
+*//**
+
+   \param[in]     *out      Output file
+   \param[in]     *lib      Template library
+   \param[in]     *hits     Linked list of hits
+
+   Prints one line for each hit giving the filename (if any), metal,
+   RMSD, residues and the template description
+
+-  17.10.26 Original   By: ACRM
+*/
+void blPrintMetalSiteHits(FILE *out, METALSITELIB *lib,
+                          METALSITEHIT *hits)
+{
+   METALSITEHIT *hit;
+   int          i;
+
+   for(hit=hits; hit!=NULL; NEXT(hit))
+   {
+      if(hit->filename != NULL)
+         fprintf(out, "%s ", hit->filename);
+      fprintf(out, "%-2s %6.3f ", lib->templates[hit->template].metal,
+              hit->rmsd);
+      for(i=0; i<hit->natoms; i++)
+      {
+         fprintf(out, "%s%s%d%s ", hit->resnam[i], hit->chain[i],
+                 hit->resnum[i], hit->insert[i]);
+      }
+      fprintf(out, "%s\n", lib->templates[hit->template].name);
+   }
+}
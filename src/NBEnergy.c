@@ -0,0 +1,1489 @@
+/************************************************************************/
+/**
+
+   \file       NBEnergy.c
+
+   \version    V1.1
+   \date       17.10.26
+   \brief      Non-bonded van der Waals and Coulomb energies
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Calculates non-bonded energies with the united atom parameters
+   supplied in eparams.dat. NONBOND records give the polarizability,
+   effective number of electrons and van der Waals radius of each atom
+   type; RESIDUE/ATOM records give the type, charge and non-bonded
+   exclusions of each atom in the standard residues. Charges may be
+   replaced by those in kolluni.dat with blReadNBCharges().
+
+   The van der Waals energy of a pair of atoms is B/r^12 - A/r^6 where
+   A is given by the Slater-Kirkwood formula
+
+      A = 362.3 ai aj / (sqrt(ai/Ni) + sqrt(aj/Nj))
+
+   (a is polarizability in A^3 and N the effective number of electrons)
+   and B = A (Ri + Rj)^6 / 2 so that the minimum is at the sum of the
+   radii. The Coulomb energy is 332.0636 qi qj / (e r), or
+   332.0636 qi qj / (e r^2) with a distance-dependent dielectric.
+
+   Pairs further apart than the cutoff are ignored (there is no
+   switching function) as are pairs listed as exclusions in the
+   topology. Atoms not in the topology (e.g. non-polar hydrogens or
+   HETATMs) contribute only through any charge given in the charge
+   file.
+
+   When the parameters are assigned, p->atomInfo is pointed at the
+   atom type in the NBPARAMS structure and p->partial_charge is set.
+   The atomInfo pointers are not owned by the atoms and become invalid
+   when the parameters are freed.
+
+   Neighbours are found with an ATOMGRID so a full evaluation is linear
+   in the number of atoms. After some atoms have been moved,
+   blUpdateNBEnergy() subtracts their old interactions and adds the new
+   ones, so the cost depends on the number of atoms moved rather than
+   the size of the structure. Each atom is given half of each of its
+   pair energies, and residue energies are the sums over their atoms.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   NBPARAMS *params;
+   NBENERGY *nbe;
+
+   params = blReadNBParams(NULL);
+   blReadNBCharges(params, NULL);
+   nbe = blCreateNBEnergy(pdb, params, NBE_DEFCUTOFF, (REAL)4.0, TRUE);
+   printf("%f %f\n", nbe->evdw, nbe->ecoul);
+
+   ... move the atoms of a sidechain ...
+   blUpdateNBEnergyRange(nbe, sidechainStart, nextResidue);
+
+   blFreeNBEnergy(nbe);
+   blFreeNBParams(params);
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 blUpdateNBEnergy() moves atoms between grid cells
+                  rather than rebuilding the grid   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP Energy calculations
+
+   #FUNCTION  blReadNBParams()
+   Reads non-bonded parameters and residue topologies
+
+   #FUNCTION  blReadNBCharges()
+   Reads partial charges to replace those in the topologies
+
+   #FUNCTION  blFreeNBParams()
+   Frees non-bonded parameters
+
+   #FUNCTION  blCreateNBEnergy()
+   Assigns parameters to a PDB linked list and calculates its
+   non-bonded energy
+
+   #FUNCTION  blFreeNBEnergy()
+   Frees a non-bonded energy structure
+
+   #FUNCTION  blCalcNBEnergy()
+   Recalculates the non-bonded energy from scratch
+
+   #FUNCTION  blUpdateNBEnergy()
+   Updates the non-bonded energy after some atoms have moved
+
+   #FUNCTION  blUpdateNBEnergyRange()
+   Updates the non-bonded energy after a range of atoms has moved
+
+   #FUNCTION  blGetNBEnergyAtom()
+   Returns the non-bonded energy of an atom
+
+   #FUNCTION  blGetNBEnergyResidue()
+   Returns the non-bonded energy of a residue
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "general.h"
+#include "pdb.h"
+#include "hash.h"
+#include "atomgrid.h"
+#include "pdbattrib.h"
+#include "nbenergy.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define MAXBUFF         240
+#define MAXKEY          24
+#define HASHSIZE        1024
+#define ALLOCSTEP       64
+#define DATAENV         "DATADIR"
+#define SLATERKIRKWOOD  ((REAL)362.3)   /* kcal A^6 / mol               */
+#define COULOMB         ((REAL)332.0636) /* kcal A / (mol e^2)          */
+#define MINDISTSQ       ((REAL)0.01)    /* Limits energies of clashes   */
+
+#define ACTIVE(nbe, i)  (((nbe)->type[(i)] >= 0) ||                      \
+                         ((nbe)->charge[(i)] != (REAL)0.0))
+
+/* An exclusion found from the topology                                 */
+typedef struct
+{
+   int i, j;
+}  EXCLPAIR;
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static void MakeKey(char *key, char *resnam, char *atnam);
+static BOOL ParseTopAtom(NBPARAMS *params, char *resnam, char *buffer,
+                         int *maxtop);
+static int  FindType(NBPARAMS *params, char *name);
+static int  FindTopAtom(NBPARAMS *params, PDB *p, BOOL *isPatch);
+static int  FindNamedAtom(NBENERGY *nbe, int res, char *atnam);
+static BOOL AssignParams(NBENERGY *nbe, NBPARAMS *params, int *topIndex,
+                         BOOL *isPatch);
+static BOOL BuildExclusions(NBENERGY *nbe, NBPARAMS *params,
+                            int *topIndex, BOOL *isPatch);
+static void SetPairCoefficients(NBENERGY *nbe, NBPARAMS *params);
+static BOOL Excluded(NBENERGY *nbe, int i, int j);
+static void AddPair(NBENERGY *nbe, int i, int j, REAL sign);
+static BOOL BuildGrid(NBENERGY *nbe);
+static BOOL AddMovedPairs(NBENERGY *nbe, int *list, int nlist,
+                          REAL sign);
+static BOOL UpdateAtoms(NBENERGY *nbe, int *list, int nlist);
+
+
+/************************************************************************/
+/*>static void MakeKey(char *key, char *resnam, char *atnam)
+   ---------------------------------------------------------
+*//**
+
+   \param[out]    *key     Hash key (MAXKEY characters)
+   \param[in]     *resnam  Residue name
+   \param[in]     *atnam   Atom name
+
+   Builds a "RES:ATOM" hash key with spaces removed
+
+-  17.10.26 Original   By: ACRM
+*/
+static void MakeKey(char *key, char *resnam, char *atnam)
+{
+   int  n = 0;
+   char *ch;
+
+   for(ch=resnam; (*ch != '\0') && (n < (MAXKEY/2 - 1)); ch++)
+   {
+      if(*ch != ' ')
+         key[n++] = *ch;
+   }
+   key[n++] = ':';
+   for(ch=atnam; (*ch != '\0') && (n < (MAXKEY - 1)); ch++)
+   {
+      if(*ch != ' ')
+         key[n++] = *ch;
+   }
+   key[n] = '\0';
+}
+
+
+/************************************************************************/
+/*>static int FindType(NBPARAMS *params, char *name)
+   -------------------------------------------------
+*//**
+
+   \param[in]     *params  Parameters
+   \param[in]     *name    Atom type name
+   \return                 Index of the type or -1 if not found
+
+-  17.10.26 Original   By: ACRM
+*/
+static int FindType(NBPARAMS *params, char *name)
+{
+   int i;
+
+   for(i=0; i<params->ntypes; i++)
+   {
+      if(!strcmp(params->types[i].atomtype, name))
+         return(i);
+   }
+   return(-1);
+}
+
+
+/************************************************************************/
+/*>static BOOL ParseTopAtom(NBPARAMS *params, char *resnam, char *buffer,
+                            int *maxtop)
+   ----------------------------------------------------------------------
+*//**
+
+   \param[in,out] *params  Parameters
+   \param[in]     *resnam  Current residue name
+   \param[in]     *buffer  ATOM line from the parameter file
+   \param[in,out] *maxtop  Allocated size of params->top
+   \return                 Success
+
+   Parses a topology ATOM line of the form
+      ATOM name type charge "excl1 excl2 ..."
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL ParseTopAtom(NBPARAMS *params, char *resnam, char *buffer,
+                         int *maxtop)
+{
+   NBTOPATOM *top;
+   char      atnam[MAXBUFF],
+             type[MAXBUFF],
+             word[MAXBUFF],
+             *ch;
+   double    charge;
+   int       n;
+
+   if(sscanf(buffer, "%*s %s %s %lf", atnam, type, &charge) != 3)
+      return(FALSE);
+   if((strlen(atnam) > 7) || (strlen(resnam) > 7))
+      return(FALSE);
+
+   if(params->ntop >= *maxtop)
+   {
+      NBTOPATOM *newTop;
+      if((newTop = (NBTOPATOM *)realloc(params->top,
+                                        (*maxtop + ALLOCSTEP) *
+                                        sizeof(NBTOPATOM)))==NULL)
+         return(FALSE);
+      params->top = newTop;
+      *maxtop    += ALLOCSTEP;
+   }
+
+   top = &(params->top[params->ntop]);
+   strcpy(top->resnam, resnam);
+   strcpy(top->atnam,  atnam);
+   top->charge = (REAL)charge;
+   top->nexcl  = 0;
+   if((top->type = FindType(params, type)) < 0)
+      return(FALSE);
+
+   /* Exclusions are the words between the quotes                      */
+   if((ch = strchr(buffer, '"')) != NULL)
+   {
+      char *end;
+      ch++;
+      if((end = strchr(ch, '"')) != NULL)
+         *end = '\0';
+      while((top->nexcl < NBE_MAXEXCL) &&
+            (sscanf(ch, "%s%n", word, &n) == 1))
+      {
+         if(strlen(word) < 8)
+            strcpy(top->excl[top->nexcl++], word);
+         ch += n;
+      }
+   }
+
+   params->ntop++;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>NBPARAMS *blReadNBParams(char *paramFile)
+   -----------------------------------------
+*//**
+
+   \param[in]     *paramFile  Parameter file. If NULL, NBE_PARAMFILE is
+                              used. Looked for in the current directory
+                              and then in $DATADIR
+   \return                    Malloc'd parameters or NULL on error
+
+   Reads the NONBOND atom types and the RESIDUE/ATOM topologies from a
+   parameter file in the format of eparams.dat. Other records are
+   ignored.
+
+-  17.10.26 Original   By: ACRM
+*/
+NBPARAMS *blReadNBParams(char *paramFile)
+{
+   FILE     *fp;
+   NBPARAMS *params;
+   char     buffer[MAXBUFF],
+            record[MAXBUFF],
+            name[MAXBUFF],
+            resnam[8],
+            key[MAXKEY];
+   int      maxtypes = 0,
+            maxtop   = 0,
+            i;
+   BOOL     noenv,
+            ok       = TRUE;
+
+   if(paramFile == NULL)
+      paramFile = NBE_PARAMFILE;
+   if((fp = blOpenFile(paramFile, DATAENV, "r", &noenv))==NULL)
+      return(NULL);
+
+   if((params = (NBPARAMS *)malloc(sizeof(NBPARAMS)))==NULL)
+   {
+      fclose(fp);
+      return(NULL);
+   }
+   params->types      = NULL;
+   params->top        = NULL;
+   params->charges    = NULL;
+   params->topHash    = NULL;
+   params->chargeHash = NULL;
+   params->ntypes     = 0;
+   params->ntop       = 0;
+   params->ncharges   = 0;
+   resnam[0]          = '\0';
+
+   while(ok && fgets(buffer, MAXBUFF, fp))
+   {
+      TERMINATE(buffer);
+      if(sscanf(buffer, "%s", record) != 1)
+         continue;
+
+      if(!strcmp(record, "NONBOND"))
+      {
+         double mass, pol, neff, vdwr;
+
+         if(params->ntypes >= maxtypes)
+         {
+            blATOMINFO *newTypes;
+            if((newTypes = (blATOMINFO *)
+                realloc(params->types, (maxtypes + ALLOCSTEP) *
+                        sizeof(blATOMINFO)))==NULL)
+            {
+               ok = FALSE;
+               break;
+            }
+            params->types = newTypes;
+            maxtypes     += ALLOCSTEP;
+         }
+         if((sscanf(buffer, "%*s %s %*d %lf %lf %lf %lf",
+                    name, &mass, &pol, &neff, &vdwr) != 5) ||
+            (strlen(name) > 7))
+         {
+            ok = FALSE;
+            break;
+         }
+         strcpy(params->types[params->ntypes].atomtype, name);
+         params->types[params->ntypes].mass = (REAL)mass;
+         params->types[params->ntypes].pol  = (REAL)pol;
+         params->types[params->ntypes].NEff = (REAL)neff;
+         params->types[params->ntypes].vdwr = (REAL)vdwr;
+         params->ntypes++;
+      }
+      else if(!strcmp(record, "RESIDUE"))
+      {
+         if((sscanf(buffer, "%*s %s", name) != 1) || (strlen(name) > 7))
+         {
+            ok = FALSE;
+            break;
+         }
+         strcpy(resnam, name);
+      }
+      else if(!strcmp(record, "ATOM") && (resnam[0] != '\0'))
+      {
+         ok = ParseTopAtom(params, resnam, buffer, &maxtop);
+      }
+   }
+   fclose(fp);
+
+   /* Index the topology                                               */
+   if(ok && ((params->topHash = blInitializeHash(HASHSIZE))==NULL))
+      ok = FALSE;
+   for(i=0; ok && (i<params->ntop); i++)
+   {
+      MakeKey(key, params->top[i].resnam, params->top[i].atnam);
+      if(!blHashKeyDefined(params->topHash, key))
+         ok = blSetHashValueInt(params->topHash, key, i);
+   }
+
+   if(!ok || (params->ntypes == 0))
+   {
+      blFreeNBParams(params);
+      return(NULL);
+   }
+
+   return(params);
+}
+
+
+/************************************************************************/
+/*>BOOL blReadNBCharges(NBPARAMS *params, char *chargeFile)
+   --------------------------------------------------------
+*//**
+
+   \param[in,out] *params      Parameters
+   \param[in]     *chargeFile  Charge file. If NULL, NBE_CHARGEFILE is
+                               used. Looked for in the current directory
+                               and then in $DATADIR
+   \return                     Success
+
+   Reads partial charges in the format of kolluni.dat: a residue name
+   on a line of its own, the number of atoms, then an atom name and
+   charge on each line. These are used in preference to the charges in
+   the topology by blCreateNBEnergy().
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blReadNBCharges(NBPARAMS *params, char *chargeFile)
+{
+   FILE   *fp;
+   char   buffer[MAXBUFF],
+          word1[MAXBUFF],
+          word2[MAXBUFF],
+          resnam[MAXBUFF],
+          key[MAXKEY];
+   double charge;
+   int    maxcharges = 0,
+          nwords;
+   BOOL   noenv,
+          ok         = TRUE;
+
+   if(params == NULL)
+      return(FALSE);
+   if(chargeFile == NULL)
+      chargeFile = NBE_CHARGEFILE;
+   if((fp = blOpenFile(chargeFile, DATAENV, "r", &noenv))==NULL)
+      return(FALSE);
+
+   if(params->chargeHash != NULL)
+      blFreeHash(params->chargeHash);
+   FREE(params->charges);
+   params->ncharges = 0;
+   if((params->chargeHash = blInitializeHash(HASHSIZE))==NULL)
+   {
+      fclose(fp);
+      return(FALSE);
+   }
+
+   resnam[0] = '\0';
+   while(ok && fgets(buffer, MAXBUFF, fp))
+   {
+      TERMINATE(buffer);
+      nwords = sscanf(buffer, "%s %s", word1, word2);
+
+      if((nwords == 1) && isalpha(word1[0]))
+      {
+         strncpy(resnam, word1, 7);
+         resnam[7] = '\0';
+      }
+      else if((nwords == 2) && (resnam[0] != '\0') &&
+              (sscanf(word2, "%lf", &charge) == 1))
+      {
+         if(params->ncharges >= maxcharges)
+         {
+            REAL *newCharges;
+            if((newCharges = (REAL *)
+                realloc(params->charges, (maxcharges + ALLOCSTEP) *
+                        sizeof(REAL)))==NULL)
+            {
+               ok = FALSE;
+               break;
+            }
+            params->charges = newCharges;
+            maxcharges     += ALLOCSTEP;
+         }
+         MakeKey(key, resnam, word1);
+         if(!blHashKeyDefined(params->chargeHash, key))
+         {
+            params->charges[params->ncharges] = (REAL)charge;
+            ok = blSetHashValueInt(params->chargeHash, key,
+                                   params->ncharges++);
+         }
+      }
+   }
+   fclose(fp);
+
+   return(ok);
+}
+
+
+/************************************************************************/
+/*>void blFreeNBParams(NBPARAMS *params)
+   -------------------------------------
+*//**
+
+   \param[in]     *params  Parameters
+
+   Frees parameters read by blReadNBParams(). Any atomInfo pointers set
+   by blCreateNBEnergy() become invalid.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeNBParams(NBPARAMS *params)
+{
+   if(params == NULL)
+      return;
+
+   FREE(params->types);
+   FREE(params->top);
+   FREE(params->charges);
+   if(params->topHash != NULL)
+      blFreeHash(params->topHash);
+   if(params->chargeHash != NULL)
+      blFreeHash(params->chargeHash);
+   free(params);
+}
+
+
+/************************************************************************/
+/*>static int FindTopAtom(NBPARAMS *params, PDB *p, BOOL *isPatch)
+   ---------------------------------------------------------------
+*//**
+
+   \param[in]     *params   Parameters
+   \param[in]     *p        Atom
+   \param[out]    *isPatch  Found in the NTER or CTER terminal patches
+   \return                  Index in params->top or -1 if not found
+
+   Looks up an atom in the topology for its residue, then in the
+   terminal patches. OXT is treated as the patch atom OT2.
+
+-  17.10.26 Original   By: ACRM
+*/
+static int FindTopAtom(NBPARAMS *params, PDB *p, BOOL *isPatch)
+{
+   char key[MAXKEY];
+
+   *isPatch = FALSE;
+
+   MakeKey(key, p->resnam, p->atnam);
+   if(blHashKeyDefined(params->topHash, key))
+      return(blGetHashValueInt(params->topHash, key));
+
+   *isPatch = TRUE;
+   MakeKey(key, "CTER",
+           (strncmp(p->atnam, "OXT ", 4) ? p->atnam : "OT2"));
+   if(blHashKeyDefined(params->topHash, key))
+      return(blGetHashValueInt(params->topHash, key));
+
+   MakeKey(key, "NTER", p->atnam);
+   if(blHashKeyDefined(params->topHash, key))
+      return(blGetHashValueInt(params->topHash, key));
+
+   *isPatch = FALSE;
+   return(-1);
+}
+
+
+/************************************************************************/
+/*>static int FindNamedAtom(NBENERGY *nbe, int res, char *atnam)
+   -------------------------------------------------------------
+*//**
+
+   \param[in]     *nbe     Energy structure
+   \param[in]     res      Residue
+   \param[in]     *atnam   Atom name (without spaces)
+   \return                 Ordinal of the atom or -1 if not found
+
+   Finds an atom by name in a residue. The terminal patch names OT1 and
+   OT2 also match O and OXT.
+
+-  17.10.26 Original   By: ACRM
+*/
+static int FindNamedAtom(NBENERGY *nbe, int res, char *atnam)
+{
+   char key[MAXKEY],
+        wanted[MAXKEY],
+        alias[MAXKEY];
+   int  i;
+
+   if((res < 0) || (res >= nbe->nres))
+      return(-1);
+
+   MakeKey(wanted, "", atnam);
+   alias[0] = '\0';
+   if(!strcmp(wanted, ":OT1"))
+      strcpy(alias, ":O");
+   else if(!strcmp(wanted, ":OT2"))
+      strcpy(alias, ":OXT");
+
+   for(i=nbe->resFirst[res]; i<nbe->resFirst[res+1]; i++)
+   {
+      MakeKey(key, "", nbe->attribs->atoms[i]->atnam);
+      if(!strcmp(key, wanted) || !strcmp(key, alias))
+         return(i);
+   }
+   return(-1);
+}
+
+
+/************************************************************************/
+/*>static BOOL AssignParams(NBENERGY *nbe, NBPARAMS *params,
+                            int *topIndex, BOOL *isPatch)
+   ---------------------------------------------------------
+*//**
+
+   \param[in,out] *nbe       Energy structure with atoms and residues
+   \param[in]     *params    Parameters
+   \param[out]    *topIndex  Topology atom for each atom (or -1)
+   \param[out]    *isPatch   Topology atom is a terminal patch
+   \return                   Success
+
+   Sets the type and charge of each atom, and its atomInfo and
+   partial_charge fields. A charge from the charge file is used in
+   preference to the topology charge. The charge file names the
+   backbone amide hydrogen HN and neutral histidine HID; these are
+   tried if H and HIS are not found.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL AssignParams(NBENERGY *nbe, NBPARAMS *params, int *topIndex,
+                         BOOL *isPatch)
+{
+   PDB  *p;
+   char key[MAXKEY];
+   int  i, t;
+
+   for(i=0; i<nbe->natoms; i++)
+   {
+      p = nbe->attribs->atoms[i];
+      nbe->type[i]   = -1;
+      nbe->charge[i] = (REAL)0.0;
+      p->atomInfo    = NULL;
+
+      if((t = topIndex[i] = FindTopAtom(params, p, &(isPatch[i]))) >= 0)
+      {
+         nbe->type[i]   = params->top[t].type;
+         nbe->charge[i] = params->top[t].charge;
+         p->atomInfo    = &(params->types[nbe->type[i]]);
+      }
+
+      if(params->chargeHash != NULL)
+      {
+         char *resnam = strncmp(p->resnam, "HIS", 3) ? p->resnam : "HID",
+              *atnam  = strncmp(p->atnam, "H   ", 4) ? p->atnam  : "HN";
+
+         MakeKey(key, p->resnam, p->atnam);
+         if(!blHashKeyDefined(params->chargeHash, key))
+            MakeKey(key, resnam, atnam);
+         if(blHashKeyDefined(params->chargeHash, key))
+         {
+            nbe->charge[i] =
+               params->charges[blGetHashValueInt(params->chargeHash,
+                                                 key)];
+         }
+      }
+
+      p->partial_charge = nbe->charge[i];
+   }
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static BOOL BuildExclusions(NBENERGY *nbe, NBPARAMS *params,
+                               int *topIndex, BOOL *isPatch)
+   ------------------------------------------------------------
+*//**
+
+   \param[in,out] *nbe       Energy structure
+   \param[in]     *params    Parameters
+   \param[in]     *topIndex  Topology atom for each atom (or -1)
+   \param[in]     *isPatch   Topology atom is a terminal patch
+   \return                   Success
+
+   Converts the exclusion names in the topology into a symmetric list of
+   excluded atom pairs in compressed sparse row form. A leading + or -
+   refers to the next or previous residue in the same chain, except in
+   the terminal patches where it refers to the residue itself.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL BuildExclusions(NBENERGY *nbe, NBPARAMS *params,
+                            int *topIndex, BOOL *isPatch)
+{
+   EXCLPAIR *pairs    = NULL;
+   int      npairs    = 0,
+            maxpairs  = 0,
+            *fill,
+            i, j, k, res, t;
+
+   for(i=0; i<nbe->natoms; i++)
+   {
+      if((t = topIndex[i]) < 0)
+         continue;
+
+      for(k=0; k<params->top[t].nexcl; k++)
+      {
+         char *name = params->top[t].excl[k];
+
+         res = nbe->residue[i];
+         if((name[0] == '+') || (name[0] == '-'))
+         {
+            if(!isPatch[i])
+            {
+               res += (name[0] == '+') ? 1 : -1;
+               if((res < 0) || (res >= nbe->nres) ||
+                  !PDBCHAINMATCH(nbe->attribs->atoms[nbe->resFirst[res]],
+                                 nbe->attribs->atoms[i]))
+                  continue;
+            }
+            name++;
+         }
+
+         if(((j = FindNamedAtom(nbe, res, name)) < 0) || (j == i))
+            continue;
+
+         if(npairs >= maxpairs)
+         {
+            EXCLPAIR *newPairs;
+            if((newPairs = (EXCLPAIR *)
+                realloc(pairs, (maxpairs + nbe->natoms + ALLOCSTEP) *
+                        sizeof(EXCLPAIR)))==NULL)
+            {
+               FREE(pairs);
+               return(FALSE);
+            }
+            pairs     = newPairs;
+            maxpairs += nbe->natoms + ALLOCSTEP;
+         }
+         pairs[npairs].i   = i;
+         pairs[npairs++].j = j;
+      }
+   }
+
+   /* Each pair is stored in both directions                           */
+   if((nbe->exclStart = (int *)calloc(nbe->natoms+1, sizeof(int)))==NULL)
+   {
+      FREE(pairs);
+      return(FALSE);
+   }
+   for(k=0; k<npairs; k++)
+   {
+      nbe->exclStart[pairs[k].i+1]++;
+      nbe->exclStart[pairs[k].j+1]++;
+   }
+   for(i=0; i<nbe->natoms; i++)
+      nbe->exclStart[i+1] += nbe->exclStart[i];
+
+   nbe->excl = (int *)malloc((2*npairs+1) * sizeof(int));
+   fill      = (int *)malloc((nbe->natoms+1) * sizeof(int));
+   if((nbe->excl == NULL) || (fill == NULL))
+   {
+      FREE(fill);
+      FREE(pairs);
+      return(FALSE);
+   }
+   for(i=0; i<nbe->natoms; i++)
+      fill[i] = nbe->exclStart[i];
+   for(k=0; k<npairs; k++)
+   {
+      nbe->excl[fill[pairs[k].i]++] = pairs[k].j;
+      nbe->excl[fill[pairs[k].j]++] = pairs[k].i;
+   }
+
+   free(fill);
+   FREE(pairs);
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static void SetPairCoefficients(NBENERGY *nbe, NBPARAMS *params)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in,out] *nbe     Energy structure with A and B allocated
+   \param[in]     *params  Parameters
+
+   Calculates the Slater-Kirkwood van der Waals coefficients for each
+   pair of atom types
+
+-  17.10.26 Original   By: ACRM
+*/
+static void SetPairCoefficients(NBENERGY *nbe, NBPARAMS *params)
+{
+   int i, j;
+
+   for(i=0; i<nbe->ntypes; i++)
+   {
+      blATOMINFO *ti = &(params->types[i]);
+
+      for(j=0; j<nbe->ntypes; j++)
+      {
+         blATOMINFO *tj = &(params->types[j]);
+         REAL       denom = (REAL)0.0,
+                    r0,
+                    A     = (REAL)0.0;
+
+         if((ti->NEff > (REAL)0.0) && (tj->NEff > (REAL)0.0))
+            denom = sqrt(ti->pol / ti->NEff) + sqrt(tj->pol / tj->NEff);
+         if(denom > (REAL)0.0)
+            A = SLATERKIRKWOOD * ti->pol * tj->pol / denom;
+
+         r0 = ti->vdwr + tj->vdwr;
+         nbe->A[i*nbe->ntypes + j] = A;
+         nbe->B[i*nbe->ntypes + j] = A * r0*r0*r0*r0*r0*r0 / (REAL)2.0;
+      }
+   }
+}
+
+
+/************************************************************************/
+/*>static BOOL Excluded(NBENERGY *nbe, int i, int j)
+   -------------------------------------------------
+*//**
+
+   \param[in]     *nbe     Energy structure
+   \param[in]     i        First atom
+   \param[in]     j        Second atom
+   \return                 Is the pair excluded?
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL Excluded(NBENERGY *nbe, int i, int j)
+{
+   int k;
+
+   for(k=nbe->exclStart[i]; k<nbe->exclStart[i+1]; k++)
+   {
+      if(nbe->excl[k] == j)
+         return(TRUE);
+   }
+   return(FALSE);
+}
+
+
+/************************************************************************/
+/*>static void AddPair(NBENERGY *nbe, int i, int j, REAL sign)
+   -----------------------------------------------------------
+*//**
+
+   \param[in,out] *nbe     Energy structure
+   \param[in]     i        First atom
+   \param[in]     j        Second atom
+   \param[in]     sign     1 to add the pair energy, -1 to remove it
+
+   Calculates the energy of a pair of atoms at the coordinates in nbe
+   and adds it (times sign) to the totals and half of it to each atom
+   and its residue. Excluded pairs and pairs beyond the cutoff are
+   ignored.
+
+-  17.10.26 Original   By: ACRM
+*/
+static void AddPair(NBENERGY *nbe, int i, int j, REAL sign)
+{
+   REAL dx    = nbe->x[i] - nbe->x[j],
+        dy    = nbe->y[i] - nbe->y[j],
+        dz    = nbe->z[i] - nbe->z[j],
+        r2    = dx*dx + dy*dy + dz*dz,
+        evdw  = (REAL)0.0,
+        ecoul = (REAL)0.0,
+        qq;
+
+   if((r2 > nbe->cutoff * nbe->cutoff) || Excluded(nbe, i, j))
+      return;
+   if(r2 < MINDISTSQ)
+      r2 = MINDISTSQ;
+
+   if((nbe->type[i] >= 0) && (nbe->type[j] >= 0))
+   {
+      int  t   = nbe->type[i] * nbe->ntypes + nbe->type[j];
+      REAL ir6 = (REAL)1.0 / (r2*r2*r2);
+      evdw = (nbe->B[t] * ir6 - nbe->A[t]) * ir6;
+   }
+
+   if((qq = nbe->charge[i] * nbe->charge[j]) != (REAL)0.0)
+   {
+      ecoul = COULOMB * qq / nbe->dielectric;
+      ecoul /= (nbe->distDielectric ? r2 : sqrt(r2));
+   }
+
+   evdw  *= sign;
+   ecoul *= sign;
+   nbe->evdw  += evdw;
+   nbe->ecoul += ecoul;
+   evdw  /= (REAL)2.0;
+   ecoul /= (REAL)2.0;
+   PDBATTRIB_REALVAL(nbe->attribs, nbe->vdwCol,  i) += evdw;
+   PDBATTRIB_REALVAL(nbe->attribs, nbe->vdwCol,  j) += evdw;
+   PDBATTRIB_REALVAL(nbe->attribs, nbe->coulCol, i) += ecoul;
+   PDBATTRIB_REALVAL(nbe->attribs, nbe->coulCol, j) += ecoul;
+   nbe->resVdw[nbe->residue[i]]  += evdw;
+   nbe->resVdw[nbe->residue[j]]  += evdw;
+   nbe->resCoul[nbe->residue[i]] += ecoul;
+   nbe->resCoul[nbe->residue[j]] += ecoul;
+}
+
+
+/************************************************************************/
+/*>static BOOL BuildGrid(NBENERGY *nbe)
+   ------------------------------------
+*//**
+
+   \param[in,out] *nbe     Energy structure
+   \return                 Success
+
+   (Re)builds the grid from the coordinates stored in nbe
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL BuildGrid(NBENERGY *nbe)
+{
+   if(nbe->grid != NULL)
+      blFreeAtomGrid(nbe->grid);
+   nbe->grid = blBuildAtomGridXYZ(nbe->x, nbe->y, nbe->z, nbe->natoms,
+                                  nbe->cutoff);
+   return((BOOL)(nbe->grid != NULL));
+}
+
+
+/************************************************************************/
+/*>NBENERGY *blCreateNBEnergy(PDB *pdb, NBPARAMS *params, REAL cutoff,
+                              REAL dielectric, BOOL distDielectric)
+   -------------------------------------------------------------------
+*//**
+
+   \param[in,out] *pdb            PDB linked list
+   \param[in]     *params         Parameters from blReadNBParams()
+   \param[in]     cutoff          Non-bonded cutoff
+   \param[in]     dielectric      Dielectric constant
+   \param[in]     distDielectric  Use a distance-dependent dielectric
+                                  (dielectric * r)
+   \return                        Malloc'd energy structure or NULL on
+                                  error
+
+   Assigns atom types and charges to the atoms of a PDB linked list
+   (setting p->atomInfo and p->partial_charge), builds the list of
+   excluded pairs and calculates the non-bonded energy.
+
+   The totals are in nbe->evdw and nbe->ecoul. The energies of each
+   atom are in the "nb_vdw" and "nb_coulomb" columns of nbe->attribs
+   (which may be written to PDBML with blAddPDBAttribTag()).
+
+   The structure refers to the atoms of the linked list, which must not
+   be added to, deleted or reordered while it is in use.
+
+-  17.10.26 Original   By: ACRM
+*/
+NBENERGY *blCreateNBEnergy(PDB *pdb, NBPARAMS *params, REAL cutoff,
+                           REAL dielectric, BOOL distDielectric)
+{
+   NBENERGY *nbe;
+   PDB      *p, *prev;
+   int      *topIndex = NULL,
+            natoms,
+            i;
+   BOOL     *isPatch  = NULL,
+            ok        = TRUE;
+
+   if((params == NULL) || (cutoff <= (REAL)0.0) ||
+      (dielectric <= (REAL)0.0))
+      return(NULL);
+
+   if((nbe = (NBENERGY *)calloc(1, sizeof(NBENERGY)))==NULL)
+      return(NULL);
+   nbe->cutoff         = cutoff;
+   nbe->dielectric     = dielectric;
+   nbe->distDielectric = distDielectric;
+   nbe->ntypes         = params->ntypes;
+
+   if(((nbe->attribs = blCreatePDBAttribs(pdb))==NULL) ||
+      ((nbe->vdwCol  = blAddPDBAttrib(nbe->attribs, "nb_vdw",
+                                      PDBATTRIB_REAL, 0)) < 0) ||
+      ((nbe->coulCol = blAddPDBAttrib(nbe->attribs, "nb_coulomb",
+                                      PDBATTRIB_REAL, 0)) < 0))
+   {
+      blFreeNBEnergy(nbe);
+      return(NULL);
+   }
+   nbe->natoms = natoms = nbe->attribs->natoms;
+
+   nbe->A        = (REAL *)malloc((nbe->ntypes*nbe->ntypes + 1) *
+                                  sizeof(REAL));
+   nbe->B        = (REAL *)malloc((nbe->ntypes*nbe->ntypes + 1) *
+                                  sizeof(REAL));
+   nbe->charge   = (REAL *)malloc((natoms+1) * sizeof(REAL));
+   nbe->x        = (REAL *)malloc((natoms+1) * sizeof(REAL));
+   nbe->y        = (REAL *)malloc((natoms+1) * sizeof(REAL));
+   nbe->z        = (REAL *)malloc((natoms+1) * sizeof(REAL));
+   nbe->type     = (int  *)malloc((natoms+1) * sizeof(int));
+   nbe->residue  = (int  *)malloc((natoms+1) * sizeof(int));
+   nbe->resFirst = (int  *)malloc((natoms+2) * sizeof(int));
+   nbe->moved    = (char *)calloc(natoms+1, sizeof(char));
+   topIndex      = (int  *)malloc((natoms+1) * sizeof(int));
+   isPatch       = (BOOL *)malloc((natoms+1) * sizeof(BOOL));
+   if((nbe->A == NULL) || (nbe->B == NULL) || (nbe->charge == NULL) ||
+      (nbe->x == NULL) || (nbe->y == NULL) || (nbe->z == NULL) ||
+      (nbe->type == NULL) || (nbe->residue == NULL) ||
+      (nbe->resFirst == NULL) || (nbe->moved == NULL) ||
+      (topIndex == NULL) || (isPatch == NULL))
+      ok = FALSE;
+
+   if(ok)
+   {
+      /* Number the residues                                           */
+      prev = NULL;
+      for(i=0; i<natoms; i++)
+      {
+         p = nbe->attribs->atoms[i];
+         if((prev == NULL) || (prev->resnum != p->resnum) ||
+            !PDBINSERTMATCH(prev, p) || !PDBCHAINMATCH(prev, p) ||
+            strcmp(prev->resnam, p->resnam))
+         {
+            nbe->resFirst[nbe->nres++] = i;
+         }
+         nbe->residue[i] = nbe->nres - 1;
+         prev = p;
+      }
+      nbe->resFirst[nbe->nres] = natoms;
+
+      nbe->resVdw  = (REAL *)calloc(nbe->nres+1, sizeof(REAL));
+      nbe->resCoul = (REAL *)calloc(nbe->nres+1, sizeof(REAL));
+      if((nbe->resVdw == NULL) || (nbe->resCoul == NULL))
+         ok = FALSE;
+   }
+
+   if(ok)
+      ok = AssignParams(nbe, params, topIndex, isPatch);
+   if(ok)
+      ok = BuildExclusions(nbe, params, topIndex, isPatch);
+   if(ok)
+   {
+      SetPairCoefficients(nbe, params);
+      ok = blCalcNBEnergy(nbe);
+   }
+
+   FREE(topIndex);
+   FREE(isPatch);
+   if(!ok)
+   {
+      blFreeNBEnergy(nbe);
+      return(NULL);
+   }
+   return(nbe);
+}
+
+
+/************************************************************************/
+/*>void blFreeNBEnergy(NBENERGY *nbe)
+   ----------------------------------
+*//**
+
+   \param[in]     *nbe     Energy structure
+
+   Frees an energy structure. The PDB linked list is not affected.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeNBEnergy(NBENERGY *nbe)
+{
+   if(nbe == NULL)
+      return;
+
+   FREE(nbe->A);
+   FREE(nbe->B);
+   FREE(nbe->charge);
+   FREE(nbe->x);
+   FREE(nbe->y);
+   FREE(nbe->z);
+   FREE(nbe->resVdw);
+   FREE(nbe->resCoul);
+   FREE(nbe->type);
+   FREE(nbe->residue);
+   FREE(nbe->resFirst);
+   FREE(nbe->exclStart);
+   FREE(nbe->excl);
+   FREE(nbe->neighbs);
+   FREE(nbe->moved);
+   if(nbe->grid != NULL)
+      blFreeAtomGrid(nbe->grid);
+   blFreePDBAttribs(nbe->attribs);
+   free(nbe);
+}
+
+
+/************************************************************************/
+/*>BOOL blCalcNBEnergy(NBENERGY *nbe)
+   ----------------------------------
+*//**
+
+   \param[in,out] *nbe     Energy structure
+   \return                 Success
+
+   Recalculates all the energies from the current coordinates of the
+   atoms. This also clears any rounding error accumulated by repeated
+   calls to blUpdateNBEnergy().
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blCalcNBEnergy(NBENERGY *nbe)
+{
+   int i, j, k, n;
+
+   if(nbe == NULL)
+      return(FALSE);
+
+   for(i=0; i<nbe->natoms; i++)
+   {
+      PDB *p = nbe->attribs->atoms[i];
+      nbe->x[i] = p->x;
+      nbe->y[i] = p->y;
+      nbe->z[i] = p->z;
+      PDBATTRIB_REALVAL(nbe->attribs, nbe->vdwCol,  i) = (REAL)0.0;
+      PDBATTRIB_REALVAL(nbe->attribs, nbe->coulCol, i) = (REAL)0.0;
+   }
+   for(i=0; i<nbe->nres; i++)
+   {
+      nbe->resVdw[i]  = (REAL)0.0;
+      nbe->resCoul[i] = (REAL)0.0;
+   }
+   nbe->evdw  = (REAL)0.0;
+   nbe->ecoul = (REAL)0.0;
+
+   if(!BuildGrid(nbe))
+      return(FALSE);
+
+   for(i=0; i<nbe->natoms; i++)
+   {
+      if(!ACTIVE(nbe, i))
+         continue;
+
+      if((n = blFindAtomGridNeighbours(nbe->grid,
+                                       nbe->x[i], nbe->y[i], nbe->z[i],
+                                       nbe->cutoff, &(nbe->neighbs),
+                                       &(nbe->maxNeighbs))) < 0)
+         return(FALSE);
+
+      for(k=0; k<n; k++)
+      {
+         j = nbe->neighbs[k];
+         if((j > i) && ACTIVE(nbe, j))
+            AddPair(nbe, i, j, (REAL)1.0);
+      }
+   }
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static BOOL AddMovedPairs(NBENERGY *nbe, int *list, int nlist,
+                             REAL sign)
+   --------------------------------------------------------------
+*//**
+
+   \param[in,out] *nbe     Energy structure with the grid built from
+                           the coordinates in nbe
+   \param[in]     *list    Moved atoms (flagged in nbe->moved)
+   \param[in]     nlist    Number of moved atoms
+   \param[in]     sign     1 to add the energies, -1 to remove them
+   \return                 Success
+
+   Adds or removes the energies of all pairs involving a moved atom.
+   Pairs of two moved atoms are counted once.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL AddMovedPairs(NBENERGY *nbe, int *list, int nlist, REAL sign)
+{
+   int i, j, k, l, n;
+
+   for(l=0; l<nlist; l++)
+   {
+      i = list[l];
+      if(!ACTIVE(nbe, i))
+         continue;
+
+      if((n = blFindAtomGridNeighbours(nbe->grid,
+                                       nbe->x[i], nbe->y[i], nbe->z[i],
+                                       nbe->cutoff, &(nbe->neighbs),
+                                       &(nbe->maxNeighbs))) < 0)
+         return(FALSE);
+
+      for(k=0; k<n; k++)
+      {
+         j = nbe->neighbs[k];
+         if((j == i) || !ACTIVE(nbe, j) || (nbe->moved[j] && (j < i)))
+            continue;
+         AddPair(nbe, i, j, sign);
+      }
+   }
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static BOOL UpdateAtoms(NBENERGY *nbe, int *list, int nlist)
+   ------------------------------------------------------------
+*//**
+
+   \param[in,out] *nbe     Energy structure
+   \param[in]     *list    Ordinals of the moved atoms. Duplicates have
+                           been removed
+   \param[in]     nlist    Number of moved atoms
+   \return                 Success
+
+   Removes the interactions of the moved atoms at their old positions,
+   takes their new coordinates and adds the new interactions. The moved
+   atoms are moved between cells of the grid, which is only rebuilt if
+   an atom has left it.
+
+-  17.10.26 Original   By: ACRM
+-  17.10.26 Moves atoms within the grid rather than rebuilding it
+            By: ACRM
+*/
+static BOOL UpdateAtoms(NBENERGY *nbe, int *list, int nlist)
+{
+   int  i, l;
+   BOOL ok,
+        rebuild = FALSE;
+
+   ok = AddMovedPairs(nbe, list, nlist, (REAL)-1.0);
+
+   for(l=0; l<nlist; l++)
+   {
+      PDB *p = nbe->attribs->atoms[list[l]];
+      i = list[l];
+      nbe->x[i] = p->x;
+      nbe->y[i] = p->y;
+      nbe->z[i] = p->z;
+      if(!rebuild && 
+         !blMoveAtomGridAtom(nbe->grid, i, nbe->x[i], nbe->y[i], 
+                             nbe->z[i]))
+         rebuild = TRUE;
+   }
+
+   if(ok && rebuild)
+      ok = BuildGrid(nbe);
+   if(ok)
+      ok = AddMovedPairs(nbe, list, nlist, (REAL)1.0);
+
+   for(l=0; l<nlist; l++)
+      nbe->moved[list[l]] = 0;
+
+   /* Leave a consistent state if anything failed                      */
+   if(!ok)
+   {
+      blCalcNBEnergy(nbe);
+      return(FALSE);
+   }
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>BOOL blUpdateNBEnergy(NBENERGY *nbe, PDB **moved, int nmoved)
+   -------------------------------------------------------------
+*//**
+
+   \param[in,out] *nbe     Energy structure
+   \param[in]     **moved  Atoms which have moved
+   \param[in]     nmoved   Number of atoms which have moved
+   \return                 Success. Fails if an atom is not in the
+                           structure
+
+   Updates the energies after the listed atoms have moved. No other
+   atom may have moved since the last evaluation. The time taken
+   depends on the number of atoms moved and their neighbours. The
+   grid (and so a linear pass over all the atoms) is only rebuilt if
+   an atom moves outside the region it covers.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blUpdateNBEnergy(NBENERGY *nbe, PDB **moved, int nmoved)
+{
+   int  *list,
+        nlist = 0,
+        i, k;
+   BOOL ok;
+
+   if(nbe == NULL)
+      return(FALSE);
+   if(nmoved <= 0)
+      return(TRUE);
+
+   if((list = (int *)malloc(nmoved * sizeof(int)))==NULL)
+      return(FALSE);
+
+   for(k=0; k<nmoved; k++)
+   {
+      if((i = blGetPDBAttribOrdinal(nbe->attribs, moved[k])) < 0)
+      {
+         for(k=0; k<nlist; k++)
+            nbe->moved[list[k]] = 0;
+         free(list);
+         return(FALSE);
+      }
+      if(!nbe->moved[i])
+      {
+         nbe->moved[i]  = 1;
+         list[nlist++] = i;
+      }
+   }
+
+   ok = UpdateAtoms(nbe, list, nlist);
+   free(list);
+   return(ok);
+}
+
+
+/************************************************************************/
+/*>BOOL blUpdateNBEnergyRange(NBENERGY *nbe, PDB *start, PDB *stop)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in,out] *nbe     Energy structure
+   \param[in]     *start   First atom which has moved
+   \param[in]     *stop    Atom after the last one which has moved
+                           (or NULL for the end of the list)
+   \return                 Success. Fails if start is not in the
+                           structure
+
+   As blUpdateNBEnergy() for a contiguous range of atoms such as a
+   residue or sidechain.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blUpdateNBEnergyRange(NBENERGY *nbe, PDB *start, PDB *stop)
+{
+   int  *list,
+        nlist = 0,
+        i;
+   PDB  *p;
+   BOOL ok;
+
+   if((nbe == NULL) ||
+      ((i = blGetPDBAttribOrdinal(nbe->attribs, start)) < 0))
+      return(FALSE);
+
+   if((list = (int *)malloc((nbe->natoms - i + 1) * sizeof(int)))==NULL)
+      return(FALSE);
+
+   for(p=start; (p!=stop) && (i<nbe->natoms); NEXT(p), i++)
+   {
+      nbe->moved[i]  = 1;
+      list[nlist++] = i;
+   }
+
+   ok = UpdateAtoms(nbe, list, nlist);
+   free(list);
+   return(ok);
+}
+
+
+/************************************************************************/
+/*>REAL blGetNBEnergyAtom(NBENERGY *nbe, PDB *p, REAL *evdw,
+                          REAL *ecoul)
+   ---------------------------------------------------------
+*//**
+
+   \param[in]     *nbe     Energy structure
+   \param[in]     *p       Atom
+   \param[out]    *evdw    Van der Waals energy of the atom (may be NULL)
+   \param[out]    *ecoul   Coulomb energy of the atom (may be NULL)
+   \return                 Total non-bonded energy of the atom (zero if
+                           it is not in the structure)
+
+   The energy of an atom is half the sum of its pair energies
+
+-  17.10.26 Original   By: ACRM
+*/
+REAL blGetNBEnergyAtom(NBENERGY *nbe, PDB *p, REAL *evdw, REAL *ecoul)
+{
+   REAL v = (REAL)0.0,
+        c = (REAL)0.0;
+   int  i;
+
+   if((nbe != NULL) &&
+      ((i = blGetPDBAttribOrdinal(nbe->attribs, p)) >= 0))
+   {
+      v = PDBATTRIB_REALVAL(nbe->attribs, nbe->vdwCol,  i);
+      c = PDBATTRIB_REALVAL(nbe->attribs, nbe->coulCol, i);
+   }
+
+   if(evdw  != NULL) *evdw  = v;
+   if(ecoul != NULL) *ecoul = c;
+   return(v + c);
+}
+
+
+/************************************************************************/
+/*>REAL blGetNBEnergyResidue(NBENERGY *nbe, PDB *p, REAL *evdw,
+                             REAL *ecoul)
+   ------------------------------------------------------------
+*//**
+
+   \param[in]     *nbe     Energy structure
+   \param[in]     *p       Any atom in the residue
+   \param[out]    *evdw    Van der Waals energy of the residue (may be
+                           NULL)
+   \param[out]    *ecoul   Coulomb energy of the residue (may be NULL)
+   \return                 Total non-bonded energy of the residue (zero
+                           if it is not in the structure)
+
+   The energy of a residue is the sum of the energies of its atoms
+
+-  17.10.26 Original   By: ACRM
+*/
+REAL blGetNBEnergyResidue(NBENERGY *nbe, PDB *p, REAL *evdw,
+                          REAL *ecoul)
+{
+   REAL v = (REAL)0.0,
+        c = (REAL)0.0;
+   int  i;
+
+   if((nbe != NULL) &&
+      ((i = blGetPDBAttribOrdinal(nbe->attribs, p)) >= 0))
+   {
+      v = nbe->resVdw[nbe->residue[i]];
+      c = nbe->resCoul[nbe->residue[i]];
+   }
+
+   if(evdw  != NULL) *evdw  = v;
+   if(ecoul != NULL) *ecoul = c;
+   return(v + c);
+}
@@ -0,0 +1,1173 @@
+/************************************************************************/
+/**
+
+   \file       NeRF.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Build chains from internal coordinates by NeRF
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Converts a protein chain between internal coordinates (phi, psi,
+   omega and the sidechain chi angles) and Cartesian coordinates.
+
+   A NERFCHAIN holds, for every atom, the three atoms it is placed from
+   together with its bond length, bond angle and torsion. The torsion is
+   either fixed or is a residue torsion (a 'dof') plus an offset; for
+   example the carbonyl oxygen is placed at psi + 180. The atoms are
+   placed in order by the Natural Extension Reference Frame (NeRF)
+   method of Parsons et al. (2005) J. Comput. Chem. 26, 1063-1068, which
+   does the same job as blTorToCoor() but with a single rotation from a
+   local frame. The sines and cosines of the bond angles and fixed
+   torsions are calculated once when the chain is created and those of
+   the residue torsions only when they have changed, so building needs
+   two square roots, one division and no trigonometry per atom.
+
+   The backbone uses the ideal geometry of Engh & Huber (1991). Sidechain
+   geometry is taken from a reference coordinate file such as the 'coor'
+   file used by blRepSChain(). For each sidechain atom the preceding
+   bonded atom is found and the torsion about each rotatable bond not in
+   a ring becomes the next chi angle. Other atoms placed about the same
+   bond (e.g. OD2 of Asp) follow that chi with a fixed offset, and
+   atoms in rings have fixed torsions. The CD atom of Ile in the
+   reference file is renamed CD1.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   NERFCHAIN *chain;
+   int       i;
+
+   chain = blCreateNeRFChain("ACDEFGHIK", NERF_REFCOORDS);
+   for(i=0; i<chain->nres; i++)
+   {
+      NERFDOF(chain, i, NERF_PHI) = -57.0 * PI / 180.0;
+      NERFDOF(chain, i, NERF_PSI) = -47.0 * PI / 180.0;
+   }
+   blBuildNeRFChain(chain, 0);
+   pdb = blNeRFChainToPDB(chain, "A");
+   blFreeNeRFChain(chain);
+\endcode
+
+   After changing the torsions of residue i and later residues only,
+   blBuildNeRFChain(chain, i) rebuilds from residue i onwards.
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Maths
+   #SUBGROUP Geometry
+
+   #FUNCTION  blCreateNeRFChain()
+   Creates a chain in internal coordinates from a sequence
+
+   #FUNCTION  blCreateNeRFChainPDB()
+   Creates a chain in internal coordinates from a PDB linked list
+
+   #FUNCTION  blFreeNeRFChain()
+   Frees a chain in internal coordinates
+
+   #FUNCTION  blBuildNeRFChain()
+   Builds Cartesian coordinates from internal coordinates
+
+   #FUNCTION  blExtractNeRFTorsions()
+   Calculates the torsions from the Cartesian coordinates
+
+   #FUNCTION  blSetNeRFChainFromPDB()
+   Takes the coordinates and torsions from a PDB linked list
+
+   #FUNCTION  blNeRFChainToPDB()
+   Creates a PDB linked list from a chain
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "general.h"
+#include "seq.h"
+#include "angle.h"
+#include "pdb.h"
+#include "nerf.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define DATAENV        "DATADIR"
+#define MAXRESATOMS    16     /* Max atoms in a reference residue       */
+#define MAXTEMPLATES   32     /* Max reference residue types            */
+#define BONDCUTSQ      ((REAL)(1.9*1.9))  /* Max bond length squared    */
+#define NBACKBONE      4      /* N, CA, C, O                            */
+#define UNSETDOF       ((REAL)1.0e30)  /* lastDof[] not yet calculated  */
+
+/* Backbone geometry from Engh & Huber (1991) Acta Cryst A47, 392-400   */
+#define BOND_NCA       ((REAL)1.458)
+#define BOND_CAC       ((REAL)1.525)
+#define BOND_CN        ((REAL)1.329)
+#define BOND_CO        ((REAL)1.231)
+#define ANGLE_NCAC     ((REAL)(111.2 * PI / 180.0))
+#define ANGLE_CACN     ((REAL)(116.2 * PI / 180.0))
+#define ANGLE_CNCA     ((REAL)(121.7 * PI / 180.0))
+#define ANGLE_CACO     ((REAL)(120.8 * PI / 180.0))
+
+/* Internal coordinates of a residue from the reference file. Atoms
+   0-3 are N, CA, C and O. ref[] are indices within the residue, with
+   C standing in for the atom before N.
+*/
+typedef struct
+{
+   REAL bond[MAXRESATOMS],
+        angle[MAXRESATOMS],
+        torsion[MAXRESATOMS],    /* Fixed or offset from chi           */
+        chiValue[NERF_MAXCHI];
+   int  ref[MAXRESATOMS][3],
+        chi[MAXRESATOMS],        /* Chi angle or -1                    */
+        natoms,
+        nchi;
+   char resnam[8],
+        atnam[MAXRESATOMS][8];
+}  RESTEMPLATE;
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static REAL Torsion(REAL *x, REAL *y, REAL *z, int a, int b, int c,
+                    int d);
+static REAL BondAngle(REAL *x, REAL *y, REAL *z, int a, int b, int c);
+static REAL WrapAngle(REAL angle);
+static BOOL InRing(BOOL bonded[MAXRESATOMS][MAXRESATOMS], int natoms,
+                   int a, int b);
+static BOOL MakeTemplate(PDB *start, PDB *stop, RESTEMPLATE *t);
+static int  ReadTemplates(char *filename, RESTEMPLATE *templates);
+static NERFCHAIN *AllocNeRFChain(int natoms, int nres);
+static void SetAtom(NERFCHAIN *chain, int i, char *atnam, int r1,
+                    int r2, int r3, REAL bond, REAL angle, REAL torsion,
+                    int dof);
+
+
+/************************************************************************/
+/*>static REAL Torsion(REAL *x, REAL *y, REAL *z, int a, int b, int c,
+                       int d)
+   -------------------------------------------------------------------
+*//**
+
+   \param[in]     *x        X coordinates
+   \param[in]     *y        Y coordinates
+   \param[in]     *z        Z coordinates
+   \param[in]     a         First atom
+   \param[in]     b         Second atom
+   \param[in]     c         Third atom
+   \param[in]     d         Fourth atom
+   \return                  Torsion angle a-b-c-d (radians)
+
+   Calculates a torsion angle with the same sign convention as blPhi()
+
+-  17.10.26 Original   By: ACRM
+*/
+static REAL Torsion(REAL *x, REAL *y, REAL *z, int a, int b, int c,
+                    int d)
+{
+   REAL b1x = x[b] - x[a], b1y = y[b] - y[a], b1z = z[b] - z[a],
+        b2x = x[c] - x[b], b2y = y[c] - y[b], b2z = z[c] - z[b],
+        b3x = x[d] - x[c], b3y = y[d] - y[c], b3z = z[d] - z[c],
+        n1x, n1y, n1z,
+        n2x, n2y, n2z,
+        mx,  my,  mz,
+        lenb2;
+
+   /* Normals to the two planes                                         */
+   n1x = b1y*b2z - b1z*b2y;
+   n1y = b1z*b2x - b1x*b2z;
+   n1z = b1x*b2y - b1y*b2x;
+   n2x = b2y*b3z - b2z*b3y;
+   n2y = b2z*b3x - b2x*b3z;
+   n2z = b2x*b3y - b2y*b3x;
+
+   /* m = n1 x b2 / |b2| gives the sine component                       */
+   lenb2 = (REAL)sqrt(b2x*b2x + b2y*b2y + b2z*b2z);
+   mx    = (n1y*b2z - n1z*b2y) / lenb2;
+   my    = (n1z*b2x - n1x*b2z) / lenb2;
+   mz    = (n1x*b2y - n1y*b2x) / lenb2;
+
+   return((REAL)atan2(-(mx*n2x + my*n2y + mz*n2z),
+                      n1x*n2x + n1y*n2y + n1z*n2z));
+}
+
+
+/************************************************************************/
+/*>static REAL BondAngle(REAL *x, REAL *y, REAL *z, int a, int b, int c)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *x        X coordinates
+   \param[in]     *y        Y coordinates
+   \param[in]     *z        Z coordinates
+   \param[in]     a         First atom
+   \param[in]     b         Central atom
+   \param[in]     c         Third atom
+   \return                  Angle a-b-c (radians)
+
+-  17.10.26 Original   By: ACRM
+*/
+static REAL BondAngle(REAL *x, REAL *y, REAL *z, int a, int b, int c)
+{
+   return(blAngle(x[a], y[a], z[a], x[b], y[b], z[b], x[c], y[c], z[c]));
+}
+
+
+/************************************************************************/
+/*>static REAL WrapAngle(REAL angle)
+   ---------------------------------
+*//**
+
+   \param[in]     angle     An angle (radians)
+   \return                  The angle in the range -PI to PI
+
+-  17.10.26 Original   By: ACRM
+*/
+static REAL WrapAngle(REAL angle)
+{
+   while(angle > PI)
+      angle -= 2*PI;
+   while(angle <= -PI)
+      angle += 2*PI;
+   return(angle);
+}
+
+
+/************************************************************************/
+/*>static BOOL InRing(BOOL bonded[MAXRESATOMS][MAXRESATOMS], int natoms,
+                      int a, int b)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     bonded    Bond matrix of a residue
+   \param[in]     natoms    Number of atoms in the residue
+   \param[in]     a         First atom of a bond
+   \param[in]     b         Second atom of the bond
+   \return                  Is the bond in a ring?
+
+   Looks for a path from a to b that does not use the bond between them
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL InRing(BOOL bonded[MAXRESATOMS][MAXRESATOMS], int natoms,
+                   int a, int b)
+{
+   int  stack[MAXRESATOMS],
+        nstack = 0,
+        i, j;
+   BOOL seen[MAXRESATOMS];
+
+   for(i=0; i<natoms; i++)
+      seen[i] = FALSE;
+   seen[a]         = TRUE;
+   stack[nstack++] = a;
+
+   while(nstack)
+   {
+      i = stack[--nstack];
+      for(j=0; j<natoms; j++)
+      {
+         if(!bonded[i][j] || seen[j] || ((i == a) && (j == b)))
+            continue;
+         if(j == b)
+            return(TRUE);
+         seen[j]         = TRUE;
+         stack[nstack++] = j;
+      }
+   }
+   return(FALSE);
+}
+
+
+/************************************************************************/
+/*>static BOOL MakeTemplate(PDB *start, PDB *stop, RESTEMPLATE *t)
+   ---------------------------------------------------------------
+*//**
+
+   \param[in]     *start    First atom of a reference residue
+   \param[in]     *stop     Atom after the residue
+   \param[out]    *t        Internal coordinates of the residue
+   \return                  Success (FALSE if the residue does not start
+                            N, CA, C, O, is too big or has an unbonded
+                            atom)
+
+   Finds the atom each sidechain atom is bonded to, works out which
+   torsions are chi angles and calculates the internal coordinates of
+   the sidechain atoms.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL MakeTemplate(PDB *start, PDB *stop, RESTEMPLATE *t)
+{
+   static char *backbone[] = {"N   ", "CA  ", "C   ", "O   "};
+   REAL x[MAXRESATOMS], y[MAXRESATOMS], z[MAXRESATOMS],
+        tor;
+   int  parent[MAXRESATOMS],
+        i, j, k;
+   BOOL bonded[MAXRESATOMS][MAXRESATOMS];
+   PDB  *p;
+
+   t->natoms = 0;
+   t->nchi   = 0;
+   strcpy(t->resnam, start->resnam);
+
+   for(p=start; p!=stop; NEXT(p))
+   {
+      if(t->natoms >= MAXRESATOMS)
+         return(FALSE);
+      i = t->natoms++;
+      strcpy(t->atnam[i], p->atnam);
+      if(!strncmp(t->resnam, "ILE", 3) && !strcmp(t->atnam[i], "CD  "))
+         strcpy(t->atnam[i], "CD1 ");
+      x[i] = p->x;
+      y[i] = p->y;
+      z[i] = p->z;
+      if((i < NBACKBONE) && strcmp(t->atnam[i], backbone[i]))
+         return(FALSE);
+   }
+   if(t->natoms < NBACKBONE)
+      return(FALSE);
+
+   for(i=0; i<t->natoms; i++)
+   {
+      for(j=0; j<t->natoms; j++)
+      {
+         REAL dx = x[i] - x[j],
+              dy = y[i] - y[j],
+              dz = z[i] - z[j];
+         bonded[i][j] = (i != j) && (dx*dx + dy*dy + dz*dz < BONDCUTSQ);
+      }
+   }
+
+   /* The atom each atom is placed from. C stands in for the previous
+      residue's C before N.
+   */
+   parent[0] = 2;
+   parent[1] = 0;
+   parent[2] = 1;
+   parent[3] = 2;
+   for(i=NBACKBONE; i<t->natoms; i++)
+   {
+      for(parent[i]=(-1), j=i-1; j>=0; j--)
+      {
+         if(bonded[i][j] && (j != 3))
+         {
+            parent[i] = j;
+            break;
+         }
+      }
+      if(parent[i] < 0)
+         return(FALSE);
+   }
+
+   for(i=NBACKBONE; i<t->natoms; i++)
+   {
+      int r3 = parent[i],
+          r2 = parent[r3],
+          r1 = parent[r2];
+
+      t->ref[i][0] = r1;
+      t->ref[i][1] = r2;
+      t->ref[i][2] = r3;
+      t->bond[i]   = (REAL)sqrt((x[i]-x[r3])*(x[i]-x[r3]) +
+                                (y[i]-y[r3])*(y[i]-y[r3]) +
+                                (z[i]-z[r3])*(z[i]-z[r3]));
+      t->angle[i]  = BondAngle(x, y, z, r2, r3, i);
+      tor          = Torsion(x, y, z, r1, r2, r3, i);
+      t->torsion[i] = tor;
+      t->chi[i]    = (-1);
+
+      /* A rotatable sidechain bond gives a chi angle                   */
+      if((r3 >= NBACKBONE) && !InRing(bonded, t->natoms, r2, r3))
+      {
+         for(k=NBACKBONE; k<i; k++)
+         {
+            if((t->chi[k] >= 0) && (t->ref[k][0] == r1) &&
+               (t->ref[k][1] == r2) && (t->ref[k][2] == r3))
+               break;
+         }
+
+         if(k < i)
+         {
+            t->chi[i]     = t->chi[k];
+            t->torsion[i] = WrapAngle(tor - t->chiValue[t->chi[k]]);
+         }
+         else if(t->nchi < NERF_MAXCHI)
+         {
+            t->chi[i]               = t->nchi;
+            t->chiValue[t->nchi++] = tor;
+            t->torsion[i]           = (REAL)0.0;
+         }
+      }
+   }
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static int ReadTemplates(char *filename, RESTEMPLATE *templates)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in]     *filename  Reference coordinate file. Looked for in the
+                             current directory and then in $DATADIR
+   \param[out]    *templates Up to MAXTEMPLATES residue templates
+   \return                   Number of templates read or -1 on error
+
+-  17.10.26 Original   By: ACRM
+*/
+static int ReadTemplates(char *filename, RESTEMPLATE *templates)
+{
+   FILE *fp;
+   PDB  *pdb,
+        *start,
+        *stop;
+   int  natoms,
+        ntemplates = 0;
+   BOOL noenv;
+
+   if((fp=blOpenFile(filename, DATAENV, "r", &noenv))==NULL)
+      return(-1);
+   pdb = blReadPDBAtoms(fp, &natoms);
+   fclose(fp);
+   if(pdb == NULL)
+      return(-1);
+
+   for(start=pdb; start!=NULL; start=stop)
+   {
+      stop = blFindNextResidue(start);
+      if(ntemplates < MAXTEMPLATES)
+      {
+         if(MakeTemplate(start, stop, &(templates[ntemplates])))
+            ntemplates++;
+      }
+   }
+
+   FREELIST(pdb, PDB);
+   return(ntemplates);
+}
+
+
+/************************************************************************/
+/*>static NERFCHAIN *AllocNeRFChain(int natoms, int nres)
+   ------------------------------------------------------
+*//**
+
+   \param[in]     natoms    Number of atoms
+   \param[in]     nres      Number of residues
+   \return                  Chain with all arrays allocated, or NULL
+
+-  17.10.26 Original   By: ACRM
+*/
+static NERFCHAIN *AllocNeRFChain(int natoms, int nres)
+{
+   NERFCHAIN *chain;
+   int       ndofs = nres * NERF_NDOF,
+             i;
+
+   if((chain = (NERFCHAIN *)malloc(sizeof(NERFCHAIN)))==NULL)
+      return(NULL);
+
+   chain->natoms   = natoms;
+   chain->nres     = nres;
+   chain->anchored = FALSE;
+   chain->x        = (REAL *)malloc(natoms * sizeof(REAL));
+   chain->y        = (REAL *)malloc(natoms * sizeof(REAL));
+   chain->z        = (REAL *)malloc(natoms * sizeof(REAL));
+   chain->bond     = (REAL *)malloc(natoms * sizeof(REAL));
+   chain->angle    = (REAL *)malloc(natoms * sizeof(REAL));
+   chain->torsion  = (REAL *)malloc(natoms * sizeof(REAL));
+   chain->cosAngle = (REAL *)malloc(natoms * sizeof(REAL));
+   chain->sinAngle = (REAL *)malloc(natoms * sizeof(REAL));
+   chain->cosTor   = (REAL *)malloc(natoms * sizeof(REAL));
+   chain->sinTor   = (REAL *)malloc(natoms * sizeof(REAL));
+   chain->dofs     = (REAL *)malloc(ndofs  * sizeof(REAL));
+   chain->cosDof   = (REAL *)malloc(ndofs  * sizeof(REAL));
+   chain->sinDof   = (REAL *)malloc(ndofs  * sizeof(REAL));
+   chain->lastDof  = (REAL *)malloc(ndofs  * sizeof(REAL));
+   chain->ref      = (int  *)malloc(3 * natoms * sizeof(int));
+   chain->dof      = (int  *)malloc(natoms * sizeof(int));
+   chain->dofAtom  = (int  *)malloc(ndofs  * sizeof(int));
+   chain->resFirst = (int  *)malloc((nres+1) * sizeof(int));
+   chain->atnam    = (char (*)[8])malloc(natoms * 8 * sizeof(char));
+   chain->resnam   = (char (*)[8])malloc(nres   * 8 * sizeof(char));
+
+   if((chain->x        == NULL) || (chain->y        == NULL) ||
+      (chain->z        == NULL) || (chain->bond     == NULL) ||
+      (chain->angle    == NULL) || (chain->torsion  == NULL) ||
+      (chain->cosAngle == NULL) || (chain->sinAngle == NULL) ||
+      (chain->cosTor   == NULL) || (chain->sinTor   == NULL) ||
+      (chain->dofs     == NULL) || (chain->cosDof   == NULL) ||
+      (chain->sinDof   == NULL) || (chain->lastDof  == NULL) ||
+      (chain->ref      == NULL) ||
+      (chain->dof      == NULL) || (chain->dofAtom  == NULL) ||
+      (chain->resFirst == NULL) || (chain->atnam    == NULL) ||
+      (chain->resnam   == NULL))
+   {
+      blFreeNeRFChain(chain);
+      return(NULL);
+   }
+
+   for(i=0; i<natoms; i++)
+   {
+      chain->x[i] = chain->y[i] = chain->z[i] = (REAL)0.0;
+      chain->ref[3*i] = chain->ref[3*i+1] = chain->ref[3*i+2] = (-1);
+   }
+   for(i=0; i<ndofs; i++)
+   {
+      chain->dofs[i]    = (REAL)0.0;
+      chain->lastDof[i] = UNSETDOF;
+      chain->dofAtom[i] = (-1);
+   }
+
+   return(chain);
+}
+
+
+/************************************************************************/
+/*>static void SetAtom(NERFCHAIN *chain, int i, char *atnam, int r1,
+                       int r2, int r3, REAL bond, REAL angle,
+                       REAL torsion, int dof)
+   -----------------------------------------------------------------
+*//**
+
+   \param[in,out] *chain    Chain
+   \param[in]     i         Atom to set
+   \param[in]     *atnam    Atom name
+   \param[in]     r1        Torsion reference atom
+   \param[in]     r2        Angle reference atom
+   \param[in]     r3        Bonded reference atom
+   \param[in]     bond      Bond length
+   \param[in]     angle     Bond angle (radians)
+   \param[in]     torsion   Fixed torsion or offset from dof (radians)
+   \param[in]     dof       Index into chain->dofs[] or -1
+
+   Sets the internal coordinates of one atom. An atom with no offset
+   from its dof is preferred as the one used to extract that dof.
+
+-  17.10.26 Original   By: ACRM
+*/
+static void SetAtom(NERFCHAIN *chain, int i, char *atnam, int r1,
+                    int r2, int r3, REAL bond, REAL angle, REAL torsion,
+                    int dof)
+{
+   strcpy(chain->atnam[i], atnam);
+   chain->ref[3*i]   = r1;
+   chain->ref[3*i+1] = r2;
+   chain->ref[3*i+2] = r3;
+   chain->bond[i]    = bond;
+   chain->angle[i]   = angle;
+   chain->torsion[i] = torsion;
+   chain->cosAngle[i] = (REAL)cos(angle);
+   chain->sinAngle[i] = (REAL)sin(angle);
+   chain->cosTor[i]  = (REAL)cos(torsion);
+   chain->sinTor[i]  = (REAL)sin(torsion);
+   chain->dof[i]     = dof;
+
+   if((dof >= 0) && (r1 >= 0))
+   {
+      int d = chain->dofAtom[dof];
+      if((d < 0) ||
+         ((torsion == (REAL)0.0) && (chain->torsion[d] != (REAL)0.0)))
+         chain->dofAtom[dof] = i;
+   }
+}
+
+
+/************************************************************************/
+/*>NERFCHAIN *blCreateNeRFChain(char *sequence, char *refCoords)
+   -------------------------------------------------------------
+*//**
+
+   \param[in]     *sequence  One-letter amino acid sequence
+   \param[in]     *refCoords Reference coordinate file for the
+                             sidechains (e.g. NERF_REFCOORDS) or NULL
+                             for the backbone only. Looked for in the
+                             current directory and then in $DATADIR
+   \return                   The chain or NULL on error
+
+   Sets up the internal coordinates for a chain. Each residue has N, CA,
+   C and O followed by the sidechain atoms in the order of the reference
+   file; residues not in the file have only backbone atoms. The chain
+   is extended (phi, psi and omega are 180) and the chi angles are those
+   of the reference residues. Call blBuildNeRFChain() to calculate the
+   coordinates.
+
+-  17.10.26 Original   By: ACRM
+*/
+NERFCHAIN *blCreateNeRFChain(char *sequence, char *refCoords)
+{
+   RESTEMPLATE *templates = NULL,
+               **resTemplate = NULL;
+   NERFCHAIN   *chain     = NULL;
+   char        *resnam;
+   int         ntemplates = 0,
+               nres,
+               natoms     = 0,
+               r, i, j, n, ca, c, base;
+
+   if((sequence == NULL) || ((nres = strlen(sequence)) == 0))
+      return(NULL);
+
+   if((resTemplate = (RESTEMPLATE **)malloc(nres * sizeof(RESTEMPLATE *)))
+      ==NULL)
+      return(NULL);
+
+   if(refCoords != NULL)
+   {
+      if(((templates = (RESTEMPLATE *)malloc(MAXTEMPLATES *
+                                             sizeof(RESTEMPLATE)))==NULL) ||
+         ((ntemplates = ReadTemplates(refCoords, templates)) < 0))
+      {
+         FREE(templates);
+         free(resTemplate);
+         return(NULL);
+      }
+   }
+
+   /* Find the template for each residue and count the atoms            */
+   for(r=0; r<nres; r++)
+   {
+      resnam = blOnethr((char)toupper(sequence[r]));
+      resTemplate[r] = NULL;
+      for(i=0; i<ntemplates; i++)
+      {
+         if(!strncmp(templates[i].resnam, resnam, 3))
+         {
+            resTemplate[r] = &(templates[i]);
+            break;
+         }
+      }
+      natoms += (resTemplate[r] == NULL) ? NBACKBONE :
+                                           resTemplate[r]->natoms;
+   }
+
+   if((chain = AllocNeRFChain(natoms, nres)) != NULL)
+   {
+      for(r=0, base=0; r<nres; r++)
+      {
+         RESTEMPLATE *t = resTemplate[r];
+
+         chain->resFirst[r] = base;
+         strcpy(chain->resnam[r], blOnethr((char)toupper(sequence[r])));
+         n  = base;
+         ca = base + 1;
+         c  = base + 2;
+
+         NERFDOF(chain, r, NERF_PHI)   = (REAL)PI;
+         NERFDOF(chain, r, NERF_PSI)   = (REAL)PI;
+         NERFDOF(chain, r, NERF_OMEGA) = (REAL)PI;
+
+         if(r == 0)
+         {
+            SetAtom(chain, n, "N   ", -1, -1, -1, (REAL)0.0, (REAL)0.0,
+                    (REAL)0.0, -1);
+            SetAtom(chain, ca, "CA  ", -1, -1, n, BOND_NCA, (REAL)0.0,
+                    (REAL)0.0, -1);
+            SetAtom(chain, c, "C   ", -1, n, ca, BOND_CAC, ANGLE_NCAC,
+                    (REAL)0.0, -1);
+         }
+         else
+         {
+            int pn  = chain->resFirst[r-1],
+                pca = pn + 1,
+                pc  = pn + 2;
+
+            SetAtom(chain, n, "N   ", pn, pca, pc, BOND_CN, ANGLE_CACN,
+                    (REAL)0.0, (r-1)*NERF_NDOF + NERF_PSI);
+            SetAtom(chain, ca, "CA  ", pca, pc, n, BOND_NCA, ANGLE_CNCA,
+                    (REAL)0.0, (r-1)*NERF_NDOF + NERF_OMEGA);
+            SetAtom(chain, c, "C   ", pc, n, ca, BOND_CAC, ANGLE_NCAC,
+                    (REAL)0.0, r*NERF_NDOF + NERF_PHI);
+         }
+         SetAtom(chain, base+3, "O   ", n, ca, c, BOND_CO, ANGLE_CACO,
+                 (REAL)PI, r*NERF_NDOF + NERF_PSI);
+
+         if(t != NULL)
+         {
+            for(j=NBACKBONE; j<t->natoms; j++)
+            {
+               SetAtom(chain, base+j, t->atnam[j], base+t->ref[j][0],
+                       base+t->ref[j][1], base+t->ref[j][2], t->bond[j],
+                       t->angle[j], t->torsion[j],
+                       (t->chi[j] < 0) ? (-1) :
+                       (r*NERF_NDOF + NERF_CHI1 + t->chi[j]));
+            }
+            for(j=0; j<t->nchi; j++)
+               NERFDOF(chain, r, NERF_CHI1 + j) = t->chiValue[j];
+         }
+
+         base += (t == NULL) ? NBACKBONE : t->natoms;
+      }
+      chain->resFirst[nres] = base;
+
+      blBuildNeRFChain(chain, 0);
+   }
+
+   FREE(templates);
+   free(resTemplate);
+   return(chain);
+}
+
+
+/************************************************************************/
+/*>void blFreeNeRFChain(NERFCHAIN *chain)
+   --------------------------------------
+*//**
+
+   \param[in]     *chain    Chain
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeNeRFChain(NERFCHAIN *chain)
+{
+   if(chain == NULL)
+      return;
+
+   FREE(chain->x);
+   FREE(chain->y);
+   FREE(chain->z);
+   FREE(chain->bond);
+   FREE(chain->angle);
+   FREE(chain->torsion);
+   FREE(chain->cosAngle);
+   FREE(chain->sinAngle);
+   FREE(chain->cosTor);
+   FREE(chain->sinTor);
+   FREE(chain->dofs);
+   FREE(chain->cosDof);
+   FREE(chain->sinDof);
+   FREE(chain->lastDof);
+   FREE(chain->ref);
+   FREE(chain->dof);
+   FREE(chain->dofAtom);
+   FREE(chain->resFirst);
+   FREE(chain->atnam);
+   FREE(chain->resnam);
+   free(chain);
+}
+
+
+/************************************************************************/
+/*>void blBuildNeRFChain(NERFCHAIN *chain, int firstRes)
+   -----------------------------------------------------
+*//**
+
+   \param[in,out] *chain    Chain
+   \param[in]     firstRes  First residue to build
+
+   Calculates the Cartesian coordinates of the atoms of residue firstRes
+   onwards from the internal coordinates. The torsions of residues
+   before firstRes must not have changed since they were last built.
+
+   When building from the first residue, N is placed at the origin, CA
+   along the x axis and C in the xy plane unless the chain is anchored
+   (by blSetNeRFChainFromPDB()), in which case their coordinates are
+   kept.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blBuildNeRFChain(NERFCHAIN *chain, int firstRes)
+{
+   REAL *x = chain->x,
+        *y = chain->y,
+        *z = chain->z,
+        ct, st,
+        bcx, bcy, bcz,
+        abx, aby, abz,
+        nx,  ny,  nz,
+        mx,  my,  mz,
+        lenBC, lenN, invLen,
+        d2x, d2y, d2z;
+   int  i, d, a, b, c,
+        start,
+        firstDof;
+
+   if((firstRes < 0) || (firstRes >= chain->nres))
+      return;
+
+   /* Sines and cosines of the torsions that have changed               */
+   firstDof = ((firstRes > 0) ? (firstRes - 1) : 0) * NERF_NDOF;
+   for(d=firstDof; d<chain->nres*NERF_NDOF; d++)
+   {
+      if((chain->dofAtom[d] >= 0) &&
+         (chain->dofs[d] != chain->lastDof[d]))
+      {
+         chain->cosDof[d]  = (REAL)cos(chain->dofs[d]);
+         chain->sinDof[d]  = (REAL)sin(chain->dofs[d]);
+         chain->lastDof[d] = chain->dofs[d];
+      }
+   }
+
+   start = chain->resFirst[firstRes];
+   if(start == 0)
+   {
+      if(!chain->anchored)
+      {
+         x[0] = y[0] = z[0] = (REAL)0.0;
+         x[1] = chain->bond[1];
+         y[1] = z[1] = (REAL)0.0;
+         x[2] = x[1] - chain->bond[2] * chain->cosAngle[2];
+         y[2] = chain->bond[2] * chain->sinAngle[2];
+         z[2] = (REAL)0.0;
+      }
+      start = 3;
+   }
+
+   for(i=start; i<chain->natoms; i++)
+   {
+      /* Torsion from its dof and offset by the angle sum formulae      */
+      if((d = chain->dof[i]) >= 0)
+      {
+         ct = chain->cosDof[d] * chain->cosTor[i] -
+              chain->sinDof[d] * chain->sinTor[i];
+         st = chain->sinDof[d] * chain->cosTor[i] +
+              chain->cosDof[d] * chain->sinTor[i];
+      }
+      else
+      {
+         ct = chain->cosTor[i];
+         st = chain->sinTor[i];
+      }
+
+      a = chain->ref[3*i];
+      b = chain->ref[3*i+1];
+      c = chain->ref[3*i+2];
+
+      /* Local frame: bc along the b->c bond, n normal to the a,b,c
+         plane and m = n x bc completing the frame. They are normalised
+         at the end so that the two square roots are independent and
+         share one division.
+      */
+      bcx = x[c] - x[b];
+      bcy = y[c] - y[b];
+      bcz = z[c] - z[b];
+      abx = x[b] - x[a];
+      aby = y[b] - y[a];
+      abz = z[b] - z[a];
+      nx  = aby*bcz - abz*bcy;
+      ny  = abz*bcx - abx*bcz;
+      nz  = abx*bcy - aby*bcx;
+      mx  = ny*bcz - nz*bcy;
+      my  = nz*bcx - nx*bcz;
+      mz  = nx*bcy - ny*bcx;
+
+      lenBC  = (REAL)sqrt(bcx*bcx + bcy*bcy + bcz*bcz);
+      lenN   = (REAL)sqrt(nx*nx + ny*ny + nz*nz);
+      invLen = (REAL)1.0 / (lenBC * lenN);
+
+      /* Position in the local frame, scaled by the normalisation       */
+      d2x = -chain->bond[i] * chain->cosAngle[i] * lenN  * invLen;
+      d2y =  chain->bond[i] * chain->sinAngle[i] * ct    * invLen;
+      d2z =  chain->bond[i] * chain->sinAngle[i] * st * lenBC * invLen;
+
+      x[i] = x[c] + d2x*bcx + d2y*mx + d2z*nx;
+      y[i] = y[c] + d2x*bcy + d2y*my + d2z*ny;
+      z[i] = z[c] + d2x*bcz + d2y*mz + d2z*nz;
+   }
+}
+
+
+/************************************************************************/
+/*>void blExtractNeRFTorsions(NERFCHAIN *chain)
+   --------------------------------------------
+*//**
+
+   \param[in,out] *chain    Chain
+
+   Calculates the torsions (phi, psi, omega and chis) of each residue
+   from the current Cartesian coordinates. This is the inverse of
+   blBuildNeRFChain(). The phi of the first residue and the omega of
+   the last have no atoms to define them and are left unchanged.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blExtractNeRFTorsions(NERFCHAIN *chain)
+{
+   int d, i;
+
+   for(d=0; d<chain->nres*NERF_NDOF; d++)
+   {
+      if((i = chain->dofAtom[d]) < 0)
+         continue;
+      chain->dofs[d] = WrapAngle(Torsion(chain->x, chain->y, chain->z,
+                                         chain->ref[3*i],
+                                         chain->ref[3*i+1],
+                                         chain->ref[3*i+2], i) -
+                                 chain->torsion[i]);
+   }
+}
+
+
+/************************************************************************/
+/*>BOOL blSetNeRFChainFromPDB(NERFCHAIN *chain, PDB *pdb)
+   ------------------------------------------------------
+*//**
+
+   \param[in,out] *chain    Chain
+   \param[in]     *pdb      PDB linked list
+   \return                  Success (FALSE if the number of residues
+                            differs or memory allocation failed)
+
+   Matches the ATOM records of each residue to the chain atoms by name,
+   copies their coordinates and calculates the torsions from them.
+   Torsions involving missing atoms are left unchanged. If N, CA and C
+   of the first residue are present the chain is anchored so that
+   rebuilding keeps the chain in the same place.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blSetNeRFChainFromPDB(NERFCHAIN *chain, PDB *pdb)
+{
+   PDB  **atoms,
+        *p,
+        *prev = NULL;
+   REAL *x = chain->x,
+        *y = chain->y,
+        *z = chain->z;
+   int  r = (-1),
+        d, i, k;
+   BOOL found;
+
+   if((atoms = (PDB **)malloc(chain->natoms * sizeof(PDB *)))==NULL)
+      return(FALSE);
+   for(i=0; i<chain->natoms; i++)
+      atoms[i] = NULL;
+
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      if(strncmp(p->record_type, "ATOM", 4))
+         continue;
+      if((prev == NULL) || (prev->resnum != p->resnum) ||
+         !PDBINSERTMATCH(prev, p) || !PDBCHAINMATCH(prev, p))
+      {
+         if(++r >= chain->nres)
+         {
+            free(atoms);
+            return(FALSE);
+         }
+      }
+      prev = p;
+
+      for(i=chain->resFirst[r]; i<chain->resFirst[r+1]; i++)
+      {
+         if(!strcmp(chain->atnam[i], p->atnam))
+         {
+            atoms[i] = p;
+            break;
+         }
+      }
+   }
+   if(r != chain->nres - 1)
+   {
+      free(atoms);
+      return(FALSE);
+   }
+
+   for(i=0; i<chain->natoms; i++)
+   {
+      if(atoms[i] != NULL)
+      {
+         x[i] = atoms[i]->x;
+         y[i] = atoms[i]->y;
+         z[i] = atoms[i]->z;
+      }
+   }
+
+   for(d=0; d<chain->nres*NERF_NDOF; d++)
+   {
+      if((i = chain->dofAtom[d]) < 0)
+         continue;
+      for(found=(atoms[i] != NULL), k=0; found && (k<3); k++)
+         found = (atoms[chain->ref[3*i+k]] != NULL);
+      if(found)
+      {
+         chain->dofs[d] = WrapAngle(Torsion(x, y, z, chain->ref[3*i],
+                                            chain->ref[3*i+1],
+                                            chain->ref[3*i+2], i) -
+                                    chain->torsion[i]);
+      }
+   }
+
+   chain->anchored = ((atoms[0] != NULL) && (atoms[1] != NULL) &&
+                      (atoms[2] != NULL));
+   free(atoms);
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>NERFCHAIN *blCreateNeRFChainPDB(PDB *pdb, char *refCoords)
+   ----------------------------------------------------------
+*//**
+
+   \param[in]     *pdb       PDB linked list of a single chain
+   \param[in]     *refCoords Reference coordinate file for the
+                             sidechains or NULL for the backbone only
+   \return                   The chain or NULL on error
+
+   Creates a chain with the sequence of the ATOM records of a PDB linked
+   list and sets its torsions and coordinates from it with
+   blSetNeRFChainFromPDB()
+
+-  17.10.26 Original   By: ACRM
+*/
+NERFCHAIN *blCreateNeRFChainPDB(PDB *pdb, char *refCoords)
+{
+   NERFCHAIN *chain;
+   PDB       *p,
+             *prev = NULL;
+   char      *sequence;
+   int       nres = 0;
+
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      if(strncmp(p->record_type, "ATOM", 4))
+         continue;
+      if((prev == NULL) || (prev->resnum != p->resnum) ||
+         !PDBINSERTMATCH(prev, p) || !PDBCHAINMATCH(prev, p))
+         nres++;
+      prev = p;
+   }
+
+   if((sequence = (char *)malloc((nres+1) * sizeof(char)))==NULL)
+      return(NULL);
+
+   for(nres=0, prev=NULL, p=pdb; p!=NULL; NEXT(p))
+   {
+      if(strncmp(p->record_type, "ATOM", 4))
+         continue;
+      if((prev == NULL) || (prev->resnum != p->resnum) ||
+         !PDBINSERTMATCH(prev, p) || !PDBCHAINMATCH(prev, p))
+         sequence[nres++] = blThrone(p->resnam);
+      prev = p;
+   }
+   sequence[nres] = '\0';
+
+   chain = blCreateNeRFChain(sequence, refCoords);
+   free(sequence);
+
+   if((chain != NULL) && !blSetNeRFChainFromPDB(chain, pdb))
+   {
+      blFreeNeRFChain(chain);
+      return(NULL);
+   }
+
+   return(chain);
+}
+
+
+/************************************************************************/
+/*>PDB *blNeRFChainToPDB(NERFCHAIN *chain, char *chainLabel)
+   ---------------------------------------------------------
+*//**
+
+   \param[in]     *chain       Chain
+   \param[in]     *chainLabel  Chain label for the atoms
+   \return                     PDB linked list or NULL if memory
+                               allocation failed
+
+   Creates a PDB linked list of the atoms in a chain. Residues are
+   numbered from 1.
+
+-  17.10.26 Original   By: ACRM
+*/
+PDB *blNeRFChainToPDB(NERFCHAIN *chain, char *chainLabel)
+{
+   PDB *pdb = NULL,
+       *p   = NULL;
+   int r, i;
+
+   for(r=0; r<chain->nres; r++)
+   {
+      for(i=chain->resFirst[r]; i<chain->resFirst[r+1]; i++)
+      {
+         if(pdb == NULL)
+         {
+            INIT(pdb, PDB);
+            p = pdb;
+         }
+         else
+         {
+            ALLOCNEXT(p, PDB);
+         }
+         if(p == NULL)
+         {
+            FREELIST(pdb, PDB);
+            return(NULL);
+         }
+
+         CLEAR_PDB(p);
+         strcpy(p->record_type, "ATOM  ");
+         p->atnum = i + 1;
+         strcpy(p->atnam, chain->atnam[i]);
+         if(strlen(chain->atnam[i]) && (chain->atnam[i][3] == ' '))
+            sprintf(p->atnam_raw, " %.3s", chain->atnam[i]);
+         else
+            strcpy(p->atnam_raw, chain->atnam[i]);
+         strcpy(p->resnam, chain->resnam[r]);
+         strncpy(p->chain, chainLabel, blMAXCHAINLABEL-1);
+         p->chain[blMAXCHAINLABEL-1] = '\0';
+         p->resnum = r + 1;
+         p->x      = chain->x[i];
+         p->y      = chain->y[i];
+         p->z      = chain->z[i];
+         p->occ    = 1.0;
+         p->bval   = 20.0;
+         blSetElementSymbolFromAtomName(p->element, p->atnam_raw);
+      }
+   }
+
+   return(pdb);
+}
@@ -3,12 +3,12 @@
 
    \file       NumericAlign.c
    
-   \version    V1.3
-   \date       07.07.14
+   \version    V1.5
+   \date       17.10.26
    \brief      Perform Needleman & Wunsch sequence alignment on two
                sequences encoded as numeric symbols.
    
-   \copyright  (c) UCL / Dr. Andrew C. R. Martin / University of Reading 1993-2014
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin / University of Reading 1993-2026
    \author     Dr. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -57,6 +57,10 @@
    First call NumericReadMDM() to read the mutation data matrix, then call
    NumericAffineAlign() to align the sequences.
 
+   Alternatively, call blNumericReadMDMatrix() to obtain an MDMATRIX
+   and pass this to blNumericMDMatrixAffineAlign(). Several of these
+   may be used at once.
+
 **************************************************************************
 
    Revision History:
@@ -67,6 +71,11 @@
                   first
 -  V1.2  06.02.03 Fixed for new version of GetWord()
 -  V1.3  07.07.14 Use bl prefix for functions By: CTP
+-  V1.4  17.10.26 Alignments are counted and timed when compiled with
+                  INSTRUMENT_SUPPORT   By: ACRM
+-  V1.5  17.10.26 The matrix is now an MDMATRIX object. Added
+                  blNumericReadMDMatrix() and 
+                  blNumericMDMatrixAffineAlign()   By: ACRM
 
 
 *************************************************************************/
@@ -85,6 +94,17 @@
    #FUNCTION  blNumericAffineAlign()
    Perform simple N&W alignment using sequences encodede as arrays of
    numeric tokens
+
+   #FUNCTION  blNumericReadMDMatrix()
+   Read a mutation data matrix for number-encoded sequences into a
+   newly allocated MDMATRIX
+
+   #FUNCTION  blGetDefaultNumericMDMatrix()
+   Return the MDMATRIX read by blNumericReadMDM()
+
+   #FUNCTION  blNumericMDMatrixAffineAlign()
+   Perform simple N&W alignment using sequences encoded as arrays of
+   numeric tokens and a specified MDMATRIX
 */
 /************************************************************************/
 /* Includes
@@ -99,6 +119,7 @@
 #include "array.h"
 #include "general.h"
 #include "seq.h"
+#include "instrument.h"
 
 /************************************************************************/
 /* Defines and macros
@@ -121,8 +142,8 @@ typedef struct
 /************************************************************************/
 /* Globals
 */
-static int  **sMDMScore;
-static int  sMDMSize = 0;
+static MDMATRIX *sMDM  = NULL;  /* Default from blNumericReadMDM()    */
+static int      sNWarn = 0;     /* Warnings given using the default   */
 
 /************************************************************************/
 /*
@@ -151,6 +172,16 @@ static int  NumericTraceBack(int **matrix, XY **dirn, int length1,
                              int length2, int *seq1, int *seq2, 
                              int *align1, int *align2, 
                              int *align_len);
+static int  NumericAffineAlignCore(MDMATRIX *mdm, int *nWarn,
+                                   int *seq1, int length1, 
+                                   int *seq2, int length2, 
+                                   BOOL verbose, BOOL identity, 
+                                   int penalty, int penext, 
+                                   int *align1, int *align2, 
+                                   int *align_len);
+static int  *NumericEncodeSequence(MDMATRIX *mdm, int *seq, int length,
+                                   int stride, int *nWarn);
+static void MissingToken(int token, int *nWarn);
 
 
 
@@ -254,23 +285,47 @@ static int NumericSearchForBest(int  **matrix,
 -  08.03.00 Original based on align.c/ReadMDM() 26.07.95 By: ACRM
 -  06.02.03 Fixed for new version of GetWord()
 -  07.07.14 Use bl prefix for functions By: CTP
+-  17.10.26 Now a wrapper to blNumericReadMDMatrix()   By: ACRM
 */
 BOOL blNumericReadMDM(char *mdmfile)
 {
-   FILE *mdm = NULL;
-   int  i, j;
-   char buffer[MAXBUFF],
-        word[16],
-        *p;
-   BOOL noenv;
-
-   if((mdm=blOpenFile(mdmfile, DATAENV, "r", &noenv))==NULL)
+   blFreeMDMatrix(sMDM);
+   sMDM = blNumericReadMDMatrix(mdmfile);
+   return(sMDM != NULL);
+}
+
+
+/************************************************************************/
+/*>MDMATRIX *blNumericReadMDMatrix(char *mdmfile)
+   ----------------------------------------------
+*//**
+
+   \param[in]     *mdmfile    Mutation data matrix filename
+   \return                    Malloc'd matrix (NULL on error)
+   
+   Read a mutation data matrix for number-encoded sequences into a new
+   MDMATRIX. The format is as for blNumericReadMDM(). Free with
+   blFreeMDMatrix().
+
+-  17.10.26 Original, based on blNumericReadMDM() 06.02.03   By: ACRM
+*/
+MDMATRIX *blNumericReadMDMatrix(char *mdmfile)
+{
+   FILE     *fp = NULL;
+   MDMATRIX *mdm;
+   int      i, j, size;
+   char     buffer[MAXBUFF],
+            word[16],
+            *p;
+   BOOL     noenv;
+
+   if((fp=blOpenFile(mdmfile, DATAENV, "r", &noenv))==NULL)
    {
-      return(FALSE);
+      return(NULL);
    }
 
    /* Read over any comment lines                                       */
-   while(fgets(buffer,MAXBUFF,mdm))
+   while(fgets(buffer,MAXBUFF,fp))
    {
       TERMINATE(buffer);
       KILLLEADSPACES(p,buffer);
@@ -279,21 +334,14 @@ BOOL blNumericReadMDM(char *mdmfile)
    }
 
    /* See how many fields there are in the buffer                       */
-   for(p = buffer, sMDMSize = 0; p!=NULL; sMDMSize++)
+   for(p = buffer, size = 0; p!=NULL; size++)
       p = blGetWord(p, word, 16);
 
-
-   /* Allocate memory for the MDM and the AA List                       */
-   if((sMDMScore = (int **)blArray2D(sizeof(int),sMDMSize,sMDMSize))==NULL)
-      return(FALSE);
-
-   /* Fill the matrix with zeros                                        */
-   for(i=0; i<sMDMSize; i++)
+   /* Allocate the matrix with all scores zero                          */
+   if((mdm = blAllocMDMatrix(size, FALSE))==NULL)
    {
-      for(j=0; j<sMDMSize; j++)
-      {
-         sMDMScore[i][j] = 0;
-      }
+      fclose(fp);
+      return(NULL);
    }
    
    i=0;
@@ -301,24 +349,41 @@ BOOL blNumericReadMDM(char *mdmfile)
    {
       TERMINATE(buffer);
       KILLLEADSPACES(p, buffer);
-      if(strlen(p))
+      if(strlen(p) && (i < size))
       {
          blGetWord(buffer, word, 16);
          if(sscanf(word,"%d",&j))    /* A row of numbers                */
          {
-            for(p = buffer, j = 0; p!=NULL && j<sMDMSize; j++)
+            for(p = buffer, j = 0; p!=NULL && j<size; j++)
             {
                p = blGetWord(p, word, 16);
-               sscanf(word,"%d",&(sMDMScore[i][j]));
+               sscanf(word,"%d",&(blMDMATRIXCELL(mdm, i, j)));
             }
             i++;
          }
       }
-   } while(fgets(buffer,MAXBUFF,mdm));
+   } while(fgets(buffer,MAXBUFF,fp));
    
-   fclose(mdm);
+   fclose(fp);
    
-   return(TRUE);
+   return(mdm);
+}
+
+
+/************************************************************************/
+/*>MDMATRIX *blGetDefaultNumericMDMatrix(void)
+   -------------------------------------------
+*//**
+   \return   The matrix read by blNumericReadMDM() (NULL if none)
+
+   Gives access to the default matrix used by blNumericAffineAlign()
+   and blNumericCalcMDMScore(). It must not be freed.
+
+-  17.10.26 Original   By: ACRM
+*/
+MDMATRIX *blGetDefaultNumericMDMatrix(void)
+{
+   return(sMDM);
 }
 
 /************************************************************************/
@@ -338,40 +403,35 @@ BOOL blNumericReadMDM(char *mdmfile)
 
 -  08.03.00 Original based on align.c/CalcMDMScore() 11.07.96 By: ACRM
 -  07.07.14 Use bl prefix for functions By: CTP
+-  17.10.26 Uses the default MDMATRIX and checks for tokens < 1
+            By: ACRM
 */
 int blNumericCalcMDMScore(int resa, int resb)
 {
-   int        i,j;
-   static int NWarn = 0;
-   BOOL       Warned = FALSE;
+   int  i,j;
+   BOOL Warned = FALSE;
 
    i = resa-1;
    j = resb-1;
    
-   if(i>=sMDMSize) 
+   if((sMDM == NULL) || (i < 0) || (i>=sMDM->size))
    {
-      if(NWarn < 10)
-         printf("Token %d not found in matrix\n",resa);
-      else if(NWarn == 10)
-         printf("More token not found in matrix...\n");
+      MissingToken(resa, &sNWarn);
       Warned = TRUE;
    }
-   if(j>=sMDMSize) 
+   if((sMDM == NULL) || (j < 0) || (j>=sMDM->size))
    {
-      if(NWarn < 10)
-         printf("Token %d not found in matrix\n",resb);
-      else if(NWarn == 10)
-         printf("More tokens not found in matrix...\n");
+      /* Only count one warning per call                                */
+      if(Warned)
+         sNWarn--;
+      MissingToken(resb, &sNWarn);
       Warned = TRUE;
    }
    
    if(Warned)
-   { 
-      NWarn++;
       return(0);
-   }
 
-   return(sMDMScore[i][j]);
+   return(blMDMATRIXCELL(sMDM, i, j));
 }                               
 
 /************************************************************************/
@@ -408,6 +468,8 @@ int blNumericCalcMDMScore(int resa, int resb)
 
 -  08.03.00 Original based on align.c/affinealign() 06.03.00 By: ACRM
 -  07.07.14 Use bl prefix for functions By: CTP
+-  17.10.26 Now a wrapper to NumericAffineAlignCore() using the 
+            default matrix   By: ACRM
 */
 int blNumericAffineAlign(int  *seq1, 
                          int  length1, 
@@ -420,9 +482,117 @@ int blNumericAffineAlign(int  *seq1,
                          int  *align1, 
                          int  *align2,
                          int  *align_len)
+{
+   return(NumericAffineAlignCore(sMDM, &sNWarn, 
+                                 seq1, length1, seq2, length2,
+                                 verbose, identity, penalty, penext,
+                                 align1, align2, align_len));
+}
+
+
+/************************************************************************/
+/*>int blNumericMDMatrixAffineAlign(MDMATRIX *mdm,
+                                    int *seq1, int length1, 
+                                    int *seq2, int length2, 
+                                    BOOL verbose, BOOL identity, 
+                                    int penalty, int penext, 
+                                    int *align1, int *align2, 
+                                    int *align_len)
+   ---------------------------------------------------------------------
+*//**
+   \param[in]     *mdm          Scoring matrix
+   \param[in]     *seq1         First sequence of tokens
+   \param[in]     length1       First sequence length
+   \param[in]     *seq2         Second sequence of tokens
+   \param[in]     length2       Second sequence length
+   \param[in]     verbose       Display N&W matrix
+   \param[in]     identity      Use identity matrix
+   \param[in]     penalty       Gap insertion penalty value
+   \param[in]     penext        Extension penalty
+   \param[out]    *align1       Sequence 1 aligned
+   \param[out]    *align2       Sequence 2 aligned
+   \param[out]    *align_len    Alignment length
+   \return                         Alignment score (0 on error)
+            
+   As blNumericAffineAlign(), but scores with the specified matrix
+   rather than the one read by blNumericReadMDM(). Tokens not in the
+   matrix score zero and no warnings are given.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blNumericMDMatrixAffineAlign(MDMATRIX *mdm,
+                                 int  *seq1, 
+                                 int  length1, 
+                                 int  *seq2, 
+                                 int  length2, 
+                                 BOOL verbose, 
+                                 BOOL identity, 
+                                 int  penalty, 
+                                 int  penext,
+                                 int  *align1, 
+                                 int  *align2,
+                                 int  *align_len)
+{
+   return(NumericAffineAlignCore(mdm, NULL, 
+                                 seq1, length1, seq2, length2,
+                                 verbose, identity, penalty, penext,
+                                 align1, align2, align_len));
+}
+
+
+/************************************************************************/
+/*>static int NumericAffineAlignCore(MDMATRIX *mdm, int *nWarn,
+                                     int *seq1, int length1, 
+                                     int *seq2, int length2, 
+                                     BOOL verbose, BOOL identity, 
+                                     int penalty, int penext, 
+                                     int *align1, int *align2, 
+                                     int *align_len)
+   ---------------------------------------------------------------------
+*//**
+   \param[in]     *mdm          Scoring matrix (may be NULL if 
+                                identity is set)
+   \param[in,out] *nWarn        Count of warnings about tokens missing
+                                from the matrix (NULL: don't warn)
+   \param[in]     *seq1         First sequence of tokens
+   \param[in]     length1       First sequence length
+   \param[in]     *seq2         Second sequence of tokens
+   \param[in]     length2       Second sequence length
+   \param[in]     verbose       Display N&W matrix
+   \param[in]     identity      Use identity matrix
+   \param[in]     penalty       Gap insertion penalty value
+   \param[in]     penext        Extension penalty
+   \param[out]    *align1       Sequence 1 aligned
+   \param[out]    *align2       Sequence 2 aligned
+   \param[out]    *align_len    Alignment length
+   \return                         Alignment score (0 on error)
+
+   Does the work for blNumericAffineAlign() and 
+   blNumericMDMatrixAffineAlign()
+
+-  08.03.00 Original based on align.c/affinealign() 06.03.00 By: ACRM
+-  07.07.14 Use bl prefix for functions By: CTP
+-  17.10.26 Moved from blNumericAffineAlign(). Takes the matrix as a
+            parameter and looks up each token once   By: ACRM
+*/
+static int NumericAffineAlignCore(MDMATRIX *mdm,
+                                  int  *nWarn,
+                                  int  *seq1, 
+                                  int  length1, 
+                                  int  *seq2, 
+                                  int  length2, 
+                                  BOOL verbose, 
+                                  BOOL identity, 
+                                  int  penalty, 
+                                  int  penext,
+                                  int  *align1, 
+                                  int  *align2,
+                                  int  *align_len)
 {
    XY    **dirn   = NULL;
    int   **matrix = NULL,
+         *row1    = NULL,
+         *col2    = NULL,
          maxdim,
          i,    j,    k,    l,
          i1,   j1,
@@ -435,11 +605,39 @@ int blNumericAffineAlign(int  *seq1,
    
    maxdim = MAX(length1, length2);
    
+   /* Look up the tokens in the scoring matrix once rather than for
+      every cell. row1[] and col2[] then index directly into the 
+      score table.
+   */
+   if(!identity)
+   {
+      if(mdm == NULL)
+         return(0);
+      if((row1 = NumericEncodeSequence(mdm, seq1, length1, 
+                                       mdm->size+1, nWarn))==NULL)
+         return(0);
+      if((col2 = NumericEncodeSequence(mdm, seq2, length2, 
+                                       1, nWarn))==NULL)
+      {
+         free(row1);
+         return(0);
+      }
+   }
+
    /* Initialise the score matrix                                       */
-   if((matrix = (int **)blArray2D(sizeof(int), maxdim, maxdim))==NULL)
-      return(0);
-   if((dirn   = (XY **)blArray2D(sizeof(XY), maxdim, maxdim))==NULL)
+   if(((matrix = (int **)blArray2D(sizeof(int), maxdim, maxdim))==NULL) ||
+      ((dirn   = (XY **)blArray2D(sizeof(XY), maxdim, maxdim))==NULL))
+   {
+      if(matrix != NULL)
+         blFreeArray2D((char **)matrix, maxdim, maxdim);
+      FREE(row1);
+      FREE(col2);
       return(0);
+   }
+
+   BLTIMERSTART(BLTIMER_ALIGN);
+   BLCOUNT(BLCOUNT_ALIGNMENTS, 1);
+   BLCOUNT(BLCOUNT_DP_CELLS, (ULONG)length1 * (ULONG)length2);
       
    for(i=0;i<maxdim;i++)
    {
@@ -460,8 +658,7 @@ int blNumericAffineAlign(int  *seq1,
       }
       else
       {
-         matrix[length1-1][j] = blNumericCalcMDMScore(seq1[length1-1], 
-                                                      seq2[j]);
+         matrix[length1-1][j] = mdm->score[row1[length1-1] + col2[j]];
       }
    }
 
@@ -474,8 +671,7 @@ int blNumericAffineAlign(int  *seq1,
       }
       else
       {
-         matrix[i][length2-1] = blNumericCalcMDMScore(seq1[i], 
-                                                      seq2[length2-1]);
+         matrix[i][length2-1] = mdm->score[row1[i] + col2[length2-1]];
       }
    }
 
@@ -558,7 +754,7 @@ int blNumericAffineAlign(int  *seq1,
          }
          else
          {
-            matrix[i1][j] += blNumericCalcMDMScore(seq1[i1],seq2[j]);
+            matrix[i1][j] += mdm->score[row1[i1] + col2[j]];
          }
       }
 
@@ -632,7 +828,7 @@ int blNumericAffineAlign(int  *seq1,
          }
          else
          {
-            matrix[i][j1] += blNumericCalcMDMScore(seq1[i],seq2[j1]);
+            matrix[i][j1] += mdm->score[row1[i] + col2[j1]];
          }
       }
    } 
@@ -665,10 +861,82 @@ int blNumericAffineAlign(int  *seq1,
     
    blFreeArray2D((char **)matrix, maxdim, maxdim);
    blFreeArray2D((char **)dirn,   maxdim, maxdim);
+   FREE(row1);
+   FREE(col2);
     
+   BLTIMERSTOP(BLTIMER_ALIGN);
    return(score);
 }
 
+
+/************************************************************************/
+/*>static int *NumericEncodeSequence(MDMATRIX *mdm, int *seq, 
+                                     int length, int stride, int *nWarn)
+   ---------------------------------------------------------------------
+*//**
+   \param[in]     *mdm       Scoring matrix
+   \param[in]     *seq       Sequence of tokens
+   \param[in]     length     Sequence length
+   \param[in]     stride     Multiplier for the matrix indexes
+   \param[in,out] *nWarn     Count of warnings given (NULL: don't warn)
+   \return                   Malloc'd array of indexes (NULL if no 
+                             memory)
+
+   Converts the tokens (which start from 1) to matrix indexes 
+   multiplied by stride. Tokens out of range give the index of the
+   zero row/column.
+
+-  17.10.26 Original   By: ACRM
+*/
+static int *NumericEncodeSequence(MDMATRIX *mdm, int *seq, int length,
+                                  int stride, int *nWarn)
+{
+   int *codes,
+       i;
+
+   if((codes = (int *)malloc(MAX(length,1) * sizeof(int)))==NULL)
+      return(NULL);
+
+   for(i=0; i<length; i++)
+   {
+      if((seq[i] >= 1) && (seq[i] <= mdm->size))
+      {
+         codes[i] = seq[i] - 1;
+      }
+      else
+      {
+         codes[i] = mdm->size;
+         if(nWarn != NULL)
+            MissingToken(seq[i], nWarn);
+      }
+      codes[i] *= stride;
+   }
+   
+   return(codes);
+}
+
+
+/************************************************************************/
+/*>static void MissingToken(int token, int *nWarn)
+   -----------------------------------------------
+*//**
+   \param[in]     token     Token not found in the matrix
+   \param[in,out] *nWarn    Count of warnings given
+
+   Warns that a token was not found. Only the first 10 are reported.
+
+-  17.10.26 Original, extracted from blNumericCalcMDMScore() By: ACRM
+*/
+static void MissingToken(int token, int *nWarn)
+{
+   if(*nWarn < 10)
+      printf("Token %d not found in matrix\n",token);
+   else if(*nWarn == 10)
+      printf("More tokens not found in matrix...\n");
+
+   (*nWarn)++;
+}
+
 /************************************************************************/
 /*>static int NumericTraceBack(int **matrix, XY **dirn, 
                                int length1, int length2, 
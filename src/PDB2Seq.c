@@ -3,12 +3,12 @@
 
    \file       PDB2Seq.c
    
-   \version    V1.16
-   \date       01.12.15
+   \version    V1.17
+   \date       17.10.26
    \brief      Conversion from PDB to sequence and other sequence
                related routines
    
-   \copyright  (c) UCL / Prof. Andrew C. R. Martin 1993-2021
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 1993-2026
    \author     Prof. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -69,6 +69,8 @@
 -  V1.14 07.07.14 Use bl prefix for functions By: CTP
 -  V1.15 01.12.15 Added blDoPDB2SeqByChain()  By: ACRM
 -  V1.16 03.11.21 HETATM PCA now handled as Q
+-  V1.17 17.10.26 Added blDoPDB2SeqView() and blDoPDB2SeqByChainView()
+                  which the linked list versions now call
 
 *************************************************************************/
 /* Doxygen
@@ -82,6 +84,12 @@
    #FUNCTION  blDoPDB2SeqByChain()
    Creates a hash indexed by chain label containing the 1-letter code
    sequence from an input PDB linked list.
+
+   #FUNCTION  blDoPDB2SeqView()
+   As blDoPDB2Seq() but works on the atoms of a PDBVIEW
+
+   #FUNCTION  blDoPDB2SeqByChainView()
+   As blDoPDB2SeqByChain() but works on the atoms of a PDBVIEW
 */
 /************************************************************************/
 /* Includes
@@ -92,6 +100,7 @@
 #include "macros.h"
 #include "pdb.h"
 #include "seq.h"
+#include "pdbview.h"
 
 
 /************************************************************************/
@@ -144,11 +153,44 @@
 -  04.02.14 Use CHAINMATCH By: CTP
 -  07.07.14 Use bl prefix for functions By: CTP
 -  03.11.21 HETATM/PCA -> Q  By: ACRM
+-  17.10.26 Now calls blDoPDB2SeqView()
 */
 char *blDoPDB2Seq(PDB *pdb, BOOL DoAsxGlx, BOOL ProtOnly, BOOL NoX)
+{
+   PDBVIEW view;
+
+   blInitPDBView(&view, pdb);
+
+   return(blDoPDB2SeqView(&view, DoAsxGlx, ProtOnly, NoX));
+}
+
+
+/************************************************************************/
+/*>char *blDoPDB2SeqView(PDBVIEW *view, BOOL DoAsxGlx, BOOL ProtOnly, 
+                         BOOL NoX)
+   -------------------------------------------------------------------
+*//**
+
+   \param[in]     *view    View onto a PDB linked list
+   \param[in]     DoAsxGlx Handle Asx and Glx as B and Z rather than X
+   \param[in]     ProtOnly Don't do DNA/RNA; these simply don't get
+                           done rather than being handled as X
+   \param[in]     NoX      Skip amino acids which would be assigned as X
+   \return                 Allocated character array containing sequence
+
+   As blDoPDB2Seq(), but takes the atoms from a view so that the 
+   sequence of (for example) a single chain or zone can be obtained 
+   without copying the atoms.
+
+-  29.09.92 Original (as blDoPDB2Seq())   By: ACRM
+-  17.10.26 Works on a PDBVIEW
+*/
+char *blDoPDB2SeqView(PDBVIEW *view, BOOL DoAsxGlx, BOOL ProtOnly, 
+                      BOOL NoX)
 {
    int   resnum,
          rescount,
+         i,
          NBreak    = 0;
    char  insert,
          chain[8],
@@ -156,18 +198,18 @@ char *blDoPDB2Seq(PDB *pdb, BOOL DoAsxGlx, BOOL ProtOnly, BOOL NoX)
    PDB   *p        = NULL;
    
    /* Sanity check                                                      */
-   if(pdb==NULL) return(NULL);
+   if((p=PDBVIEW_FIRST(view, i))==NULL) return(NULL);
 
    /* First step through the pdb linked list to see how many residues
       and chains.
       10.06.05 Fixed bug - was undercounting by one for CA-only chains
    */
    rescount = 1;
-   resnum   = pdb->resnum;
-   insert   = pdb->insert[0];
-   strcpy(chain,pdb->chain);
+   resnum   = p->resnum;
+   insert   = p->insert[0];
+   strcpy(chain,p->chain);
    
-   for(p=pdb->next; p!=NULL; NEXT(p))
+   for(p=PDBVIEW_NEXT(view, p, i); p!=NULL; p=PDBVIEW_NEXT(view, p, i))
    {
       if(p->resnum != resnum || p->insert[0] != insert)
       {
@@ -199,7 +241,7 @@ char *blDoPDB2Seq(PDB *pdb, BOOL DoAsxGlx, BOOL ProtOnly, BOOL NoX)
    if(sequence == NULL) return(NULL);
    
    /* Step through the pdb linked list again, setting sequence array    */
-   p = pdb;
+   p = PDBVIEW_FIRST(view, i);
 
    /* Skip an NTER residue                                              */
    /* 24.01.96 Added NULL check; occurs when no ATOM records present    */
@@ -221,7 +263,7 @@ char *blDoPDB2Seq(PDB *pdb, BOOL DoAsxGlx, BOOL ProtOnly, BOOL NoX)
       if(!strncmp(p->record_type,"HETATM",6) &&
          !strncmp(p->resnam,"PCA",3))
          break;
-      NEXT(p);
+      p = PDBVIEW_NEXT(view, p, i);
    }
    
    if(p==NULL)
@@ -246,7 +288,7 @@ char *blDoPDB2Seq(PDB *pdb, BOOL DoAsxGlx, BOOL ProtOnly, BOOL NoX)
    insert      = p->insert[0];
    strcpy(chain,p->chain);
 
-   for(p=p->next; p!=NULL; NEXT(p))
+   for(p=PDBVIEW_NEXT(view, p, i); p!=NULL; p=PDBVIEW_NEXT(view, p, i))
    {
       if(!strncmp(p->record_type,"ATOM  ",6) ||
          (!strncmp(p->record_type,"HETATM",6) &&
@@ -316,11 +358,43 @@ char *blDoPDB2Seq(PDB *pdb, BOOL DoAsxGlx, BOOL ProtOnly, BOOL NoX)
    
 -  30.11.15 Original based on blDoPDB2Seq()    By: ACRM
 -  03.11.21 HETATM/PCA -> Q
+-  17.10.26 Now calls blDoPDB2SeqByChainView()
 */
 HASHTABLE *blDoPDB2SeqByChain(PDB *pdb, BOOL DoAsxGlx, BOOL ProtOnly, 
                               BOOL NoX)
 {
-   int   lastresnum,
+   PDBVIEW view;
+
+   blInitPDBView(&view, pdb);
+
+   return(blDoPDB2SeqByChainView(&view, DoAsxGlx, ProtOnly, NoX));
+}
+
+
+/************************************************************************/
+/*>HASHTABLE *blDoPDB2SeqByChainView(PDBVIEW *view, BOOL DoAsxGlx, 
+                                     BOOL ProtOnly, BOOL NoX)
+   ---------------------------------------------------------------
+*//**
+
+   \param[in]     *view    View onto a PDB linked list
+   \param[in]     DoAsxGlx Handle Asx and Glx as B and Z rather than X
+   \param[in]     ProtOnly Don't do DNA/RNA; these simply don't get
+                           done rather than being handled as X
+   \param[in]     NoX      Skip amino acids which would be assigned as X
+   \return                 A hash of 1-letter code sequences indexed by
+                           chain label
+
+   As blDoPDB2SeqByChain(), but takes the atoms from a view.
+
+-  30.11.15 Original (as blDoPDB2SeqByChain())   By: ACRM
+-  17.10.26 Works on a PDBVIEW
+*/
+HASHTABLE *blDoPDB2SeqByChainView(PDBVIEW *view, BOOL DoAsxGlx, 
+                                  BOOL ProtOnly, BOOL NoX)
+{
+   int   i,
+         lastresnum,
          nres       = 0,
          ArraySize  = ALLOCSIZE;
    char  lastinsert[blMAXCHAINLABEL],
@@ -334,7 +408,7 @@ HASHTABLE *blDoPDB2SeqByChain(PDB *pdb, BOOL DoAsxGlx, BOOL ProtOnly,
    strcpy(lastinsert, "z");
    
    /* Sanity check                                                      */
-   if(pdb==NULL) return(NULL);
+   if((p=PDBVIEW_FIRST(view, i))==NULL) return(NULL);
 
    /* Initialize hash with 11 bins                                      */
    if((hash = blInitializeHash(11))==NULL)
@@ -346,10 +420,10 @@ HASHTABLE *blDoPDB2SeqByChain(PDB *pdb, BOOL DoAsxGlx, BOOL ProtOnly,
    sequence[0]  = '\0';
 
    /* Initialize chain label                                            */
-   strncpy(lastchain, pdb->chain, blMAXCHAINLABEL);
+   strncpy(lastchain, p->chain, blMAXCHAINLABEL);
 
    /* Step through the PDB linked list                                  */
-   for(p=pdb; p!=NULL; NEXT(p))
+   for(p=PDBVIEW_FIRST(view, i); p!=NULL; p=PDBVIEW_NEXT(view, p, i))
    {
       /* Only interested in ATOM records and HETATM/PCA                 */
       if(!strncmp(p->record_type, "ATOM  ", 6) ||
@@ -0,0 +1,604 @@
+/************************************************************************/
+/**
+
+   \file       PDBAttrib.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Typed per-atom attribute columns for a PDB linked list
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   The extras field of the PDB structure, together with
+   CREATEPDBEXTRAS() and FREEPDBEXTRAS(), allows data to be attached to
+   each atom, but needs one allocation per atom and a pointer
+   dereference for every access.
+
+   A PDBATTRIBS table instead holds any number of named, typed columns
+   (REAL, int or fixed width string) for the atoms of a linked list.
+   Each column is a single array indexed by the ordinal of the atom in
+   the linked list at the time the table was created. Values may be
+   accessed by ordinal with the PDBATTRIB_XXXXVAL() macros or from a
+   PDB pointer with the blGetPDBAttribXXXX() and blSetPDBAttribXXXX()
+   routines; the latter find the ordinal by bisection.
+
+   The table refers to the atoms of the linked list but does not own
+   them. Atoms added afterwards, or in a copy of the list, have no
+   attributes. Columns may be emitted as PDBML tags by registering them
+   with blAddPDBAttribTag() (see PDBTagVars.c).
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   PDBATTRIBS *attribs;
+   int        col, i;
+
+   attribs = blCreatePDBAttribs(pdb);
+   col     = blAddPDBAttrib(attribs, "energy", PDBATTRIB_REAL, 0);
+   for(i=0; i<attribs->natoms; i++)
+      PDBATTRIB_REALVAL(attribs, col, i) =
+         CalcEnergy(attribs->atoms[i]);
+   ...
+   blFreePDBAttribs(attribs);
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP Attribute columns
+
+   #FUNCTION  blCreatePDBAttribs()
+   Creates an empty attribute table for a PDB linked list
+
+   #FUNCTION  blFreePDBAttribs()
+   Frees an attribute table
+
+   #FUNCTION  blAddPDBAttrib()
+   Adds a named, typed column to an attribute table
+
+   #FUNCTION  blFindPDBAttrib()
+   Finds a column by name
+
+   #FUNCTION  blGetPDBAttribOrdinal()
+   Finds the ordinal of an atom in an attribute table
+
+   #FUNCTION  blSetPDBAttribReal()
+   Sets a REAL attribute for an atom
+
+   #FUNCTION  blSetPDBAttribInt()
+   Sets an int attribute for an atom
+
+   #FUNCTION  blSetPDBAttribString()
+   Sets a string attribute for an atom
+
+   #FUNCTION  blGetPDBAttribReal()
+   Gets a REAL attribute for an atom
+
+   #FUNCTION  blGetPDBAttribInt()
+   Gets an int attribute for an atom
+
+   #FUNCTION  blGetPDBAttribString()
+   Gets a string attribute for an atom
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdlib.h>
+#include <string.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "pdb.h"
+#include "pdbattrib.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define ATTRIBCOLSTEP 8      /* Step for allocating columns             */
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static int CmpAttribMap(const void *a, const void *b);
+static BOOL ValidColumn(PDBATTRIBS *attribs, int col, int type);
+
+
+/************************************************************************/
+/*>static int CmpAttribMap(const void *a, const void *b)
+   -----------------------------------------------------
+*//**
+
+   qsort()/bsearch() comparison on the atom pointer of a PDBATTRIBMAP
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CmpAttribMap(const void *a, const void *b)
+{
+   PDB *pa = ((PDBATTRIBMAP *)a)->p,
+       *pb = ((PDBATTRIBMAP *)b)->p;
+
+   if(pa < pb) return(-1);
+   if(pa > pb) return(1);
+   return(0);
+}
+
+
+/************************************************************************/
+/*>static BOOL ValidColumn(PDBATTRIBS *attribs, int col, int type)
+   ---------------------------------------------------------------
+*//**
+
+   \param[in]     *attribs  Attribute table
+   \param[in]     col       Column number
+   \param[in]     type      Required type (PDBATTRIB_XXXX)
+   \return                  Column exists and is of the required type
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL ValidColumn(PDBATTRIBS *attribs, int col, int type)
+{
+   return((attribs != NULL) && (col >= 0) && (col < attribs->ncols) &&
+          (attribs->cols[col].type == type));
+}
+
+
+/************************************************************************/
+/*>PDBATTRIBS *blCreatePDBAttribs(PDB *pdb)
+   ----------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \return                 Malloc'd attribute table or NULL on error
+
+   Creates an attribute table, with no columns, for the atoms of a PDB
+   linked list. Atoms are numbered from 0 in linked list order.
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBATTRIBS *blCreatePDBAttribs(PDB *pdb)
+{
+   PDBATTRIBS *attribs;
+   PDB        *p;
+   int        natoms = 0,
+              i;
+   BOOL       sorted = TRUE;
+
+   for(p=pdb; p!=NULL; NEXT(p))
+      natoms++;
+
+   if((attribs=(PDBATTRIBS *)malloc(sizeof(PDBATTRIBS)))==NULL)
+      return(NULL);
+   attribs->natoms  = natoms;
+   attribs->ncols   = 0;
+   attribs->maxcols = 0;
+   attribs->cols    = NULL;
+   attribs->atoms   = (PDB **)malloc((natoms+1) * sizeof(PDB *));
+   attribs->map     = (PDBATTRIBMAP *)malloc((natoms+1) *
+                                             sizeof(PDBATTRIBMAP));
+   if((attribs->atoms == NULL) || (attribs->map == NULL))
+   {
+      blFreePDBAttribs(attribs);
+      return(NULL);
+   }
+
+   for(p=pdb, i=0; p!=NULL; NEXT(p), i++)
+   {
+      attribs->atoms[i]       = p;
+      attribs->map[i].p       = p;
+      attribs->map[i].ordinal = i;
+      if(i && (p < attribs->map[i-1].p))
+         sorted = FALSE;
+   }
+
+   /* Atoms read from a file are usually allocated in order, so the
+      sort is often not needed
+   */
+   if(!sorted)
+      qsort(attribs->map, natoms, sizeof(PDBATTRIBMAP), CmpAttribMap);
+
+   return(attribs);
+}
+
+
+/************************************************************************/
+/*>void blFreePDBAttribs(PDBATTRIBS *attribs)
+   ------------------------------------------
+*//**
+
+   \param[in]     *attribs  Attribute table
+
+   Frees an attribute table and all its columns. The PDB linked list
+   is not affected.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreePDBAttribs(PDBATTRIBS *attribs)
+{
+   int i;
+
+   if(attribs == NULL)
+      return;
+
+   for(i=0; i<attribs->ncols; i++)
+   {
+      FREE(attribs->cols[i].reals);
+      FREE(attribs->cols[i].ints);
+      FREE(attribs->cols[i].strings);
+   }
+   FREE(attribs->cols);
+   FREE(attribs->atoms);
+   FREE(attribs->map);
+   free(attribs);
+}
+
+
+/************************************************************************/
+/*>int blAddPDBAttrib(PDBATTRIBS *attribs, char *name, int type,
+                      int width)
+   -------------------------------------------------------------
+*//**
+
+   \param[in,out] *attribs  Attribute table
+   \param[in]     *name     Column name
+   \param[in]     type      PDBATTRIB_REAL, PDBATTRIB_INT or
+                            PDBATTRIB_STRING
+   \param[in]     width     Maximum string length for PDBATTRIB_STRING
+                            (ignored for other types)
+   \return                  Column number or -1 on error
+
+   Adds a column to an attribute table. REAL and int values are set to
+   zero and strings are blank. If a column of this name and type
+   already exists, its number is returned and it is not changed. It is
+   an error for it to exist with a different type or string width.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blAddPDBAttrib(PDBATTRIBS *attribs, char *name, int type, int width)
+{
+   PDBATTRIBCOL *col;
+   int          n,
+                i;
+
+   if((attribs == NULL) || (name == NULL) ||
+      (strlen(name) >= MAXPDBATTRIBNAME))
+      return(-1);
+
+   if(type != PDBATTRIB_STRING)
+      width = 0;
+   else if(width < 1)
+      return(-1);
+
+   if((n = blFindPDBAttrib(attribs, name)) >= 0)
+   {
+      if((attribs->cols[n].type != type) ||
+         (attribs->cols[n].width != width))
+         return(-1);
+      return(n);
+   }
+
+   if(attribs->ncols >= attribs->maxcols)
+   {
+      PDBATTRIBCOL *newCols;
+      if((newCols = (PDBATTRIBCOL *)
+          realloc(attribs->cols, (attribs->maxcols + ATTRIBCOLSTEP) *
+                  sizeof(PDBATTRIBCOL)))==NULL)
+         return(-1);
+      attribs->cols     = newCols;
+      attribs->maxcols += ATTRIBCOLSTEP;
+   }
+
+   n   = attribs->ncols;
+   col = &(attribs->cols[n]);
+   col->reals   = NULL;
+   col->ints    = NULL;
+   col->strings = NULL;
+   col->type    = type;
+   col->width   = width;
+   strcpy(col->name, name);
+
+   /* Allocate one spare item so that an empty list is not a special
+      case
+   */
+   switch(type)
+   {
+   case PDBATTRIB_REAL:
+      if((col->reals = (REAL *)malloc((attribs->natoms+1) *
+                                      sizeof(REAL)))==NULL)
+         return(-1);
+      for(i=0; i<attribs->natoms; i++)
+         col->reals[i] = (REAL)0.0;
+      break;
+   case PDBATTRIB_INT:
+      if((col->ints = (int *)calloc(attribs->natoms+1,
+                                    sizeof(int)))==NULL)
+         return(-1);
+      break;
+   case PDBATTRIB_STRING:
+      if((col->strings = (char *)calloc((attribs->natoms+1) * (width+1),
+                                        sizeof(char)))==NULL)
+         return(-1);
+      break;
+   default:
+      return(-1);
+   }
+
+   attribs->ncols++;
+   return(n);
+}
+
+
+/************************************************************************/
+/*>int blFindPDBAttrib(PDBATTRIBS *attribs, char *name)
+   ----------------------------------------------------
+*//**
+
+   \param[in]     *attribs  Attribute table
+   \param[in]     *name     Column name
+   \return                  Column number or -1 if not found
+
+-  17.10.26 Original   By: ACRM
+*/
+int blFindPDBAttrib(PDBATTRIBS *attribs, char *name)
+{
+   int i;
+
+   if((attribs == NULL) || (name == NULL))
+      return(-1);
+
+   for(i=0; i<attribs->ncols; i++)
+   {
+      if(!strcmp(attribs->cols[i].name, name))
+         return(i);
+   }
+   return(-1);
+}
+
+
+/************************************************************************/
+/*>int blGetPDBAttribOrdinal(PDBATTRIBS *attribs, PDB *p)
+   ------------------------------------------------------
+*//**
+
+   \param[in]     *attribs  Attribute table
+   \param[in]     *p        Atom
+   \return                  Ordinal of the atom or -1 if it is not in
+                            the table
+
+   Finds the position of an atom in the linked list from which an
+   attribute table was created. This takes O(log n) time.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blGetPDBAttribOrdinal(PDBATTRIBS *attribs, PDB *p)
+{
+   PDBATTRIBMAP key,
+                *found;
+
+   if((attribs == NULL) || (p == NULL))
+      return(-1);
+
+   key.p = p;
+   if((found = (PDBATTRIBMAP *)bsearch(&key, attribs->map,
+                                       attribs->natoms,
+                                       sizeof(PDBATTRIBMAP),
+                                       CmpAttribMap))==NULL)
+      return(-1);
+   return(found->ordinal);
+}
+
+
+/************************************************************************/
+/*>BOOL blSetPDBAttribReal(PDBATTRIBS *attribs, int col, PDB *p,
+                           REAL value)
+   -------------------------------------------------------------
+*//**
+
+   \param[in,out] *attribs  Attribute table
+   \param[in]     col       Column number
+   \param[in]     *p        Atom
+   \param[in]     value     Value to store
+   \return                  Success. Fails if the column is not of type
+                            PDBATTRIB_REAL or the atom is not in the
+                            table
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blSetPDBAttribReal(PDBATTRIBS *attribs, int col, PDB *p, REAL value)
+{
+   int i;
+
+   if(!ValidColumn(attribs, col, PDBATTRIB_REAL) ||
+      ((i = blGetPDBAttribOrdinal(attribs, p)) < 0))
+      return(FALSE);
+
+   PDBATTRIB_REALVAL(attribs, col, i) = value;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>BOOL blSetPDBAttribInt(PDBATTRIBS *attribs, int col, PDB *p,
+                          int value)
+   ------------------------------------------------------------
+*//**
+
+   \param[in,out] *attribs  Attribute table
+   \param[in]     col       Column number
+   \param[in]     *p        Atom
+   \param[in]     value     Value to store
+   \return                  Success. Fails if the column is not of type
+                            PDBATTRIB_INT or the atom is not in the
+                            table
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blSetPDBAttribInt(PDBATTRIBS *attribs, int col, PDB *p, int value)
+{
+   int i;
+
+   if(!ValidColumn(attribs, col, PDBATTRIB_INT) ||
+      ((i = blGetPDBAttribOrdinal(attribs, p)) < 0))
+      return(FALSE);
+
+   PDBATTRIB_INTVAL(attribs, col, i) = value;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>BOOL blSetPDBAttribString(PDBATTRIBS *attribs, int col, PDB *p,
+                             char *value)
+   ---------------------------------------------------------------
+*//**
+
+   \param[in,out] *attribs  Attribute table
+   \param[in]     col       Column number
+   \param[in]     *p        Atom
+   \param[in]     *value    Value to store. Truncated to the column
+                            width if necessary
+   \return                  Success. Fails if the column is not of type
+                            PDBATTRIB_STRING or the atom is not in the
+                            table
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blSetPDBAttribString(PDBATTRIBS *attribs, int col, PDB *p,
+                          char *value)
+{
+   char *dest;
+   int  i,
+        len;
+
+   if(!ValidColumn(attribs, col, PDBATTRIB_STRING) ||
+      ((i = blGetPDBAttribOrdinal(attribs, p)) < 0))
+      return(FALSE);
+
+   dest = PDBATTRIB_STRINGVAL(attribs, col, i);
+   len  = (value == NULL) ? 0 : strlen(value);
+   if(len > attribs->cols[col].width)
+      len = attribs->cols[col].width;
+   if(len)
+      memcpy(dest, value, len);
+   dest[len] = '\0';
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>REAL blGetPDBAttribReal(PDBATTRIBS *attribs, int col, PDB *p)
+   -------------------------------------------------------------
+*//**
+
+   \param[in]     *attribs  Attribute table
+   \param[in]     col       Column number
+   \param[in]     *p        Atom
+   \return                  Value; zero if the column is not of type
+                            PDBATTRIB_REAL or the atom is not in the
+                            table
+
+-  17.10.26 Original   By: ACRM
+*/
+REAL blGetPDBAttribReal(PDBATTRIBS *attribs, int col, PDB *p)
+{
+   int i;
+
+   if(!ValidColumn(attribs, col, PDBATTRIB_REAL) ||
+      ((i = blGetPDBAttribOrdinal(attribs, p)) < 0))
+      return((REAL)0.0);
+
+   return(PDBATTRIB_REALVAL(attribs, col, i));
+}
+
+
+/************************************************************************/
+/*>int blGetPDBAttribInt(PDBATTRIBS *attribs, int col, PDB *p)
+   -----------------------------------------------------------
+*//**
+
+   \param[in]     *attribs  Attribute table
+   \param[in]     col       Column number
+   \param[in]     *p        Atom
+   \return                  Value; zero if the column is not of type
+                            PDBATTRIB_INT or the atom is not in the
+                            table
+
+-  17.10.26 Original   By: ACRM
+*/
+int blGetPDBAttribInt(PDBATTRIBS *attribs, int col, PDB *p)
+{
+   int i;
+
+   if(!ValidColumn(attribs, col, PDBATTRIB_INT) ||
+      ((i = blGetPDBAttribOrdinal(attribs, p)) < 0))
+      return(0);
+
+   return(PDBATTRIB_INTVAL(attribs, col, i));
+}
+
+
+/************************************************************************/
+/*>char *blGetPDBAttribString(PDBATTRIBS *attribs, int col, PDB *p)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in]     *attribs  Attribute table
+   \param[in]     col       Column number
+   \param[in]     *p        Atom
+   \return                  Pointer to the value in the table; NULL if
+                            the column is not of type PDBATTRIB_STRING
+                            or the atom is not in the table
+
+-  17.10.26 Original   By: ACRM
+*/
+char *blGetPDBAttribString(PDBATTRIBS *attribs, int col, PDB *p)
+{
+   int i;
+
+   if(!ValidColumn(attribs, col, PDBATTRIB_STRING) ||
+      ((i = blGetPDBAttribOrdinal(attribs, p)) < 0))
+      return(NULL);
+
+   return(PDBATTRIB_STRINGVAL(attribs, col, i));
+}
@@ -0,0 +1,990 @@
+/************************************************************************/
+/**
+
+   \file       PDBCompact.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Compact array representation of PDB atoms
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   The PDB structure is designed for flexibility rather than size: it
+   holds double precision coordinates, eight character name fields and
+   a fixed array of MAXCONECT pointers for CONECT data, so each atom
+   occupies several hundred bytes. For read-only analysis of large
+   structures or trajectories this can dominate memory use.
+
+   A PDBCOMPACT holds the atoms as a single array of PDBATOMC records
+   using single precision coordinates and packed name fields. Chain
+   labels and record types are interned in a string table and CONECT
+   data are held out of line in compressed sparse row form, so atoms
+   without CONECTs cost nothing for them. A typical atom takes 56
+   bytes rather than the 312 of a PDB record (on a 64-bit machine).
+
+   The following PDB fields are not kept and are reset to their
+   defaults by blCompactToPDB(): access, radius, partial_charge,
+   extras, atomInfo, atomtype and entity_id. Insert codes are a single
+   character and atom names, residue names and segment IDs are limited
+   to 4 characters as in a PDB file.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   PDBCOMPACT *cpdb;
+   VEC3F      cg;
+   int        natoms;
+
+   cpdb = blReadPDBCompact(fp, &natoms);
+   blGetCofGPDBCompact(cpdb, &cg);
+   blFreePDBCompact(cpdb);
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP Compact storage
+
+   #FUNCTION  blPDBToCompact()
+   Creates a compact copy of a PDB linked list
+
+   #FUNCTION  blCompactToPDB()
+   Creates a PDB linked list from a compact copy
+
+   #FUNCTION  blReadPDBCompact()
+   Reads a PDB file into compact storage
+
+   #FUNCTION  blFreePDBCompact()
+   Frees compact storage
+
+   #FUNCTION  blPDBCompactMemory()
+   Reports the memory used by compact storage
+
+   #FUNCTION  blPDBMemory()
+   Reports the memory used by a PDB linked list
+
+   #FUNCTION  blGetCofGPDBCompact()
+   Compact equivalent of blGetCofGPDB()
+
+   #FUNCTION  blTranslatePDBCompact()
+   Compact equivalent of blTranslatePDB()
+
+   #FUNCTION  blApplyMatrixPDBCompact()
+   Compact equivalent of blApplyMatrixPDB()
+
+   #FUNCTION  blCalcRMSPDBCompact()
+   Compact equivalent of blCalcRMSPDB()
+
+   #FUNCTION  blFitPDBCompact()
+   Fits one compact structure onto another
+
+   #FUNCTION  blDoPDB2SeqCompact()
+   Compact equivalent of blDoPDB2Seq()
+
+   #FUNCTION  blDoPDB2SeqByChainCompact()
+   Compact equivalent of blDoPDB2SeqByChain()
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "pdb.h"
+#include "fit.h"
+#include "hash.h"
+#include "seq.h"
+#include "pdbcompact.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define MAXCOMPACTSTRINGS 65535   /* Limited by unsigned short indexes  */
+
+/* Used to map CONECT pointers to atom indexes                          */
+typedef struct
+{
+   PDB *p;
+   int index;
+}  ATOMPTRINDEX;
+
+#define PACK(dest, src) PackField((dest), (src), sizeof(dest))
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static int InternString(PDBCOMPACT *cpdb, HASHTABLE *hash, int *maxstr,
+                        char *string);
+static BOOL BuildCompactConects(PDBCOMPACT *cpdb, PDB *pdb);
+static int CmpAtomPtr(const void *a, const void *b);
+static PDB *CompactResidueList(PDBCOMPACT *cpdb);
+static void PackField(char *dest, char *src, int width);
+
+
+/************************************************************************/
+/*>static int InternString(PDBCOMPACT *cpdb, HASHTABLE *hash,
+                           int *maxstr, char *string)
+   ------------------------------------------------------------
+*//**
+
+   \param[in,out] *cpdb    Compact structure
+   \param[in,out] *hash    Hash of strings already stored
+   \param[in,out] *maxstr  Allocated size of cpdb->strings
+   \param[in]     *string  String to store
+   \return                 Index of the string or -1 on error
+
+   Returns the index of a string in the string table, adding it if it
+   is not already there.
+
+-  17.10.26 Original   By: ACRM
+*/
+static int InternString(PDBCOMPACT *cpdb, HASHTABLE *hash, int *maxstr,
+                        char *string)
+{
+   char **newStrings;
+
+   if(blHashKeyDefined(hash, string))
+      return(blGetHashValueInt(hash, string));
+
+   if(cpdb->nstrings >= MAXCOMPACTSTRINGS)
+      return(-1);
+
+   if(cpdb->nstrings >= *maxstr)
+   {
+      *maxstr += 16;
+      if((newStrings=(char **)realloc(cpdb->strings,
+                                      *maxstr * sizeof(char *)))==NULL)
+         return(-1);
+      cpdb->strings = newStrings;
+   }
+
+   if((cpdb->strings[cpdb->nstrings] =
+       (char *)malloc((strlen(string)+1) * sizeof(char)))==NULL)
+      return(-1);
+   strcpy(cpdb->strings[cpdb->nstrings], string);
+
+   if(!blSetHashValueInt(hash, string, cpdb->nstrings))
+   {
+      free(cpdb->strings[cpdb->nstrings]);
+      return(-1);
+   }
+
+   return(cpdb->nstrings++);
+}
+
+
+/************************************************************************/
+/*>static void PackField(char *dest, char *src, int width)
+   -------------------------------------------------------
+*//**
+
+   \param[out]    *dest    Packed field
+   \param[in]     *src     Null-terminated string
+   \param[in]     width    Width of the packed field
+
+   Copies a string into a fixed width field, padding with nulls. The
+   result is not terminated if the string fills the field.
+
+-  17.10.26 Original   By: ACRM
+*/
+static void PackField(char *dest, char *src, int width)
+{
+   int i;
+
+   for(i=0; i<width && src[i]; i++)
+      dest[i] = src[i];
+   for(; i<width; i++)
+      dest[i] = '\0';
+}
+
+
+/************************************************************************/
+/*>static int CmpAtomPtr(const void *a, const void *b)
+   ---------------------------------------------------
+*//**
+
+   qsort()/bsearch() comparison on the atom pointer of an ATOMPTRINDEX
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CmpAtomPtr(const void *a, const void *b)
+{
+   PDB *pa = ((ATOMPTRINDEX *)a)->p,
+       *pb = ((ATOMPTRINDEX *)b)->p;
+
+   if(pa < pb) return(-1);
+   if(pa > pb) return(1);
+   return(0);
+}
+
+
+/************************************************************************/
+/*>static BOOL BuildCompactConects(PDBCOMPACT *cpdb, PDB *pdb)
+   -----------------------------------------------------------
+*//**
+
+   \param[in,out] *cpdb    Compact structure with atoms filled in
+   \param[in]     *pdb     The PDB linked list it was made from
+   \return                 Success
+
+   Converts the CONECT pointers of the linked list to compressed sparse
+   row form. Pointers to atoms that are not in the linked list are
+   dropped. Nothing is allocated if there are no CONECTs.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL BuildCompactConects(PDBCOMPACT *cpdb, PDB *pdb)
+{
+   ATOMPTRINDEX *map = NULL,
+                key,
+                *found;
+   PDB          *p;
+   int          i, j,
+                nconect = 0;
+
+   for(p=pdb; p!=NULL; NEXT(p))
+      nconect += p->nConect;
+   if(nconect == 0)
+      return(TRUE);
+
+   if(((cpdb->conectStart=(int *)malloc((cpdb->natoms+1) *
+                                        sizeof(int)))==NULL) ||
+      ((cpdb->conect=(int *)malloc(nconect * sizeof(int)))==NULL) ||
+      ((map=(ATOMPTRINDEX *)malloc(cpdb->natoms *
+                                   sizeof(ATOMPTRINDEX)))==NULL))
+      return(FALSE);
+
+   /* Sorted table of pointers so we can find the index of an atom      */
+   for(p=pdb, i=0; p!=NULL; NEXT(p), i++)
+   {
+      map[i].p     = p;
+      map[i].index = i;
+   }
+   qsort(map, cpdb->natoms, sizeof(ATOMPTRINDEX), CmpAtomPtr);
+
+   nconect = 0;
+   for(p=pdb, i=0; p!=NULL; NEXT(p), i++)
+   {
+      cpdb->conectStart[i] = nconect;
+      for(j=0; j<p->nConect; j++)
+      {
+         key.p = p->conect[j];
+         if((key.p != NULL) &&
+            ((found=(ATOMPTRINDEX *)bsearch(&key, map, cpdb->natoms,
+                                            sizeof(ATOMPTRINDEX),
+                                            CmpAtomPtr))!=NULL))
+         {
+            cpdb->conect[nconect++] = found->index;
+         }
+      }
+   }
+   cpdb->conectStart[cpdb->natoms] = nconect;
+
+   free(map);
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>PDBCOMPACT *blPDBToCompact(PDB *pdb)
+   ------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \return                 Malloc'd compact structure or NULL on error
+
+   Creates a compact copy of a PDB linked list. The linked list is not
+   changed and may be freed afterwards. See the file description for
+   the fields that are not kept.
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBCOMPACT *blPDBToCompact(PDB *pdb)
+{
+   PDBCOMPACT *cpdb;
+   HASHTABLE  *hash;
+   PDBATOMC   *a;
+   PDB        *p;
+   int        i,
+              chain,
+              record,
+              maxstr = 0;
+
+   if((cpdb=(PDBCOMPACT *)malloc(sizeof(PDBCOMPACT)))==NULL)
+      return(NULL);
+   cpdb->atoms       = NULL;
+   cpdb->strings     = NULL;
+   cpdb->conectStart = NULL;
+   cpdb->conect      = NULL;
+   cpdb->nstrings    = 0;
+   cpdb->natoms      = 0;
+
+   for(p=pdb; p!=NULL; NEXT(p))
+      cpdb->natoms++;
+
+   if(((cpdb->atoms=(PDBATOMC *)malloc(((cpdb->natoms>0)?cpdb->natoms:1)
+                                       * sizeof(PDBATOMC)))==NULL) ||
+      ((hash=blInitializeHash(0))==NULL))
+   {
+      blFreePDBCompact(cpdb);
+      return(NULL);
+   }
+
+   for(p=pdb, i=0; p!=NULL; NEXT(p), i++)
+   {
+      if(((chain=InternString(cpdb, hash, &maxstr, p->chain)) < 0) ||
+         ((record=InternString(cpdb, hash, &maxstr, p->record_type))<0))
+      {
+         blFreeHash(hash);
+         blFreePDBCompact(cpdb);
+         return(NULL);
+      }
+
+      a = cpdb->atoms + i;
+      a->x             = (float)p->x;
+      a->y             = (float)p->y;
+      a->z             = (float)p->z;
+      a->occ           = (float)p->occ;
+      a->bval          = (float)p->bval;
+      a->atnum         = p->atnum;
+      a->resnum        = p->resnum;
+      a->chain         = (unsigned short)chain;
+      a->record_type   = (unsigned short)record;
+      a->insert        = p->insert[0];
+      a->altpos        = p->altpos;
+      a->secstr        = p->secstr;
+      a->formal_charge = (signed char)p->formal_charge;
+      PACK(a->atnam,     p->atnam);
+      PACK(a->atnam_raw, p->atnam_raw);
+      PACK(a->resnam,    p->resnam);
+      PACK(a->segid,     p->segid);
+      PACK(a->element,   p->element);
+   }
+   blFreeHash(hash);
+
+   if(!BuildCompactConects(cpdb, pdb))
+   {
+      blFreePDBCompact(cpdb);
+      return(NULL);
+   }
+
+   return(cpdb);
+}
+
+
+/************************************************************************/
+/*>PDB *blCompactToPDB(PDBCOMPACT *cpdb)
+   -------------------------------------
+*//**
+
+   \param[in]     *cpdb    Compact structure
+   \return                 PDB linked list or NULL on error
+
+   Creates a PDB linked list from a compact structure, including the
+   CONECT data. Coordinates, occupancies and B-values have single
+   precision; fields that are not kept in compact storage take the
+   values set by CLEAR_PDB(). CONECTs beyond MAXCONECT for an atom are
+   dropped.
+
+-  17.10.26 Original   By: ACRM
+*/
+PDB *blCompactToPDB(PDBCOMPACT *cpdb)
+{
+   PDB      *pdb = NULL,
+            *p   = NULL,
+            **indx;
+   PDBATOMC *a;
+   int      i, j;
+
+   if((cpdb==NULL) || (cpdb->natoms==0))
+      return(NULL);
+
+   if((indx=(PDB **)malloc(cpdb->natoms * sizeof(PDB *)))==NULL)
+      return(NULL);
+
+   for(i=0; i<cpdb->natoms; i++)
+   {
+      if(pdb==NULL)
+      {
+         INIT(pdb, PDB);
+         p = pdb;
+      }
+      else
+      {
+         ALLOCNEXT(p, PDB);
+      }
+      if(p==NULL)
+      {
+         FREELIST(pdb, PDB);
+         free(indx);
+         return(NULL);
+      }
+      indx[i] = p;
+
+      a = cpdb->atoms + i;
+      CLEAR_PDB(p);
+      p->x              = (REAL)a->x;
+      p->y              = (REAL)a->y;
+      p->z              = (REAL)a->z;
+      p->occ            = (REAL)a->occ;
+      p->bval           = (REAL)a->bval;
+      p->atnum          = a->atnum;
+      p->resnum         = a->resnum;
+      p->formal_charge  = a->formal_charge;
+      p->partial_charge = (REAL)a->formal_charge;
+      p->altpos         = a->altpos;
+      p->secstr         = a->secstr;
+      p->insert[0]      = a->insert;
+      p->insert[1]      = '\0';
+      strcpy(p->chain,       cpdb->strings[a->chain]);
+      strcpy(p->record_type, cpdb->strings[a->record_type]);
+      PDBC_UNPACK(p->atnam,     a->atnam);
+      PDBC_UNPACK(p->atnam_raw, a->atnam_raw);
+      PDBC_UNPACK(p->resnam,    a->resnam);
+      PDBC_UNPACK(p->segid,     a->segid);
+      PDBC_UNPACK(p->element,   a->element);
+   }
+
+   if(cpdb->conectStart != NULL)
+   {
+      for(i=0; i<cpdb->natoms; i++)
+      {
+         for(j=cpdb->conectStart[i]; j<cpdb->conectStart[i+1]; j++)
+            blAddOneDirectionConect(indx[i], indx[cpdb->conect[j]]);
+      }
+   }
+
+   free(indx);
+   return(pdb);
+}
+
+
+/************************************************************************/
+/*>PDBCOMPACT *blReadPDBCompact(FILE *fp, int *natom)
+   --------------------------------------------------
+*//**
+
+   \param[in]     *fp      PDB file pointer
+   \param[out]    *natom   Number of atoms read
+   \return                 Compact structure or NULL on error
+
+   Reads a PDB file (as blReadPDB()) straight into compact storage.
+   The linked list used while reading is freed before returning.
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBCOMPACT *blReadPDBCompact(FILE *fp, int *natom)
+{
+   PDB        *pdb;
+   PDBCOMPACT *cpdb;
+
+   *natom = 0;
+   if((pdb=blReadPDB(fp, natom))==NULL)
+      return(NULL);
+
+   cpdb = blPDBToCompact(pdb);
+   FREELIST(pdb, PDB);
+
+   if(cpdb==NULL)
+      *natom = 0;
+   return(cpdb);
+}
+
+
+/************************************************************************/
+/*>void blFreePDBCompact(PDBCOMPACT *cpdb)
+   ---------------------------------------
+*//**
+
+   \param[in]     *cpdb    Compact structure to free
+
+   Frees a compact structure and everything it contains
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreePDBCompact(PDBCOMPACT *cpdb)
+{
+   int i;
+
+   if(cpdb==NULL)
+      return;
+
+   if(cpdb->strings!=NULL)
+   {
+      for(i=0; i<cpdb->nstrings; i++)
+         free(cpdb->strings[i]);
+      free(cpdb->strings);
+   }
+   if(cpdb->atoms!=NULL)       free(cpdb->atoms);
+   if(cpdb->conectStart!=NULL) free(cpdb->conectStart);
+   if(cpdb->conect!=NULL)      free(cpdb->conect);
+   free(cpdb);
+}
+
+
+/************************************************************************/
+/*>ULONG blPDBCompactMemory(PDBCOMPACT *cpdb)
+   ------------------------------------------
+*//**
+
+   \param[in]     *cpdb    Compact structure
+   \return                 Bytes used
+
+   Returns the number of bytes allocated for a compact structure (not
+   counting malloc() overheads)
+
+-  17.10.26 Original   By: ACRM
+*/
+ULONG blPDBCompactMemory(PDBCOMPACT *cpdb)
+{
+   ULONG bytes;
+   int   i;
+
+   if(cpdb==NULL)
+      return(0);
+
+   bytes = sizeof(PDBCOMPACT) +
+           (ULONG)cpdb->natoms * sizeof(PDBATOMC) +
+           (ULONG)cpdb->nstrings * sizeof(char *);
+   for(i=0; i<cpdb->nstrings; i++)
+      bytes += strlen(cpdb->strings[i]) + 1;
+   if(cpdb->conectStart!=NULL)
+   {
+      bytes += (ULONG)(cpdb->natoms + 1) * sizeof(int) +
+               (ULONG)cpdb->conectStart[cpdb->natoms] * sizeof(int);
+   }
+
+   return(bytes);
+}
+
+
+/************************************************************************/
+/*>ULONG blPDBMemory(PDB *pdb)
+   ---------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \return                 Bytes used
+
+   Returns the number of bytes allocated for the records of a PDB
+   linked list (not counting malloc() overheads or anything hung from
+   the extras or atomInfo pointers)
+
+-  17.10.26 Original   By: ACRM
+*/
+ULONG blPDBMemory(PDB *pdb)
+{
+   PDB   *p;
+   ULONG bytes = 0;
+
+   for(p=pdb; p!=NULL; NEXT(p))
+      bytes += sizeof(PDB);
+
+   return(bytes);
+}
+
+
+/************************************************************************/
+/*>void blGetCofGPDBCompact(PDBCOMPACT *cpdb, VEC3F *cg)
+   -----------------------------------------------------
+*//**
+
+   \param[in]     *cpdb    Compact structure
+   \param[out]    *cg      Centre of geometry
+
+   Finds the CofG of the atoms, ignoring NULL (9999.0) coordinates in
+   the same way as blGetCofGPDB()
+
+-  17.10.26 Original   By: ACRM
+*/
+void blGetCofGPDBCompact(PDBCOMPACT *cpdb, VEC3F *cg)
+{
+   PDBATOMC *a;
+   int      i,
+            natom = 0;
+
+   cg->x = 0.0;
+   cg->y = 0.0;
+   cg->z = 0.0;
+   for(i=0, a=cpdb->atoms; i<cpdb->natoms; i++, a++)
+   {
+      if(a->x < 9999.0 || a->y < 9999.0 || a->z < 9999.0)
+      {
+         cg->x += a->x;
+         cg->y += a->y;
+         cg->z += a->z;
+         natom++;
+      }
+   }
+   if(natom)
+   {
+      cg->x /= natom;
+      cg->y /= natom;
+      cg->z /= natom;
+   }
+}
+
+
+/************************************************************************/
+/*>void blTranslatePDBCompact(PDBCOMPACT *cpdb, VEC3F tvect)
+   ---------------------------------------------------------
+*//**
+
+   \param[in,out] *cpdb    Compact structure
+   \param[in]     tvect    Translation vector
+
+   Translates the atoms, ignoring NULL (9999.0) coordinates as
+   blTranslatePDB() does
+
+-  17.10.26 Original   By: ACRM
+*/
+void blTranslatePDBCompact(PDBCOMPACT *cpdb, VEC3F tvect)
+{
+   PDBATOMC *a;
+   int      i;
+
+   for(i=0, a=cpdb->atoms; i<cpdb->natoms; i++, a++)
+   {
+      if(a->x < 9999.0 && a->y < 9999.0 && a->z < 9999.0)
+      {
+         a->x = (float)(a->x + tvect.x);
+         a->y = (float)(a->y + tvect.y);
+         a->z = (float)(a->z + tvect.z);
+      }
+   }
+}
+
+
+/************************************************************************/
+/*>void blApplyMatrixPDBCompact(PDBCOMPACT *cpdb, REAL matrix[3][3])
+   -----------------------------------------------------------------
+*//**
+
+   \param[in,out] *cpdb    Compact structure
+   \param[in]     matrix   Rotation matrix
+
+   Applies a rotation matrix to the atoms, leaving NULL (9999.0)
+   coordinates untouched as blApplyMatrixPDB() does
+
+-  17.10.26 Original   By: ACRM
+*/
+void blApplyMatrixPDBCompact(PDBCOMPACT *cpdb, REAL matrix[3][3])
+{
+   PDBATOMC *a;
+   REAL     x, y, z;
+   int      i;
+
+   for(i=0, a=cpdb->atoms; i<cpdb->natoms; i++, a++)
+   {
+      if(a->x != 9999.0 && a->y != 9999.0 && a->z != 9999.0)
+      {
+         x = a->x;
+         y = a->y;
+         z = a->z;
+         a->x = (float)(x*matrix[0][0] + y*matrix[0][1] + z*matrix[0][2]);
+         a->y = (float)(x*matrix[1][0] + y*matrix[1][1] + z*matrix[1][2]);
+         a->z = (float)(x*matrix[2][0] + y*matrix[2][1] + z*matrix[2][2]);
+      }
+   }
+}
+
+
+/************************************************************************/
+/*>REAL blCalcRMSPDBCompact(PDBCOMPACT *cpdb1, PDBCOMPACT *cpdb2)
+   --------------------------------------------------------------
+*//**
+
+   \param[in]     *cpdb1   First structure
+   \param[in]     *cpdb2   Second structure
+   \return                 RMS deviation
+
+   Calculates the RMSD between equivalent atoms of two structures. As
+   with blCalcRMSPDB() no fitting is done and the atoms are paired in
+   order. The sums are done in REAL precision.
+
+-  17.10.26 Original   By: ACRM
+*/
+REAL blCalcRMSPDBCompact(PDBCOMPACT *cpdb1, PDBCOMPACT *cpdb2)
+{
+   PDBATOMC *a, *b;
+   int      i,
+            count;
+   REAL     dx, dy, dz,
+            dist = (REAL)0.0;
+
+   count = MIN(cpdb1->natoms, cpdb2->natoms);
+   for(i=0, a=cpdb1->atoms, b=cpdb2->atoms; i<count; i++, a++, b++)
+   {
+      dx = (REAL)a->x - (REAL)b->x;
+      dy = (REAL)a->y - (REAL)b->y;
+      dz = (REAL)a->z - (REAL)b->z;
+      dist += dx*dx + dy*dy + dz*dz;
+   }
+
+   return((REAL)((count)?sqrt((double)(dist/(REAL)count)):0.0));
+}
+
+
+/************************************************************************/
+/*>BOOL blFitPDBCompact(PDBCOMPACT *ref, PDBCOMPACT *fit, REAL rm[3][3])
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *ref     Reference structure
+   \param[in,out] *fit     Structure to be fitted
+   \param[out]    rm       Rotation matrix (may be input as NULL)
+   \return                 Success
+
+   Fits fit onto ref, pairing atoms in order. Returns FALSE if the
+   structures differ in size or have fewer than 3 atoms, in which case
+   nothing is moved.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blFitPDBCompact(PDBCOMPACT *ref, PDBCOMPACT *fit, REAL rm[3][3])
+{
+   REAL  RotMat[3][3];
+   COOR  *ref_coor = NULL,
+         *fit_coor = NULL;
+   VEC3F ref_CofG,
+         fit_CofG,
+         shift;
+   int   NCoor,
+         i, j;
+   BOOL  RetVal;
+
+   if((ref->natoms != fit->natoms) || (ref->natoms < 3))
+      return(FALSE);
+   NCoor = ref->natoms;
+
+   if(((ref_coor=(COOR *)malloc(NCoor * sizeof(COOR)))==NULL) ||
+      ((fit_coor=(COOR *)malloc(NCoor * sizeof(COOR)))==NULL))
+   {
+      if(ref_coor) free(ref_coor);
+      return(FALSE);
+   }
+
+   blGetCofGPDBCompact(ref, &ref_CofG);
+   blGetCofGPDBCompact(fit, &fit_CofG);
+
+   /* Create coordinate arrays centred on the origin                    */
+   for(i=0; i<NCoor; i++)
+   {
+      ref_coor[i].x = ref->atoms[i].x - ref_CofG.x;
+      ref_coor[i].y = ref->atoms[i].y - ref_CofG.y;
+      ref_coor[i].z = ref->atoms[i].z - ref_CofG.z;
+      fit_coor[i].x = fit->atoms[i].x - fit_CofG.x;
+      fit_coor[i].y = fit->atoms[i].y - fit_CofG.y;
+      fit_coor[i].z = fit->atoms[i].z - fit_CofG.z;
+   }
+
+   if((RetVal = blMatfit(ref_coor,fit_coor,RotMat,NCoor,NULL,FALSE)))
+   {
+      shift.x = -fit_CofG.x;
+      shift.y = -fit_CofG.y;
+      shift.z = -fit_CofG.z;
+      blTranslatePDBCompact(fit, shift);
+      blApplyMatrixPDBCompact(fit, RotMat);
+      blTranslatePDBCompact(fit, ref_CofG);
+
+      if(rm!=NULL)
+      {
+         for(i=0; i<3; i++)
+            for(j=0; j<3; j++)
+               rm[i][j] = RotMat[i][j];
+      }
+   }
+
+   free(ref_coor);
+   free(fit_coor);
+
+   return(RetVal);
+}
+
+
+/************************************************************************/
+/*>static PDB *CompactResidueList(PDBCOMPACT *cpdb)
+   ------------------------------------------------
+*//**
+
+   \param[in]     *cpdb    Compact structure
+   \return                 Malloc'd array of PDB records linked as a list
+
+   Creates a temporary linked list holding only the first atom of each
+   run of atoms with the same record type, chain, residue number,
+   insert code and residue name. The sequence routines only act when
+   one of these changes, so they give the same result on this list as
+   on the full structure. The list is a single array and must be freed
+   with free() rather than FREELIST().
+
+-  17.10.26 Original   By: ACRM
+*/
+static PDB *CompactResidueList(PDBCOMPACT *cpdb)
+{
+   PDB      *list;
+   PDBATOMC *a,
+            *prev = NULL;
+   int      i,
+            nres = 0;
+
+   for(i=0, a=cpdb->atoms; i<cpdb->natoms; i++, a++)
+   {
+      if((prev==NULL) ||
+         (a->resnum      != prev->resnum)      ||
+         (a->insert      != prev->insert)      ||
+         (a->chain       != prev->chain)       ||
+         (a->record_type != prev->record_type) ||
+         strncmp(a->resnam, prev->resnam, sizeof(a->resnam)))
+         nres++;
+      prev = a;
+   }
+
+   if((list=(PDB *)malloc(nres * sizeof(PDB)))==NULL)
+      return(NULL);
+
+   nres = 0;
+   prev = NULL;
+   for(i=0, a=cpdb->atoms; i<cpdb->natoms; i++, a++)
+   {
+      if((prev==NULL) ||
+         (a->resnum      != prev->resnum)      ||
+         (a->insert      != prev->insert)      ||
+         (a->chain       != prev->chain)       ||
+         (a->record_type != prev->record_type) ||
+         strncmp(a->resnam, prev->resnam, sizeof(a->resnam)))
+      {
+         PDB *p = list + nres;
+
+         CLEAR_PDB(p);
+         p->resnum    = a->resnum;
+         p->insert[0] = a->insert;
+         p->insert[1] = '\0';
+         strcpy(p->chain,       cpdb->strings[a->chain]);
+         strcpy(p->record_type, cpdb->strings[a->record_type]);
+         PDBC_UNPACK(p->resnam, a->resnam);
+         if(nres)
+            list[nres-1].next = p;
+         nres++;
+      }
+      prev = a;
+   }
+
+   return(list);
+}
+
+
+/************************************************************************/
+/*>char *blDoPDB2SeqCompact(PDBCOMPACT *cpdb, BOOL DoAsxGlx,
+                            BOOL ProtOnly, BOOL NoX)
+   ---------------------------------------------------------
+*//**
+
+   \param[in]     *cpdb    Compact structure
+   \param[in]     DoAsxGlx Handle Asx and Glx as B and Z rather than X
+   \param[in]     ProtOnly Don't do DNA/RNA; these simply don't get
+                           done rather than being handled as X
+   \param[in]     NoX      Skip amino acids which would be assigned as X
+   \return                 Allocated character array containing sequence
+
+   As blDoPDB2Seq(), but works on a compact structure
+
+-  17.10.26 Original   By: ACRM
+*/
+char *blDoPDB2SeqCompact(PDBCOMPACT *cpdb, BOOL DoAsxGlx, BOOL ProtOnly,
+                         BOOL NoX)
+{
+   PDB  *list;
+   char *seq;
+
+   if((cpdb==NULL) || (cpdb->natoms==0))
+      return(NULL);
+   if((list=CompactResidueList(cpdb))==NULL)
+      return(NULL);
+
+   seq = blDoPDB2Seq(list, DoAsxGlx, ProtOnly, NoX);
+   free(list);
+
+   return(seq);
+}
+
+
+/************************************************************************/
+/*>HASHTABLE *blDoPDB2SeqByChainCompact(PDBCOMPACT *cpdb, BOOL DoAsxGlx,
+                                        BOOL ProtOnly, BOOL NoX)
+   ----------------------------------------------------------------------
+*//**
+
+   \param[in]     *cpdb    Compact structure
+   \param[in]     DoAsxGlx Handle Asx and Glx as B and Z rather than X
+   \param[in]     ProtOnly Don't do DNA/RNA; these simply don't get
+                           done rather than being handled as X
+   \param[in]     NoX      Skip amino acids which would be assigned as X
+   \return                 A hash of 1-letter code sequences indexed by
+                           chain label
+
+   As blDoPDB2SeqByChain(), but works on a compact structure
+
+-  17.10.26 Original   By: ACRM
+*/
+HASHTABLE *blDoPDB2SeqByChainCompact(PDBCOMPACT *cpdb, BOOL DoAsxGlx,
+                                     BOOL ProtOnly, BOOL NoX)
+{
+   PDB       *list;
+   HASHTABLE *hash;
+
+   if((cpdb==NULL) || (cpdb->natoms==0))
+      return(NULL);
+   if((list=CompactResidueList(cpdb))==NULL)
+      return(NULL);
+
+   hash = blDoPDB2SeqByChain(list, DoAsxGlx, ProtOnly, NoX);
+   free(list);
+
+   return(hash);
+}
+
@@ -3,12 +3,12 @@
 
    \file       PDBHeaderInfo.c
    
-   \version    V1.9
-   \date       13.03.19
+   \version    V1.10
+   \date       17.10.26
 
    \brief      Get misc header info from PDB header
    
-   \copyright  (c) Dr. Andrew C.R. Martin / UCL, 2015-2019
+   \copyright  (c) Dr. Andrew C.R. Martin / UCL, 2015-2026
    \author     Dr. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -67,6 +67,8 @@
                   blGetSeqresByChainWholePDB()
 -  V1.8  03.10.16 Added <stdlib.h>
 -  V1.9  13.03.19 Some fixes to terminate strings made with strncpy()
+-  V1.10 17.10.26 Added blScanPDBHeader(), blGetHeaderInfoWholePDB() and
+                  blFreePDBHeaderInfo()
 
 *************************************************************************/
 /* Doxygen
@@ -115,6 +117,16 @@
 
    #FUNCTION blFreeBiomolecule()
    Free the biomolecule data
+
+   #FUNCTION blScanPDBHeader()
+   Reads just the header of a PDB file and extracts the commonly needed
+   header data in one pass
+
+   #FUNCTION blGetHeaderInfoWholePDB()
+   Extracts the commonly needed header data from WHOLEPDB info
+
+   #FUNCTION blFreePDBHeaderInfo()
+   Frees a PDBHEADERINFO structure
 */
 
 /************************************************************************/
@@ -1420,6 +1432,148 @@ HASHTABLE *blGetSeqresByChainWholePDB(WHOLEPDB *wpdb, MODRES *modres,
 
 
 
+/************************************************************************/
+/*>PDBHEADERINFO *blGetHeaderInfoWholePDB(WHOLEPDB *wpdb)
+   ------------------------------------------------------
+*//**
+   \param[in]     *wpdb    WHOLEPDB structure
+   \return                 Header information (NULL if no memory or
+                           the SSBOND records could not be read)
+
+   Collects the experimental, crystal, SEQRES, SSBOND, secondary 
+   structure and HEADER data from the header of a WHOLEPDB structure
+   into a single PDBHEADERINFO structure. The wpdb field is left as
+   NULL since the WHOLEPDB remains the property of the caller.
+
+   Free the result with blFreePDBHeaderInfo()
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBHEADERINFO *blGetHeaderInfoWholePDB(WHOLEPDB *wpdb)
+{
+   PDBHEADERINFO *info;
+   BOOL          error = FALSE;
+
+   if((info = (PDBHEADERINFO *)malloc(sizeof(PDBHEADERINFO)))==NULL)
+      return(NULL);
+
+   info->wpdb          = NULL;
+   info->secstr        = NULL;
+   info->disulphides   = NULL;
+   info->seqres        = NULL;
+   info->resolution    = (REAL)0.0;
+   info->RFactor       = (REAL)0.0;
+   info->FreeR         = (REAL)0.0;
+   info->strucType     = STRUCTURE_TYPE_UNKNOWN;
+   info->nSeqresChains = 0;
+   info->nSecstr       = 0;
+   info->spacegroup[0] = info->header[0] = 
+      info->date[0]    = info->pdbcode[0] = '\0';
+
+   info->gotExptl    = blGetExptlWholePDB(wpdb, &(info->resolution),
+                                          &(info->RFactor),
+                                          &(info->FreeR),
+                                          &(info->strucType));
+   info->crystFlags  = blGetCrystWholePDB(wpdb, &(info->unitCell),
+                                          &(info->cellAngles),
+                                          info->spacegroup,
+                                          info->origMatrix,
+                                          info->scaleMatrix);
+   info->seqres      = blReadSeqresWholePDB(wpdb, &(info->nSeqresChains));
+   info->disulphides = blReadDisulphidesWholePDB(wpdb, &error);
+   info->secstr      = blReadSecWholePDB(wpdb, &(info->nSecstr));
+   info->gotHeader   = blGetHeaderWholePDB(wpdb,
+                                           info->header,  48,
+                                           info->date,    16,
+                                           info->pdbcode,  8);
+
+   if(error)
+   {
+      blFreePDBHeaderInfo(info);
+      return(NULL);
+   }
+
+   return(info);
+}
+
+
+/************************************************************************/
+/*>PDBHEADERINFO *blScanPDBHeader(FILE *fp)
+   ----------------------------------------
+*//**
+   \param[in]     *fp      PDB file pointer
+   \return                 Header information (NULL on error)
+
+   Reads only the header of a PDB file (stopping at the first coordinate
+   record) and collects the commonly needed header data in one pass. 
+   This avoids rewinding and re-reading the file for each item as 
+   happens when the FILE-based routines such as blGetExptlPDB() and
+   blReadDisulphidesPDB() are used in turn.
+
+   The header records are kept in the wpdb field so that other
+   ...WholePDB() routines may be used on them. Free the result with
+   blFreePDBHeaderInfo()
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBHEADERINFO *blScanPDBHeader(FILE *fp)
+{
+   WHOLEPDB      *wpdb;
+   PDBHEADERINFO *info;
+
+   if((wpdb = blReadPDBHeader(fp))==NULL)
+      return(NULL);
+
+   if((info = blGetHeaderInfoWholePDB(wpdb))==NULL)
+   {
+      blFreeWholePDB(wpdb);
+      return(NULL);
+   }
+
+   info->wpdb = wpdb;
+   return(info);
+}
+
+
+/************************************************************************/
+/*>void blFreePDBHeaderInfo(PDBHEADERINFO *info)
+   ---------------------------------------------
+*//**
+   \param[in]     *info    Header information
+
+   Frees a PDBHEADERINFO structure and the data it contains, including
+   the header records read by blScanPDBHeader()
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreePDBHeaderInfo(PDBHEADERINFO *info)
+{
+   int i;
+   
+   if(info == NULL)
+      return;
+
+   if(info->seqres != NULL)
+   {
+      for(i=0; i<info->nSeqresChains; i++)
+      {
+         if(info->seqres[i] != NULL)
+            free(info->seqres[i]);
+      }
+      free(info->seqres);
+   }
+   
+   if(info->disulphides != NULL)
+      FREELIST(info->disulphides, DISULPHIDE);
+   if(info->secstr != NULL)
+      FREELIST(info->secstr, SECSTRUC);
+   if(info->wpdb != NULL)
+      blFreeWholePDB(info->wpdb);
+
+   free(info);
+}
+
+
 /************************************************************************/
 #ifdef TEST
 int main(int argc, char **argv)
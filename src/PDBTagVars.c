@@ -0,0 +1,510 @@
+/************************************************************************/
+/**
+
+   \file       PDBTagVars.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Code for associating XML tags with additional
+               variables in the PDB structure
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 1988-2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Maintains a list of XML tags, each bound either to a function that
+   extracts a value from a PDB structure or to a column of a PDBATTRIBS
+   attribute table. blWritePDBAsPDBML() calls blAddTagVariablesNodes()
+   to add a child node for each tag to every atom_site.
+
+   Values from an attribute table are only written for atoms that are
+   in the table.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   attribs = blCreatePDBAttribs(pdb);
+   col     = blAddPDBAttrib(attribs, "energy", PDBATTRIB_REAL, 0);
+   ...
+   blAddPDBAttribTag(attribs, col, "pdbx_energy");
+   INIT_PDBTAGVAR(&myFunction, PDBTAGVAR_INT, "my_tag");
+   blWritePDBAsPDBML(fp, pdb);
+   blClearPDBTagVars();
+   blFreePDBAttribs(attribs);
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V0.1  06.08.14 Preliminary code
+-  V0.2  25.08.14 Added blAddTagVariablesNodes() By: CTP
+-  V0.3  28.08.14 Added blAddTagVariablesColumns() and updated
+                  blAddTagVariablesNodes() By: CTP
+-  V1.0  17.10.26 Moved into the library from the pdbtagvars prototype.
+                  Added blAddPDBTagFunction(), blAddPDBAttribTag() and
+                  blClearPDBTagVars(). Tags may now be bound to
+                  attribute columns   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP Attribute columns
+
+   #FUNCTION  blAddPDBTagFunction()
+   Binds an XML tag to a function that extracts a value from a PDB
+   structure
+
+   #FUNCTION  blAddPDBAttribTag()
+   Binds an XML tag to a column of an attribute table
+
+   #FUNCTION  blClearPDBTagVars()
+   Removes all XML tag bindings
+
+   #FUNCTION  blXMLGetPDBAccess()
+   Returns the accessibility of an atom
+
+   #FUNCTION  blPDBAddXMLAccessTag()
+   Binds the accessibility to the pdbx_accessibility tag
+
+   #FUNCTION  blPrintTagVariables()
+   Prints the tagged values for an atom
+
+   #FUNCTION  blPrintAllTagVariables()
+   Prints the tagged values for all atoms in a linked list
+
+   #FUNCTION  blAddTagVariablesNodes()
+   Adds the tagged values for an atom to a PDBML atom_site node
+
+   #FUNCTION  blAddTagVariablesCols()
+   Creates a string of the tagged values for an atom
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+#include "macros.h"
+#include "pdbattrib.h"
+
+#define _PDBTAGVARS_CODE 1
+#include "pdbtagvars.h"
+
+/************************************************************************/
+/* Prototypes
+*/
+static PDBTAGVAR *NewTagVar(char *tag, int type);
+static BOOL FormatTagVar(PDBTAGVAR *tv, PDB *p, BOOL padded,
+                         char *buffer);
+
+
+/************************************************************************/
+/*>static PDBTAGVAR *NewTagVar(char *tag, int type)
+   ------------------------------------------------
+*//**
+
+   \param[in]   *tag     XML tag name
+   \param[in]   type     PDBTAGVAR_XXXX
+   \return               Cleared entry added to gPDBTagFunctions or NULL
+                         on error
+
+-  17.10.26 Original   By: ACRM
+*/
+static PDBTAGVAR *NewTagVar(char *tag, int type)
+{
+   PDBTAGVAR *tagVars,
+             *tv;
+
+   if((tag == NULL) || (strlen(tag) >= MAXTAGNAME))
+      return(NULL);
+
+   if((tagVars = (PDBTAGVAR *)realloc(gPDBTagFunctions,
+                                      (gNPDBTagFunctions+1) *
+                                      sizeof(PDBTAGVAR)))==NULL)
+      return(NULL);
+   gPDBTagFunctions = tagVars;
+
+   tv = &(gPDBTagFunctions[gNPDBTagFunctions++]);
+   tv->realFunction   = NULL;
+   tv->intFunction    = NULL;
+   tv->stringFunction = NULL;
+   tv->attribs        = NULL;
+   tv->column         = -1;
+   tv->type           = type;
+   strcpy(tv->tag, tag);
+
+   return(tv);
+}
+
+
+/************************************************************************/
+/*>static BOOL FormatTagVar(PDBTAGVAR *tv, PDB *p, BOOL padded,
+                            char *buffer)
+   ------------------------------------------------------------
+*//**
+
+   \param[in]   *tv      Tag binding
+   \param[in]   *p       Pointer to a PDB structure
+   \param[in]   padded   Pad numbers to a fixed width
+   \param[out]  *buffer  The value (MAXTAGDATA characters)
+   \return               Value available. FALSE if the tag is bound to
+                         an attribute table that does not contain this
+                         atom
+
+   Floating point data are formatted as "%8.3f" and integers as "%6d"
+   when padded, otherwise as "%.3f" and "%d".
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL FormatTagVar(PDBTAGVAR *tv, PDB *p, BOOL padded,
+                         char *buffer)
+{
+   char *string = NULL;
+   int  i       = 0;
+
+   if(tv->attribs != NULL)
+   {
+      if((i = blGetPDBAttribOrdinal(tv->attribs, p)) < 0)
+         return(FALSE);
+   }
+
+   switch(tv->type)
+   {
+   case PDBTAGVAR_REAL:
+      sprintf(buffer, (padded ? "%8.3f" : "%.3f"),
+              ((tv->attribs != NULL) ?
+               PDBATTRIB_REALVAL(tv->attribs, tv->column, i) :
+               (*tv->realFunction)(p)));
+      break;
+   case PDBTAGVAR_INT:
+      sprintf(buffer, (padded ? "%6d" : "%d"),
+              ((tv->attribs != NULL) ?
+               PDBATTRIB_INTVAL(tv->attribs, tv->column, i) :
+               (*tv->intFunction)(p)));
+      break;
+   case PDBTAGVAR_STRING:
+      string = (tv->attribs != NULL) ?
+         PDBATTRIB_STRINGVAL(tv->attribs, tv->column, i) :
+         (*tv->stringFunction)(p);
+      if(string == NULL)
+         string = "";
+      strncpy(buffer, string, MAXTAGDATA-1);
+      buffer[MAXTAGDATA-1] = '\0';
+      break;
+   default:
+      buffer[0] = '\0';
+      break;
+   }
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>BOOL blAddPDBTagFunction(REAL (*realFunction)(PDB *),
+                            int (*intFunction)(PDB *),
+                            char *(*stringFunction)(PDB *),
+                            int type, char *tag)
+   ---------------------------------------------------------
+*//**
+
+   \param[in]   realFunction    Function for PDBTAGVAR_REAL
+   \param[in]   intFunction     Function for PDBTAGVAR_INT
+   \param[in]   stringFunction  Function for PDBTAGVAR_STRING
+   \param[in]   type            PDBTAGVAR_XXXX
+   \param[in]   *tag            XML tag name
+   \return                      Success
+
+   Binds an XML tag to a function that extracts a value from a PDB
+   structure. Only the function matching the type is used; the others
+   should be NULL. Normally called via the INIT_PDBTAGVAR() macro.
+
+-  17.10.26 Original based on INIT_PDBTAGVAR()   By: ACRM
+*/
+BOOL blAddPDBTagFunction(REAL (*realFunction)(PDB *),
+                         int (*intFunction)(PDB *),
+                         char *(*stringFunction)(PDB *),
+                         int type, char *tag)
+{
+   PDBTAGVAR *tv;
+
+   if(((type == PDBTAGVAR_REAL)   && (realFunction   == NULL)) ||
+      ((type == PDBTAGVAR_INT)    && (intFunction    == NULL)) ||
+      ((type == PDBTAGVAR_STRING) && (stringFunction == NULL)))
+      return(FALSE);
+
+   if((tv = NewTagVar(tag, type))==NULL)
+      return(FALSE);
+
+   tv->realFunction   = realFunction;
+   tv->intFunction    = intFunction;
+   tv->stringFunction = stringFunction;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>BOOL blAddPDBAttribTag(PDBATTRIBS *attribs, int column, char *tag)
+   ------------------------------------------------------------------
+*//**
+
+   \param[in]   *attribs  Attribute table
+   \param[in]   column    Column in the table
+   \param[in]   *tag      XML tag name. If NULL, the column name is used
+   \return                Success
+
+   Binds an XML tag to a column of an attribute table. The table must
+   not be freed while the binding exists; call blClearPDBTagVars()
+   first.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blAddPDBAttribTag(PDBATTRIBS *attribs, int column, char *tag)
+{
+   PDBTAGVAR *tv;
+
+   if((attribs == NULL) || (column < 0) || (column >= attribs->ncols))
+      return(FALSE);
+
+   if(tag == NULL)
+      tag = attribs->cols[column].name;
+
+   if((tv = NewTagVar(tag, attribs->cols[column].type))==NULL)
+      return(FALSE);
+
+   tv->attribs = attribs;
+   tv->column  = column;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>void blClearPDBTagVars(void)
+   ----------------------------
+*//**
+
+   Removes all XML tag bindings
+
+-  17.10.26 Original   By: ACRM
+*/
+void blClearPDBTagVars(void)
+{
+   FREE(gPDBTagFunctions);
+   gNPDBTagFunctions = 0;
+}
+
+
+/************************************************************************/
+/*>REAL blXMLGetPDBAccess(PDB *p)
+   ------------------------------
+*//**
+   \param[in]   PDB  *  Pointer to PDB structure
+
+   Extracts and returns the accessibility from a PDB structure
+
+   This is used by blPDBAddXMLAccessTag()
+
+-  06.08.14 Original   By: ACRM
+*/
+REAL blXMLGetPDBAccess(PDB *p)
+{
+   return(p->access);
+}
+
+
+/************************************************************************/
+/*>void blPDBAddXMLAccessTag(void)
+   -------------------------------
+*//**
+   Adds the blXMLGetPDBAccess() function with the <pdbx_accessibility>
+   XML tag
+
+   This also serves as a demonstration of how to associate a function
+   that extracts a value from a PDB structure with an XML tag name
+
+-  06.08.14 Original   By: ACRM
+*/
+void blPDBAddXMLAccessTag(void)
+{
+   INIT_PDBTAGVAR(&blXMLGetPDBAccess, PDBTAGVAR_REAL,
+                  "pdbx_accessibility");
+}
+
+
+/************************************************************************/
+/*>void blPrintAllTagVariables(PDB *pdb)
+   -------------------------------------
+*//**
+   \param[in]   PDB  *  PDB linked list
+
+   Runs through each item in a PDB linked list and calls the
+   blPrintTagVariables() routine to generate tags for that atom
+
+-  06.08.14 Original   By: ACRM
+*/
+void blPrintAllTagVariables(PDB *pdb)
+{
+   PDB *p;
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      blPrintTagVariables(p);
+   }
+}
+
+
+/************************************************************************/
+/*>void blPrintTagVariables(PDB *p)
+   --------------------------------
+*//**
+   \param[in]   PDB  *  Pointer to a PDB structure
+
+   Prints each tagged value for an atom to standard output
+
+-  06.08.14 Original   By: ACRM
+-  17.10.26 Uses FormatTagVar() so attribute columns are printed
+            By: ACRM
+*/
+void blPrintTagVariables(PDB *p)
+{
+   char buffer[MAXTAGDATA];
+   int  i;
+
+   for(i=0; i<gNPDBTagFunctions; i++)
+   {
+      if(FormatTagVar(&(gPDBTagFunctions[i]), p, FALSE, buffer))
+      {
+         printf("<%s>%s</%s>\n", gPDBTagFunctions[i].tag, buffer,
+                gPDBTagFunctions[i].tag);
+      }
+   }
+}
+
+
+#ifdef XML_SUPPORT
+/************************************************************************/
+/*>BOOL blAddTagVariablesNodes(PDB *pdb, xmlNodePtr atom_node)
+   -----------------------------------------------------------
+*//**
+   \param[in]   PDB        *  Pointer to a PDB structure
+   \param[in]   atom_node  *  Pointer to an atom_site node
+   \return                    Success
+
+   Adds child nodes with user-defined data to pdbml atom_site node.
+
+   Based on blPrintTagVariables().
+
+-  25.08.14 Original   By: CTP
+-  28.08.14 Added format for floating point and decimal data.
+            Added max length for xmltag_data string. By: CTP
+-  17.10.26 Uses FormatTagVar(). Numbers are no longer padded. Returns
+            BOOL   By: ACRM
+*/
+BOOL blAddTagVariablesNodes(PDB *pdb, xmlNodePtr atom_node)
+{
+   char xmltag_data[MAXTAGDATA];
+   int  i;
+
+   for(i=0; i<gNPDBTagFunctions; i++)
+   {
+      if(FormatTagVar(&(gPDBTagFunctions[i]), pdb, FALSE, xmltag_data))
+      {
+         if(xmlNewChild(atom_node, NULL,
+                        (xmlChar *)gPDBTagFunctions[i].tag,
+                        (xmlChar *)xmltag_data)==NULL)
+            return(FALSE);
+      }
+   }
+
+   return(TRUE);
+}
+#endif
+
+
+/************************************************************************/
+/*>char *blAddTagVariablesCols(PDB *pdb)
+   -------------------------------------
+*//**
+   \param[in]   PDB  *  Pointer to a PDB structure
+   \return              Malloc'd string of values or NULL on error
+
+   Creates a string of user-defined data to add as columns to pdb-format
+   output.
+
+   Floating point data is formatted as "%8.3f" and decimal data is
+   formatted as "%6d". Values missing from an attribute table are
+   written as blanks of the same width.
+
+   String data does not have a set column width giving the user the
+   freedom to set the data format from the tag function.
+
+-  28.08.14 Original   By: CTP
+-  17.10.26 Uses FormatTagVar() and allocates the string once  By: ACRM
+*/
+char *blAddTagVariablesCols(PDB *pdb)
+{
+   char *xmltag_string = NULL;
+   char xmltag_data[MAXTAGDATA];
+   int  i,
+        len = 0;
+
+   if((xmltag_string = (char *)malloc((gNPDBTagFunctions * MAXTAGDATA
+                                       + 1) * sizeof(char)))==NULL)
+      return(NULL);
+   xmltag_string[0] = '\0';
+
+   for(i=0; i<gNPDBTagFunctions; i++)
+   {
+      if(!FormatTagVar(&(gPDBTagFunctions[i]), pdb, TRUE, xmltag_data))
+      {
+         switch(gPDBTagFunctions[i].type)
+         {
+         case PDBTAGVAR_REAL:
+            sprintf(xmltag_data, "%8s", "");
+            break;
+         case PDBTAGVAR_INT:
+            sprintf(xmltag_data, "%6s", "");
+            break;
+         default:
+            xmltag_data[0] = '\0';
+            break;
+         }
+      }
+      strcpy(xmltag_string+len, xmltag_data);
+      len += strlen(xmltag_data);
+   }
+
+   return(xmltag_string);
+}
@@ -0,0 +1,935 @@
+/************************************************************************/
+/**
+
+   \file       PDBView.c
+
+   \version    V1.1
+   \date       17.10.26
+   \brief      Zero-copy views onto a PDB linked list
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   The blXxxxPDBAsCopy() routines (and blSelectCaPDB()) build a new
+   linked list by copying atoms with blCopyPDB() and then rebuilding
+   CONECT data. When the subset is only needed to calculate something
+   (a centre of geometry, an RMSD, a fit, a sequence) that copy is
+   wasted effort. A PDBVIEW instead holds pointers to the selected atoms
+   of the original linked list, in list order. The views created here
+   follow the same selection rules as the corresponding AsCopy routine.
+
+   Views are only valid while the underlying linked list is unchanged
+   in structure - atoms must not be freed or relinked while a view onto
+   them exists. Coordinates may be changed freely. blCheckPDBView()
+   tests whether a view still matches its linked list.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   PDBVIEW *ca;
+   VEC3F   cg;
+
+   ca = blSelectCaPDBView(pdb);
+   blGetCofGPDBView(ca, &cg);
+   blFreePDBView(ca);
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Added blCheckPDBView()
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP Views
+
+   #FUNCTION  blInitPDBView()
+   Initializes a view covering a whole PDB linked list
+
+   #FUNCTION  blCreatePDBView()
+   Creates a view of the atoms set in an atom mask
+
+   #FUNCTION  blCreatePDBViewExpression()
+   Creates a view of the atoms matching a selection expression
+
+   #FUNCTION  blFreePDBView()
+   Frees a view (but not the underlying atoms)
+
+   #FUNCTION  blCheckPDBView()
+   Tests whether a view is still valid for its linked list
+
+   #FUNCTION  blPDBViewAsCopy()
+   Makes a real linked list from the atoms in a view
+
+   #FUNCTION  blStripHPDBView()
+   View equivalent of blStripHPDBAsCopy()
+
+   #FUNCTION  blStripWatersPDBView()
+   View equivalent of blStripWatersPDBAsCopy()
+
+   #FUNCTION  blSelectAtomsPDBView()
+   View equivalent of blSelectAtomsPDBAsCopy()
+
+   #FUNCTION  blSelectCaPDBView()
+   View equivalent of blSelectCaPDB()
+
+   #FUNCTION  blGetPDBChainView()
+   View equivalent of blGetPDBChainAsCopy()
+
+   #FUNCTION  blExtractZonePDBView()
+   View equivalent of blExtractZonePDBAsCopy()
+
+   #FUNCTION  blExtractNotZonePDBView()
+   View equivalent of blExtractNotZonePDBAsCopy()
+
+   #FUNCTION  blGetCofGPDBView()
+   Finds the CofG of the atoms in a view
+
+   #FUNCTION  blCalcRMSPDBView()
+   Calculates the RMSD between the atoms of two views
+
+   #FUNCTION  blFitPDBView()
+   Fits one view onto another, moving the whole of the fitted list
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "pdb.h"
+#include "fit.h"
+#include "atomsel.h"
+#include "pdbview.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+typedef struct
+{
+   char **sel;
+   int  nsel;
+}  ATOMLIST;
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static PDBVIEW *AllocView(PDB *pdb, int natoms);
+static PDBVIEW *CreateFilteredView(PDB *pdb,
+                                   BOOL (*keep)(PDB *p, void *data),
+                                   void *data);
+static PDBVIEW *CreateRangeView(PDB *pdb, PDB *start, PDB *stop,
+                                BOOL outside);
+static BOOL KeepNotHydrogen(PDB *p, void *data);
+static BOOL KeepNotWater(PDB *p, void *data);
+static BOOL KeepAtomInList(PDB *p, void *data);
+static BOOL KeepCa(PDB *p, void *data);
+static BOOL KeepChain(PDB *p, void *data);
+
+
+/************************************************************************/
+/*>void blInitPDBView(PDBVIEW *view, PDB *pdb)
+   -------------------------------------------
+*//**
+
+   \param[out]    *view    View to initialize
+   \param[in]     *pdb     PDB linked list
+
+   Initializes a view (typically an automatic variable) to cover the
+   whole of a PDB linked list. Nothing is allocated so the view must
+   not be passed to blFreePDBView().
+
+-  17.10.26 Original   By: ACRM
+*/
+void blInitPDBView(PDBVIEW *view, PDB *pdb)
+{
+   PDB *p;
+
+   view->pdb    = pdb;
+   view->atoms  = NULL;
+   view->natoms = 0;
+   for(p=pdb; p!=NULL; NEXT(p))
+      view->natoms++;
+}
+
+
+/************************************************************************/
+/*>static PDBVIEW *AllocView(PDB *pdb, int natoms)
+   -----------------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \param[in]     natoms   Number of atoms the view will hold
+   \return                 Malloc'd view with natoms set to zero
+
+-  17.10.26 Original   By: ACRM
+*/
+static PDBVIEW *AllocView(PDB *pdb, int natoms)
+{
+   PDBVIEW *view;
+
+   if((view=(PDBVIEW *)malloc(sizeof(PDBVIEW)))==NULL)
+      return(NULL);
+
+   /* Always allocate at least one slot so that atoms is never NULL
+      for an allocated view
+   */
+   if((view->atoms=(PDB **)malloc(((natoms>0)?natoms:1) *
+                                  sizeof(PDB *)))==NULL)
+   {
+      free(view);
+      return(NULL);
+   }
+   view->pdb    = pdb;
+   view->natoms = 0;
+
+   return(view);
+}
+
+
+/************************************************************************/
+/*>PDBVIEW *blCreatePDBView(PDB *pdb, ATOMMASK *mask)
+   --------------------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \param[in]     *mask    Atom mask (NULL for all atoms)
+   \return                 Malloc'd view or NULL if out of memory
+
+   Creates a view of the atoms whose bits are set in the mask. Bit i
+   refers to the i'th atom in the linked list as returned by
+   blEvalAtomSelectionPDB().
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBVIEW *blCreatePDBView(PDB *pdb, ATOMMASK *mask)
+{
+   PDBVIEW *view;
+   PDB     *p;
+   int     i,
+           natoms = 0;
+
+   if(mask==NULL)
+   {
+      for(p=pdb; p!=NULL; NEXT(p))
+         natoms++;
+   }
+   else
+   {
+      natoms = blCountAtomMask(mask);
+   }
+
+   if((view=AllocView(pdb, natoms))==NULL)
+      return(NULL);
+
+   for(p=pdb, i=0; p!=NULL; NEXT(p), i++)
+   {
+      if(mask!=NULL)
+      {
+         if(i >= mask->natoms)
+            break;
+         if(!ATOMMASK_ISSET(mask, i))
+            continue;
+      }
+      view->atoms[view->natoms++] = p;
+   }
+
+   return(view);
+}
+
+
+/************************************************************************/
+/*>PDBVIEW *blCreatePDBViewExpression(PDB *pdb, char *expression)
+   --------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb          PDB linked list
+   \param[in]     *expression   Selection expression
+   \return                      Malloc'd view or NULL on error
+
+   Creates a view of the atoms matching a selection expression. See
+   blCompileAtomSelection() for the expression syntax.
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBVIEW *blCreatePDBViewExpression(PDB *pdb, char *expression)
+{
+   ATOMMASK *mask;
+   PDBVIEW  *view;
+
+   if((mask=blSelectAtomsByExpression(pdb, expression))==NULL)
+      return(NULL);
+
+   view = blCreatePDBView(pdb, mask);
+   blFreeAtomMask(mask);
+
+   return(view);
+}
+
+
+/************************************************************************/
+/*>void blFreePDBView(PDBVIEW *view)
+   ---------------------------------
+*//**
+
+   \param[in]     *view    View to free
+
+   Frees a view created by one of the view routines. The atoms in the
+   underlying linked list are not touched.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreePDBView(PDBVIEW *view)
+{
+   if(view!=NULL)
+   {
+      if(view->atoms!=NULL)
+         free(view->atoms);
+      free(view);
+   }
+}
+
+
+/************************************************************************/
+/*>BOOL blCheckPDBView(PDBVIEW *view)
+   ----------------------------------
+*//**
+
+   \param[in]     *view    View
+   \return                 Is the view still valid?
+
+   Tests whether a view still matches its underlying linked list: every
+   atom in the view must still be linked into the list, in the same
+   order. A view covering the whole list (atoms==NULL) is only valid
+   while the list has the number of atoms it had when the view was
+   initialized. The atoms in the view are not dereferenced, so a view
+   onto atoms that have since been freed can be tested safely. Only
+   changes to the structure of the list are detected; changes to
+   coordinates and other fields never invalidate a view.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blCheckPDBView(PDBVIEW *view)
+{
+   PDB *p;
+   int i = 0;
+
+   if(view->atoms==NULL)
+   {
+      for(p=view->pdb; p!=NULL; NEXT(p))
+         i++;
+   }
+   else
+   {
+      for(p=view->pdb; (p!=NULL) && (i<view->natoms); NEXT(p))
+      {
+         if(p==view->atoms[i])
+            i++;
+      }
+   }
+
+   return((i==view->natoms) ? TRUE : FALSE);
+}
+
+
+/************************************************************************/
+/*>PDB *blPDBViewAsCopy(PDBVIEW *view)
+   -----------------------------------
+*//**
+
+   \param[in]     *view    View
+   \return                 New PDB linked list or NULL
+
+   Makes a real PDB linked list from the atoms in a view, copying the
+   CONECT data in the same way as the AsCopy routines. Only needed when
+   a list is to be kept or passed to a routine that has no view
+   equivalent.
+
+-  17.10.26 Original   By: ACRM
+*/
+PDB *blPDBViewAsCopy(PDBVIEW *view)
+{
+   PDB *pdb = NULL,
+       *p, *q = NULL;
+   int i;
+
+   for(p=PDBVIEW_FIRST(view, i); p!=NULL; p=PDBVIEW_NEXT(view, p, i))
+   {
+      if(pdb==NULL)
+      {
+         INIT(pdb, PDB);
+         q = pdb;
+      }
+      else
+      {
+         ALLOCNEXT(q, PDB);
+      }
+      if(q==NULL)
+      {
+         FREELIST(pdb, PDB);
+         return(NULL);
+      }
+      blCopyPDB(q, p);
+   }
+
+   if(pdb!=NULL)
+      blCopyConects(pdb, view->pdb);
+
+   return(pdb);
+}
+
+
+/************************************************************************/
+/*>static PDBVIEW *CreateFilteredView(PDB *pdb,
+                                      BOOL (*keep)(PDB *p, void *data),
+                                      void *data)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \param[in]     *keep    Function returning TRUE for atoms to keep
+   \param[in]     *data    Passed through to keep()
+   \return                 Malloc'd view or NULL
+
+   Builds a view of the atoms for which keep() returns TRUE.
+
+-  17.10.26 Original   By: ACRM
+*/
+static PDBVIEW *CreateFilteredView(PDB *pdb,
+                                   BOOL (*keep)(PDB *p, void *data),
+                                   void *data)
+{
+   PDBVIEW *view;
+   PDB     *p;
+   int     natoms = 0;
+
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      if((*keep)(p, data))
+         natoms++;
+   }
+
+   if((view=AllocView(pdb, natoms))==NULL)
+      return(NULL);
+
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      if((*keep)(p, data))
+         view->atoms[view->natoms++] = p;
+   }
+
+   return(view);
+}
+
+
+/************************************************************************/
+/*>static PDBVIEW *CreateRangeView(PDB *pdb, PDB *start, PDB *stop,
+                                   BOOL outside)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \param[in]     *start   First atom of the range
+   \param[in]     *stop    Atom after the end of the range (or NULL)
+   \param[in]     outside  Take the atoms outside rather than inside
+                           the range
+   \return                 Malloc'd view or NULL
+
+-  17.10.26 Original   By: ACRM
+*/
+static PDBVIEW *CreateRangeView(PDB *pdb, PDB *start, PDB *stop,
+                                BOOL outside)
+{
+   PDBVIEW *view = NULL;
+   PDB     *p;
+   int     pass,
+           natoms = 0;
+   BOOL    inRange;
+
+   /* Pass 0 counts the atoms, pass 1 fills in the view                 */
+   for(pass=0; pass<2; pass++)
+   {
+      if(pass==1)
+      {
+         if((view=AllocView(pdb, natoms))==NULL)
+            return(NULL);
+      }
+
+      inRange = FALSE;
+      for(p=pdb; p!=NULL; NEXT(p))
+      {
+         if(p==start) inRange = TRUE;
+         if(p==stop)  inRange = FALSE;
+
+         if(inRange != outside)
+         {
+            if(pass==0)
+               natoms++;
+            else
+               view->atoms[view->natoms++] = p;
+         }
+      }
+   }
+
+   return(view);
+}
+
+
+/************************************************************************/
+/* Selection tests used to mirror the AsCopy routines
+*/
+static BOOL KeepNotHydrogen(PDB *p, void *data)
+{
+   return((p->atnam[0] != 'H') && (p->atnam[0] != 'D'));
+}
+
+static BOOL KeepNotWater(PDB *p, void *data)
+{
+   return(ISWATER(p) ? FALSE : TRUE);
+}
+
+static BOOL KeepAtomInList(PDB *p, void *data)
+{
+   ATOMLIST *list = (ATOMLIST *)data;
+   int      i;
+
+   for(i=0; i<list->nsel; i++)
+   {
+      if(!strncmp(p->atnam, list->sel[i], 4))
+         return(TRUE);
+   }
+   return(FALSE);
+}
+
+static BOOL KeepCa(PDB *p, void *data)
+{
+   return(strncmp(p->atnam, "CA  ", 4) ? FALSE : TRUE);
+}
+
+static BOOL KeepChain(PDB *p, void *data)
+{
+   return(CHAINMATCH(p->chain, (char *)data));
+}
+
+
+/************************************************************************/
+/*>PDBVIEW *blStripHPDBView(PDB *pdb)
+   ----------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \return                 Malloc'd view or NULL
+
+   Creates a view excluding hydrogens (and deuteriums) using the same
+   rules as blStripHPDBAsCopy()
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBVIEW *blStripHPDBView(PDB *pdb)
+{
+   return(CreateFilteredView(pdb, KeepNotHydrogen, NULL));
+}
+
+
+/************************************************************************/
+/*>PDBVIEW *blStripWatersPDBView(PDB *pdb)
+   ---------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \return                 Malloc'd view or NULL
+
+   Creates a view excluding waters using the same rules as 
+   blStripWatersPDBAsCopy()
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBVIEW *blStripWatersPDBView(PDB *pdb)
+{
+   return(CreateFilteredView(pdb, KeepNotWater, NULL));
+}
+
+
+/************************************************************************/
+/*>PDBVIEW *blSelectAtomsPDBView(PDB *pdb, int nsel, char **sel)
+   -------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \param[in]     nsel     Number of atom types to keep
+   \param[in]     **sel    List of atom types to keep (4 characters,
+                           space padded)
+   \return                 Malloc'd view or NULL
+
+   Creates a view of the specified atom types using the same rules as
+   blSelectAtomsPDBAsCopy()
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBVIEW *blSelectAtomsPDBView(PDB *pdb, int nsel, char **sel)
+{
+   ATOMLIST list;
+
+   list.sel  = sel;
+   list.nsel = nsel;
+   return(CreateFilteredView(pdb, KeepAtomInList, (void *)&list));
+}
+
+
+/************************************************************************/
+/*>PDBVIEW *blSelectCaPDBView(PDB *pdb)
+   ------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \return                 Malloc'd view or NULL
+
+   Creates a view of the CA atoms. Unlike blSelectCaPDB() the linked
+   list is not modified.
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBVIEW *blSelectCaPDBView(PDB *pdb)
+{
+   return(CreateFilteredView(pdb, KeepCa, NULL));
+}
+
+
+/************************************************************************/
+/*>PDBVIEW *blGetPDBChainView(PDB *pdb, char *chain)
+   -------------------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \param[in]     *chain   Chain label
+   \return                 Malloc'd view or NULL
+
+   Creates a view of a single chain using the same rules as
+   blGetPDBChainAsCopy()
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBVIEW *blGetPDBChainView(PDB *pdb, char *chain)
+{
+   return(CreateFilteredView(pdb, KeepChain, (void *)chain));
+}
+
+
+/************************************************************************/
+/*>PDBVIEW *blExtractZonePDBView(PDB *pdb,
+                                 char *chain1, int resnum1, char *insert1,
+                                 char *chain2, int resnum2, char *insert2)
+   -----------------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \param[in]     *chain1  Start residue chain name
+   \param[in]     resnum1  Start residue number
+   \param[in]     *insert1 Start residue insert code
+   \param[in]     *chain2  End residue chain name
+   \param[in]     resnum2  End residue number
+   \param[in]     *insert2 End residue insert code
+   \return                 Malloc'd view or NULL if the zone was not
+                           found
+
+   Creates a view of a zone using the same rules as 
+   blExtractZonePDBAsCopy(): if either end residue is missing, the zone
+   is taken from the residues that would follow it.
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBVIEW *blExtractZonePDBView(PDB *pdb,
+                              char *chain1, int resnum1, char *insert1,
+                              char *chain2, int resnum2, char *insert2)
+{
+   PDB *p,
+       *start = NULL,
+       *last  = NULL;
+
+   if((start=blFindResidue(pdb, chain1, resnum1, insert1))==NULL)
+   {
+      for(p=pdb; p!=NULL; NEXT(p))
+      {
+         if(CHAINMATCH(p->chain,chain1) &&
+            ((p->resnum > resnum1) ||
+             ((p->resnum == resnum1) &&
+              (p->insert[0] >= insert1[0]))))
+         {
+            start = p;
+            break;
+         }
+      }
+   }
+   if(start==NULL)
+      return(NULL);
+
+   if((last=blFindResidue(pdb, chain2, resnum2, insert2))!=NULL)
+   {
+      PDB *nextres = blFindNextResidue(last);
+      for(; last->next!=nextres; NEXT(last)) ;
+   }
+   else
+   {
+      for(p=start; p!=NULL; NEXT(p))
+      {
+         if(CHAINMATCH(p->chain,chain2) &&
+            ((p->resnum > resnum2) ||
+             ((p->resnum == resnum2) &&
+              (p->insert[0] > insert2[0]))))
+         {
+            break;
+         }
+         if(CHAINMATCH(chain1,chain2) &&
+            !CHAINMATCH(p->chain,chain2))
+         {
+            break;
+         }
+         last = p;
+      }
+   }
+   if(last==NULL)
+      return(NULL);
+
+   return(CreateRangeView(pdb, start, last->next, FALSE));
+}
+
+
+/************************************************************************/
+/*>PDBVIEW *blExtractNotZonePDBView(PDB *pdb,
+                                    char *chain1, int resnum1, 
+                                    char *insert1, char *chain2,
+                                    int resnum2, char *insert2)
+   ----------------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb     PDB linked list
+   \param[in]     *chain1  Start residue chain name
+   \param[in]     resnum1  Start residue number
+   \param[in]     *insert1 Start residue insert code
+   \param[in]     *chain2  End residue chain name
+   \param[in]     resnum2  End residue number
+   \param[in]     *insert2 End residue insert code
+   \return                 Malloc'd view or NULL if either residue was
+                           not found
+
+   Creates a view of the atoms outside a zone using the same rules as
+   blExtractNotZonePDBAsCopy()
+
+-  17.10.26 Original   By: ACRM
+*/
+PDBVIEW *blExtractNotZonePDBView(PDB *pdb,
+                                 char *chain1, int resnum1, char *insert1,
+                                 char *chain2, int resnum2, char *insert2)
+{
+   PDB *start, 
+       *stop;
+
+   if((start = blFindResidue(pdb, chain1, resnum1, insert1)) == NULL)
+      return(NULL);
+   if((stop  = blFindResidue(pdb, chain2, resnum2, insert2)) == NULL)
+      return(NULL);
+   stop = blFindNextResidue(stop);
+
+   return(CreateRangeView(pdb, start, stop, TRUE));
+}
+
+
+/************************************************************************/
+/*>void blGetCofGPDBView(PDBVIEW *view, VEC3F *cg)
+   -----------------------------------------------
+*//**
+
+   \param[in]     *view    View
+   \param[out]    *cg      Centre of geometry of the atoms in the view
+
+   Finds the CofG of the atoms in a view, ignoring NULL (9999.0)
+   coordinates. blGetCofGPDB() calls this with a view of the whole
+   linked list.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blGetCofGPDBView(PDBVIEW *view, VEC3F *cg)
+{
+   PDB *p;
+   int i,
+       natom = 0;
+
+   cg->x = 0.0;
+   cg->y = 0.0;
+   cg->z = 0.0;
+   for(p=PDBVIEW_FIRST(view, i); p!=NULL; p=PDBVIEW_NEXT(view, p, i))
+   {
+      if(p->x < 9999.0 || p->y < 9999.0 || p->z < 9999.0)
+      {
+         cg->x += p->x;
+         cg->y += p->y;
+         cg->z += p->z;
+         natom++;
+      }
+   }
+   if(natom)
+   {
+      cg->x /= natom;
+      cg->y /= natom;
+      cg->z /= natom;
+   }
+}
+
+
+/************************************************************************/
+/*>REAL blCalcRMSPDBView(PDBVIEW *view1, PDBVIEW *view2)
+   -----------------------------------------------------
+*//**
+
+   \param[in]     *view1   First view
+   \param[in]     *view2   Second view
+   \return                 RMS deviation
+
+   Calculates the RMSD between equivalent atoms of two views. As with
+   blCalcRMSPDB() no fitting is done and the atoms are paired in order.
+
+-  17.10.26 Original   By: ACRM
+*/
+REAL blCalcRMSPDBView(PDBVIEW *view1, PDBVIEW *view2)
+{
+   PDB  *p, *q;
+   int  i, j,
+        count = 0;
+   REAL dist  = (REAL)0.0;
+
+   for(p=PDBVIEW_FIRST(view1, i), q=PDBVIEW_FIRST(view2, j);
+       p!=NULL && q!=NULL;
+       p=PDBVIEW_NEXT(view1, p, i), q=PDBVIEW_NEXT(view2, q, j))
+   {
+      dist += DISTSQ(p,q);
+      count++;
+   }
+
+   return((REAL)((count)?sqrt((double)(dist/(REAL)count)):0.0));
+}
+
+
+/************************************************************************/
+/*>BOOL blFitPDBView(PDBVIEW *refView, PDBVIEW *fitView, REAL rm[3][3])
+   --------------------------------------------------------------------
+*//**
+
+   \param[in]     *refView  Reference view
+   \param[in]     *fitView  View to be fitted
+   \param[out]    rm        Rotation matrix (may be input as NULL)
+   \return                  Success
+
+   Fits the atoms of fitView onto the equivalent atoms of refView. The
+   resulting transformation is applied to the whole of the linked list
+   underlying fitView, so fitting on (say) CA atoms moves the complete
+   structure. The reference structure is not moved. Returns FALSE if
+   the views differ in size or have fewer than 3 atoms, in which case
+   nothing is moved.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blFitPDBView(PDBVIEW *refView, PDBVIEW *fitView, REAL rm[3][3])
+{
+   REAL  RotMat[3][3];
+   COOR  *ref_coor = NULL,
+         *fit_coor = NULL;
+   VEC3F ref_CofG,
+         fit_CofG,
+         shift;
+   PDB   *p;
+   int   NCoor     = 0,
+         i, j;
+   BOOL  RetVal;
+
+   if((refView->natoms != fitView->natoms) || (refView->natoms < 3))
+      return(FALSE);
+   NCoor = refView->natoms;
+
+   if(((ref_coor=(COOR *)malloc(NCoor * sizeof(COOR)))==NULL) ||
+      ((fit_coor=(COOR *)malloc(NCoor * sizeof(COOR)))==NULL))
+   {
+      if(ref_coor) free(ref_coor);
+      return(FALSE);
+   }
+
+   blGetCofGPDBView(refView, &ref_CofG);
+   blGetCofGPDBView(fitView, &fit_CofG);
+
+   /* Create coordinate arrays centred on the origin                    */
+   for(p=PDBVIEW_FIRST(refView, i); p!=NULL; p=PDBVIEW_NEXT(refView,p,i))
+   {
+      ref_coor[i].x = p->x - ref_CofG.x;
+      ref_coor[i].y = p->y - ref_CofG.y;
+      ref_coor[i].z = p->z - ref_CofG.z;
+   }
+   for(p=PDBVIEW_FIRST(fitView, i); p!=NULL; p=PDBVIEW_NEXT(fitView,p,i))
+   {
+      fit_coor[i].x = p->x - fit_CofG.x;
+      fit_coor[i].y = p->y - fit_CofG.y;
+      fit_coor[i].z = p->z - fit_CofG.z;
+   }
+
+   if((RetVal = blMatfit(ref_coor,fit_coor,RotMat,NCoor,NULL,FALSE)))
+   {
+      /* Move the whole fitted linked list                              */
+      shift.x = -fit_CofG.x;
+      shift.y = -fit_CofG.y;
+      shift.z = -fit_CofG.z;
+      blTranslatePDB(fitView->pdb, shift);
+      blApplyMatrixPDB(fitView->pdb, RotMat);
+      blTranslatePDB(fitView->pdb, ref_CofG);
+
+      if(rm!=NULL)
+      {
+         for(i=0; i<3; i++)
+            for(j=0; j<3; j++)
+               rm[i][j] = RotMat[i][j];
+      }
+   }
+
+   free(ref_coor);
+   free(fit_coor);
+
+   return(RetVal);
+}
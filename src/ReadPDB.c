@@ -3,11 +3,11 @@
 
    \file       ReadPDB.c
    
-   \version    V3.13
-   \date       11.12.20
+   \version    V3.24
+   \date       17.10.26
    \brief      Read coordinates from a PDB file 
    
-   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1988-2020
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1988-2026
    \author     Dr. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -68,6 +68,10 @@
    gPDBMultiNMR      - the PDB file contained multiple models
    gPDBXML           - the file was in PDBML (XML) format
    gPDBModelNotFound - the requested model was not found
+   These flags are shared by all threads and are set without locking,
+   so they are not meaningful if more than one thread is reading at 
+   once (e.g. in blFindMetalSitesFiles()). The readers are otherwise
+   safe to call from several threads at once.
    
 
 NOTE:  Although some of the fields are represented by a single character,
@@ -240,6 +244,28 @@ BUGS:  25.01.05 Note the multiple occupancy code won't work properly for
 -  V3.12 07.08.18 Increased text buffer sizes to silence gcc 7.3.1 
                   with -O2 By: ACRM
 -  V3.13 11.12.20 More checks before popen() prototype
+-  V3.14 17.10.26 Added blDoReadPDBFiltered() and blReadPDBFiltered()
+                  which skip unwanted records before they are parsed.
+                  blDoReadPDB() is now a wrapper to 
+                  blDoReadPDBFiltered()
+-  V3.15 17.10.26 Added blReadPDBHeader(). Decompression moved into
+                  OpenUncompressedPDB()
+-  V3.16 17.10.26 Added blDoReadPDBParallel() and blReadPDBParallel()
+-  V3.17 17.10.26 Added blDoReadPDBFile(), blDoReadPDBBuffer() and 
+                  blReadPDBFile(). blDoReadPDBParallel() memory maps 
+                  regular files and takes fields straight from the
+                  mapped data
+-  V3.18 17.10.26 CONECT records are stored after all atoms have been
+                  read, finding atoms through an index by atom number
+-  V3.19 17.10.26 Atom and residue numbers may be hybrid-36
+-  V3.20 17.10.26 ApplyReadFilter() uses blDeleteAtomsPDB()
+-  V3.21 17.10.26 Counts lines and atoms and times the readers when
+                  compiled with INSTRUMENT_SUPPORT
+-  V3.22 17.10.26 The chunks are parsed with blRunThreadPool()
+-  V3.23 17.10.26 Compressed files are uncompressed into a temporary
+                  file from mkstemp() so that threads do not share it
+-  V3.24 17.10.26 The whole PDB readers store the CONECT records as a
+                  bond graph in wpdb->bonds
 
 *************************************************************************/
 /* Doxygen
@@ -272,6 +298,38 @@ BUGS:  25.01.05 Note the multiple occupancy code won't work properly for
    A lower level routine giving full control over reading all or only
    ATOM records, occupancy rankings and model numbers.
 
+   #FUNCTION blDoReadPDBFiltered() 
+   As blDoReadPDB(), but takes a PDBREADFILTER so that only the wanted
+   chains, record types, atom names and model are parsed and stored
+
+   #FUNCTION blReadPDBFiltered() 
+   Reads the highest occupancy atoms which pass a PDBREADFILTER
+
+   #FUNCTION blInitPDBReadFilter() 
+   Initializes a PDBREADFILTER to accept everything in the first model
+
+   #FUNCTION blDoReadPDBParallel() 
+   As blDoReadPDBFiltered(), but splits the file into chunks which are
+   parsed in parallel
+
+   #FUNCTION blReadPDBParallel() 
+   Reads the highest occupancy atoms using several threads
+
+   #FUNCTION blDoReadPDBFile() 
+   As blDoReadPDBParallel(), but takes a file name. Regular files are
+   memory mapped
+
+   #FUNCTION blDoReadPDBBuffer() 
+   As blDoReadPDBParallel(), but reads a PDB file which is already in
+   memory
+
+   #FUNCTION blReadPDBFile() 
+   Reads the highest occupancy atoms from a named, memory mapped, file
+
+   #FUNCTION blReadPDBHeader() 
+   Reads just the header of a PDB file into a WHOLEPDB structure,
+   stopping at the first coordinate record
+
    #FUNCTION blDoReadPDBML() 
    A lower level routine giving full control over reading all or only
    ATOM records, occupancy rankings and model numbers from a PDBML XML
@@ -326,12 +384,21 @@ BUGS:  25.01.05 Note the multiple occupancy code won't work properly for
 #include <libxml/tree.h>
 #endif
 
+#ifndef MS_WINDOWS     /* Required to memory map files                  */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
 #include "SysDefs.h"
 #include "MathType.h"
 #include "pdb.h"
 #include "macros.h"
 #include "fsscanf.h"
 #include "general.h"
+#include "bondgraph.h"
+#include "instrument.h"
+#include "threadpool.h"
 
 #define MAXPARTIAL 8
 #define SMALL      0.000001
@@ -343,6 +410,47 @@ BUGS:  25.01.05 Note the multiple occupancy code won't work properly for
 #define LOCATION_COORDINATES 1
 #define LOCATION_TRAILER     2
 
+/* Does a line (which need not be null-terminated) start with a given
+   6-character record name?
+*/
+#define LINE_IS_RECORD(line, len, rec)                                   \
+   (((len) >= 6) && !strncmp((line), (rec), 6))
+
+/* A header or trailer line found by blDoReadPDBParallel()              */
+typedef struct
+{
+   char *line;               /* Start of the line in the file buffer    */
+   int  location;            /* LOCATION_HEADER or LOCATION_TRAILER     */
+}  READLINEREF;
+
+/* A line-aligned chunk of the file buffer handled by one thread in
+   blDoReadPDBParallel(). Atoms are parsed into a private linked list
+   which is stitched onto the others in file order afterwards.
+*/
+typedef struct
+{
+   PDBREADFILTER *filter;
+   READLINEREF   *lines;        /* Header and trailer lines             */
+   PDB           *pdb,          /* Atoms read from this chunk           */
+                 *last;
+   char          *start,        /* First character of the chunk         */
+                 *stop;         /* One past the last character          */
+   int           OccRank,
+                 ModelNum,
+                 startLocation, /* Location at the start of the chunk   */
+                 endLocation,   /* Location at the end (-1 if unchanged)*/
+                 startModel,    /* MODEL records before the chunk       */
+                 nModels,       /* MODEL records in the chunk           */
+                 natoms,
+                 nPartial,      /* Partial occupancy atoms in the chunk */
+                 nlines,
+                 maxlines;
+   BOOL          DoWhole,
+                 AllAtoms,
+                 modelFound,    /* Wanted model found in the chunk      */
+                 error;
+}  READCHUNK;
+
 #ifdef XML_SUPPORT
 #define APPEND_STRINGLIST(x, y)                 \
    if(((y)!=NULL) && ((x)!=NULL)) {             \
@@ -359,7 +467,45 @@ static BOOL StoreOccRankAtom(int OccRank, PDB multi[MAXPARTIAL],
                                int *natom);
 static void ProcessElementField(char *element, char *element_field);
 static void ProcessChargeField(int *charge, char *charge_field);
-static void StoreConectRecords(WHOLEPDB *wpdb, char *buffer);
+static BOOL StoreConectRecords(WHOLEPDB *wpdb);
+static FILE *OpenUncompressedPDB(FILE *fpin, char *tmpfile);
+static BOOL KeepRecord(char *buffer, int len, PDBREADFILTER *filter);
+static BOOL KeepAtom(PDB *p, PDBREADFILTER *filter);
+static BOOL RejectAtom(PDB *p, APTR filter);
+static BOOL AtomNameInList(char *atnam, char **names, int nnames);
+static void ApplyReadFilter(WHOLEPDB *wpdb, PDBREADFILTER *filter);
+static WHOLEPDB *ReadPDBFiltered(FILE *fpin, int OccRank, BOOL DoWhole,
+                                 PDBREADFILTER *filter);
+static WHOLEPDB *ReadPDBBuffer(char *buffer, long length, int OccRank,
+                               BOOL DoWhole, PDBREADFILTER *filter,
+                               int nThreads);
+static char *MapPDBFile(FILE *fp, long *length, char **map, 
+                        size_t *mapsize);
+static void UnmapPDBFile(char *map, size_t mapsize);
+static char *ReadFileIntoBuffer(FILE *fp, long *length);
+static char *GetBufferLine(char *line, char *stop, char *buffer, 
+                           int maxlen);
+static void *ScanChunk(void *arg);
+static void *ParseChunk(void *arg);
+static void ReadCoordColumns(char *line, int len, char *record_type,
+                             int *atnum, char *atnam, char *resnam,
+                             char *chain, int *resnum, char *insert,
+                             double *x, double *y, double *z, 
+                             double *occ, double *bval, char *segid,
+                             char *element, char *charge);
+static void ColumnString(char *line, int len, int column, int width,
+                         char *string);
+static void ColumnHybrid36(char *line, int len, int column, int width,
+                           int *value);
+static void ColumnDouble(char *line, int len, int column, int width,
+                         double *value);
+static BOOL StoreLineRef(READCHUNK *chunk, char *line, int location);
+static BOOL IsFullOccupancy(PDB *p, int OccRank);
+static BOOL StitchChunks(WHOLEPDB *wpdb, READCHUNK *chunks, int nchunks,
+                         int OccRank);
+static BOOL StoreChunkLines(WHOLEPDB *wpdb, READCHUNK *chunks, 
+                            int nchunks);
+static void FreeChunks(READCHUNK *chunks, int nchunks);
 #ifdef XML_SUPPORT
 static BOOL SetPDBDateField(char *pdb_date, char *pdbml_date);
 static void ParseHeaderRecordsPDBML(WHOLEPDB *wpdb, xmlDoc *document);
@@ -391,6 +537,13 @@ extern FILE *popen(const char *, const char *);
 #if !defined(__APPLE__) && !defined(__USE_POSIX2)
 extern int pclose(FILE *);
 #endif
+#if !defined(MS_WINDOWS) && !defined(__USE_POSIX)
+extern int fileno(FILE *);
+#endif
+#if !defined(MS_WINDOWS) && !defined(__USE_XOPEN_EXTENDED) && \
+    !defined(__USE_XOPEN2K8)
+extern int mkstemp(char *);
+#endif
 
 
 /************************************************************************/
@@ -634,6 +787,229 @@ PDB *blReadPDBAtomsOccRank(FILE *fp, int *natom, int OccRank)
    return(pdb);
 }
 
+/************************************************************************/
+/*>PDB *blReadPDBFiltered(FILE *fp, int *natom, PDBREADFILTER *filter)
+   -------------------------------------------------------------------
+*//**
+
+   \param[in]     *fp      A pointer to type FILE in which the
+                           .PDB file is stored.
+   \param[out]    *natom   Number of atoms read. -1 if error.
+   \param[in]     *filter  Which records to read (NULL reads all)
+   \return                 A pointer to the first allocated item of
+                           the PDB linked list
+
+   Reads a PDB file into a PDB linked list keeping only the atoms which
+   pass the filter. Unwanted records are skipped without being parsed 
+   or allocated, so reading (say) just the CA atoms of a large file is 
+   much cheaper than reading everything and calling blSelectCaPDB().
+   As with blReadPDB(), the highest occupancy atoms are read.
+
+-  17.10.26 Original    By: ACRM
+*/
+PDB *blReadPDBFiltered(FILE *fp, int *natom, PDBREADFILTER *filter)
+{
+   PDB *pdb = NULL;
+   WHOLEPDB *wpdb;
+   *natom=(-1);
+
+   if((wpdb = blDoReadPDBFiltered(fp, 1, FALSE, filter))!=NULL)
+   {
+      blFreeStringList(wpdb->header);
+      blFreeStringList(wpdb->trailer);
+      *natom = wpdb->natoms;
+      pdb = wpdb->pdb;
+      free(wpdb);
+
+      pdb = blRemoveAlternates(pdb);
+   }
+   
+   return(pdb);
+}
+
+/************************************************************************/
+/*>PDB *blReadPDBParallel(FILE *fp, int *natom, int nThreads)
+   ----------------------------------------------------------
+*//**
+
+   \param[in]     *fp       A pointer to type FILE in which the
+                            .PDB file is stored.
+   \param[out]    *natom    Number of atoms read. -1 if error.
+   \param[in]     nThreads  Number of threads to use
+   \return                  A pointer to the first allocated item of
+                            the PDB linked list
+
+   Reads a PDB file into a PDB linked list, parsing the coordinate 
+   records with several threads. The result is the same as from
+   blReadPDB(). Threads are only used if the library was compiled
+   with PTHREAD_SUPPORT defined.
+
+-  17.10.26 Original    By: ACRM
+*/
+PDB *blReadPDBParallel(FILE *fp, int *natom, int nThreads)
+{
+   PDB           *pdb = NULL;
+   WHOLEPDB      *wpdb;
+   PDBREADFILTER filter;
+   *natom=(-1);
+
+   blInitPDBReadFilter(&filter);
+
+   if((wpdb = blDoReadPDBParallel(fp, 1, FALSE, &filter, nThreads))!=NULL)
+   {
+      blFreeStringList(wpdb->header);
+      blFreeStringList(wpdb->trailer);
+      *natom = wpdb->natoms;
+      pdb = wpdb->pdb;
+      free(wpdb);
+
+      pdb = blRemoveAlternates(pdb);
+   }
+   
+   return(pdb);
+}
+
+/************************************************************************/
+/*>PDB *blReadPDBFile(char *filename, int *natom)
+   ----------------------------------------------
+*//**
+
+   \param[in]     *filename PDB file name
+   \param[out]    *natom    Number of atoms read. -1 if error.
+   \return                  A pointer to the first allocated item of
+                            the PDB linked list
+
+   Reads a named PDB file into a PDB linked list. The result is the
+   same as from blReadPDB(), but regular files are memory mapped and 
+   parsed in place rather than being read a line at a time through
+   stdio.
+
+-  17.10.26 Original    By: ACRM
+*/
+PDB *blReadPDBFile(char *filename, int *natom)
+{
+   PDB           *pdb = NULL;
+   WHOLEPDB      *wpdb;
+   PDBREADFILTER filter;
+   *natom=(-1);
+
+   blInitPDBReadFilter(&filter);
+
+   if((wpdb = blDoReadPDBFile(filename, 1, FALSE, &filter, 1))!=NULL)
+   {
+      blFreeStringList(wpdb->header);
+      blFreeStringList(wpdb->trailer);
+      *natom = wpdb->natoms;
+      pdb = wpdb->pdb;
+      free(wpdb);
+
+      pdb = blRemoveAlternates(pdb);
+   }
+   
+   return(pdb);
+}
+
+/************************************************************************/
+/*>void blInitPDBReadFilter(PDBREADFILTER *filter)
+   -----------------------------------------------
+*//**
+
+   \param[out]    *filter  Filter to initialize
+
+   Sets a filter to read ATOM and HETATM records from all chains in the
+   first model. Set the chains and atnams arrays (and the counts) to
+   restrict the chains and atom names, modelNum to 0 to read all 
+   models, and clear atoms or hetatms to skip those record types.
+
+-  17.10.26 Original    By: ACRM
+*/
+void blInitPDBReadFilter(PDBREADFILTER *filter)
+{
+   filter->chains   = NULL;
+   filter->atnams   = NULL;
+   filter->nchains  = 0;
+   filter->natnams  = 0;
+   filter->modelNum = 1;
+   filter->atoms    = TRUE;
+   filter->hetatms  = TRUE;
+}
+
+/************************************************************************/
+/*>WHOLEPDB *blReadPDBHeader(FILE *fpin)
+   -------------------------------------
+*//**
+
+   \param[in]     *fpin    A pointer to type FILE in which the
+                           .PDB file is stored.
+   \return                 A pointer to a malloc'd WHOLEPDB structure
+                           containing only the header (NULL on error)
+
+   Reads the header records of a PDB file, stopping at the first ATOM,
+   HETATM or MODEL record. No coordinates are read or stored so this is
+   the cheap way to get header information (via blScanPDBHeader() or 
+   the blXxxxWholePDB() routines) for large numbers of files.
+
+   Compressed files are handled as by blDoReadPDB(). For PDBML files, 
+   which have no separate header, the whole file is read and the 
+   coordinates discarded.
+
+-  17.10.26 Original    By: ACRM
+*/
+WHOLEPDB *blReadPDBHeader(FILE *fpin)
+{
+   WHOLEPDB *wpdb = NULL;
+   FILE     *fp;
+   char     buffer[MAXBUFF],
+            tmpfile[80];
+
+   if((fp = OpenUncompressedPDB(fpin, tmpfile))==NULL)
+      return(NULL);
+
+   if(blCheckFileFormatPDBML(fp))
+   {
+#ifdef XML_SUPPORT
+      if((wpdb = blDoReadPDBML(fp, TRUE, 1, 1, TRUE))!=NULL)
+      {
+         if(wpdb->pdb != NULL)
+            FREELIST(wpdb->pdb, PDB);
+         wpdb->pdb    = NULL;
+         wpdb->natoms = 0;
+      }
+#endif
+   }
+   else if((wpdb=(WHOLEPDB *)malloc(sizeof(WHOLEPDB)))!=NULL)
+   {
+      wpdb->pdb     = NULL;
+      wpdb->header  = NULL;
+      wpdb->trailer = NULL;
+      wpdb->bonds   = NULL;
+      wpdb->natoms  = 0;
+
+      while(fgets(buffer,MAXBUFF-1,fp))
+      {
+         if(!strncmp(buffer, "ATOM  ", 6) ||
+            !strncmp(buffer, "HETATM", 6) ||
+            !strncmp(buffer, "MODEL ", 6))
+            break;
+
+         if((wpdb->header = blStoreString(wpdb->header, buffer))==NULL)
+         {
+            free(wpdb);
+            wpdb = NULL;
+            break;
+         }
+      }
+   }
+
+   if(tmpfile[0])
+   {
+      fclose(fp);
+      unlink(tmpfile);
+   }
+
+   return(wpdb);
+}
+
 /************************************************************************/
 /*>WHOLEPDB *blDoReadPDB(FILE *fpin, BOOL AllAtoms, int OccRank,
                          int ModelNum, BOOL DoWhole)
@@ -731,6 +1107,7 @@ PDB *blReadPDBAtomsOccRank(FILE *fp, int *natom, int OccRank)
 -  28.04.15 V3.5  Removed rewind. Call to blDoReadPDBML() returns WHOLEPDB
                   instead of PDB.  By: CTP
 -  21.07.15       Changed atomType to atomInfo   By: ACRM
+-  17.10.26 V3.14 Now just calls blDoReadPDBFiltered()
 
    We need to deal with freeing wpdb if we are returning null.
    Also need to deal with some sort of error code
@@ -740,6 +1117,79 @@ WHOLEPDB *blDoReadPDB(FILE *fpin,
                       int  OccRank,
                       int  ModelNum,
                       BOOL DoWhole)
+{
+   PDBREADFILTER filter;
+
+   blInitPDBReadFilter(&filter);
+   filter.hetatms  = AllAtoms;
+   filter.modelNum = ModelNum;
+
+   return(blDoReadPDBFiltered(fpin, OccRank, DoWhole, &filter));
+}
+
+/************************************************************************/
+/*>WHOLEPDB *blDoReadPDBFiltered(FILE *fpin, int OccRank, BOOL DoWhole,
+                                 PDBREADFILTER *filter)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *fpin    A pointer to type FILE in which the
+                           .PDB file is stored.
+   \param[in]     OccRank  Occupancy ranking
+   \param[in]     DoWhole  Read the whole PDB file rather than just 
+                           the ATOM/HETATM records.
+   \param[in]     *filter  Which records to read (NULL reads ATOM and
+                           HETATM records from all models)
+   \return                 A pointer to a malloc'd WHOLEPDB structure
+
+   The work horse for blDoReadPDB(). Coordinate records are checked 
+   against the filter using the fixed PDB columns (record type, chain
+   and atom name) before they are parsed with fsscanf() or any memory 
+   is allocated. Records from unwanted models are skipped as before.
+   Partial occupancy handling is applied to the atoms which pass the
+   filter. Header and trailer are unaffected by the filter.
+
+   PDBML files are read in full and then filtered.
+
+-  17.10.26 Original, split from blDoReadPDB()    By: ACRM
+-  17.10.26 Reads hybrid-36 atom and residue numbers   By: ACRM
+-  17.10.26 Now a wrapper to ReadPDBFiltered() which is timed  By: ACRM
+*/
+WHOLEPDB *blDoReadPDBFiltered(FILE *fpin, int OccRank, BOOL DoWhole,
+                              PDBREADFILTER *filter)
+{
+   WHOLEPDB *wpdb;
+
+   BLTIMERSTART(BLTIMER_READPDB);
+   wpdb = ReadPDBFiltered(fpin, OccRank, DoWhole, filter);
+   if(wpdb != NULL)
+      BLCOUNT(BLCOUNT_ATOMS_ALLOCATED, wpdb->natoms);
+   BLTIMERSTOP(BLTIMER_READPDB);
+
+   return(wpdb);
+}
+
+/************************************************************************/
+/*>static WHOLEPDB *ReadPDBFiltered(FILE *fpin, int OccRank, BOOL DoWhole,
+                                    PDBREADFILTER *filter)
+   -----------------------------------------------------------------------
+*//**
+
+   \param[in]     *fpin    A pointer to type FILE in which the
+                           .PDB file is stored.
+   \param[in]     OccRank  Occupancy ranking
+   \param[in]     DoWhole  Read the whole PDB file rather than just 
+                           the ATOM/HETATM records.
+   \param[in]     *filter  Which records to read (NULL reads ATOM and
+                           HETATM records from all models)
+   \return                 A pointer to a malloc'd WHOLEPDB structure
+
+   Does the work of blDoReadPDBFiltered()
+
+-  17.10.26 Original, split from blDoReadPDBFiltered()    By: ACRM
+*/
+static WHOLEPDB *ReadPDBFiltered(FILE *fpin, int OccRank, BOOL DoWhole,
+                                 PDBREADFILTER *filter)
 {
    char     record_type[8],
             atnambuff[8],
@@ -771,17 +1221,13 @@ WHOLEPDB *blDoReadPDB(FILE *fpin,
    PDB      *p = NULL,
             multi[MAXPARTIAL];   /* Temporary storage for partial occ   */
    WHOLEPDB *wpdb = NULL;
-   BOOL     pdbml_format;
+   BOOL     pdbml_format,
+            AllAtoms;
+   int      ModelNum;
    
-
-#if defined(GUNZIP_SUPPORT) && !defined(MS_WINDOWS)
-   int      signature[3],
-            ch;
-   BOOL     gzipped_file = FALSE;
-#  ifndef SINGLE_CHAR_FILECHECK
-   int      i;
-#  endif
-#endif
+   /* Extract the record type and model settings from the filter       */
+   AllAtoms = (filter==NULL) ? TRUE : filter->hetatms;
+   ModelNum = (filter==NULL) ? 0    : filter->modelNum;
 
    if((wpdb=(WHOLEPDB *)malloc(sizeof(WHOLEPDB)))==NULL)
       return(NULL);
@@ -789,6 +1235,7 @@ WHOLEPDB *blDoReadPDB(FILE *fpin,
    wpdb->pdb         = NULL;
    wpdb->header      = NULL;
    wpdb->trailer     = NULL;
+   wpdb->bonds       = NULL;
    
    wpdb->natoms      = 0;
    CurAtom[0]        = '\0';
@@ -799,55 +1246,12 @@ WHOLEPDB *blDoReadPDB(FILE *fpin,
    gPDBXML           = FALSE;
    gPDBModelNotFound = TRUE;  /* Assume we haven't found the model      */
 
-#if defined(GUNZIP_SUPPORT) && !defined(MS_WINDOWS)
-   /* See whether this is a gzipped file                                */
-#  ifndef SINGLE_CHAR_FILECHECK
-   /* Default three character filetype check                            */
-   for(i=0; i<3; i++)
-      signature[i] = fgetc(fpin);
-   for(i=2; i>=0; i--)
-      ungetc(signature[i], fpin);
-   if(((signature[0] == (int)0x1F) &&    /* gzip                        */
-       (signature[1] == (int)0x8B) &&
-       (signature[2] == (int)0x08)) ||
-      ((signature[0] == (int)0x1F) &&    /* 05.06.07 compress           */
-       (signature[1] == (int)0x9D) &&
-       (signature[2] == (int)0x90)))
-   {
-      gzipped_file = TRUE;
-   }
-#  else
-   /* Single character filetype check                                   */
-   signature[0] = fgetc(fpin);
-   ungetc(signature[0], fpin);
-   if(signature[0] == (int)0x1F) gzipped_file = TRUE;
-#  endif
-
-   if(gzipped_file)
+   /* Decompress gzipped or compressed files                         */
+   if((fp = OpenUncompressedPDB(fpin, cmd))==NULL)
    {
-      /* It is gzipped so we'll open gunzip as a pipe and send the data
-         through that into a temporary file
-      */
-      sprintf(cmd,"gunzip >/tmp/readpdb_%d", (int)getpid());
-      if((fp = (FILE *)popen(cmd,"w"))==NULL)
-      {
-         wpdb->natoms = (-1);
-         return(NULL);
-      }
-      while((ch=fgetc(fpin))!=EOF)
-         fputc(ch, fp);
-      pclose(fp);
-
-      /* We now reopen the temporary file as our PDB input file         */
-      sprintf(cmd,"/tmp/readpdb_%d", (int)getpid());
-      if((fp = fopen(cmd,"r"))==NULL)
-      {
-         wpdb->natoms = (-1);
-         return(NULL);
-      }
+      wpdb->natoms = (-1);
+      return(NULL);
    }
-#endif   
-
 
    /* Check file format                                                 */
    pdbml_format = blCheckFileFormatPDBML(fp);
@@ -860,6 +1264,8 @@ WHOLEPDB *blDoReadPDB(FILE *fpin,
       blFreeWholePDB(wpdb);   /* free wpdb                              */
       wpdb = blDoReadPDBML(fp,AllAtoms,OccRank,ModelNum,DoWhole);
       if(cmd[0]) unlink(cmd); /* delete tmp file                        */
+      if(wpdb != NULL)
+         ApplyReadFilter(wpdb, filter);
       return(wpdb);           /* return PDB list                        */
 #else
       /* PDBML format not supported.                                    */
@@ -873,6 +1279,8 @@ WHOLEPDB *blDoReadPDB(FILE *fpin,
    
    while(fgets(buffer,159,fp))
    {
+      BLCOUNT(BLCOUNT_LINES_PARSED, 1);
+
       /*** Deal with counting model numbers                           ***/
       if(ModelNum != 0)          /* We are interested in model numbers  */
       {
@@ -925,20 +1333,26 @@ WHOLEPDB *blDoReadPDB(FILE *fpin,
          if(DoWhole)
          {
             wpdb->trailer = blStoreString(wpdb->trailer, buffer);
-            if(!strncmp(buffer, "CONECT", 6))
-               StoreConectRecords(wpdb, buffer);
          }
          
          continue;
       }
 
+      /* 17.10.26 Skip unwanted records before parsing them             */
+      if(!KeepRecord(buffer, strlen(buffer), filter))
+         continue;
+
       /* Read a record                                                  */
       if(fsscanf(buffer,
-            "%6s%5d%1x%5s%4s%1s%4d%1s%3x%8lf%8lf%8lf%6lf%6lf%6x%4s%2s%2s",
-                 record_type,&atnum,atnambuff,resnam,chain,&resnum,insert,
+            "%6s%5x%1x%5s%4s%1s%4x%1s%3x%8lf%8lf%8lf%6lf%6lf%6x%4s%2s%2s",
+                 record_type,atnambuff,resnam,chain,insert,
                  &x,&y,&z,&occ,&bval,segid,element_buff,charge_buff) 
          != EOF)
       {
+         /* 17.10.26 Atom and residue numbers may be hybrid-36          */
+         ColumnHybrid36(buffer, strlen(buffer),  6, 5, &atnum);
+         ColumnHybrid36(buffer, strlen(buffer), 22, 4, &resnum);
+
          if((!strncmp(record_type,"ATOM  ",6)) || 
             (!strncmp(record_type,"HETATM",6) && AllAtoms))
          {
@@ -1128,27 +1542,1481 @@ WHOLEPDB *blDoReadPDB(FILE *fpin,
                }
             }
          }
-         charge_buff[0] = '\0';
-         charge = 0;
+         charge_buff[0] = '\0';
+         charge = 0;
+      }
+   }
+
+   if(NPartial != 0)
+   {
+      if(!StoreOccRankAtom(OccRank,multi,NPartial,&wpdb->pdb,&p,
+                             &wpdb->natoms))
+      {
+         if(wpdb->pdb != NULL) FREELIST(wpdb->pdb, PDB);
+         wpdb->natoms = (-1);
+         if(cmd[0]) unlink(cmd);
+         return(NULL);
+      }
+   }
+
+   /* 17.10.26 CONECTs are stored once all the atoms have been read     */
+   if(DoWhole && !StoreConectRecords(wpdb))
+   {
+      blFreeWholePDB(wpdb);
+      if(cmd[0]) unlink(cmd);
+      return(NULL);
+   }
+
+   if(cmd[0]) unlink(cmd);
+
+   /* Return pointer to start of linked list                            */
+   return(wpdb);
+}
+
+/************************************************************************/
+/*>WHOLEPDB *blDoReadPDBParallel(FILE *fpin, int OccRank, BOOL DoWhole,
+                                 PDBREADFILTER *filter, int nThreads)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *fpin     A pointer to type FILE in which the
+                            .PDB file is stored.
+   \param[in]     OccRank   Occupancy ranking
+   \param[in]     DoWhole   Read the whole PDB file rather than just 
+                            the ATOM/HETATM records.
+   \param[in]     *filter   Which records to read (NULL reads ATOM and
+                            HETATM records from all models)
+   \param[in]     nThreads  Number of threads to use
+   \return                  A pointer to a malloc'd WHOLEPDB structure
+
+   As blDoReadPDBFiltered(), but the file is parsed from memory in 
+   nThreads line-aligned chunks which are dealt with in parallel.
+   Regular files are memory mapped; anything else (e.g. a pipe) is 
+   read into memory first.
+
+   A quick first pass over each chunk counts the MODEL records and
+   finds whether the chunk ends in the header, coordinates or trailer,
+   so that each chunk starts with the same model number and location 
+   that the serial reader would have had. Each chunk is then parsed 
+   into its own linked list. The lists are joined in file order and
+   the partial occupancy atoms are resolved as they are joined, so 
+   alternate positions which span a chunk boundary are handled just
+   as in blDoReadPDBFiltered(). Header and trailer lines (and CONECT 
+   records) are stored once all the atoms have been read.
+
+   If the library was not compiled with PTHREAD_SUPPORT, the chunks
+   are parsed in turn by the calling thread. PDBML files are read with
+   blDoReadPDBFiltered().
+
+-  17.10.26 Original    By: ACRM
+-  17.10.26 Maps regular files rather than reading them   By: ACRM
+*/
+WHOLEPDB *blDoReadPDBParallel(FILE *fpin, int OccRank, BOOL DoWhole,
+                              PDBREADFILTER *filter, int nThreads)
+{
+   FILE     *fp;
+   char     cmd[80],
+            *buffer,
+            *map     = NULL;
+   long     length;
+   size_t   mapsize  = 0;
+   WHOLEPDB *wpdb    = NULL;
+
+   /* Decompress gzipped or compressed files                            */
+   if((fp = OpenUncompressedPDB(fpin, cmd))==NULL)
+      return(NULL);
+
+   BLTIMERSTART(BLTIMER_READPDB);
+
+   /* PDBML files are not line-based so use the serial reader           */
+   if(blCheckFileFormatPDBML(fp))
+   {
+      wpdb = blDoReadPDBFiltered(fp, OccRank, DoWhole, filter);
+   }
+   else
+   {
+      /* Map the file or, failing that, read it into memory             */
+      if((buffer = MapPDBFile(fp, &length, &map, &mapsize))==NULL)
+         buffer = ReadFileIntoBuffer(fp, &length);
+
+      if(buffer != NULL)
+      {
+         wpdb = ReadPDBBuffer(buffer, length, OccRank, DoWhole, filter, 
+                              nThreads);
+         UnmapPDBFile(map, mapsize);
+         if(map == NULL)
+            free(buffer);
+      }
+   }
+   
+   BLTIMERSTOP(BLTIMER_READPDB);
+
+   if(cmd[0])
+   {
+      fclose(fp);
+      unlink(cmd);
+   }
+
+   return(wpdb);
+}
+
+/************************************************************************/
+/*>WHOLEPDB *blDoReadPDBFile(char *filename, int OccRank, BOOL DoWhole,
+                             PDBREADFILTER *filter, int nThreads)
+   --------------------------------------------------------------------
+*//**
+
+   \param[in]     *filename PDB file name
+   \param[in]     OccRank   Occupancy ranking
+   \param[in]     DoWhole   Read the whole PDB file rather than just 
+                            the ATOM/HETATM records.
+   \param[in]     *filter   Which records to read (NULL reads ATOM and
+                            HETATM records from all models)
+   \param[in]     nThreads  Number of threads to use
+   \return                  A pointer to a malloc'd WHOLEPDB structure
+                            (NULL if the file could not be opened or
+                            read)
+
+   Reads a PDB file given its name. Uncompressed PDB files are memory
+   mapped and the fields are taken directly from the mapped data 
+   without the lines being copied through stdio buffers. Gzipped files 
+   are decompressed first and PDBML files are read with 
+   blDoReadPDBFiltered().
+
+-  17.10.26 Original    By: ACRM
+*/
+WHOLEPDB *blDoReadPDBFile(char *filename, int OccRank, BOOL DoWhole,
+                          PDBREADFILTER *filter, int nThreads)
+{
+   FILE     *fp;
+   WHOLEPDB *wpdb;
+
+   if((fp = fopen(filename, "r"))==NULL)
+      return(NULL);
+
+   wpdb = blDoReadPDBParallel(fp, OccRank, DoWhole, filter, nThreads);
+   fclose(fp);
+   
+   return(wpdb);
+}
+
+/************************************************************************/
+/*>WHOLEPDB *blDoReadPDBBuffer(char *buffer, long length, int OccRank,
+                               BOOL DoWhole, PDBREADFILTER *filter, 
+                               int nThreads)
+   -------------------------------------------------------------------
+*//**
+
+   \param[in]     *buffer   PDB file contents
+   \param[in]     length    Number of characters in buffer
+   \param[in]     OccRank   Occupancy ranking
+   \param[in]     DoWhole   Read the whole PDB file rather than just 
+                            the ATOM/HETATM records.
+   \param[in]     *filter   Which records to read (NULL reads ATOM and
+                            HETATM records from all models)
+   \param[in]     nThreads  Number of threads to use
+   \return                  A pointer to a malloc'd WHOLEPDB structure
+                            (NULL on error)
+
+   Reads a PDB file which is already in memory. The buffer need not be 
+   null-terminated and is not modified. Gzipped data and PDBML are not
+   handled and give a NULL return.
+
+-  17.10.26 Original    By: ACRM
+*/
+WHOLEPDB *blDoReadPDBBuffer(char *buffer, long length, int OccRank,
+                            BOOL DoWhole, PDBREADFILTER *filter, 
+                            int nThreads)
+{
+   WHOLEPDB *wpdb;
+
+   if((buffer == NULL) || (length < 0))
+      return(NULL);
+   
+   if((length >= 1) && ((unsigned char)buffer[0] == 0x1F))
+      return(NULL);
+   if((length >= 6) && !strncmp(buffer, "<?xml ", 6))
+      return(NULL);
+
+   BLTIMERSTART(BLTIMER_READPDB);
+   wpdb = ReadPDBBuffer(buffer, length, OccRank, DoWhole, filter, 
+                        nThreads);
+   BLTIMERSTOP(BLTIMER_READPDB);
+
+   return(wpdb);
+}
+
+/************************************************************************/
+/*>static WHOLEPDB *ReadPDBBuffer(char *buffer, long length, int OccRank,
+                                  BOOL DoWhole, PDBREADFILTER *filter,
+                                  int nThreads)
+   ----------------------------------------------------------------------
+*//**
+
+   \param[in]     *buffer   PDB file contents
+   \param[in]     length    Number of characters in buffer
+   \param[in]     OccRank   Occupancy ranking
+   \param[in]     DoWhole   Read the whole PDB file rather than just 
+                            the ATOM/HETATM records.
+   \param[in]     *filter   Which records to read (NULL reads ATOM and
+                            HETATM records from all models)
+   \param[in]     nThreads  Number of threads to use
+   \return                  A pointer to a malloc'd WHOLEPDB structure
+
+   The work horse for blDoReadPDBParallel() and blDoReadPDBBuffer().
+   Splits the buffer into chunks, scans and parses them and stitches
+   the results together.
+
+-  17.10.26 Original, split from blDoReadPDBParallel()   By: ACRM
+*/
+static WHOLEPDB *ReadPDBBuffer(char *buffer, long length, int OccRank,
+                               BOOL DoWhole, PDBREADFILTER *filter,
+                               int nThreads)
+{
+   char      *start;
+   int       i,
+             location = LOCATION_HEADER,
+             model    = 0;
+   READCHUNK *chunks  = NULL;
+   WHOLEPDB  *wpdb    = NULL;
+
+   if(nThreads < 1)
+      nThreads = 1;
+   
+   gPDBPartialOcc    = FALSE;
+   gPDBMultiNMR      = 0;
+   gPDBXML           = FALSE;
+   gPDBModelNotFound = TRUE;  /* Assume we haven't found the model      */
+
+   if(((chunks=(READCHUNK *)malloc(nThreads * sizeof(READCHUNK)))==NULL) ||
+      ((wpdb=(WHOLEPDB *)malloc(sizeof(WHOLEPDB)))==NULL))
+   {
+      if(chunks != NULL) free(chunks);
+      return(NULL);
+   }
+   wpdb->pdb     = NULL;
+   wpdb->header  = NULL;
+   wpdb->trailer = NULL;
+   wpdb->bonds   = NULL;
+   wpdb->natoms  = 0;
+
+   /* Split the buffer into chunks which start at the beginning of a 
+      line
+   */
+   start = buffer;
+   for(i=0; i<nThreads; i++)
+   {
+      chunks[i].filter     = filter;
+      chunks[i].lines      = NULL;
+      chunks[i].pdb        = NULL;
+      chunks[i].last       = NULL;
+      chunks[i].OccRank    = OccRank;
+      chunks[i].ModelNum   = (filter==NULL) ? 0    : filter->modelNum;
+      chunks[i].AllAtoms   = (filter==NULL) ? TRUE : filter->hetatms;
+      chunks[i].DoWhole    = DoWhole;
+      chunks[i].natoms     = 0;
+      chunks[i].nPartial   = 0;
+      chunks[i].nlines     = 0;
+      chunks[i].maxlines   = 0;
+      chunks[i].modelFound = FALSE;
+      chunks[i].error      = FALSE;
+
+      chunks[i].start = start;
+      if(i == nThreads-1)
+      {
+         start = buffer + length;
+      }
+      else
+      {
+         if(start < buffer + (length * (i+1)) / nThreads)
+            start = buffer + (length * (i+1)) / nThreads;
+         while((start > buffer) && (start < buffer + length) &&
+               (*(start-1) != '\n'))
+            start++;
+      }
+      chunks[i].stop = start;
+   }
+
+   /* First pass: find the model and location at the start of each chunk
+   */
+   blRunThreadPool(ScanChunk, (void *)chunks, sizeof(READCHUNK), nThreads);
+   for(i=0; i<nThreads; i++)
+   {
+      chunks[i].startLocation = location;
+      chunks[i].startModel    = model;
+      if(chunks[i].endLocation >= 0)
+         location = chunks[i].endLocation;
+      model += chunks[i].nModels;
+   }
+   if(chunks[0].ModelNum != 0)
+      gPDBMultiNMR = model;
+
+   /* Second pass: parse the coordinates                                */
+   blRunThreadPool(ParseChunk, (void *)chunks, sizeof(READCHUNK),
+                   nThreads);
+   for(i=0; i<nThreads; i++)
+   {
+      if(chunks[i].error)
+         break;
+      if(chunks[i].modelFound)
+         gPDBModelNotFound = FALSE;
+   }
+
+   /* Join the chunks and store the header and trailer                  */
+   if((i < nThreads) ||
+      !StitchChunks(wpdb, chunks, nThreads, OccRank) ||
+      !StoreChunkLines(wpdb, chunks, nThreads))
+   {
+      FreeChunks(chunks, nThreads);
+      blFreeWholePDB(wpdb);
+      return(NULL);
+   }
+   
+   FreeChunks(chunks, nThreads);
+
+   if(DoWhole && !StoreConectRecords(wpdb))
+   {
+      blFreeWholePDB(wpdb);
+      return(NULL);
+   }
+   
+   BLCOUNT(BLCOUNT_ATOMS_ALLOCATED, wpdb->natoms);
+   return(wpdb);
+}
+
+/************************************************************************/
+/*>static char *MapPDBFile(FILE *fp, long *length, char **map, 
+                           size_t *mapsize)
+   -----------------------------------------------------------
+*//**
+
+   \param[in]     *fp       File pointer
+   \param[out]    *length   Number of characters from the current file
+                            position to the end of the file
+   \param[out]    **map     Start of the mapping (for UnmapPDBFile())
+   \param[out]    *mapsize  Size of the mapping (for UnmapPDBFile())
+   \return                  The current file position in the mapping
+                            (NULL if the file could not be mapped)
+
+   Memory maps a regular file so that it can be parsed without being
+   copied. Returns NULL for pipes, empty files and on systems without
+   mmap().
+
+-  17.10.26 Original    By: ACRM
+*/
+static char *MapPDBFile(FILE *fp, long *length, char **map, 
+                        size_t *mapsize)
+{
+#ifndef MS_WINDOWS
+   struct stat statbuf;
+   long        pos;
+   void        *addr;
+   int         fd;
+#endif
+
+   *map     = NULL;
+   *mapsize = 0;
+
+#ifndef MS_WINDOWS
+   fd = fileno(fp);
+   if((fstat(fd, &statbuf) != 0) || !S_ISREG(statbuf.st_mode))
+      return(NULL);
+
+   /* ftell() allows for characters pushed back by the file type checks*/
+   if(((pos = ftell(fp)) < 0) || (pos >= (long)statbuf.st_size))
+      return(NULL);
+
+   addr = mmap(NULL, (size_t)statbuf.st_size, PROT_READ, MAP_PRIVATE, 
+               fd, 0);
+   if(addr == MAP_FAILED)
+      return(NULL);
+
+   *map     = (char *)addr;
+   *mapsize = (size_t)statbuf.st_size;
+   *length  = (long)statbuf.st_size - pos;
+   return(*map + pos);
+#else
+   return(NULL);
+#endif
+}
+
+/************************************************************************/
+/*>static void UnmapPDBFile(char *map, size_t mapsize)
+   ---------------------------------------------------
+*//**
+
+   \param[in]     *map      Mapping from MapPDBFile() (or NULL)
+   \param[in]     mapsize   Size of the mapping
+
+   Removes a mapping made by MapPDBFile()
+
+-  17.10.26 Original    By: ACRM
+*/
+static void UnmapPDBFile(char *map, size_t mapsize)
+{
+#ifndef MS_WINDOWS
+   if(map != NULL)
+      munmap((void *)map, mapsize);
+#endif
+}
+
+/************************************************************************/
+/*>static char *ReadFileIntoBuffer(FILE *fp, long *length)
+   -------------------------------------------------------
+*//**
+
+   \param[in]     *fp       File pointer
+   \param[out]    *length   Number of characters read
+   \return                  Malloc'd, null-terminated buffer containing
+                            the rest of the file (NULL if no memory)
+
+   Reads the rest of a file into memory.
+
+-  17.10.26 Original    By: ACRM
+*/
+static char *ReadFileIntoBuffer(FILE *fp, long *length)
+{
+   char   *buffer = NULL,
+          *newbuffer;
+   size_t size    = 0,
+          used    = 0,
+          nread;
+
+   do
+   {
+      if(used == size)
+      {
+         size = (size == 0) ? (1024 * 1024) : (2 * size);
+         if((newbuffer = (char *)realloc(buffer, size+1))==NULL)
+         {
+            if(buffer != NULL)
+               free(buffer);
+            return(NULL);
+         }
+         buffer = newbuffer;
+      }
+      nread = fread(buffer+used, 1, size-used, fp);
+      used += nread;
+   }  while(nread > 0);
+
+   buffer[used] = '\0';
+   *length      = (long)used;
+   return(buffer);
+}
+
+/************************************************************************/
+/*>static char *GetBufferLine(char *line, char *stop, char *buffer,
+                              int maxlen)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in]     *line     Start of a line in a file buffer
+   \param[in]     *stop     End of the file buffer (or chunk)
+   \param[out]    *buffer   Copy of the line (may be NULL)
+   \param[in]     maxlen    Size of buffer
+   \return                  Start of the next line
+
+   Steps through a line in memory in the same way as fgets(): at most 
+   maxlen-1 characters are taken, including the newline. If buffer is
+   not NULL the line is copied into it and terminated.
+
+-  17.10.26 Original    By: ACRM
+*/
+static char *GetBufferLine(char *line, char *stop, char *buffer, 
+                           int maxlen)
+{
+   char *end = line;
+   
+   while((end < stop) && ((end - line) < (maxlen-1)))
+   {
+      if(*(end++) == '\n')
+         break;
+   }
+   
+   if(buffer != NULL)
+   {
+      strncpy(buffer, line, end-line);
+      buffer[end-line] = '\0';
+   }
+   
+   return(end);
+}
+
+/************************************************************************/
+/*>static void *ScanChunk(void *arg)
+   ---------------------------------
+*//**
+
+   \param[in,out] *arg      The READCHUNK to scan
+   \return                  NULL
+
+   First pass of blDoReadPDBParallel(). Counts the MODEL records in the
+   chunk and finds the location (header, coordinates or trailer) at 
+   its end using the same rules as blDoReadPDBFiltered().
+
+-  17.10.26 Original    By: ACRM
+-  17.10.26 Works on the buffer without copying lines   By: ACRM
+*/
+static void *ScanChunk(void *arg)
+{
+   READCHUNK *chunk = (READCHUNK *)arg;
+   char      *line,
+             *next;
+   int       len;
+
+   chunk->nModels     = 0;
+   chunk->endLocation = (-1);
+
+   for(line=chunk->start; line<chunk->stop; line=next)
+   {
+      next = GetBufferLine(line, chunk->stop, NULL, 159);
+      len  = (int)(next - line);
+
+      if(LINE_IS_RECORD(line, len, "MODEL "))
+         chunk->nModels++;
+
+      if(LINE_IS_RECORD(line, len, "ATOM  ") ||
+         LINE_IS_RECORD(line, len, "HETATM") ||
+         LINE_IS_RECORD(line, len, "MODEL "))
+      {
+         chunk->endLocation = LOCATION_COORDINATES;
+      }
+      else if(LINE_IS_RECORD(line, len, "CONECT") ||
+              LINE_IS_RECORD(line, len, "MASTER") ||
+              LINE_IS_RECORD(line, len, "END   "))
+      {
+         chunk->endLocation = LOCATION_TRAILER;
+      }
+   }
+
+   return(NULL);
+}
+
+/************************************************************************/
+/*>static void *ParseChunk(void *arg)
+   ----------------------------------
+*//**
+
+   \param[in,out] *arg      The READCHUNK to parse
+   \return                  NULL
+
+   Second pass of blDoReadPDBParallel(). Parses the coordinate records
+   of the chunk into its own linked list exactly as 
+   blDoReadPDBFiltered() would, except that partial occupancy atoms
+   are kept (with their alternate position indicator in the atom name)
+   for StitchChunks() to resolve. Header and trailer lines are noted
+   for StoreChunkLines(). Sets chunk->error if memory runs out.
+
+   Lines are not copied: the fields are taken straight from the buffer
+   by ReadCoordColumns(). As with fsscanf(), a number which can't be
+   read keeps its value from the previous record; at the start of a 
+   chunk that value is zero.
+
+-  17.10.26 Original    By: ACRM
+-  17.10.26 Uses ReadCoordColumns() rather than copying each line and
+            calling fsscanf()   By: ACRM
+*/
+static void *ParseChunk(void *arg)
+{
+   READCHUNK *chunk = (READCHUNK *)arg;
+   char      record_type[8],
+             atnambuff[8],
+             *atnam,
+             atnam_raw[8],
+             resnam[8],
+             chain[4],
+             insert[4],
+             segid[8],
+             altpos,
+             element_buff[4] = "",
+             charge_buff[4]  = "",
+             element[4]      = "",
+             *line,
+             *next;
+   int       atnum      = 0,
+             resnum     = 0,
+             len,
+             charge     = 0,
+             ModelCount = chunk->startModel,
+             inLocation = chunk->startLocation;
+   double    x    = 0.0,
+             y    = 0.0,
+             z    = 0.0,
+             occ  = 0.0,
+             bval = 0.0;
+   PDB       *p = NULL;
+
+   for(line=chunk->start; line<chunk->stop; line=next)
+   {
+      next = GetBufferLine(line, chunk->stop, NULL, 159);
+      len  = (int)(next - line);
+      BLCOUNT(BLCOUNT_LINES_PARSED, 1);
+
+      /*** Deal with counting model numbers                           ***/
+      if(chunk->ModelNum != 0)
+      {
+         if(LINE_IS_RECORD(line, len, "MODEL "))
+            ModelCount++;
+
+         /* See if we are in the right model                            */
+         if(inLocation == LOCATION_COORDINATES)
+         {
+            if((ModelCount != chunk->ModelNum) && (ModelCount != 0))
+               continue;
+            else
+               chunk->modelFound = TRUE;
+         }
+      }
+      else
+      {
+         chunk->modelFound = TRUE;
+      }
+
+      if(LINE_IS_RECORD(line, len, "ATOM  ") ||
+         LINE_IS_RECORD(line, len, "HETATM") ||
+         LINE_IS_RECORD(line, len, "MODEL "))
+      {
+         inLocation = LOCATION_COORDINATES;
+      }
+      else if(LINE_IS_RECORD(line, len, "CONECT") ||
+              LINE_IS_RECORD(line, len, "MASTER") ||
+              LINE_IS_RECORD(line, len, "END   "))
+      {
+         inLocation = LOCATION_TRAILER;
+      }
+
+      /* Note header and trailer lines to be stored later               */
+      if(inLocation != LOCATION_COORDINATES)
+      {
+         if(chunk->DoWhole && !StoreLineRef(chunk, line, inLocation))
+         {
+            chunk->error = TRUE;
+            return(NULL);
+         }
+         continue;
+      }
+
+      /* Skip unwanted records before parsing them. This only passes
+         ATOM and HETATM records, so the line is never blank
+      */
+      if(!KeepRecord(line, len, chunk->filter))
+         continue;
+
+      /* Read a record                                                  */
+      ReadCoordColumns(line, len, record_type, &atnum, atnambuff, resnam,
+                       chain, &resnum, insert, &x, &y, &z, &occ, &bval,
+                       segid, element_buff, charge_buff);
+
+      if((!strncmp(record_type,"ATOM  ",6)) || 
+         (!strncmp(record_type,"HETATM",6) && chunk->AllAtoms))
+      {
+         strncpy(atnam_raw, atnambuff, 4);
+         atnam_raw[4] = '\0';
+         altpos = atnambuff[4];
+
+         /* Fix the atom name accounting for start in column 13 or 14   */
+         atnam = blFixAtomName(atnambuff, occ);
+            
+         /* Set element and charge                                      */
+         ProcessElementField(element, element_buff);
+         ProcessChargeField(&charge, charge_buff);
+         if(strlen(element) == 0)
+            blSetElementSymbolFromAtomName(element, atnam_raw);
+
+         /* Allocate space in the chunk's linked list                   */
+         if(chunk->pdb == NULL)
+         {
+            INIT(chunk->pdb, PDB);
+            p = chunk->pdb;
+         }
+         else
+         {
+            ALLOCNEXT(p, PDB);
+         }
+         if(p==NULL)
+         {
+            chunk->error = TRUE;
+            return(NULL);
+         }
+         chunk->last = p;
+         (chunk->natoms)++;
+            
+         /* Store the information read                                  */
+         CLEAR_PDB(p);
+         p->atnum  = atnum;
+         p->resnum = resnum;
+         p->x      = (REAL)x;
+         p->y      = (REAL)y;
+         p->z      = (REAL)z;
+         p->occ    = (REAL)occ;
+         p->bval   = (REAL)bval;
+         p->altpos = altpos;
+         p->formal_charge  = charge;
+         p->partial_charge = (REAL)charge;
+         strcpy(p->record_type, record_type);
+         strcpy(p->atnam,       atnam);
+         strcpy(p->atnam_raw,   atnam_raw);
+         strcpy(p->resnam,      resnam);
+         strcpy(p->chain,       chain);
+         strcpy(p->insert,      insert);
+         strcpy(p->element,     element);
+         strcpy(p->segid,       segid);
+
+         /* Fully occupied atoms have the name trimmed as in 
+            blDoReadPDBFiltered(); partial occupancy atoms keep the
+            full name until StoreOccRankAtom() deals with them
+         */
+         if(IsFullOccupancy(p, chunk->OccRank))
+            (p->atnam)[4] = '\0';
+         else
+            (chunk->nPartial)++;
+      }
+      charge_buff[0] = '\0';
+      charge = 0;
+   }
+
+   return(NULL);
+}
+
+/************************************************************************/
+/*>static void ReadCoordColumns(char *line, int len, char *record_type,
+                                int *atnum, char *atnam, char *resnam,
+                                char *chain, int *resnum, char *insert,
+                                double *x, double *y, double *z, 
+                                double *occ, double *bval, char *segid,
+                                char *element, char *charge)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *line         Start of an ATOM or HETATM record
+   \param[in]     len           Length of the line (it need not be
+                                null-terminated)
+   \param[out]    *record_type  Columns 1-6
+   \param[in,out] *atnum        Columns 7-11
+   \param[out]    *atnam        Columns 13-17
+   \param[out]    *resnam       Columns 18-21
+   \param[out]    *chain        Column 22
+   \param[in,out] *resnum       Columns 23-26
+   \param[out]    *insert       Column 27
+   \param[in,out] *x            Columns 31-38
+   \param[in,out] *y            Columns 39-46
+   \param[in,out] *z            Columns 47-54
+   \param[in,out] *occ          Columns 55-60
+   \param[in,out] *bval         Columns 61-66
+   \param[out]    *segid        Columns 73-76
+   \param[out]    *element      Columns 77-78
+   \param[out]    *charge       Columns 79-80
+
+   Extracts the fields of a coordinate record directly from the line,
+   giving the same results as the fsscanf() format used by
+   blDoReadPDBFiltered() but without copying the line or allocating 
+   memory. Strings are padded with spaces to the field width. Numbers
+   in blank or missing fields are set to zero; numbers which can't be
+   read are left unchanged, as they are by fsscanf().
+
+-  17.10.26 Original    By: ACRM
+-  17.10.26 Reads hybrid-36 atom and residue numbers   By: ACRM
+*/
+static void ReadCoordColumns(char *line, int len, char *record_type,
+                             int *atnum, char *atnam, char *resnam,
+                             char *chain, int *resnum, char *insert,
+                             double *x, double *y, double *z, 
+                             double *occ, double *bval, char *segid,
+                             char *element, char *charge)
+{
+   int i;
+   
+   /* Fields stop at the end of the line (as fsscanf() does)            */
+   for(i=0; i<len; i++)
+   {
+      if((line[i] == '\n') || (line[i] == '\0'))
+         break;
+   }
+   len = i;
+
+   ColumnString(line, len,  0, 6, record_type);
+   ColumnHybrid36(line, len, 6, 5, atnum);
+   ColumnString(line, len, 12, 5, atnam);
+   ColumnString(line, len, 17, 4, resnam);
+   ColumnString(line, len, 21, 1, chain);
+   ColumnHybrid36(line, len, 22, 4, resnum);
+   ColumnString(line, len, 26, 1, insert);
+   ColumnDouble(line, len, 30, 8, x);
+   ColumnDouble(line, len, 38, 8, y);
+   ColumnDouble(line, len, 46, 8, z);
+   ColumnDouble(line, len, 54, 6, occ);
+   ColumnDouble(line, len, 60, 6, bval);
+   ColumnString(line, len, 72, 4, segid);
+   ColumnString(line, len, 76, 2, element);
+   ColumnString(line, len, 78, 2, charge);
+}
+
+/************************************************************************/
+/*>static void ColumnString(char *line, int len, int column, int width,
+                            char *string)
+   --------------------------------------------------------------------
+*//**
+
+   \param[in]     *line     Line from a PDB file
+   \param[in]     len       Length of the line
+   \param[in]     column    Start column (from 0)
+   \param[in]     width     Field width
+   \param[out]    *string   Field padded with spaces to width and
+                            terminated
+
+   Extracts a fixed-width string field as fsscanf() does with %Ns
+
+-  17.10.26 Original    By: ACRM
+*/
+static void ColumnString(char *line, int len, int column, int width,
+                         char *string)
+{
+   int i;
+   
+   for(i=0; i<width; i++)
+      string[i] = ((column+i) < len) ? line[column+i] : ' ';
+   string[width] = '\0';
+}
+
+/************************************************************************/
+/*>static void ColumnHybrid36(char *line, int len, int column, int width,
+                              int *value)
+   ----------------------------------------------------------------------
+*//**
+
+   \param[in]     *line     Line from a PDB file
+   \param[in]     len       Length of the line
+   \param[in]     column    Start column (from 0)
+   \param[in]     width     Field width
+   \param[in,out] *value    Value read
+
+   Reads a fixed-width integer field as fsscanf() does with %Nd, but 
+   also accepting hybrid-36 numbers. Used for atom and residue numbers.
+
+-  17.10.26 Original    By: ACRM
+*/
+static void ColumnHybrid36(char *line, int len, int column, int width,
+                           int *value)
+{
+   if(column >= len)
+   {
+      *value = 0;
+      return;
+   }
+   if(column + width > len)
+      width = len - column;
+   
+   blDecodeHybrid36(line+column, width, value);
+}
+
+/************************************************************************/
+/*>static void ColumnDouble(char *line, int len, int column, int width,
+                            double *value)
+   --------------------------------------------------------------------
+*//**
+
+   \param[in]     *line     Line from a PDB file
+   \param[in]     len       Length of the line
+   \param[in]     column    Start column (from 0)
+   \param[in]     width     Field width (at most 15)
+   \param[in,out] *value    Value read
+
+   Reads a fixed-width floating point field as fsscanf() does with %Nlf
+
+-  17.10.26 Original    By: ACRM
+*/
+static void ColumnDouble(char *line, int len, int column, int width,
+                         double *value)
+{
+   char   field[16],
+          *end;
+   double dvalue;
+   int    i, n = 0;
+
+   for(i=column; (i<len) && (i<column+width); i++)
+      field[n++] = line[i];
+   field[n] = '\0';
+
+   dvalue = strtod(field, &end);
+   if(end != field)
+   {
+      *value = dvalue;
+   }
+   else
+   {
+      /* A blank field is zero; anything else is left unchanged         */
+      for(i=0; (i<n) && isspace(field[i]); i++);
+      if(i==n)
+         *value = 0.0;
+   }
+}
+
+/************************************************************************/
+/*>static BOOL StoreLineRef(READCHUNK *chunk, char *line, int location)
+   --------------------------------------------------------------------
+*//**
+
+   \param[in,out] *chunk    The chunk being parsed
+   \param[in]     *line     Start of a header or trailer line
+   \param[in]     location  LOCATION_HEADER or LOCATION_TRAILER
+   \return                  Success?
+
+   Adds a header or trailer line to the chunk's list of lines
+
+-  17.10.26 Original    By: ACRM
+*/
+static BOOL StoreLineRef(READCHUNK *chunk, char *line, int location)
+{
+   READLINEREF *lines;
+   
+   if(chunk->nlines == chunk->maxlines)
+   {
+      chunk->maxlines = (chunk->maxlines == 0) ? 64 : 2*chunk->maxlines;
+      if((lines = (READLINEREF *)realloc(chunk->lines, 
+                                         chunk->maxlines * 
+                                         sizeof(READLINEREF)))==NULL)
+         return(FALSE);
+      chunk->lines = lines;
+   }
+
+   chunk->lines[chunk->nlines].line     = line;
+   chunk->lines[chunk->nlines].location = location;
+   (chunk->nlines)++;
+
+   return(TRUE);
+}
+
+/************************************************************************/
+/*>static BOOL IsFullOccupancy(PDB *p, int OccRank)
+   ------------------------------------------------
+*//**
+
+   \param[in]     *p        Atom just read
+   \param[in]     OccRank   Occupancy ranking
+   \return                  Should the atom be treated as fully 
+                            occupied?
+
+   The test used by blDoReadPDBFiltered() to decide whether an atom is
+   one of a set of alternate positions
+
+-  17.10.26 Original    By: ACRM
+*/
+static BOOL IsFullOccupancy(PDB *p, int OccRank)
+{
+   return((p->altpos == ' ') ||
+          ((double)p->occ > (double)0.999) ||
+          (OccRank == 0));
+}
+
+/************************************************************************/
+/*>static BOOL StitchChunks(WHOLEPDB *wpdb, READCHUNK *chunks, 
+                            int nchunks, int OccRank)
+   -------------------------------------------------------------
+*//**
+
+   \param[in,out] *wpdb     WHOLEPDB to receive the atoms
+   \param[in,out] *chunks   Array of parsed chunks
+   \param[in]     nchunks   Number of chunks
+   \param[in]     OccRank   Occupancy ranking
+   \return                  Success?
+
+   Joins the linked lists from the chunks in file order. Chunks without
+   partial occupancy atoms are simply linked on. Otherwise the atoms 
+   are taken one at a time and sets of alternate positions are 
+   collected and passed to StoreOccRankAtom() as in 
+   blDoReadPDBFiltered(), so a set may span more than one chunk.
+
+-  17.10.26 Original    By: ACRM
+*/
+static BOOL StitchChunks(WHOLEPDB *wpdb, READCHUNK *chunks, int nchunks,
+                         int OccRank)
+{
+   PDB  *p = NULL,
+        *q,
+        multi[MAXPARTIAL];
+   char CurAtom[8],
+        CurIns   = ' ';
+   int  i,
+        CurRes   = 0,
+        NPartial = 0;
+
+   CurAtom[0] = '\0';
+
+   for(i=0; i<nchunks; i++)
+   {
+      if(chunks[i].pdb == NULL)
+         continue;
+      
+      if(chunks[i].nPartial == 0)
+      {
+         if(NPartial != 0)
+         {
+            if(!StoreOccRankAtom(OccRank,multi,NPartial,
+                                 &wpdb->pdb,&p,&(wpdb->natoms)))
+               return(FALSE);
+            NPartial = 0;
+         }
+
+         if(wpdb->pdb == NULL)
+            wpdb->pdb = chunks[i].pdb;
+         else
+            p->next   = chunks[i].pdb;
+         p             = chunks[i].last;
+         wpdb->natoms += chunks[i].natoms;
+         chunks[i].pdb = NULL;
+         continue;
+      }
+      
+      gPDBPartialOcc = TRUE;
+      
+      while((q = chunks[i].pdb) != NULL)
+      {
+         chunks[i].pdb = q->next;
+         q->next       = NULL;
+         
+         if(IsFullOccupancy(q, OccRank))
+         {
+            if(NPartial != 0)
+            {
+               if(!StoreOccRankAtom(OccRank,multi,NPartial,
+                                    &wpdb->pdb,&p,&(wpdb->natoms)))
+               {
+                  free(q);
+                  return(FALSE);
+               }
+               NPartial = 0;
+            }
+
+            if(wpdb->pdb == NULL)
+               wpdb->pdb = q;
+            else
+               p->next   = q;
+            p = q;
+            (wpdb->natoms)++;
+         }
+         else
+         {
+            /* First in a group, store atom name                        */
+            if(NPartial == 0)
+            {
+               CurIns = q->insert[0];
+               CurRes = q->resnum;
+               strcpy(CurAtom,q->atnam);
+            }
+            
+            if(strncmp(CurAtom,q->atnam,strlen(CurAtom)-1) || 
+               q->resnum != CurRes || 
+               CurIns != q->insert[0])
+            {
+               /* Atom name has changed 
+                  Select and store the OccRank highest occupancy atom
+               */
+               if(!StoreOccRankAtom(OccRank,multi,NPartial,
+                                    &wpdb->pdb,&p,&(wpdb->natoms)))
+               {
+                  free(q);
+                  return(FALSE);
+               }
+               NPartial = 0;
+               strcpy(CurAtom,q->atnam);
+               CurRes = q->resnum;
+               CurIns = q->insert[0];
+            }
+            
+            if(NPartial < MAXPARTIAL)
+            {
+               multi[NPartial] = *q;
+               NPartial++;
+            }
+            free(q);
+         }
       }
    }
 
    if(NPartial != 0)
    {
-      if(!StoreOccRankAtom(OccRank,multi,NPartial,&wpdb->pdb,&p,
-                             &wpdb->natoms))
+      if(!StoreOccRankAtom(OccRank,multi,NPartial,
+                           &wpdb->pdb,&p,&(wpdb->natoms)))
+         return(FALSE);
+   }
+
+   return(TRUE);
+}
+
+/************************************************************************/
+/*>static BOOL StoreChunkLines(WHOLEPDB *wpdb, READCHUNK *chunks, 
+                               int nchunks)
+   --------------------------------------------------------------
+*//**
+
+   \param[in,out] *wpdb     WHOLEPDB to receive the header and trailer
+   \param[in]     *chunks   Array of parsed chunks
+   \param[in]     nchunks   Number of chunks
+   \return                  Success?
+
+   Stores the header and trailer lines noted by ParseChunk(), in file
+   order, and deals with the CONECT records.
+
+-  17.10.26 Original    By: ACRM
+*/
+static BOOL StoreChunkLines(WHOLEPDB *wpdb, READCHUNK *chunks, 
+                            int nchunks)
+{
+   int  i, j;
+   char buffer[MAXBUFF];
+   
+   for(i=0; i<nchunks; i++)
+   {
+      for(j=0; j<chunks[i].nlines; j++)
       {
-         if(wpdb->pdb != NULL) FREELIST(wpdb->pdb, PDB);
-         wpdb->natoms = (-1);
-         if(cmd[0]) unlink(cmd);
+         GetBufferLine(chunks[i].lines[j].line, chunks[i].stop, 
+                       buffer, 159);
+         if(chunks[i].lines[j].location == LOCATION_HEADER)
+         {
+            if((wpdb->header = blStoreString(wpdb->header, buffer))
+               ==NULL)
+               return(FALSE);
+         }
+         else
+         {
+            if((wpdb->trailer = blStoreString(wpdb->trailer, buffer))
+               ==NULL)
+               return(FALSE);
+         }
+      }
+   }
+
+   return(TRUE);
+}
+
+/************************************************************************/
+/*>static void FreeChunks(READCHUNK *chunks, int nchunks)
+   ------------------------------------------------------
+*//**
+
+   \param[in,out] *chunks   Array of chunks
+   \param[in]     nchunks   Number of chunks
+
+   Frees any atoms and line lists left in the chunks and the array 
+   itself
+
+-  17.10.26 Original    By: ACRM
+*/
+static void FreeChunks(READCHUNK *chunks, int nchunks)
+{
+   int i;
+   
+   for(i=0; i<nchunks; i++)
+   {
+      if(chunks[i].pdb != NULL)
+         FREELIST(chunks[i].pdb, PDB);
+      if(chunks[i].lines != NULL)
+         free(chunks[i].lines);
+   }
+   free(chunks);
+}
+
+/************************************************************************/
+/*>static FILE *OpenUncompressedPDB(FILE *fpin, char *tmpfile)
+   -----------------------------------------------------------
+*//**
+
+   \param[in]     *fpin     File pointer to a PDB file
+   \param[out]    *tmpfile  Name of the temporary file created (blank
+                            if none was needed). Must be >= 80 chars
+   \return                  File pointer from which to read the 
+                            uncompressed data (NULL on error)
+
+   If the file is gzipped or Unix compressed (and GUNZIP_SUPPORT is 
+   defined), it is uncompressed into a temporary file which is opened
+   and returned. The caller must unlink() tmpfile when done. Otherwise
+   fpin is returned.
+
+   The temporary file is created with mkstemp() so that each call, in
+   whichever thread, has its own.
+
+-  25.02.98 Original as part of doReadPDB()   By: ACRM
+-  17.10.26 Split out of blDoReadPDBFiltered() so it can also be used
+            by blReadPDBHeader()
+-  17.10.26 Temporary file created with mkstemp() rather than named
+            from the process ID, which all threads share
+*/
+static FILE *OpenUncompressedPDB(FILE *fpin, char *tmpfile)
+{
+   FILE     *fp = fpin;
+#if defined(GUNZIP_SUPPORT) && !defined(MS_WINDOWS)
+   int      signature[3],
+            ch,
+            fd;
+   BOOL     gzipped_file = FALSE;
+   char     cmd[80];
+#  ifndef SINGLE_CHAR_FILECHECK
+   int      i;
+#  endif
+#endif
+
+   tmpfile[0] = '\0';
+
+#if defined(GUNZIP_SUPPORT) && !defined(MS_WINDOWS)
+   /* See whether this is a gzipped file                                */
+#  ifndef SINGLE_CHAR_FILECHECK
+   /* Default three character filetype check                            */
+   for(i=0; i<3; i++)
+      signature[i] = fgetc(fpin);
+   for(i=2; i>=0; i--)
+      ungetc(signature[i], fpin);
+   if(((signature[0] == (int)0x1F) &&    /* gzip                        */
+       (signature[1] == (int)0x8B) &&
+       (signature[2] == (int)0x08)) ||
+      ((signature[0] == (int)0x1F) &&    /* 05.06.07 compress           */
+       (signature[1] == (int)0x9D) &&
+       (signature[2] == (int)0x90)))
+   {
+      gzipped_file = TRUE;
+   }
+#  else
+   /* Single character filetype check                                   */
+   signature[0] = fgetc(fpin);
+   ungetc(signature[0], fpin);
+   if(signature[0] == (int)0x1F) gzipped_file = TRUE;
+#  endif
+
+   if(gzipped_file)
+   {
+      /* Create a temporary file with a name of its own, so that 
+         threads reading at the same time do not share it
+      */
+      strcpy(tmpfile, "/tmp/readpdb_XXXXXX");
+      if((fd = mkstemp(tmpfile)) < 0)
+      {
+         tmpfile[0] = '\0';
+         return(NULL);
+      }
+      close(fd);
+
+      /* It is gzipped so we'll open gunzip as a pipe and send the data
+         through that into the temporary file
+      */
+      sprintf(cmd,"gunzip >%s", tmpfile);
+      if((fp = (FILE *)popen(cmd,"w"))==NULL)
+      {
+         unlink(tmpfile);
+         tmpfile[0] = '\0';
+         return(NULL);
+      }
+      while((ch=fgetc(fpin))!=EOF)
+         fputc(ch, fp);
+      pclose(fp);
+
+      /* We now reopen the temporary file as our PDB input file         */
+      if((fp = fopen(tmpfile,"r"))==NULL)
+      {
+         unlink(tmpfile);
+         tmpfile[0] = '\0';
          return(NULL);
       }
    }
+#endif   
 
-   if(cmd[0]) unlink(cmd);
+   return(fp);
+}
 
-   /* Return pointer to start of linked list                            */
-   return(wpdb);
+/************************************************************************/
+/*>static BOOL KeepRecord(char *buffer, int len, PDBREADFILTER *filter)
+   --------------------------------------------------------------------
+*//**
+
+   \param[in]     *buffer  Record read from a PDB file
+   \param[in]     len      Length of the record (buffer need not be
+                           null-terminated)
+   \param[in]     *filter  Read filter (or NULL)
+   \return                 Should this record be parsed?
+
+   Checks a coordinate record against a read filter using the fixed
+   PDB columns only. Records other than ATOM and HETATM are rejected
+   since blDoReadPDBFiltered() would ignore them after parsing anyway.
+
+-  17.10.26 Original    By: ACRM
+-  17.10.26 Added len so that it can work on a memory mapped file
+            By: ACRM
+*/
+static BOOL KeepRecord(char *buffer, int len, PDBREADFILTER *filter)
+{
+   char chain[2],
+        atnambuff[8],
+        *atnam;
+   int  i;
+
+   if(LINE_IS_RECORD(buffer, len, "ATOM  "))
+   {
+      if((filter!=NULL) && !filter->atoms)
+         return(FALSE);
+   }
+   else if(LINE_IS_RECORD(buffer, len, "HETATM"))
+   {
+      if((filter!=NULL) && !filter->hetatms)
+         return(FALSE);
+   }
+   else
+   {
+      return(FALSE);
+   }
+
+   if(filter==NULL)
+      return(TRUE);
+
+   /* Chain label is column 22                                          */
+   if(filter->nchains)
+   {
+      chain[0] = (len > 21) ? buffer[21] : ' ';
+      chain[1] = '\0';
+
+      for(i=0; i<filter->nchains; i++)
+      {
+         if(CHAINMATCH(chain, filter->chains[i]))
+            break;
+      }
+      if(i==filter->nchains)
+         return(FALSE);
+   }
+
+   /* Atom name is columns 13-16 plus the alternate position in 17. 
+      blFixAtomName() then gives the name as it will be stored
+   */
+   if(filter->natnams)
+   {
+      for(i=0; i<5; i++)
+         atnambuff[i] = ((12+i) < len) ? buffer[12+i] : ' ';
+      atnambuff[5] = '\0';
+      if((atnambuff[4] == '\n') || (atnambuff[4] == '\r'))
+         atnambuff[4] = ' ';
+
+      atnam = blFixAtomName(atnambuff, (REAL)1.0);
+      if(!AtomNameInList(atnam, filter->atnams, filter->natnams))
+         return(FALSE);
+   }
+
+   return(TRUE);
+}
+
+/************************************************************************/
+/*>static BOOL AtomNameInList(char *atnam, char **names, int nnames)
+   -----------------------------------------------------------------
+*//**
+
+   \param[in]     *atnam   Atom name
+   \param[in]     **names  Names to look for
+   \param[in]     nnames   Number of names
+   \return                 Is the atom name in the list?
+
+   Compares the first 4 characters of the names, treating the end of a
+   string as space padding, so "CA" and "CA  " are equivalent.
+
+-  17.10.26 Original    By: ACRM
+*/
+static BOOL AtomNameInList(char *atnam, char **names, int nnames)
+{
+   int  i, j;
+   char a, b;
+
+   for(i=0; i<nnames; i++)
+   {
+      for(j=0; j<4; j++)
+      {
+         a = (j < (int)strlen(atnam))    ? atnam[j]    : ' ';
+         b = (j < (int)strlen(names[i])) ? names[i][j] : ' ';
+         if(a != b)
+            break;
+      }
+      if(j==4)
+         return(TRUE);
+   }
+   return(FALSE);
+}
+
+/************************************************************************/
+/*>static BOOL KeepAtom(PDB *p, PDBREADFILTER *filter)
+   ---------------------------------------------------
+*//**
+
+   \param[in]     *p       PDB record
+   \param[in]     *filter  Read filter
+   \return                 Does the atom pass the filter?
+
+   Equivalent of KeepRecord() for an atom that has already been read.
+
+-  17.10.26 Original    By: ACRM
+*/
+static BOOL KeepAtom(PDB *p, PDBREADFILTER *filter)
+{
+   int i;
+
+   if(!strncmp(p->record_type, "ATOM  ", 6) && !filter->atoms)
+      return(FALSE);
+   if(!strncmp(p->record_type, "HETATM", 6) && !filter->hetatms)
+      return(FALSE);
+
+   if(filter->nchains)
+   {
+      for(i=0; i<filter->nchains; i++)
+      {
+         if(CHAINMATCH(p->chain, filter->chains[i]))
+            break;
+      }
+      if(i==filter->nchains)
+         return(FALSE);
+   }
+
+   if(filter->natnams &&
+      !AtomNameInList(p->atnam, filter->atnams, filter->natnams))
+      return(FALSE);
+
+   return(TRUE);
+}
+
+/************************************************************************/
+/*>static void ApplyReadFilter(WHOLEPDB *wpdb, PDBREADFILTER *filter)
+   ------------------------------------------------------------------
+*//**
+
+   \param[in,out] *wpdb    WHOLEPDB structure
+   \param[in]     *filter  Read filter (or NULL)
+
+   Removes atoms that fail the filter from an already-read structure.
+   Used for PDBML input where the records can't be skipped on reading.
+
+-  17.10.26 Original    By: ACRM
+-  17.10.26 Uses blDeleteAtomsPDB()   By: ACRM
+*/
+static void ApplyReadFilter(WHOLEPDB *wpdb, PDBREADFILTER *filter)
+{
+   int ndeleted = 0;
+
+   if(filter==NULL)
+      return;
+
+   wpdb->pdb     = blDeleteAtomsPDB(wpdb->pdb, RejectAtom, (APTR)filter,
+                                    &ndeleted);
+   wpdb->natoms -= ndeleted;
+}
+
+
+/************************************************************************/
+/*>static BOOL RejectAtom(PDB *p, APTR filter)
+   -------------------------------------------
+*//**
+
+   \param[in]     *p       Atom to test
+   \param[in]     filter   The PDBREADFILTER
+   \return                 Should the atom be removed?
+
+   blDeleteAtomsPDB() test for ApplyReadFilter()
+
+-  17.10.26 Original    By: ACRM
+*/
+static BOOL RejectAtom(PDB *p, APTR filter)
+{
+   return(!KeepAtom(p, (PDBREADFILTER *)filter));
 }
 
 /************************************************************************/
@@ -1699,6 +3567,7 @@ WHOLEPDB *blDoReadPDBML(FILE *fpin,
    wpdb->pdb         = NULL;
    wpdb->header      = NULL;
    wpdb->trailer     = NULL;
+   wpdb->bonds       = NULL;
    wpdb->natoms      = 0;
 
    /* Reset flags                                                       */
@@ -2316,15 +4185,18 @@ static void ProcessChargeField(int *charge, char *charge_field)
 
    \param[in]     *wpdb    WHOLEPDB structure to be freed
 
-   Frees the header, trailer and atom content from a WHOLEPDB structure
+   Frees the header, trailer, bond graph and atom content from a 
+   WHOLEPDB structure
 
 -  30.05.02  Original   By: ACRM
 -  07.07.14  Renamed to blFreeWholePDB() By: CTP
+-  17.10.26  Frees the bond graph   By: ACRM
 */
 void blFreeWholePDB(WHOLEPDB *wpdb)
 {
    blFreeStringList(wpdb->header);
    blFreeStringList(wpdb->trailer);
+   blFreeBondGraph(wpdb->bonds);
    FREELIST(wpdb->pdb, PDB);
    free(wpdb);
 }
@@ -2355,12 +4227,23 @@ void blFreeWholePDB(WHOLEPDB *wpdb)
 
 -  07.03.07 Made into a wrapper to doReadWholePDB()
 -  07.07.14 Use blDoReadWholePDB() Renamed to blReadWholePDB() By: CTP
+-  17.10.26 Rebuilds the bond graph after removing alternates. Checks
+            for a NULL return from blDoReadPDB()   By: ACRM
 */
 WHOLEPDB *blReadWholePDB(FILE *fpin)
 {
    WHOLEPDB *wpdb;
-   wpdb = blDoReadPDB(fpin, TRUE, 1, 1, TRUE);
-   wpdb->pdb = blRemoveAlternates(wpdb->pdb);
+   if((wpdb = blDoReadPDB(fpin, TRUE, 1, 1, TRUE))!=NULL)
+   {
+      wpdb->pdb = blRemoveAlternates(wpdb->pdb);
+
+      /* The bond graph must not refer to removed atoms                 */
+      if((wpdb->bonds != NULL) && !StoreConectRecords(wpdb))
+      {
+         blFreeWholePDB(wpdb);
+         return(NULL);
+      }
+   }
    return(wpdb);
 }
 
@@ -2390,25 +4273,39 @@ WHOLEPDB *blReadWholePDB(FILE *fpin)
 -  07.03.07 Made into a wrapper to doReadWholePDB()
 -  07.07.14 Use blDoReadWholePDB() Renamed to blReadWholePDBAtoms() 
             By: CTP
+-  17.10.26 Rebuilds the bond graph after removing alternates. Checks
+            for a NULL return from blDoReadPDB()   By: ACRM
 */
 WHOLEPDB *blReadWholePDBAtoms(FILE *fpin)
 {
    WHOLEPDB *wpdb;
-   wpdb = blDoReadPDB(fpin, FALSE, 1, 1, TRUE);
-   wpdb->pdb = blRemoveAlternates(wpdb->pdb);
+   if((wpdb = blDoReadPDB(fpin, FALSE, 1, 1, TRUE))!=NULL)
+   {
+      wpdb->pdb = blRemoveAlternates(wpdb->pdb);
+
+      /* The bond graph must not refer to removed atoms                 */
+      if((wpdb->bonds != NULL) && !StoreConectRecords(wpdb))
+      {
+         blFreeWholePDB(wpdb);
+         return(NULL);
+      }
+   }
    return(wpdb);
 }
 
 
 /************************************************************************/
-/*>static void StoreConectRecords(WHOLEPDB *wpdb, char *buffer)
-   ------------------------------------------------------------
+/*>static BOOL StoreConectRecords(WHOLEPDB *wpdb)
+   ----------------------------------------------
 *//**
    \param[in,out]    *wpdb      Whole PDB structure
-   \param[in]        *buffer    A line containing a CONECT record
+   \return                      Success (FALSE if no memory)
 
-   Stores the connectivity data from a CONECT record into the PDB linked
-   list
+   Stores the connectivity data from the CONECT records in the trailer
+   as a bond graph in wpdb->bonds, replacing any graph already there.
+   The graph has all the bonds. The per-atom CONECT arrays in the PDB
+   linked list are then filled from the graph; these hold at most 
+   MAXCONECT bonds for an atom.
 
 -  18.02.15  Original   By: ACRM
 -  05.03.15  Initialize all connected atoms to NULL and check for NULLs
@@ -2416,98 +4313,32 @@ WHOLEPDB *blReadWholePDBAtoms(FILE *fpin)
              atom specified in a CONECT record has alternate occupancies
              and an alternate position is removed. Previously this led
              to core dumps. e.g. PDB code 3pnw
+-  17.10.26  Now called once for all the CONECT records after reading 
+             the atoms. Atoms are found with blGetConectPairsWholePDB()
+             which uses an index by atom number rather than searching 
+             the linked list for each atom of each record
+-  17.10.26  Builds wpdb->bonds and fills the CONECT arrays from it. 
+             Returns BOOL
 */
-static void StoreConectRecords(WHOLEPDB *wpdb, char *buffer)
+static BOOL StoreConectRecords(WHOLEPDB *wpdb)
 {
-   char record_type[8];
-   int  i, j,
-        nConect,
-        atoms[5];
-   PDB  *p,
-        *atomsP[5];
-   BOOL gotLink;
-
-   fsscanf(buffer,"%6s%5d%5d%5d%5d%5d", 
-           record_type,&atoms[0],&atoms[1],&atoms[2],&atoms[3],&atoms[4]);
-
-   /* Find the PDB pointers for the (up to) 5 CONECT atoms              */
-   nConect = 0;
-   for(i=0; i<5; i++)
-   {
-      /* Have we run out of specified atoms?                            */
-      if(atoms[i] == 0)
-         break;
+   PDB **pairs;
+   int npairs;
 
-      atomsP[i] = NULL;                                 /* 05.03.15     */
+   blFreeBondGraph(wpdb->bonds);
+   wpdb->bonds = NULL;
 
-      /* Look for this atom                                             */
-      for(p=wpdb->pdb; p!=NULL; NEXT(p))
-      {
-         if(atoms[i] == p->atnum)
-         {
-            /* Found it so store and break out                          */
-            atomsP[i] = p;
-            nConect++;
-            break;
-         }
-      }
-   }
+   pairs = blGetConectPairsWholePDB(wpdb, &npairs);
+   if(npairs <= 0)
+      return(npairs==0);
 
-   /* Set the connections from atom 0                                   */
-   if(atomsP[0] != NULL)                                /* 05.03.15     */
-   {
-      for(i=1; i<nConect; i++)
-      {
-         /* Look to see if we have this conect stored already           */
-         gotLink = FALSE;
-         for(j=0; j<atomsP[0]->nConect; j++)
-         {
-            if(atomsP[i] != NULL)                       /* 05.03.15     */
-            {
-               if(atomsP[0]->conect[j] == atomsP[i])
-               {
-                  gotLink = TRUE;
-                  break;
-               }
-            }
-         }
-         
-         /* If not then store it                                        */
-         if(!gotLink && (atomsP[0]->nConect < MAXCONECT))
-         {
-            if(atomsP[i] != NULL)                       /* 05.03.15     */
-            {
-               atomsP[0]->conect[atomsP[0]->nConect] = atomsP[i];
-               (atomsP[0]->nConect)++;
-            }
-         }
-      }
+   wpdb->bonds = blBuildBondGraphPairs(wpdb->pdb, pairs, npairs);
+   free(pairs);
+   if(wpdb->bonds == NULL)
+      return(FALSE);
 
-      /* Set the connections in the other direction                     */
-      for(i=1; i<nConect; i++)
-      {
-         if(atomsP[i] != NULL)                          /* 05.03.15     */
-         {
-            /* Look to see if we have this conect stored already        */
-            gotLink = FALSE;
-            for(j=0; j<atomsP[i]->nConect; j++)
-            {
-               if(atomsP[i]->conect[j] == atomsP[0])
-               {
-                  gotLink = TRUE;
-                  break;
-               }
-            }
-            
-            /* If not then store it                                     */
-            if(!gotLink && (atomsP[i]->nConect < MAXCONECT))
-            {
-               atomsP[i]->conect[atomsP[i]->nConect] = atomsP[0];
-               (atomsP[i]->nConect)++;
-            }
-         }
-      }
-   }
+   blSetConectsFromBondGraph(wpdb->bonds);
+   return(TRUE);
 }
 
 #ifdef XML_SUPPORT
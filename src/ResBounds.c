@@ -0,0 +1,559 @@
+/************************************************************************/
+/**
+
+   \file       ResBounds.c
+
+   \version    V1.1
+   \date       17.10.26
+   \brief      Residue centroids and bounding spheres for coarse pruning
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   A coarse geometric layer over a PDBSTRUCT: for each residue the
+   centroid of its atoms, the centroid of its sidechain (the CA for
+   glycine, as blGetCofGPDBSCRange()) and the radius of a sphere about
+   the centroid containing every atom. All are found in one pass over
+   the atoms.
+
+   If the distance between the centroids of two residues exceeds the
+   sum of their radii plus d, no pair of atoms from the two can be
+   within d of one another. blResBoundsWithin() makes this test so
+   that distant pairs cost a single distance calculation. It is used
+   before any atom-level work by blAreResBoundsBonded() (BuildConect.c),
+   blIsHBondedResBounds() (hbond.c) and
+   blBuildAtomNeighbourPDBListResBounds() (BuildAtomNeighbourPDBList.c).
+   The corresponding routines that take pointers to residues,
+   blAreResiduePointersBonded(), blIsHBonded() and
+   blBuildAtomNeighbourPDBListAsCopy(), build the bounds as they go
+   with blSetResBoundRange(), which needs no PDBSTRUCT.
+
+   The layer is kept up to date without a full recalculation:
+   - blTranslateResBounds() and blApplyMatrixResBounds() follow
+     blTranslatePDB() and blApplyMatrixPDB() of the whole structure
+     by moving just the centroids;
+   - blMoveAtomResBound() moves a single atom and updates its
+     residue in constant time. The centroids stay exact but the
+     radius never shrinks, so may become an overestimate. Once the
+     possible overestimate exceeds RESBOUND_MAXSLACK the residue is
+     recalculated;
+   - blSetResBound() recalculates a residue after any other change
+     and blUpdateResBounds() the whole structure.
+
+   Atoms with NULL coordinates (all 9999.0) are not included in the
+   bounds but are counted so that callers can fall back to testing
+   them directly.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   PDBSTRUCT *pdbs;
+   RESBOUNDS *bounds;
+   int       i, j;
+
+   pdbs   = blAllocPDBStructure(pdb);
+   bounds = blAllocResBounds(pdbs);
+   for(i=0; i<bounds->nres; i++)
+      for(j=i+1; j<bounds->nres; j++)
+         if(blIsHBondedResBounds(&(bounds->residues[i]),
+                                 &(bounds->residues[j]), HBOND_ANY))
+            ...
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Added blSetResBoundRange(). The residue-pair and
+                  neighbour routines moved next to the routines they
+                  prune
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP Analyzing structures
+
+   #FUNCTION  blAllocResBounds()
+   Calculates the centroids and bounding spheres of the residues in a
+   PDBSTRUCT
+
+   #FUNCTION  blFreeResBounds()
+   Frees a RESBOUNDS structure
+
+   #FUNCTION  blSetResBound()
+   Recalculates the centroids and bounding sphere of one residue
+
+   #FUNCTION  blSetResBoundRange()
+   Calculates the centroids and bounding sphere of a range of atoms
+
+   #FUNCTION  blUpdateResBounds()
+   Recalculates the centroids and bounding spheres of all residues
+
+   #FUNCTION  blMoveAtomResBound()
+   Moves an atom and updates the bounds of its residue
+
+   #FUNCTION  blTranslateResBounds()
+   Updates the bounds after the structure has been translated
+
+   #FUNCTION  blApplyMatrixResBounds()
+   Updates the bounds after the structure has been rotated
+
+   #FUNCTION  blResBoundsWithin()
+   Tests whether two residues may have atoms within a distance
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "pdb.h"
+#include "matrix.h"
+#include "resbounds.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define NULLCOORD(p) (((p)->x > 9999.0) && \
+                      ((p)->y > 9999.0) && \
+                      ((p)->z > 9999.0))
+#define ISSIDECHAIN(p) (strncmp((p)->atnam, "N   ", 4) && \
+                        strncmp((p)->atnam, "CA  ", 4) && \
+                        strncmp((p)->atnam, "C   ", 4) && \
+                        strncmp((p)->atnam, "O   ", 4))
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+
+
+/************************************************************************/
+/*>RESBOUNDS *blAllocResBounds(PDBSTRUCT *pdbs)
+   --------------------------------------------
+*//**
+   \param[in]   *pdbs    Structure from blAllocPDBStructure()
+   \return               The bounds of each residue or NULL if memory
+                         allocation failed
+
+   Calculates the centroids and bounding spheres of all the residues in
+   a PDBSTRUCT. The residues are stored in the order of the chains and
+   residues, which is that of the PDB linked list.
+
+-  17.10.26 Original   By: ACRM
+*/
+RESBOUNDS *blAllocResBounds(PDBSTRUCT *pdbs)
+{
+   RESBOUNDS  *bounds;
+   PDBCHAIN   *chain;
+   PDBRESIDUE *res;
+   int        nres = 0;
+
+   if(pdbs == NULL)
+      return(NULL);
+
+   for(chain=pdbs->chains; chain!=NULL; NEXT(chain))
+   {
+      for(res=chain->residues; res!=NULL; NEXT(res))
+         nres++;
+   }
+
+   if((bounds = (RESBOUNDS *)malloc(sizeof(RESBOUNDS)))==NULL)
+      return(NULL);
+   if((bounds->residues =
+       (RESBOUND *)malloc((nres?nres:1) * sizeof(RESBOUND)))==NULL)
+   {
+      free(bounds);
+      return(NULL);
+   }
+   bounds->pdbs = pdbs;
+   bounds->nres = 0;
+
+   for(chain=pdbs->chains; chain!=NULL; NEXT(chain))
+   {
+      for(res=chain->residues; res!=NULL; NEXT(res))
+         bounds->residues[bounds->nres++].residue = res;
+   }
+
+   blUpdateResBounds(bounds);
+   return(bounds);
+}
+
+
+/************************************************************************/
+/*>void blFreeResBounds(RESBOUNDS *bounds)
+   ---------------------------------------
+*//**
+   \param[in]   *bounds   The residue bounds
+
+   Frees a RESBOUNDS structure. The PDBSTRUCT is not freed.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeResBounds(RESBOUNDS *bounds)
+{
+   if(bounds != NULL)
+   {
+      FREE(bounds->residues);
+      free(bounds);
+   }
+}
+
+
+/************************************************************************/
+/*>void blSetResBound(RESBOUND *rb)
+   --------------------------------
+*//**
+   \param[in,out] *rb    The bounds of a residue
+
+   Recalculates the centroids, bounding radius and largest covalent
+   radius of one residue from the coordinates of its atoms.
+
+-  17.10.26 Original   By: ACRM
+-  17.10.26 Counts the atoms with NULL coordinates   By: ACRM
+*/
+void blSetResBound(RESBOUND *rb)
+{
+   PDB  *p,
+        *ca = NULL;
+   REAL rad,
+        maxDistSq = 0.0;
+
+   rb->cg.x   = rb->cg.y   = rb->cg.z   = (REAL)0.0;
+   rb->scCg.x = rb->scCg.y = rb->scCg.z = (REAL)0.0;
+   rb->natoms    = 0;
+   rb->nscAtoms  = 0;
+   rb->nullAtoms = 0;
+   rb->slack     = (REAL)0.0;
+   rb->maxCovRad = (REAL)0.0;
+
+   for(p=rb->residue->start; p!=rb->residue->stop; NEXT(p))
+   {
+      if(NULLCOORD(p))
+      {
+         rb->nullAtoms++;
+         continue;
+      }
+
+      rb->cg.x += p->x;
+      rb->cg.y += p->y;
+      rb->cg.z += p->z;
+      rb->natoms++;
+
+      if(ISSIDECHAIN(p))
+      {
+         rb->scCg.x += p->x;
+         rb->scCg.y += p->y;
+         rb->scCg.z += p->z;
+         rb->nscAtoms++;
+      }
+      else if(!strncmp(p->atnam, "CA  ", 4))
+      {
+         ca = p;
+      }
+
+      rad = blCovalentRadius(p->element);
+      if(rad > rb->maxCovRad)
+         rb->maxCovRad = rad;
+   }
+
+   if(rb->natoms)
+   {
+      rb->cg.x /= rb->natoms;
+      rb->cg.y /= rb->natoms;
+      rb->cg.z /= rb->natoms;
+   }
+
+   if(rb->nscAtoms)
+   {
+      rb->scCg.x /= rb->nscAtoms;
+      rb->scCg.y /= rb->nscAtoms;
+      rb->scCg.z /= rb->nscAtoms;
+   }
+   else if(ca != NULL)
+   {
+      rb->scCg.x = ca->x;
+      rb->scCg.y = ca->y;
+      rb->scCg.z = ca->z;
+   }
+
+   /* The atoms of the residue are still in cache                       */
+   for(p=rb->residue->start; p!=rb->residue->stop; NEXT(p))
+   {
+      REAL distSq;
+
+      if(NULLCOORD(p))
+         continue;
+
+      distSq = DISTSQ(p, &(rb->cg));
+      if(distSq > maxDistSq)
+         maxDistSq = distSq;
+   }
+   rb->radius = (REAL)sqrt(maxDistSq);
+}
+
+
+/************************************************************************/
+/*>void blSetResBoundRange(RESBOUND *rb, PDBRESIDUE *res, PDB *start,
+                           PDB *stop)
+   ------------------------------------------------------------------
+*//**
+   \param[out]  *rb      The bounds of the atoms
+   \param[out]  *res     Residue to describe the range of atoms
+   \param[in]   *start   First atom
+   \param[in]   *stop    Atom after the last (or NULL)
+
+   Calculates the bounds of the atoms from start up to stop (normally
+   a residue found with blFindNextResidue()) without needing a
+   PDBSTRUCT. Only the start and stop of res are used and it must
+   stay in scope as long as rb is used.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blSetResBoundRange(RESBOUND *rb, PDBRESIDUE *res, PDB *start,
+                        PDB *stop)
+{
+   res->next   = NULL;
+   res->prev   = NULL;
+   res->extras = NULL;
+   res->start  = start;
+   res->stop   = stop;
+   rb->residue = res;
+   blSetResBound(rb);
+}
+
+
+/************************************************************************/
+/*>void blUpdateResBounds(RESBOUNDS *bounds)
+   -----------------------------------------
+*//**
+   \param[in,out] *bounds   The residue bounds
+
+   Recalculates the bounds of all the residues, for example after the
+   coordinates have been refined.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blUpdateResBounds(RESBOUNDS *bounds)
+{
+   int i;
+
+   for(i=0; i<bounds->nres; i++)
+      blSetResBound(&(bounds->residues[i]));
+}
+
+
+/************************************************************************/
+/*>void blMoveAtomResBound(RESBOUND *rb, PDB *p, REAL x, REAL y, REAL z)
+   ---------------------------------------------------------------------
+*//**
+   \param[in,out] *rb    The bounds of the residue containing p
+   \param[in,out] *p     The atom to move
+   \param[in]     x      New x coordinate
+   \param[in]     y      New y coordinate
+   \param[in]     z      New z coordinate
+
+   Moves an atom and updates the bounds of its residue without visiting
+   the other atoms. The centroids are shifted exactly. Every other atom
+   was within the radius of the old centroid, so the radius is grown by
+   the shift of the centroid (and to include the new position). When
+   the possible overestimate of the radius exceeds RESBOUND_MAXSLACK,
+   or if the old or new coordinates are NULL, the residue is
+   recalculated.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blMoveAtomResBound(RESBOUND *rb, PDB *p, REAL x, REAL y, REAL z)
+{
+   VEC3F delta;
+   REAL  move,
+         shift,
+         dist;
+   BOOL  wasNull = NULLCOORD(p);
+
+   delta.x = x - p->x;
+   delta.y = y - p->y;
+   delta.z = z - p->z;
+   p->x    = x;
+   p->y    = y;
+   p->z    = z;
+
+   if(wasNull || NULLCOORD(p))
+   {
+      blSetResBound(rb);
+      return;
+   }
+
+   if(ISSIDECHAIN(p))
+   {
+      rb->scCg.x += delta.x / rb->nscAtoms;
+      rb->scCg.y += delta.y / rb->nscAtoms;
+      rb->scCg.z += delta.z / rb->nscAtoms;
+   }
+   else if(!rb->nscAtoms && !strncmp(p->atnam, "CA  ", 4))
+   {
+      rb->scCg.x = x;
+      rb->scCg.y = y;
+      rb->scCg.z = z;
+   }
+
+   move     = (REAL)sqrt(delta.x*delta.x +
+                         delta.y*delta.y +
+                         delta.z*delta.z);
+   delta.x /= rb->natoms;
+   delta.y /= rb->natoms;
+   delta.z /= rb->natoms;
+   rb->cg.x += delta.x;
+   rb->cg.y += delta.y;
+   rb->cg.z += delta.z;
+
+   shift       = move / rb->natoms;
+   rb->radius += shift;
+
+   /* The true radius may have shrunk by up to the shift plus the move,
+      if this was the outermost atom
+   */
+   rb->slack  += 2*shift + move;
+
+   dist = DIST(p, &(rb->cg));
+   if(dist > rb->radius)
+      rb->radius = dist;
+
+   if(rb->slack > RESBOUND_MAXSLACK)
+      blSetResBound(rb);
+}
+
+
+/************************************************************************/
+/*>void blTranslateResBounds(RESBOUNDS *bounds, VEC3F tvect)
+   ---------------------------------------------------------
+*//**
+   \param[in,out] *bounds   The residue bounds
+   \param[in]     tvect     Translation vector
+
+   Updates the bounds after blTranslatePDB() has been applied to the
+   structure. Only the centroids move.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blTranslateResBounds(RESBOUNDS *bounds, VEC3F tvect)
+{
+   int i;
+
+   for(i=0; i<bounds->nres; i++)
+   {
+      RESBOUND *rb = &(bounds->residues[i]);
+
+      if(rb->natoms)
+      {
+         rb->cg.x   += tvect.x;
+         rb->cg.y   += tvect.y;
+         rb->cg.z   += tvect.z;
+         rb->scCg.x += tvect.x;
+         rb->scCg.y += tvect.y;
+         rb->scCg.z += tvect.z;
+      }
+   }
+}
+
+
+/************************************************************************/
+/*>void blApplyMatrixResBounds(RESBOUNDS *bounds, REAL matrix[3][3])
+   -----------------------------------------------------------------
+*//**
+   \param[in,out] *bounds   The residue bounds
+   \param[in]     matrix    Rotation matrix
+
+   Updates the bounds after blApplyMatrixPDB() has been applied to the
+   structure. The matrix must be a pure rotation so that the radii are
+   unchanged.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blApplyMatrixResBounds(RESBOUNDS *bounds, REAL matrix[3][3])
+{
+   VEC3F incoords;
+   int   i;
+
+   for(i=0; i<bounds->nres; i++)
+   {
+      RESBOUND *rb = &(bounds->residues[i]);
+
+      if(rb->natoms)
+      {
+         incoords = rb->cg;
+         blMatMult3_33(incoords, matrix, &(rb->cg));
+         incoords = rb->scCg;
+         blMatMult3_33(incoords, matrix, &(rb->scCg));
+      }
+   }
+}
+
+
+/************************************************************************/
+/*>BOOL blResBoundsWithin(RESBOUND *rb1, RESBOUND *rb2, REAL dist)
+   ---------------------------------------------------------------
+*//**
+   \param[in]   *rb1     The bounds of the first residue
+   \param[in]   *rb2     The bounds of the second residue
+   \param[in]   dist     Distance
+   \return               FALSE if no atom of one residue can be within
+                         dist of an atom of the other
+
+   Tests whether the bounding spheres of two residues, expanded by dist,
+   overlap. A TRUE return only means that atom-level tests are needed.
+   Atoms with NULL coordinates are not considered.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blResBoundsWithin(RESBOUND *rb1, RESBOUND *rb2, REAL dist)
+{
+   REAL reach;
+
+   if(!rb1->natoms || !rb2->natoms)
+      return(FALSE);
+
+   reach = rb1->radius + rb2->radius + dist;
+   if(reach < (REAL)0.0)
+      return(FALSE);
+
+   return((DISTSQ(&(rb1->cg), &(rb2->cg)) <= reach*reach) ? TRUE : FALSE);
+}
+
@@ -0,0 +1,1370 @@
+/************************************************************************/
+/**
+
+   \file       SeqCluster.c
+
+   \version    V1.1
+   \date       17.10.26
+   \brief      K-mer index and greedy redundancy clustering of
+               sequences
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+   Description:
+   ============
+
+   Builds non-redundant sets of sequences, such as the chains of every
+   PDB file, without aligning every pair.
+
+   A SEQINDEX holds the sequences together with an inverted index
+   giving, for every k-mer (word) of the 20 standard amino acids, the
+   sequences in which it occurs. Words containing other residues are
+   not indexed.
+
+   Two sequences of identity t over the length L of the shorter, where
+   the shorter has n words, must share at least n - k.floor((1-t)L)
+   words, since each mismatch or gap in the shorter sequence can
+   remove at most k of its words. The shared words (counted with their
+   multiplicity) are found from the index and only pairs which pass
+   this test are aligned, with blMDMatrixAffinealign(). The identity 
+   is the number of identical aligned residues divided by the length 
+   of the shorter sequence. This is the short word filter of CD-HIT 
+   (Li & Godzik (2006) Bioinformatics 22, 1658-1659). Longer words 
+   filter more strongly at high identities; blSeqIndexWordSize() 
+   suggests a length for a threshold.
+
+   blClusterSeqIndex() does greedy incremental clustering. The
+   sequences are taken longest first; each joins the cluster of the
+   first existing representative (in the order they were chosen) with
+   at least the required identity or else becomes a new
+   representative. The sequences are taken in batches: each sequence
+   in a batch is compared with the representatives chosen before the
+   batch in parallel and then, in order, with any chosen within the
+   batch. The result is therefore the same for any number of threads.
+
+   If the library is compiled with PTHREAD_SUPPORT, a pool of threads
+   takes sequences from the batch in turn, so a thread that is given
+   short sequences or few candidates simply takes more of them.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   SEQINDEX    *index;
+   SEQCLUSTERS *clusters;
+   
+   index = blAllocSeqIndex(blSeqIndexWordSize(0.9));
+   blAddSeqIndexPDB(index, "1abc", pdb);
+   ...
+   clusters = blClusterSeqIndex(index, mdm, 0.9, 8);
+   blPrintSeqClusters(stdout, index, clusters);
+   blFreeSeqClusters(clusters);
+   blFreeSeqIndex(index);
+\endcode
+
+   mdm is a matrix from blReadMDMatrix() or NULL to align with an
+   identity matrix.
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Uses blRunThreadPool()   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling Sequence Data
+   #SUBGROUP Clustering
+
+   #FUNCTION  blSeqIndexWordSize()
+   Suggests a k-mer length for an identity threshold
+
+   #FUNCTION  blAllocSeqIndex()
+   Creates an empty sequence index
+
+   #FUNCTION  blFreeSeqIndex()
+   Frees a sequence index
+
+   #FUNCTION  blAddSeqIndex()
+   Adds a sequence to an index
+
+   #FUNCTION  blAddSeqIndexPDB()
+   Adds the sequence of each protein chain of a PDB linked list
+
+   #FUNCTION  blAddSeqIndexFASTA()
+   Adds the sequences from a FASTA file
+
+   #FUNCTION  blSearchSeqIndex()
+   Finds the sequences in an index similar to a query
+
+   #FUNCTION  blFreeSeqHits()
+   Frees a list of search hits
+
+   #FUNCTION  blClusterSeqIndex()
+   Clusters the sequences in an index by identity
+
+   #FUNCTION  blFreeSeqClusters()
+   Frees the result of clustering
+
+   #FUNCTION  blPrintSeqClusters()
+   Prints clusters in the format of a CD-HIT .clstr file
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "hash.h"
+#include "pdb.h"
+#include "seq.h"
+#include "sequtil.h"
+#include "threadpool.h"
+#include "seqcluster.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define MAXFASTABUFF 1024    /* Longest FASTA header line               */
+#define ALLOCSTEP    256
+#define NRESTYPES    20
+
+/* Arrays used by one thread to compare a sequence with others         */
+typedef struct
+{
+   int   *shared,            /* Words shared with each sequence (zero
+                                between uses)                           */
+         *touched,           /* Sequences with non-zero shared[]        */
+         *cands,
+         *words;
+   char  *align1,
+         *align2;
+   ULONG nalign;
+}  SCWORKSPACE;
+
+/* A batch of sequences being clustered                                 */
+typedef struct
+{
+   SEQINDEX    *index;
+   SEQCLUSTERS *clusters;
+   MDMATRIX    *mdm;
+   SCWORKSPACE *ws;          /* One per thread                          */
+   REAL        minIdentity,
+               *matchIdentity;
+   int         *order,       /* Sequences, longest first                */
+               *repNum,      /* Representative number of each sequence
+                                or -1                                   */
+               *match,       /* Representative found for each sequence
+                                in the batch or -1                      */
+               batchStart,
+               batchEnd,
+               nreps,        /* Representatives chosen before the batch */
+               next;
+}  SCBATCH;
+
+/* Passed to each thread                                                */
+typedef struct
+{
+   SCBATCH     *batch;
+   SCWORKSPACE *ws;
+}  SCTHREAD;
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static int  ResidueCode(char res);
+static int  CompareInts(const void *a, const void *b);
+static int  GetWords(char *seq, int length, int wordSize, int *words);
+static BOOL BuildIndex(SEQINDEX *index);
+static BOOL AllocWorkspace(SCWORKSPACE *ws, int nseqs, int maxlen);
+static void FreeWorkspace(SCWORKSPACE *ws);
+static int  WordsNeeded(int wordSize, int nwords, int length,
+                        REAL minIdentity);
+static int  CountShared(SEQINDEX *index, SCWORKSPACE *ws, char *seq,
+                        int length, int *repNum, int minRep, int maxRep);
+static REAL Identity(SCWORKSPACE *ws, MDMATRIX *mdm, char *seq1,
+                     int length1, char *seq2, int length2);
+static int  FindRep(SCBATCH *batch, SCWORKSPACE *ws, int seq, 
+                    int minRep, int maxRep, REAL *identity);
+static void *CompareBatch(void *arg);
+static int  CompareHits(const void *a, const void *b);
+
+
+/************************************************************************/
+/*>static int ResidueCode(char res)
+   --------------------------------
+*//**
+
+   \param[in]     res       Upper case amino acid
+   \return                  0-19 for the standard amino acids, else -1
+
+-  17.10.26 Original   By: ACRM
+*/
+static int ResidueCode(char res)
+{
+   switch(res)
+   {
+   case 'A': return(0);
+   case 'C': return(1);
+   case 'D': return(2);
+   case 'E': return(3);
+   case 'F': return(4);
+   case 'G': return(5);
+   case 'H': return(6);
+   case 'I': return(7);
+   case 'K': return(8);
+   case 'L': return(9);
+   case 'M': return(10);
+   case 'N': return(11);
+   case 'P': return(12);
+   case 'Q': return(13);
+   case 'R': return(14);
+   case 'S': return(15);
+   case 'T': return(16);
+   case 'V': return(17);
+   case 'W': return(18);
+   case 'Y': return(19);
+   }
+   return(-1);
+}
+
+
+/************************************************************************/
+/*>static int CompareInts(const void *a, const void *b)
+   ----------------------------------------------------
+*//**
+
+   \param[in]     *a        Pointer to an int
+   \param[in]     *b        Pointer to an int
+   \return                  Comparison for qsort() giving increasing 
+                            order
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CompareInts(const void *a, const void *b)
+{
+   int ia = *(const int *)a,
+       ib = *(const int *)b;
+
+   return((ia > ib) - (ia < ib));
+}
+
+
+/************************************************************************/
+/*>static int GetWords(char *seq, int length, int wordSize, int *words)
+   --------------------------------------------------------------------
+*//**
+
+   \param[in]     *seq      Upper case sequence
+   \param[in]     length    Its length
+   \param[in]     wordSize  k-mer length
+   \param[out]    *words    The k-mers in increasing order (space for
+                            length values)
+   \return                  Number of k-mers
+
+   Finds the k-mers which contain only the standard amino acids,
+   encoded as base-20 numbers
+
+-  17.10.26 Original   By: ACRM
+*/
+static int GetWords(char *seq, int length, int wordSize, int *words)
+{
+   int i, code,
+       mod    = 1,
+       word   = 0,
+       run    = 0,
+       nwords = 0;
+
+   for(i=1; i<wordSize; i++)
+      mod *= NRESTYPES;
+
+   for(i=0; i<length; i++)
+   {
+      if((code = ResidueCode(seq[i])) < 0)
+      {
+         run  = 0;
+         word = 0;
+         continue;
+      }
+      word = (word % mod) * NRESTYPES + code;
+      if(++run >= wordSize)
+         words[nwords++] = word;
+   }
+
+   qsort(words, nwords, sizeof(int), CompareInts);
+   return(nwords);
+}
+
+
+/************************************************************************/
+/*>static BOOL BuildIndex(SEQINDEX *index)
+   ---------------------------------------
+*//**
+
+   \param[in,out] *index    Index
+   \return                  FALSE on allocation failure
+
+   Builds the inverted index of k-mers. The postings of each k-mer are
+   in order of sequence, with a sequence repeated for each occurrence.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL BuildIndex(SEQINDEX *index)
+{
+   int  *words,
+        ntotal = 0,
+        i, w, nwords;
+
+   FREE(index->wordStart);
+   FREE(index->postings);
+
+   for(i=0; i<index->nseqs; i++)
+      ntotal += index->nwords[i];
+
+   index->wordStart = (int *)calloc(index->nwordTypes+1, sizeof(int));
+   index->postings  = (int *)malloc((ntotal+1) * sizeof(int));
+   words            = (int *)malloc((index->maxlen+1) * sizeof(int));
+   if((index->wordStart == NULL) || (index->postings == NULL) ||
+      (words == NULL))
+   {
+      FREE(words);
+      return(FALSE);
+   }
+
+   /* Count the postings for each k-mer and make them offsets           */
+   for(i=0; i<index->nseqs; i++)
+   {
+      nwords = GetWords(index->seqs[i], index->lengths[i],
+                        index->wordSize, words);
+      for(w=0; w<nwords; w++)
+         index->wordStart[words[w]+1]++;
+   }
+   for(w=1; w<=index->nwordTypes; w++)
+      index->wordStart[w] += index->wordStart[w-1];
+
+   /* Fill the postings, using wordStart[] as the next free slot        */
+   for(i=0; i<index->nseqs; i++)
+   {
+      nwords = GetWords(index->seqs[i], index->lengths[i],
+                        index->wordSize, words);
+      for(w=0; w<nwords; w++)
+         index->postings[index->wordStart[words[w]]++] = i;
+   }
+   /* The starts have moved to the ends; shift them back                */
+   for(w=index->nwordTypes; w>0; w--)
+      index->wordStart[w] = index->wordStart[w-1];
+   index->wordStart[0] = 0;
+
+   free(words);
+   index->dirty = FALSE;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static BOOL AllocWorkspace(SCWORKSPACE *ws, int nseqs, int maxlen)
+   ------------------------------------------------------------------
+*//**
+
+   \param[out]    *ws       Workspace
+   \param[in]     nseqs     Sequences in the index
+   \param[in]     maxlen    Longest sequence to be compared
+   \return                  Success
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL AllocWorkspace(SCWORKSPACE *ws, int nseqs, int maxlen)
+{
+   ws->shared  = (int *)calloc(nseqs+1, sizeof(int));
+   ws->touched = (int *)malloc((nseqs+1) * sizeof(int));
+   ws->cands   = (int *)malloc((nseqs+1) * sizeof(int));
+   ws->words   = (int *)malloc((maxlen+1) * sizeof(int));
+   ws->align1  = (char *)malloc((2*maxlen+1) * sizeof(char));
+   ws->align2  = (char *)malloc((2*maxlen+1) * sizeof(char));
+   ws->nalign  = 0;
+
+   if((ws->shared == NULL) || (ws->touched == NULL) ||
+      (ws->cands  == NULL) || (ws->words   == NULL) ||
+      (ws->align1 == NULL) || (ws->align2  == NULL))
+   {
+      FreeWorkspace(ws);
+      return(FALSE);
+   }
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static void FreeWorkspace(SCWORKSPACE *ws)
+   ------------------------------------------
+*//**
+
+   \param[in,out] *ws       Workspace
+
+-  17.10.26 Original   By: ACRM
+*/
+static void FreeWorkspace(SCWORKSPACE *ws)
+{
+   FREE(ws->shared);
+   FREE(ws->touched);
+   FREE(ws->cands);
+   FREE(ws->words);
+   FREE(ws->align1);
+   FREE(ws->align2);
+}
+
+
+/************************************************************************/
+/*>static int WordsNeeded(int wordSize, int nwords, int length,
+                          REAL minIdentity)
+   ------------------------------------------------------------
+*//**
+
+   \param[in]     wordSize     k-mer length
+   \param[in]     nwords       k-mers in the shorter sequence
+   \param[in]     length       Length of the shorter sequence
+   \param[in]     minIdentity  Identity threshold
+   \return                     Fewest k-mers two sequences can share
+                               and reach the threshold (may be <= 0)
+
+-  17.10.26 Original   By: ACRM
+*/
+static int WordsNeeded(int wordSize, int nwords, int length,
+                       REAL minIdentity)
+{
+   int nmismatch = (int)floor(((REAL)1.0 - minIdentity) * length + 
+                              (REAL)0.00001);
+   
+   return(nwords - wordSize * nmismatch);
+}
+
+
+/************************************************************************/
+/*>static int CountShared(SEQINDEX *index, SCWORKSPACE *ws, char *seq,
+                          int length, int *repNum, int minRep,
+                          int maxRep)
+   -------------------------------------------------------------------
+*//**
+
+   \param[in]     *index    Index
+   \param[in,out] *ws       Workspace. ws->shared[] is set for the
+                            sequences listed in ws->touched[]
+   \param[in]     *seq      Upper case sequence
+   \param[in]     length    Its length
+   \param[in]     *repNum   Representative number of each sequence in
+                            the index (or NULL to count all sequences)
+   \param[in]     minRep    Count only representatives minRep...
+   \param[in]     maxRep    ...maxRep-1
+   \return                  Number of sequences in ws->touched[]
+
+   Counts the k-mers each sequence in the index shares with a sequence.
+   A k-mer occurring m times in one and n times in the other counts
+   min(m,n) times.
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CountShared(SEQINDEX *index, SCWORKSPACE *ws, char *seq,
+                       int length, int *repNum, int minRep, int maxRep)
+{
+   int nwords, ntouched = 0,
+       w, mult, i, end, s, run;
+
+   nwords = GetWords(seq, length, index->wordSize, ws->words);
+   for(w=0; w<nwords; w+=mult)
+   {
+      for(mult=1; 
+          (w+mult < nwords) && (ws->words[w+mult] == ws->words[w]);
+          mult++);
+
+      end = index->wordStart[ws->words[w]+1];
+      for(i=index->wordStart[ws->words[w]]; i<end; i+=run)
+      {
+         s = index->postings[i];
+         for(run=1; (i+run < end) && (index->postings[i+run] == s); 
+             run++);
+         if((repNum != NULL) &&
+            ((repNum[s] < minRep) || (repNum[s] >= maxRep)))
+            continue;
+         if(ws->shared[s] == 0)
+            ws->touched[ntouched++] = s;
+         ws->shared[s] += MIN(run, mult);
+      }
+   }
+   
+   return(ntouched);
+}
+
+
+/************************************************************************/
+/*>static REAL Identity(SCWORKSPACE *ws, MDMATRIX *mdm, char *seq1,
+                        int length1, char *seq2, int length2)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in,out] *ws       Workspace with alignment buffers of at least
+                            length1+length2+1
+   \param[in]     *mdm      Scoring matrix (NULL for identity)
+   \param[in]     *seq1     First sequence
+   \param[in]     length1   Its length
+   \param[in]     *seq2     Second sequence
+   \param[in]     length2   Its length
+   \return                  Identical aligned residues over the length
+                            of the shorter sequence
+
+-  17.10.26 Original   By: ACRM
+*/
+static REAL Identity(SCWORKSPACE *ws, MDMATRIX *mdm, char *seq1,
+                     int length1, char *seq2, int length2)
+{
+   int alen   = 0,
+       nident = 0,
+       i;
+
+   blMDMatrixAffinealign(mdm, seq1, length1, seq2, length2, FALSE,
+                         (mdm == NULL), SEQIDX_GAPOPEN, SEQIDX_GAPEXT, 0,
+                         ws->align1, ws->align2, &alen);
+   ws->nalign++;
+   for(i=0; i<alen; i++)
+   {
+      if((ws->align1[i] == ws->align2[i]) && (ws->align1[i] != '-'))
+         nident++;
+   }
+
+   return((REAL)nident / MIN(length1, length2));
+}
+
+
+/************************************************************************/
+/*>static int FindRep(SCBATCH *batch, SCWORKSPACE *ws, int seq,
+                      int minRep, int maxRep, REAL *identity)
+   ------------------------------------------------------------
+*//**
+
+   \param[in]     *batch    Clustering in progress
+   \param[in,out] *ws       Workspace
+   \param[in]     seq       Sequence to place
+   \param[in]     minRep    Compare with representatives minRep...
+   \param[in]     maxRep    ...maxRep-1
+   \param[out]    *identity Identity to the representative found
+   \return                  First of these representatives with enough
+                            identity, or -1
+
+   The representatives are no shorter than the sequence, so the filter
+   is based on the sequence's own k-mers.
+
+-  17.10.26 Original   By: ACRM
+*/
+static int FindRep(SCBATCH *batch, SCWORKSPACE *ws, int seq,
+                   int minRep, int maxRep, REAL *identity)
+{
+   SEQINDEX *index  = batch->index;
+   int      length  = index->lengths[seq],
+            ncands  = 0,
+            need, ntouched, i, r, s;
+
+   need = WordsNeeded(index->wordSize, index->nwords[seq], length,
+                      batch->minIdentity);
+   if(need <= 0)
+   {
+      for(r=minRep; r<maxRep; r++)
+         ws->cands[ncands++] = r;
+   }
+   else
+   {
+      ntouched = CountShared(index, ws, index->seqs[seq], length,
+                             batch->repNum, minRep, maxRep);
+      for(i=0; i<ntouched; i++)
+      {
+         s = ws->touched[i];
+         if(ws->shared[s] >= need)
+            ws->cands[ncands++] = batch->repNum[s];
+         ws->shared[s] = 0;
+      }
+      qsort(ws->cands, ncands, sizeof(int), CompareInts);
+   }
+
+   for(i=0; i<ncands; i++)
+   {
+      s = batch->clusters->rep[ws->cands[i]];
+      *identity = Identity(ws, batch->mdm, index->seqs[s],
+                           index->lengths[s], index->seqs[seq], length);
+      if(*identity >= batch->minIdentity)
+         return(ws->cands[i]);
+   }
+   
+   return(-1);
+}
+
+
+/************************************************************************/
+/*>static void *CompareBatch(void *arg)
+   ------------------------------------
+*//**
+
+   \param[in,out] *arg      SCTHREAD for this thread
+   \return                  NULL
+
+   Takes sequences from the batch in turn and compares each with the
+   representatives chosen before the batch. Run by each thread.
+
+-  17.10.26 Original   By: ACRM
+*/
+static void *CompareBatch(void *arg)
+{
+   SCTHREAD *thread = (SCTHREAD *)arg;
+   SCBATCH  *batch  = thread->batch;
+   int      i;
+
+   for(;;)
+   {
+      if((i = blThreadPoolIncrement(&(batch->next))) >= batch->batchEnd)
+         break;
+
+      batch->match[i - batch->batchStart] = 
+         FindRep(batch, thread->ws, batch->order[i], 0, batch->nreps,
+                 &(batch->matchIdentity[i - batch->batchStart]));
+   }
+
+   return(NULL);
+}
+
+
+/************************************************************************/
+/*>static int CompareHits(const void *a, const void *b)
+   ----------------------------------------------------
+*//**
+
+   \param[in]     *a        Pointer to a SEQHIT pointer
+   \param[in]     *b        Pointer to a SEQHIT pointer
+   \return                  Comparison for qsort() giving decreasing
+                            identity then increasing entry number
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CompareHits(const void *a, const void *b)
+{
+   SEQHIT *hitA = *(SEQHIT **)a,
+          *hitB = *(SEQHIT **)b;
+
+   if(hitA->identity > hitB->identity)
+      return(-1);
+   if(hitA->identity < hitB->identity)
+      return(1);
+   return(hitA->entry - hitB->entry);
+}
+
+
+/************************************************************************/
+/*>int blSeqIndexWordSize(REAL minIdentity)
+   ----------------------------------------
+*//**
+
+   \param[in]     minIdentity  Identity threshold (0-1)
+   \return                     Suggested k-mer length
+
+   Suggests the k-mer length for a clustering threshold, following
+   CD-HIT: 5 for 0.7 and above, 4 for 0.6, 3 for 0.5 and 2 below that.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blSeqIndexWordSize(REAL minIdentity)
+{
+   if(minIdentity >= (REAL)0.7)
+      return(5);
+   if(minIdentity >= (REAL)0.6)
+      return(4);
+   if(minIdentity >= (REAL)0.5)
+      return(3);
+   return(2);
+}
+
+
+/************************************************************************/
+/*>SEQINDEX *blAllocSeqIndex(int wordSize)
+   ---------------------------------------
+*//**
+
+   \param[in]     wordSize  k-mer length (1-SEQIDX_MAXWORD, or 0 for
+                            SEQIDX_DEFWORD)
+   \return                  Empty index (NULL if no memory or the word
+                            size is invalid)
+
+-  17.10.26 Original   By: ACRM
+*/
+SEQINDEX *blAllocSeqIndex(int wordSize)
+{
+   SEQINDEX *index;
+   int      i;
+
+   if(wordSize == 0)
+      wordSize = SEQIDX_DEFWORD;
+   if((wordSize < 1) || (wordSize > SEQIDX_MAXWORD))
+      return(NULL);
+   
+   if((index = (SEQINDEX *)malloc(sizeof(SEQINDEX)))==NULL)
+      return(NULL);
+
+   index->ids        = NULL;
+   index->chains     = NULL;
+   index->seqs       = NULL;
+   index->lengths    = NULL;
+   index->nwords     = NULL;
+   index->wordStart  = NULL;
+   index->postings   = NULL;
+   index->nseqs      = 0;
+   index->maxseqs    = 0;
+   index->maxlen     = 0;
+   index->wordSize   = wordSize;
+   index->nwordTypes = 1;
+   index->dirty      = TRUE;
+   for(i=0; i<wordSize; i++)
+      index->nwordTypes *= NRESTYPES;
+
+   return(index);
+}
+
+
+/************************************************************************/
+/*>void blFreeSeqIndex(SEQINDEX *index)
+   ------------------------------------
+*//**
+
+   \param[in]     *index    Index
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeSeqIndex(SEQINDEX *index)
+{
+   int i;
+
+   if(index == NULL)
+      return;
+
+   for(i=0; i<index->nseqs; i++)
+   {
+      FREE(index->ids[i]);
+      FREE(index->chains[i]);
+      FREE(index->seqs[i]);
+   }
+   FREE(index->ids);
+   FREE(index->chains);
+   FREE(index->seqs);
+   FREE(index->lengths);
+   FREE(index->nwords);
+   FREE(index->wordStart);
+   FREE(index->postings);
+   free(index);
+}
+
+
+/************************************************************************/
+/*>BOOL blAddSeqIndex(SEQINDEX *index, char *id, char *chain, char *seq)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in,out] *index    Index
+   \param[in]     *id       Identifier (copied)
+   \param[in]     *chain    Chain label (copied; may be NULL)
+   \param[in]     *seq      Sequence (copied and upcased)
+   \return                  FALSE if no memory
+
+   Adds a sequence. Empty sequences are ignored, so the entry number of
+   a sequence is the number of non-empty sequences added before it.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blAddSeqIndex(SEQINDEX *index, char *id, char *chain, char *seq)
+{
+   int  length, i, n;
+   
+   if((length = strlen(seq)) == 0)
+      return(TRUE);
+   if(chain == NULL)
+      chain = "";
+
+   if(index->nseqs == index->maxseqs)
+   {
+      char **newIds, **newChains, **newSeqs;
+      int  *newLengths, *newNwords;
+
+      n          = index->maxseqs + ALLOCSTEP;
+      newIds     = (char **)realloc(index->ids,     n * sizeof(char *));
+      if(newIds != NULL)     index->ids     = newIds;
+      newChains  = (char **)realloc(index->chains,  n * sizeof(char *));
+      if(newChains != NULL)  index->chains  = newChains;
+      newSeqs    = (char **)realloc(index->seqs,    n * sizeof(char *));
+      if(newSeqs != NULL)    index->seqs    = newSeqs;
+      newLengths = (int *)realloc(index->lengths,   n * sizeof(int));
+      if(newLengths != NULL) index->lengths = newLengths;
+      newNwords  = (int *)realloc(index->nwords,    n * sizeof(int));
+      if(newNwords != NULL)  index->nwords  = newNwords;
+      if((newIds == NULL) || (newChains == NULL) || (newSeqs == NULL) ||
+         (newLengths == NULL) || (newNwords == NULL))
+         return(FALSE);
+      index->maxseqs = n;
+   }
+
+   n = index->nseqs;
+   index->ids[n]    = (char *)malloc(strlen(id) + 1);
+   index->chains[n] = (char *)malloc(strlen(chain) + 1);
+   index->seqs[n]   = (char *)malloc(length + 1);
+   if((index->ids[n] == NULL) || (index->chains[n] == NULL) ||
+      (index->seqs[n] == NULL))
+   {
+      FREE(index->ids[n]);
+      FREE(index->chains[n]);
+      FREE(index->seqs[n]);
+      return(FALSE);
+   }
+   strcpy(index->ids[n],    id);
+   strcpy(index->chains[n], chain);
+   for(i=0; i<=length; i++)
+      index->seqs[n][i] = (char)toupper(seq[i]);
+
+   /* Count the k-mers                                                  */
+   index->nwords[n] = 0;
+   for(i=0; i<length; i++)
+   {
+      int run;
+      
+      for(run=0; (run < index->wordSize) && (i+run < length) &&
+             (ResidueCode(index->seqs[n][i+run]) >= 0); run++);
+      if(run == index->wordSize)
+         index->nwords[n]++;
+   }
+
+   index->lengths[n] = length;
+   if(length > index->maxlen)
+      index->maxlen = length;
+   index->nseqs++;
+   index->dirty = TRUE;
+   
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>int blAddSeqIndexPDB(SEQINDEX *index, char *id, PDB *pdb)
+   ---------------------------------------------------------
+*//**
+
+   \param[in,out] *index    Index
+   \param[in]     *id       Identifier for the structure
+   \param[in]     *pdb      PDB linked list
+   \return                  Number of chains added (-1 on error)
+
+   Adds the sequence of each protein chain, from 
+   blDoPDB2SeqByChain(), in the order of the chains in the linked list.
+   A chain label which appears more than once is added once.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blAddSeqIndexPDB(SEQINDEX *index, char *id, PDB *pdb)
+{
+   HASHTABLE *hash;
+   PDB       *chain;
+   char      *seq;
+   int       nadded = 0;
+
+   if((hash = blDoPDB2SeqByChain(pdb, FALSE, TRUE, FALSE))==NULL)
+      return(-1);
+
+   for(chain=pdb; chain!=NULL; chain=blFindNextChain(chain))
+   {
+      if(!blHashKeyDefined(hash, chain->chain))
+         continue;
+      seq = blGetHashValueString(hash, chain->chain);
+      if((seq != NULL) && (seq[0] != '\0'))
+      {
+         if(!blAddSeqIndex(index, id, chain->chain, seq))
+         {
+            nadded = (-1);
+            break;
+         }
+         nadded++;
+      }
+      blDeleteHashKey(hash, chain->chain);
+   }
+
+   blFreeHash(hash);
+   return(nadded);
+}
+
+
+/************************************************************************/
+/*>int blAddSeqIndexFASTA(SEQINDEX *index, FILE *fp)
+   -------------------------------------------------
+*//**
+
+   \param[in,out] *index    Index
+   \param[in]     *fp       FASTA file
+   \return                  Number of sequences added (-1 on error)
+
+   Adds every sequence in a FASTA file. The identifier is the first
+   word of the header and the chain label is blank.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blAddSeqIndexFASTA(SEQINDEX *index, FILE *fp)
+{
+   char header[MAXFASTABUFF],
+        buffer[MAXFASTABUFF],
+        id[MAXFASTABUFF],
+        *seq;
+   int  nadded = 0;
+   BOOL ok;
+
+   buffer[0] = '\0';
+   while((seq = blReadFASTAExtBuffer(fp, header, MAXFASTABUFF,
+                                     buffer, MAXFASTABUFF)) != NULL)
+   {
+      header[MAXFASTABUFF-1] = '\0';
+      if(sscanf((header[0] == '>') ? header+1 : header, "%s", id) != 1)
+         id[0] = '\0';
+      ok = blAddSeqIndex(index, id, NULL, seq);
+      free(seq);
+      if(!ok)
+         return(-1);
+      nadded++;
+   }
+
+   return(nadded);
+}
+
+
+/************************************************************************/
+/*>SEQHIT *blSearchSeqIndex(SEQINDEX *index, MDMATRIX *mdm, char *query,
+                            REAL minIdentity, int *nhits)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in,out] *index       Index (rebuilt if sequences have been
+                               added)
+   \param[in]     *mdm         Scoring matrix (NULL for identity)
+   \param[in]     *query       Query sequence
+   \param[in]     minIdentity  Identity threshold (0-1)
+   \param[out]    *nhits       Number of hits (-1 on error)
+   \return                     Hits in decreasing order of identity
+
+   Finds the sequences with at least the given identity to a query,
+   aligning only those which pass the k-mer filter
+
+-  17.10.26 Original   By: ACRM
+*/
+SEQHIT *blSearchSeqIndex(SEQINDEX *index, MDMATRIX *mdm, char *query,
+                         REAL minIdentity, int *nhits)
+{
+   SEQINDEX    *qindex  = NULL;
+   SCWORKSPACE ws;
+   SEQHIT      *hits    = NULL,
+               **sorted = NULL;
+   char        *qseq;
+   int         qlen, qwords, s, i, need;
+   REAL        identity;
+   BOOL        ok       = TRUE;
+
+   *nhits = 0;
+   if(index->dirty && !BuildIndex(index))
+   {
+      *nhits = (-1);
+      return(NULL);
+   }
+   if((query[0] == '\0') || (index->nseqs == 0))
+      return(NULL);
+
+   /* Upcase the query and count its k-mers                             */
+   if(((qindex = blAllocSeqIndex(index->wordSize))==NULL) ||
+      !blAddSeqIndex(qindex, "", NULL, query))
+   {
+      blFreeSeqIndex(qindex);
+      *nhits = (-1);
+      return(NULL);
+   }
+   qseq   = qindex->seqs[0];
+   qlen   = qindex->lengths[0];
+   qwords = qindex->nwords[0];
+
+   if(!AllocWorkspace(&ws, index->nseqs, MAX(qlen, index->maxlen)))
+   {
+      blFreeSeqIndex(qindex);
+      *nhits = (-1);
+      return(NULL);
+   }
+
+   CountShared(index, &ws, qseq, qlen, NULL, 0, 0);
+   for(s=0; s<index->nseqs; s++)
+   {
+      SEQHIT *hit;
+
+      /* The filter uses the k-mers of the shorter sequence             */
+      if(index->lengths[s] < qlen)
+         need = WordsNeeded(index->wordSize, index->nwords[s],
+                            index->lengths[s], minIdentity);
+      else
+         need = WordsNeeded(index->wordSize, qwords, qlen, minIdentity);
+      if(ws.shared[s] < need)
+         continue;
+
+      identity = Identity(&ws, mdm, qseq, qlen, index->seqs[s],
+                          index->lengths[s]);
+      if(identity < minIdentity)
+         continue;
+      
+      if((hit = (SEQHIT *)malloc(sizeof(SEQHIT)))==NULL)
+      {
+         ok = FALSE;
+         goto Cleanup;
+      }
+      hit->next     = hits;
+      hit->id       = index->ids[s];
+      hit->chain    = index->chains[s];
+      hit->identity = identity;
+      hit->entry    = s;
+      hits          = hit;
+      (*nhits)++;
+   }
+
+   /* Sort the hits, best first                                         */
+   if(*nhits > 1)
+   {
+      SEQHIT *h;
+
+      if((sorted = (SEQHIT **)malloc(*nhits * sizeof(SEQHIT *)))==NULL)
+      {
+         ok = FALSE;
+         goto Cleanup;
+      }
+      for(h=hits, i=0; h!=NULL; NEXT(h))
+         sorted[i++] = h;
+      qsort(sorted, *nhits, sizeof(SEQHIT *), CompareHits);
+      for(i=0; i<*nhits-1; i++)
+         sorted[i]->next = sorted[i+1];
+      sorted[*nhits-1]->next = NULL;
+      hits = sorted[0];
+   }
+
+Cleanup:
+   FREE(sorted);
+   FreeWorkspace(&ws);
+   blFreeSeqIndex(qindex);
+   if(!ok)
+   {
+      blFreeSeqHits(hits);
+      hits   = NULL;
+      *nhits = (-1);
+   }
+   return(hits);
+}
+
+
+/************************************************************************/
+/*>void blFreeSeqHits(SEQHIT *hits)
+   --------------------------------
+*//**
+
+   \param[in]     *hits     Linked list of hits
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeSeqHits(SEQHIT *hits)
+{
+   if(hits != NULL)
+      FREELIST(hits, SEQHIT);
+}
+
+
+/************************************************************************/
+/*>SEQCLUSTERS *blClusterSeqIndex(SEQINDEX *index, MDMATRIX *mdm,
+                                  REAL minIdentity, int nthreads)
+   --------------------------------------------------------------
+*//**
+
+   \param[in,out] *index       Index (rebuilt if sequences have been
+                               added)
+   \param[in]     *mdm         Scoring matrix (NULL for identity)
+   \param[in]     minIdentity  Identity threshold (0-1)
+   \param[in]     nthreads     Number of threads to use
+   \return                     Clusters (NULL if no memory)
+
+   Greedy incremental clustering. Sequences are taken longest first
+   (in order of entry for equal lengths); each joins the cluster of the
+   first representative with at least minIdentity over its length or
+   becomes a new representative. Each representative is therefore the
+   longest sequence of its cluster.
+
+   If the library was compiled with PTHREAD_SUPPORT, up to nthreads
+   threads are used. The clusters do not depend on the number of
+   threads.
+
+-  17.10.26 Original   By: ACRM
+*/
+SEQCLUSTERS *blClusterSeqIndex(SEQINDEX *index, MDMATRIX *mdm,
+                               REAL minIdentity, int nthreads)
+{
+   SEQCLUSTERS *clusters = NULL;
+   SCBATCH     batch;
+   SCTHREAD    *threads  = NULL;
+   int         *count    = NULL,
+               nws       = 0,
+               i, j, s, r;
+   BOOL        ok        = TRUE;
+
+   if(index->dirty && !BuildIndex(index))
+      return(NULL);
+   if(nthreads < 1)
+      nthreads = 1;
+#ifndef PTHREAD_SUPPORT
+   nthreads = 1;
+#endif
+
+   batch.order         = NULL;
+   batch.repNum        = NULL;
+   batch.match         = NULL;
+   batch.matchIdentity = NULL;
+   batch.ws            = NULL;
+   
+   if((clusters = (SEQCLUSTERS *)malloc(sizeof(SEQCLUSTERS)))==NULL)
+      return(NULL);
+   clusters->nseqs     = index->nseqs;
+   clusters->nclusters = 0;
+   clusters->nalign    = 0;
+   clusters->cluster   = (int *)malloc((index->nseqs+1) * sizeof(int));
+   clusters->rep       = (int *)malloc((index->nseqs+1) * sizeof(int));
+   clusters->size      = (int *)calloc(index->nseqs+1, sizeof(int));
+   clusters->identity  = (REAL *)malloc((index->nseqs+1) * sizeof(REAL));
+
+   batch.order         = (int *)malloc((index->nseqs+1) * sizeof(int));
+   batch.repNum        = (int *)malloc((index->nseqs+1) * sizeof(int));
+   batch.match         = (int *)malloc(SEQCLUST_BATCH * sizeof(int));
+   batch.matchIdentity = (REAL *)malloc(SEQCLUST_BATCH * sizeof(REAL));
+   batch.ws            = (SCWORKSPACE *)malloc(nthreads * 
+                                               sizeof(SCWORKSPACE));
+   threads             = (SCTHREAD *)malloc(nthreads * sizeof(SCTHREAD));
+   count               = (int *)calloc(index->maxlen+2, sizeof(int));
+   if((clusters->cluster == NULL) || (clusters->rep == NULL) ||
+      (clusters->size == NULL)    || (clusters->identity == NULL) ||
+      (batch.order == NULL)       || (batch.repNum == NULL) ||
+      (batch.match == NULL)       || (batch.matchIdentity == NULL) ||
+      (batch.ws == NULL)          || (threads == NULL) ||
+      (count == NULL))
+   {
+      ok = FALSE;
+      goto Cleanup;
+   }
+   for(nws=0; nws<nthreads; nws++)
+   {
+      if(!AllocWorkspace(batch.ws+nws, index->nseqs, index->maxlen))
+      {
+         ok = FALSE;
+         goto Cleanup;
+      }
+      threads[nws].batch = &batch;
+      threads[nws].ws    = batch.ws+nws;
+   }
+
+   /* Counting sort by decreasing length, keeping the order of entry    */
+   for(s=0; s<index->nseqs; s++)
+      count[index->maxlen - index->lengths[s] + 1]++;
+   for(i=1; i<=index->maxlen+1; i++)
+      count[i] += count[i-1];
+   for(s=0; s<index->nseqs; s++)
+      batch.order[count[index->maxlen - index->lengths[s]]++] = s;
+   
+   for(s=0; s<index->nseqs; s++)
+      batch.repNum[s] = (-1);
+
+   batch.index       = index;
+   batch.clusters    = clusters;
+   batch.mdm         = mdm;
+   batch.minIdentity = minIdentity;
+
+   for(batch.batchStart=0;
+       batch.batchStart<index->nseqs;
+       batch.batchStart+=SEQCLUST_BATCH)
+   {
+      batch.batchEnd = MIN(batch.batchStart + SEQCLUST_BATCH,
+                           index->nseqs);
+      batch.nreps    = clusters->nclusters;
+
+      /* In parallel, against the representatives before the batch      */
+      if(batch.nreps > 0)
+      {
+         batch.next = batch.batchStart;
+         blRunThreadPool(CompareBatch, (void *)threads, sizeof(SCTHREAD),
+                         MIN(nthreads, batch.batchEnd-batch.batchStart));
+      }
+      else
+      {
+         for(i=0; i<batch.batchEnd-batch.batchStart; i++)
+            batch.match[i] = (-1);
+      }
+
+      /* In order, against those chosen in the batch                    */
+      for(i=batch.batchStart; i<batch.batchEnd; i++)
+      {
+         j = i - batch.batchStart;
+         s = batch.order[i];
+         if((r = batch.match[j]) < 0)
+            r = FindRep(&batch, batch.ws, s, batch.nreps,
+                        clusters->nclusters, &(batch.matchIdentity[j]));
+         if(r < 0)
+         {
+            r = clusters->nclusters++;
+            clusters->rep[r]       = s;
+            batch.repNum[s]        = r;
+            batch.matchIdentity[j] = (REAL)1.0;
+         }
+         clusters->cluster[s]  = r;
+         clusters->identity[s] = batch.matchIdentity[j];
+         clusters->size[r]++;
+      }
+   }
+
+Cleanup:
+   for(i=0; i<nws; i++)
+   {
+      clusters->nalign += batch.ws[i].nalign;
+      FreeWorkspace(batch.ws+i);
+   }
+   FREE(batch.ws);
+   FREE(threads);
+   FREE(batch.order);
+   FREE(batch.repNum);
+   FREE(batch.match);
+   FREE(batch.matchIdentity);
+   FREE(count);
+   if(!ok)
+   {
+      blFreeSeqClusters(clusters);
+      clusters = NULL;
+   }
+   return(clusters);
+}
+
+
+/************************************************************************/
+/*>void blFreeSeqClusters(SEQCLUSTERS *clusters)
+   ---------------------------------------------
+*//**
+
+   \param[in]     *clusters Clusters from blClusterSeqIndex()
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeSeqClusters(SEQCLUSTERS *clusters)
+{
+   if(clusters == NULL)
+      return;
+   FREE(clusters->cluster);
+   FREE(clusters->rep);
+   FREE(clusters->size);
+   FREE(clusters->identity);
+   free(clusters);
+}
+
+
+/************************************************************************/
+/*>BOOL blPrintSeqClusters(FILE *fp, SEQINDEX *index,
+                           SEQCLUSTERS *clusters)
+   --------------------------------------------------
+*//**
+
+   \param[in]     *fp       Output file
+   \param[in]     *index    Index that was clustered
+   \param[in]     *clusters Clusters from blClusterSeqIndex()
+   \return                  FALSE if no memory
+
+   Prints the clusters in the format of a CD-HIT .clstr file. The 
+   representative is listed first and marked with a '*'; the other
+   members follow in order of entry with their identity. A sequence
+   with a chain label is named id_chain.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blPrintSeqClusters(FILE *fp, SEQINDEX *index, SEQCLUSTERS *clusters)
+{
+   int *start,
+       *members,
+       c, i, n, s;
+
+   start   = (int *)malloc((clusters->nclusters+1) * sizeof(int));
+   members = (int *)malloc((clusters->nseqs+1) * sizeof(int));
+   if((start == NULL) || (members == NULL))
+   {
+      FREE(start);
+      FREE(members);
+      return(FALSE);
+   }
+
+   /* Representatives first, with room for the rest of each cluster    */
+   for(c=0, n=0; c<clusters->nclusters; c++)
+   {
+      members[n] = clusters->rep[c];
+      start[c]   = n + 1;
+      n         += clusters->size[c];
+   }
+   /* The others in order of entry. start[c] becomes the end of c      */
+   for(s=0; s<clusters->nseqs; s++)
+   {
+      c = clusters->cluster[s];
+      if(s != clusters->rep[c])
+         members[start[c]++] = s;
+   }
+
+   for(c=0, i=0; c<clusters->nclusters; c++)
+   {
+      fprintf(fp, ">Cluster %d\n", c);
+      for(n=0; i<start[c]; i++, n++)
+      {
+         s = members[i];
+         fprintf(fp, "%d\t%daa, >%s%s%s... ", n, index->lengths[s],
+                 index->ids[s], (index->chains[s][0] ? "_" : ""),
+                 index->chains[s]);
+         if(n == 0)
+            fprintf(fp, "*\n");
+         else
+            fprintf(fp, "at %.2f%%\n", 100.0 * clusters->identity[s]);
+      }
+   }
+
+   free(start);
+   free(members);
+   return(TRUE);
+}
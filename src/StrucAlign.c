@@ -0,0 +1,1125 @@
+/************************************************************************/
+/**
+
+   \file       StrucAlign.c
+
+   \version    V1.1
+   \date       17.10.26
+   \brief      Sequence-independent structural alignment
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Aligns the C-alphas of two structures without reference to their
+   sequences, in the manner of TM-align (Zhang & Skolnick (2005)
+   Nucl.Acids Res. 33, 2302-2309).
+
+   Two seed alignments are tried. The first is the best gapless
+   alignment of the chains over all offsets that overlap by at least
+   half the shorter chain. The second aligns the secondary structures
+   from blCalcSecStrucPDB() by dynamic programming, scoring 1 for the
+   same state (helix, strand or other) and 0 otherwise.
+
+   Each seed is then refined. The aligned pairs are superimposed with
+   blMatfit() and refitted using only the pairs within d0 (at least
+   4.5A and at most 8A). The target is moved onto the query and each
+   pair of C-alphas is scored 1/(1+(d/d0)^2). A Needleman & Wunsch
+   alignment of these scores, with a penalty for opening a gap and no
+   end gap penalties, gives the next alignment. This repeats until the
+   alignment does not change. The result is the alignment with the best
+   TM-score, normalized by the query length with
+   d0 = 1.24 (L-15)^(1/3) - 1.8.
+
+   All the arrays used in an alignment are kept in a workspace which is
+   enlarged when needed, so aligning a query against a library of
+   structures allocates no memory once the largest has been seen. A
+   library may be searched in parallel. If the library is compiled with
+   PTHREAD_SUPPORT, a pool of threads, each with its own workspace,
+   takes structures in turn; otherwise the structures are aligned one
+   after another.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   SACHAIN     *query, *target;
+   SAWORKSPACE *ws;
+   SARESULT    result;
+
+   query  = blPrepareSAChain(pdb1);
+   target = blPrepareSAChain(pdb2);
+   ws     = blAllocSAWorkspace(query->length, target->length);
+   result.map = (int *)malloc(query->length * sizeof(int));
+   if(blStructureAlign(query, target, ws, &result))
+      blApplySAResultPDB(pdb2, &result);
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Uses blRunThreadPool()   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP Fitting PDB files
+
+   #FUNCTION  blPrepareSAChain()
+   Extracts the C-alphas and secondary structure of a structure for
+   alignment
+
+   #FUNCTION  blFreeSAChain()
+   Frees a chain prepared for alignment
+
+   #FUNCTION  blAllocSAWorkspace()
+   Allocates a workspace for structural alignments
+
+   #FUNCTION  blFreeSAWorkspace()
+   Frees a structural alignment workspace
+
+   #FUNCTION  blStructureAlign()
+   Aligns two structures without reference to their sequences
+
+   #FUNCTION  blStructureAlignLibrary()
+   Aligns a query structure against each of a library of structures
+
+   #FUNCTION  blApplySAResultPDB()
+   Moves a target PDB linked list onto the query of an alignment
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "pdb.h"
+#include "fit.h"
+#include "matrix.h"
+#include "secstr.h"
+#include "threadpool.h"
+#include "strucalign.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define MINFITPAIRS  3              /* Pairs needed for a superposition */
+#define MINTRIMCUT   ((REAL)4.5)    /* Limits on the cutoff for pairs   */
+#define MAXTRIMCUT   ((REAL)8.0)    /* used in the second fit           */
+
+/* Reduces the secondary structure to helix, strand or other           */
+#define SIMPLESS(c) ((SECSTR_ISHELIX(c)  || ((c)==SECSTR_3_10) ||        \
+                      ((c)==SECSTR_3_10_SMALL) || ((c)==SECSTR_PI) ||     \
+                      ((c)==SECSTR_PI_SMALL)) ? 'H' :                     \
+                     ((SECSTR_ISSTRAND(c) || ((c)==SECSTR_BRIDGE_FWD) ||  \
+                       ((c)==SECSTR_BRIDGE_BACKWD)) ? 'E' : '-'))
+
+/* A superposition                                                      */
+typedef struct
+{
+   REAL  rm[3][3],
+         tmscore,
+         rmsd;
+   VEC3F cgQuery,
+         cgTarget;
+}  SAFIT;
+
+/* A search of a library                                                */
+typedef struct
+{
+   SACHAIN  *query,
+            **library;
+   SARESULT *results;
+   int      nlib,
+            next,
+            nok;
+}  SALIBSCAN;
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static BOOL GrowWorkspace(SAWORKSPACE *ws, int n1, int n2);
+static BOOL FitPairs(SACHAIN *query, SACHAIN *target, int *map,
+                     int *pairs, int npairs, SAWORKSPACE *ws,
+                     SAFIT *fit);
+static int  ScorePairs(SACHAIN *query, SACHAIN *target, int *map,
+                       int *pairs, int npairs, REAL d0, REAL cut,
+                       int *keep, SAFIT *fit);
+static BOOL Superpose(SACHAIN *query, SACHAIN *target, int *map,
+                      REAL d0, SAWORKSPACE *ws, SAFIT *fit,
+                      int *naligned);
+static void FillDistanceScores(SACHAIN *query, SACHAIN *target,
+                               SAWORKSPACE *ws, REAL d0, SAFIT *fit);
+static void FillSSScores(SACHAIN *query, SACHAIN *target,
+                         SAWORKSPACE *ws);
+static void DPAlign(SAWORKSPACE *ws, int n1, int n2, REAL gap,
+                    int *map);
+static void GaplessSeed(SACHAIN *query, SACHAIN *target,
+                        SAWORKSPACE *ws, REAL d0);
+static void Refine(SACHAIN *query, SACHAIN *target, SAWORKSPACE *ws,
+                   REAL d0, SARESULT *result);
+static void *ScanLibrary(void *arg);
+
+
+/************************************************************************/
+/*>SACHAIN *blPrepareSAChain(PDB *pdb)
+   -----------------------------------
+*//**
+
+   \param[in,out] *pdb      PDB linked list
+   \return                  The prepared chain or NULL on error or if
+                            there are no C-alphas
+
+   Extracts the C-alphas of the ATOM records (the first for each
+   residue) and their secondary structure. blCalcSecStrucPDB() is
+   called, so the secstr field of the linked list is set. The chain
+   points into the linked list, which must not be freed while the
+   chain is in use.
+
+-  17.10.26 Original   By: ACRM
+*/
+SACHAIN *blPrepareSAChain(PDB *pdb)
+{
+   SACHAIN *chain;
+   PDB     *p,
+           *prev = NULL;
+   int     nca   = 0;
+
+   if((pdb == NULL) ||
+      (blCalcSecStrucPDB(pdb, NULL, FALSE) != SECSTR_ERR_NOERR))
+      return(NULL);
+
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      if(!strncmp(p->record_type, "ATOM  ", 6) &&
+         !strncmp(p->atnam, "CA  ", 4) &&
+         ((prev == NULL) || !RESIDMATCH(p, prev)))
+      {
+         nca++;
+         prev = p;
+      }
+   }
+   if(nca == 0)
+      return(NULL);
+
+   if((chain = (SACHAIN *)malloc(sizeof(SACHAIN)))==NULL)
+      return(NULL);
+   chain->ca    = (COOR *)malloc(nca * sizeof(COOR));
+   chain->atoms = (PDB **)malloc(nca * sizeof(PDB *));
+   chain->ss    = (char *)malloc(nca * sizeof(char));
+   if((chain->ca == NULL) || (chain->atoms == NULL) ||
+      (chain->ss == NULL))
+   {
+      blFreeSAChain(chain);
+      return(NULL);
+   }
+
+   chain->length = 0;
+   prev          = NULL;
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      if(!strncmp(p->record_type, "ATOM  ", 6) &&
+         !strncmp(p->atnam, "CA  ", 4) &&
+         ((prev == NULL) || !RESIDMATCH(p, prev)))
+      {
+         chain->ca[chain->length].x  = p->x;
+         chain->ca[chain->length].y  = p->y;
+         chain->ca[chain->length].z  = p->z;
+         chain->atoms[chain->length] = p;
+         chain->ss[chain->length]    = SIMPLESS(p->secstr);
+         chain->length++;
+         prev = p;
+      }
+   }
+
+   return(chain);
+}
+
+
+/************************************************************************/
+/*>void blFreeSAChain(SACHAIN *chain)
+   ----------------------------------
+*//**
+
+   \param[in]     *chain    Chain to free
+
+   Frees a chain prepared for alignment (but not the PDB linked list to
+   which it points)
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeSAChain(SACHAIN *chain)
+{
+   if(chain != NULL)
+   {
+      FREE(chain->ca);
+      FREE(chain->atoms);
+      FREE(chain->ss);
+      free(chain);
+   }
+}
+
+
+/************************************************************************/
+/*>SAWORKSPACE *blAllocSAWorkspace(int max1, int max2)
+   ---------------------------------------------------
+*//**
+
+   \param[in]     max1      Expected longest query (may be 0)
+   \param[in]     max2      Expected longest target (may be 0)
+   \return                  The workspace or NULL on error
+
+   Allocates a workspace for blStructureAlign(). It is enlarged when a
+   longer query or target is aligned.
+
+-  17.10.26 Original   By: ACRM
+*/
+SAWORKSPACE *blAllocSAWorkspace(int max1, int max2)
+{
+   SAWORKSPACE *ws;
+
+   if((ws = (SAWORKSPACE *)malloc(sizeof(SAWORKSPACE)))==NULL)
+      return(NULL);
+
+   ws->score   = NULL;
+   ws->val     = NULL;
+   ws->path    = NULL;
+   ws->moved   = NULL;
+   ws->fit1    = NULL;
+   ws->fit2    = NULL;
+   ws->map     = NULL;
+   ws->newMap  = NULL;
+   ws->bestMap = NULL;
+   ws->pairs   = NULL;
+   ws->keep    = NULL;
+   ws->max1    = 0;
+   ws->max2    = 0;
+
+   if(!GrowWorkspace(ws, max1, max2))
+   {
+      blFreeSAWorkspace(ws);
+      return(NULL);
+   }
+
+   return(ws);
+}
+
+
+/************************************************************************/
+/*>void blFreeSAWorkspace(SAWORKSPACE *ws)
+   ---------------------------------------
+*//**
+
+   \param[in]     *ws       Workspace to free
+
+   Frees a structural alignment workspace
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeSAWorkspace(SAWORKSPACE *ws)
+{
+   if(ws != NULL)
+   {
+      FREE(ws->score);
+      FREE(ws->val);
+      FREE(ws->path);
+      FREE(ws->moved);
+      FREE(ws->fit1);
+      FREE(ws->fit2);
+      FREE(ws->map);
+      FREE(ws->newMap);
+      FREE(ws->bestMap);
+      FREE(ws->pairs);
+      FREE(ws->keep);
+      free(ws);
+   }
+}
+
+
+/************************************************************************/
+/*>static BOOL GrowWorkspace(SAWORKSPACE *ws, int n1, int n2)
+   ----------------------------------------------------------
+*//**
+
+   \param[in,out] *ws       Workspace
+   \param[in]     n1        Query length
+   \param[in]     n2        Target length
+   \return                  Success
+
+   Makes sure the workspace is large enough for the chain lengths. The
+   arrays are only reallocated if either length is larger than before.
+   On failure the workspace is left empty.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL GrowWorkspace(SAWORKSPACE *ws, int n1, int n2)
+{
+   int cells;
+
+   if((n1 <= ws->max1) && (n2 <= ws->max2))
+      return(TRUE);
+
+   if(n1 < ws->max1)
+      n1 = ws->max1;
+   if(n2 < ws->max2)
+      n2 = ws->max2;
+   cells = (n1+1) * (n2+1);
+
+   FREE(ws->score);
+   FREE(ws->val);
+   FREE(ws->path);
+   FREE(ws->moved);
+   FREE(ws->fit1);
+   FREE(ws->fit2);
+   FREE(ws->map);
+   FREE(ws->newMap);
+   FREE(ws->bestMap);
+   FREE(ws->pairs);
+   FREE(ws->keep);
+
+   ws->score   = (REAL *)malloc(cells * sizeof(REAL));
+   ws->val     = (REAL *)malloc(cells * sizeof(REAL));
+   ws->path    = (char *)malloc(cells * sizeof(char));
+   ws->moved   = (COOR *)malloc((n2+1) * sizeof(COOR));
+   ws->fit1    = (COOR *)malloc((n1+1) * sizeof(COOR));
+   ws->fit2    = (COOR *)malloc((n1+1) * sizeof(COOR));
+   ws->map     = (int  *)malloc((n1+1) * sizeof(int));
+   ws->newMap  = (int  *)malloc((n1+1) * sizeof(int));
+   ws->bestMap = (int  *)malloc((n1+1) * sizeof(int));
+   ws->pairs   = (int  *)malloc((n1+1) * sizeof(int));
+   ws->keep    = (int  *)malloc((n1+1) * sizeof(int));
+
+   if((ws->score   == NULL) || (ws->val    == NULL) ||
+      (ws->path    == NULL) || (ws->moved  == NULL) ||
+      (ws->fit1    == NULL) || (ws->fit2   == NULL) ||
+      (ws->map     == NULL) || (ws->newMap == NULL) ||
+      (ws->bestMap == NULL) || (ws->pairs  == NULL) ||
+      (ws->keep    == NULL))
+   {
+      FREE(ws->score);
+      FREE(ws->val);
+      FREE(ws->path);
+      FREE(ws->moved);
+      FREE(ws->fit1);
+      FREE(ws->fit2);
+      FREE(ws->map);
+      FREE(ws->newMap);
+      FREE(ws->bestMap);
+      FREE(ws->pairs);
+      FREE(ws->keep);
+      ws->max1 = 0;
+      ws->max2 = 0;
+      return(FALSE);
+   }
+
+   ws->max1 = n1;
+   ws->max2 = n2;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static BOOL FitPairs(SACHAIN *query, SACHAIN *target, int *map,
+                        int *pairs, int npairs, SAWORKSPACE *ws,
+                        SAFIT *fit)
+   ---------------------------------------------------------------
+*//**
+
+   \param[in]     *query    Query chain
+   \param[in]     *target   Target chain
+   \param[in]     *map      Target residue for each query residue
+   \param[in]     *pairs    Query residues of the pairs to fit
+   \param[in]     npairs    Number of pairs
+   \param[in,out] *ws       Workspace
+   \param[out]    *fit      Rotation matrix and centres of geometry
+   \return                  Success
+
+   Superimposes the target C-alphas of the pairs onto the query
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL FitPairs(SACHAIN *query, SACHAIN *target, int *map,
+                     int *pairs, int npairs, SAWORKSPACE *ws,
+                     SAFIT *fit)
+{
+   int k;
+
+   fit->cgQuery.x  = fit->cgQuery.y  = fit->cgQuery.z  = (REAL)0.0;
+   fit->cgTarget.x = fit->cgTarget.y = fit->cgTarget.z = (REAL)0.0;
+   for(k=0; k<npairs; k++)
+   {
+      VEC3F *q = &(query->ca[pairs[k]]),
+            *t = &(target->ca[map[pairs[k]]]);
+
+      fit->cgQuery.x  += q->x;
+      fit->cgQuery.y  += q->y;
+      fit->cgQuery.z  += q->z;
+      fit->cgTarget.x += t->x;
+      fit->cgTarget.y += t->y;
+      fit->cgTarget.z += t->z;
+   }
+   fit->cgQuery.x  /= npairs;
+   fit->cgQuery.y  /= npairs;
+   fit->cgQuery.z  /= npairs;
+   fit->cgTarget.x /= npairs;
+   fit->cgTarget.y /= npairs;
+   fit->cgTarget.z /= npairs;
+
+   for(k=0; k<npairs; k++)
+   {
+      VEC3F *q = &(query->ca[pairs[k]]),
+            *t = &(target->ca[map[pairs[k]]]);
+
+      ws->fit1[k].x = q->x - fit->cgQuery.x;
+      ws->fit1[k].y = q->y - fit->cgQuery.y;
+      ws->fit1[k].z = q->z - fit->cgQuery.z;
+      ws->fit2[k].x = t->x - fit->cgTarget.x;
+      ws->fit2[k].y = t->y - fit->cgTarget.y;
+      ws->fit2[k].z = t->z - fit->cgTarget.z;
+   }
+
+   return(blMatfit(ws->fit1, ws->fit2, fit->rm, npairs, NULL, FALSE));
+}
+
+
+/************************************************************************/
+/*>static int ScorePairs(SACHAIN *query, SACHAIN *target, int *map,
+                         int *pairs, int npairs, REAL d0, REAL cut,
+                         int *keep, SAFIT *fit)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in]     *query    Query chain
+   \param[in]     *target   Target chain
+   \param[in]     *map      Target residue for each query residue
+   \param[in]     *pairs    Query residues of the aligned pairs
+   \param[in]     npairs    Number of pairs
+   \param[in]     d0        TM-score distance scale
+   \param[in]     cut       Distance cutoff for keep[]
+   \param[out]    *keep     Query residues of the pairs within cut
+   \param[in,out] *fit      Superposition. Its TM-score and RMSD are
+                            filled in
+   \return                  Number of pairs in keep[]
+
+   Scores the aligned pairs after superposition
+
+-  17.10.26 Original   By: ACRM
+*/
+static int ScorePairs(SACHAIN *query, SACHAIN *target, int *map,
+                      int *pairs, int npairs, REAL d0, REAL cut,
+                      int *keep, SAFIT *fit)
+{
+   VEC3F in, out;
+   REAL  d2,
+         sumTM  = (REAL)0.0,
+         sumSq  = (REAL)0.0;
+   int   k,
+         nkeep  = 0;
+
+   for(k=0; k<npairs; k++)
+   {
+      VEC3F *q = &(query->ca[pairs[k]]),
+            *t = &(target->ca[map[pairs[k]]]);
+
+      in.x = t->x - fit->cgTarget.x;
+      in.y = t->y - fit->cgTarget.y;
+      in.z = t->z - fit->cgTarget.z;
+      blMatMult3_33(in, fit->rm, &out);
+      out.x += fit->cgQuery.x;
+      out.y += fit->cgQuery.y;
+      out.z += fit->cgQuery.z;
+      d2 = DISTSQ(&out, q);
+
+      sumTM += (REAL)1.0 / ((REAL)1.0 + d2/(d0*d0));
+      sumSq += d2;
+      if(d2 < cut*cut)
+         keep[nkeep++] = pairs[k];
+   }
+
+   fit->tmscore = sumTM / query->length;
+   fit->rmsd    = (REAL)sqrt(sumSq / npairs);
+   return(nkeep);
+}
+
+
+/************************************************************************/
+/*>static BOOL Superpose(SACHAIN *query, SACHAIN *target, int *map,
+                         REAL d0, SAWORKSPACE *ws, SAFIT *fit,
+                         int *naligned)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in]     *query    Query chain
+   \param[in]     *target   Target chain
+   \param[in]     *map      Target residue for each query residue
+   \param[in]     d0        TM-score distance scale
+   \param[in,out] *ws       Workspace
+   \param[out]    *fit      The better of the superpositions
+   \param[out]    *naligned Number of aligned pairs
+   \return                  FALSE if there were too few pairs to fit
+
+   Superimposes the aligned pairs, then refits those which are within
+   d0 (limited to MINTRIMCUT..MAXTRIMCUT) of each other. The fit giving
+   the higher TM-score over all the aligned pairs is kept.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL Superpose(SACHAIN *query, SACHAIN *target, int *map,
+                      REAL d0, SAWORKSPACE *ws, SAFIT *fit,
+                      int *naligned)
+{
+   SAFIT trimmed;
+   REAL  cut;
+   int   i, nkeep,
+         npairs = 0;
+
+   for(i=0; i<query->length; i++)
+   {
+      if(map[i] >= 0)
+         ws->pairs[npairs++] = i;
+   }
+   *naligned = npairs;
+   if(npairs < MINFITPAIRS)
+      return(FALSE);
+
+   cut = d0;
+   if(cut < MINTRIMCUT)
+      cut = MINTRIMCUT;
+   if(cut > MAXTRIMCUT)
+      cut = MAXTRIMCUT;
+
+   if(!FitPairs(query, target, map, ws->pairs, npairs, ws, fit))
+      return(FALSE);
+   nkeep = ScorePairs(query, target, map, ws->pairs, npairs, d0, cut,
+                      ws->keep, fit);
+
+   if((nkeep >= MINFITPAIRS) && (nkeep < npairs) &&
+      FitPairs(query, target, map, ws->keep, nkeep, ws, &trimmed))
+   {
+      ScorePairs(query, target, map, ws->pairs, npairs, d0, cut,
+                 ws->keep, &trimmed);
+      if(trimmed.tmscore > fit->tmscore)
+         *fit = trimmed;
+   }
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static void FillDistanceScores(SACHAIN *query, SACHAIN *target,
+                                  SAWORKSPACE *ws, REAL d0, SAFIT *fit)
+   --------------------------------------------------------------------
+*//**
+
+   \param[in]     *query    Query chain
+   \param[in]     *target   Target chain
+   \param[in,out] *ws       Workspace
+   \param[in]     d0        TM-score distance scale
+   \param[in]     *fit      Superposition
+
+   Moves the target onto the query and fills the score matrix with the
+   TM-score term for each pair of C-alphas
+
+-  17.10.26 Original   By: ACRM
+*/
+static void FillDistanceScores(SACHAIN *query, SACHAIN *target,
+                               SAWORKSPACE *ws, REAL d0, SAFIT *fit)
+{
+   VEC3F in;
+   REAL  *score,
+         d02 = d0 * d0;
+   int   i, j;
+
+   for(j=0; j<target->length; j++)
+   {
+      in.x = target->ca[j].x - fit->cgTarget.x;
+      in.y = target->ca[j].y - fit->cgTarget.y;
+      in.z = target->ca[j].z - fit->cgTarget.z;
+      blMatMult3_33(in, fit->rm, &(ws->moved[j]));
+      ws->moved[j].x += fit->cgQuery.x;
+      ws->moved[j].y += fit->cgQuery.y;
+      ws->moved[j].z += fit->cgQuery.z;
+   }
+
+   score = ws->score;
+   for(i=0; i<query->length; i++)
+   {
+      for(j=0; j<target->length; j++)
+      {
+         *(score++) = (REAL)1.0 /
+            ((REAL)1.0 + DISTSQ(&(query->ca[i]), &(ws->moved[j]))/d02);
+      }
+   }
+}
+
+
+/************************************************************************/
+/*>static void FillSSScores(SACHAIN *query, SACHAIN *target,
+                            SAWORKSPACE *ws)
+   -----------------------------------------------------------
+*//**
+
+   \param[in]     *query    Query chain
+   \param[in]     *target   Target chain
+   \param[in,out] *ws       Workspace
+
+   Fills the score matrix with 1 for residues in the same secondary
+   structure state and 0 otherwise
+
+-  17.10.26 Original   By: ACRM
+*/
+static void FillSSScores(SACHAIN *query, SACHAIN *target,
+                         SAWORKSPACE *ws)
+{
+   REAL *score = ws->score;
+   int  i, j;
+
+   for(i=0; i<query->length; i++)
+   {
+      for(j=0; j<target->length; j++)
+      {
+         *(score++) = (query->ss[i] == target->ss[j]) ?
+            (REAL)1.0 : (REAL)0.0;
+      }
+   }
+}
+
+
+/************************************************************************/
+/*>static void DPAlign(SAWORKSPACE *ws, int n1, int n2, REAL gap,
+                       int *map)
+   --------------------------------------------------------------
+*//**
+
+   \param[in,out] *ws       Workspace containing the n1 x n2 scores
+   \param[in]     n1        Query length
+   \param[in]     n2        Target length
+   \param[in]     gap       Penalty for opening a gap (negative)
+   \param[out]    *map      Target residue for each query residue or -1
+
+   Needleman & Wunsch alignment of the score matrix. Opening a gap is
+   penalized but extending it and end gaps are free.
+
+-  17.10.26 Original   By: ACRM
+*/
+static void DPAlign(SAWORKSPACE *ws, int n1, int n2, REAL gap,
+                    int *map)
+{
+   REAL *val   = ws->val,
+        *score = ws->score,
+        diag, up, left;
+   char *path  = ws->path;
+   int  i, j,
+        w      = n2 + 1;
+
+   for(i=0; i<=n1; i++)
+   {
+      val[i*w]  = (REAL)0.0;
+      path[i*w] = FALSE;
+   }
+   for(j=0; j<=n2; j++)
+   {
+      val[j]  = (REAL)0.0;
+      path[j] = FALSE;
+   }
+
+   /* path[] is set where the best move is along the diagonal          */
+   for(i=1; i<=n1; i++)
+   {
+      for(j=1; j<=n2; j++)
+      {
+         diag = val[(i-1)*w + j-1] + score[(i-1)*n2 + j-1];
+         up   = val[(i-1)*w + j];
+         if(path[(i-1)*w + j])
+            up += gap;
+         left = val[i*w + j-1];
+         if(path[i*w + j-1])
+            left += gap;
+
+         if((diag >= up) && (diag >= left))
+         {
+            val[i*w + j]  = diag;
+            path[i*w + j] = TRUE;
+         }
+         else
+         {
+            val[i*w + j]  = (up >= left) ? up : left;
+            path[i*w + j] = FALSE;
+         }
+      }
+   }
+
+   /* Trace back                                                        */
+   for(i=0; i<n1; i++)
+      map[i] = (-1);
+   i = n1;
+   j = n2;
+   while((i > 0) && (j > 0))
+   {
+      if(path[i*w + j])
+      {
+         map[i-1] = j-1;
+         i--;
+         j--;
+      }
+      else
+      {
+         up   = val[(i-1)*w + j];
+         if(path[(i-1)*w + j])
+            up += gap;
+         left = val[i*w + j-1];
+         if(path[i*w + j-1])
+            left += gap;
+
+         if(left >= up)
+            j--;
+         else
+            i--;
+      }
+   }
+}
+
+
+/************************************************************************/
+/*>static void GaplessSeed(SACHAIN *query, SACHAIN *target,
+                           SAWORKSPACE *ws, REAL d0)
+   ----------------------------------------------------------
+*//**
+
+   \param[in]     *query    Query chain
+   \param[in]     *target   Target chain
+   \param[in,out] *ws       Workspace. The seed is left in ws->map
+   \param[in]     d0        TM-score distance scale
+
+   Finds the gapless alignment with the best TM-score, considering
+   every offset where the chains overlap by at least half the shorter
+   chain
+
+-  17.10.26 Original   By: ACRM
+*/
+static void GaplessSeed(SACHAIN *query, SACHAIN *target,
+                        SAWORKSPACE *ws, REAL d0)
+{
+   SAFIT fit;
+   REAL  bestTM     = (REAL)(-1.0);
+   int   n1         = query->length,
+         n2         = target->length,
+         minOverlap = MIN(n1, n2) / 2,
+         bestOffset = 0,
+         offset, i, naligned;
+
+   if(minOverlap < MINFITPAIRS)
+      minOverlap = MINFITPAIRS;
+
+   /* Query residue i is aligned with target residue i+offset          */
+   for(offset = minOverlap-n1; offset <= n2-minOverlap; offset++)
+   {
+      for(i=0; i<n1; i++)
+         ws->map[i] = ((i+offset >= 0) && (i+offset < n2)) ?
+            (i+offset) : (-1);
+
+      if(Superpose(query, target, ws->map, d0, ws, &fit, &naligned) &&
+         (fit.tmscore > bestTM))
+      {
+         bestTM     = fit.tmscore;
+         bestOffset = offset;
+      }
+   }
+
+   for(i=0; i<n1; i++)
+      ws->map[i] = ((i+bestOffset >= 0) && (i+bestOffset < n2)) ?
+         (i+bestOffset) : (-1);
+}
+
+
+/************************************************************************/
+/*>static void Refine(SACHAIN *query, SACHAIN *target, SAWORKSPACE *ws,
+                      REAL d0, SARESULT *result)
+   --------------------------------------------------------------------
+*//**
+
+   \param[in]     *query    Query chain
+   \param[in]     *target   Target chain
+   \param[in,out] *ws       Workspace. ws->map is the seed
+   \param[in]     d0        TM-score distance scale
+   \param[in,out] *result   Best alignment so far. Updated (with the
+                            alignment in ws->bestMap) if a better one
+                            is found
+
+   Alternates superposition and dynamic programming from a seed until
+   the alignment does not change
+
+-  17.10.26 Original   By: ACRM
+*/
+static void Refine(SACHAIN *query, SACHAIN *target, SAWORKSPACE *ws,
+                   REAL d0, SARESULT *result)
+{
+   SAFIT fit;
+   int   iter, i, naligned;
+   BOOL  changed;
+
+   for(iter=0; iter<SA_MAXITER; iter++)
+   {
+      if(!Superpose(query, target, ws->map, d0, ws, &fit, &naligned))
+         break;
+
+      if(fit.tmscore > result->tmscore)
+      {
+         result->tmscore  = fit.tmscore;
+         result->rmsd     = fit.rmsd;
+         result->cgQuery  = fit.cgQuery;
+         result->cgTarget = fit.cgTarget;
+         result->naligned = naligned;
+         for(i=0; i<3; i++)
+         {
+            result->rm[i][0] = fit.rm[i][0];
+            result->rm[i][1] = fit.rm[i][1];
+            result->rm[i][2] = fit.rm[i][2];
+         }
+         for(i=0; i<query->length; i++)
+            ws->bestMap[i] = ws->map[i];
+      }
+
+      FillDistanceScores(query, target, ws, d0, &fit);
+      DPAlign(ws, query->length, target->length, SA_GAPOPEN,
+              ws->newMap);
+
+      changed = FALSE;
+      for(i=0; i<query->length; i++)
+      {
+         if(ws->newMap[i] != ws->map[i])
+         {
+            changed    = TRUE;
+            ws->map[i] = ws->newMap[i];
+         }
+      }
+      if(!changed)
+         break;
+   }
+}
+
+
+/************************************************************************/
+/*>BOOL blStructureAlign(SACHAIN *query, SACHAIN *target,
+                         SAWORKSPACE *ws, SARESULT *result)
+   ------------------------------------------------------
+*//**
+
+   \param[in]     *query    Query chain
+   \param[in]     *target   Target chain
+   \param[in,out] *ws       Workspace (enlarged if needed)
+   \param[in,out] *result   The alignment. If result->map is not NULL,
+                            it must have query->length elements and is
+                            filled with the target residue aligned
+                            with each query residue (or -1)
+   \return                  FALSE if the workspace could not be
+                            enlarged
+
+   Aligns the C-alphas of the target to those of the query without
+   reference to the sequences. The TM-score is normalized by the query
+   length. If no superposition could be made (for example, with fewer
+   than 3 residues in either chain) the TM-score is 0.0 and nothing is
+   aligned.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blStructureAlign(SACHAIN *query, SACHAIN *target, SAWORKSPACE *ws,
+                      SARESULT *result)
+{
+   REAL d0;
+   int  i;
+
+   result->tmscore  = (REAL)0.0;
+   result->rmsd     = (REAL)0.0;
+   result->naligned = 0;
+   result->cgQuery.x  = result->cgQuery.y  = result->cgQuery.z  = 0.0;
+   result->cgTarget.x = result->cgTarget.y = result->cgTarget.z = 0.0;
+   for(i=0; i<3; i++)
+   {
+      result->rm[i][0] = result->rm[i][1] = result->rm[i][2] = 0.0;
+      result->rm[i][i] = (REAL)1.0;
+   }
+   if(result->map != NULL)
+   {
+      for(i=0; i<query->length; i++)
+         result->map[i] = (-1);
+   }
+
+   if(!GrowWorkspace(ws, query->length, target->length))
+      return(FALSE);
+   if((query->length < MINFITPAIRS) || (target->length < MINFITPAIRS))
+      return(TRUE);
+
+   /* TM-score distance scale for the query                            */
+   d0 = (query->length > 21) ?
+      (REAL)(1.24 * pow((double)(query->length - 15), 1.0/3.0) - 1.8) :
+      (REAL)0.5;
+   for(i=0; i<query->length; i++)
+      ws->bestMap[i] = (-1);
+
+   /* Refine the best gapless alignment                                */
+   GaplessSeed(query, target, ws, d0);
+   Refine(query, target, ws, d0, result);
+
+   /* Refine the alignment of the secondary structures                 */
+   FillSSScores(query, target, ws);
+   DPAlign(ws, query->length, target->length, SA_SSGAP, ws->map);
+   Refine(query, target, ws, d0, result);
+
+   if(result->map != NULL)
+   {
+      for(i=0; i<query->length; i++)
+         result->map[i] = ws->bestMap[i];
+   }
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static void *ScanLibrary(void *arg)
+   -----------------------------------
+*//**
+
+   \param[in,out] *arg      The SALIBSCAN
+   \return                  NULL
+
+   Takes structures from the library in turn until none are left,
+   aligning each with the query using a workspace of its own
+
+-  17.10.26 Original   By: ACRM
+*/
+static void *ScanLibrary(void *arg)
+{
+   SALIBSCAN   *scan = (SALIBSCAN *)arg;
+   SAWORKSPACE *ws;
+   int         i;
+
+   if((ws = blAllocSAWorkspace(scan->query->length, 0))==NULL)
+      return(NULL);
+
+   for(;;)
+   {
+      if((i = blThreadPoolIncrement(&(scan->next))) >= scan->nlib)
+         break;
+      if(scan->library[i] == NULL)
+         continue;
+
+      if(blStructureAlign(scan->query, scan->library[i], ws,
+                          &(scan->results[i])))
+         blThreadPoolIncrement(&(scan->nok));
+   }
+
+   blFreeSAWorkspace(ws);
+   return(NULL);
+}
+
+
+/************************************************************************/
+/*>int blStructureAlignLibrary(SACHAIN *query, SACHAIN **library,
+                               int nlib, SARESULT *results,
+                               int nthreads)
+   --------------------------------------------------------------
+*//**
+
+   \param[in]     *query    Query chain
+   \param[in]     **library Target chains (NULL entries are skipped)
+   \param[in]     nlib      Number of targets
+   \param[in,out] *results  Array of nlib results. As for
+                            blStructureAlign(), the map of each may be
+                            NULL or an array to be filled
+   \param[in]     nthreads  Number of threads to use
+   \return                  Number of targets aligned
+
+   Aligns the query against each target in a library (as
+   blStructureAlign()). If the library was compiled with
+   PTHREAD_SUPPORT, up to nthreads targets are aligned at once, each
+   thread having its own workspace.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blStructureAlignLibrary(SACHAIN *query, SACHAIN **library,
+                            int nlib, SARESULT *results, int nthreads)
+{
+   SALIBSCAN scan;
+
+   if((query == NULL) || (nlib <= 0))
+      return(0);
+
+   scan.query   = query;
+   scan.library = library;
+   scan.results = results;
+   scan.nlib    = nlib;
+   scan.next    = 0;
+   scan.nok     = 0;
+
+   blRunThreadPool(ScanLibrary, (void *)&scan, 0, MIN(nthreads, nlib));
+
+   return(scan.nok);
+}
+
+
+/************************************************************************/
+/*>void blApplySAResultPDB(PDB *pdb, SARESULT *result)
+   ---------------------------------------------------
+*//**
+
+   \param[in,out] *pdb      Target PDB linked list
+   \param[in]     *result   Alignment of the target to a query
+
+   Moves the target structure onto the query using the superposition
+   of an alignment
+
+-  17.10.26 Original   By: ACRM
+*/
+void blApplySAResultPDB(PDB *pdb, SARESULT *result)
+{
+   VEC3F tvect;
+
+   tvect.x = -result->cgTarget.x;
+   tvect.y = -result->cgTarget.y;
+   tvect.z = -result->cgTarget.z;
+   blTranslatePDB(pdb, tvect);
+   blApplyMatrixPDB(pdb, result->rm);
+   blTranslatePDB(pdb, result->cgQuery);
+}
@@ -0,0 +1,268 @@
+/************************************************************************/
+/**
+
+   \file       atomsel_suite.c
+   
+   \version    V1.2
+   \date       17.10.26
+   \brief      Test suite for compiled atom selections.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for compiled atom selections.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+-  V1.1  17.10.26 Added test_pattern_01 By: ACRM
+-  V1.2  17.10.26 Added test_delete_01 By: ACRM
+
+*************************************************************************/
+
+#include "atomsel_suite.h"
+
+/* Defines */
+#define TEST_PDB_FILE "./data/test-deca-ala-01.pdb"
+
+/* Globals */
+static PDB      *pdb_in = NULL;
+static ATOMMASK *mask   = NULL;
+
+/* Setup And Teardown */
+static void atomsel_setup(void)
+{
+   FILE *fp;
+   int natom = 0;
+   
+   fp = fopen(TEST_PDB_FILE,"r");
+   if(fp == NULL)
+   {
+      fprintf(stderr, "Failed to open test pdb file!\n");
+      return;
+   }
+   
+   pdb_in = blReadPDB(fp,&natom);
+   fclose(fp);
+   
+   if(pdb_in == NULL)
+   {
+      fprintf(stderr, "Failed to read test pdb file!\n");
+   }
+}
+
+static void atomsel_teardown(void)
+{
+   /* Free PDB and mask */
+   FREELIST(pdb_in,PDB);
+   blFreeAtomMask(mask);
+   mask = NULL;
+}
+
+/* Count atoms selected by an expression */
+static int count_selected(char *expression)
+{
+   blFreeAtomMask(mask);
+   mask = blSelectAtomsByExpression(pdb_in, expression);
+   if(mask == NULL)
+      return(-1);
+   return(blCountAtomMask(mask));
+}
+
+/* PDB Data Read Test */
+START_TEST(test_read_01)
+{
+   ck_assert_msg(pdb_in != NULL, "No data read from test file.");
+}
+END_TEST
+
+
+/* Core tests */
+START_TEST(test_name_01)
+{
+   ck_assert_int_eq(count_selected("name CA"), 10);
+   ck_assert(ATOMMASK_ISSET(mask, 1)  == TRUE);
+   ck_assert(ATOMMASK_ISSET(mask, 0)  == FALSE);
+   ck_assert(ATOMMASK_ISSET(mask, 31) == TRUE);
+}
+END_TEST
+
+START_TEST(test_name_02)
+{
+   ck_assert_int_eq(count_selected("chain B and name C*"), 12);
+   ck_assert_int_eq(count_selected("name n?"),             11);
+   ck_assert_int_eq(count_selected("name N,O"),            20);
+}
+END_TEST
+
+START_TEST(test_resid_01)
+{
+   ck_assert_int_eq(count_selected("resid A2-A4"),         15);
+   ck_assert_int_eq(count_selected("resid A2-A4,B1"),      20);
+   ck_assert_int_eq(count_selected("resnum 2-3 and name N"), 4);
+}
+END_TEST
+
+START_TEST(test_logic_01)
+{
+   ck_assert_int_eq(count_selected("not chain A"),         21);
+   ck_assert_int_eq(count_selected("!(chain A | chain B)"), 0);
+   ck_assert_int_eq(count_selected("all and not none"),    51);
+   ck_assert_int_eq(count_selected("hetatm or water"),      0);
+}
+END_TEST
+
+START_TEST(test_element_01)
+{
+   ck_assert_int_eq(count_selected("element N"),           11);
+   ck_assert_int_eq(count_selected("element c and atom"),  30);
+}
+END_TEST
+
+START_TEST(test_value_01)
+{
+   ck_assert_int_eq(count_selected("occ >= 1.0"),          51);
+   ck_assert_int_eq(count_selected("bval > 0"),             0);
+   ck_assert_int_eq(count_selected("bval != 1.5"),         51);
+}
+END_TEST
+
+START_TEST(test_within_01)
+{
+   ck_assert_int_eq(count_selected("within 0 of name NT"),  1);
+   ck_assert_int_eq(count_selected("within 1.6 of name NT"), 2);
+   ck_assert(ATOMMASK_ISSET(mask, 48) == TRUE);
+   ck_assert(ATOMMASK_ISSET(mask, 50) == TRUE);
+}
+END_TEST
+
+START_TEST(test_pattern_01)
+{
+   ATOMNAMEPATTERN pattern;
+   char            *specs[] = {"CA", "C*", "?G*", "O\\*", "N%", "C?",
+                               "<CA", ""};
+   char            *names[] = {"CA  ", "CB  ", " CA ", "CA ", "O5* ", 
+                               "OG1 ", "NZ  ", "C   ", "    ", "CA\0"};
+   int             i, j, k;
+
+   for(i=0; i<8; i++)
+   {
+      for(k=0; k<2; k++)
+      {
+         ck_assert(blCompileAtomNamePattern(specs[i], (BOOL)k, &pattern));
+         for(j=0; j<10; j++)
+         {
+            BOOL expected = k ? 
+               blAtomNameRawMatch(names[j], specs[i], NULL) :
+               blAtomNameMatch(names[j], specs[i], NULL);
+            ck_assert(blMatchAtomNamePattern(names[j], &pattern) == 
+                      expected);
+         }
+      }
+   }
+   ck_assert(!blCompileAtomNamePattern("ABCDEFGHI", FALSE, &pattern));
+
+   /* The first CB in the list */
+   blCompileAtomNamePattern("?B", FALSE, &pattern);
+   ck_assert(blFindAtomNamePattern(pdb_in, NULL, &pattern) == 
+             blFindAtomWildcardInRes(pdb_in, "CB  "));
+}
+END_TEST
+
+START_TEST(test_delete_01)
+{
+   int ndeleted = 0;
+
+   /* Delete the first residue and all CB atoms                         */
+   ck_assert_int_eq(count_selected("resid A1 or name CB"), 14);
+   pdb_in = blDeleteAtomMaskPDB(pdb_in, mask, &ndeleted);
+   ck_assert_int_eq(ndeleted, 14);
+   ck_assert_int_eq(count_selected("all"),         37);
+   ck_assert_int_eq(count_selected("name CB"),      0);
+   ck_assert_int_eq(pdb_in->resnum,                 2);
+}
+END_TEST
+
+/* Error tests */
+START_TEST(test_error_01)
+{
+   ck_assert(blCompileAtomSelection("")              == NULL);
+   ck_assert(blCompileAtomSelection("chain")         == NULL);
+   ck_assert(blCompileAtomSelection("name CA and")   == NULL);
+   ck_assert(blCompileAtomSelection("bval 5")        == NULL);
+   ck_assert(blCompileAtomSelection("(chain A")      == NULL);
+   ck_assert(blCompileAtomSelection("resid A1-B4")   == NULL);
+   ck_assert(blCompileAtomSelection("within 5 chain A") == NULL);
+   ck_assert(blCompileAtomSelection("colour red")    == NULL);
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *atomsel_suite(void)
+{
+   Suite *s        = suite_create("AtomSelection");
+   TCase *tc_read  = tcase_create("Read");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Check read from test file */
+   tcase_add_checked_fixture(tc_read, atomsel_setup, atomsel_teardown);
+   tcase_add_test(tc_read, test_read_01);
+   suite_add_tcase(s, tc_read);   
+   
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, atomsel_setup, atomsel_teardown);
+   tcase_add_test(tc_core, test_name_01);
+   tcase_add_test(tc_core, test_name_02);
+   tcase_add_test(tc_core, test_resid_01);
+   tcase_add_test(tc_core, test_logic_01);
+   tcase_add_test(tc_core, test_element_01);
+   tcase_add_test(tc_core, test_value_01);
+   tcase_add_test(tc_core, test_within_01);
+   tcase_add_test(tc_core, test_pattern_01);
+   tcase_add_test(tc_core, test_delete_01);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, atomsel_setup, atomsel_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
@@ -3,8 +3,8 @@
 
    \file       conect_suite.c
    
-   \version    V1.0
-   \date       28.04.15
+   \version    V1.2
+   \date       17.10.26
    \brief      Test suite for CONECT data for pdb and pdbml.
    
    \copyright  (c) UCL / Dr. Andrew C. R. Martin 1993-2015
@@ -48,6 +48,9 @@
    Revision History:
    =================
 -  V1.0  28.04.15 Original By: CTP
+-  V1.1  17.10.26 Added bond graph tests By: ACRM
+-  V1.2  17.10.26 Added a test of an atom with more than MAXCONECT
+                  bonds By: ACRM
 
 *************************************************************************/
 
@@ -412,6 +415,75 @@ START_TEST(test_read_write_pdbml)
 END_TEST
 
 
+START_TEST(test_bondgraph_pdb)
+{
+   BONDGRAPH *graph;
+   char      filename_in[] = "test_alanine_in.pdb";
+
+   /* read input file */
+   strcat(test_input_filename,filename_in);
+   fp = fopen(test_input_filename,"r");
+   wpdb = blReadWholePDB(fp);
+   fclose(fp);
+   ck_assert_msg(wpdb != NULL, "Failed to read PDB file.");
+
+   /* bond graph stored by the reader */
+   ck_assert_msg(wpdb->bonds != NULL,      "Bond graph not stored.");
+   ck_assert_msg(wpdb->bonds->nbonds == 4, "Wrong number of bonds.");
+
+   /* bond graph from the CONECT records */
+   graph = blBuildBondGraphWholePDB(wpdb);
+   ck_assert_msg(graph != NULL,         "Failed to build bond graph.");
+   ck_assert_msg(graph->natoms == 5,    "Wrong number of atoms.");
+   ck_assert_msg(graph->nbonds == 4,    "Wrong number of bonds.");
+   ck_assert_msg(BONDGRAPH_DEGREE(graph, 1) == 3, "Wrong CA degree.");
+   ck_assert_msg(blBondGraphIsBonded(graph, 0, 1), "N-CA not bonded.");
+   ck_assert_msg(!blBondGraphIsBonded(graph, 0, 2), "N-C bonded.");
+   ck_assert_msg(blBondGraphAtomIndex(graph, wpdb->pdb->next) == 1,
+                 "Wrong atom index.");
+   blFreeBondGraph(graph);
+
+   /* bond graph from the per-atom CONECT data */
+   graph = blBuildBondGraphConect(wpdb->pdb);
+   ck_assert_msg(graph != NULL,         "Failed to build bond graph.");
+   ck_assert_msg(graph->nbonds == 4,    "Wrong number of bonds.");
+   ck_assert_msg(blSetConectsFromBondGraph(graph) == 0, 
+                 "CONECTs not stored.");
+   ck_assert_msg(wpdb->pdb->next->nConect == 3, "Wrong CA CONECTs.");
+   blFreeBondGraph(graph);
+}
+END_TEST
+
+
+START_TEST(test_bondgraph_cluster)
+{
+   char filename_in[] = "test_cluster_in.pdb";
+   int  nbonded = 18;
+
+   /* read input file with a metal bonded to more than MAXCONECT atoms */
+   strcat(test_input_filename,filename_in);
+   fp = fopen(test_input_filename,"r");
+   wpdb = blReadWholePDB(fp);
+   fclose(fp);
+   ck_assert_msg(wpdb != NULL, "Failed to read PDB file.");
+
+   /* all the bonds are in the graph */
+   ck_assert_msg(wpdb->bonds != NULL,            "Bond graph not stored.");
+   ck_assert_msg(wpdb->bonds->natoms == nbonded+1, 
+                 "Wrong number of atoms.");
+   ck_assert_msg(wpdb->bonds->nbonds == nbonded, "Wrong number of bonds.");
+   ck_assert_msg(BONDGRAPH_DEGREE(wpdb->bonds, 0) == nbonded, 
+                 "Wrong metal degree.");
+   ck_assert_msg(blBondGraphIsBonded(wpdb->bonds, nbonded, 0),
+                 "Last bond missing.");
+
+   /* the per-atom CONECTs are capped */
+   ck_assert_msg(wpdb->pdb->nConect == MAXCONECT, "Wrong metal CONECTs.");
+   ck_assert_msg(wpdb->pdb->next->nConect == 1,   "Wrong water CONECTs.");
+}
+END_TEST
+
+
 /* Create Suite */
 Suite *conect_suite(void)
 {
@@ -430,6 +502,8 @@ Suite *conect_suite(void)
    tcase_add_test(tc_core, test_write_pdbml_02);
    tcase_add_test(tc_core, test_read_write_pdb);
    tcase_add_test(tc_core, test_read_write_pdbml);
+   tcase_add_test(tc_core, test_bondgraph_pdb);
+   tcase_add_test(tc_core, test_bondgraph_cluster);
    suite_add_tcase(s, tc_core);
 
    /* Add additional tests here */
@@ -3,8 +3,8 @@
 
    \file       conect_suite.h
    
-   \version    V1.0
-   \date       28.04.15
+   \version    V1.1
+   \date       17.10.26
    \brief      Include file for CONECT test suite.
    
    \copyright  (c) UCL / Dr. Andrew C. R. Martin 1993-2015
@@ -48,6 +48,7 @@
    Revision History:
    =================
 -  V1.0  28.04.15 Original By: CTP
+-  V1.1  17.10.26 Include bondgraph.h By: ACRM
 
 *************************************************************************/
 
@@ -67,6 +68,7 @@
 #include "../../macros.h"
 #include "../../general.h"
 #include "../../pdb.h"
+#include "../../bondgraph.h"
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <time.h>
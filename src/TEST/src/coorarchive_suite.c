@@ -0,0 +1,344 @@
+/************************************************************************/
+/**
+
+   \file       coorarchive_suite.c
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Test suite for coordinate archives.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for coordinate archives.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+
+#include "coorarchive_suite.h"
+
+/* Defines */
+#define TEST_PDB_FILE  "./data/test-deca-ala-01.pdb"
+#define NFRAMES        20
+#define TOLERANCE      0.00051
+
+/* Globals */
+static PDB  *pdb    = NULL;
+static FILE *fp     = NULL;
+static int  natoms  = 0;
+
+/* Setup And Teardown */
+static void coorarchive_setup(void)
+{
+   FILE *in;
+   
+   if((in = fopen(TEST_PDB_FILE,"r")) == NULL)
+   {
+      fprintf(stderr, "Failed to open test pdb file!\n");
+      return;
+   }
+   pdb = blReadPDB(in, &natoms);
+   fclose(in);
+   fp = tmpfile();
+}
+
+static void coorarchive_teardown(void)
+{
+   FREELIST(pdb, PDB);
+   if(fp != NULL)
+      fclose(fp);
+   fp     = NULL;
+   natoms = 0;
+}
+
+/* Moves each atom a little differently in each frame                  */
+static void MakeFrame(REAL *xyz, int frame, REAL shift)
+{
+   PDB *p;
+   int i = 0;
+   
+   for(p=pdb; p!=NULL; NEXT(p))
+   {
+      xyz[i]   = p->x + shift + 0.3 * sin((REAL)(i + frame));
+      xyz[i+1] = p->y - shift + 0.3 * cos((REAL)(i * frame));
+      xyz[i+2] = p->z + 0.01  * frame;
+      i += 3;
+   }
+}
+
+/* Core Tests */
+START_TEST(test_frames_01)
+{
+   COORARCHIVE *arc;
+   REAL        *xyz, *in;
+   int         frame, i;
+   BOOL        ok = TRUE;
+   
+   ck_assert(pdb != NULL);
+   ck_assert(fp  != NULL);
+   xyz = (REAL *)malloc(3 * natoms * sizeof(REAL));
+   in  = (REAL *)malloc(3 * natoms * sizeof(REAL));
+   ck_assert((xyz != NULL) && (in != NULL));
+
+   ck_assert((arc = blCreateCoorArchive(fp, natoms, 0.0)) != NULL);
+   ck_assert_int_eq(arc->scale, 1000);
+   for(frame=0; frame<NFRAMES; frame++)
+   {
+      MakeFrame(xyz, frame, 0.0);
+      ck_assert(blWriteCoorArchiveFrame(arc, xyz));
+   }
+   /* Small moves are stored as differences from the first frame       */
+   ck_assert_int_eq(arc->keyFrame[NFRAMES-1], 0);
+   ck_assert(blCloseCoorArchive(arc));
+
+   /* Read back in reverse                                             */
+   ck_assert((arc = blOpenCoorArchive(fp)) != NULL);
+   ck_assert_int_eq(arc->natoms, natoms);
+   ck_assert_int_eq(arc->nframes, NFRAMES);
+   for(frame=NFRAMES-1; frame>=0; frame--)
+   {
+      MakeFrame(xyz, frame, 0.0);
+      ck_assert(blReadCoorArchiveFrame(arc, frame, in));
+      for(i=0; i<3*natoms; i++)
+      {
+         if(fabs(in[i] - xyz[i]) > TOLERANCE)
+            ok = FALSE;
+      }
+   }
+   ck_assert(ok);
+   blCloseCoorArchive(arc);
+   free(xyz);
+   free(in);
+}
+END_TEST
+
+START_TEST(test_frames_02)
+{
+   COORARCHIVE *arc;
+   REAL        *xyz, *in;
+   int         frame, i;
+   BOOL        ok = TRUE;
+   
+   ck_assert(pdb != NULL);
+   xyz = (REAL *)malloc(3 * natoms * sizeof(REAL));
+   in  = (REAL *)malloc(3 * natoms * sizeof(REAL));
+   ck_assert((xyz != NULL) && (in != NULL));
+
+   /* Large moves make new key frames                                  */
+   ck_assert((arc = blCreateCoorArchive(fp, natoms, 0.1)) != NULL);
+   ck_assert_int_eq(arc->scale, 10);
+   for(frame=0; frame<4; frame++)
+   {
+      MakeFrame(xyz, frame, 1000.0 * frame);
+      ck_assert(blWriteCoorArchiveFrame(arc, xyz));
+   }
+   for(frame=0; frame<4; frame++)
+      ck_assert_int_eq(arc->keyFrame[frame], frame);
+   ck_assert(blCloseCoorArchive(arc));
+
+   ck_assert((arc = blOpenCoorArchive(fp)) != NULL);
+   for(frame=0; frame<4; frame++)
+   {
+      MakeFrame(xyz, frame, 1000.0 * frame);
+      ck_assert(blReadCoorArchiveFrame(arc, frame, in));
+      for(i=0; i<3*natoms; i++)
+      {
+         if(fabs(in[i] - xyz[i]) > 0.051)
+            ok = FALSE;
+      }
+   }
+   ck_assert(ok);
+   blCloseCoorArchive(arc);
+   free(xyz);
+   free(in);
+}
+END_TEST
+
+START_TEST(test_pdb_01)
+{
+   COORARCHIVE *arc;
+   PDB         *models, *third, *copy, *p, *q;
+   VEC3F       tvect;
+   int         frame;
+   BOOL        ok = TRUE;
+   
+   ck_assert(pdb != NULL);
+
+   /* Three models, the last moved                                     */
+   models = blDupePDB(pdb);
+   p      = blDupePDB(pdb);
+   third  = blDupePDB(pdb);
+   ck_assert((models != NULL) && (p != NULL) && (third != NULL));
+   tvect.x = 1.5; tvect.y = -2.0; tvect.z = 0.25;
+   blTranslatePDB(third, tvect);
+   blAppendPDB(models, p);
+   blAppendPDB(models, third);
+
+   ck_assert((arc = blCreateCoorArchive(fp, natoms, 0.0)) != NULL);
+   ck_assert_int_eq(blWriteCoorArchiveModelsPDB(arc, models), 3);
+   ck_assert(blWriteCoorArchiveFramePDB(arc, pdb));
+   ck_assert(blCloseCoorArchive(arc));
+
+   /* Each frame into a copy of the first model                        */
+   ck_assert((copy = blDupePDB(pdb)) != NULL);
+   ck_assert((arc = blOpenCoorArchive(fp)) != NULL);
+   ck_assert_int_eq(arc->nframes, 4);
+   for(frame=3; frame>=0; frame--)
+   {
+      ck_assert(blReadCoorArchiveFramePDB(arc, frame, copy));
+      for(p=copy, q=((frame==2) ? third : pdb); p!=NULL; NEXT(p), NEXT(q))
+      {
+         if((fabs(p->x - q->x) > TOLERANCE) ||
+            (fabs(p->y - q->y) > TOLERANCE) ||
+            (fabs(p->z - q->z) > TOLERANCE) ||
+            strcmp(p->atnam, q->atnam) || (p->resnum != q->resnum))
+            ok = FALSE;
+      }
+   }
+   ck_assert(ok);
+   blCloseCoorArchive(arc);
+   FREELIST(copy, PDB);
+   FREELIST(models, PDB);
+}
+END_TEST
+
+START_TEST(test_size_01)
+{
+   COORARCHIVE *arc;
+   REAL        *xyz;
+   int         frame;
+   
+   ck_assert(pdb != NULL);
+   xyz = (REAL *)malloc(3 * natoms * sizeof(REAL));
+   ck_assert(xyz != NULL);
+
+   /* A PDB file takes 81 bytes per atom. The archive should take less
+      than 6 bytes per atom
+   */
+   ck_assert((arc = blCreateCoorArchive(fp, natoms, 0.0)) != NULL);
+   for(frame=0; frame<NFRAMES; frame++)
+   {
+      MakeFrame(xyz, frame, 0.0);
+      ck_assert(blWriteCoorArchiveFrame(arc, xyz));
+   }
+   ck_assert(blCloseCoorArchive(arc));
+   fseek(fp, 0L, SEEK_END);
+   ck_assert(ftell(fp) < 6 * natoms * NFRAMES);
+   free(xyz);
+}
+END_TEST
+
+
+/* Error Tests */
+START_TEST(test_error_01)
+{
+   COORARCHIVE *arc;
+   PDB         *p;
+   REAL        xyz[3];
+   int         i;
+   
+   ck_assert(pdb != NULL);
+   ck_assert(blCreateCoorArchive(fp, 0, 0.0) == NULL);
+   ck_assert(blCreateCoorArchive(NULL, natoms, 0.0) == NULL);
+   ck_assert(blOpenCoorArchive(NULL) == NULL);
+
+   /* Not an archive                                                   */
+   for(i=0; i<10; i++)
+      fprintf(fp, "ATOM      1  N   ALA     1       0.000   0.000   0.000\n");
+   ck_assert(blOpenCoorArchive(fp) == NULL);
+   rewind(fp);
+
+   /* Short lists and out of range coordinates                         */
+   ck_assert((arc = blCreateCoorArchive(fp, natoms+1, 0.0)) != NULL);
+   ck_assert(!blWriteCoorArchiveFramePDB(arc, pdb));
+   ck_assert(!blReadCoorArchiveFrame(arc, 0, xyz));
+   blCloseCoorArchive(arc);
+
+   rewind(fp);
+   ck_assert((arc = blCreateCoorArchive(fp, 1, 0.0)) != NULL);
+   xyz[0] = xyz[1] = 0.0;
+   xyz[2] = 1.0e7;
+   ck_assert(!blWriteCoorArchiveFrame(arc, xyz));
+   ck_assert_int_eq(blWriteCoorArchiveModelsPDB(arc, pdb), natoms);
+   ck_assert(blCloseCoorArchive(arc));
+
+   /* Missing frames and short lists                                   */
+   ck_assert((arc = blOpenCoorArchive(fp)) != NULL);
+   ck_assert_int_eq(arc->nframes, natoms);
+   ck_assert(!blReadCoorArchiveFrame(arc, -1, xyz));
+   ck_assert(!blReadCoorArchiveFrame(arc, natoms, xyz));
+   ck_assert(!blReadCoorArchiveFramePDB(arc, 0, NULL));
+   ck_assert(!blWriteCoorArchiveFrame(arc, xyz));
+   for(p=pdb, i=0; p!=NULL; NEXT(p), i++)
+   {
+      ck_assert(blReadCoorArchiveFrame(arc, i, xyz));
+      ck_assert(fabs(xyz[0] - p->x) < TOLERANCE);
+   }
+   blCloseCoorArchive(arc);
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *coorarchive_suite(void)
+{
+   Suite *s        = suite_create("CoorArchive");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, coorarchive_setup, 
+                             coorarchive_teardown);
+   tcase_add_test(tc_core, test_frames_01);
+   tcase_add_test(tc_core, test_frames_02);
+   tcase_add_test(tc_core, test_pdb_01);
+   tcase_add_test(tc_core, test_size_01);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, coorarchive_setup, 
+                             coorarchive_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
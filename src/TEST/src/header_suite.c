@@ -3,8 +3,8 @@
 
    \file       header_suite.c
    
-   \version    V1.0
-   \date       05.05.15
+   \version    V1.1
+   \date       17.10.26
    \brief      Test suite for header data for pdbml.
    
    \copyright  (c) UCL / Dr. Andrew C. R. Martin 1993-2015
@@ -36,7 +36,8 @@
    Description:
    ============
 
-   Test suite for reading and writing header data for pdbml files.
+   Test suite for reading and writing header data for pdbml files and
+   for scanning header data with blScanPDBHeader().
 
 **************************************************************************
 
@@ -48,6 +49,7 @@
    Revision History:
    =================
 -  V1.0  05.05.15 Original By: CTP
+-  V1.1  17.10.26 Added tests of blScanPDBHeader()   By: ACRM
 
 *************************************************************************/
 
@@ -627,6 +629,222 @@ START_TEST(test_modres_01)
 END_TEST
 
 
+/* TEST blScanPDBHeader() */
+/* Compare the header information collected by blScanPDBHeader() with
+   that returned by the individual routines on the whole file
+*/
+static void scan_compare_header(char *filename_in, char **chains)
+{
+   PDBHEADERINFO *info     = NULL;
+   WHOLEPDB      *refwpdb  = NULL;
+   HASHTABLE     *seqhash  = NULL;
+   COMPND        compnd,
+                 refCompnd;
+   PDBSOURCE     source,
+                 refSource;
+   REAL          resolution,
+                 RFactor;
+   char          header[48],
+                 date[16],
+                 pdbcode[8],
+                 *refseq;
+   int           strucType,
+                 i;
+   BOOL          gotHeader,
+                 gotExptl,
+                 gotInfo,
+                 gotRef;
+   
+   /* read the header and the reference whole PDB                      */
+   strcat(test_input_filename,filename_in);
+   fp = fopen(test_input_filename,"r");
+   ck_assert_msg(fp != NULL, "Failed to open PDB file.");
+   info = blScanPDBHeader(fp);
+   rewind(fp);
+   refwpdb = blReadWholePDB(fp);
+   rewind(fp);
+   gotExptl = blGetResolPDB(fp, &resolution, &RFactor, &strucType);
+   fclose(fp);
+   ck_assert_msg(info != NULL,       "Failed to scan PDB header.");
+   ck_assert_msg(info->wpdb != NULL, "Header records not kept.");
+   ck_assert_msg(refwpdb != NULL,    "Failed to read PDB file.");
+
+   /* HEADER record                                                     */
+   gotHeader = blGetHeaderWholePDB(refwpdb, header, 48, date, 16,
+                                   pdbcode, 8);
+   ck_assert_msg(info->gotHeader == gotHeader, "HEADER flag differs.");
+   ck_assert_msg(!strcmp(info->header,  header),  "Header differs.");
+   ck_assert_msg(!strcmp(info->date,    date),    "Date differs.");
+   ck_assert_msg(!strcmp(info->pdbcode, pdbcode), "PDB code differs.");
+   
+   /* Experimental data                                                 */
+   ck_assert_msg(info->gotExptl == gotExptl, "Exptl flag differs.");
+   ck_assert_msg(info->strucType == strucType, 
+                 "Structure type differs.");
+   ck_assert_msg(ABS(info->resolution - resolution) < 0.0001,
+                 "Resolution differs.");
+   ck_assert_msg(ABS(info->RFactor - RFactor) < 0.0001,
+                 "R-factor differs.");
+
+   /* SEQRES data                                                       */
+   seqhash = blGetSeqresByChainWholePDB(refwpdb, NULL, FALSE);
+   if(info->nSeqresChains == 0)
+   {
+      ck_assert_msg(info->seqres == NULL, "Unexpected SEQRES data.");
+   }
+   for(i=0; chains[i]!=NULL; i++)
+   {
+      if(info->nSeqresChains != 0)
+      {
+         ck_assert_msg(i < info->nSeqresChains, 
+                       "Too few SEQRES chains.");
+         ck_assert_msg(seqhash != NULL, "No reference SEQRES data.");
+         refseq = blGetHashValueString(seqhash, chains[i]);
+         ck_assert_msg(refseq != NULL, "No reference SEQRES chain.");
+         ck_assert_msg(!strcmp(info->seqres[i], refseq),
+                       "SEQRES sequence differs.");
+      }
+
+      /* COMPND and SOURCE data by chain                                */
+      gotInfo = blGetCompoundWholePDBChain(info->wpdb, chains[i],
+                                           &compnd);
+      gotRef  = blGetCompoundWholePDBChain(refwpdb, chains[i],
+                                           &refCompnd);
+      ck_assert_msg(gotInfo == gotRef, "COMPND flag differs.");
+      if(gotRef)
+      {
+         ck_assert_msg(compnd.molid == refCompnd.molid, 
+                       "MOL_ID differs.");
+         ck_assert_msg(!strcmp(compnd.molecule, refCompnd.molecule),
+                       "MOLECULE differs.");
+         ck_assert_msg(!strcmp(compnd.chain, refCompnd.chain),
+                       "CHAIN differs.");
+         ck_assert_msg(!strcmp(compnd.fragment, refCompnd.fragment),
+                       "FRAGMENT differs.");
+         ck_assert_msg(!strcmp(compnd.synonym, refCompnd.synonym),
+                       "SYNONYM differs.");
+         ck_assert_msg(!strcmp(compnd.ec, refCompnd.ec),
+                       "EC differs.");
+         ck_assert_msg(!strcmp(compnd.engineered, refCompnd.engineered),
+                       "ENGINEERED differs.");
+         ck_assert_msg(!strcmp(compnd.mutation, refCompnd.mutation),
+                       "MUTATION differs.");
+         ck_assert_msg(!strcmp(compnd.other, refCompnd.other),
+                       "OTHER_DETAILS differs.");
+      }
+      
+      gotInfo = blGetSpeciesWholePDBChain(info->wpdb, chains[i],
+                                          &source);
+      gotRef  = blGetSpeciesWholePDBChain(refwpdb, chains[i],
+                                          &refSource);
+      ck_assert_msg(gotInfo == gotRef, "SOURCE flag differs.");
+      if(gotRef)
+      {
+         ck_assert_msg(!strcmp(source.scientificName, 
+                               refSource.scientificName),
+                       "ORGANISM_SCIENTIFIC differs.");
+         ck_assert_msg(!strcmp(source.commonName, refSource.commonName),
+                       "ORGANISM_COMMON differs.");
+         ck_assert_msg(!strcmp(source.strain, refSource.strain),
+                       "STRAIN differs.");
+         ck_assert_msg(source.taxid == refSource.taxid,
+                       "ORGANISM_TAXID differs.");
+      }
+   }
+   if(info->nSeqresChains != 0)
+   {
+      ck_assert_msg(i == info->nSeqresChains, "Too many SEQRES chains.");
+   }
+
+   if(seqhash != NULL) blFreeHash(seqhash);
+   blFreeWholePDB(refwpdb);
+   blFreePDBHeaderInfo(info);
+}
+
+/* Header with COMPND and SOURCE but no experimental data */
+START_TEST(test_scan_01)
+{
+   char *chains[] = {"A", NULL};
+   scan_compare_header("test_alanine_in_01.pdb", chains);
+}
+END_TEST
+
+/* Header with SEQRES records */
+START_TEST(test_scan_02)
+{
+   char *chains[] = {"A", "B", "C", NULL};
+   scan_compare_header("test_seqres_in_01.pdb", chains);
+}
+END_TEST
+
+/* Multi-line COMPND and SOURCE records for two molecules with
+   experimental data and SEQRES records
+*/
+START_TEST(test_scan_03)
+{
+   char *chains[] = {"A", "B", "C", NULL};
+   scan_compare_header("test_multiline_in_01.pdb", chains);
+}
+END_TEST
+
+/* Check the multi-line records are joined when read with 
+   blScanPDBHeader() 
+*/
+START_TEST(test_scan_04)
+{
+   PDBHEADERINFO *info = NULL;
+   COMPND        compnd;
+   PDBSOURCE     source;
+   
+   strcat(test_input_filename,"test_multiline_in_01.pdb");
+   fp = fopen(test_input_filename,"r");
+   ck_assert_msg(fp != NULL, "Failed to open PDB file.");
+   info = blScanPDBHeader(fp);
+   fclose(fp);
+   ck_assert_msg(info != NULL, "Failed to scan PDB header.");
+
+   ck_assert_msg(!strcmp(info->pdbcode, "9XYZ"), "Wrong PDB code.");
+   ck_assert_msg(info->nSeqresChains == 3, "Wrong SEQRES chain count.");
+   ck_assert_msg(!strcmp(info->seqres[2], "PSTWYV"), 
+                 "Wrong SEQRES sequence.");
+   ck_assert_msg(ABS(info->resolution - 1.80) < 0.0001,
+                 "Wrong resolution.");
+   ck_assert_msg(ABS(info->FreeR - 0.214) < 0.0001,
+                 "Wrong free R-factor.");
+   
+   ck_assert_msg(blGetCompoundWholePDBMolID(info->wpdb, 1, &compnd),
+                 "MOL_ID 1 not found in COMPND.");
+   ck_assert_msg(!strcmp(compnd.molecule,
+                         "SERINE PROTEASE ALPHA-LYTIC ENDOPEPTIDASE \
+PRECURSOR FRAGMENT, CATALYTIC DOMAIN"),
+                 "Multi-line MOLECULE not joined.");
+   ck_assert_msg(!strcmp(compnd.synonym,
+                         "ALPHA-LYTIC PROTEASE, ALP, SERINE \
+ENDOPEPTIDASE TYPE ONE"),
+                 "Multi-line SYNONYM not joined.");
+   ck_assert_msg(!strcmp(compnd.chain, "A, B"), "Wrong CHAIN.");
+   ck_assert_msg(blGetCompoundWholePDBMolID(info->wpdb, 2, &compnd),
+                 "MOL_ID 2 not found in COMPND.");
+   ck_assert_msg(!strcmp(compnd.molecule, "PROTEINASE INHIBITOR"),
+                 "Wrong MOLECULE for MOL_ID 2.");
+
+   ck_assert_msg(blGetSpeciesWholePDBMolID(info->wpdb, 1, &source),
+                 "MOL_ID 1 not found in SOURCE.");
+   ck_assert_msg(!strcmp(source.scientificName,
+                         "LYSOBACTER ENZYMOGENES SUBSP. ENZYMOGENES \
+ATCC 29487"),
+                 "Multi-line ORGANISM_SCIENTIFIC not joined.");
+   ck_assert_msg(source.taxid == 69, "Wrong ORGANISM_TAXID.");
+   ck_assert_msg(blGetSpeciesWholePDBChain(info->wpdb, "C", &source),
+                 "Chain C not found in SOURCE.");
+   ck_assert_msg(source.taxid == 9606, 
+                 "Wrong ORGANISM_TAXID for chain C.");
+
+   blFreePDBHeaderInfo(info);
+}
+END_TEST
+
+
 /* Create Suite */
 Suite *header_suite(void)
 {
@@ -635,6 +853,7 @@ Suite *header_suite(void)
    TCase *tc_title  = tcase_create("Title");
    TCase *tc_seqres = tcase_create("Seqres");
    TCase *tc_modres = tcase_create("Modres");
+   TCase *tc_scan   = tcase_create("Scan");
 
    /* Core test case */
    tcase_add_checked_fixture(tc_core, 
@@ -684,5 +903,16 @@ Suite *header_suite(void)
    tcase_add_test(tc_modres, test_modres_01);
    suite_add_tcase(s, tc_modres);
 
+   /* Header scan test case */
+   tcase_add_checked_fixture(tc_scan, 
+                             wholepdb_setup, 
+                             wholepdb_teardown);
+   /* blScanPDBHeader() tests */
+   tcase_add_test(tc_scan, test_scan_01);
+   tcase_add_test(tc_scan, test_scan_02);
+   tcase_add_test(tc_scan, test_scan_03);
+   tcase_add_test(tc_scan, test_scan_04);
+   suite_add_tcase(s, tc_scan);
+
    return s;
 }
@@ -3,8 +3,8 @@
 
    \file       header_suite.h
    
-   \version    V1.0
-   \date       05.05.15
+   \version    V1.1
+   \date       17.10.26
    \brief      Include file for CONECT test suite.
    
    \copyright  (c) UCL / Dr. Andrew C. R. Martin 1993-2015
@@ -48,6 +48,7 @@
    Revision History:
    =================
 -  V1.0  05.05.15 Original By: CTP
+-  V1.1  17.10.26 Added hash.h for blScanPDBHeader() tests   By: ACRM
 
 *************************************************************************/
 
@@ -67,6 +68,7 @@
 #include "../../macros.h"
 #include "../../general.h"
 #include "../../pdb.h"
+#include "../../hash.h"
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <time.h>
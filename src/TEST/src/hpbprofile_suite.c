@@ -0,0 +1,254 @@
+/************************************************************************/
+/**
+
+   \file       hpbprofile_suite.c
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Test suite for hydrophobicity profiles.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for hydrophobicity profiles.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+
+#include "hpbprofile_suite.h"
+
+/* Defines */
+#define TEST_KYTE        "../../data/kyte.hpb"
+#define TEST_EISENBERG   "../../data/consensus.hpb"
+#define TEST_FAUCHERE    "../../data/HPBScales/fauchere.dat"
+#define TEST_FASTA       "./data/hpbprofile_suite/test.fa"
+#define TEST_SEQ  "MKKDEELLLLIIVVAALLLIVAFLLKKDDEERRGSLKKLLKLLKKLLKLAGXXQWE"
+#define MAXSEQ    80
+
+/* Globals */
+static HPBSCALE *kyte      = NULL,
+                *eisenberg = NULL;
+
+/* Setup And Teardown */
+static void hpbprofile_setup(void)
+{
+   kyte      = blReadHPBScale(TEST_KYTE);
+   eisenberg = blReadHPBScale(TEST_EISENBERG);
+}
+
+static void hpbprofile_teardown(void)
+{
+   blFreeHPBScale(kyte);
+   blFreeHPBScale(eisenberg);
+   kyte = eisenberg = NULL;
+}
+
+
+/* Core Tests */
+START_TEST(test_read_01)
+{
+   HPBSCALE *fauchere;
+   
+   /* Three-letter .hpb file                                         */
+   ck_assert(kyte != NULL);
+   ck_assert(!strncmp(kyte->name, "Kyte & Doolittle", 16));
+   ck_assert(kyte->known['I'] && kyte->known['i']);
+   ck_assert(fabs(kyte->value['I'] - 4.5) < 0.0001);
+   ck_assert(fabs(kyte->value['r'] + 4.5) < 0.0001);
+   ck_assert(!kyte->known['B']);
+
+   /* One-letter file with reference and colour lines                */
+   fauchere = blReadHPBScale(TEST_FAUCHERE);
+   ck_assert(fauchere != NULL);
+   ck_assert(fauchere->known['A']);
+   ck_assert(fabs(fauchere->value['W'] - 2.25) < 0.0001);
+   ck_assert(fabs(fauchere->value['A'] - 0.31) < 0.0001);
+   blFreeHPBScale(fauchere);
+}
+END_TEST
+
+START_TEST(test_profile_01)
+{
+   REAL mean[MAXSEQ],
+        moment[MAXSEQ];
+   char *seq = TEST_SEQ;
+   int  nwin, i, j, aa, nknown;
+   
+   nwin = blHPBProfile(eisenberg, seq, 11, HPB_HELIXANGLE, 
+                       mean, moment);
+   ck_assert_int_eq(nwin, strlen(seq) - 10);
+
+   /* The running sums match a calculation of each window            */
+   for(i=0; i<nwin; i++)
+   {
+      double h = 0.0, c = 0.0, s = 0.0,
+             theta;
+      
+      for(j=0, nknown=0; j<11; j++)
+      {
+         aa = seq[i+j];
+         if(eisenberg->known[aa])
+         {
+            theta = j * HPB_HELIXANGLE * PI / 180.0;
+            h += eisenberg->value[aa];
+            c += eisenberg->value[aa] * cos(theta);
+            s += eisenberg->value[aa] * sin(theta);
+            nknown++;
+         }
+      }
+      ck_assert(fabs(mean[i] - h/nknown) < 0.0001);
+      ck_assert(fabs(moment[i] - sqrt(c*c + s*s)/nknown) < 0.0001);
+   }
+
+   ck_assert_int_eq(blHPBProfile(eisenberg, "LLKK", 11, HPB_HELIXANGLE,
+                                 mean, NULL), 0);
+}
+END_TEST
+
+START_TEST(test_segments_01)
+{
+   HPBSEGMENT *segs;
+   int        nsegs;
+   
+   /* Transmembrane helix                                            */
+   segs = blFindHPBSegments(kyte, TEST_SEQ, HPB_TMWINDOW, 
+                            HPB_HELIXANGLE, HPB_TMTHRESHOLD, 
+                            (REAL)0.0, &nsegs);
+   ck_assert_int_eq(nsegs, 1);
+   ck_assert_int_eq(segs->start, 0);
+   ck_assert_int_eq(segs->stop,  29);
+   ck_assert(segs->id == NULL);
+   blFreeHPBSegments(segs);
+
+   /* Amphipathic helix (LKKLLKLLKKLLKL)                             */
+   segs = blFindHPBSegments(eisenberg, TEST_SEQ, 11, HPB_HELIXANGLE,
+                            (REAL)(-10.0), (REAL)0.5, &nsegs);
+   ck_assert_int_eq(nsegs, 1);
+   ck_assert_int_eq(segs->start, 35);
+   ck_assert_int_eq(segs->stop,  47);
+   ck_assert(segs->maxMoment >= 0.5);
+   blFreeHPBSegments(segs);
+}
+END_TEST
+
+START_TEST(test_fasta_01)
+{
+   HPBSEGMENT *segs, *s;
+   FILE       *fp;
+   int        nseqs,
+              nthreads;
+   
+   for(nthreads=1; nthreads<=4; nthreads+=3)
+   {
+      ck_assert((fp = fopen(TEST_FASTA, "r")) != NULL);
+      segs = blFindHPBSegmentsFASTA(kyte, fp, HPB_TMWINDOW,
+                                    HPB_HELIXANGLE, HPB_TMTHRESHOLD,
+                                    (REAL)0.0, nthreads, &nseqs);
+      fclose(fp);
+      ck_assert_int_eq(nseqs, 3);
+
+      /* Segments are in sequence order whatever the threads         */
+      s = segs;
+      ck_assert(s != NULL);
+      ck_assert_int_eq(s->seqNum, 0);
+      ck_assert_str_eq(s->id, "seq1 single helix");
+      ck_assert_int_eq(s->stop, 29);
+      NEXT(s);
+      ck_assert(s != NULL);
+      ck_assert_int_eq(s->seqNum, 2);
+      ck_assert_int_eq(s->start, 0);
+      ck_assert_int_eq(s->stop,  24);
+      NEXT(s);
+      ck_assert(s != NULL);
+      ck_assert_int_eq(s->seqNum, 2);
+      ck_assert_int_eq(s->start, 26);
+      ck_assert_int_eq(s->stop,  47);
+      ck_assert(s->next == NULL);
+
+      blFreeHPBSegments(segs);
+   }
+}
+END_TEST
+
+
+/* Error Tests */
+START_TEST(test_error_01)
+{
+   int nsegs;
+   
+   ck_assert(blReadHPBScale("nonexistent.hpb") == NULL);
+   ck_assert(blFindHPBSegments(NULL, TEST_SEQ, HPB_TMWINDOW,
+                               HPB_HELIXANGLE, HPB_TMTHRESHOLD,
+                               (REAL)0.0, &nsegs) == NULL);
+   ck_assert_int_eq(nsegs, 0);
+   ck_assert(blFindHPBSegments(kyte, "", HPB_TMWINDOW,
+                               HPB_HELIXANGLE, HPB_TMTHRESHOLD,
+                               (REAL)0.0, &nsegs) == NULL);
+   ck_assert_int_eq(nsegs, 0);
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *hpbprofile_suite(void)
+{
+   Suite *s        = suite_create("HPBProfile");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, hpbprofile_setup, 
+                             hpbprofile_teardown);
+   tcase_add_test(tc_core, test_read_01);
+   tcase_add_test(tc_core, test_profile_01);
+   tcase_add_test(tc_core, test_segments_01);
+   tcase_add_test(tc_core, test_fasta_01);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, hpbprofile_setup, 
+                             hpbprofile_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
@@ -0,0 +1,235 @@
+/************************************************************************/
+/**
+
+   \file       instrument_suite.c
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Test suite for the instrumentation layer.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for the instrumentation layer.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+
+#include "instrument_suite.h"
+
+/* Defines */
+#define TEST_PDB_FILE    "./data/test-deca-ala-01.pdb"
+#define TEST_OUT_FILE    "./data/instrument_out.txt"
+#define MAXBUFF          160
+
+/* Setup And Teardown */
+static void instrument_setup(void)
+{
+   blResetInstrumentStats();
+}
+
+static void instrument_teardown(void)
+{
+   blResetInstrumentStats();
+}
+
+
+/* Core Tests */
+START_TEST(test_count_01)
+{
+   INSTRUMENTSTATS stats;
+
+   blInstrumentCount(BLCOUNT_PAIRS_TESTED, 10);
+   blInstrumentCount(BLCOUNT_PAIRS_TESTED, 5);
+   blInstrumentCount(BLCOUNT_DP_CELLS,     7);
+   
+   blGetInstrumentStats(&stats, TRUE);
+   ck_assert(stats.counts[BLCOUNT_PAIRS_TESTED] == 15);
+   ck_assert(stats.counts[BLCOUNT_DP_CELLS]     == 7);
+   ck_assert(stats.counts[BLCOUNT_ALIGNMENTS]   == 0);
+   ck_assert(stats.nthreads == 1);
+
+   blGetInstrumentStats(&stats, FALSE);
+   ck_assert(stats.counts[BLCOUNT_PAIRS_TESTED] == 15);
+}
+END_TEST
+
+START_TEST(test_timer_01)
+{
+   INSTRUMENTSTATS stats;
+
+   /* Nested calls of the same timer count as one call               */
+   blInstrumentTimerStart(BLTIMER_ALIGN);
+   blInstrumentTimerStart(BLTIMER_ALIGN);
+   blInstrumentTimerStop(BLTIMER_ALIGN);
+   blInstrumentTimerStop(BLTIMER_ALIGN);
+
+   blInstrumentTimerStart(BLTIMER_ACCESS);
+   blInstrumentTimerStop(BLTIMER_ACCESS);
+
+   blGetInstrumentStats(&stats, TRUE);
+   ck_assert(stats.calls[BLTIMER_ALIGN]  == 1);
+   ck_assert(stats.calls[BLTIMER_ACCESS] == 1);
+   ck_assert(stats.calls[BLTIMER_SECSTR] == 0);
+   ck_assert(stats.seconds[BLTIMER_ALIGN] >= 0.0);
+}
+END_TEST
+
+START_TEST(test_reset_01)
+{
+   INSTRUMENTSTATS stats;
+   int             i;
+
+   blInstrumentCount(BLCOUNT_ALIGNMENTS, 3);
+   blInstrumentTimerStart(BLTIMER_CONECT);
+   blInstrumentTimerStop(BLTIMER_CONECT);
+   blResetInstrumentStats();
+
+   blGetInstrumentStats(&stats, FALSE);
+   for(i=0; i<BLCOUNT_NUM; i++)
+      ck_assert(stats.counts[i] == 0);
+   for(i=0; i<BLTIMER_NUM; i++)
+      ck_assert(stats.calls[i] == 0);
+}
+END_TEST
+
+START_TEST(test_readpdb_01)
+{
+   INSTRUMENTSTATS stats;
+   FILE            *fp;
+   PDB             *pdb;
+   int             natoms = 0;
+
+   /* Library hooks only do something in an instrumented build       */
+   if(!blInstrumentEnabled())
+      return;
+   
+   ck_assert((fp = fopen(TEST_PDB_FILE, "r")) != NULL);
+   pdb = blReadPDB(fp, &natoms);
+   fclose(fp);
+   ck_assert(pdb != NULL);
+
+   blGetInstrumentStats(&stats, TRUE);
+   ck_assert(stats.counts[BLCOUNT_ATOMS_ALLOCATED] == (ULONG)natoms);
+   ck_assert(stats.counts[BLCOUNT_LINES_PARSED] >= (ULONG)natoms);
+   ck_assert(stats.calls[BLTIMER_READPDB] == 1);
+
+   FREELIST(pdb, PDB);
+}
+END_TEST
+
+START_TEST(test_print_01)
+{
+   INSTRUMENTSTATS stats;
+   FILE            *fp;
+   char            buffer[MAXBUFF];
+   BOOL            found = FALSE;
+
+   blInstrumentCount(BLCOUNT_ATOMS_WRITTEN, 42);
+   blGetInstrumentStats(&stats, FALSE);
+
+   ck_assert((fp = fopen(TEST_OUT_FILE, "w")) != NULL);
+   blPrintInstrumentStats(fp, &stats, INSTRUMENT_JSON);
+   fclose(fp);
+
+   ck_assert((fp = fopen(TEST_OUT_FILE, "r")) != NULL);
+   while(fgets(buffer, MAXBUFF, fp))
+   {
+      if(strstr(buffer, "\"atoms_written\"") &&
+         strstr(buffer, "42"))
+         found = TRUE;
+   }
+   fclose(fp);
+   remove(TEST_OUT_FILE);
+   
+   ck_assert(found);
+}
+END_TEST
+
+
+/* Error Tests */
+START_TEST(test_error_01)
+{
+   INSTRUMENTSTATS stats;
+
+   /* Out of range counters and timers are ignored                   */
+   blInstrumentCount(-1, 1);
+   blInstrumentCount(BLCOUNT_NUM, 1);
+   blInstrumentTimerStart(BLTIMER_NUM);
+   blInstrumentTimerStop(-1);
+
+   /* Stopping a timer which was never started does nothing          */
+   blInstrumentTimerStop(BLTIMER_WRITEPDB);
+   
+   blGetInstrumentStats(&stats, FALSE);
+   ck_assert(stats.calls[BLTIMER_WRITEPDB] == 0);
+   ck_assert(blInstrumentCounterName(BLCOUNT_NUM) == NULL);
+   ck_assert(blInstrumentTimerName(-1) == NULL);
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *instrument_suite(void)
+{
+   Suite *s        = suite_create("Instrument");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, instrument_setup,
+                             instrument_teardown);
+   tcase_add_test(tc_core, test_count_01);
+   tcase_add_test(tc_core, test_timer_01);
+   tcase_add_test(tc_core, test_reset_01);
+   tcase_add_test(tc_core, test_readpdb_01);
+   tcase_add_test(tc_core, test_print_01);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, instrument_setup,
+                             instrument_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
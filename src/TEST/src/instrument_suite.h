@@ -0,0 +1,77 @@
+/************************************************************************/
+/**
+
+   \file       instrument_suite.h
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Include file for Instrument test suite.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for the instrumentation counters and timers and for the
+   counts made by the instrumented PDB reading routines.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+#ifndef _INSTRUMENT_SUITE_H
+#define _INSTRUMENT_SUITE_H
+
+/* Includes for tests */
+#include <stdlib.h>
+#include <check.h>
+#include "../../MathType.h"
+#include "../../pdb.h"
+
+/* Includes from source file */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "../../SysDefs.h"
+#include "../../macros.h"
+#include "../../instrument.h"
+
+/* Prototypes */
+Suite *instrument_suite(void);
+
+#endif
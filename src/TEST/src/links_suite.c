@@ -0,0 +1,243 @@
+/************************************************************************/
+/**
+
+   \file       links_suite.c
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Test suite for geometric disulphide and link detection.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for geometric disulphide and link detection.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+
+#include "links_suite.h"
+
+/* Defines */
+#define TEST_PDB_FILE    "./data/links_suite/crambin_nossbond.pdb"
+#define TOLERANCE        0.45
+
+/* Globals */
+static WHOLEPDB *wpdb = NULL;
+
+/* Setup And Teardown */
+static void links_setup(void)
+{
+   FILE *fp;
+   
+   if((fp = fopen(TEST_PDB_FILE,"r")) == NULL)
+   {
+      fprintf(stderr, "Failed to open test pdb file!\n");
+      return;
+   }
+   wpdb = blReadWholePDB(fp);
+   fclose(fp);
+}
+
+static void links_teardown(void)
+{
+   blFreeWholePDB(wpdb);
+   wpdb = NULL;
+}
+
+/* Check a disulphide                                                   */
+static BOOL is_disulphide(DISULPHIDE *d, int res1, int res2)
+{
+   return((d != NULL) && 
+          !strcmp(d->chain1, "A") && (d->res1 == res1) &&
+          !strcmp(d->chain2, "A") && (d->res2 == res2));
+}
+
+/* Count header records of a given type                                 */
+static int count_records(char *type)
+{
+   STRINGLIST *s;
+   int        count = 0;
+   
+   for(s=wpdb->header; s!=NULL; NEXT(s))
+   {
+      if(!strncmp(s->string, type, 6))
+         count++;
+   }
+   return(count);
+}
+
+
+/* Core Tests */
+START_TEST(test_disulphides_01)
+{
+   DISULPHIDE *dis;
+   BOOL       error;
+   
+   ck_assert(wpdb != NULL);
+   dis = blFindDisulphidesPDB(wpdb->pdb, TOLERANCE, &error);
+   ck_assert(!error);
+
+   ck_assert(is_disulphide(dis,             3, 40));
+   ck_assert(is_disulphide(dis->next,       4, 32));
+   ck_assert(is_disulphide(dis->next->next, 16, 26));
+   ck_assert(dis->next->next->next == NULL);
+
+   FREELIST(dis, DISULPHIDE);
+}
+END_TEST
+
+START_TEST(test_links_01)
+{
+   DISULPHIDE   *dis;
+   COVALENTLINK *links;
+   BOOL         error;
+   
+   links = blFindCovalentLinksPDB(wpdb->pdb, TOLERANCE, &dis, &error);
+   ck_assert(!error);
+
+   /* Same disulphides as from the SG grid                           */
+   ck_assert(is_disulphide(dis,             3, 40));
+   ck_assert(is_disulphide(dis->next,       4, 32));
+   ck_assert(is_disulphide(dis->next->next, 16, 26));
+   ck_assert(dis->next->next->next == NULL);
+
+   /* The zinc is bonded to Cys3, but no peptide bonds are listed    */
+   ck_assert(links != NULL);
+   ck_assert(links->next == NULL);
+   ck_assert(!strncmp(links->atom1->atnam, "SG  ", 4));
+   ck_assert_int_eq(links->atom1->resnum, 3);
+   ck_assert(!strncmp(links->atom2->atnam, "ZN  ", 4));
+   ck_assert(fabs(links->distance - 2.30) < 0.01);
+
+   FREELIST(dis, DISULPHIDE);
+   FREELIST(links, COVALENTLINK);
+}
+END_TEST
+
+START_TEST(test_links_02)
+{
+   COVALENTLINK *links, *l;
+   BOOL         error;
+   int          count = 0;
+   
+   /* Without a disulphide list, the disulphides are links           */
+   links = blFindCovalentLinksPDB(wpdb->pdb, TOLERANCE, NULL, &error);
+   ck_assert(!error);
+   for(l=links; l!=NULL; NEXT(l))
+      count++;
+   ck_assert_int_eq(count, 4);
+   
+   FREELIST(links, COVALENTLINK);
+}
+END_TEST
+
+START_TEST(test_records_01)
+{
+   DISULPHIDE   *dis;
+   COVALENTLINK *links;
+   STRINGLIST   *s;
+   BOOL         error;
+   
+   ck_assert_int_eq(count_records("SSBOND"), 0);
+
+   links = blFindCovalentLinksPDB(wpdb->pdb, TOLERANCE, &dis, &error);
+   ck_assert(blSetLinkRecordsWholePDB(wpdb, dis, links));
+   ck_assert_int_eq(count_records("SSBOND"), 3);
+   ck_assert_int_eq(count_records("LINK  "), 1);
+
+   /* The records go before CRYST1 and match the SSBOND format       */
+   for(s=wpdb->header; s!=NULL; NEXT(s))
+   {
+      if(!strncmp(s->string, "SSBOND", 6))
+         break;
+      ck_assert(strncmp(s->string, "CRYST1", 6));
+   }
+   ck_assert(!strncmp(s->string, 
+                      "SSBOND   1 CYS A    3    CYS A   40", 35));
+
+   /* Regenerating replaces the old records                          */
+   ck_assert(blSetLinkRecordsWholePDB(wpdb, dis, NULL));
+   ck_assert_int_eq(count_records("SSBOND"), 3);
+   ck_assert_int_eq(count_records("LINK  "), 0);
+   
+   FREELIST(dis, DISULPHIDE);
+   FREELIST(links, COVALENTLINK);
+}
+END_TEST
+
+
+/* Error Tests */
+START_TEST(test_error_01)
+{
+   BOOL error;
+   
+   ck_assert(blFindDisulphidesPDB(NULL, TOLERANCE, &error) == NULL);
+   ck_assert(!error);
+   ck_assert(blFindCovalentLinksPDB(NULL, TOLERANCE, NULL, &error) 
+             == NULL);
+   ck_assert(!error);
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *links_suite(void)
+{
+   Suite *s        = suite_create("Links");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, links_setup, links_teardown);
+   tcase_add_test(tc_core, test_disulphides_01);
+   tcase_add_test(tc_core, test_links_01);
+   tcase_add_test(tc_core, test_links_02);
+   tcase_add_test(tc_core, test_records_01);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, links_setup, links_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
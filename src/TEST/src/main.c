@@ -3,8 +3,8 @@
 
    \file       main.c
    
-   \version    V1.2
-   \date       05.05.15
+   \version    V1.17
+   \date       17.10.26
    \brief      Run test suites for BiopLib.
 
    \copyright  (c) UCL / Dr. Andrew C. R. Martin 1993-2015
@@ -71,6 +71,21 @@
 -  V1.0  05.08.14 Original By: CTP
 -  V1.1  28.04.15 Add CONECT tests. By: CTP
 -  V1.2  05.05.15 Add Header tests. By: CTP
+-  V1.3  17.10.26 Add atom selection tests. By: ACRM
+-  V1.4  17.10.26 Add non-bonded energy tests. By: ACRM
+-  V1.5  17.10.26 Add metal site search tests. By: ACRM
+-  V1.6  17.10.26 Add NeRF chain builder tests. By: ACRM
+-  V1.7  17.10.26 Add instrumentation tests. By: ACRM
+-  V1.8  17.10.26 Add scoring matrix tests. By: ACRM
+-  V1.9  17.10.26 Add disulphide and link detection tests. By: ACRM
+-  V1.10 17.10.26 Add hydrophobicity profile tests. By: ACRM
+-  V1.11 17.10.26 Add structural alignment tests. By: ACRM
+-  V1.12 17.10.26 Add topology string and index tests. By: ACRM
+-  V1.13 17.10.26 Add coordinate archive tests. By: ACRM
+-  V1.14 17.10.26 Add sequence index and clustering tests. By: ACRM
+-  V1.15 17.10.26 Add residue bounds tests. By: ACRM
+-  V1.16 17.10.26 Add PDB view tests. By: ACRM
+-  V1.17 17.10.26 Add compact atom storage tests. By: ACRM
 
 *************************************************************************/
 
@@ -88,6 +103,21 @@
 #include "wholepdb_suite.h"
 #include "conect_suite.h"
 #include "header_suite.h"
+#include "atomsel_suite.h"
+#include "nbenergy_suite.h"
+#include "metalsite_suite.h"
+#include "nerf_suite.h"
+#include "instrument_suite.h"
+#include "mdmatrix_suite.h"
+#include "links_suite.h"
+#include "hpbprofile_suite.h"
+#include "strucalign_suite.h"
+#include "topology_suite.h"
+#include "coorarchive_suite.h"
+#include "seqcluster_suite.h"
+#include "resbounds_suite.h"
+#include "pdbview_suite.h"
+#include "pdbcompact_suite.h"
                                                   /* add suites here... */
 
 
@@ -113,6 +143,21 @@ int main(int argc, char **argv)
    srunner_add_suite(sr, wholepdb_suite());
    srunner_add_suite(sr, conect_suite());
    srunner_add_suite(sr, header_suite());
+   srunner_add_suite(sr, atomsel_suite());
+   srunner_add_suite(sr, nbenergy_suite());
+   srunner_add_suite(sr, metalsite_suite());
+   srunner_add_suite(sr, nerf_suite());
+   srunner_add_suite(sr, instrument_suite());
+   srunner_add_suite(sr, mdmatrix_suite());
+   srunner_add_suite(sr, links_suite());
+   srunner_add_suite(sr, hpbprofile_suite());
+   srunner_add_suite(sr, strucalign_suite());
+   srunner_add_suite(sr, topology_suite());
+   srunner_add_suite(sr, coorarchive_suite());
+   srunner_add_suite(sr, seqcluster_suite());
+   srunner_add_suite(sr, resbounds_suite());
+   srunner_add_suite(sr, pdbview_suite());
+   srunner_add_suite(sr, pdbcompact_suite());
                                                   /* add suites here... */
 
 
@@ -0,0 +1,218 @@
+/************************************************************************/
+/**
+
+   \file       mdmatrix_suite.c
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Test suite for scoring matrix objects.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for scoring matrix objects.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+
+#include "mdmatrix_suite.h"
+
+/* Defines */
+#define TEST_BLOSUM      "../../data/BLOSUM62"
+#define TEST_PAM         "../../data/pam250.mat"
+#define TEST_SEQ1        "ACDEFGHIKLMNPQRSTVWYKLTWW"
+#define TEST_SEQ2        "MKTAYIAKQRQISFVKSHFSRQLEERLGLIEVQ"
+#define MAXALN           80
+
+/* Globals */
+static MDMATRIX *blosum = NULL;
+static MDMATRIX *pam    = NULL;
+
+/* Setup And Teardown */
+static void mdmatrix_setup(void)
+{
+   blosum = blReadMDMatrix(TEST_BLOSUM);
+   pam    = blReadMDMatrix(TEST_PAM);
+}
+
+static void mdmatrix_teardown(void)
+{
+   blFreeMDMatrix(blosum);
+   blFreeMDMatrix(pam);
+   blFreeMDM();
+   blosum = pam = NULL;
+}
+
+
+/* Core Tests */
+START_TEST(test_read_01)
+{
+   ck_assert(blosum != NULL);
+   ck_assert(pam    != NULL);
+   ck_assert_int_eq(blosum->size, 24);
+   ck_assert(!strncmp(blosum->aaList, "ARNDCQEGHILKMFPSTWYVBZX*", 24));
+
+   /* Both matrices are available at once                            */
+   ck_assert_int_eq(blMDMatrixScore(blosum, 'W', 'W'), 11);
+   ck_assert_int_eq(blMDMatrixScore(pam,    'W', 'W'), 17);
+   ck_assert_int_eq(blMDMatrixScore(blosum, 'A', 'R'), -1);
+   ck_assert_int_eq(blMDMatrixScore(blosum, 'R', 'A'), -1);
+}
+END_TEST
+
+START_TEST(test_score_01)
+{
+   /* Unknown residues score zero; the UC version ignores case       */
+   ck_assert_int_eq(blMDMatrixScore(blosum, 'w', 'W'), 0);
+   ck_assert_int_eq(blMDMatrixScore(blosum, 'J', 'A'), 0);
+   ck_assert_int_eq(blMDMatrixScoreUC(blosum, 'w', 'W'), 11);
+   ck_assert_int_eq(blMDMatrixScoreUC(blosum, 'a', 'r'), -1);
+}
+END_TEST
+
+START_TEST(test_default_01)
+{
+   char *s1 = TEST_SEQ1,
+        *s2 = TEST_SEQ2,
+        al1[MAXALN], al2[MAXALN],
+        bl1[MAXALN], bl2[MAXALN];
+   int  score1, score2, len1, len2;
+
+   /* The old routines use the default matrix                        */
+   ck_assert(blReadMDM(TEST_BLOSUM));
+   ck_assert(blGetDefaultMDMatrix() != NULL);
+   ck_assert_int_eq(blCalcMDMScore('W', 'W'), 11);
+
+   score1 = blAffinealign(s1, strlen(s1), s2, strlen(s2), FALSE, FALSE,
+                          10, 2, al1, al2, &len1);
+   score2 = blMDMatrixAffinealign(blosum, s1, strlen(s1), s2, strlen(s2),
+                                  FALSE, FALSE, 10, 2, 0,
+                                  bl1, bl2, &len2);
+   ck_assert_int_eq(score1, score2);
+   ck_assert_int_eq(len1, len2);
+   ck_assert(!strncmp(al1, bl1, len1));
+   ck_assert(!strncmp(al2, bl2, len1));
+}
+END_TEST
+
+START_TEST(test_align_01)
+{
+   char *s1 = TEST_SEQ1,
+        al1[MAXALN], al2[MAXALN];
+   int  score, len;
+
+   /* Self alignment scores the sum of the diagonal                  */
+   score = blMDMatrixAffinealign(pam, s1, strlen(s1), s1, strlen(s1),
+                                 FALSE, FALSE, 10, 2, 0,
+                                 al1, al2, &len);
+   ck_assert_int_eq(len, (int)strlen(s1));
+   ck_assert(!strncmp(al1, s1, len));
+   ck_assert(!strncmp(al2, s1, len));
+   ck_assert(score > 0);
+}
+END_TEST
+
+START_TEST(test_zero_01)
+{
+   int i, j, maxval;
+
+   maxval = blZeroMDMatrix(pam);
+   ck_assert_int_eq(maxval, 25);
+   for(i=0; i<pam->size; i++)
+   {
+      for(j=0; j<pam->size; j++)
+      {
+         ck_assert(blMDMATRIXCELL(pam, i, j) >= 0);
+      }
+   }
+
+   /* The other matrix is untouched                                  */
+   ck_assert_int_eq(blMDMatrixScore(blosum, 'A', 'R'), -1);
+
+   ck_assert(blSetMDMatrixScoreWeight(blosum, 'a', 'r', 2.0));
+   ck_assert_int_eq(blMDMatrixScore(blosum, 'R', 'A'), -2);
+}
+END_TEST
+
+
+/* Error Tests */
+START_TEST(test_error_01)
+{
+   char al1[MAXALN], al2[MAXALN];
+   int  len;
+
+   ck_assert(blReadMDMatrix("nonexistent_matrix") == NULL);
+   ck_assert(!blSetMDMatrixScoreWeight(blosum, 'J', 'A', 2.0));
+
+   /* No matrix to align with                                        */
+   ck_assert_int_eq(blMDMatrixAffinealign(NULL, "AC", 2, "AC", 2,
+                                          FALSE, FALSE, 10, 2, 0,
+                                          al1, al2, &len), 0);
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *mdmatrix_suite(void)
+{
+   Suite *s        = suite_create("MDMatrix");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, mdmatrix_setup, 
+                             mdmatrix_teardown);
+   tcase_add_test(tc_core, test_read_01);
+   tcase_add_test(tc_core, test_score_01);
+   tcase_add_test(tc_core, test_default_01);
+   tcase_add_test(tc_core, test_align_01);
+   tcase_add_test(tc_core, test_zero_01);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, mdmatrix_setup, 
+                             mdmatrix_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
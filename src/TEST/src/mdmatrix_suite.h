@@ -0,0 +1,78 @@
+/************************************************************************/
+/**
+
+   \file       mdmatrix_suite.h
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Include file for MDMATRIX test suite.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for reading MDMATRIX scoring matrices, for scoring and
+   aligning sequences with them and for their agreement with the
+   global matrix routines.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+#ifndef _MDMATRIX_SUITE_H
+#define _MDMATRIX_SUITE_H
+
+/* Includes for tests */
+#include <stdlib.h>
+#include <check.h>
+
+/* Includes from source file */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "../../SysDefs.h"
+#include "../../macros.h"
+#include "../../array.h"
+#include "../../general.h"
+#include "../../seq.h"
+#include "../../instrument.h"
+
+/* Prototypes */
+Suite *mdmatrix_suite(void);
+
+#endif
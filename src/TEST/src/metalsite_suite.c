@@ -0,0 +1,349 @@
+/************************************************************************/
+/**
+
+   \file       metalsite_suite.c
+   
+   \version    V1.2
+   \date       17.10.26
+   \brief      Test suite for metal site searches.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for metal site searches.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+-  V1.1  17.10.26 Added a threaded test on a gzipped file
+-  V1.2  17.10.26 A site is one hit from its C-alpha and C-beta 
+                  templates. Added a test on structures with no sites
+
+*************************************************************************/
+
+
+#include "metalsite_suite.h"
+
+/* Defines */
+#define TEST_PDB_FILE  "data/metalsite_suite/test_zinc_site.pdb"
+#define TEST_PDB_DIR   "data/metalsite_suite"
+#define TEST_NOSITE_FILE1 "data/test-deca-ala-01.pdb"
+#define TEST_NOSITE_FILE2 "data/crambin.pdb"
+#define TEST_GZ_FILE   "data/metalsite_suite/test_zinc_site.pdb.gz"
+#define NGZFILES       24
+#define TEST_ZN_FILE   "../../data/zn_sites.dat"
+#define TEST_CU_FILE   "../../data/cu_sites.dat"
+#define TEST_CA_FILE   "../../data/ca_ef_sites.dat"
+
+/* Globals */
+static PDB          *pdb_in = NULL;
+static METALSITELIB *lib    = NULL;
+
+/* Setup And Teardown */
+static void metalsite_setup(void)
+{
+   FILE *fp;
+   int natom = 0;
+   
+   fp = fopen(TEST_PDB_FILE,"r");
+   if(fp == NULL)
+   {
+      fprintf(stderr, "Failed to open test pdb file!\n");
+      return;
+   }
+   
+   pdb_in = blReadPDB(fp,&natom);
+   fclose(fp);
+   
+   if(pdb_in == NULL)
+   {
+      fprintf(stderr, "Failed to read test pdb file!\n");
+      return;
+   }
+
+   lib = blReadMetalSiteLib(NULL, TEST_ZN_FILE, "ZN");
+   if(lib != NULL)
+      lib = blReadMetalSiteLib(lib, TEST_CU_FILE, "CU");
+   if(lib != NULL)
+      lib = blReadMetalSiteLib(lib, TEST_CA_FILE, "CA");
+   if(lib == NULL)
+   {
+      fprintf(stderr, "Failed to read template files!\n");
+      return;
+   }
+}
+
+static void metalsite_teardown(void)
+{
+   /* Free templates and PDB */
+   blFreeMetalSiteLib(lib);
+   FREELIST(pdb_in,PDB);
+   lib = NULL;
+}
+
+/* Data Read Tests */
+START_TEST(test_read_01)
+{
+   int i;
+   
+   ck_assert_msg(pdb_in != NULL, "No data read from test file.");
+   ck_assert_msg(lib != NULL, "No templates read.");
+   ck_assert_int_eq(lib->ntemplates, 40);
+   ck_assert_int_eq(lib->natnams, 3);
+   
+   /* The templates are sorted by their first distance */
+   for(i=1; i<lib->ntemplates; i++)
+      ck_assert(lib->edges[i-1].dist <= lib->edges[i].dist);
+   
+   ck_assert_str_eq(lib->templates[0].metal, "ZN");
+   ck_assert_str_eq(lib->templates[0].atnam[0], "CA");
+   ck_assert_str_eq(lib->templates[0].resnam[2], "HIS");
+
+   /* The C-alpha and C-beta templates of each site are partners       */
+   for(i=0; i<lib->ntemplates; i++)
+      ck_assert_int_eq(lib->templates[i].partner, i + ((i%2) ? -1 : 1));
+}
+END_TEST
+
+
+/* Core tests */
+START_TEST(test_find_01)
+{
+   METALSITEHIT *hits;
+   int          nhits;
+
+   /* The C-alpha and C-beta patterns of the 1TON site give one hit */
+   hits = blFindMetalSites(lib, pdb_in, METALSITE_DEFDISTTOL,
+                           METALSITE_DEFRMSD, FALSE, &nhits);
+   ck_assert_int_eq(nhits, 1);
+   ck_assert(hits != NULL);
+   ck_assert(hits->next == NULL);
+
+   ck_assert_int_eq(hits->template, 0);
+   ck_assert_int_eq(hits->natoms, 3);
+   ck_assert(hits->rmsd < 0.01);
+   ck_assert_int_eq(hits->resnum[0], 57);
+   ck_assert_int_eq(hits->resnum[1], 97);
+   ck_assert_int_eq(hits->resnum[2], 99);
+   ck_assert_str_eq(hits->chain[0], "A");
+   ck_assert_str_eq(hits->resnam[0], "HIS");
+   ck_assert_str_eq(hits->atoms[0]->atnam, "CA  ");
+   ck_assert(hits->filename == NULL);
+
+   blFreeMetalSiteHits(hits);
+}
+END_TEST
+
+START_TEST(test_find_02)
+{
+   METALSITEHIT *hits;
+   PDB          *p;
+   int          nhits;
+
+   /* A mutated site is only found if the residue types are ignored */
+   for(p=pdb_in; p!=NULL; NEXT(p))
+   {
+      if(p->resnum == 97)
+         strcpy(p->resnam, "ALA ");
+   }
+
+   hits = blFindMetalSites(lib, pdb_in, METALSITE_DEFDISTTOL,
+                           METALSITE_DEFRMSD, TRUE, &nhits);
+   ck_assert_int_eq(nhits, 0);
+   ck_assert(hits == NULL);
+
+   hits = blFindMetalSites(lib, pdb_in, METALSITE_DEFDISTTOL,
+                           METALSITE_DEFRMSD, FALSE, &nhits);
+   ck_assert_int_eq(nhits, 1);
+   ck_assert_str_eq(hits->resnam[1], "ALA");
+   blFreeMetalSiteHits(hits);
+}
+END_TEST
+
+START_TEST(test_find_03)
+{
+   METALSITEHIT *hits;
+   PDB          *p;
+   int          nhits;
+
+   /* Distort the site beyond the distance tolerance */
+   for(p=pdb_in; p!=NULL; NEXT(p))
+   {
+      if(p->resnum == 99)
+         p->x += 2.0;
+   }
+
+   hits = blFindMetalSites(lib, pdb_in, METALSITE_DEFDISTTOL,
+                           METALSITE_DEFRMSD, FALSE, &nhits);
+   ck_assert_int_eq(nhits, 0);
+   ck_assert(hits == NULL);
+}
+END_TEST
+
+START_TEST(test_find_04)
+{
+   METALSITEHIT *hits;
+   FILE         *fp;
+   PDB          *pdb;
+   int          natoms,
+                nhits;
+
+   /* Structures without metal sites give no hits                      */
+   ck_assert((fp = fopen(TEST_NOSITE_FILE1, "r")) != NULL);
+   pdb = blReadPDB(fp, &natoms);
+   fclose(fp);
+   ck_assert(pdb != NULL);
+   hits = blFindMetalSites(lib, pdb, METALSITE_DEFDISTTOL,
+                           METALSITE_DEFRMSD, FALSE, &nhits);
+   ck_assert_int_eq(nhits, 0);
+   ck_assert(hits == NULL);
+   FREELIST(pdb, PDB);
+
+   ck_assert((fp = fopen(TEST_NOSITE_FILE2, "r")) != NULL);
+   pdb = blReadPDB(fp, &natoms);
+   fclose(fp);
+   ck_assert(pdb != NULL);
+   hits = blFindMetalSites(lib, pdb, METALSITE_DEFDISTTOL,
+                           METALSITE_DEFRMSD, TRUE, &nhits);
+   ck_assert_int_eq(nhits, 0);
+   ck_assert(hits == NULL);
+   FREELIST(pdb, PDB);
+}
+END_TEST
+
+START_TEST(test_dir_01)
+{
+   METALSITEHIT *hits;
+   int          nscanned;
+
+   /* The directory holds the plain and gzipped copies of the file    */
+   hits = blFindMetalSitesDir(lib, TEST_PDB_DIR, METALSITE_DEFDISTTOL,
+                              METALSITE_DEFRMSD, FALSE, 2, &nscanned);
+   ck_assert_int_eq(nscanned, 2);
+   ck_assert(hits != NULL);
+   ck_assert(!strncmp(hits->filename, TEST_PDB_DIR "/test_zinc_site.pdb",
+                      strlen(TEST_PDB_DIR "/test_zinc_site.pdb")));
+   ck_assert(hits->atoms[0] == NULL);
+   ck_assert_int_eq(hits->resnum[0], 57);
+   blFreeMetalSiteHits(hits);
+}
+END_TEST
+
+START_TEST(test_dir_02)
+{
+   METALSITEHIT *hits, 
+                *h;
+   char         *files[NGZFILES];
+   int          i, 
+                nscanned,
+                nhits1 = 0,
+                nhits  = 0;
+
+   /* Each thread uncompresses its own copy of the gzipped file        */
+   for(i=0; i<NGZFILES; i++)
+      files[i] = TEST_GZ_FILE;
+
+   hits = blFindMetalSitesFiles(lib, files, 1, METALSITE_DEFDISTTOL,
+                                METALSITE_DEFRMSD, FALSE, 1, &nscanned);
+   ck_assert_int_eq(nscanned, 1);
+   for(h=hits; h!=NULL; NEXT(h))
+      nhits1++;
+   ck_assert(nhits1 > 0);
+   blFreeMetalSiteHits(hits);
+
+   hits = blFindMetalSitesFiles(lib, files, NGZFILES, 
+                                METALSITE_DEFDISTTOL, METALSITE_DEFRMSD, 
+                                FALSE, 4, &nscanned);
+   ck_assert_int_eq(nscanned, NGZFILES);
+   for(h=hits; h!=NULL; NEXT(h))
+   {
+      ck_assert_str_eq(h->filename, TEST_GZ_FILE);
+      ck_assert_int_eq(h->resnum[0], 57);
+      nhits++;
+   }
+   ck_assert_int_eq(nhits, NGZFILES * nhits1);
+   blFreeMetalSiteHits(hits);
+}
+END_TEST
+
+
+/* Error tests */
+START_TEST(test_error_01)
+{
+   int nhits;
+
+   ck_assert(blReadMetalSiteLib(NULL, "nonexistent_sites.dat", "ZN")
+             == NULL);
+   ck_assert(blFindMetalSites(NULL, pdb_in, METALSITE_DEFDISTTOL,
+                              METALSITE_DEFRMSD, FALSE, &nhits) == NULL);
+   ck_assert_int_eq(nhits, 0);
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *metalsite_suite(void)
+{
+   Suite *s        = suite_create("MetalSite");
+   TCase *tc_read  = tcase_create("Read");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Check read from test file */
+   tcase_add_checked_fixture(tc_read, metalsite_setup, metalsite_teardown);
+   tcase_add_test(tc_read, test_read_01);
+   suite_add_tcase(s, tc_read);   
+   
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, metalsite_setup, metalsite_teardown);
+   tcase_add_test(tc_core, test_find_01);
+   tcase_add_test(tc_core, test_find_02);
+   tcase_add_test(tc_core, test_find_03);
+   tcase_add_test(tc_core, test_find_04);
+   tcase_add_test(tc_core, test_dir_01);
+   tcase_add_test(tc_core, test_dir_02);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, metalsite_setup,
+                             metalsite_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
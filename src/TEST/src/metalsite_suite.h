@@ -0,0 +1,84 @@
+/************************************************************************/
+/**
+
+   \file       metalsite_suite.h
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Include file for MetalSite test suite.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for reading metal-binding site templates and for
+   searching structures and directories of structures for matching
+   sites.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+#ifndef _METALSITE_SUITE_H
+#define _METALSITE_SUITE_H
+
+/* Includes for tests */
+#include <stdlib.h>
+#include <check.h>
+
+/* Includes from source file */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+#include <dirent.h>
+#include "../../SysDefs.h"
+#include "../../MathType.h"
+#include "../../macros.h"
+#include "../../general.h"
+#include "../../pdb.h"
+#include "../../fit.h"
+#include "../../matrix.h"
+#include "../../atomgrid.h"
+#include "../../threadpool.h"
+#include "../../metalsite.h"
+
+/* Prototypes */
+Suite *metalsite_suite(void);
+
+#endif
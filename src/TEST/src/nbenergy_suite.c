@@ -0,0 +1,351 @@
+/************************************************************************/
+/**
+
+   \file       nbenergy_suite.c
+   
+   \version    V1.1
+   \date       17.10.26
+   \brief      Test suite for non-bonded energies.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for non-bonded energies.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+-  V1.1  17.10.26 Added tests of updates within and outside the grid
+                  By: ACRM
+
+*************************************************************************/
+
+#include "nbenergy_suite.h"
+
+/* Defines */
+#define TEST_PDB_FILE    "./data/test-deca-ala-01.pdb"
+#define TEST_PARAM_FILE  "../../data/eparams.dat"
+#define TEST_CHARGE_FILE "../../data/kolluni.dat"
+#define TOLERANCE        1.0e-6
+
+/* Globals */
+static PDB      *pdb_in = NULL;
+static NBPARAMS *params = NULL;
+static NBENERGY *nbe    = NULL;
+
+/* Setup And Teardown */
+static void nbenergy_setup(void)
+{
+   FILE *fp;
+   int natom = 0;
+   
+   fp = fopen(TEST_PDB_FILE,"r");
+   if(fp == NULL)
+   {
+      fprintf(stderr, "Failed to open test pdb file!\n");
+      return;
+   }
+   
+   pdb_in = blReadPDB(fp,&natom);
+   fclose(fp);
+   
+   if(pdb_in == NULL)
+   {
+      fprintf(stderr, "Failed to read test pdb file!\n");
+      return;
+   }
+
+   params = blReadNBParams(TEST_PARAM_FILE);
+   if((params == NULL) || !blReadNBCharges(params, TEST_CHARGE_FILE))
+   {
+      fprintf(stderr, "Failed to read parameter files!\n");
+      return;
+   }
+
+   nbe = blCreateNBEnergy(pdb_in, params, NBE_DEFCUTOFF, (REAL)4.0,
+                          TRUE);
+}
+
+static void nbenergy_teardown(void)
+{
+   /* Free energy, parameters and PDB */
+   blFreeNBEnergy(nbe);
+   blFreeNBParams(params);
+   FREELIST(pdb_in,PDB);
+   nbe    = NULL;
+   params = NULL;
+}
+
+/* Check that the energies match a full recalculation */
+static void check_against_full(void)
+{
+   REAL evdw  = nbe->evdw,
+        ecoul = nbe->ecoul;
+
+   ck_assert(blCalcNBEnergy(nbe));
+   ck_assert(fabs(evdw  - nbe->evdw)  < TOLERANCE * fabs(nbe->evdw));
+   ck_assert(fabs(ecoul - nbe->ecoul) < TOLERANCE * fabs(nbe->ecoul));
+}
+
+/* Check that the energies match those of a new energy structure, 
+   leaving the grid of the original alone
+*/
+static void check_against_new(void)
+{
+   NBENERGY *ref;
+
+   ref = blCreateNBEnergy(pdb_in, params, NBE_DEFCUTOFF, (REAL)4.0,
+                          TRUE);
+   ck_assert(ref != NULL);
+   ck_assert(fabs(ref->evdw  - nbe->evdw)  < TOLERANCE * fabs(ref->evdw));
+   ck_assert(fabs(ref->ecoul - nbe->ecoul) < 
+             TOLERANCE * fabs(ref->ecoul));
+   blFreeNBEnergy(ref);
+}
+
+/* PDB Data Read Test */
+START_TEST(test_read_01)
+{
+   ck_assert_msg(pdb_in != NULL, "No data read from test file.");
+   ck_assert_msg(params != NULL, "No parameters read.");
+   ck_assert_int_eq(params->ntypes, 31);
+}
+END_TEST
+
+
+/* Core tests */
+START_TEST(test_assign_01)
+{
+   PDB *p;
+   int ntyped = 0;
+
+   ck_assert(nbe != NULL);
+   ck_assert_int_eq(nbe->natoms, 51);
+   ck_assert_int_eq(nbe->nres,   10);
+
+   for(p=pdb_in; p!=NULL; NEXT(p))
+   {
+      if(p->atomInfo != NULL)
+         ntyped++;
+   }
+   /* NT is not in the topology */
+   ck_assert_int_eq(ntyped, 50);
+
+   /* Type from eparams.dat, charge from kolluni.dat */
+   ck_assert_str_eq(pdb_in->atomInfo->atomtype, "NH1");
+   ck_assert(fabs(pdb_in->partial_charge - (-0.52)) < TOLERANCE);
+}
+END_TEST
+
+START_TEST(test_exclusions_01)
+{
+   /* The first N excludes CA, CB and C of its own residue */
+   ck_assert_int_eq(nbe->exclStart[1] - nbe->exclStart[0], 3);
+   ck_assert_int_eq(nbe->excl[nbe->exclStart[0]], 1);
+   ck_assert_int_eq(nbe->exclStart[nbe->natoms], 224);
+}
+END_TEST
+
+START_TEST(test_energy_01)
+{
+   PDB  *p;
+   REAL evdw, ecoul,
+        sumAtoms = (REAL)0.0,
+        sumRes   = (REAL)0.0;
+   int  i;
+
+   ck_assert(nbe->evdw != (REAL)0.0);
+   ck_assert(nbe->ecoul != (REAL)0.0);
+
+   for(p=pdb_in; p!=NULL; NEXT(p))
+      sumAtoms += blGetNBEnergyAtom(nbe, p, NULL, NULL);
+   for(i=0; i<nbe->nres; i++)
+      sumRes += blGetNBEnergyResidue(nbe,
+                                     nbe->attribs->atoms[nbe->resFirst[i]],
+                                     &evdw, &ecoul);
+
+   ck_assert(fabs(sumAtoms - (nbe->evdw + nbe->ecoul)) < 
+             TOLERANCE * fabs(sumAtoms));
+   ck_assert(fabs(sumRes - (nbe->evdw + nbe->ecoul)) < 
+             TOLERANCE * fabs(sumRes));
+}
+END_TEST
+
+START_TEST(test_update_01)
+{
+   PDB *start, *stop, *p;
+
+   /* Move residue A3 */
+   for(p=pdb_in; p!=NULL; NEXT(p))
+   {
+      if(p->resnum == 3)
+         break;
+   }
+   start = p;
+   stop  = blFindNextResidue(start);
+   for(p=start; p!=stop; NEXT(p))
+   {
+      p->x += 0.5;
+      p->z -= 0.3;
+   }
+
+   ck_assert(blUpdateNBEnergyRange(nbe, start, stop));
+   check_against_full();
+}
+END_TEST
+
+START_TEST(test_update_02)
+{
+   PDB *moved[4];
+
+   /* A repeated atom must only be counted once */
+   moved[0] = pdb_in;
+   moved[1] = pdb_in->next->next;
+   moved[2] = pdb_in;
+   moved[3] = nbe->attribs->atoms[40];
+   moved[0]->y += 0.7;
+   moved[1]->x -= 0.4;
+   moved[3]->z += 1.1;
+
+   ck_assert(blUpdateNBEnergy(nbe, moved, 4));
+   check_against_full();
+}
+END_TEST
+
+START_TEST(test_update_03)
+{
+   ATOMGRID *grid = nbe->grid;
+   PDB      *p    = nbe->attribs->atoms[2],
+            *q    = nbe->attribs->atoms[45];
+   REAL     x     = p->x,
+            y     = p->y,
+            z     = p->z;
+   int      nx    = grid->nx;
+
+   /* Move an atom across the structure, and so between grid cells, 
+      then move it again and back. The grid must not be rebuilt
+   */
+   p->x = q->x + 0.5;
+   p->y = q->y + 0.5;
+   p->z = q->z;
+   ck_assert(blUpdateNBEnergy(nbe, &p, 1));
+   ck_assert(nbe->grid == grid);
+   ck_assert(grid->slotOf[2] == -1);
+   check_against_new();
+
+   p->y -= 1.2;
+   ck_assert(blUpdateNBEnergy(nbe, &p, 1));
+   check_against_new();
+
+   p->x = x;
+   p->y = y;
+   p->z = z;
+   ck_assert(blUpdateNBEnergy(nbe, &p, 1));
+   ck_assert(nbe->grid == grid);
+   ck_assert(nbe->grid->nx == nx);
+   check_against_new();
+   check_against_full();
+}
+END_TEST
+
+START_TEST(test_update_04)
+{
+   ATOMGRID *grid = nbe->grid;
+   PDB      *p    = nbe->attribs->atoms[20];
+   REAL     xmax  = grid->xmin + grid->nx * grid->cellSize;
+
+   /* An atom that leaves the grid forces it to be rebuilt */
+   p->x = xmax + NBE_DEFCUTOFF;
+   ck_assert(blUpdateNBEnergy(nbe, &p, 1));
+   ck_assert(nbe->grid->xmin + nbe->grid->nx * nbe->grid->cellSize > 
+             p->x);
+   ck_assert(nbe->grid->movedHead == NULL);
+   check_against_new();
+   check_against_full();
+}
+END_TEST
+
+/* Error tests */
+START_TEST(test_error_01)
+{
+   PDB atom;
+
+   ck_assert(blReadNBParams("nonexistent_eparams.dat") == NULL);
+   ck_assert(blCreateNBEnergy(pdb_in, NULL, NBE_DEFCUTOFF, (REAL)4.0,
+                              TRUE) == NULL);
+   ck_assert(blCreateNBEnergy(pdb_in, params, (REAL)0.0, (REAL)4.0,
+                              TRUE) == NULL);
+
+   /* An atom which is not in the structure */
+   atom = *pdb_in;
+   ck_assert(!blUpdateNBEnergyRange(nbe, &atom, NULL));
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *nbenergy_suite(void)
+{
+   Suite *s        = suite_create("NBEnergy");
+   TCase *tc_read  = tcase_create("Read");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Check read from test file */
+   tcase_add_checked_fixture(tc_read, nbenergy_setup, nbenergy_teardown);
+   tcase_add_test(tc_read, test_read_01);
+   suite_add_tcase(s, tc_read);   
+   
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, nbenergy_setup, nbenergy_teardown);
+   tcase_add_test(tc_core, test_assign_01);
+   tcase_add_test(tc_core, test_exclusions_01);
+   tcase_add_test(tc_core, test_energy_01);
+   tcase_add_test(tc_core, test_update_01);
+   tcase_add_test(tc_core, test_update_02);
+   tcase_add_test(tc_core, test_update_03);
+   tcase_add_test(tc_core, test_update_04);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, nbenergy_setup, nbenergy_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
@@ -0,0 +1,82 @@
+/************************************************************************/
+/**
+
+   \file       nbenergy_suite.h
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Include file for NBEnergy test suite.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for reading non-bonded parameters and charges, for
+   calculating the non-bonded energy of a structure and for updating it
+   as atoms are moved.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+#ifndef _NBENERGY_SUITE_H
+#define _NBENERGY_SUITE_H
+
+/* Includes for tests */
+#include <stdlib.h>
+#include <check.h>
+
+/* Includes from source file */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+#include "../../SysDefs.h"
+#include "../../MathType.h"
+#include "../../macros.h"
+#include "../../general.h"
+#include "../../pdb.h"
+#include "../../hash.h"
+#include "../../atomgrid.h"
+#include "../../pdbattrib.h"
+#include "../../nbenergy.h"
+
+/* Prototypes */
+Suite *nbenergy_suite(void);
+
+#endif
@@ -0,0 +1,330 @@
+/************************************************************************/
+/**
+
+   \file       nerf_suite.c
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Test suite for the NeRF chain builder.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for the NeRF chain builder.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+
+#include "nerf_suite.h"
+
+/* Defines */
+#define TEST_PDB_FILE    "./data/test-deca-ala-01.pdb"
+#define TEST_REF_FILE    "../../data/coor"
+#define TEST_SEQUENCE    "ACDEFGHIKLMNPQRSTVWY"
+#define TOLERANCE        1.0e-8
+
+/* Globals */
+static PDB       *pdb_in = NULL;
+static NERFCHAIN *chain  = NULL;
+
+/* Setup And Teardown */
+static void nerf_setup(void)
+{
+   FILE *fp;
+   int natom = 0;
+   
+   fp = fopen(TEST_PDB_FILE,"r");
+   if(fp == NULL)
+   {
+      fprintf(stderr, "Failed to open test pdb file!\n");
+      return;
+   }
+   
+   pdb_in = blReadPDB(fp,&natom);
+   fclose(fp);
+   
+   if(pdb_in == NULL)
+   {
+      fprintf(stderr, "Failed to read test pdb file!\n");
+      return;
+   }
+
+   chain = blCreateNeRFChain(TEST_SEQUENCE, TEST_REF_FILE);
+   if(chain == NULL)
+   {
+      fprintf(stderr, "Failed to create chain!\n");
+      return;
+   }
+}
+
+static void nerf_teardown(void)
+{
+   /* Free chain and PDB */
+   blFreeNeRFChain(chain);
+   FREELIST(pdb_in,PDB);
+   chain = NULL;
+}
+
+/* Set some non-trivial torsions */
+static void set_torsions(NERFCHAIN *c)
+{
+   int r;
+
+   for(r=0; r<c->nres; r++)
+   {
+      NERFDOF(c, r, NERF_PHI)   = -1.0 + 0.05 * r;
+      NERFDOF(c, r, NERF_PSI)   = -0.8 + 0.02 * r;
+      NERFDOF(c, r, NERF_OMEGA) = 3.1;
+      NERFDOF(c, r, NERF_CHI1) += 0.3;
+   }
+}
+
+/* Distance between two atoms of the chain */
+static REAL atom_dist(int i, int j)
+{
+   return(sqrt((chain->x[i] - chain->x[j]) * (chain->x[i] - chain->x[j]) +
+               (chain->y[i] - chain->y[j]) * (chain->y[i] - chain->y[j]) +
+               (chain->z[i] - chain->z[j]) * (chain->z[i] - chain->z[j])));
+}
+
+/* Torsion between four atoms of the chain */
+static REAL atom_torsion(int a, int b, int c, int d)
+{
+   return(blPhi(chain->x[a], chain->y[a], chain->z[a],
+                chain->x[b], chain->y[b], chain->z[b],
+                chain->x[c], chain->y[c], chain->z[c],
+                chain->x[d], chain->y[d], chain->z[d]));
+}
+
+/* Data Read Tests */
+START_TEST(test_create_01)
+{
+   ck_assert_msg(pdb_in != NULL, "No data read from test file.");
+   ck_assert_msg(chain != NULL, "No chain created.");
+   ck_assert_int_eq(chain->nres, 20);
+   ck_assert_int_eq(chain->natoms, 167);
+
+   /* Cys (residue 1) has N, CA, C, O, CB, SG and one chi angle */
+   ck_assert_int_eq(chain->resFirst[2] - chain->resFirst[1], 6);
+   ck_assert_str_eq(chain->resnam[1], "CYS ");
+   ck_assert_str_eq(chain->atnam[chain->resFirst[1]+5], "SG  ");
+   ck_assert(chain->dofAtom[1*NERF_NDOF + NERF_CHI1] ==
+             chain->resFirst[1]+5);
+   ck_assert(chain->dofAtom[1*NERF_NDOF + NERF_CHI1 + 1] < 0);
+
+   /* Lys has 4 chi angles, Pro and Phe ring atoms have none */
+   ck_assert(chain->dofAtom[8*NERF_NDOF + NERF_CHI1 + 3] >= 0);
+   ck_assert(chain->dofAtom[12*NERF_NDOF + NERF_CHI1] < 0);
+   ck_assert(chain->dofAtom[4*NERF_NDOF + NERF_CHI1 + 1] >= 0);
+   ck_assert(chain->dofAtom[4*NERF_NDOF + NERF_CHI1 + 2] < 0);
+}
+END_TEST
+
+
+/* Core tests */
+START_TEST(test_build_01)
+{
+   int  r, n, ca, c, nn;
+
+   set_torsions(chain);
+   blBuildNeRFChain(chain, 0);
+
+   for(r=0; r<chain->nres-1; r++)
+   {
+      n  = chain->resFirst[r];
+      ca = n + 1;
+      c  = n + 2;
+      nn = chain->resFirst[r+1];
+
+      /* Ideal bond lengths */
+      ck_assert(fabs(atom_dist(n, ca)  - 1.458) < TOLERANCE);
+      ck_assert(fabs(atom_dist(ca, c)  - 1.525) < TOLERANCE);
+      ck_assert(fabs(atom_dist(c, nn)  - 1.329) < TOLERANCE);
+      ck_assert(fabs(atom_dist(c, n+3) - 1.231) < TOLERANCE);
+
+      /* Torsions as set */
+      ck_assert(fabs(atom_torsion(n, ca, c, nn) -
+                     NERFDOF(chain, r, NERF_PSI)) < TOLERANCE);
+      ck_assert(fabs(atom_torsion(ca, c, nn, nn+1) -
+                     NERFDOF(chain, r, NERF_OMEGA)) < TOLERANCE);
+      if(r > 0)
+      {
+         ck_assert(fabs(atom_torsion(chain->resFirst[r-1]+2, n, ca, c) -
+                        NERFDOF(chain, r, NERF_PHI)) < TOLERANCE);
+      }
+   }
+}
+END_TEST
+
+START_TEST(test_extract_01)
+{
+   REAL saved[20*NERF_NDOF];
+   int  d;
+
+   set_torsions(chain);
+   blBuildNeRFChain(chain, 0);
+   for(d=0; d<chain->nres*NERF_NDOF; d++)
+      saved[d] = chain->dofs[d];
+
+   for(d=0; d<chain->nres*NERF_NDOF; d++)
+      chain->dofs[d] = 0.0;
+   blExtractNeRFTorsions(chain);
+
+   for(d=0; d<chain->nres*NERF_NDOF; d++)
+   {
+      if(chain->dofAtom[d] >= 0)
+         ck_assert(fabs(chain->dofs[d] - saved[d]) < TOLERANCE);
+   }
+}
+END_TEST
+
+START_TEST(test_rebuild_01)
+{
+   REAL x[167], y[167], z[167];
+   int  i;
+
+   /* Rebuilding from residue 12 gives the same as a full build */
+   set_torsions(chain);
+   blBuildNeRFChain(chain, 0);
+   NERFDOF(chain, 12, NERF_PSI)      = 2.0;
+   NERFDOF(chain, 15, NERF_CHI1 + 1) = 1.0;
+   blBuildNeRFChain(chain, 12);
+   for(i=0; i<chain->natoms; i++)
+   {
+      x[i] = chain->x[i];
+      y[i] = chain->y[i];
+      z[i] = chain->z[i];
+   }
+
+   blBuildNeRFChain(chain, 0);
+   for(i=0; i<chain->natoms; i++)
+   {
+      ck_assert(fabs(x[i] - chain->x[i]) < TOLERANCE);
+      ck_assert(fabs(y[i] - chain->y[i]) < TOLERANCE);
+      ck_assert(fabs(z[i] - chain->z[i]) < TOLERANCE);
+   }
+}
+END_TEST
+
+START_TEST(test_pdb_01)
+{
+   NERFCHAIN *deca;
+   PDB       *pdb, *p;
+   int       natoms = 0;
+
+   deca = blCreateNeRFChainPDB(pdb_in, TEST_REF_FILE);
+   ck_assert(deca != NULL);
+   ck_assert_int_eq(deca->nres, 10);
+   ck_assert_int_eq(deca->natoms, 50);
+   ck_assert(deca->anchored);
+
+   /* Torsions match the structure: psi of residue 2 */
+   ck_assert(fabs(NERFDOF(deca, 1, NERF_PSI) -
+                  blPhi(pdb_in->next->next->next->next->next->x,
+                        pdb_in->next->next->next->next->next->y,
+                        pdb_in->next->next->next->next->next->z,
+                        deca->x[6], deca->y[6], deca->z[6],
+                        deca->x[7], deca->y[7], deca->z[7],
+                        deca->x[10], deca->y[10], deca->z[10]))
+             < TOLERANCE);
+
+   /* The anchored first residue stays in place */
+   blBuildNeRFChain(deca, 0);
+   ck_assert(fabs(deca->x[1] - pdb_in->next->x) < TOLERANCE);
+   ck_assert(fabs(deca->z[2] - pdb_in->next->next->next->z) < TOLERANCE);
+
+   pdb = blNeRFChainToPDB(deca, "A");
+   for(p=pdb; p!=NULL; NEXT(p))
+      natoms++;
+   ck_assert_int_eq(natoms, 50);
+   ck_assert_str_eq(pdb->next->atnam, "CA  ");
+   ck_assert_str_eq(pdb->next->atnam_raw, " CA ");
+   ck_assert_str_eq(pdb->resnam, "ALA ");
+   ck_assert_int_eq(pdb->next->next->next->next->next->resnum, 2);
+
+   FREELIST(pdb, PDB);
+   blFreeNeRFChain(deca);
+}
+END_TEST
+
+
+/* Error tests */
+START_TEST(test_error_01)
+{
+   ck_assert(blCreateNeRFChain(TEST_SEQUENCE, "nonexistent_coor")
+             == NULL);
+   ck_assert(blCreateNeRFChain("", TEST_REF_FILE) == NULL);
+
+   /* Wrong number of residues */
+   ck_assert(!blSetNeRFChainFromPDB(chain, pdb_in));
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *nerf_suite(void)
+{
+   Suite *s        = suite_create("NeRF");
+   TCase *tc_read  = tcase_create("Create");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Check chain creation */
+   tcase_add_checked_fixture(tc_read, nerf_setup, nerf_teardown);
+   tcase_add_test(tc_read, test_create_01);
+   suite_add_tcase(s, tc_read);   
+   
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, nerf_setup, nerf_teardown);
+   tcase_add_test(tc_core, test_build_01);
+   tcase_add_test(tc_core, test_extract_01);
+   tcase_add_test(tc_core, test_rebuild_01);
+   tcase_add_test(tc_core, test_pdb_01);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, nerf_setup, nerf_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
@@ -0,0 +1,455 @@
+/************************************************************************/
+/**
+
+   \file       pdbcompact_suite.c
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Test suite for compact atom storage.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for compact atom storage. A PDB linked list with
+   alternate locations, insert codes, charges, HETATMs and CONECTs is
+   converted to a PDBCOMPACT and back, and every kept field is
+   compared with the original. The geometry and sequence routines are
+   compared with their linked list equivalents.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+#include "pdbcompact_suite.h"
+
+/* Defines */
+#define TEST_PDB_FILE "./data/pdbcompact_suite/test_compact.pdb"
+#define NATOMS        24       /* Including alternate atoms             */
+#define NSTRINGS      5        /* Chains A, B, W plus ATOM and HETATM   */
+#define NCONECT       8        /* Both directions of the 4 zinc bonds   */
+#define EPS           0.0005   /* Single precision coordinates          */
+
+/* Globals */
+static WHOLEPDB   *wpdb = NULL;
+static PDBCOMPACT *cpdb = NULL;
+
+/* Setup And Teardown */
+static void pdbcompact_setup(void)
+{
+   FILE *fp;
+   
+   if((fp = fopen(TEST_PDB_FILE,"r")) == NULL)
+   {
+      fprintf(stderr, "Failed to open test pdb file!\n");
+      return;
+   }
+   /* All atoms so that alternates are kept, whole PDB for CONECTs     */
+   wpdb = blDoReadPDB(fp, TRUE, 0, 0, TRUE);
+   fclose(fp);
+   if(wpdb != NULL)
+      cpdb = blPDBToCompact(wpdb->pdb);
+}
+
+static void pdbcompact_teardown(void)
+{
+   blFreePDBCompact(cpdb);
+   cpdb = NULL;
+   if(wpdb != NULL)
+      blFreeWholePDB(wpdb);
+   wpdb = NULL;
+}
+
+/* Returns the position of an atom in a linked list                    */
+static int atom_index(PDB *pdb, PDB *atom)
+{
+   PDB *p;
+   int i;
+
+   for(p=pdb, i=0; p!=NULL; NEXT(p), i++)
+   {
+      if(p==atom)
+         return(i);
+   }
+   return(-1);
+}
+
+/* Checks the fields kept in compact storage are the same in two PDB
+   linked lists, including the CONECTs
+*/
+static void check_same_pdb(PDB *pdb1, PDB *pdb2)
+{
+   PDB *p, *q;
+   int j;
+
+   for(p=pdb1, q=pdb2; p!=NULL && q!=NULL; NEXT(p), NEXT(q))
+   {
+      ck_assert_str_eq(p->record_type, q->record_type);
+      ck_assert_int_eq(p->atnum,       q->atnum);
+      ck_assert_str_eq(p->atnam,       q->atnam);
+      ck_assert_str_eq(p->atnam_raw,   q->atnam_raw);
+      ck_assert_str_eq(p->resnam,      q->resnam);
+      ck_assert_str_eq(p->chain,       q->chain);
+      ck_assert_int_eq(p->resnum,      q->resnum);
+      ck_assert_str_eq(p->insert,      q->insert);
+      ck_assert_str_eq(p->segid,       q->segid);
+      ck_assert_str_eq(p->element,     q->element);
+      ck_assert_int_eq(p->altpos,      q->altpos);
+      ck_assert_int_eq(p->secstr,      q->secstr);
+      ck_assert_int_eq(p->formal_charge, q->formal_charge);
+      ck_assert(ABS(p->x    - q->x)    < EPS);
+      ck_assert(ABS(p->y    - q->y)    < EPS);
+      ck_assert(ABS(p->z    - q->z)    < EPS);
+      ck_assert(ABS(p->occ  - q->occ)  < EPS);
+      ck_assert(ABS(p->bval - q->bval) < EPS);
+
+      ck_assert_int_eq(p->nConect, q->nConect);
+      for(j=0; j<p->nConect; j++)
+      {
+         ck_assert_int_eq(atom_index(pdb1, p->conect[j]),
+                          atom_index(pdb2, q->conect[j]));
+      }
+   }
+   ck_assert(p == NULL);
+   ck_assert(q == NULL);
+}
+
+/* Core tests */
+/* Every atom of the compact structure against the linked list, using
+   the string table and CONECT lookup macros
+*/
+START_TEST(test_compact_01)
+{
+   PDB      *p;
+   PDBATOMC *a;
+   char     atnam[5], atnam_raw[5], resnam[5], segid[5], element[3];
+   int      i;
+
+   ck_assert(cpdb != NULL);
+   ck_assert_int_eq(cpdb->natoms,   NATOMS);
+   ck_assert_int_eq(cpdb->nstrings, NSTRINGS);
+
+   for(p=wpdb->pdb, i=0; p!=NULL; NEXT(p), i++)
+   {
+      a = cpdb->atoms + i;
+      PDBC_UNPACK(atnam,     a->atnam);
+      PDBC_UNPACK(atnam_raw, a->atnam_raw);
+      PDBC_UNPACK(resnam,    a->resnam);
+      PDBC_UNPACK(segid,     a->segid);
+      PDBC_UNPACK(element,   a->element);
+
+      ck_assert_str_eq(PDBC_RECORDTYPE(cpdb, i), p->record_type);
+      ck_assert_str_eq(PDBC_CHAIN(cpdb, i),      p->chain);
+      ck_assert_str_eq(atnam,     p->atnam);
+      ck_assert_str_eq(atnam_raw, p->atnam_raw);
+      ck_assert_str_eq(resnam,    p->resnam);
+      ck_assert_str_eq(segid,     p->segid);
+      ck_assert_str_eq(element,   p->element);
+      ck_assert_int_eq(a->atnum,  p->atnum);
+      ck_assert_int_eq(a->resnum, p->resnum);
+      ck_assert_int_eq(a->insert, p->insert[0]);
+      ck_assert_int_eq(a->altpos, p->altpos);
+      ck_assert_int_eq(a->formal_charge, p->formal_charge);
+      ck_assert(ABS(a->x    - p->x)    < EPS);
+      ck_assert(ABS(a->occ  - p->occ)  < EPS);
+      ck_assert(ABS(a->bval - p->bval) < EPS);
+      ck_assert_int_eq(PDBC_NCONECT(cpdb, i), p->nConect);
+   }
+   ck_assert_int_eq(i, NATOMS);
+}
+END_TEST
+
+/* The fields that matter in the test file have the expected values    */
+START_TEST(test_compact_02)
+{
+   char element[3];
+   
+   ck_assert(cpdb != NULL);
+
+   /* SER A2 CB alternate B                                            */
+   ck_assert_int_eq(cpdb->atoms[10].altpos, 'B');
+   ck_assert(ABS(cpdb->atoms[10].occ - 0.35) < EPS);
+   
+   /* GLY A2A                                                          */
+   ck_assert_int_eq(cpdb->atoms[13].insert, 'A');
+   ck_assert_int_eq(cpdb->atoms[16].formal_charge, -1);
+
+   /* Zinc has a two-character element and shares chain B             */
+   PDBC_UNPACK(element, cpdb->atoms[22].element);
+   ck_assert_str_eq(element, "ZN");
+   ck_assert_int_eq(cpdb->atoms[22].formal_charge, 2);
+   ck_assert_str_eq(PDBC_RECORDTYPE(cpdb, 22), "HETATM");
+   ck_assert_int_eq(cpdb->atoms[22].chain, cpdb->atoms[17].chain);
+}
+END_TEST
+
+/* CONECTs in compressed sparse row form                               */
+START_TEST(test_conect_01)
+{
+   PDB *p;
+   int i, j, k;
+
+   ck_assert(cpdb != NULL);
+   ck_assert(cpdb->conectStart != NULL);
+   ck_assert_int_eq(cpdb->conectStart[0], 0);
+   ck_assert_int_eq(cpdb->conectStart[cpdb->natoms], NCONECT);
+
+   for(p=wpdb->pdb, i=0; p!=NULL; NEXT(p), i++)
+   {
+      for(j=0, k=cpdb->conectStart[i]; j<PDBC_NCONECT(cpdb, i); j++, k++)
+      {
+         ck_assert_int_eq(cpdb->conect[k], 
+                          atom_index(wpdb->pdb, p->conect[j]));
+      }
+   }
+
+   /* Zinc is bonded to SER O, SER OG (alternate A), GLY O and LYS NZ  */
+   ck_assert_int_eq(PDBC_NCONECT(cpdb, 22), 4);
+   k = cpdb->conectStart[22];
+   ck_assert_int_eq(cpdb->conect[k],   8);
+   ck_assert_int_eq(cpdb->conect[k+1], 11);
+   ck_assert_int_eq(cpdb->conect[k+2], 16);
+   ck_assert_int_eq(cpdb->conect[k+3], 21);
+}
+END_TEST
+
+/* Round trip to a linked list and back again                          */
+START_TEST(test_roundtrip_01)
+{
+   PDB        *pdb;
+   PDBCOMPACT *cpdb2;
+   PDBATOMC   *a, *b;
+   int        i;
+
+   ck_assert(cpdb != NULL);
+   pdb = blCompactToPDB(cpdb);
+   ck_assert(pdb != NULL);
+   check_same_pdb(wpdb->pdb, pdb);
+
+   cpdb2 = blPDBToCompact(pdb);
+   ck_assert(cpdb2 != NULL);
+   ck_assert_int_eq(cpdb2->natoms,   cpdb->natoms);
+   ck_assert_int_eq(cpdb2->nstrings, cpdb->nstrings);
+   for(i=0; i<cpdb->natoms; i++)
+   {
+      a = cpdb->atoms  + i;
+      b = cpdb2->atoms + i;
+      ck_assert(a->x == b->x && a->y == b->y && a->z == b->z);
+      ck_assert(a->occ == b->occ && a->bval == b->bval);
+      ck_assert_int_eq(a->atnum,  b->atnum);
+      ck_assert_int_eq(a->resnum, b->resnum);
+      ck_assert_int_eq(a->chain,  b->chain);
+      ck_assert_int_eq(a->record_type, b->record_type);
+      ck_assert(!memcmp(a->atnam,     b->atnam,     4));
+      ck_assert(!memcmp(a->atnam_raw, b->atnam_raw, 4));
+      ck_assert(!memcmp(a->resnam,    b->resnam,    4));
+      ck_assert(!memcmp(a->segid,     b->segid,     4));
+      ck_assert(!memcmp(a->element,   b->element,   2));
+      ck_assert_int_eq(a->insert, b->insert);
+      ck_assert_int_eq(a->altpos, b->altpos);
+      ck_assert_int_eq(a->secstr, b->secstr);
+      ck_assert_int_eq(a->formal_charge, b->formal_charge);
+   }
+   ck_assert(!memcmp(cpdb2->conectStart, cpdb->conectStart,
+                     (cpdb->natoms+1) * sizeof(int)));
+   ck_assert(!memcmp(cpdb2->conect, cpdb->conect, NCONECT * sizeof(int)));
+
+   blFreePDBCompact(cpdb2);
+   FREELIST(pdb, PDB);
+}
+END_TEST
+
+/* Reading straight into compact storage drops alternates and CONECTs
+   as blReadPDB() does
+*/
+START_TEST(test_roundtrip_02)
+{
+   FILE       *fp;
+   PDB        *pdb, *pdb2;
+   PDBCOMPACT *cpdb2;
+   int        natoms, natoms2;
+
+   ck_assert((fp = fopen(TEST_PDB_FILE,"r")) != NULL);
+   cpdb2 = blReadPDBCompact(fp, &natoms2);
+   rewind(fp);
+   pdb = blReadPDB(fp, &natoms);
+   fclose(fp);
+
+   ck_assert(cpdb2 != NULL);
+   ck_assert(pdb   != NULL);
+   ck_assert_int_eq(natoms2, natoms);
+   ck_assert_int_eq(cpdb2->natoms, natoms);
+   ck_assert(cpdb2->conectStart == NULL);
+   ck_assert_int_eq(PDBC_NCONECT(cpdb2, 0), 0);
+
+   pdb2 = blCompactToPDB(cpdb2);
+   check_same_pdb(pdb, pdb2);
+
+   FREELIST(pdb2, PDB);
+   FREELIST(pdb,  PDB);
+   blFreePDBCompact(cpdb2);
+}
+END_TEST
+
+/* An empty list                                                       */
+START_TEST(test_roundtrip_03)
+{
+   PDBCOMPACT *cpdb2;
+
+   cpdb2 = blPDBToCompact(NULL);
+   ck_assert(cpdb2 != NULL);
+   ck_assert_int_eq(cpdb2->natoms, 0);
+   ck_assert(cpdb2->conectStart == NULL);
+   ck_assert(blCompactToPDB(cpdb2) == NULL);
+   blFreePDBCompact(cpdb2);
+}
+END_TEST
+
+/* Sequence from the compact structure as a string and by chain        */
+START_TEST(test_sequence_01)
+{
+   HASHTABLE *hash, *refHash;
+   char      *seq, *refSeq, **chains;
+   int       i;
+
+   ck_assert(cpdb != NULL);
+   seq    = blDoPDB2SeqCompact(cpdb, FALSE, FALSE, FALSE);
+   refSeq = blDoPDB2Seq(wpdb->pdb, FALSE, FALSE, FALSE);
+   ck_assert(seq != NULL);
+   ck_assert_str_eq(seq, refSeq);
+   free(seq);
+   free(refSeq);
+
+   hash    = blDoPDB2SeqByChainCompact(cpdb, FALSE, TRUE, FALSE);
+   refHash = blDoPDB2SeqByChain(wpdb->pdb, FALSE, TRUE, FALSE);
+   ck_assert(hash != NULL);
+   ck_assert((chains = blGetHashKeyList(refHash)) != NULL);
+   for(i=0; chains[i]!=NULL; i++)
+   {
+      ck_assert(blHashKeyDefined(hash, chains[i]));
+      ck_assert_str_eq(blGetHashValueString(hash, chains[i]),
+                       blGetHashValueString(refHash, chains[i]));
+   }
+   ck_assert_str_eq(blGetHashValueString(hash, "A"), "ASG");
+   ck_assert_str_eq(blGetHashValueString(hash, "B"), "K");
+
+   blFreeHashKeyList(chains);
+   blFreeHash(hash);
+   blFreeHash(refHash);
+}
+END_TEST
+
+/* Centre of geometry, translation and fitting                         */
+START_TEST(test_geometry_01)
+{
+   PDBCOMPACT *cpdb2;
+   PDB        *pdb;
+   VEC3F      cg, refCg, tvect;
+   REAL       rm[3][3];
+   
+   ck_assert(cpdb != NULL);
+   blGetCofGPDBCompact(cpdb, &cg);
+   blGetCofGPDB(wpdb->pdb, &refCg);
+   ck_assert(ABS(cg.x - refCg.x) < EPS);
+   ck_assert(ABS(cg.y - refCg.y) < EPS);
+   ck_assert(ABS(cg.z - refCg.z) < EPS);
+
+   pdb   = blCompactToPDB(cpdb);
+   cpdb2 = blPDBToCompact(pdb);
+   ck_assert(blCalcRMSPDBCompact(cpdb, cpdb2) < EPS);
+
+   tvect.x = 10.0;
+   tvect.y = -5.0;
+   tvect.z = 2.5;
+   blTranslatePDBCompact(cpdb2, tvect);
+   ck_assert(ABS(cpdb2->atoms[0].x - (cpdb->atoms[0].x + 10.0)) < EPS);
+   ck_assert(ABS(blCalcRMSPDBCompact(cpdb, cpdb2) - sqrt(131.25)) < EPS);
+
+   ck_assert(blFitPDBCompact(cpdb, cpdb2, rm));
+   ck_assert(blCalcRMSPDBCompact(cpdb, cpdb2) < 0.001);
+
+   blFreePDBCompact(cpdb2);
+   FREELIST(pdb, PDB);
+}
+END_TEST
+
+/* Compact storage is smaller than the linked list                     */
+START_TEST(test_memory_01)
+{
+   ck_assert(cpdb != NULL);
+   ck_assert(blPDBCompactMemory(cpdb) > 0);
+   ck_assert(blPDBCompactMemory(cpdb) < blPDBMemory(wpdb->pdb));
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *pdbcompact_suite(void)
+{
+   Suite *s       = suite_create("PDBCompact");
+   TCase *tc_core = tcase_create("Core");
+   TCase *tc_trip = tcase_create("RoundTrip");
+   TCase *tc_use  = tcase_create("Routines");
+
+
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, pdbcompact_setup, 
+                             pdbcompact_teardown);
+   tcase_add_test(tc_core, test_compact_01);
+   tcase_add_test(tc_core, test_compact_02);
+   tcase_add_test(tc_core, test_conect_01);
+   suite_add_tcase(s, tc_core);
+
+   /* Round trip test case */
+   tcase_add_checked_fixture(tc_trip, pdbcompact_setup, 
+                             pdbcompact_teardown);
+   tcase_add_test(tc_trip, test_roundtrip_01);
+   tcase_add_test(tc_trip, test_roundtrip_02);
+   tcase_add_test(tc_trip, test_roundtrip_03);
+   suite_add_tcase(s, tc_trip);
+
+   /* Geometry and sequence test case */
+   tcase_add_checked_fixture(tc_use, pdbcompact_setup, 
+                             pdbcompact_teardown);
+   tcase_add_test(tc_use, test_sequence_01);
+   tcase_add_test(tc_use, test_geometry_01);
+   tcase_add_test(tc_use, test_memory_01);
+   suite_add_tcase(s, tc_use);
+
+
+   return(s);
+}
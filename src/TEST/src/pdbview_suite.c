@@ -0,0 +1,434 @@
+/************************************************************************/
+/**
+
+   \file       pdbview_suite.c
+   
+   \version    V1.2
+   \date       17.10.26
+   \brief      Test suite for PDB views.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for zero-copy views onto PDB linked lists. Each view is
+   compared with the linked list built by the equivalent AsCopy
+   routine.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+#include "pdbview_suite.h"
+
+/* Defines */
+#define TEST_PDB_FILE "./data/pdbview_suite/test_view.pdb"
+#define NATOMS        332
+#define NCHAINA       171      /* Chain A includes two hydrogens        */
+#define NCHAINB       158
+
+/* Globals */
+static PDB *pdb = NULL;
+
+/* Setup And Teardown */
+static void pdbview_setup(void)
+{
+   FILE *fp;
+   int  natoms;
+   
+   if((fp = fopen(TEST_PDB_FILE,"r")) == NULL)
+   {
+      fprintf(stderr, "Failed to open test pdb file!\n");
+      return;
+   }
+   pdb = blReadPDB(fp, &natoms);
+   fclose(fp);
+}
+
+static void pdbview_teardown(void)
+{
+   FREELIST(pdb, PDB);
+}
+
+/* Checks that a view holds the same atoms, in the same order, as a
+   linked list made by an AsCopy routine
+*/
+static void check_same_atoms(PDBVIEW *view, PDB *copy)
+{
+   PDB *p, *q;
+   int i, ncopy = 0;
+
+   ck_assert(view != NULL);
+   ck_assert(blCheckPDBView(view));
+   for(q=copy; q!=NULL; NEXT(q))
+      ncopy++;
+   ck_assert_int_eq(view->natoms, ncopy);
+
+   for(p=PDBVIEW_FIRST(view, i), q=copy;
+       p!=NULL && q!=NULL;
+       p=PDBVIEW_NEXT(view, p, i), NEXT(q))
+   {
+      ck_assert(p != q);
+      ck_assert_int_eq(p->atnum,  q->atnum);
+      ck_assert_int_eq(p->resnum, q->resnum);
+      ck_assert_str_eq(p->chain,  q->chain);
+      ck_assert_str_eq(p->insert, q->insert);
+      ck_assert_str_eq(p->atnam,  q->atnam);
+      ck_assert(p->x == q->x);
+   }
+   ck_assert(p == NULL);
+   ck_assert(q == NULL);
+}
+
+/* Checks a zone view against blExtractZonePDBAsCopy() and, where the
+   end residues exist, against blFindResidue()
+*/
+static void check_zone(char *chain1, int resnum1, char *insert1,
+                       char *chain2, int resnum2, char *insert2)
+{
+   PDBVIEW *view;
+   PDB     *copy, *res;
+
+   view = blExtractZonePDBView(pdb, chain1, resnum1, insert1,
+                               chain2, resnum2, insert2);
+   copy = blExtractZonePDBAsCopy(pdb, chain1, resnum1, insert1,
+                                 chain2, resnum2, insert2);
+   ck_assert(copy != NULL);
+   check_same_atoms(view, copy);
+
+   if((res = blFindResidue(pdb, chain1, resnum1, insert1)) != NULL)
+      ck_assert(view->atoms[0] == res);
+   if((res = blFindResidue(pdb, chain2, resnum2, insert2)) != NULL)
+      ck_assert(view->atoms[view->natoms-1]->next == 
+                blFindNextResidue(res));
+
+   FREELIST(copy, PDB);
+   blFreePDBView(view);
+
+   view = blExtractNotZonePDBView(pdb, chain1, resnum1, insert1,
+                                  chain2, resnum2, insert2);
+   copy = blExtractNotZonePDBAsCopy(pdb, chain1, resnum1, insert1,
+                                    chain2, resnum2, insert2);
+
+   /* Both need the end residues to exist                              */
+   if(copy == NULL)
+   {
+      ck_assert(view == NULL);
+   }
+   else
+   {
+      check_same_atoms(view, copy);
+      FREELIST(copy, PDB);
+      blFreePDBView(view);
+   }
+}
+
+
+/* Core Tests */
+START_TEST(test_whole_01)
+{
+   PDBVIEW view;
+   PDB     *p;
+   int     i, n = 0;
+
+   ck_assert(pdb != NULL);
+   blInitPDBView(&view, pdb);
+   ck_assert_int_eq(view.natoms, NATOMS);
+   ck_assert(view.atoms == NULL);
+   ck_assert(blCheckPDBView(&view));
+
+   for(p=PDBVIEW_FIRST(&view, i); p!=NULL; p=PDBVIEW_NEXT(&view, p, i))
+   {
+      ck_assert_int_eq(i, n);
+      n++;
+   }
+   ck_assert_int_eq(n, NATOMS);
+}
+END_TEST
+
+START_TEST(test_chain_01)
+{
+   PDBVIEW *view;
+   PDB     *copy;
+
+   ck_assert(pdb != NULL);
+   view = blGetPDBChainView(pdb, "A");
+   copy = blGetPDBChainAsCopy(pdb, "A");
+   check_same_atoms(view, copy);
+   ck_assert_int_eq(view->natoms, NCHAINA);
+   FREELIST(copy, PDB);
+   blFreePDBView(view);
+
+   view = blGetPDBChainView(pdb, "B");
+   copy = blGetPDBChainAsCopy(pdb, "B");
+   check_same_atoms(view, copy);
+   ck_assert_int_eq(view->natoms, NCHAINB);
+   FREELIST(copy, PDB);
+   blFreePDBView(view);
+
+   /* A missing chain gives an empty view                              */
+   view = blGetPDBChainView(pdb, "Z");
+   ck_assert(view != NULL);
+   ck_assert_int_eq(view->natoms, 0);
+   ck_assert(blCheckPDBView(view));
+   blFreePDBView(view);
+}
+END_TEST
+
+START_TEST(test_zone_01)
+{
+   ck_assert(pdb != NULL);
+
+   /* Within a chain, across chains and to an insert                   */
+   check_zone("A",  5, " ", "A", 15, " ");
+   check_zone("A",  1, " ", "A",  1, " ");
+   check_zone("A", 20, " ", "B", 26, " ");
+   check_zone("B", 29, " ", "B", 29, "A");
+   check_zone("B", 29, "A", "B", 46, " ");
+}
+END_TEST
+
+START_TEST(test_zone_02)
+{
+   ck_assert(pdb != NULL);
+
+   /* Residue B30 does not exist (it is numbered B29A) and A50 is
+      beyond the end of chain A
+   */
+   ck_assert(blFindResidue(pdb, "B", 30, " ") == NULL);
+   check_zone("B", 30, " ", "B", 35, " ");
+   check_zone("A", 10, " ", "A", 50, " ");
+}
+END_TEST
+
+START_TEST(test_select_01)
+{
+   PDBVIEW *view;
+   PDB     *copy;
+   char    *sel[2];
+   int     natoms;
+
+   ck_assert(pdb != NULL);
+
+   sel[0] = "CA  ";
+   sel[1] = "CB  ";
+   view = blSelectAtomsPDBView(pdb, 2, sel);
+   copy = blSelectAtomsPDBAsCopy(pdb, 2, sel, &natoms);
+   check_same_atoms(view, copy);
+   ck_assert_int_eq(view->natoms, natoms);
+   FREELIST(copy, PDB);
+   blFreePDBView(view);
+
+   view = blStripHPDBView(pdb);
+   copy = blStripHPDBAsCopy(pdb, &natoms);
+   check_same_atoms(view, copy);
+   ck_assert_int_eq(view->natoms, NATOMS-2);
+   FREELIST(copy, PDB);
+   blFreePDBView(view);
+
+   view = blStripWatersPDBView(pdb);
+   copy = blStripWatersPDBAsCopy(pdb, &natoms);
+   check_same_atoms(view, copy);
+   ck_assert_int_eq(view->natoms, NATOMS-3);
+   FREELIST(copy, PDB);
+   blFreePDBView(view);
+}
+END_TEST
+
+START_TEST(test_select_02)
+{
+   PDBVIEW *view, *ca;
+   PDB     *copy;
+   int     i;
+
+   ck_assert(pdb != NULL);
+
+   /* An expression view matches the chain and CA views combined       */
+   view = blCreatePDBViewExpression(pdb, "chain B and name CA");
+   ca   = blSelectCaPDBView(pdb);
+   ck_assert(view != NULL);
+   ck_assert(ca != NULL);
+   ck_assert_int_eq(ca->natoms, 46);
+   ck_assert_int_eq(view->natoms, 23);
+   for(i=0; i<view->natoms; i++)
+      ck_assert(view->atoms[i] == ca->atoms[23+i]);
+
+   /* and can be made into a real list                                 */
+   copy = blPDBViewAsCopy(view);
+   check_same_atoms(view, copy);
+   FREELIST(copy, PDB);
+   blFreePDBView(view);
+   blFreePDBView(ca);
+
+   /* The residue B29A is found by its insert code                     */
+   view = blCreatePDBViewExpression(pdb, "resid B29A");
+   ck_assert(view != NULL);
+   ck_assert_int_eq(view->natoms, 7);
+   ck_assert(view->atoms[0] == blFindResidue(pdb, "B", 29, "A"));
+   blFreePDBView(view);
+}
+END_TEST
+
+START_TEST(test_valid_01)
+{
+   PDBVIEW *view;
+   PDB     *p, *prev;
+   VEC3F   cg1, cg2;
+
+   ck_assert(pdb != NULL);
+   view = blSelectCaPDBView(pdb);
+   ck_assert(blCheckPDBView(view));
+
+   /* Changing coordinates does not invalidate a view and the view sees
+      the new coordinates
+   */
+   blGetCofGPDBView(view, &cg1);
+   for(p=pdb; p!=NULL; NEXT(p))
+      p->x += 10.0;
+   blGetCofGPDBView(view, &cg2);
+   ck_assert(blCheckPDBView(view));
+   ck_assert(fabs(cg2.x - cg1.x - 10.0) < 0.0001);
+
+   /* Removing an atom that is not in the view leaves it valid         */
+   prev = pdb;
+   p    = pdb->next;                         /* THR A1 CA               */
+   ck_assert(view->atoms[0] == p);
+   prev = p;
+   p    = p->next;                           /* THR A1 HA               */
+   prev->next = p->next;
+   free(p);
+   ck_assert(blCheckPDBView(view));
+
+   /* Removing one that is in the view invalidates it                  */
+   p = pdb->next;
+   pdb->next = p->next;
+   free(p);
+   ck_assert(!blCheckPDBView(view));
+
+   blFreePDBView(view);
+}
+END_TEST
+
+START_TEST(test_valid_02)
+{
+   PDBVIEW view,
+           *zone;
+   PDB     *p, *q, *r;
+
+   ck_assert(pdb != NULL);
+
+   /* Relinking atoms within a view out of order invalidates it         */
+   zone = blExtractZonePDBView(pdb, "A", 1, " ", "A", 2, " ");
+   ck_assert(blCheckPDBView(zone));
+   p = pdb;
+   q = p->next;
+   r = q->next;
+   pdb     = q;
+   q->next = p;
+   p->next = r;
+   ck_assert(!blCheckPDBView(zone));
+
+   /* Restoring the order makes it valid again                         */
+   pdb     = p;
+   p->next = q;
+   q->next = r;
+   ck_assert(blCheckPDBView(zone));
+   blFreePDBView(zone);
+
+   /* A whole-list view becomes invalid when an atom is added          */
+   blInitPDBView(&view, pdb);
+   ck_assert(blCheckPDBView(&view));
+   for(p=pdb; p->next!=NULL; NEXT(p));
+   ALLOCNEXT(p, PDB);
+   ck_assert(p != NULL);
+   blCopyPDB(p, pdb);
+   ck_assert(!blCheckPDBView(&view));
+   blInitPDBView(&view, pdb);
+   ck_assert_int_eq(view.natoms, NATOMS+1);
+   ck_assert(blCheckPDBView(&view));
+}
+END_TEST
+
+
+/* Error Tests */
+START_TEST(test_error_01)
+{
+   PDBVIEW *view;
+   
+   ck_assert(pdb != NULL);
+
+   /* A zone starting after the end of its chain                       */
+   view = blExtractZonePDBView(pdb, "B", 99, " ", "B", 100, " ");
+   ck_assert(view == NULL);
+
+   /* A bad expression                                                 */
+   view = blCreatePDBViewExpression(pdb, "name CA and");
+   ck_assert(view == NULL);
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *pdbview_suite(void)
+{
+   Suite *s        = suite_create("PDBView");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, pdbview_setup, 
+                             pdbview_teardown);
+   tcase_add_test(tc_core, test_whole_01);
+   tcase_add_test(tc_core, test_chain_01);
+   tcase_add_test(tc_core, test_zone_01);
+   tcase_add_test(tc_core, test_zone_02);
+   tcase_add_test(tc_core, test_select_01);
+   tcase_add_test(tc_core, test_select_02);
+   tcase_add_test(tc_core, test_valid_01);
+   tcase_add_test(tc_core, test_valid_02);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, pdbview_setup, 
+                             pdbview_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
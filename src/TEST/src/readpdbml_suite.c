@@ -3,8 +3,8 @@
 
    \file       readpdbml_suite.c
    
-   \version    V1.6
-   \date       29.07.15
+   \version    V1.9
+   \date       17.10.26
    \brief      Test suite for reading pdb and pdbml data from file.
 
    \copyright  (c) UCL / Dr. Andrew C. R. Martin 1993-2015
@@ -56,6 +56,10 @@
                   By: CTP
 -  V1.5  25.06.15 Catch bug where author residue number is 0.  By: CTP
 -  V1.6  29.07.15 Changed pdb->atomType to pdb->atomInfo  By: CTP 
+-  V1.7  17.10.26 Added tests of blDoReadPDBFiltered()  By: ACRM
+-  V1.8  17.10.26 Added tests of blDoReadPDBParallel()  By: ACRM
+-  V1.9  17.10.26 Added tests of blDoReadPDBFile() and 
+                  blDoReadPDBBuffer()  By: ACRM
 
 *************************************************************************/
 
@@ -66,6 +70,19 @@ PDB  *pdb;
 FILE  *fp;
 int   natoms = 0;
 
+/* Defines */
+#define MODELS_FILE "data/readpdbml_suite/test_models_alt.pdb"
+#define MAXOCCRANK  2
+#define MAXMODEL    2
+#define MAXTHREADS  16
+
+/* Atoms read from MODELS_FILE by OccRank and model. Rank 0 keeps all
+   the alternates and model 0 reads all 3 models.
+*/
+static int sModelsNAtoms[MAXOCCRANK+1][MAXMODEL+1] = {{183, 61, 61},
+                                                      {159, 53, 53},
+                                                      {159, 53, 53}};
+
 /* Setup And Teardown */
 void readpdbml_setup(void)
 {
@@ -79,6 +96,56 @@ void readpdbml_teardown(void)
    FREELIST(pdb, PDB);
 }
 
+/* Compares two PDB linked lists field by field                        */
+static void compare_pdb(PDB *pdb1, PDB *pdb2)
+{
+   PDB *p, *q;
+
+   for(p=pdb1, q=pdb2; p!=NULL && q!=NULL; NEXT(p), NEXT(q))
+   {
+      ck_assert_str_eq( p->record_type, q->record_type);
+      ck_assert(        p->atnum ==     q->atnum);
+      ck_assert_str_eq( p->atnam,       q->atnam);
+      ck_assert_str_eq( p->atnam_raw,   q->atnam_raw);
+      ck_assert(        p->altpos ==    q->altpos);
+      ck_assert_str_eq( p->resnam,      q->resnam);
+      ck_assert_str_eq( p->chain,       q->chain);
+      ck_assert(        p->resnum ==    q->resnum);
+      ck_assert_str_eq( p->insert,      q->insert);
+      ck_assert(        p->x ==         q->x);
+      ck_assert(        p->y ==         q->y);
+      ck_assert(        p->z ==         q->z);
+      ck_assert(        p->occ ==       q->occ);
+      ck_assert(        p->bval ==      q->bval);
+      ck_assert_str_eq( p->element,     q->element);
+   }
+   ck_assert(p == NULL);
+   ck_assert(q == NULL);
+}
+
+/* Reads the models file with blDoReadPDB() as a reference             */
+static WHOLEPDB *read_reference(int OccRank, int ModelNum)
+{
+   WHOLEPDB *wpdb;
+   
+   fp   = fopen(MODELS_FILE, "r");
+   ck_assert(fp != NULL);
+   wpdb = blDoReadPDB(fp, TRUE, OccRank, ModelNum, FALSE);
+   fclose(fp);
+   ck_assert(wpdb != NULL);
+
+   return(wpdb);
+}
+
+/* Compares two lists of header or trailer lines                       */
+static void compare_strings(STRINGLIST *s1, STRINGLIST *s2)
+{
+   for(; s1!=NULL && s2!=NULL; NEXT(s1), NEXT(s2))
+      ck_assert_str_eq(s1->string, s2->string);
+   ck_assert(s1 == NULL);
+   ck_assert(s2 == NULL);
+}
+
 /* Core tests */
 START_TEST(test_read_pdb)
 {
@@ -957,13 +1024,291 @@ START_TEST(test_read_pdbml_data_12)
 END_TEST
 
 
+/* Reader Tests */
+START_TEST(test_read_filtered_01)
+{
+   WHOLEPDB      *ref, *wpdb;
+   PDBREADFILTER filter;
+   int           OccRank, model;
+
+   /* With the default filter the results match blDoReadPDB() for
+      each occupancy rank and model (0 is all models)
+   */
+   for(OccRank=0; OccRank<=MAXOCCRANK; OccRank++)
+   {
+      for(model=0; model<=MAXMODEL; model++)
+      {
+         ref = read_reference(OccRank, model);
+         ck_assert_int_eq(ref->natoms, sModelsNAtoms[OccRank][model]);
+
+         blInitPDBReadFilter(&filter);
+         filter.modelNum = model;
+         fp   = fopen(MODELS_FILE, "r");
+         wpdb = blDoReadPDBFiltered(fp, OccRank, FALSE, &filter);
+         fclose(fp);
+
+         ck_assert(wpdb != NULL);
+         ck_assert_int_eq(wpdb->natoms, ref->natoms);
+         compare_pdb(wpdb->pdb, ref->pdb);
+         blFreeWholePDB(wpdb);
+         blFreeWholePDB(ref);
+      }
+   }
+}
+END_TEST
+
+START_TEST(test_read_filtered_02)
+{
+   WHOLEPDB      *ref, *wpdb;
+   PDBREADFILTER filter;
+   PDB           *p, *q, *prev;
+   char          *chains[] = {"A"},
+                 *atnams[] = {"CA  ", "CB  "};
+   int           n;
+
+   /* Read just the chain A CA and CB ATOM records of model 2          */
+   blInitPDBReadFilter(&filter);
+   filter.chains   = chains;
+   filter.nchains  = 1;
+   filter.atnams   = atnams;
+   filter.natnams  = 2;
+   filter.modelNum = 2;
+   filter.hetatms  = FALSE;
+
+   fp   = fopen(MODELS_FILE, "r");
+   wpdb = blDoReadPDBFiltered(fp, 1, FALSE, &filter);
+   fclose(fp);
+   ck_assert(wpdb != NULL);
+
+   /* Apply the same selection to the whole of model 2                 */
+   ref = read_reference(1, 2);
+   for(p=ref->pdb, prev=NULL, n=0; p!=NULL; p=q)
+   {
+      q = p->next;
+      if(strcmp(p->chain, "A") || strcmp(p->record_type, "ATOM  ") ||
+         (strncmp(p->atnam, "CA  ", 4) && strncmp(p->atnam, "CB  ", 4)))
+      {
+         if(prev == NULL)
+            ref->pdb = q;
+         else
+            prev->next = q;
+         free(p);
+      }
+      else
+      {
+         prev = p;
+         n++;
+      }
+   }
+
+   /* 6 residues with CA and CB                                        */
+   ck_assert_int_eq(n, 12);
+   ck_assert_int_eq(wpdb->natoms, n);
+   compare_pdb(wpdb->pdb, ref->pdb);
+
+   /* The higher occupancy CB was taken for A5                          */
+   for(p=wpdb->pdb; p!=NULL; NEXT(p))
+   {
+      if((p->resnum == 5) && !strncmp(p->atnam, "CB  ", 4))
+         ck_assert(p->occ == (REAL)0.70);
+   }
+
+   blFreeWholePDB(wpdb);
+   blFreeWholePDB(ref);
+}
+END_TEST
+
+START_TEST(test_read_parallel_01)
+{
+   WHOLEPDB *ref, *wpdb;
+   int      OccRank, model, nThreads;
+
+   /* Every thread count splits the file differently, so alternates
+      and models are divided between chunks in different places
+   */
+   for(OccRank=0; OccRank<=MAXOCCRANK; OccRank++)
+   {
+      for(model=0; model<=MAXMODEL; model++)
+      {
+         PDBREADFILTER filter;
+
+         ref = read_reference(OccRank, model);
+         blInitPDBReadFilter(&filter);
+         filter.modelNum = model;
+
+         for(nThreads=1; nThreads<=MAXTHREADS; nThreads++)
+         {
+            fp   = fopen(MODELS_FILE, "r");
+            wpdb = blDoReadPDBParallel(fp, OccRank, FALSE, &filter,
+                                       nThreads);
+            fclose(fp);
+
+            ck_assert(wpdb != NULL);
+            ck_assert_int_eq(wpdb->natoms, ref->natoms);
+            compare_pdb(wpdb->pdb, ref->pdb);
+            blFreeWholePDB(wpdb);
+         }
+         blFreeWholePDB(ref);
+      }
+   }
+}
+END_TEST
+
+START_TEST(test_read_parallel_02)
+{
+   WHOLEPDB      *ref, *wpdb;
+   PDBREADFILTER filter;
+   PDB           *pdb2;
+   int           natoms2,
+                 nThreads;
+
+   /* blReadPDBParallel() matches blReadPDB()                           */
+   fp  = fopen(MODELS_FILE, "r");
+   pdb = blReadPDB(fp, &natoms);
+   fclose(fp);
+   ck_assert(pdb != NULL);
+   for(nThreads=1; nThreads<=MAXTHREADS; nThreads+=5)
+   {
+      fp   = fopen(MODELS_FILE, "r");
+      pdb2 = blReadPDBParallel(fp, &natoms2, nThreads);
+      fclose(fp);
+      ck_assert_int_eq(natoms2, natoms);
+      compare_pdb(pdb2, pdb);
+      FREELIST(pdb2, PDB);
+   }
+
+   /* The header and trailer are kept when reading the whole file       */
+   fp  = fopen(MODELS_FILE, "r");
+   ref = blDoReadPDB(fp, TRUE, 1, 1, TRUE);
+   fclose(fp);
+   ck_assert(ref != NULL);
+   ck_assert(ref->header != NULL);
+   blInitPDBReadFilter(&filter);
+   for(nThreads=1; nThreads<=MAXTHREADS; nThreads+=5)
+   {
+      fp   = fopen(MODELS_FILE, "r");
+      wpdb = blDoReadPDBParallel(fp, 1, TRUE, &filter, nThreads);
+      fclose(fp);
+      ck_assert(wpdb != NULL);
+      compare_strings(wpdb->header, ref->header);
+      compare_strings(wpdb->trailer, ref->trailer);
+      compare_pdb(wpdb->pdb, ref->pdb);
+      blFreeWholePDB(wpdb);
+   }
+   blFreeWholePDB(ref);
+}
+END_TEST
+
+START_TEST(test_read_file_01)
+{
+   WHOLEPDB      *ref, *wpdb;
+   PDBREADFILTER filter;
+   PDB           *pdb2;
+   int           OccRank, model, nThreads,
+                 natoms2;
+
+   for(OccRank=0; OccRank<=MAXOCCRANK; OccRank++)
+   {
+      for(model=0; model<=MAXMODEL; model++)
+      {
+         ref = read_reference(OccRank, model);
+         blInitPDBReadFilter(&filter);
+         filter.modelNum = model;
+
+         for(nThreads=1; nThreads<=MAXTHREADS; nThreads+=3)
+         {
+            wpdb = blDoReadPDBFile(MODELS_FILE, OccRank, FALSE, &filter,
+                                   nThreads);
+            ck_assert(wpdb != NULL);
+            ck_assert_int_eq(wpdb->natoms, ref->natoms);
+            compare_pdb(wpdb->pdb, ref->pdb);
+            blFreeWholePDB(wpdb);
+         }
+         blFreeWholePDB(ref);
+      }
+   }
+
+   /* blReadPDBFile() matches blReadPDB()                               */
+   fp  = fopen(MODELS_FILE, "r");
+   pdb = blReadPDB(fp, &natoms);
+   fclose(fp);
+   pdb2 = blReadPDBFile(MODELS_FILE, &natoms2);
+   ck_assert(pdb2 != NULL);
+   ck_assert_int_eq(natoms2, natoms);
+   compare_pdb(pdb2, pdb);
+   FREELIST(pdb2, PDB);
+
+   /* A missing file                                                   */
+   ck_assert(blDoReadPDBFile("data/readpdbml_suite/missing.pdb", 1, 
+                             FALSE, &filter, 1) == NULL);
+}
+END_TEST
+
+START_TEST(test_read_buffer_01)
+{
+   WHOLEPDB      *ref, *wpdb;
+   PDBREADFILTER filter;
+   char          *buffer;
+   long          length;
+   int           OccRank, model, nThreads;
+
+   /* Read the file into a buffer which is not null-terminated          */
+   fp = fopen(MODELS_FILE, "r");
+   ck_assert(fp != NULL);
+   fseek(fp, 0L, SEEK_END);
+   length = ftell(fp);
+   rewind(fp);
+   buffer = (char *)malloc(length);
+   ck_assert(buffer != NULL);
+   ck_assert(fread(buffer, 1, length, fp) == (size_t)length);
+   fclose(fp);
+
+   for(OccRank=0; OccRank<=MAXOCCRANK; OccRank++)
+   {
+      for(model=0; model<=MAXMODEL; model++)
+      {
+         ref = read_reference(OccRank, model);
+         blInitPDBReadFilter(&filter);
+         filter.modelNum = model;
+
+         for(nThreads=1; nThreads<=MAXTHREADS; nThreads+=3)
+         {
+            wpdb = blDoReadPDBBuffer(buffer, length, OccRank, FALSE,
+                                     &filter, nThreads);
+            ck_assert(wpdb != NULL);
+            ck_assert_int_eq(wpdb->natoms, ref->natoms);
+            compare_pdb(wpdb->pdb, ref->pdb);
+            blFreeWholePDB(wpdb);
+         }
+         blFreeWholePDB(ref);
+      }
+   }
+
+   /* The last line may be cut short without a newline                 */
+   ref  = read_reference(1, 0);
+   wpdb = blDoReadPDBBuffer(buffer, length-1, 1, FALSE, NULL, 4);
+   ck_assert(wpdb != NULL);
+   ck_assert_int_eq(wpdb->natoms, ref->natoms);
+   blFreeWholePDB(wpdb);
+   blFreeWholePDB(ref);
+
+   /* PDBML is not handled from a buffer                               */
+   ck_assert(blDoReadPDBBuffer("<?xml version", 13, 1, FALSE, NULL, 1)
+             == NULL);
+
+   free(buffer);
+}
+END_TEST
+
+
 /* Create Suite */
 Suite *readpdbml_suite(void)
 {
    Suite *s        = suite_create("ReadPDBML");
-   TCase *tc_core  = tcase_create("Core"),
-         *tc_pdb   = tcase_create("PDB"),
-         *tc_pdbml = tcase_create("PDBML");
+   TCase *tc_core   = tcase_create("Core"),
+         *tc_pdb    = tcase_create("PDB"),
+         *tc_pdbml  = tcase_create("PDBML"),
+         *tc_reader = tcase_create("Readers");
 
 
    /* Core test case */
@@ -1008,5 +1353,16 @@ Suite *readpdbml_suite(void)
    tcase_add_test(tc_pdbml, test_read_pdbml_data_12);
    suite_add_tcase(s, tc_pdbml);
 
+   /* Alternative readers */
+   tcase_add_checked_fixture(tc_reader, readpdbml_setup, 
+                             readpdbml_teardown);
+   tcase_add_test(tc_reader, test_read_filtered_01);
+   tcase_add_test(tc_reader, test_read_filtered_02);
+   tcase_add_test(tc_reader, test_read_parallel_01);
+   tcase_add_test(tc_reader, test_read_parallel_02);
+   tcase_add_test(tc_reader, test_read_file_01);
+   tcase_add_test(tc_reader, test_read_buffer_01);
+   suite_add_tcase(s, tc_reader);
+
    return s;
 }
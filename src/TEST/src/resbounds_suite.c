@@ -0,0 +1,463 @@
+/************************************************************************/
+/**
+
+   \file       resbounds_suite.c
+   
+   \version    V1.1
+   \date       17.10.26
+   \brief      Test suite for the residue bounds layer.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for the residue bounds layer.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+-  V1.1  17.10.26 Compare against unpruned searches and test NULL
+                  coordinates, occupancies and CONECTs
+
+*************************************************************************/
+
+
+#include "resbounds_suite.h"
+
+/* Defines */
+#define TEST_PDB_FILE   "./data/crambin.pdb"
+#define TEST_HBOND_FILE "./data/resbounds_suite/hbond_pair.pdb"
+#define BOND_TOL        ((REAL)0.45)
+#define SHORT_DADIST    ((REAL)2.0)
+#define EPS             ((REAL)0.0001)
+#define NULLCOORD       ((REAL)9999.999)
+
+/* Globals */
+static PDB       *pdb    = NULL;
+static PDBSTRUCT *pdbs   = NULL;
+static RESBOUNDS *bounds = NULL;
+
+/* Setup And Teardown */
+static void resbounds_setup(void)
+{
+   FILE *fp;
+   int  natoms;
+   
+   if((fp = fopen(TEST_PDB_FILE,"r")) == NULL)
+   {
+      fprintf(stderr, "Failed to open test pdb file!\n");
+      return;
+   }
+   pdb = blReadPDBAtoms(fp, &natoms);
+   fclose(fp);
+
+   pdbs   = blAllocPDBStructure(pdb);
+   bounds = blAllocResBounds(pdbs);
+}
+
+static void resbounds_teardown(void)
+{
+   blFreeResBounds(bounds);
+   blFreePDBStructure(pdbs);
+   FREELIST(pdb, PDB);
+   bounds = NULL;
+   pdbs   = NULL;
+}
+
+/* Checks that the bounds of every residue contain its atoms and that
+   the centroids match a fresh calculation
+*/
+static void check_bounds(void)
+{
+   RESBOUND fresh;
+   PDB      *p;
+   int      i;
+
+   for(i=0; i<bounds->nres; i++)
+   {
+      RESBOUND *rb = &(bounds->residues[i]);
+
+      for(p=rb->residue->start; p!=rb->residue->stop; NEXT(p))
+         ck_assert(DIST(p, &(rb->cg)) <= rb->radius + EPS);
+
+      fresh.residue = rb->residue;
+      blSetResBound(&fresh);
+      ck_assert(DIST(&(fresh.cg), &(rb->cg)) < EPS);
+      ck_assert(DIST(&(fresh.scCg), &(rb->scCg)) < EPS);
+      ck_assert(rb->radius >= fresh.radius - EPS);
+      ck_assert(rb->radius <= fresh.radius + RESBOUND_MAXSLACK + EPS);
+   }
+}
+
+/* Tests every pair of atoms from two residues                         */
+static BOOL bonded_by_atoms(PDB *res1, PDB *res2)
+{
+   PDB *res1next = blFindNextResidue(res1),
+       *res2next = blFindNextResidue(res2),
+       *p, *q;
+
+   for(p=res1; p!=res1next; NEXT(p))
+      for(q=res2; q!=res2next; NEXT(q))
+         if(blIsBonded(p, q, BOND_TOL))
+            return(TRUE);
+   return(FALSE);
+}
+
+/* Checks a neighbour list against every atom of the structure and
+   that its CONECTs all point within the list
+*/
+static void check_neighbours(PDB *neighbs, PDB *res, REAL dist)
+{
+   PDB *resnext = blFindNextResidue(res),
+       *n = neighbs,
+       *p, *q;
+   int i, nConect;
+
+   for(q=pdb; q!=NULL; NEXT(q))
+   {
+      for(p=res; p!=resnext; NEXT(p))
+         if(DISTSQ(p, q) <= dist*dist)
+            break;
+      if(p == resnext)
+         continue;
+
+      ck_assert(n != NULL);
+      ck_assert_int_eq(n->atnum, q->atnum);
+      ck_assert(n->occ == (REAL)1.0);
+
+      for(i=0, nConect=0; i<q->nConect; i++)
+      {
+         for(p=neighbs; p!=NULL; NEXT(p))
+            if(p->atnum == q->conect[i]->atnum)
+               break;
+         if(p != NULL)
+            nConect++;
+      }
+      ck_assert_int_eq(n->nConect, nConect);
+      for(i=0; i<n->nConect; i++)
+      {
+         for(p=neighbs; p!=NULL; NEXT(p))
+            if(p == n->conect[i])
+               break;
+         ck_assert(p != NULL);
+      }
+      NEXT(n);
+   }
+   ck_assert(n == NULL);
+}
+
+
+/* Core Tests */
+START_TEST(test_bounds_01)
+{
+   VEC3F cg;
+   int   i;
+   
+   ck_assert(bounds != NULL);
+   ck_assert_int_eq(bounds->nres, 46);
+   check_bounds();
+
+   for(i=0; i<bounds->nres; i++)
+   {
+      RESBOUND *rb = &(bounds->residues[i]);
+
+      ck_assert(rb->residue->start->resnum == i+1);
+      ck_assert(rb->slack == (REAL)0.0);
+      blGetCofGPDBRange(rb->residue->start, rb->residue->stop, &cg);
+      ck_assert(DIST(&cg, &(rb->cg)) < EPS);
+      blGetCofGPDBSCRange(rb->residue->start, rb->residue->stop, &cg);
+      ck_assert(DIST(&cg, &(rb->scCg)) < EPS);
+   }
+}
+END_TEST
+
+START_TEST(test_pairs_01)
+{
+   int i, j,
+       npruned = 0,
+       nbonded = 0,
+       nhbonded = 0;
+
+   ck_assert(bounds != NULL);
+   for(i=0; i<bounds->nres; i++)
+   {
+      for(j=0; j<bounds->nres; j++)
+      {
+         RESBOUND *rb1 = &(bounds->residues[i]),
+                  *rb2 = &(bounds->residues[j]);
+         BOOL     bonded;
+         int      hbond;
+
+         if(i==j)
+            continue;
+
+         if(!blResBoundsWithin(rb1, rb2, (REAL)4.0))
+            npruned++;
+
+         bonded = bonded_by_atoms(rb1->residue->start,
+                                  rb2->residue->start);
+         ck_assert(blAreResiduePointersBonded(rb1->residue->start,
+                                              rb2->residue->start,
+                                              BOND_TOL) == bonded);
+         ck_assert(blAreResBoundsBonded(rb1, rb2, BOND_TOL) == bonded);
+         if(bonded)
+            nbonded++;
+
+         hbond = blIsHBonded(rb1->residue->start, rb2->residue->start,
+                             HBOND_ANY);
+         ck_assert_int_eq(blIsHBondedResBounds(rb1, rb2, HBOND_ANY),
+                          hbond);
+         if(hbond)
+            nhbonded++;
+      }
+   }
+
+   /* The peptide bonds and 3 disulphides                              */
+   ck_assert_int_eq(nbonded, 2*(45+3));
+   ck_assert(nhbonded > 0);
+   ck_assert(npruned > (bounds->nres * (bounds->nres-1)) / 2);
+}
+END_TEST
+
+/* With explicit hydrogens an H-bond is accepted on the H...A distance
+   alone. In this pair the H and O lie on the surfaces of the residue
+   bounds 2.2A apart, so pruning on a D...A cutoff of 2.0A would miss
+   the H-bond
+*/
+START_TEST(test_pairs_02)
+{
+   FILE      *fp;
+   PDB       *hpdb;
+   PDBSTRUCT *hpdbs;
+   RESBOUNDS *hbounds;
+   REAL      daDist = blGetMaxProteinHBondDADistance();
+   int       natoms, hbond;
+
+   ck_assert((fp = fopen(TEST_HBOND_FILE,"r")) != NULL);
+   hpdb = blReadPDB(fp, &natoms);
+   fclose(fp);
+   ck_assert(hpdb != NULL);
+   ck_assert((hpdbs   = blAllocPDBStructure(hpdb)) != NULL);
+   ck_assert((hbounds = blAllocResBounds(hpdbs)) != NULL);
+   ck_assert_int_eq(hbounds->nres, 2);
+
+   blSetMaxProteinHBondDADistance(SHORT_DADIST);
+   hbond = blIsHBondedResBounds(&(hbounds->residues[0]),
+                                &(hbounds->residues[1]), HBOND_ANY);
+   ck_assert(!blResBoundsWithin(&(hbounds->residues[0]),
+                                &(hbounds->residues[1]), SHORT_DADIST));
+   blSetMaxProteinHBondDADistance(daDist);
+
+   ck_assert(hbond != 0);
+   ck_assert_int_eq(hbond,
+                    blIsHBonded(hbounds->residues[0].residue->start,
+                                hbounds->residues[1].residue->start,
+                                HBOND_ANY));
+
+   blFreeResBounds(hbounds);
+   blFreePDBStructure(hpdbs);
+   FREELIST(hpdb, PDB);
+}
+END_TEST
+
+START_TEST(test_neighbours_01)
+{
+   PDB  *full, *pruned;
+   REAL dist;
+   int  i;
+
+   ck_assert(bounds != NULL);
+   ck_assert(blBuildConectData(pdb, BOND_TOL));
+   for(dist=(REAL)3.0; dist<(REAL)9.0; dist+=(REAL)2.5)
+   {
+      for(i=0; i<bounds->nres; i+=5)
+      {
+         RESBOUND *rb = &(bounds->residues[i]);
+
+         full   = blBuildAtomNeighbourPDBListAsCopy(pdb, rb->residue->start,
+                                                    dist);
+         pruned = blBuildAtomNeighbourPDBListResBounds(bounds, rb, dist);
+         ck_assert(full != NULL);
+         check_neighbours(full,   rb->residue->start, dist);
+         check_neighbours(pruned, rb->residue->start, dist);
+
+         FREELIST(full, PDB);
+         FREELIST(pruned, PDB);
+      }
+   }
+}
+END_TEST
+
+/* Atoms with NULL coordinates are outside the bounds but are
+   neighbours of one another
+*/
+START_TEST(test_neighbours_02)
+{
+   RESBOUND *rb;
+   PDB      *full, *pruned, *p;
+   int      i;
+
+   ck_assert(bounds != NULL);
+   for(i=0; i<bounds->nres; i+=9)
+   {
+      p    = bounds->residues[i].residue->start;
+      p->x = p->y = p->z = NULLCOORD;
+   }
+   blUpdateResBounds(bounds);
+
+   rb = &(bounds->residues[18]);
+   ck_assert_int_eq(rb->nullAtoms, 1);
+   ck_assert_int_eq(bounds->residues[19].nullAtoms, 0);
+
+   for(i=18; i<20; i++)
+   {
+      rb     = &(bounds->residues[i]);
+      full   = blBuildAtomNeighbourPDBListAsCopy(pdb, rb->residue->start,
+                                                 (REAL)4.0);
+      pruned = blBuildAtomNeighbourPDBListResBounds(bounds, rb,
+                                                    (REAL)4.0);
+      check_neighbours(full,   rb->residue->start, (REAL)4.0);
+      check_neighbours(pruned, rb->residue->start, (REAL)4.0);
+
+      FREELIST(full, PDB);
+      FREELIST(pruned, PDB);
+   }
+}
+END_TEST
+
+START_TEST(test_move_01)
+{
+   PDB  *p;
+   int  i, n;
+   REAL shift;
+
+   ck_assert(bounds != NULL);
+
+   /* Nudge atoms repeatedly: the bounds must stay valid without being
+      recalculated from scratch
+   */
+   for(n=0; n<20; n++)
+   {
+      for(i=0; i<bounds->nres; i++)
+      {
+         RESBOUND *rb = &(bounds->residues[i]);
+
+         for(p=rb->residue->start; p!=rb->residue->stop; NEXT(p))
+         {
+            shift = (REAL)(((p->atnum + n) % 7) - 3) * (REAL)0.05;
+            blMoveAtomResBound(rb, p, p->x + shift, p->y - shift,
+                               p->z + shift/2);
+         }
+      }
+      check_bounds();
+   }
+
+   /* A large move of a single atom                                    */
+   p = bounds->residues[10].residue->start;
+   blMoveAtomResBound(&(bounds->residues[10]), p, p->x + 20.0, p->y,
+                      p->z);
+   check_bounds();
+}
+END_TEST
+
+START_TEST(test_transform_01)
+{
+   REAL  rm[3][3];
+   VEC3F tvect;
+
+   ck_assert(bounds != NULL);
+   blCreateRotMat('y', (REAL)1.2, rm);
+   blApplyMatrixPDB(pdb, rm);
+   blApplyMatrixResBounds(bounds, rm);
+   check_bounds();
+
+   tvect.x = (REAL)20.0;
+   tvect.y = (REAL)-5.0;
+   tvect.z = (REAL)3.0;
+   blTranslatePDB(pdb, tvect);
+   blTranslateResBounds(bounds, tvect);
+   check_bounds();
+}
+END_TEST
+
+
+/* Error Tests */
+START_TEST(test_error_01)
+{
+   PDBSTRUCT empty;
+   RESBOUNDS *none;
+   
+   ck_assert(blAllocResBounds(NULL) == NULL);
+
+   empty.pdb    = NULL;
+   empty.chains = NULL;
+   empty.extras = NULL;
+   none = blAllocResBounds(&empty);
+   ck_assert(none != NULL);
+   ck_assert_int_eq(none->nres, 0);
+   blFreeResBounds(none);
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *resbounds_suite(void)
+{
+   Suite *s        = suite_create("ResBounds");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, resbounds_setup, 
+                             resbounds_teardown);
+   tcase_add_test(tc_core, test_bounds_01);
+   tcase_add_test(tc_core, test_pairs_01);
+   tcase_add_test(tc_core, test_pairs_02);
+   tcase_add_test(tc_core, test_neighbours_01);
+   tcase_add_test(tc_core, test_neighbours_02);
+   tcase_add_test(tc_core, test_move_01);
+   tcase_add_test(tc_core, test_transform_01);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, resbounds_setup, 
+                             resbounds_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
@@ -0,0 +1,78 @@
+/************************************************************************/
+/**
+
+   \file       resbounds_suite.h
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Include file for ResBounds test suite.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for residue centroids and bounding spheres, for keeping
+   them up to date as a structure moves and for using them to prune
+   bond, H-bond and neighbour searches.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+#ifndef _RESBOUNDS_SUITE_H
+#define _RESBOUNDS_SUITE_H
+
+/* Includes for tests */
+#include <stdlib.h>
+#include <check.h>
+
+/* Includes from source file */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../../SysDefs.h"
+#include "../../MathType.h"
+#include "../../macros.h"
+#include "../../pdb.h"
+#include "../../matrix.h"
+#include "../../hbond.h"
+#include "../../resbounds.h"
+
+/* Prototypes */
+Suite *resbounds_suite(void);
+
+#endif
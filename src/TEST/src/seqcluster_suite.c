@@ -0,0 +1,283 @@
+/************************************************************************/
+/**
+
+   \file       seqcluster_suite.c
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Test suite for the sequence index and clustering.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for the sequence index and clustering.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+
+#include "seqcluster_suite.h"
+
+/* Defines */
+#define TEST_FASTA_FILE "./data/seqcluster_suite/test.fa"
+#define TEST_PDB_FILE   "./data/crambin.pdb"
+#define NSEQS           9
+#define MAXBUFF         160
+#define CRAMBIN_SEQ     "TTCCPSIVARSNFNVCRLPGTPEAICATYTGCIIIPGATCPGDYAN"
+/* seqA with a change at position 6 */
+#define QUERY_SEQ       "MFPCDFENWCTHCDQQDIDVQCWEIWCWWPCICVFLQFVEWLVGEWW\
+HNEVDWCYHSVQMRWRNLIGIDWLTSMRLYDETQGMFSQCDVWMMNYSWRDDKSDCLWRLPNARNGYESCHLF"
+
+/* Globals */
+static SEQINDEX *index = NULL;
+
+/* Setup And Teardown */
+static void seqcluster_setup(void)
+{
+   FILE *fp;
+   
+   if((fp = fopen(TEST_FASTA_FILE,"r")) == NULL)
+   {
+      fprintf(stderr, "Failed to open test FASTA file!\n");
+      return;
+   }
+   if((index = blAllocSeqIndex(5)) != NULL)
+      blAddSeqIndexFASTA(index, fp);
+   fclose(fp);
+}
+
+static void seqcluster_teardown(void)
+{
+   blFreeSeqIndex(index);
+   index = NULL;
+}
+
+/* Checks the clusters found at 0.9 identity                           */
+static void CheckClusters90(SEQCLUSTERS *clusters)
+{
+   /* seqA, seqA1, seqA2                                               */
+   ck_assert_int_eq(clusters->nclusters, 5);
+   ck_assert_int_eq(clusters->rep[0], 0);
+   ck_assert_int_eq(clusters->cluster[1], 0);
+   ck_assert_int_eq(clusters->cluster[2], 0);
+   ck_assert(fabs(clusters->identity[1] - 117.0/120.0) < 0.0001);
+   ck_assert(fabs(clusters->identity[2] - 1.0) < 0.0001);
+   ck_assert_int_eq(clusters->size[0], 3);
+   /* seqA3 has 20 changes                                             */
+   ck_assert_int_eq(clusters->rep[1], 3);
+   ck_assert_int_eq(clusters->size[1], 1);
+   /* seqB1 has an insertion, so is longer than seqB                   */
+   ck_assert_int_eq(clusters->rep[2], 5);
+   ck_assert_int_eq(clusters->cluster[4], 2);
+   /* seqC and its lower case copy                                     */
+   ck_assert_int_eq(clusters->rep[3], 6);
+   ck_assert_int_eq(clusters->cluster[7], 3);
+   /* seqX has no k-mers                                               */
+   ck_assert_int_eq(clusters->rep[4], 8);
+}
+
+/* Core Tests */
+START_TEST(test_index_01)
+{
+   SEQINDEX *pdbIndex;
+   FILE     *fp;
+   PDB      *pdb;
+   int      natoms;
+   
+   ck_assert(index != NULL);
+   ck_assert_int_eq(index->nseqs, NSEQS);
+   ck_assert_str_eq(index->ids[0], "seqA");
+   ck_assert_int_eq(index->lengths[0], 120);
+   ck_assert_int_eq(index->nwords[0], 116);
+   ck_assert_int_eq(index->nwords[8], 0);
+   ck_assert(strncmp(index->seqs[7], index->seqs[6], 40) == 0);
+
+   ck_assert((fp = fopen(TEST_PDB_FILE, "r")) != NULL);
+   pdb = blReadPDB(fp, &natoms);
+   fclose(fp);
+   ck_assert(pdb != NULL);
+   ck_assert((pdbIndex = blAllocSeqIndex(0)) != NULL);
+   ck_assert_int_eq(pdbIndex->wordSize, SEQIDX_DEFWORD);
+   ck_assert_int_eq(blAddSeqIndexPDB(pdbIndex, "1crn", pdb), 1);
+   ck_assert_str_eq(pdbIndex->chains[0], "A");
+   ck_assert_str_eq(pdbIndex->seqs[0], CRAMBIN_SEQ);
+   blFreeSeqIndex(pdbIndex);
+   FREELIST(pdb, PDB);
+}
+END_TEST
+
+START_TEST(test_cluster_01)
+{
+   SEQCLUSTERS *clusters;
+
+   ck_assert(index != NULL);
+   ck_assert((clusters = blClusterSeqIndex(index, NULL, 0.9, 1)) 
+             != NULL);
+   CheckClusters90(clusters);
+   /* Only sequences sharing enough k-mers are aligned: seqX with each
+      earlier representative and one alignment for each of the 4 which
+      join a cluster
+   */
+   ck_assert_int_eq(clusters->nalign, 8);
+   blFreeSeqClusters(clusters);
+
+   /* The same with several threads                                    */
+   ck_assert((clusters = blClusterSeqIndex(index, NULL, 0.9, 4)) 
+             != NULL);
+   CheckClusters90(clusters);
+   blFreeSeqClusters(clusters);
+
+   /* seqA3 joins seqA at 0.8                                          */
+   ck_assert((clusters = blClusterSeqIndex(index, NULL, 0.8, 2)) 
+             != NULL);
+   ck_assert_int_eq(clusters->nclusters, 4);
+   ck_assert_int_eq(clusters->cluster[3], 0);
+   ck_assert(fabs(clusters->identity[3] - 100.0/120.0) < 0.0001);
+   blFreeSeqClusters(clusters);
+}
+END_TEST
+
+START_TEST(test_cluster_02)
+{
+   SEQCLUSTERS *clusters;
+   FILE        *fp;
+   char        buffer[MAXBUFF];
+
+   ck_assert(index != NULL);
+   ck_assert((clusters = blClusterSeqIndex(index, NULL, 0.9, 1)) 
+             != NULL);
+   ck_assert((fp = tmpfile()) != NULL);
+   ck_assert(blPrintSeqClusters(fp, index, clusters));
+   rewind(fp);
+   ck_assert(fgets(buffer, MAXBUFF, fp) != NULL);
+   ck_assert_str_eq(buffer, ">Cluster 0\n");
+   ck_assert(fgets(buffer, MAXBUFF, fp) != NULL);
+   ck_assert_str_eq(buffer, "0\t120aa, >seqA... *\n");
+   ck_assert(fgets(buffer, MAXBUFF, fp) != NULL);
+   ck_assert_str_eq(buffer, "1\t120aa, >seqA1... at 97.50%\n");
+   fclose(fp);
+   blFreeSeqClusters(clusters);
+}
+END_TEST
+
+START_TEST(test_search_01)
+{
+   SEQHIT *hits;
+   int    nhits;
+   
+   ck_assert(index != NULL);
+   hits = blSearchSeqIndex(index, NULL, QUERY_SEQ, 0.9, &nhits);
+   ck_assert_int_eq(nhits, 3);
+   ck_assert_str_eq(hits->id, "seqA2");
+   ck_assert(fabs(hits->identity - 1.0) < 0.0001);
+   ck_assert_str_eq(hits->next->id, "seqA");
+   ck_assert(fabs(hits->next->identity - 119.0/120.0) < 0.0001);
+   ck_assert_str_eq(hits->next->next->id, "seqA1");
+   blFreeSeqHits(hits);
+
+   /* An unrelated sequence                                           */
+   hits = blSearchSeqIndex(index, NULL, "TKGWCDEEMFCQRLQGNWTLQIAYNK", 
+                           0.5, &nhits);
+   ck_assert_int_eq(nhits, 0);
+   blFreeSeqHits(hits);
+
+   /* The lower case copy of seqC matches both                         */
+   hits = blSearchSeqIndex(index, NULL, index->seqs[7], 0.99, &nhits);
+   ck_assert_int_eq(nhits, 2);
+   blFreeSeqHits(hits);
+}
+END_TEST
+
+
+/* Error Tests */
+START_TEST(test_error_01)
+{
+   SEQCLUSTERS *clusters;
+   int         nhits;
+   
+   ck_assert(blAllocSeqIndex(SEQIDX_MAXWORD+1) == NULL);
+   ck_assert(blAllocSeqIndex(-1) == NULL);
+   ck_assert(index != NULL);
+
+   /* Empty sequences are ignored                                      */
+   ck_assert(blAddSeqIndex(index, "empty", "A", ""));
+   ck_assert_int_eq(index->nseqs, NSEQS);
+   ck_assert(blSearchSeqIndex(index, NULL, "", 0.5, &nhits) == NULL);
+   ck_assert_int_eq(nhits, 0);
+
+   /* An empty index                                                   */
+   blFreeSeqIndex(index);
+   ck_assert((index = blAllocSeqIndex(3)) != NULL);
+   ck_assert(blSearchSeqIndex(index, NULL, "ACDEF", 0.5, &nhits)
+             == NULL);
+   ck_assert_int_eq(nhits, 0);
+   ck_assert((clusters = blClusterSeqIndex(index, NULL, 0.9, 1))
+             != NULL);
+   ck_assert_int_eq(clusters->nclusters, 0);
+   blFreeSeqClusters(clusters);
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *seqcluster_suite(void)
+{
+   Suite *s        = suite_create("SeqCluster");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, seqcluster_setup, 
+                             seqcluster_teardown);
+   tcase_add_test(tc_core, test_index_01);
+   tcase_add_test(tc_core, test_cluster_01);
+   tcase_add_test(tc_core, test_cluster_02);
+   tcase_add_test(tc_core, test_search_01);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, seqcluster_setup, 
+                             seqcluster_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
@@ -0,0 +1,260 @@
+/************************************************************************/
+/**
+
+   \file       strucalign_suite.c
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Test suite for structural alignment.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for structural alignment.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+
+#include "strucalign_suite.h"
+
+/* Defines */
+#define TEST_PDB_FILE  "./data/crambin.pdb"
+#define TEST_SS        "EEEE-HHHHHHHHHHHHH---HHHHHHHHHH-EEE-----HHHHHE"
+#define CRAMBIN_LEN    46
+
+/* Globals */
+static PDB     *query   = NULL,
+               *target  = NULL;
+static SACHAIN *qchain  = NULL,
+               *tchain  = NULL;
+
+/* Setup And Teardown */
+static void strucalign_setup(void)
+{
+   FILE  *fp;
+   PDB   *p, *next,
+         *prev = NULL;
+   REAL  rm[3][3];
+   VEC3F tvect;
+   int   natoms;
+   
+   if((fp = fopen(TEST_PDB_FILE,"r")) == NULL)
+   {
+      fprintf(stderr, "Failed to open test pdb file!\n");
+      return;
+   }
+   query  = blReadPDBAtoms(fp, &natoms);
+   rewind(fp);
+   target = blReadPDBAtoms(fp, &natoms);
+   fclose(fp);
+
+   /* Delete residues 10-12 from the target and move it away          */
+   for(p=target; p!=NULL; p=next)
+   {
+      next = p->next;
+      if((p->resnum >= 10) && (p->resnum <= 12))
+      {
+         prev->next = next;
+         free(p);
+      }
+      else
+      {
+         prev = p;
+      }
+   }
+   blCreateRotMat('x', (REAL)0.7, rm);
+   blApplyMatrixPDB(target, rm);
+   tvect.x = 5.0;
+   tvect.y = -3.0;
+   tvect.z = 10.0;
+   blTranslatePDB(target, tvect);
+
+   qchain = blPrepareSAChain(query);
+   tchain = blPrepareSAChain(target);
+}
+
+static void strucalign_teardown(void)
+{
+   blFreeSAChain(qchain);
+   blFreeSAChain(tchain);
+   FREELIST(query,  PDB);
+   FREELIST(target, PDB);
+   qchain = tchain = NULL;
+}
+
+
+/* Core Tests */
+START_TEST(test_prepare_01)
+{
+   ck_assert(qchain != NULL);
+   ck_assert_int_eq(qchain->length, CRAMBIN_LEN);
+   ck_assert(!strncmp(qchain->ss, TEST_SS, CRAMBIN_LEN));
+   ck_assert_int_eq(qchain->atoms[0]->resnum, 1);
+   ck_assert(!strncmp(qchain->atoms[0]->atnam, "CA  ", 4));
+   ck_assert_int_eq(tchain->length, CRAMBIN_LEN-3);
+}
+END_TEST
+
+START_TEST(test_align_01)
+{
+   SAWORKSPACE *ws;
+   SARESULT    result;
+   int         map[CRAMBIN_LEN],
+               i;
+
+   /* Self alignment                                                 */
+   ck_assert((ws = blAllocSAWorkspace(0, 0)) != NULL);
+   result.map = map;
+   ck_assert(blStructureAlign(qchain, qchain, ws, &result));
+   ck_assert(fabs(result.tmscore - 1.0) < 0.0001);
+   ck_assert(result.rmsd < 0.001);
+   ck_assert_int_eq(result.naligned, CRAMBIN_LEN);
+   for(i=0; i<CRAMBIN_LEN; i++)
+      ck_assert_int_eq(map[i], i);
+   blFreeSAWorkspace(ws);
+}
+END_TEST
+
+START_TEST(test_align_02)
+{
+   SAWORKSPACE *ws;
+   SARESULT    result;
+   int         map[CRAMBIN_LEN],
+               i;
+
+   /* The deleted residues are left out and the rest align           */
+   ck_assert((ws = blAllocSAWorkspace(0, 0)) != NULL);
+   result.map = map;
+   ck_assert(blStructureAlign(qchain, tchain, ws, &result));
+   ck_assert_int_eq(result.naligned, CRAMBIN_LEN-3);
+   ck_assert(fabs(result.tmscore - 43.0/46.0) < 0.0001);
+   ck_assert(result.rmsd < 0.001);
+   for(i=0; i<9; i++)
+      ck_assert_int_eq(map[i], i);
+   for(i=9; i<12; i++)
+      ck_assert_int_eq(map[i], -1);
+   for(i=12; i<CRAMBIN_LEN; i++)
+      ck_assert_int_eq(map[i], i-3);
+
+   /* The superposition moves the target back onto the query         */
+   blApplySAResultPDB(target, &result);
+   ck_assert(fabs(target->x - query->x) < 0.001);
+   ck_assert(fabs(target->y - query->y) < 0.001);
+   ck_assert(fabs(target->z - query->z) < 0.001);
+
+   /* Without a map the workspace is reused                          */
+   result.map = NULL;
+   ck_assert(blStructureAlign(tchain, qchain, ws, &result));
+   ck_assert(fabs(result.tmscore - 1.0) < 0.0001);
+   blFreeSAWorkspace(ws);
+}
+END_TEST
+
+START_TEST(test_library_01)
+{
+   SACHAIN  *library[3];
+   SARESULT results[3];
+   int      nthreads;
+
+   library[0] = tchain;
+   library[1] = NULL;
+   library[2] = qchain;
+   for(nthreads=1; nthreads<=3; nthreads+=2)
+   {
+      results[0].map = results[1].map = results[2].map = NULL;
+      ck_assert_int_eq(blStructureAlignLibrary(qchain, library, 3,
+                                               results, nthreads), 2);
+      ck_assert(fabs(results[0].tmscore - 43.0/46.0) < 0.0001);
+      ck_assert(fabs(results[2].tmscore - 1.0) < 0.0001);
+   }
+}
+END_TEST
+
+
+/* Error Tests */
+START_TEST(test_error_01)
+{
+   SAWORKSPACE *ws;
+   SARESULT    result;
+   SACHAIN     shortChain;
+   int         map[CRAMBIN_LEN];
+
+   ck_assert(blPrepareSAChain(NULL) == NULL);
+
+   /* Too short to superpose                                         */
+   shortChain        = *qchain;
+   shortChain.length = 2;
+   ck_assert((ws = blAllocSAWorkspace(0, 0)) != NULL);
+   result.map = map;
+   ck_assert(blStructureAlign(qchain, &shortChain, ws, &result));
+   ck_assert(result.tmscore == 0.0);
+   ck_assert_int_eq(result.naligned, 0);
+   ck_assert_int_eq(map[0], -1);
+   blFreeSAWorkspace(ws);
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *strucalign_suite(void)
+{
+   Suite *s        = suite_create("StrucAlign");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, strucalign_setup, 
+                             strucalign_teardown);
+   tcase_add_test(tc_core, test_prepare_01);
+   tcase_add_test(tc_core, test_align_01);
+   tcase_add_test(tc_core, test_align_02);
+   tcase_add_test(tc_core, test_library_01);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, strucalign_setup, 
+                             strucalign_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
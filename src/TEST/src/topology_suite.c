@@ -0,0 +1,251 @@
+/************************************************************************/
+/**
+
+   \file       topology_suite.c
+   
+   \version    V1.0
+   \date       17.10.26
+   \brief      Test suite for topology strings and index.
+   
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 2026
+   \author     Dr. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+               
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a 
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Test suite for topology strings and index.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original By: ACRM
+
+*************************************************************************/
+
+
+#include "topology_suite.h"
+
+/* Defines */
+#define TEST_PDB_FILE  "./data/crambin.pdb"
+#define TEST_MATRIX    "../../data/topmat.mat"
+#define TEST_INDEX     "test_topology.idx"
+#define CRAMBIN_TOPO   "AISO"
+
+/* Globals */
+static PDB       *pdb   = NULL;
+static MDMATRIX  *mdm   = NULL;
+static TOPOINDEX *index = NULL;
+
+/* Setup And Teardown */
+static void topology_setup(void)
+{
+   FILE *fp;
+   int  natoms;
+   
+   if((fp = fopen(TEST_PDB_FILE,"r")) == NULL)
+   {
+      fprintf(stderr, "Failed to open test pdb file!\n");
+      return;
+   }
+   pdb = blReadPDBAtoms(fp, &natoms);
+   fclose(fp);
+
+   mdm   = blReadMDMatrix(TEST_MATRIX);
+   index = blAllocTopologyIndex();
+}
+
+static void topology_teardown(void)
+{
+   FREELIST(pdb, PDB);
+   blFreeMDMatrix(mdm);
+   blFreeTopologyIndex(index);
+   mdm   = NULL;
+   index = NULL;
+}
+
+
+/* Core Tests */
+START_TEST(test_string_01)
+{
+   char  *topology;
+   REAL  rm[3][3];
+   VEC3F tvect;
+   
+   ck_assert(pdb != NULL);
+   topology = blTopologyStringPDB(pdb, NULL);
+   ck_assert_str_eq(topology, CRAMBIN_TOPO);
+   free(topology);
+
+   /* The string does not depend on the orientation                  */
+   blCreateRotMat('y', (REAL)1.2, rm);
+   blApplyMatrixPDB(pdb, rm);
+   tvect.x = tvect.y = tvect.z = (REAL)20.0;
+   blTranslatePDB(pdb, tvect);
+   topology = blTopologyStringPDB(pdb, NULL);
+   ck_assert_str_eq(topology, CRAMBIN_TOPO);
+   free(topology);
+}
+END_TEST
+
+START_TEST(test_index_01)
+{
+   FILE      *fp;
+   TOPOINDEX *copy;
+   
+   ck_assert_int_eq(blAddTopologyIndexPDB(index, "1crn", pdb), 1);
+   ck_assert(blAddTopologyIndex(index, "test1", "A", "GSTU"));
+   ck_assert(blAddTopologyIndex(index, "test2", "",  "aiso"));
+   ck_assert(blAddTopologyIndex(index, "test3", "B", ""));
+   ck_assert_int_eq(index->nentries, 3);
+   ck_assert_str_eq(index->chains[0], "A");
+   ck_assert_str_eq(index->topologies[0], CRAMBIN_TOPO);
+
+   /* Written and read back                                          */
+   ck_assert((fp = fopen(TEST_INDEX, "w")) != NULL);
+   blWriteTopologyIndex(fp, index);
+   fclose(fp);
+   ck_assert((fp = fopen(TEST_INDEX, "r")) != NULL);
+   copy = blReadTopologyIndex(fp);
+   fclose(fp);
+   remove(TEST_INDEX);
+
+   ck_assert(copy != NULL);
+   ck_assert_int_eq(copy->nentries, 3);
+   ck_assert_str_eq(copy->ids[1], "test1");
+   ck_assert_str_eq(copy->chains[2], "");
+   ck_assert_str_eq(copy->topologies[2], "aiso");
+   blFreeTopologyIndex(copy);
+}
+END_TEST
+
+START_TEST(test_search_01)
+{
+   TOPOHIT *hits;
+   int     nhits;
+   
+   ck_assert(mdm != NULL);
+   blAddTopologyIndexPDB(index, "1crn", pdb);
+   blAddTopologyIndex(index, "buried",  "A", "aiso");
+   blAddTopologyIndex(index, "helical", "A", "GSTU");
+   blAddTopologyIndex(index, "long",    "A", "AISOAISOAISO");
+
+   /* The long entry is removed by length and the helical one shares
+      no 2-mers with the query
+   */
+   hits = blSearchTopologyIndex(index, mdm, CRAMBIN_TOPO, (REAL)0.0,
+                                &nhits);
+   ck_assert_int_eq(nhits, 2);
+   ck_assert_str_eq(hits->id, "1crn");
+   ck_assert(fabs(hits->score - 1.0) < 0.0001);
+   ck_assert_int_eq(hits->rawScore, 40);
+   ck_assert_str_eq(hits->next->id, "buried");
+   ck_assert(hits->next->score < hits->score);
+   blFreeTopologyHits(hits);
+
+   /* The cutoff on the score                                        */
+   hits = blSearchTopologyIndex(index, mdm, CRAMBIN_TOPO, (REAL)0.9,
+                                &nhits);
+   ck_assert_int_eq(nhits, 1);
+   blFreeTopologyHits(hits);
+
+   /* Without the length filter                                      */
+   index->lenRatio = (REAL)3.0;
+   hits = blSearchTopologyIndex(index, mdm, CRAMBIN_TOPO, (REAL)0.0,
+                                &nhits);
+   ck_assert_int_eq(nhits, 3);
+   blFreeTopologyHits(hits);
+}
+END_TEST
+
+START_TEST(test_search_02)
+{
+   TOPOHIT *hits;
+   int     nhits;
+   
+   /* A single SSE has no 2-mers so entries of similar length are
+      aligned
+   */
+   blAddTopologyIndex(index, "one",   "A", "G");
+   blAddTopologyIndex(index, "two",   "A", "GS");
+   blAddTopologyIndex(index, "three", "A", "GST");
+   hits = blSearchTopologyIndex(index, mdm, "G", (REAL)0.5, &nhits);
+   ck_assert_int_eq(nhits, 2);
+   ck_assert_str_eq(hits->id, "one");
+   ck_assert_str_eq(hits->next->id, "two");
+   blFreeTopologyHits(hits);
+}
+END_TEST
+
+
+/* Error Tests */
+START_TEST(test_error_01)
+{
+   int nhits;
+   
+   ck_assert(blTopologyStringPDB(NULL, NULL) == NULL);
+   ck_assert(blSearchTopologyIndex(index, mdm, CRAMBIN_TOPO, (REAL)0.0,
+                                   &nhits) == NULL);
+   ck_assert_int_eq(nhits, 0);
+   blAddTopologyIndex(index, "test1", "A", CRAMBIN_TOPO);
+   ck_assert(blSearchTopologyIndex(index, mdm, "", (REAL)0.0,
+                                   &nhits) == NULL);
+   ck_assert_int_eq(nhits, 0);
+}
+END_TEST
+
+
+/* Create Suite */
+Suite *topology_suite(void)
+{
+   Suite *s        = suite_create("Topology");
+   TCase *tc_core  = tcase_create("Core");
+   TCase *tc_error = tcase_create("Errors");
+
+
+   /* Core test case */
+   tcase_add_checked_fixture(tc_core, topology_setup, 
+                             topology_teardown);
+   tcase_add_test(tc_core, test_string_01);
+   tcase_add_test(tc_core, test_index_01);
+   tcase_add_test(tc_core, test_search_01);
+   tcase_add_test(tc_core, test_search_02);
+   suite_add_tcase(s, tc_core);
+
+   /* Error test case */
+   tcase_add_checked_fixture(tc_error, topology_setup, 
+                             topology_teardown);
+   tcase_add_test(tc_error, test_error_01);
+   suite_add_tcase(s, tc_error);
+
+
+   return(s);
+}
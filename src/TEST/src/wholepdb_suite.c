@@ -3,11 +3,11 @@
 
    \file       wholepdb_suite.c
    
-   \version    V1.2
-   \date       12.09.14
+   \version    V1.3
+   \date       17.10.26
    \brief      Test suite for whole pdb and pdbml.
    
-   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1993-2014
+   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1993-2026
    \author     Dr. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -50,6 +50,7 @@
 -  V1.0  05.08.14 Original By: CTP
 -  V1.1  18.08.14 Check if input file read for all tests. By: CTP
 -  V1.2  12.09.14 Update tests for MS Windows. By: CTP
+-  V1.3  17.10.26 Added test_read_write_hybrid36. By: ACRM
 
 *************************************************************************/
 
@@ -401,6 +402,57 @@ START_TEST(test_read_write_pdbml)
 }
 END_TEST
 
+START_TEST(test_read_write_hybrid36)
+{
+   /* get pdb data */
+   char filename_in[]      = "test_hybrid36_in.pdb",
+        filename_example[] = "test_hybrid36_out.pdb",
+        test_message[]     = "Output PDB does not match example file.";
+   PDB  *p;
+        
+   /* Set Default */
+   gPDBXMLForce = FORCEXML_NOFORCE;
+   
+   /* read input file */
+   strcat(test_input_filename,filename_in);
+   fp = fopen(test_input_filename,"r");
+   wpdb = blReadWholePDB(fp);
+   fclose(fp);
+   ck_assert_msg(wpdb != NULL, "Failed to read PDB file.");
+
+   /* check decimal and hybrid-36 numbers were read */
+   p = wpdb->pdb;
+   ck_assert_msg(p->atnum == 99998 && p->resnum == 9999,
+                 "Decimal numbers not read.");
+   for(; p->next != NULL; NEXT(p));
+   ck_assert_msg(p->atnum == 100003 && p->resnum == 10001,
+                 "Hybrid-36 numbers not read.");
+   ck_assert_msg(p->nConect == 1 && p->conect[0]->atnum == 100002,
+                 "Hybrid-36 CONECT not read.");
+
+#ifndef MS_WINDOWS   
+   /* Set temp file name */
+   mkstemp(test_output_filename);
+#endif
+
+   /* write output file */
+   fp = fopen(test_output_filename,"w");
+   blWriteWholePDB(fp, wpdb);
+   fclose(fp);
+
+   /* compare output file to example file */
+   strcat(test_example_filename, filename_example);
+   files_identical = wholepdb_compare_files(test_example_filename, 
+                                            test_output_filename);
+
+   /* remove output file */
+   remove(test_output_filename);
+  
+   /* return test result */
+   ck_assert_msg(files_identical, test_message);
+}
+END_TEST
+
 
 
 /* Create Suite */
@@ -421,6 +473,7 @@ Suite *wholepdb_suite(void)
    tcase_add_test(tc_core, test_write_pdbml_02);
    tcase_add_test(tc_core, test_read_write_pdb);
    tcase_add_test(tc_core, test_read_write_pdbml);   
+   tcase_add_test(tc_core, test_read_write_hybrid36);
    suite_add_tcase(s, tc_core);
 
    return s;
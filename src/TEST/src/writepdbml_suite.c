@@ -3,8 +3,8 @@
 
    \file       writepdbml_suite.c
    
-   \version    V1.5
-   \date       02.04.15
+   \version    V1.6
+   \date       17.10.26
    \brief      Test suite for writing pdb and pdbml data to file.
    
    \copyright  (c) UCL / Dr. Andrew C. R. Martin 1993-2014
@@ -54,6 +54,8 @@
                   longer rewinds. By: CTP
 -  V1.4  12.09.14 Update tests for MS Windows. By: CTP
 -  V1.5  02.04.15 Update tests for segment ID. By: CTP
+-  V1.6  17.10.26 Added test_write_pdbml_data_13 for attribute columns.
+                  By: ACRM
 
 *************************************************************************/
 
@@ -963,6 +965,52 @@ START_TEST(test_write_pdbml_data_12)
 END_TEST
 
 
+START_TEST(test_write_pdbml_data_13)
+{
+   /* set message and example file */
+   char test_error_msg[] = "Write attribute columns.";
+   char filename[]       = "test_alpha_carbon_attrib.xml";
+   PDBATTRIBS *attribs;
+   int        energy, count, label;
+
+   /* Set attributes and register them as tags */
+   attribs = blCreatePDBAttribs(pdb_out);
+   energy  = blAddPDBAttrib(attribs, "energy", PDBATTRIB_REAL,   0);
+   count   = blAddPDBAttrib(attribs, "count",  PDBATTRIB_INT,    0);
+   label   = blAddPDBAttrib(attribs, "label",  PDBATTRIB_STRING, 4);
+   ck_assert(blSetPDBAttribReal(attribs, energy, pdb_out, -1.5));
+   ck_assert(blSetPDBAttribInt(attribs, count, pdb_out, 42));
+   ck_assert(blSetPDBAttribString(attribs, label, pdb_out, "core"));
+   ck_assert_int_eq(blAddPDBAttrib(attribs, "count", PDBATTRIB_INT, 0),
+                    count);
+   ck_assert_int_eq(blAddPDBAttrib(attribs, "count", PDBATTRIB_REAL, 0),
+                    -1);
+   ck_assert_int_eq(blGetPDBAttribInt(attribs, count, pdb_out), 42);
+   ck_assert(blAddPDBAttribTag(attribs, energy, "pdbx_energy"));
+   ck_assert(blAddPDBAttribTag(attribs, count,  NULL));
+   ck_assert(blAddPDBAttribTag(attribs, label,  NULL));
+
+   /* write test file */
+   fp = fopen(test_output_filename,"w");
+   blWritePDB(fp, pdb_out);
+   fclose(fp);
+   blClearPDBTagVars();
+   blFreePDBAttribs(attribs);
+
+   /* compare to example file */
+   strcat(test_example_filename, filename);
+   files_identical = writepdbml_compare_files(test_example_filename, 
+                                              test_output_filename);
+
+   /* remove output file */
+   remove(test_output_filename);
+  
+   /* return test result */
+   ck_assert_msg(files_identical, test_error_msg);
+}
+END_TEST
+
+
 /* PDBML Ion */
 START_TEST(test_write_pdbml_ion_data_01)
 {
@@ -1093,6 +1141,7 @@ Suite *writepdbml_suite(void)
    tcase_add_test(tc_pdbml, test_write_pdbml_data_10);
    tcase_add_test(tc_pdbml, test_write_pdbml_data_11);
    tcase_add_test(tc_pdbml, test_write_pdbml_data_12);
+   tcase_add_test(tc_pdbml, test_write_pdbml_data_13);
    suite_add_tcase(s, tc_pdbml);
 
    /* PDBML_ion test case */
@@ -72,6 +72,7 @@
 #include "../../MathType.h"
 #include "../../pdb.h"
 #include "../../macros.h"
+#include "../../pdbtagvars.h"
 
 /* Prototypes */
 Suite *writepdbml_suite(void);
@@ -0,0 +1,217 @@
+/************************************************************************/
+/**
+
+   \file       ThreadPool.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Running a worker function on a pool of threads
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+
+   Description:
+   ============
+
+   The routines that divide their work between threads all follow the
+   same pattern: a worker function is run by a number of threads (the
+   calling thread being one of them) and each worker takes items of
+   work in turn from a counter shared by the threads until none are
+   left.
+
+   blRunThreadPool() runs the worker and blThreadPoolIncrement() takes
+   the next value of a shared counter. If the library is compiled
+   without PTHREAD_SUPPORT, the calling thread runs the worker and the
+   counter is incremented without locking.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   static void *Worker(void *arg)
+   {
+      SCAN *scan = (SCAN *)arg;
+      int  i;
+
+      while((i = blThreadPoolIncrement(&(scan->next))) < scan->nitems)
+         ...
+      return(NULL);
+   }
+   ...
+   scan.next = 0;
+   blRunThreadPool(Worker, (void *)&scan, 0, MIN(nthreads, nitems));
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    General Programming
+   #SUBGROUP Miscellaneous
+
+   #FUNCTION  blRunThreadPool()
+   Runs a worker function on a pool of threads
+
+   #FUNCTION  blThreadPoolIncrement()
+   Increments a counter shared between threads
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdlib.h>
+#ifdef PTHREAD_SUPPORT
+#include <pthread.h>
+#endif
+
+#include "SysDefs.h"
+#include "macros.h"
+#include "threadpool.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+
+/************************************************************************/
+/* Globals
+*/
+#ifdef PTHREAD_SUPPORT
+static pthread_mutex_t sMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/************************************************************************/
+/* Prototypes
+*/
+
+
+/************************************************************************/
+/*>void blRunThreadPool(void *(*worker)(void *), void *args, 
+                        size_t argSize, int nthreads)
+   -----------------------------------------------------------
+*//**
+
+   \param[in]     *worker   Worker function
+   \param[in,out] *args     Arguments for the worker
+   \param[in]     argSize   Size of each argument, or 0 if all the
+                            threads share one argument
+   \param[in]     nthreads  Number of threads (including the calling 
+                            thread)
+
+   Runs a worker function on up to nthreads threads and waits for them
+   all to finish. The calling thread is one of them. If argSize is 0,
+   every thread is passed args; otherwise args is an array of nthreads
+   arguments of argSize bytes and thread i is passed the i'th.
+
+   With separate arguments, the calling thread also runs the worker
+   for any argument whose thread could not be created, so each is
+   always dealt with. Without PTHREAD_SUPPORT, the calling thread runs
+   the worker for each argument in turn.
+
+-  17.10.26 Original   By: ACRM
+*/
+void blRunThreadPool(void *(*worker)(void *), void *args, size_t argSize,
+                     int nthreads)
+{
+   char      *arg = (char *)args;
+   int       i;
+#ifdef PTHREAD_SUPPORT
+   pthread_t *threads = NULL;
+   BOOL      *started = NULL;
+
+   if(nthreads > 1)
+   {
+      threads = (pthread_t *)malloc(nthreads * sizeof(pthread_t));
+      started = (BOOL *)malloc(nthreads * sizeof(BOOL));
+   }
+   if((threads != NULL) && (started != NULL))
+   {
+      for(i=1; i<nthreads; i++)
+      {
+         started[i] = (pthread_create(&(threads[i]), NULL, worker,
+                                      (void *)(arg + i*argSize)) == 0);
+      }
+
+      (*worker)((void *)arg);
+
+      for(i=1; i<nthreads; i++)
+      {
+         if(started[i])
+            pthread_join(threads[i], NULL);
+         else if(argSize != 0)
+            (*worker)((void *)(arg + i*argSize));
+      }
+
+      free(threads);
+      free(started);
+      return;
+   }
+   FREE(threads);
+   FREE(started);
+#endif
+
+   if(argSize == 0)
+      nthreads = 1;
+   for(i=0; i<nthreads; i++)
+      (*worker)((void *)(arg + i*argSize));
+}
+
+
+/************************************************************************/
+/*>int blThreadPoolIncrement(int *counter)
+   ---------------------------------------
+*//**
+
+   \param[in,out] *counter  Counter shared between threads
+   \return                  The value of the counter before it was
+                            incremented
+
+   Increments a counter shared between the threads of a pool, such as
+   the index of the next item of work or a count of items done. With
+   PTHREAD_SUPPORT this is done under a lock.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blThreadPoolIncrement(int *counter)
+{
+   int value;
+
+#ifdef PTHREAD_SUPPORT
+   pthread_mutex_lock(&sMutex);
+#endif
+   value = (*counter)++;
+#ifdef PTHREAD_SUPPORT
+   pthread_mutex_unlock(&sMutex);
+#endif
+
+   return(value);
+}
@@ -0,0 +1,1082 @@
+/************************************************************************/
+/**
+
+   \file       Topology.c
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Secondary structure topology strings and index
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Describes each chain as a string of letters, one for each secondary
+   structure element (SSE), in the alphabet of topmat.mat:
+
+\verbatim
+              <--Distant-->   <--Adjacent-->
+              Sheet   Helix   Sheet   Helix
+   Up         A       G       M       S
+   Right      B       H       N       T
+   Down       C       I       O       U
+   Left       D       J       P       V
+   Back       E       K       Q       W
+   Forward    F       L       R       X
+\endverbatim
+
+   with lower case for buried elements. The SSEs are the helices (H) of
+   at least TOPO_MINHELIX residues and strands (E) of at least
+   TOPO_MINSTRAND residues assigned by blCalcSecStrucPDB(). The axis of
+   each runs from the centre of its first to the centre of its last
+   4 (helix) or 2 (strand) C-alphas. The first axis defines Up; Right
+   is the direction from the centre of the first SSE to the second,
+   made perpendicular to Up. Each SSE takes the direction nearest to
+   its axis. An SSE is adjacent if any of its C-alphas is within
+   TOPO_ADJACENTDIST of one in the previous SSE, and buried if its
+   C-alphas have on average at least TOPO_BURIEDCOUNT other C-alphas
+   of the chain within 10A.
+
+   An index holds the strings for an archive of chains and is searched
+   with a query string in three steps, each cheaper than the next:
+   - only entries whose length is within a factor of lenRatio of the
+     query are considered;
+   - each SSE is reduced to its type and direction (12 symbols) and an
+     inverted index of the pairs of consecutive symbols finds the
+     entries sharing at least a fraction minShared of those in the
+     query;
+   - the survivors are aligned with blMDMatrixAffinealign() using
+     topmat.mat and kept if the score, as a fraction of the query's
+     score against itself, reaches the cutoff.
+   The hits are a prefilter for full structural comparison, such as
+   with blStructureAlign().
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   TOPOINDEX *index;
+   TOPOHIT   *hits;
+   MDMATRIX  *mdm;
+   int       nhits;
+
+   mdm   = blReadMDMatrix(TOPO_MATFILE);
+   index = blReadTopologyIndex(fp);
+   hits  = blSearchTopologyIndex(index, mdm, query, (REAL)0.6, &nhits);
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP Analyzing structures
+
+   #FUNCTION  blTopologyStringPDB()
+   Creates the secondary structure topology string for a chain
+
+   #FUNCTION  blAllocTopologyIndex()
+   Creates an empty index of topology strings
+
+   #FUNCTION  blFreeTopologyIndex()
+   Frees an index of topology strings
+
+   #FUNCTION  blAddTopologyIndex()
+   Adds a topology string to an index
+
+   #FUNCTION  blAddTopologyIndexPDB()
+   Adds the topology string of each chain in a structure to an index
+
+   #FUNCTION  blReadTopologyIndex()
+   Reads an index of topology strings from a file
+
+   #FUNCTION  blWriteTopologyIndex()
+   Writes an index of topology strings to a file
+
+   #FUNCTION  blSearchTopologyIndex()
+   Finds the entries in an index whose topology matches a query
+
+   #FUNCTION  blFreeTopologyHits()
+   Frees a list of topology index hits
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "general.h"
+#include "pdb.h"
+#include "seq.h"
+#include "secstr.h"
+#include "topology.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define MAXBUFF       1024
+#define ALLOCSTEP     1024
+#define NEIGHBDIST    ((REAL)10.0) /* Radius for counting neighbours    */
+#define NSYMBOLS      12           /* SSE type and direction            */
+
+/* Directions of an SSE in the order used by topmat.mat                 */
+#define DIR_UP        0
+#define DIR_RIGHT     1
+#define DIR_DOWN      2
+#define DIR_LEFT      3
+#define DIR_BACK      4
+#define DIR_FORWARD   5
+
+/* Reduces a topology letter to its SSE type and direction (0..11)      */
+#define TOPOSYMBOL(c) ((toupper(c) - 'A') % NSYMBOLS)
+#define ISTOPOLETTER(c) ((toupper(c) >= 'A') && (toupper(c) <= 'X'))
+
+#define DOT3(a, b) ((a).x*(b).x + (a).y*(b).y + (a).z*(b).z)
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static VEC3F MeanCoor(COOR *ca, int start, int n);
+static void  Normalize(VEC3F *v);
+static char  SSELetter(VEC3F axis, VEC3F *frame, BOOL helix,
+                       BOOL adjacent, BOOL buried);
+static char  *CopyString(char *string);
+static int   CountKmers(char *topology, BOOL *seen, int *kmers);
+static BOOL  BuildIndex(TOPOINDEX *index);
+static int   CompareHits(const void *a, const void *b);
+
+
+/************************************************************************/
+/*>static VEC3F MeanCoor(COOR *ca, int start, int n)
+   -------------------------------------------------
+*//**
+
+   \param[in]     *ca       Array of coordinates
+   \param[in]     start     First to use
+   \param[in]     n         Number to use
+   \return                  Their centre
+
+-  17.10.26 Original   By: ACRM
+*/
+static VEC3F MeanCoor(COOR *ca, int start, int n)
+{
+   VEC3F mean;
+   int   i;
+
+   mean.x = mean.y = mean.z = (REAL)0.0;
+   for(i=start; i<start+n; i++)
+   {
+      mean.x += ca[i].x;
+      mean.y += ca[i].y;
+      mean.z += ca[i].z;
+   }
+   mean.x /= n;
+   mean.y /= n;
+   mean.z /= n;
+
+   return(mean);
+}
+
+
+/************************************************************************/
+/*>static void Normalize(VEC3F *v)
+   -------------------------------
+*//**
+
+   \param[in,out] *v        Vector
+
+   Scales a vector to unit length (leaving a zero vector alone)
+
+-  17.10.26 Original   By: ACRM
+*/
+static void Normalize(VEC3F *v)
+{
+   REAL len = (REAL)sqrt(DOT3(*v, *v));
+
+   if(len > (REAL)0.0)
+   {
+      v->x /= len;
+      v->y /= len;
+      v->z /= len;
+   }
+}
+
+
+/************************************************************************/
+/*>static char SSELetter(VEC3F axis, VEC3F *frame, BOOL helix,
+                         BOOL adjacent, BOOL buried)
+   -----------------------------------------------------------
+*//**
+
+   \param[in]     axis      Axis of the SSE
+   \param[in]     *frame    Right, Back and Up unit vectors
+   \param[in]     helix     Is it a helix (rather than a strand)?
+   \param[in]     adjacent  Is it adjacent to the previous SSE?
+   \param[in]     buried    Is it buried?
+   \return                  Topology letter
+
+   Finds the direction nearest to the axis and encodes the SSE
+
+-  17.10.26 Original   By: ACRM
+*/
+static char SSELetter(VEC3F axis, VEC3F *frame, BOOL helix,
+                      BOOL adjacent, BOOL buried)
+{
+   REAL right = DOT3(axis, frame[0]),
+        back  = DOT3(axis, frame[1]),
+        up    = DOT3(axis, frame[2]);
+   int  dir;
+   char letter;
+
+   if((ABS(up) >= ABS(right)) && (ABS(up) >= ABS(back)))
+      dir = (up    >= 0.0) ? DIR_UP    : DIR_DOWN;
+   else if(ABS(right) >= ABS(back))
+      dir = (right >= 0.0) ? DIR_RIGHT : DIR_LEFT;
+   else
+      dir = (back  >= 0.0) ? DIR_BACK  : DIR_FORWARD;
+
+   letter = (char)('A' + (adjacent ? 12 : 0) + (helix ? 6 : 0) + dir);
+   if(buried)
+      letter = (char)tolower(letter);
+
+   return(letter);
+}
+
+
+/************************************************************************/
+/*>char *blTopologyStringPDB(PDB *pdbStart, PDB *pdbStop)
+   ------------------------------------------------------
+*//**
+
+   \param[in,out] *pdbStart   Start of a chain in a PDB linked list
+   \param[in]     *pdbStop    Start of the next chain (or NULL)
+   \return                    Malloc'd topology string (empty if there
+                              are no SSEs) or NULL on error
+
+   Creates the topology string for a chain. blCalcSecStrucPDB() is
+   called for the chain, so the secstr field is set.
+
+-  17.10.26 Original   By: ACRM
+*/
+char *blTopologyStringPDB(PDB *pdbStart, PDB *pdbStop)
+{
+   PDB   *p,
+         *prev     = NULL;
+   COOR  *ca       = NULL;
+   VEC3F *axes     = NULL,
+         frame[3],
+         first;
+   REAL  d;
+   char  *ss       = NULL,
+         *topology = NULL;
+   int   *sseStart = NULL,
+         *sseLen   = NULL,
+         nca       = 0,
+         nsse      = 0,
+         i, j, k, nend;
+
+   if((pdbStart == NULL) ||
+      (blCalcSecStrucPDB(pdbStart, pdbStop, FALSE) != SECSTR_ERR_NOERR))
+      return(NULL);
+
+   for(p=pdbStart; p!=pdbStop; NEXT(p))
+   {
+      if(!strncmp(p->record_type, "ATOM  ", 6) &&
+         !strncmp(p->atnam, "CA  ", 4) &&
+         ((prev == NULL) || !RESIDMATCH(p, prev)))
+      {
+         nca++;
+         prev = p;
+      }
+   }
+
+   ca       = (COOR  *)malloc((nca+1) * sizeof(COOR));
+   ss       = (char  *)malloc((nca+1) * sizeof(char));
+   sseStart = (int   *)malloc((nca+1) * sizeof(int));
+   sseLen   = (int   *)malloc((nca+1) * sizeof(int));
+   axes     = (VEC3F *)malloc((nca+1) * sizeof(VEC3F));
+   topology = (char  *)malloc((nca+1) * sizeof(char));
+   if((ca == NULL) || (ss == NULL) || (sseStart == NULL) ||
+      (sseLen == NULL) || (axes == NULL) || (topology == NULL))
+   {
+      FREE(topology);
+      goto Cleanup;
+   }
+
+   /* Collect the C-alphas and whether they are in a helix or strand    */
+   nca  = 0;
+   prev = NULL;
+   for(p=pdbStart; p!=pdbStop; NEXT(p))
+   {
+      if(!strncmp(p->record_type, "ATOM  ", 6) &&
+         !strncmp(p->atnam, "CA  ", 4) &&
+         ((prev == NULL) || !RESIDMATCH(p, prev)))
+      {
+         ca[nca].x = p->x;
+         ca[nca].y = p->y;
+         ca[nca].z = p->z;
+         ss[nca++] = SECSTR_ISHELIX(p->secstr)  ? 'H' :
+                     (SECSTR_ISSTRAND(p->secstr) ? 'E' : '-');
+         prev      = p;
+      }
+   }
+
+   /* Find the SSEs                                                     */
+   for(i=0; i<nca; i=j)
+   {
+      for(j=i+1; (j<nca) && (ss[j]==ss[i]); j++);
+
+      if(((ss[i] == 'H') && (j-i >= TOPO_MINHELIX)) ||
+         ((ss[i] == 'E') && (j-i >= TOPO_MINSTRAND)))
+      {
+         sseStart[nsse] = i;
+         sseLen[nsse]   = j-i;
+         nend           = (ss[i] == 'H') ? 4 : 2;
+         axes[nsse]     = MeanCoor(ca, j-nend, nend);
+         first          = MeanCoor(ca, i, nend);
+         axes[nsse].x  -= first.x;
+         axes[nsse].y  -= first.y;
+         axes[nsse].z  -= first.z;
+         nsse++;
+      }
+   }
+   topology[nsse] = '\0';
+   if(nsse == 0)
+      goto Cleanup;
+
+   /* Up is the first axis and Right points to the second SSE           */
+   frame[2] = axes[0];
+   Normalize(&(frame[2]));
+   frame[0].x = frame[0].y = frame[0].z = (REAL)0.0;
+   if(nsse > 1)
+   {
+      VEC3F c0 = MeanCoor(ca, sseStart[0], sseLen[0]),
+            c1 = MeanCoor(ca, sseStart[1], sseLen[1]);
+
+      frame[0].x = c1.x - c0.x;
+      frame[0].y = c1.y - c0.y;
+      frame[0].z = c1.z - c0.z;
+      d = DOT3(frame[0], frame[2]);
+      frame[0].x -= d * frame[2].x;
+      frame[0].y -= d * frame[2].y;
+      frame[0].z -= d * frame[2].z;
+   }
+   if(DOT3(frame[0], frame[0]) < (REAL)0.0001)
+   {
+      /* Any direction perpendicular to Up                              */
+      frame[0].x = (ABS(frame[2].x) < (REAL)0.9) ? (REAL)1.0 : (REAL)0.0;
+      frame[0].y = (ABS(frame[2].x) < (REAL)0.9) ? (REAL)0.0 : (REAL)1.0;
+      frame[0].z = (REAL)0.0;
+      d = DOT3(frame[0], frame[2]);
+      frame[0].x -= d * frame[2].x;
+      frame[0].y -= d * frame[2].y;
+      frame[0].z -= d * frame[2].z;
+   }
+   Normalize(&(frame[0]));
+   /* Back = Up x Right                                                 */
+   frame[1].x = frame[2].y*frame[0].z - frame[2].z*frame[0].y;
+   frame[1].y = frame[2].z*frame[0].x - frame[2].x*frame[0].z;
+   frame[1].z = frame[2].x*frame[0].y - frame[2].y*frame[0].x;
+
+   for(k=0; k<nsse; k++)
+   {
+      BOOL adjacent  = FALSE;
+      REAL neighbs   = (REAL)0.0;
+
+      /* Adjacent to the previous SSE?                                  */
+      for(i=sseStart[k]; (k>0) && !adjacent &&
+             (i<sseStart[k]+sseLen[k]); i++)
+      {
+         for(j=sseStart[k-1]; j<sseStart[k-1]+sseLen[k-1]; j++)
+         {
+            if(DISTSQ(&(ca[i]), &(ca[j])) <
+               TOPO_ADJACENTDIST * TOPO_ADJACENTDIST)
+            {
+               adjacent = TRUE;
+               break;
+            }
+         }
+      }
+
+      /* Mean number of C-alpha neighbours                              */
+      for(i=sseStart[k]; i<sseStart[k]+sseLen[k]; i++)
+      {
+         for(j=0; j<nca; j++)
+         {
+            if((j != i) &&
+               (DISTSQ(&(ca[i]), &(ca[j])) < NEIGHBDIST * NEIGHBDIST))
+               neighbs += (REAL)1.0;
+         }
+      }
+      neighbs /= sseLen[k];
+
+      topology[k] = SSELetter(axes[k], frame,
+                              (ss[sseStart[k]] == 'H'),
+                              adjacent, (neighbs >= TOPO_BURIEDCOUNT));
+   }
+
+Cleanup:
+   FREE(ca);
+   FREE(ss);
+   FREE(sseStart);
+   FREE(sseLen);
+   FREE(axes);
+
+   return(topology);
+}
+
+
+/************************************************************************/
+/*>TOPOINDEX *blAllocTopologyIndex(void)
+   -------------------------------------
+*//**
+
+   \return                  An empty index or NULL on error
+
+   Creates an empty index with the default prefilter settings
+   (TOPO_DEFLENRATIO and TOPO_DEFMINSHARED), which may be changed in
+   the lenRatio and minShared fields.
+
+-  17.10.26 Original   By: ACRM
+*/
+TOPOINDEX *blAllocTopologyIndex(void)
+{
+   TOPOINDEX *index;
+
+   if((index = (TOPOINDEX *)malloc(sizeof(TOPOINDEX)))==NULL)
+      return(NULL);
+
+   index->ids        = NULL;
+   index->chains     = NULL;
+   index->topologies = NULL;
+   index->lengths    = NULL;
+   index->order      = NULL;
+   index->kmerStart  = NULL;
+   index->postings   = NULL;
+   index->nentries   = 0;
+   index->maxentries = 0;
+   index->lenRatio   = TOPO_DEFLENRATIO;
+   index->minShared  = TOPO_DEFMINSHARED;
+   index->dirty      = TRUE;
+
+   return(index);
+}
+
+
+/************************************************************************/
+/*>void blFreeTopologyIndex(TOPOINDEX *index)
+   ------------------------------------------
+*//**
+
+   \param[in]     *index    Index to free
+
+   Frees an index and its strings
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeTopologyIndex(TOPOINDEX *index)
+{
+   int i;
+
+   if(index == NULL)
+      return;
+
+   for(i=0; i<index->nentries; i++)
+   {
+      FREE(index->ids[i]);
+      FREE(index->chains[i]);
+      FREE(index->topologies[i]);
+   }
+   FREE(index->ids);
+   FREE(index->chains);
+   FREE(index->topologies);
+   FREE(index->lengths);
+   FREE(index->order);
+   FREE(index->kmerStart);
+   FREE(index->postings);
+   free(index);
+}
+
+
+/************************************************************************/
+/*>static char *CopyString(char *string)
+   -------------------------------------
+*//**
+
+   \param[in]     *string   String
+   \return                  Malloc'd copy or NULL
+
+-  17.10.26 Original   By: ACRM
+*/
+static char *CopyString(char *string)
+{
+   char *copy;
+
+   if((copy = (char *)malloc(strlen(string)+1))!=NULL)
+      strcpy(copy, string);
+   return(copy);
+}
+
+
+/************************************************************************/
+/*>BOOL blAddTopologyIndex(TOPOINDEX *index, char *id, char *chain,
+                           char *topology)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in,out] *index    Index
+   \param[in]     *id       Identifier (e.g. PDB code). No spaces
+   \param[in]     *chain    Chain label (may be blank). No spaces
+   \param[in]     *topology Topology string
+   \return                  FALSE on allocation failure
+
+   Adds copies of the strings to the index. An empty topology string is
+   not added.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blAddTopologyIndex(TOPOINDEX *index, char *id, char *chain,
+                        char *topology)
+{
+   int n = index->nentries;
+
+   if(topology[0] == '\0')
+      return(TRUE);
+
+   if(n >= index->maxentries)
+   {
+      int  newMax = index->maxentries + ALLOCSTEP;
+      char **newIds, **newChains, **newTopologies;
+      int  *newLengths;
+
+      if((newIds = (char **)realloc(index->ids,
+                                    newMax * sizeof(char *)))!=NULL)
+         index->ids = newIds;
+      if((newChains = (char **)realloc(index->chains,
+                                       newMax * sizeof(char *)))!=NULL)
+         index->chains = newChains;
+      if((newTopologies = (char **)realloc(index->topologies,
+                                           newMax * sizeof(char *)))
+         !=NULL)
+         index->topologies = newTopologies;
+      if((newLengths = (int *)realloc(index->lengths,
+                                      newMax * sizeof(int)))!=NULL)
+         index->lengths = newLengths;
+      if((newIds == NULL) || (newChains == NULL) ||
+         (newTopologies == NULL) || (newLengths == NULL))
+         return(FALSE);
+      index->maxentries = newMax;
+   }
+
+   index->ids[n]        = CopyString(id);
+   index->chains[n]     = CopyString(chain);
+   index->topologies[n] = CopyString(topology);
+   if((index->ids[n] == NULL) || (index->chains[n] == NULL) ||
+      (index->topologies[n] == NULL))
+   {
+      FREE(index->ids[n]);
+      FREE(index->chains[n]);
+      FREE(index->topologies[n]);
+      return(FALSE);
+   }
+   index->lengths[n] = strlen(topology);
+   index->nentries++;
+   index->dirty = TRUE;
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>int blAddTopologyIndexPDB(TOPOINDEX *index, char *id, PDB *pdb)
+   ---------------------------------------------------------------
+*//**
+
+   \param[in,out] *index    Index
+   \param[in]     *id       Identifier for the structure. No spaces
+   \param[in,out] *pdb      PDB linked list
+   \return                  Number of chains added (-1 on error)
+
+   Calculates the topology string of each chain (with
+   blTopologyStringPDB()) and adds those with SSEs to the index
+
+-  17.10.26 Original   By: ACRM
+*/
+int blAddTopologyIndexPDB(TOPOINDEX *index, char *id, PDB *pdb)
+{
+   PDB  *chain,
+        *nextChain;
+   char *topology;
+   int  nadded = 0;
+   BOOL ok;
+
+   for(chain=pdb; chain!=NULL; chain=nextChain)
+   {
+      nextChain = blFindNextChain(chain);
+      if((topology = blTopologyStringPDB(chain, nextChain))==NULL)
+         return(-1);
+      if(topology[0] != '\0')
+      {
+         ok = blAddTopologyIndex(index, id, chain->chain, topology);
+         free(topology);
+         if(!ok)
+            return(-1);
+         nadded++;
+      }
+      else
+      {
+         free(topology);
+      }
+   }
+
+   return(nadded);
+}
+
+
+/************************************************************************/
+/*>TOPOINDEX *blReadTopologyIndex(FILE *fp)
+   ----------------------------------------
+*//**
+
+   \param[in]     *fp       File written by blWriteTopologyIndex()
+   \return                  The index or NULL on error
+
+   Reads an index. Each line gives an identifier, chain label ('-' if
+   blank) and topology string. Lines starting with '#' are ignored.
+
+-  17.10.26 Original   By: ACRM
+*/
+TOPOINDEX *blReadTopologyIndex(FILE *fp)
+{
+   TOPOINDEX *index;
+   char      buffer[MAXBUFF],
+             id[MAXBUFF],
+             chain[MAXBUFF],
+             topology[MAXBUFF];
+
+   if((index = blAllocTopologyIndex())==NULL)
+      return(NULL);
+
+   while(fgets(buffer, MAXBUFF, fp))
+   {
+      if((buffer[0] == '#') ||
+         (sscanf(buffer, "%s %s %s", id, chain, topology) != 3))
+         continue;
+      if(!strcmp(chain, "-"))
+         chain[0] = '\0';
+      if(!blAddTopologyIndex(index, id, chain, topology))
+      {
+         blFreeTopologyIndex(index);
+         return(NULL);
+      }
+   }
+
+   return(index);
+}
+
+
+/************************************************************************/
+/*>void blWriteTopologyIndex(FILE *fp, TOPOINDEX *index)
+   -----------------------------------------------------
+*//**
+
+   \param[in]     *fp       Output file
+   \param[in]     *index    Index
+
+   Writes an index in the form read by blReadTopologyIndex()
+
+-  17.10.26 Original   By: ACRM
+*/
+void blWriteTopologyIndex(FILE *fp, TOPOINDEX *index)
+{
+   int i;
+
+   for(i=0; i<index->nentries; i++)
+   {
+      fprintf(fp, "%s %s %s\n", index->ids[i],
+              ((index->chains[i][0] == '\0') ||
+               (index->chains[i][0] == ' ')) ? "-" : index->chains[i],
+              index->topologies[i]);
+   }
+}
+
+
+/************************************************************************/
+/*>static int CountKmers(char *topology, BOOL *seen, int *kmers)
+   -------------------------------------------------------------
+*//**
+
+   \param[in]     *topology Topology string
+   \param[in,out] *seen     TOPO_NKMERS flags, all FALSE on entry and
+                            exit
+   \param[out]    *kmers    The distinct 2-mers (up to TOPO_NKMERS)
+   \return                  Number of distinct 2-mers
+
+   Finds the distinct pairs of consecutive reduced symbols in a string
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CountKmers(char *topology, BOOL *seen, int *kmers)
+{
+   int i, k,
+       nkmers = 0;
+
+   for(i=0; (topology[i] != '\0') && (topology[i+1] != '\0'); i++)
+   {
+      if(!ISTOPOLETTER(topology[i]) || !ISTOPOLETTER(topology[i+1]))
+         continue;
+      k = TOPOSYMBOL(topology[i]) * NSYMBOLS + TOPOSYMBOL(topology[i+1]);
+      if(!seen[k])
+      {
+         seen[k]          = TRUE;
+         kmers[nkmers++]  = k;
+      }
+   }
+   for(i=0; i<nkmers; i++)
+      seen[kmers[i]] = FALSE;
+
+   return(nkmers);
+}
+
+
+/************************************************************************/
+/*>static BOOL BuildIndex(TOPOINDEX *index)
+   ----------------------------------------
+*//**
+
+   \param[in,out] *index    Index
+   \return                  FALSE on allocation failure
+
+   Sorts the entries by length (a counting sort) and builds the
+   inverted index of 2-mers
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL BuildIndex(TOPOINDEX *index)
+{
+   BOOL seen[TOPO_NKMERS];
+   int  kmers[TOPO_NKMERS],
+        *count  = NULL,
+        maxlen  = 0,
+        ntotal  = 0,
+        i, k, nkmers;
+
+   FREE(index->order);
+   FREE(index->kmerStart);
+   FREE(index->postings);
+
+   for(i=0; i<TOPO_NKMERS; i++)
+      seen[i] = FALSE;
+   for(i=0; i<index->nentries; i++)
+   {
+      if(index->lengths[i] > maxlen)
+         maxlen = index->lengths[i];
+   }
+
+   index->order     = (int *)malloc((index->nentries+1) * sizeof(int));
+   index->kmerStart = (int *)calloc(TOPO_NKMERS+1, sizeof(int));
+   count            = (int *)calloc(maxlen+2, sizeof(int));
+   if((index->order == NULL) || (index->kmerStart == NULL) ||
+      (count == NULL))
+   {
+      FREE(count);
+      return(FALSE);
+   }
+
+   /* Counting sort on length                                           */
+   for(i=0; i<index->nentries; i++)
+      count[index->lengths[i]+1]++;
+   for(i=1; i<=maxlen+1; i++)
+      count[i] += count[i-1];
+   for(i=0; i<index->nentries; i++)
+      index->order[count[index->lengths[i]]++] = i;
+   free(count);
+
+   /* Count the postings for each 2-mer and make them offsets           */
+   for(i=0; i<index->nentries; i++)
+   {
+      nkmers = CountKmers(index->topologies[i], seen, kmers);
+      for(k=0; k<nkmers; k++)
+         index->kmerStart[kmers[k]+1]++;
+      ntotal += nkmers;
+   }
+   for(k=1; k<=TOPO_NKMERS; k++)
+      index->kmerStart[k] += index->kmerStart[k-1];
+
+   if((index->postings = (int *)malloc((ntotal+1) * sizeof(int)))==NULL)
+      return(FALSE);
+
+   /* Fill the postings, using kmerStart[] as the next free slot        */
+   for(i=0; i<index->nentries; i++)
+   {
+      nkmers = CountKmers(index->topologies[i], seen, kmers);
+      for(k=0; k<nkmers; k++)
+         index->postings[index->kmerStart[kmers[k]]++] = i;
+   }
+   /* The starts have moved to the ends; shift them back                */
+   for(k=TOPO_NKMERS; k>0; k--)
+      index->kmerStart[k] = index->kmerStart[k-1];
+   index->kmerStart[0] = 0;
+
+   index->dirty = FALSE;
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static int CompareHits(const void *a, const void *b)
+   ----------------------------------------------------
+*//**
+
+   \param[in]     *a        Pointer to a TOPOHIT pointer
+   \param[in]     *b        Pointer to a TOPOHIT pointer
+   \return                  Comparison for qsort() giving decreasing
+                            score then increasing entry number
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CompareHits(const void *a, const void *b)
+{
+   TOPOHIT *hitA = *(TOPOHIT **)a,
+           *hitB = *(TOPOHIT **)b;
+
+   if(hitA->score > hitB->score)
+      return(-1);
+   if(hitA->score < hitB->score)
+      return(1);
+   return(hitA->entry - hitB->entry);
+}
+
+
+/************************************************************************/
+/*>TOPOHIT *blSearchTopologyIndex(TOPOINDEX *index, MDMATRIX *mdm,
+                                  char *query, REAL minScore,
+                                  int *nhits)
+   ---------------------------------------------------------------
+*//**
+
+   \param[in,out] *index    Index (rebuilt if entries have been added)
+   \param[in]     *mdm      Topology scoring matrix (from
+                            blReadMDMatrix(TOPO_MATFILE))
+   \param[in]     *query    Query topology string
+   \param[in]     minScore  Alignment score cutoff as a fraction of the
+                            query's score against itself
+   \param[out]    *nhits    Number of hits (-1 on error)
+   \return                  Linked list of hits, best first
+
+   Finds the entries of similar length sharing enough 2-mers of SSE
+   type and direction with the query (see the index's lenRatio and
+   minShared), aligns each with the query and keeps those scoring at
+   least minScore. A query with a single SSE has no 2-mers, so all the
+   entries of similar length are aligned. The hits point to the strings
+   in the index, which must not be freed while they are in use.
+
+   Each search only reads the index once it has been built, so several
+   searches may be run at once if the index is built first (e.g. by a
+   search with an empty query).
+
+-  17.10.26 Original   By: ACRM
+*/
+TOPOHIT *blSearchTopologyIndex(TOPOINDEX *index, MDMATRIX *mdm,
+                               char *query, REAL minScore, int *nhits)
+{
+   TOPOHIT *hits     = NULL,
+           **sorted  = NULL;
+   BOOL    seen[TOPO_NKMERS];
+   char    *align1   = NULL,
+           *align2   = NULL;
+   int     kmers[TOPO_NKMERS],
+           *shared   = NULL,
+           *cands    = NULL,
+           qlen, minLen, maxLen, need, nkmers, ncands, alen,
+           selfScore = 0,
+           i, k, e;
+   BOOL    ok        = TRUE;
+
+   *nhits = 0;
+   if(index->dirty && !BuildIndex(index))
+   {
+      *nhits = (-1);
+      return(NULL);
+   }
+   if(((qlen = strlen(query)) == 0) || (index->nentries == 0))
+      return(NULL);
+
+   minLen = (int)ceil(qlen / index->lenRatio);
+   maxLen = (int)(qlen * index->lenRatio);
+   for(i=0; i<qlen; i++)
+      selfScore += blMDMatrixScore(mdm, query[i], query[i]);
+   if(selfScore <= 0)
+      return(NULL);
+
+   shared = (int *)calloc(index->nentries, sizeof(int));
+   cands  = (int *)malloc(index->nentries * sizeof(int));
+   align1 = (char *)malloc((qlen + maxLen + 1) * sizeof(char));
+   align2 = (char *)malloc((qlen + maxLen + 1) * sizeof(char));
+   if((shared == NULL) || (cands == NULL) || (align1 == NULL) ||
+      (align2 == NULL))
+   {
+      ok = FALSE;
+      goto Cleanup;
+   }
+
+   /* Find the candidates                                               */
+   for(i=0; i<TOPO_NKMERS; i++)
+      seen[i] = FALSE;
+   nkmers = CountKmers(query, seen, kmers);
+   ncands = 0;
+   if(nkmers)
+   {
+      need = (int)ceil(index->minShared * nkmers);
+      if(need < 1)
+         need = 1;
+      for(k=0; k<nkmers; k++)
+      {
+         for(i=index->kmerStart[kmers[k]];
+             i<index->kmerStart[kmers[k]+1];
+             i++)
+         {
+            e = index->postings[i];
+            if((++shared[e] == need) &&
+               (index->lengths[e] >= minLen) &&
+               (index->lengths[e] <= maxLen))
+               cands[ncands++] = e;
+         }
+      }
+   }
+   else
+   {
+      for(i=0; i<index->nentries; i++)
+      {
+         e = index->order[i];
+         if(index->lengths[e] > maxLen)
+            break;
+         if(index->lengths[e] >= minLen)
+            cands[ncands++] = e;
+      }
+   }
+
+   /* Align the candidates                                              */
+   for(i=0; i<ncands; i++)
+   {
+      TOPOHIT *hit;
+      int     score;
+
+      e     = cands[i];
+      score = blMDMatrixAffinealign(mdm, query, qlen,
+                                    index->topologies[e],
+                                    index->lengths[e], FALSE, FALSE,
+                                    TOPO_GAPOPEN, TOPO_GAPEXT, 0,
+                                    align1, align2, &alen);
+      if((REAL)score / selfScore < minScore)
+         continue;
+
+      if((hit = (TOPOHIT *)malloc(sizeof(TOPOHIT)))==NULL)
+      {
+         ok = FALSE;
+         goto Cleanup;
+      }
+      hit->next     = hits;
+      hit->id       = index->ids[e];
+      hit->chain    = index->chains[e];
+      hit->topology = index->topologies[e];
+      hit->entry    = e;
+      hit->rawScore = score;
+      hit->score    = (REAL)score / selfScore;
+      hits          = hit;
+      (*nhits)++;
+   }
+
+   /* Sort the hits, best first                                         */
+   if(*nhits > 1)
+   {
+      TOPOHIT *h;
+
+      if((sorted = (TOPOHIT **)malloc(*nhits * sizeof(TOPOHIT *)))==NULL)
+      {
+         ok = FALSE;
+         goto Cleanup;
+      }
+      for(h=hits, i=0; h!=NULL; NEXT(h))
+         sorted[i++] = h;
+      qsort(sorted, *nhits, sizeof(TOPOHIT *), CompareHits);
+      for(i=0; i<*nhits-1; i++)
+         sorted[i]->next = sorted[i+1];
+      sorted[*nhits-1]->next = NULL;
+      hits = sorted[0];
+   }
+
+Cleanup:
+   FREE(shared);
+   FREE(cands);
+   FREE(align1);
+   FREE(align2);
+   FREE(sorted);
+   if(!ok)
+   {
+      blFreeTopologyHits(hits);
+      hits   = NULL;
+      *nhits = (-1);
+   }
+
+   return(hits);
+}
+
+
+/************************************************************************/
+/*>void blFreeTopologyHits(TOPOHIT *hits)
+   --------------------------------------
+*//**
+
+   \param[in]     *hits     Linked list of hits
+
+   Frees a list of hits (but not the strings in the index)
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeTopologyHits(TOPOHIT *hits)
+{
+   FREELIST(hits, TOPOHIT);
+}
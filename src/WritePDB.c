@@ -3,11 +3,11 @@
 
    \file       WritePDB.c
    
-   \version    V1.32
-   \date       17.11.21
+   \version    V1.37
+   \date       17.10.26
    \brief      Write a PDB file from a linked list
    
-   \copyright  (c) UCL / Prof. Andrew C. R. Martin 1993-2021
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 1993-2026
    \author     Prof. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -116,6 +116,15 @@
 -  V1.31 07.08.18 Increased text buffer sizes to silence gcc 7.3.1 
                   with -O2
 -  V1.32 17.11.21 Added blCreateSEQRES()
+-  V1.33 17.10.26 Added blWritePDBView(). blWritePDBAsPDBorGromos() now
+                  uses WriteViewAsPDBorGromos()
+-  V1.34 17.10.26 Atom and residue numbers which don't fit in their
+                  columns are written as hybrid-36
+-  V1.35 17.10.26 blDoWritePDBAsPDBML() writes tags registered with
+                  INIT_PDBTAGVAR() and blAddPDBAttribTag()
+-  V1.36 17.10.26 Counts atoms written and times the writers when
+                  compiled with INSTRUMENT_SUPPORT
+-  V1.37 17.10.26 Initialises WHOLEPDB bonds
 
 *************************************************************************/
 /* Doxygen
@@ -151,6 +160,9 @@
    Writes a PDB linked list to a file in PDB format or the modified
    GROMOS version
 
+   #FUNCTION blWritePDBView()
+   Writes the atoms of a PDBVIEW to a file without copying them
+
    #FUNCTION blWritePDBRecordAtnam()
    Writes a single PDB record in PDB format using atom data from the
    atnam field rather than the atnam_raw field
@@ -205,10 +217,15 @@
 #include "hash.h"
 #include "fsscanf.h"
 #include "seq.h"
+#include "pdbview.h"
+#include "pdbtagvars.h"
+#include "instrument.h"
 
 /************************************************************************/
 /* Prototypes
 */
+static int WriteViewAsPDBorGromos(FILE *fp, PDBVIEW *view, 
+                                  BOOL doGromos);
 static void WriteMaster(FILE *fp, WHOLEPDB *wpdb, int numConect,
                         int numTer);
 static BOOL blDoWritePDBAsPDBML(FILE *fp, WHOLEPDB  *wpdb, BOOL doWhole);
@@ -317,17 +334,97 @@ BOOL blFormatCheckWritePDB(PDB *pdb)
 -  23.02.15 Write correct format TER cards. Now returns int    By: ACRM
 -  24.02.15 Renamed to blWritePDBAsPDBorGromos() and added doGromos
             flag
-
+-  17.10.26 Work moved to WriteViewAsPDBorGromos()   By: ACRM
 */
 int blWritePDBAsPDBorGromos(FILE *fp, PDB  *pdb, BOOL doGromos)
+{
+   PDBVIEW view;
+
+   blInitPDBView(&view, pdb);
+
+   return(WriteViewAsPDBorGromos(fp, &view, doGromos));
+}
+
+
+/************************************************************************/
+/*>int blWritePDBView(FILE *fp, PDBVIEW *view)
+   -------------------------------------------
+*//**
+
+   \param[in]     *fp   PDB file pointer to be written
+   \param[in]     *view View onto a PDB linked list
+   \return              Number of TER cards written (0 indicates error)
+
+   Writes the atoms in a view as blWritePDB() would write the equivalent
+   copied linked list. Only PDBML output needs a real linked list so, 
+   in that case, a temporary copy is made.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blWritePDBView(FILE *fp, PDBVIEW *view)
+{
+   PDB *p;
+   int i;
+
+   if((gPDBXMLForce == FORCEXML_XML) ||
+      (gPDBXMLForce == FORCEXML_NOFORCE && gPDBXML == TRUE))
+   {
+#ifdef XML_SUPPORT
+      PDB *pdb;
+
+      if((pdb = blPDBViewAsCopy(view))==NULL)
+         return(0);
+      blWritePDBAsPDBML(fp, pdb);
+      FREELIST(pdb, PDB);
+      return(1);
+#else
+      return(0);
+#endif
+   }
+
+   /* Check format                                                      */
+   for(p=PDBVIEW_FIRST(view, i); p!=NULL; p=PDBVIEW_NEXT(view, p, i))
+   {
+      if(strlen(p->chain) > 1)
+         return(0);
+   }
+
+   return(WriteViewAsPDBorGromos(fp, view, FALSE));
+}
+
+
+/************************************************************************/
+/*>static int WriteViewAsPDBorGromos(FILE *fp, PDBVIEW *view, 
+                                     BOOL doGromos)
+   -----------------------------------------------------------
+*//**
+
+   \param[in]     *fp       PDB file pointer to be written
+   \param[in]     *view     View onto a PDB linked list
+   \param[in]     doGromos  Write GROMOS format records
+   \return                  Number of TER cards written
+
+   Does the work for blWritePDBAsPDBorGromos() and blWritePDBView().
+   HETATM groups are checked for bonding to the previous residue using
+   the underlying linked list.
+
+-  08.03.89 Original (as blWritePDBAsPDBorGromos())
+-  17.10.26 Works on a PDBVIEW   By: ACRM
+*/
+static int WriteViewAsPDBorGromos(FILE *fp, PDBVIEW *view, 
+                                  BOOL doGromos)
 {
    PDB   *p,
          *prev = NULL;
-   int   numTer = 0;
+   int   i,
+         numTer = 0;
    BOOL  doneTer = FALSE;
 
-   for(p=pdb; p!=NULL; NEXT(p))
+   BLTIMERSTART(BLTIMER_WRITEPDB);
+   for(p=PDBVIEW_FIRST(view, i); p!=NULL; p=PDBVIEW_NEXT(view, p, i))
    {
+      BLCOUNT(BLCOUNT_ATOMS_WRITTEN, 1);
+
       /* If previous was non-null and was an ATOM                       */
       if((prev!=NULL) && !strncmp(prev->record_type, "ATOM  ", 6))
       {
@@ -344,8 +441,8 @@ int blWritePDBAsPDBorGromos(FILE *fp, PDB  *pdb, BOOL doGromos)
          */
          if(!doneTer && !strncmp(p->record_type, "HETATM", 6))
          {
-            PDB *prevStart = blFindResidue(pdb, prev->chain, prev->resnum,
-                                           prev->insert);
+            PDB *prevStart = blFindResidue(view->pdb, prev->chain, 
+                                           prev->resnum, prev->insert);
             if(!blAreResiduePointersBonded(prevStart, p, (REAL)0.2))
             {
                blWriteTerCard(fp, prev);
@@ -375,6 +472,7 @@ int blWritePDBAsPDBorGromos(FILE *fp, PDB  *pdb, BOOL doGromos)
       blWriteTerCard(fp, prev);
       numTer++;
    }
+   BLTIMERSTOP(BLTIMER_WRITEPDB);
    return(numTer);
 }
 
@@ -392,13 +490,19 @@ int blWritePDBAsPDBorGromos(FILE *fp, PDB  *pdb, BOOL doGromos)
 
 -  23.02.15  Original   By: ACRM
 -  02.03.15  Added space padding
+-  17.10.26  Writes hybrid-36 numbers   By: ACRM
 */
 void blWriteTerCard(FILE *fp, PDB *p)
 {
    if(p!=NULL)
    {
-      fprintf(fp,"TER   %5d      %-4s%1s%4d%1s%s\n",
-              p->atnum+1, p->resnam, p->chain, p->resnum, p->insert,
+      char atnum[8],
+           resnum[8];
+
+      blEncodeHybrid36(p->atnum+1, 5, atnum);
+      blEncodeHybrid36(p->resnum,  4, resnum);
+      fprintf(fp,"TER   %5s      %-4s%1s%4s%1s%s\n",
+              atnum, p->resnam, p->chain, resnum, p->insert,
               "                                                     ");
    }
 }
@@ -426,12 +530,18 @@ void blWriteTerCard(FILE *fp, PDB *p)
 -  16.08.14 Write element and formal charge.  By: CTP
 -  17.02.15 Added segid support   By: ACRM
 -  09.02.18 Corrected ABS() call
+-  17.10.26 Writes hybrid-36 numbers   By: ACRM
 */
 void blWritePDBRecord(FILE *fp,
                       PDB  *pdb)
 {
    char charge = ' ',
-        sign   = ' ';
+        sign   = ' ',
+        atnum[8],
+        resnum[8];
+
+   blEncodeHybrid36(pdb->atnum,  5, atnum);
+   blEncodeHybrid36(pdb->resnum, 4, resnum);
 
    if(pdb->formal_charge && ABS(pdb->formal_charge) <= 8)
    {
@@ -439,14 +549,14 @@ void blWritePDBRecord(FILE *fp,
       sign   = (char)(pdb->formal_charge > 0 ? '+':'-');
    }
 
-   fprintf(fp,"%-6s%5d %-4s%c%-4s%1s%4d%1s   %8.3f%8.3f%8.3f%6.2f%6.2f      %4s%2s%c%c\n",
+   fprintf(fp,"%-6s%5s %-4s%c%-4s%1s%4s%1s   %8.3f%8.3f%8.3f%6.2f%6.2f      %4s%2s%c%c\n",
            pdb->record_type,
-           pdb->atnum,
+           atnum,
            pdb->atnam_raw,
            pdb->altpos,
            pdb->resnam,
            pdb->chain,
-           pdb->resnum,
+           resnum,
            pdb->insert,
            pdb->x,
            pdb->y,
@@ -483,12 +593,18 @@ void blWritePDBRecord(FILE *fp,
 -  07.07.14 Renamed to blWritePDBRecordAtnam() By: CTP
 -  17.02.15 Added element, formalcharge and segid support   By: ACRM
 -  09.02.17 Corrected ABS() call
+-  17.10.26 Writes hybrid-36 numbers   By: ACRM
 */
 void blWritePDBRecordAtnam(FILE *fp,
                            PDB  *pdb)
 {
    char charge = ' ',
-        sign   = ' ';
+        sign   = ' ',
+        atnum[8],
+        resnum[8];
+
+   blEncodeHybrid36(pdb->atnum,  5, atnum);
+   blEncodeHybrid36(pdb->resnum, 4, resnum);
 
    if(pdb->formal_charge && ABS(pdb->formal_charge) <= 8)
    {
@@ -496,13 +612,13 @@ void blWritePDBRecordAtnam(FILE *fp,
       sign   = (char)(pdb->formal_charge > 0 ? '+':'-');
    }
 
-   fprintf(fp,"%-6s%5d  %-4s%-4s%1s%4d%1s   %8.3f%8.3f%8.3f%6.2f%6.2f      %4s%2s%c%c\n",
+   fprintf(fp,"%-6s%5s  %-4s%-4s%1s%4s%1s   %8.3f%8.3f%8.3f%6.2f%6.2f      %4s%2s%c%c\n",
            pdb->record_type,
-           pdb->atnum,
+           atnum,
            pdb->atnam,
            pdb->resnam,
            pdb->chain,
-           pdb->resnum,
+           resnum,
            pdb->insert,
            pdb->x,
            pdb->y,
@@ -536,6 +652,7 @@ void blWritePDBRecordAtnam(FILE *fp,
 -  29.04.15 Updated to write CONECT records.  By: CTP
 -  11.05.15 Made function into wrapper for blDoWritePDBAsPDBML(). By: CTP
 -  10.07.15 Added return value for no XML_SUPPORT  By: ACRM
+-  17.10.26 Initialises the bonds of the WHOLEPDB   By: ACRM
 
 */
 BOOL blWritePDBAsPDBML(FILE *fp, PDB  *pdb)
@@ -549,11 +666,16 @@ BOOL blWritePDBAsPDBML(FILE *fp, PDB  *pdb)
 
    /* PDBML format supported.                                           */
    WHOLEPDB wpdb;
+   BOOL     ok;
    wpdb.header  = NULL;
    wpdb.trailer = NULL;
+   wpdb.bonds   = NULL;
    wpdb.natoms  =    0;
    wpdb.pdb     =  pdb;
-   return(blDoWritePDBAsPDBML(fp, &wpdb, FALSE));
+   BLTIMERSTART(BLTIMER_WRITEPDB);
+   ok = blDoWritePDBAsPDBML(fp, &wpdb, FALSE);
+   BLTIMERSTOP(BLTIMER_WRITEPDB);
+   return(ok);
 
 #endif
 }
@@ -590,6 +712,7 @@ BOOL blWritePDBAsPDBML(FILE *fp, PDB  *pdb)
 -  10.07.15 Added return value for no XML_SUPPORT  By: ACRM
 -  29.07.15 Added output of SEQRES records from wpdb->header.  By: CTP
 -  07.08.18 Increased text buffer sizes to silence gcc 7.3.1 with -O2
+-  17.10.26 Writes user-defined tags from pdbtagvars.h   By: ACRM
 */
 static BOOL blDoWritePDBAsPDBML(FILE *fp, WHOLEPDB  *wpdb, BOOL doWhole)
 {
@@ -668,6 +791,7 @@ static BOOL blDoWritePDBAsPDBML(FILE *fp, WHOLEPDB  *wpdb, BOOL doWhole)
       {
          continue;
       }
+      BLCOUNT(BLCOUNT_ATOMS_WRITTEN, 1);
 
       /* Add atom node                                                  */
       if((atom_node = xmlNewChild(sites_node, NULL,
@@ -877,6 +1001,10 @@ static BOOL blDoWritePDBAsPDBML(FILE *fp, WHOLEPDB  *wpdb, BOOL doWhole)
                                 (xmlChar *)p->segid))==NULL)
             XMLDIE(doc);                   /* 25.02.15                  */
       }
+
+      /* User-defined tags and attribute columns                        */
+      if(gNPDBTagFunctions && !blAddTagVariablesNodes(p, atom_node))
+         XMLDIE(doc);                      /* 17.10.26                  */
    }
 
    /* Finished Coordinate Data                                          */
@@ -1530,17 +1658,24 @@ void blWriteGromosPDB(FILE *fp,
 -  11.03.94 %lf back to %f (!)
 -  12.02.01 This is the old WritePDBRecord()
 -  07.07.14 Use bl prefix for functions By: CTP
+-  17.10.26 Writes hybrid-36 numbers   By: ACRM
 */
 void blWriteGromosPDBRecord(FILE *fp,
                             PDB  *pdb)
 {
-   fprintf(fp,"%-6s%5d  %-4s%-4s%1s%4d%1s   %8.3f%8.3f%8.3f%6.2f%6.2f\n",
+   char atnum[8],
+        resnum[8];
+
+   blEncodeHybrid36(pdb->atnum,  5, atnum);
+   blEncodeHybrid36(pdb->resnum, 4, resnum);
+
+   fprintf(fp,"%-6s%5s  %-4s%-4s%1s%4s%1s   %8.3f%8.3f%8.3f%6.2f%6.2f\n",
            pdb->record_type,
-           pdb->atnum,
+           atnum,
            pdb->atnam,
            pdb->resnam,
            pdb->chain,
-           pdb->resnum,
+           resnum,
            pdb->insert,
            pdb->x,
            pdb->y,
@@ -1583,7 +1718,9 @@ BOOL blWriteWholePDB(FILE *fp, WHOLEPDB *wpdb)
    {
 #ifdef XML_SUPPORT
       /* Write PDBML file (including header and footer data)            */
+      BLTIMERSTART(BLTIMER_WRITEPDB);
       blDoWritePDBAsPDBML(fp, wpdb, TRUE);
+      BLTIMERSTOP(BLTIMER_WRITEPDB);
 #else
       /* PDBML not supported                                            */
       return(FALSE);
@@ -1657,6 +1794,7 @@ void blWriteWholePDBHeader(FILE *fp, WHOLEPDB *wpdb)
 -  02.03.15  Padded END and CONECT
 -  06.08.15  Updated XML check. By: CTP
 -  07.08.18 Increased text buffer sizes to silence gcc 7.3.1 with -O2
+-  17.10.26 Writes hybrid-36 atom numbers   By: ACRM
 */
 void blWriteWholePDBTrailer(FILE *fp, WHOLEPDB *wpdb, int numTer)
 {
@@ -1675,7 +1813,8 @@ void blWriteWholePDBTrailer(FILE *fp, WHOLEPDB *wpdb, int numTer)
             int  i, 
                  nPrinted,
                  width=0;
-            char format[16];
+            char format[16],
+                 atnum[8];
 
             for(i=0, nPrinted=0; i<p->nConect; i++)
             {
@@ -1683,14 +1822,16 @@ void blWriteWholePDBTrailer(FILE *fp, WHOLEPDB *wpdb, int numTer)
                {
                   if(conectPrinted)
                      fprintf(fp, "\n");
-                  fprintf(fp,"CONECT%5d", p->atnum);
+                  blEncodeHybrid36(p->atnum, 5, atnum);
+                  fprintf(fp,"CONECT%5s", atnum);
                   nConect++;
                   width = 11;
                   conectPrinted = 1;
                }
                if(p->conect[i] != NULL)
                {
-                  fprintf(fp,"%5d", p->conect[i]->atnum);
+                  blEncodeHybrid36(p->conect[i]->atnum, 5, atnum);
+                  fprintf(fp,"%5s", atnum);
                   width += 5;
                   nPrinted++;
                }
@@ -3,8 +3,8 @@
 
    \file       access.c
    
-   \version    V1.2
-   \date       17.06.15
+   \version    V1.3
+   \date       17.10.26
    \brief      Accessibility calculation code
    
    \copyright  (c) UCL, Dr. Andrew C.R. Martin, 1999-2015
@@ -70,6 +70,9 @@
 -  V1.0  21.04.99 Original   By: ACRM
 -  V1.1  17.07.14 Extracted from XMAS code
 -  V1.2  17.06.15 Added sidechain residues access
+-  V1.3  17.10.26 Added blCalcAccessView()
+-  V1.4  17.10.26 Neighbour pairs are counted and blCalcAccessView() is
+                  timed when compiled with INSTRUMENT_SUPPORT
 
 *************************************************************************/
 /* Doxygen
@@ -85,6 +88,9 @@
    Allocates arrays and calls routines to populate them, do the access
    calculations and populate into the PDB linked list
 
+   #FUNCTION  blCalcAccessView()
+   As blCalcAccess() but works on the atoms of a PDBVIEW
+
    #FUNCTION  blCalcResAccess()
    Calculates and populates the residue totals and relative values
    using standards stored in resrad
@@ -100,6 +106,8 @@
 #include "SysDefs.h"
 #include "pdb.h"
 #include "access.h"
+#include "pdbview.h"
+#include "instrument.h"
 
 /************************************************************************/
 /* Defines and macros
@@ -177,12 +185,13 @@ static BOOL doCalcAccess(int numAtoms, REAL integrationAccuracy,
                          REAL *AtomRadius,
                          REAL *x, REAL *y, REAL *z,
                          REAL *accessResults);
-static void FillArrays(PDB *pdb, REAL *x, REAL *y, REAL *z, REAL *r);
+static void FillArrays(PDBVIEW *view, REAL *x, REAL *y, REAL *z,
+                       REAL *r);
 static RESRAD *GetResidueRadii(RESRAD *resrad, char *resnam);
 static RESRAD *ReadRadiusFile(FILE *fpRad);
 static REAL GetStandardAccess(char *resnam, RESRAD *resrad);
 static REAL DefaultRadius(char *element);
-static void SetPDBAccess(PDB *pdb, REAL *accessArray);
+static void SetPDBAccess(PDBVIEW *view, REAL *accessArray);
 static char *blGetElement(PDB *p);
 static REAL GetStandardAccessSC(char *resnam, RESRAD *resrad);
 
@@ -317,7 +326,9 @@ RESRAD *blSetAtomRadii(PDB *pdb, FILE *fpRad)
    --------------------------------------------------------------
 *//**
    \param[in,out]    *pdb                  PDB linked list
-   \param[in]        natoms                Number of atoms
+   \param[in]        natoms                Number of atoms (unused - the
+                                           atoms are counted by
+                                           blInitPDBView())
    \param[in]        integrationAccuracy   Integration accuracy
    \param[in]        probeRadius           Probe radius
    \param[in]        doAccessibility       Accessibility or contact area
@@ -327,21 +338,55 @@ RESRAD *blSetAtomRadii(PDB *pdb, FILE *fpRad)
    calculations and populate into the PDB linked list
 
 -  22.04.99 Original   By: ACRM
+-  17.10.26 Now just calls blCalcAccessView()
 */
 BOOL blCalcAccess(PDB *pdb, int natoms, 
                   REAL integrationAccuracy, REAL probeRadius,
                   BOOL doAccessibility)
+{
+   PDBVIEW view;
+
+   blInitPDBView(&view, pdb);
+
+   return(blCalcAccessView(&view, integrationAccuracy, probeRadius,
+                           doAccessibility));
+}
+
+
+/************************************************************************/
+/*>BOOL blCalcAccessView(PDBVIEW *view, REAL integrationAccuracy, 
+                         REAL probeRadius, BOOL doAccessibility)
+   --------------------------------------------------------------
+*//**
+   \param[in,out]    *view                 View onto a PDB linked list
+   \param[in]        integrationAccuracy   Integration accuracy
+   \param[in]        probeRadius           Probe radius
+   \param[in]        doAccessibility       Accessibility or contact area
+   \return                                 Success
+
+   As blCalcAccess(), but only the atoms in the view are considered.
+   The results are placed in the access field of those atoms of the
+   underlying linked list; other atoms are untouched.
+
+-  22.04.99 Original (as blCalcAccess())   By: ACRM
+-  17.10.26 Works on a PDBVIEW
+*/
+BOOL blCalcAccessView(PDBVIEW *view, REAL integrationAccuracy, 
+                      REAL probeRadius, BOOL doAccessibility)
 {
    REAL *x = NULL, 
         *y = NULL, 
         *z = NULL, 
         *radii = NULL, 
         *accessArray = NULL;
+   int  natoms = view->natoms;
    BOOL retval = FALSE;
 
    if(integrationAccuracy < VERY_SMALL)
       integrationAccuracy = ACCESS_DEF_INTACC;
    
+   BLTIMERSTART(BLTIMER_ACCESS);
+
    /* Allocate arrays                                                   */
    if((x=(REAL *)malloc(natoms * sizeof(REAL)))!=NULL)
    {
@@ -360,12 +405,12 @@ BOOL blCalcAccess(PDB *pdb, int natoms,
                      accessibility run and put the results back into the 
                      PDB structure
                   */
-                  FillArrays(pdb, x, y, z, radii);
+                  FillArrays(view, x, y, z, radii);
                   doCalcAccess(natoms, integrationAccuracy, probeRadius, 
                                doAccessibility,
                                radii, x, y, z,
                                accessArray);
-                  SetPDBAccess(pdb, accessArray);
+                  SetPDBAccess(view, accessArray);
                }
             }
          }
@@ -379,16 +424,18 @@ BOOL blCalcAccess(PDB *pdb, int natoms,
    if(radii!=NULL)       free(radii);
    if(accessArray!=NULL) free(accessArray);
    
+   BLTIMERSTOP(BLTIMER_ACCESS);
    return(retval);
 }
 
 
 
 /************************************************************************/
-/*>static void FillArrays(PDB *pdb, REAL *x, REAL *y, REAL *z, REAL *r)
+/*>static void FillArrays(PDBVIEW *view, REAL *x, REAL *y, REAL *z, 
+                          REAL *r)
    --------------------------------------------------------------------
 *//**
-   \param[in]   *pdb      PDB linked list
+   \param[in]   *view     View onto a PDB linked list
    \param[out]  *x        X coordinate array
    \param[out]  *y        Y coordinate array
    \param[out]  *z        Z coordinate array
@@ -397,14 +444,17 @@ BOOL blCalcAccess(PDB *pdb, int natoms,
    Fills the coordinate and atom arrays from the PDB linked list
 
 -  22.04.99 Original   By: ACRM
+-  17.10.26 Takes a PDBVIEW
 */
-static void FillArrays(PDB *pdb, REAL *x, REAL *y, REAL *z, REAL *r)
+static void FillArrays(PDBVIEW *view, REAL *x, REAL *y, REAL *z, 
+                       REAL *r)
 {
    PDB *p;
-   int  count = 0;
+   int  i,
+        count = 0;
    
 
-   for(p=pdb; p!=NULL; NEXT(p))
+   for(p=PDBVIEW_FIRST(view, i); p!=NULL; p=PDBVIEW_NEXT(view, p, i))
    {
       x[count] = p->x;
       y[count] = p->y;
@@ -628,24 +678,25 @@ static REAL DefaultRadius(char *element)
 
 
 /************************************************************************/
-/*>static void SetPDBAccess(PDB *pdb, REAL *accessArray)
-   -----------------------------------------------------
+/*>static void SetPDBAccess(PDBVIEW *view, REAL *accessArray)
+   -----------------------------------------------------------
 *//**
-   \param       *pdb           PDB linked list
+   \param       *view          View onto a PDB linked list
    \param[in]   *accessArray   Accessibility information
 
    Puts accessibility information from the array into the PDB linked list.
 
 -  16.07.14 Original   By: ACRM
+-  17.10.26 Takes a PDBVIEW
 */
-static void SetPDBAccess(PDB *pdb, REAL *accessArray)
+static void SetPDBAccess(PDBVIEW *view, REAL *accessArray)
 {
    PDB *p;
-   int i = 0;
+   int i;
    
-   for(p=pdb; p!=NULL; NEXT(p))
+   for(p=PDBVIEW_FIRST(view, i); p!=NULL; p=PDBVIEW_NEXT(view, p, i))
    {
-      p->access = accessArray[i++];
+      p->access = accessArray[i];
    }
 }
 
@@ -1213,6 +1264,8 @@ static BOOL doCalcAccess(int numAtoms, REAL integrationAccuracy,
          }
       }
       
+      BLCOUNT(BLCOUNT_PAIRS_TESTED, io);
+
       if(io == 0)
       {
          totalArea = twoPi * radiusX2;
@@ -3,11 +3,11 @@
 
    \file       align.c
    
-   \version    V3.8
-   \date       13.06.22
+   \version    V3.11
+   \date       17.10.26
    \brief      Perform Needleman & Wunsch sequence alignment
    
-   \copyright  (c) UCL / Prof. Andrew C. R. Martin 1993-2022
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 1993-2026
    \author     Prof. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -50,6 +50,11 @@
    First call ReadMDM() to read the mutation data matrix, then call
    align() to align the sequences.
 
+   Alternatively, call blReadMDMatrix() to obtain an MDMATRIX object
+   and pass this to blMDMatrixAffinealign(). Any number of these may be
+   loaded at once and used from several threads. blReadMDM() simply
+   loads the default MDMATRIX used by the older routines.
+
 **************************************************************************
 
    Revision History:
@@ -85,6 +90,16 @@
                   go to stderr
 -  V3.7  02.05.18 Added blFreeMDM()
 -  V3.8  13.06.22 Added blAffinealignWindow() and blAffinealignucWindow()
+-  V3.9  17.10.26 Alignments are counted and timed when compiled with
+                  INSTRUMENT_SUPPORT   By: ACRM
+-  V3.10 17.10.26 The matrix is now an MDMATRIX object with residues
+                  looked up once per alignment rather than once per
+                  cell. Added blReadMDMatrix(), blMDMatrixAffinealign()
+                  and friends. The old globals are a default MDMATRIX
+                  By: ACRM
+-  V3.11 17.10.26 Warnings about residues missing from the matrix are
+                  again given in the same number and order as when
+                  each cell was looked up   By: ACRM
 
 *************************************************************************/
 /* Doxygen
@@ -136,6 +151,40 @@
    Apply a weight to a particular amino acid substitution. Modifies
    the scoring matrix read by blReadMDM()
 
+   #FUNCTION blMDMatrixAffinealign()
+   Perform N&W alignment of seq1 and seq2 with separate gap opening
+   and extension penalties using a specified MDMATRIX
+
+   #FUNCTION blMDMatrixAffinealignuc()
+   As blMDMatrixAffinealign() but upcases residues before looking them
+   up in the matrix
+
+   #FUNCTION blReadMDMatrix()
+   Read a mutation data matrix into a newly allocated MDMATRIX
+
+   #FUNCTION blAllocMDMatrix()
+   Allocate an empty MDMATRIX
+
+   #FUNCTION blFreeMDMatrix()
+   Free an MDMATRIX
+
+   #FUNCTION blGetDefaultMDMatrix()
+   Return the MDMATRIX read by blReadMDM()
+
+   #FUNCTION blMDMatrixScore()
+   Calculates a score for comparing two amino acids using a specified
+   MDMATRIX
+
+   #FUNCTION blMDMatrixScoreUC()
+   As blMDMatrixScore() but upcases the amino acid labels first
+
+   #FUNCTION blZeroMDMatrix()
+   Modifies all values in an MDMATRIX such that the minimum value is 0
+
+   #FUNCTION blSetMDMatrixScoreWeight()
+   Apply a weight to a particular amino acid substitution in an 
+   MDMATRIX
+
 */
 /************************************************************************/
 /* Includes
@@ -150,6 +199,7 @@
 #include "array.h"
 #include "general.h"
 #include "seq.h"
+#include "instrument.h"
 
 /************************************************************************/
 /* Defines and macros
@@ -165,6 +215,15 @@
 #define MAXBUFF 400
 #define MAXWORD 16
 
+/* Score of cell (i,j) in AffinealignCore(). While warnings about 
+   residues missing from the matrix may still be given, the residues
+   are looked up again by WarnScore() so that the warnings appear in
+   the same number and order as when every cell was looked up.
+*/
+#define CELLSCORE(i, j)                                                  \
+   (warn ? WarnScore(mdm, upcase, seq1[(i)], seq2[(j)], nWarn, &warn) : \
+           mdm->score[row1[(i)] + col2[(j)]])
+
 /* Type definition to store a X,Y coordinate pair in the matrix         */
 typedef struct
 {
@@ -175,9 +234,9 @@ typedef struct
 /************************************************************************/
 /* Globals
 */
-static int  **sMDMScore  = NULL;
-static char *sMDM_AAList = NULL;
-static int  sMDMSize     = 0;
+static MDMATRIX *sMDM    = NULL;  /* Default matrix from blReadMDM()  */
+static int      sNWarn   = 0,     /* Warnings given by the routines   */
+                sNWarnUC = 0;     /* using the default matrix         */
 
 /************************************************************************/
 /* Prototypes
@@ -188,6 +247,19 @@ static int  SearchForBest(int **matrix, int length1, int length2,
 static int  TraceBack(int **matrix, XY **dirn, int length1, int length2, 
                       char *seq1, char *seq2, char *align1, char *align2, 
                       int *align_len);
+static int  AffinealignCore(MDMATRIX *mdm, BOOL upcase, int *nWarn,
+                            char *seq1, int length1, 
+                            char *seq2, int length2, 
+                            BOOL verbose, BOOL identity, 
+                            int penalty, int penext, int window,
+                            char *align1, char *align2, int *align_len);
+static int  *EncodeSequence(MDMATRIX *mdm, char *seq, int length, 
+                            BOOL upcase, int stride, BOOL *missing);
+static void MissingResidue(char res, int *nWarn);
+static int  CalcScore(MDMATRIX *mdm, int *lookup, char resa, char resb,
+                      int *nWarn, int silence);
+static int  WarnScore(MDMATRIX *mdm, BOOL upcase, char resa, char resb,
+                      int *nWarn, BOOL *warn);
 
 
 /************************************************************************/
@@ -338,10 +410,8 @@ int blAffinealign(char *seq1,
             the path as it goes.
 -  07.07.14 Use bl prefix for functions By: CTP
 -  13.06.22 Renamed and added window parameter  By: ACRM
-
-**************************************************************************
-******   NOTE AND CHANGES SHOULD BE PROPAGATED TO affinealignuc()   ******
-**************************************************************************
+-  17.10.26 Now a wrapper to AffinealignCore() using the default
+            matrix   By: ACRM
 */
 int blAffinealignWindow(char *seq1, 
                         int  length1, 
@@ -356,267 +426,10 @@ int blAffinealignWindow(char *seq1,
                         char *align2,
                         int  *align_len)
 {
-   XY    **dirn   = NULL;
-   int   **matrix = NULL,
-         maxdim,
-         i,    j,    k,    l,
-         i1,   j1,
-         dia,  right, down,
-         rcell, dcell, maxoff,
-         match = 1,
-         thisscore,
-         gapext,
-         score;
-
-   
-   /* Find maximum dimension                                            */
-   maxdim = MAX(length1, length2);
-   
-   /* If window size is zero then set it to no window                   */
-   if(window<=0)
-   {
-      window = maxdim;
-   }
-
-   /* Initialise the score matrix                                       */
-   if((matrix = (int **)blArray2D(sizeof(int), maxdim, maxdim))==NULL)
-      return(0);
-   if((dirn   = (XY **)blArray2D(sizeof(XY), maxdim, maxdim))==NULL)
-      return(0);
-      
-
-   for(i=0;i<maxdim;i++)
-   {
-      for(j=0;j<maxdim;j++)
-      {
-         matrix[i][j] = 0;
-         dirn[i][j].x = -1;
-         dirn[i][j].y = -1;
-      }
-   }
-
-   /* Fill in scores up the right hand side of the matrix               */
-   for(j=0; j<length2; j++)
-   {
-      if(identity)
-      {
-         if(seq1[length1-1] == seq2[j]) matrix[length1-1][j] = match;
-      }
-      else
-      {
-         matrix[length1-1][j] = blCalcMDMScore(seq1[length1-1], seq2[j]);
-      }
-   }
-
-   /* Fill in scores along the bottom row of the matrix                 */
-   for(i=0; i<length1; i++)
-   {
-      if(identity)
-      {
-         if(seq1[i] == seq2[length2-1]) matrix[i][length2-1] = match;
-      }
-      else
-      {
-         matrix[i][length2-1] = blCalcMDMScore(seq1[i], seq2[length2-1]);
-      }
-   }
-
-   i = length1 - 1;
-   j = length2 - 1;
-   
-   /* Move back along the diagonal                                      */
-   while(i > 0 && j > 0)
-   {
-      i--;
-      j--;
-
-      /* Fill in the scores along this row                              */
-      for(i1 = i; i1 > -1; i1--)
-      {
-         dia   = matrix[i1+1][j+1];
-
-         /* Find highest score to right of diagonal                     */
-         rcell = i1+2;
-         if(i1+2 >= length1)  right = 0;
-         else                 right = matrix[i1+2][j+1] - penalty;
-         
-         gapext = 1;
-         for(k = i1+3;
-             ((k<length1) && (k < i1+3+window));
-              k++, gapext++)
-         {
-            thisscore = matrix[k][j+1] - (penalty + gapext*penext);
-            
-            if(thisscore > right) 
-            {
-               right = thisscore;
-               rcell = k;
-            }
-         }
-
-         /* Find highest score below diagonal                           */
-         dcell = j+2;
-         if(j+2 >= length2)  down = 0;
-         else                down   = matrix[i1+1][j+2] - penalty;
-         
-         gapext = 1;
-         for(l = j+3;
-             ((l<length2) && (l < j+3+window));
-             l++, gapext++)
-         {
-            thisscore = matrix[i1+1][l] - (penalty + gapext*penext);
-
-            if(thisscore > down) 
-            {
-               down = thisscore;
-               dcell = l;
-            }
-         }
-         
-         /* Set score to best of these                                  */
-         maxoff = MAX(right, down);
-         if(dia >= maxoff)
-         {
-            matrix[i1][j] = dia;
-            dirn[i1][j].x = i1+1;
-            dirn[i1][j].y = j+1;
-         }
-         else
-         {
-            if(right > down)
-            {
-               matrix[i1][j] = right;
-               dirn[i1][j].x = rcell;
-               dirn[i1][j].y = j+1;
-            }
-            else
-            {
-               matrix[i1][j] = down;
-               dirn[i1][j].x = i1+1;
-               dirn[i1][j].y = dcell;
-            }
-         }
-       
-         /* Add the score for a match                                   */
-         if(identity)
-         {
-            if(seq1[i1] == seq2[j]) matrix[i1][j] += match;
-         }
-         else
-         {
-            matrix[i1][j] += blCalcMDMScore(seq1[i1],seq2[j]);
-         }
-      }
-
-      /* Fill in the scores in this column                              */
-      for(j1 = j; j1 > -1; j1--)
-      {
-         dia   = matrix[i+1][j1+1];
-         
-         /* Find highest score to right of diagonal                     */
-         rcell = i+2;
-         if(i+2 >= length1)   right = 0;
-         else                 right = matrix[i+2][j1+1] - penalty;
-
-         gapext = 1;
-         for(k = i+3;
-             ((k<length1) && (k < i+3+window));
-             k++, gapext++)
-         {
-            thisscore = matrix[k][j1+1] - (penalty + gapext*penext);
-            
-            if(thisscore > right) 
-            {
-               right = thisscore;
-               rcell = k;
-            }
-         }
-
-         /* Find highest score below diagonal                           */
-         dcell = j1+2;
-         if(j1+2 >= length2)  down = 0;
-         else                 down = matrix[i+1][j1+2] - penalty;
-
-         gapext = 1;
-         for(l = j1+3;
-             ((l<length2) && (l < j1+3+window));
-             l++, gapext++)
-         {
-            thisscore = matrix[i+1][l] - (penalty + gapext*penext);
-            
-            if(thisscore > down) 
-            {
-               down = thisscore;
-               dcell = l;
-            }
-         }
-
-         /* Set score to best of these                                  */
-         maxoff = MAX(right, down);
-         if(dia >= maxoff)
-         {
-            matrix[i][j1] = dia;
-            dirn[i][j1].x = i+1;
-            dirn[i][j1].y = j1+1;
-         }
-         else
-         {
-            if(right > down)
-            {
-               matrix[i][j1] = right;
-               dirn[i][j1].x = rcell;
-               dirn[i][j1].y = j1+1;
-            }
-            else
-            {
-               matrix[i][j1] = down;
-               dirn[i][j1].x = i+1;
-               dirn[i][j1].y = dcell;
-            }
-         }
-       
-         /* Add the score for a match                                   */
-         if(identity)
-         {
-            if(seq1[i] == seq2[j1]) matrix[i][j1] += match;
-         }
-         else
-         {
-            matrix[i][j1] += blCalcMDMScore(seq1[i],seq2[j1]);
-         }
-      }
-   } 
-   
-   score = TraceBack(matrix, dirn, length1, length2,
-                     seq1, seq2, align1, align2, align_len);
-
-   if(verbose)
-   {
-      printf("Matrix:\n-------\n");
-      for(j=0; j<length2;j++)
-      {
-         for(i=0; i<length1; i++)
-         {
-            printf("%3d ",matrix[i][j]);
-         }
-         printf("\n");
-      }
-
-      printf("Path:\n-----\n");
-      for(j=0; j<length2;j++)
-      {
-         for(i=0; i<length1; i++)
-         {
-            printf("(%3d,%3d) ",dirn[i][j].x,dirn[i][j].y);
-         }
-         printf("\n");
-      }
-   }
-    
-   blFreeArray2D((char **)matrix, maxdim, maxdim);
-   blFreeArray2D((char **)dirn,   maxdim, maxdim);
-    
-   return(score);
+   return(AffinealignCore(sMDM, FALSE, &sNWarn,
+                          seq1, length1, seq2, length2,
+                          verbose, identity, penalty, penext, window,
+                          align1, align2, align_len));
 }
 
 
@@ -716,10 +529,8 @@ int blAffinealignuc(char *seq1,
             comparison
 -  07.07.14 Use bl prefix for functions By: CTP
 -  13.06.22 Added window parameter and renamed to blAffinealignnucWindow()
-
-**************************************************************************
-******    NOTE AND CHANGES SHOULD BE PROPAGATED TO affinealign()    ******
-**************************************************************************
+-  17.10.26 Now a wrapper to AffinealignCore() using the default
+            matrix   By: ACRM
 */
 int blAffinealignucWindow(char *seq1, 
                           int  length1, 
@@ -733,9 +544,197 @@ int blAffinealignucWindow(char *seq1,
                           char *align1, 
                           char *align2,
                           int  *align_len)
+{
+   return(AffinealignCore(sMDM, TRUE, &sNWarnUC,
+                          seq1, length1, seq2, length2,
+                          verbose, identity, penalty, penext, window,
+                          align1, align2, align_len));
+}
+
+
+/************************************************************************/
+/*>int blMDMatrixAffinealign(MDMATRIX *mdm,
+                             char *seq1, int length1, 
+                             char *seq2, int length2, 
+                             BOOL verbose, BOOL identity, 
+                             int penalty, int penext, int window,
+                             char *align1, char *align2, int *align_len)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *mdm          Scoring matrix
+   \param[in]     *seq1         First sequence
+   \param[in]     length1       First sequence length
+   \param[in]     *seq2         Second sequence
+   \param[in]     length2       Second sequence length
+   \param[in]     verbose       Display N&W matrix
+   \param[in]     identity      Use identity matrix
+   \param[in]     penalty       Gap insertion penalty value
+   \param[in]     penext        Extension penalty
+   \param[in]     window        Window size (0: no window)
+   \param[out]    *align1       Sequence 1 aligned
+   \param[out]    *align2       Sequence 2 aligned
+   \param[out]    *align_len    Alignment length
+   \return                      Alignment score (0 on error)
+            
+   As blAffinealignWindow(), but scores with the specified matrix
+   rather than the one read by blReadMDM(). Residues not in the matrix
+   score zero and no warnings are given, so several alignments may be
+   run at once with different matrices.
+
+   Note that you must allocate sufficient memory for the aligned 
+   sequences.
+   The easy way to do this is to ensure that align1 and align2 are
+   of length (length1+length2).
+
+-  17.10.26 Original   By: ACRM
+*/
+int blMDMatrixAffinealign(MDMATRIX *mdm,
+                          char *seq1, 
+                          int  length1, 
+                          char *seq2, 
+                          int  length2, 
+                          BOOL verbose, 
+                          BOOL identity, 
+                          int  penalty, 
+                          int  penext,
+                          int  window,
+                          char *align1, 
+                          char *align2,
+                          int  *align_len)
+{
+   return(AffinealignCore(mdm, FALSE, NULL,
+                          seq1, length1, seq2, length2,
+                          verbose, identity, penalty, penext, window,
+                          align1, align2, align_len));
+}
+
+
+/************************************************************************/
+/*>int blMDMatrixAffinealignuc(MDMATRIX *mdm,
+                               char *seq1, int length1, 
+                               char *seq2, int length2, 
+                               BOOL verbose, BOOL identity, 
+                               int penalty, int penext, int window,
+                               char *align1, char *align2, int *align_len)
+   -----------------------------------------------------------------------
+*//**
+
+   \param[in]     *mdm          Scoring matrix
+   \param[in]     *seq1         First sequence
+   \param[in]     length1       First sequence length
+   \param[in]     *seq2         Second sequence
+   \param[in]     length2       Second sequence length
+   \param[in]     verbose       Display N&W matrix
+   \param[in]     identity      Use identity matrix
+   \param[in]     penalty       Gap insertion penalty value
+   \param[in]     penext        Extension penalty
+   \param[in]     window        Window size (0: no window)
+   \param[out]    *align1       Sequence 1 aligned
+   \param[out]    *align2       Sequence 2 aligned
+   \param[out]    *align_len    Alignment length
+   \return                      Alignment score (0 on error)
+            
+   As blMDMatrixAffinealign(), but upcases residues before looking them
+   up in the matrix.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blMDMatrixAffinealignuc(MDMATRIX *mdm,
+                            char *seq1, 
+                            int  length1, 
+                            char *seq2, 
+                            int  length2, 
+                            BOOL verbose, 
+                            BOOL identity, 
+                            int  penalty, 
+                            int  penext,
+                            int  window,
+                            char *align1, 
+                            char *align2,
+                            int  *align_len)
+{
+   return(AffinealignCore(mdm, TRUE, NULL,
+                          seq1, length1, seq2, length2,
+                          verbose, identity, penalty, penext, window,
+                          align1, align2, align_len));
+}
+
+
+/************************************************************************/
+/*>static int AffinealignCore(MDMATRIX *mdm, BOOL upcase, int *nWarn,
+                              char *seq1, int length1, 
+                              char *seq2, int length2, 
+                              BOOL verbose, BOOL identity, 
+                              int penalty, int penext, int window,
+                              char *align1, char *align2, int *align_len)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *mdm          Scoring matrix (may be NULL if identity
+                                is set)
+   \param[in]     upcase        Upcase residues before looking them up
+                                in the matrix
+   \param[in,out] *nWarn        Count of warnings about residues 
+                                missing from the matrix (NULL: don't
+                                warn)
+   \param[in]     *seq1         First sequence
+   \param[in]     length1       First sequence length
+   \param[in]     *seq2         Second sequence
+   \param[in]     length2       Second sequence length
+   \param[in]     verbose       Display N&W matrix
+   \param[in]     identity      Use identity matrix
+   \param[in]     penalty       Gap insertion penalty value
+   \param[in]     penext        Extension penalty
+   \param[in]     window        Window size (0: no window)
+   \param[out]    *align1       Sequence 1 aligned
+   \param[out]    *align2       Sequence 2 aligned
+   \param[out]    *align_len    Alignment length
+   \return                      Alignment score (0 on error)
+            
+   Does the work for all the N&W alignment routines.
+
+-  07.10.92 Adapted from original written while at NIMR
+-  08.10.92 Split into separate routines
+-  09.10.92 Changed best structure to simple integers, moved 
+            SearchForBest() into TraceBack()
+-  21.08.95 Was only filling in the bottom right cell at initialisation
+            rather than all the right hand column and bottom row
+-  11.07.96 Changed calls to calcscore() to CalcMDMScore()
+-  06.03.00 Changed name to affinealign() (the routine align() is
+            provided as a backwards compatible wrapper). Added penext 
+            parameter. Now supports affine gap penalties with separate
+            opening and extension penalties. The code now maintains
+            the path as it goes.
+-  07.07.14 Use bl prefix for functions By: CTP
+-  13.06.22 Renamed and added window parameter  By: ACRM
+-  17.10.26 Moved from blAffinealignWindow() which is now a wrapper
+            and also replaces the copy in blAffinealignucWindow(). 
+            Takes the matrix as a parameter and looks up each residue
+            once rather than for every cell   By: ACRM
+-  17.10.26 Warnings about missing residues are given per cell, as
+            before, while any remain to be given   By: ACRM
+*/
+static int AffinealignCore(MDMATRIX *mdm,
+                           BOOL upcase,
+                           int  *nWarn,
+                           char *seq1, 
+                           int  length1, 
+                           char *seq2, 
+                           int  length2, 
+                           BOOL verbose, 
+                           BOOL identity, 
+                           int  penalty, 
+                           int  penext,
+                           int  window,
+                           char *align1, 
+                           char *align2,
+                           int  *align_len)
 {
    XY    **dirn   = NULL;
    int   **matrix = NULL,
+         *row1    = NULL,
+         *col2    = NULL,
          maxdim,
          i,    j,    k,    l,
          i1,   j1,
@@ -745,6 +744,9 @@ int blAffinealignucWindow(char *seq1,
          thisscore,
          gapext,
          score;
+   BOOL  missing = FALSE,
+         warn    = FALSE;
+
    
    /* Find maximum dimension                                            */
    maxdim = MAX(length1, length2);
@@ -755,12 +757,42 @@ int blAffinealignucWindow(char *seq1,
       window = maxdim;
    }
 
+   /* Look up the residues in the scoring matrix once rather than for
+      every cell. row1[] and col2[] then index directly into the 
+      score table.
+   */
+   if(!identity)
+   {
+      if(mdm == NULL)
+         return(0);
+      if((row1 = EncodeSequence(mdm, seq1, length1, upcase, 
+                                mdm->size+1, &missing))==NULL)
+         return(0);
+      if((col2 = EncodeSequence(mdm, seq2, length2, upcase, 
+                                1, &missing))==NULL)
+      {
+         free(row1);
+         return(0);
+      }
+      warn = (missing && (nWarn != NULL) && (*nWarn <= 10));
+   }
+
    /* Initialise the score matrix                                       */
-   if((matrix = (int **)blArray2D(sizeof(int), maxdim, maxdim))==NULL)
-      return(0);
-   if((dirn   = (XY **)blArray2D(sizeof(XY), maxdim, maxdim))==NULL)
+   if(((matrix = (int **)blArray2D(sizeof(int), maxdim, maxdim))==NULL) ||
+      ((dirn   = (XY **)blArray2D(sizeof(XY), maxdim, maxdim))==NULL))
+   {
+      if(matrix != NULL)
+         blFreeArray2D((char **)matrix, maxdim, maxdim);
+      FREE(row1);
+      FREE(col2);
       return(0);
+   }
+
+   BLTIMERSTART(BLTIMER_ALIGN);
+   BLCOUNT(BLCOUNT_ALIGNMENTS, 1);
+   BLCOUNT(BLCOUNT_DP_CELLS, (ULONG)length1 * (ULONG)length2);
       
+
    for(i=0;i<maxdim;i++)
    {
       for(j=0;j<maxdim;j++)
@@ -770,7 +802,7 @@ int blAffinealignucWindow(char *seq1,
          dirn[i][j].y = -1;
       }
    }
-    
+
    /* Fill in scores up the right hand side of the matrix               */
    for(j=0; j<length2; j++)
    {
@@ -780,7 +812,7 @@ int blAffinealignucWindow(char *seq1,
       }
       else
       {
-         matrix[length1-1][j] = blCalcMDMScoreUC(seq1[length1-1],seq2[j]);
+         matrix[length1-1][j] = CELLSCORE(length1-1, j);
       }
    }
 
@@ -793,7 +825,7 @@ int blAffinealignucWindow(char *seq1,
       }
       else
       {
-         matrix[i][length2-1] = blCalcMDMScoreUC(seq1[i],seq2[length2-1]);
+         matrix[i][length2-1] = CELLSCORE(i, length2-1);
       }
    }
 
@@ -819,7 +851,7 @@ int blAffinealignucWindow(char *seq1,
          gapext = 1;
          for(k = i1+3;
              ((k<length1) && (k < i1+3+window));
-             k++, gapext++)
+              k++, gapext++)
          {
             thisscore = matrix[k][j+1] - (penalty + gapext*penext);
             
@@ -880,7 +912,7 @@ int blAffinealignucWindow(char *seq1,
          }
          else
          {
-            matrix[i1][j] += blCalcMDMScoreUC(seq1[i1],seq2[j]);
+            matrix[i1][j] += CELLSCORE(i1, j);
          }
       }
 
@@ -958,7 +990,7 @@ int blAffinealignucWindow(char *seq1,
          }
          else
          {
-            matrix[i][j1] += blCalcMDMScoreUC(seq1[i],seq2[j1]);
+            matrix[i][j1] += CELLSCORE(i, j1);
          }
       }
    } 
@@ -991,7 +1023,119 @@ int blAffinealignucWindow(char *seq1,
     
    blFreeArray2D((char **)matrix, maxdim, maxdim);
    blFreeArray2D((char **)dirn,   maxdim, maxdim);
+   FREE(row1);
+   FREE(col2);
     
+   BLTIMERSTOP(BLTIMER_ALIGN);
+   return(score);
+}
+
+/************************************************************************/
+/*>static int *EncodeSequence(MDMATRIX *mdm, char *seq, int length, 
+                              BOOL upcase, int stride, BOOL *missing)
+   ------------------------------------------------------------------
+*//**
+
+   \param[in]     *mdm       Scoring matrix
+   \param[in]     *seq       Sequence
+   \param[in]     length     Sequence length
+   \param[in]     upcase     Upcase the residues
+   \param[in]     stride     Multiplier for the matrix indexes
+   \param[in,out] *missing   Set to TRUE if any residue is not in the
+                             matrix (otherwise left unchanged)
+   \return                   Malloc'd array of indexes (NULL if no 
+                             memory)
+
+   Looks up each residue in the scoring matrix. The indexes are 
+   multiplied by stride so that the row index for a residue in one
+   sequence may simply be added to the column index from the other to
+   find a cell of the score table. Residues not in the matrix give the
+   index of the zero row/column. No warnings are given here; see
+   WarnScore().
+
+-  17.10.26 Original   By: ACRM
+*/
+static int *EncodeSequence(MDMATRIX *mdm, char *seq, int length, 
+                           BOOL upcase, int stride, BOOL *missing)
+{
+   int *codes,
+       *lookup,
+       i;
+
+   if((codes = (int *)malloc(MAX(length,1) * sizeof(int)))==NULL)
+      return(NULL);
+
+   lookup = (upcase ? mdm->codeUC : mdm->code);
+   for(i=0; i<length; i++)
+   {
+      codes[i] = lookup[(unsigned char)seq[i]];
+      if(codes[i] == mdm->size)
+         *missing = TRUE;
+      codes[i] *= stride;
+   }
+   
+   return(codes);
+}
+
+
+/************************************************************************/
+/*>static void MissingResidue(char res, int *nWarn)
+   ------------------------------------------------
+*//**
+
+   \param[in]     res       Residue not found in the matrix
+   \param[in,out] *nWarn    Count of warnings given
+
+   Warns that a residue was not found. Only the first 10 are reported.
+
+-  17.10.26 Original, extracted from blCalcMDMScore()   By: ACRM
+*/
+static void MissingResidue(char res, int *nWarn)
+{
+   if(*nWarn < 10)
+      fprintf(stderr, "Residue %c not found in matrix\n", res);
+   else if(*nWarn == 10)
+      fprintf(stderr, "More residues not found in matrix...\n");
+
+   (*nWarn)++;
+}
+
+
+/************************************************************************/
+/*>static int WarnScore(MDMATRIX *mdm, BOOL upcase, char resa, 
+                        char resb, int *nWarn, BOOL *warn)
+   -----------------------------------------------------------
+*//**
+
+   \param[in]     *mdm      Scoring matrix
+   \param[in]     upcase    Upcase the residues
+   \param[in]     resa      First residue
+   \param[in]     resb      Second residue
+   \param[in,out] *nWarn    Count of warnings given
+   \param[out]    *warn     Set to FALSE once no more warnings will be
+                            given
+   \return                  score
+
+   Scores a cell of the alignment matrix as blCalcMDMScore() or
+   blCalcMDMScoreUC() would, giving the same warnings. Used by 
+   AffinealignCore() only while warnings remain to be given.
+
+-  17.10.26 Original   By: ACRM
+*/
+static int WarnScore(MDMATRIX *mdm, BOOL upcase, char resa, char resb,
+                     int *nWarn, BOOL *warn)
+{
+   int score;
+
+   if(upcase)
+   {
+      resa = (islower(resa) ? toupper(resa) : resa);
+      resb = (islower(resb) ? toupper(resb) : resb);
+   }
+   score = CalcScore(mdm, upcase ? mdm->codeUC : mdm->code, resa, resb,
+                     nWarn, *nWarn);
+   if(*nWarn > 10)
+      *warn = FALSE;
    return(score);
 }
 
@@ -1004,11 +1148,9 @@ int blAffinealignucWindow(char *seq1,
    \param[in]     *mdmfile    Mutation data matrix filename
    \return                      Success?
    
-   Read mutation data matrix into static global arrays. The matrix may
-   have comments at the start introduced with a ! in the first column.
-   The matrix must be complete (i.e. a triangular matrix will not
-   work). A line describing the residue types must appear, and may
-   be placed before or after the matrix itself
+   Read mutation data matrix into the default MDMATRIX used by 
+   blAffinealign(), blCalcMDMScore(), etc. Any matrix read previously
+   is freed. See blReadMDMatrix() for the file format.
 
 -  07.10.92 Original
 -  18.03.94 getc() -> fgetc()
@@ -1024,24 +1166,56 @@ int blAffinealignucWindow(char *seq1,
             Allow comments introduced with # as well as !
             Uses MAXWORD rather than hardcoded 16
 -  07.07.14 Use bl prefix for functions By: CTP
+-  17.10.26 Now a wrapper to blReadMDMatrix()   By: ACRM
 */
 BOOL blReadMDM(char *mdmfile)
 {
-   FILE *mdm = NULL;
-   int  i, j, k, row, tmpStoreSize;
-   char buffer[MAXBUFF],
-        word[MAXWORD],
-        *p,
-        **tmpStore;
-   BOOL noenv;
-
-   if((mdm=blOpenFile(mdmfile, DATAENV, "r", &noenv))==NULL)
+   blFreeMDM();
+   sMDM = blReadMDMatrix(mdmfile);
+   return(sMDM != NULL);
+}
+
+
+/************************************************************************/
+/*>MDMATRIX *blReadMDMatrix(char *mdmfile)
+   ---------------------------------------
+*//**
+
+   \param[in]     *mdmfile    Mutation data matrix filename
+   \return                    Malloc'd matrix (NULL on error)
+   
+   Read mutation data matrix into a new MDMATRIX. The matrix may
+   have comments at the start introduced with a ! or # in the first
+   column. The matrix must be complete (i.e. a triangular matrix will
+   not work). A line describing the residue types must appear, and may
+   be placed before or after the matrix itself. If the file is not 
+   found in the current directory, it is looked for in DATADIR.
+
+   Each matrix is independent of the others and of the default matrix
+   read by blReadMDM(), so several may be used at once. Free with
+   blFreeMDMatrix().
+
+-  17.10.26 Original, based on blReadMDM() 07.04.09   By: ACRM
+*/
+MDMATRIX *blReadMDMatrix(char *mdmfile)
+{
+   FILE     *fp = NULL;
+   MDMATRIX *mdm;
+   int      i, j, k, row, size, tmpStoreSize;
+   char     buffer[MAXBUFF],
+            word[MAXWORD],
+            *p,
+            **tmpStore;
+   BOOL     noenv;
+
+   if((fp=blOpenFile(mdmfile, DATAENV, "r", &noenv))==NULL)
    {
-      return(FALSE);
+      return(NULL);
    }
 
    /* First read the file to determine the dimensions                   */
-   while(fgets(buffer,MAXBUFF,mdm))
+   size = 0;
+   while(fgets(buffer,MAXBUFF,fp))
    {
       TERMINATE(buffer);
       KILLLEADSPACES(p,buffer);
@@ -1049,52 +1223,41 @@ BOOL blReadMDM(char *mdmfile)
       /* First line which is non-blank and non-comment                  */
       if(strlen(p) && p[0] != '!' && p[0] != '#')
       {
-         sMDMSize = 0;
+         size = 0;
          for(p = buffer; p!=NULL;)
          {
             p = blGetWord(p, word, MAXWORD);
             /* Increment counter if this is numeric                     */
             if(isdigit(word[0]) || 
                ((word[0] == '-')&&(isdigit(word[1]))))
-               sMDMSize++;
+               size++;
          }
-         if(sMDMSize)
+         if(size)
             break;
       }
    }
 
-   /* Allocate memory for the MDM and the AA List                       */
-   if((sMDMScore = (int **)blArray2D(sizeof(int),sMDMSize,sMDMSize))==NULL)
-      return(FALSE);
-   if((sMDM_AAList = (char *)malloc((sMDMSize+1)*sizeof(char)))==NULL)
+   /* Allocate the matrix with its scores and residue list              */
+   if((size == 0) || ((mdm = blAllocMDMatrix(size, TRUE))==NULL))
    {
-      blFreeArray2D((char **)sMDMScore, sMDMSize, sMDMSize);
-      return(FALSE);
+      fclose(fp);
+      return(NULL);
    }
 
    /* Allocate temporary storage for a row from the matrix              */
-   tmpStoreSize = 2*sMDMSize;
+   tmpStoreSize = 2*size;
    if((tmpStore = (char **)blArray2D(sizeof(char), tmpStoreSize, MAXWORD))
       ==NULL)
    {
-      free(sMDM_AAList);
-      blFreeArray2D((char **)sMDMScore, sMDMSize, sMDMSize);
-      return(FALSE);
-   }
-
-   /* Fill the matrix with zeros                                        */
-   for(i=0; i<sMDMSize; i++)
-   {
-      for(j=0; j<sMDMSize; j++)
-      {
-         sMDMScore[i][j] = 0;
-      }
+      blFreeMDMatrix(mdm);
+      fclose(fp);
+      return(NULL);
    }
 
    /* Rewind the file and read the actual data                          */
-   rewind(mdm);
+   rewind(fp);
    row = 0;
-   while(fgets(buffer,MAXBUFF,mdm))
+   while(fgets(buffer,MAXBUFF,fp))
    {
       int Numeric;
       
@@ -1119,25 +1282,26 @@ BOOL blReadMDM(char *mdmfile)
          /* No numeric fields so it is the amino acid names             */
          if(Numeric == 0)
          {
-            for(j = 0; j<i && j<sMDMSize; j++)
+            for(j = 0; j<i && j<size; j++)
             {
-               sMDM_AAList[j] = tmpStore[j][0];
+               mdm->aaList[j] = tmpStore[j][0];
             }
          }
-         else
+         else if(row < size)
          {
             /* There were numeric fields, so copy them into the matrix,
                skipping any non-numeric fields
                j counts the input fields
-               k counts the fields in sMDMScore
-               row counts the row in sMDMScore
+               k counts the fields in the score table
+               row counts the row in the score table
             */
-            for(j=0, k=0; j<i && k<sMDMSize; j++)
+            for(j=0, k=0; j<i && k<size; j++)
             {
                if(isdigit(tmpStore[j][0]) || 
                   ((tmpStore[j][0] == '-')&&(isdigit(tmpStore[j][1]))))
                {
-                  sscanf(tmpStore[j],"%d",&(sMDMScore[row][k]));
+                  sscanf(tmpStore[j],"%d",
+                         &(blMDMATRIXCELL(mdm, row, k)));
                   k++;
                }
             }
@@ -1146,10 +1310,74 @@ BOOL blReadMDM(char *mdmfile)
          }
       }
    }
-   fclose(mdm);
+   fclose(fp);
    blFreeArray2D((char **)tmpStore, tmpStoreSize, MAXWORD);
+
+   /* Build the residue lookup tables. Work backwards so that the first
+      occurrence of a residue wins as it did when the list was searched
+   */
+   for(i=size-1; i>=0; i--)
+   {
+      mdm->code[(unsigned char)mdm->aaList[i]] = i;
+   }
+   for(i=0; i<256; i++)
+   {
+      mdm->codeUC[i] = mdm->code[(unsigned char)toupper(i)];
+   }
    
-   return(TRUE);
+   return(mdm);
+}
+
+
+/************************************************************************/
+/*>MDMATRIX *blAllocMDMatrix(int size, BOOL withList)
+   --------------------------------------------------
+*//**
+
+   \param[in]     size       Number of residue types
+   \param[in]     withList   Allocate the residue list
+   \return                   Malloc'd matrix (NULL if no memory)
+
+   Allocates an MDMATRIX with all scores zero and every residue 
+   character mapped to the zero row/column. Used by blReadMDMatrix()
+   and blNumericReadMDMatrix() and may be used to build a matrix in
+   code.
+
+-  17.10.26 Original   By: ACRM
+*/
+MDMATRIX *blAllocMDMatrix(int size, BOOL withList)
+{
+   MDMATRIX *mdm;
+   int      i;
+   
+   if((mdm = (MDMATRIX *)malloc(sizeof(MDMATRIX)))==NULL)
+      return(NULL);
+
+   mdm->size   = size;
+   mdm->aaList = NULL;
+   if((mdm->score = (int *)calloc((size+1)*(size+1), sizeof(int)))
+      ==NULL)
+   {
+      free(mdm);
+      return(NULL);
+   }
+   
+   if(withList)
+   {
+      if((mdm->aaList = (char *)calloc(size+1, sizeof(char)))==NULL)
+      {
+         blFreeMDMatrix(mdm);
+         return(NULL);
+      }
+   }
+
+   for(i=0; i<256; i++)
+   {
+      mdm->code[i]   = size;
+      mdm->codeUC[i] = size;
+   }
+
+   return(mdm);
 }
 
 
@@ -1160,12 +1388,53 @@ BOOL blReadMDM(char *mdmfile)
    Frees the memory allocated by blReadMDM()
 
 -  02.05.18 Original   By: ACRM
+-  17.10.26 Frees the default MDMATRIX   By: ACRM
 */
 void blFreeMDM(void)
 {
-   FREE(sMDM_AAList);
-   blFreeArray2D((char **)sMDMScore, sMDMSize, sMDMSize);
-   sMDMSize = 0;
+   blFreeMDMatrix(sMDM);
+   sMDM = NULL;
+}
+
+
+/************************************************************************/
+/*>void blFreeMDMatrix(MDMATRIX *mdm)
+   ----------------------------------
+*//**
+   \param[in]     *mdm     Matrix to free
+
+   Frees an MDMATRIX allocated by blReadMDMatrix() or 
+   blNumericReadMDMatrix()
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeMDMatrix(MDMATRIX *mdm)
+{
+   if(mdm != NULL)
+   {
+      FREE(mdm->score);
+      FREE(mdm->aaList);
+      free(mdm);
+   }
+}
+
+
+/************************************************************************/
+/*>MDMATRIX *blGetDefaultMDMatrix(void)
+   ------------------------------------
+*//**
+   \return   The matrix read by blReadMDM() (NULL if none)
+
+   Gives access to the default matrix used by blAffinealign(),
+   blCalcMDMScore(), etc. so that it may be passed to the routines 
+   which take an MDMATRIX. It must not be freed except through 
+   blFreeMDM()
+
+-  17.10.26 Original   By: ACRM
+*/
+MDMATRIX *blGetDefaultMDMatrix(void)
+{
+   return(sMDM);
 }
 
 
@@ -1389,56 +1658,14 @@ static int TraceBack(int  **matrix,
 -  07.07.14 Use bl prefix for functions By: CTP
 -  04.01.16 Added special call with both residues set to '\0' to silence
             warnings. Also warnings now go to stderr
+-  17.10.26 Uses the lookup table in the default MDMATRIX rather than
+            searching the residue list. Silencing warnings also 
+            silences the alignment routines   By: ACRM
 */
 int blCalcMDMScore(char resa, char resb)
 {
-   int        i,j;
-   static int NWarn = 0;
-   BOOL       Warned = FALSE;
-
-   if((resa == '\0') && (resb == '\0'))
-   {
-      NWarn = 100;
-      return(0);
-   }
-
-   for(i=0; i<sMDMSize; i++)
-   {
-      if(resa==sMDM_AAList[i]) break;
-   }
-
-   if(i==sMDMSize) 
-   {
-      if(NWarn < 10)
-         fprintf(stderr, "Residue %c not found in matrix\n", resa);
-      else if(NWarn == 10)
-         fprintf(stderr, "More residues not found in matrix...\n");
-
-      Warned = TRUE;
-   }
-
-   for(j=0; j<sMDMSize; j++)
-   {
-      if(resb==sMDM_AAList[j]) break;
-   }
-
-   if(j==sMDMSize) 
-   {
-      if(NWarn < 10)
-         fprintf(stderr, "Residue %c not found in matrix\n", resb);
-      else if(NWarn == 10)
-         fprintf(stderr, "More residues not found in matrix...\n");
-
-      Warned = TRUE;
-   }
-   
-   if(Warned)
-   { 
-      NWarn++;
-      return(0);
-   }
-
-   return(sMDMScore[i][j]);
+   return(CalcScore(sMDM, sMDM ? sMDM->code : NULL, resa, resb, 
+                    &sNWarn, 100));
 }                               
 
 /************************************************************************/
@@ -1462,59 +1689,112 @@ int blCalcMDMScore(char resa, char resb)
 -  07.07.14 Use bl prefix for functions By: CTP
 -  04.01.16 Added special call with both residues set to '\0' to silence
             warnings. Also warnings now go to stderr
+-  17.10.26 Uses the lookup table in the default MDMATRIX rather than
+            searching the residue list   By: ACRM
+-  17.10.26 Warnings give the upcased residue again   By: ACRM
 */
 int blCalcMDMScoreUC(char resa, char resb)
 {
-   int        i,j;
-   static int NWarn = 0;
-   BOOL       Warned = FALSE;
+   resa = (islower(resa) ? toupper(resa) : resa);
+   resb = (islower(resb) ? toupper(resb) : resb);
 
-   if((resa == '\0') && (resb == '\0'))
-   {
-      NWarn = 10;
-      return(0);
-   }
+   return(CalcScore(sMDM, sMDM ? sMDM->codeUC : NULL, resa, resb, 
+                    &sNWarnUC, 10));
+}                               
+
+/************************************************************************/
+/*>static int CalcScore(MDMATRIX *mdm, int *lookup, char resa, char resb,
+                        int *nWarn, int silence)
+   ----------------------------------------------------------------------
+*//**
+
+   \param[in]     *mdm      Scoring matrix (may be NULL)
+   \param[in]     *lookup   mdm->code or mdm->codeUC
+   \param[in]     resa      First residue
+   \param[in]     resb      Second residue
+   \param[in,out] *nWarn    Count of warnings given
+   \param[in]     silence   Value to set *nWarn to when both residues
+                            are '\0'
+   \return                  score
 
-   resa = (islower(resa)?toupper(resa):resa);
-   resb = (islower(resb)?toupper(resb):resb);
+   Does the work for blCalcMDMScore() and blCalcMDMScoreUC()
 
-   for(i=0; i<sMDMSize; i++)
+-  17.10.26 Original, extracted from blCalcMDMScore()   By: ACRM
+*/
+static int CalcScore(MDMATRIX *mdm, int *lookup, char resa, char resb,
+                     int *nWarn, int silence)
+{
+   int  i = 0, 
+        j = 0;
+   BOOL Warned = FALSE;
+
+   if((resa == '\0') && (resb == '\0'))
    {
-      if(resa==sMDM_AAList[i]) break;
+      *nWarn = silence;
+      return(0);
    }
 
-   if(i==sMDMSize) 
+   if((mdm == NULL) || ((i = lookup[(unsigned char)resa]) == mdm->size))
    {
-      if(NWarn < 10)
-         fprintf(stderr, "Residue %c not found in matrix\n", resa);
-      else if(NWarn == 10)
-         fprintf(stderr, "More residues not found in matrix...\n");
-
+      MissingResidue(resa, nWarn);
       Warned = TRUE;
    }
 
-   for(j=0; j<sMDMSize; j++)
+   if((mdm == NULL) || ((j = lookup[(unsigned char)resb]) == mdm->size))
    {
-      if(resb==sMDM_AAList[j]) break;
+      /* Only count one warning per call as we always have              */
+      if(Warned) 
+         (*nWarn)--;
+      MissingResidue(resb, nWarn);
    }
 
-   if(j==sMDMSize) 
-   {
-      if(NWarn < 10)
-         fprintf(stderr, "Residue %c not found in matrix\n", resb);
-      else if(NWarn == 10)
-         fprintf(stderr, "More residues not found in matrix...\n");
-
-      Warned = TRUE;
-   }
-   
-   if(Warned)
-   { 
-      NWarn++;
+   if(mdm == NULL)
       return(0);
-   }
+   
+   return(blMDMATRIXCELL(mdm, i, j));
+}                               
+
+/************************************************************************/
+/*>int blMDMatrixScore(MDMATRIX *mdm, char resa, char resb)
+   --------------------------------------------------------
+*//**
+
+   \param[in]     *mdm      Scoring matrix
+   \param[in]     resa      First residue
+   \param[in]     resb      Second residue
+   \return                  score
+
+   Calculate score from the specified matrix. Residues not in the 
+   matrix score zero.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blMDMatrixScore(MDMATRIX *mdm, char resa, char resb)
+{
+   return(blMDMATRIXCELL(mdm, 
+                         mdm->code[(unsigned char)resa],
+                         mdm->code[(unsigned char)resb]));
+}                               
+
+/************************************************************************/
+/*>int blMDMatrixScoreUC(MDMATRIX *mdm, char resa, char resb)
+   ----------------------------------------------------------
+*//**
+
+   \param[in]     *mdm      Scoring matrix
+   \param[in]     resa      First residue
+   \param[in]     resb      Second residue
+   \return                  score
+
+   As blMDMatrixScore() but upcases the residues first
 
-   return(sMDMScore[i][j]);
+-  17.10.26 Original   By: ACRM
+*/
+int blMDMatrixScoreUC(MDMATRIX *mdm, char resa, char resb)
+{
+   return(blMDMATRIXCELL(mdm, 
+                         mdm->codeUC[(unsigned char)resa],
+                         mdm->codeUC[(unsigned char)resb]));
 }                               
 
 /************************************************************************/
@@ -1527,25 +1807,49 @@ int blCalcMDMScoreUC(char resa, char resb)
    Modifies all values in the MDM such that the minimum value is 0
 -  17.09.96 Original
 -  07.07.14 Use bl prefix for functions By: CTP
+-  17.10.26 Now a wrapper to blZeroMDMatrix()   By: ACRM
 */
 int blZeroMDM(void)
 {
-   int MinVal = sMDMScore[0][0],
-       MaxVal = sMDMScore[0][0],
+   return(blZeroMDMatrix(sMDM));
+}
+
+/************************************************************************/
+/*>int blZeroMDMatrix(MDMATRIX *mdm)
+   ---------------------------------
+*//**
+
+   \param[in,out] *mdm       Scoring matrix
+   \return                   Maximum value in modified matrix
+
+   Modifies all values in the matrix such that the minimum value is 0.
+   The row and column used for unknown residues still score 0.
+
+-  17.10.26 Original, based on blZeroMDM() 17.09.96   By: ACRM
+*/
+int blZeroMDMatrix(MDMATRIX *mdm)
+{
+   int MinVal, 
+       MaxVal,
        i, j;
 
+   if((mdm == NULL) || (mdm->size == 0))
+      return(0);
+   
+   MinVal = MaxVal = blMDMATRIXCELL(mdm, 0, 0);
+
    /* Find the minimum and maximum values on the matrix                 */
-   for(i=0; i<sMDMSize; i++)
+   for(i=0; i<mdm->size; i++)
    {
-      for(j=0; j<sMDMSize; j++)
+      for(j=0; j<mdm->size; j++)
       {
-         if(sMDMScore[i][j] < MinVal)
+         if(blMDMATRIXCELL(mdm, i, j) < MinVal)
          {
-            MinVal = sMDMScore[i][j];
+            MinVal = blMDMATRIXCELL(mdm, i, j);
          }
-         else if(sMDMScore[i][j] > MaxVal)
+         else if(blMDMATRIXCELL(mdm, i, j) > MaxVal)
          {
-            MaxVal = sMDMScore[i][j];
+            MaxVal = blMDMATRIXCELL(mdm, i, j);
          }
       }
    }
@@ -1553,11 +1857,11 @@ int blZeroMDM(void)
    /* Now subtract the MinVal from all cells in the matrix so it starts
       at zero.
    */
-   for(i=0; i<sMDMSize; i++)
+   for(i=0; i<mdm->size; i++)
    {
-      for(j=0; j<sMDMSize; j++)
+      for(j=0; j<mdm->size; j++)
       {
-         sMDMScore[i][j] -= MinVal;
+         blMDMATRIXCELL(mdm, i, j) -= MinVal;
       }
    }
    
@@ -1577,39 +1881,28 @@ int blZeroMDM(void)
    Apply a weight to a particular amino acid substitution
 
 -  26.08.14 Original   By: ACRM
+-  17.10.26 Now a wrapper to blSetMDMatrixScoreWeight()   By: ACRM
 */
 void blSetMDMScoreWeight(char resa, char resb, REAL weight)
 {
-   int        i,j;
    static int NWarn = 0;
+   char       res[2];
+   int        i;
    BOOL       Warned = FALSE;
 
-   resa = (islower(resa)?toupper(resa):resa);
-   resb = (islower(resb)?toupper(resb):resb);
-
-   for(i=0;i<sMDMSize;i++)
-   {
-      if(resa==sMDM_AAList[i]) break;
-   }
-   if(i==sMDMSize) 
+   res[0] = resa;
+   res[1] = resb;
+   for(i=0; i<2; i++)
    {
-      if(NWarn < 10)
-         printf("Residue %c not found in matrix\n",resa);
-      else if(NWarn == 10)
-         printf("More residues not found in matrix...\n");
-      Warned = TRUE;
-   }
-   for(j=0;j<sMDMSize;j++)
-   {
-      if(resb==sMDM_AAList[j]) break;
-   }
-   if(j==sMDMSize) 
-   {
-      if(NWarn < 10)
-         printf("Residue %c not found in matrix\n",resb);
-      else if(NWarn == 10)
-         printf("More residues not found in matrix...\n");
-      Warned = TRUE;
+      if((sMDM == NULL) || 
+         (sMDM->codeUC[(unsigned char)res[i]] == sMDM->size))
+      {
+         if(NWarn < 10)
+            printf("Residue %c not found in matrix\n",res[i]);
+         else if(NWarn == 10)
+            printf("More residues not found in matrix...\n");
+         Warned = TRUE;
+      }
    }
    
    if(Warned)
@@ -1618,11 +1911,41 @@ void blSetMDMScoreWeight(char resa, char resb, REAL weight)
       return;
    }
 
-   sMDMScore[i][j] *= weight;
+   blSetMDMatrixScoreWeight(sMDM, resa, resb, weight);
+}
+            
+/************************************************************************/
+/*>BOOL blSetMDMatrixScoreWeight(MDMATRIX *mdm, char resa, char resb, 
+                                 REAL weight)
+   ------------------------------------------------------------------
+*//**
+
+   \param[in,out] *mdm      Scoring matrix
+   \param[in]     resa      First residue
+   \param[in]     resb      Second residue
+   \param[in]     weight    Weight to apply
+   \return                  Were both residues in the matrix?
+
+   Apply a weight to a particular amino acid substitution in the 
+   specified matrix. The residues are upcased.
+
+-  17.10.26 Original, based on blSetMDMScoreWeight() 26.08.14 By: ACRM
+*/
+BOOL blSetMDMatrixScoreWeight(MDMATRIX *mdm, char resa, char resb, 
+                              REAL weight)
+{
+   int i = mdm->codeUC[(unsigned char)resa],
+       j = mdm->codeUC[(unsigned char)resb];
+
+   if((i == mdm->size) || (j == mdm->size))
+      return(FALSE);
+
+   blMDMATRIXCELL(mdm, i, j) *= weight;
    if(i != j)
    {
-      sMDMScore[j][i] *= weight;
+      blMDMATRIXCELL(mdm, j, i) *= weight;
    }
+   return(TRUE);
 }
             
       
@@ -1638,17 +1961,17 @@ int main(int argc, char **argv)
    
    ReadMDM("pet91.mat");
 
-   for(i=0; i<sMDMSize; i++)
+   for(i=0; i<sMDM->size; i++)
    {
-      printf("  %c", sMDM_AAList[i]);
+      printf("  %c", sMDM->aaList[i]);
    }
    printf("\n");
    
-   for(i=0; i<sMDMSize; i++)
+   for(i=0; i<sMDM->size; i++)
    {
-      for(j=0; j<sMDMSize; j++)
+      for(j=0; j<sMDM->size; j++)
       {
-         printf("%3d", sMDMScore[i][j]);
+         printf("%3d", blMDMATRIXCELL(sMDM, i, j));
       }
       printf("\n");
    }
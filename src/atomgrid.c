@@ -0,0 +1,724 @@
+/************************************************************************/
+/**
+
+   \file       atomgrid.c
+
+   \version    V1.1
+   \date       17.10.26
+   \brief      Spatial cell grid for fast distance searches over atoms
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   Places a set of atoms into a regular grid of cubic cells so that all
+   atoms within a given distance of a point can be found by examining
+   only the neighbouring cells rather than every atom. The atoms are
+   counting-sorted by cell so the grid is stored in compressed sparse
+   row form: two integer arrays and a copy of the coordinates in cell
+   order.
+
+   Atoms are identified by their ordinal in the array (or list) used to
+   build the grid.
+
+   blMoveAtomGridAtom() moves a single atom to a new cell without
+   rebuilding the grid. The atom's old slot is left empty and it is
+   linked into a short list of moved atoms for its new cell, so the
+   cost does not depend on the number of atoms in the grid. The grid
+   must be rebuilt if an atom moves outside the original bounds.
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   PDB      **indx;
+   ATOMGRID *grid;
+   int      natoms, nNeighb, maxNeighb = 0, *neighbs = NULL;
+
+   indx = blIndexPDB(pdb, &natoms);
+   grid = blBuildAtomGrid(indx, natoms, (REAL)5.0);
+   nNeighb = blFindAtomGridNeighbours(grid, x, y, z, (REAL)5.0,
+                                      &neighbs, &maxNeighb);
+   ...
+   free(neighbs);
+   blFreeAtomGrid(grid);
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Added blMoveAtomGridAtom(). The cell of each atom is
+                  now kept in the grid   By: ACRM
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP Distance searching
+
+   #FUNCTION  blBuildAtomGrid()
+   Builds a spatial grid from an array of PDB pointers
+
+   #FUNCTION  blBuildAtomGridXYZ()
+   Builds a spatial grid from separate coordinate arrays
+
+   #FUNCTION  blFreeAtomGrid()
+   Frees a spatial grid
+
+   #FUNCTION  blFindAtomGridNeighbours()
+   Finds all atoms in a grid within a distance of a point
+
+   #FUNCTION  blAtomGridAnyWithin()
+   Tests whether any atom in a grid is within a distance of a point
+
+   #FUNCTION  blMoveAtomGridAtom()
+   Moves one atom within a grid without rebuilding it
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "pdb.h"
+#include "atomgrid.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define CELLINDEX(g, i, j, k) ((((k) * (g)->ny) + (j)) * (g)->nx + (i))
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static int CellCoord(REAL val, REAL min, REAL cellSize, int ncells);
+static void CellRange(ATOMGRID *grid, REAL x, REAL y, REAL z, REAL dist,
+                      int *lo, int *hi);
+static BOOL InitMovedAtoms(ATOMGRID *grid);
+static BOOL StoreNeighbour(int atom, int nNeighb, int **neighbours,
+                           int *maxNeighb);
+
+
+/************************************************************************/
+/*>ATOMGRID *blBuildAtomGrid(PDB **atoms, int natoms, REAL cellSize)
+   -----------------------------------------------------------------
+*//**
+
+   \param[in]     **atoms    Array of PDB pointers (e.g. from
+                             blIndexPDB())
+   \param[in]     natoms     Number of atoms in the array
+   \param[in]     cellSize   Requested cell size. Normally the distance
+                             cutoff that will be used in searches
+   \return                   Malloc'd grid or NULL on allocation failure
+
+   Builds a spatial grid over an array of atoms. Neighbour searches
+   return indexes into the atoms[] array. The grid holds its own copy
+   of the coordinates, so atoms that move must be updated with
+   blMoveAtomGridAtom() or the grid rebuilt.
+
+-  17.10.26 Original   By: ACRM
+*/
+ATOMGRID *blBuildAtomGrid(PDB **atoms, int natoms, REAL cellSize)
+{
+   ATOMGRID *grid = NULL;
+   REAL     *x = NULL,
+            *y = NULL,
+            *z = NULL;
+   int      i;
+
+   if(natoms > 0)
+   {
+      x = (REAL *)malloc(natoms * sizeof(REAL));
+      y = (REAL *)malloc(natoms * sizeof(REAL));
+      z = (REAL *)malloc(natoms * sizeof(REAL));
+      if((x==NULL) || (y==NULL) || (z==NULL))
+      {
+         FREE(x);
+         FREE(y);
+         FREE(z);
+         return(NULL);
+      }
+
+      for(i=0; i<natoms; i++)
+      {
+         x[i] = atoms[i]->x;
+         y[i] = atoms[i]->y;
+         z[i] = atoms[i]->z;
+      }
+   }
+
+   grid = blBuildAtomGridXYZ(x, y, z, natoms, cellSize);
+
+   FREE(x);
+   FREE(y);
+   FREE(z);
+
+   return(grid);
+}
+
+
+/************************************************************************/
+/*>ATOMGRID *blBuildAtomGridXYZ(REAL *x, REAL *y, REAL *z, int natoms,
+                                REAL cellSize)
+   -------------------------------------------------------------------
+*//**
+
+   \param[in]     *x         Array of x coordinates
+   \param[in]     *y         Array of y coordinates
+   \param[in]     *z         Array of z coordinates
+   \param[in]     natoms     Number of atoms
+   \param[in]     cellSize   Requested cell size. Normally the distance
+                             cutoff that will be used in searches
+   \return                   Malloc'd grid or NULL on allocation failure
+
+   Builds a spatial grid from coordinate arrays. If the requested cell
+   size would create more than ATOMGRID_MAXCELLFACTOR cells per atom
+   (i.e. a very sparse grid) the cell size is increased to bound the
+   memory used. This affects only speed, not the results of searches.
+
+-  17.10.26 Original   By: ACRM
+*/
+ATOMGRID *blBuildAtomGridXYZ(REAL *x, REAL *y, REAL *z, int natoms,
+                             REAL cellSize)
+{
+   ATOMGRID *grid;
+   REAL     xmax, ymax, zmax;
+   double   ncells;
+   int      i, c,
+            *cellOf,
+            *fill   = NULL;
+
+   if(cellSize <= (REAL)0.0)
+      cellSize = (REAL)1.0;
+
+   if((grid = (ATOMGRID *)malloc(sizeof(ATOMGRID)))==NULL)
+      return(NULL);
+
+   grid->natoms      = natoms;
+   grid->xyz         = NULL;
+   grid->movedXyz    = NULL;
+   grid->cellStart   = NULL;
+   grid->sortedIndex = NULL;
+   grid->cellOf      = NULL;
+   grid->slotOf      = NULL;
+   grid->movedHead   = NULL;
+   grid->movedNext   = NULL;
+   grid->xmin = grid->ymin = grid->zmin = (REAL)0.0;
+   xmax = ymax = zmax = (REAL)0.0;
+
+   /* Find the bounding box                                             */
+   for(i=0; i<natoms; i++)
+   {
+      if((i==0) || (x[i] < grid->xmin)) grid->xmin = x[i];
+      if((i==0) || (y[i] < grid->ymin)) grid->ymin = y[i];
+      if((i==0) || (z[i] < grid->zmin)) grid->zmin = z[i];
+      if((i==0) || (x[i] > xmax))       xmax       = x[i];
+      if((i==0) || (y[i] > ymax))       ymax       = y[i];
+      if((i==0) || (z[i] > zmax))       zmax       = z[i];
+   }
+
+   /* Choose the grid dimensions, growing the cells if the grid would
+      be too sparse
+   */
+   for(;;)
+   {
+      grid->nx = (int)((xmax - grid->xmin) / cellSize) + 1;
+      grid->ny = (int)((ymax - grid->ymin) / cellSize) + 1;
+      grid->nz = (int)((zmax - grid->zmin) / cellSize) + 1;
+      ncells   = (double)grid->nx * (double)grid->ny * (double)grid->nz;
+      if(ncells <= (double)ATOMGRID_MAXCELLFACTOR * (double)(natoms+1))
+         break;
+      cellSize *= (REAL)2.0;
+   }
+   grid->cellSize = cellSize;
+
+   /* Allocate the arrays                                               */
+   grid->cellStart   = (int *)calloc((size_t)ncells + 1, sizeof(int));
+   grid->sortedIndex = (int *)malloc((natoms+1) * sizeof(int));
+   grid->xyz         = (REAL *)malloc((3*natoms+1) * sizeof(REAL));
+   grid->cellOf      = (int *)malloc((natoms+1) * sizeof(int));
+   fill              = (int *)malloc(((size_t)ncells + 1) * sizeof(int));
+   if((grid->cellStart == NULL) || (grid->sortedIndex == NULL) ||
+      (grid->xyz == NULL) || (grid->cellOf == NULL) || (fill == NULL))
+   {
+      FREE(fill);
+      blFreeAtomGrid(grid);
+      return(NULL);
+   }
+
+   /* Count the atoms in each cell                                      */
+   cellOf = grid->cellOf;
+   for(i=0; i<natoms; i++)
+   {
+      cellOf[i] = CELLINDEX(grid,
+                     CellCoord(x[i], grid->xmin, cellSize, grid->nx),
+                     CellCoord(y[i], grid->ymin, cellSize, grid->ny),
+                     CellCoord(z[i], grid->zmin, cellSize, grid->nz));
+      grid->cellStart[cellOf[i]+1]++;
+   }
+
+   /* Convert counts to start offsets                                   */
+   for(c=0; c<(int)ncells; c++)
+   {
+      grid->cellStart[c+1] += grid->cellStart[c];
+      fill[c] = grid->cellStart[c];
+   }
+
+   /* Place the atoms                                                   */
+   for(i=0; i<natoms; i++)
+   {
+      int pos = fill[cellOf[i]]++;
+      grid->sortedIndex[pos] = i;
+      grid->xyz[3*pos]       = x[i];
+      grid->xyz[3*pos+1]     = y[i];
+      grid->xyz[3*pos+2]     = z[i];
+   }
+
+   free(fill);
+
+   return(grid);
+}
+
+
+/************************************************************************/
+/*>void blFreeAtomGrid(ATOMGRID *grid)
+   -----------------------------------
+*//**
+
+   \param[in]     *grid      Grid to be freed
+
+   Frees all memory associated with a grid
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeAtomGrid(ATOMGRID *grid)
+{
+   if(grid != NULL)
+   {
+      FREE(grid->xyz);
+      FREE(grid->movedXyz);
+      FREE(grid->cellStart);
+      FREE(grid->sortedIndex);
+      FREE(grid->cellOf);
+      FREE(grid->slotOf);
+      FREE(grid->movedHead);
+      FREE(grid->movedNext);
+      free(grid);
+   }
+}
+
+
+/************************************************************************/
+/*>int blFindAtomGridNeighbours(ATOMGRID *grid, REAL x, REAL y, REAL z,
+                                REAL dist, int **neighbours,
+                                int *maxNeighb)
+   --------------------------------------------------------------------
+*//**
+
+   \param[in]     *grid        The grid
+   \param[in]     x            x coordinate of the point
+   \param[in]     y            y coordinate of the point
+   \param[in]     z            z coordinate of the point
+   \param[in]     dist         Distance cutoff
+   \param[in,out] **neighbours Array of atom ordinals. This is
+                               (re)allocated as required so may
+                               be passed in as a pointer to NULL
+   \param[in,out] *maxNeighb   Allocated size of the neighbours array.
+                               0 if neighbours is NULL
+   \return                     Number of atoms found or -1 on
+                               allocation failure
+
+   Finds all atoms in the grid that lie within dist of the specified
+   point. The neighbours array may be reused between calls to avoid
+   repeated allocation.
+
+-  17.10.26 Original   By: ACRM
+*/
+int blFindAtomGridNeighbours(ATOMGRID *grid, REAL x, REAL y, REAL z,
+                             REAL dist, int **neighbours, int *maxNeighb)
+{
+   int  lo[3], hi[3],
+        i, j, k, a,
+        nNeighb = 0;
+   REAL distSq = dist * dist;
+
+   if((grid == NULL) || (grid->natoms == 0))
+      return(0);
+
+   CellRange(grid, x, y, z, dist, lo, hi);
+
+   for(k=lo[2]; k<=hi[2]; k++)
+   {
+      for(j=lo[1]; j<=hi[1]; j++)
+      {
+         for(i=lo[0]; i<=hi[0]; i++)
+         {
+            int c = CELLINDEX(grid, i, j, k);
+
+            for(a=grid->cellStart[c]; a<grid->cellStart[c+1]; a++)
+            {
+               REAL dx = grid->xyz[3*a]   - x,
+                    dy = grid->xyz[3*a+1] - y,
+                    dz = grid->xyz[3*a+2] - z;
+
+               if((grid->sortedIndex[a] >= 0) &&
+                  ((dx*dx + dy*dy + dz*dz) <= distSq))
+               {
+                  if(!StoreNeighbour(grid->sortedIndex[a], nNeighb,
+                                     neighbours, maxNeighb))
+                     return(-1);
+                  nNeighb++;
+               }
+            }
+
+            /* Atoms that have moved into this cell                     */
+            if(grid->movedHead != NULL)
+            {
+               for(a=grid->movedHead[c]; a>=0; a=grid->movedNext[a])
+               {
+                  REAL dx = grid->movedXyz[3*a]   - x,
+                       dy = grid->movedXyz[3*a+1] - y,
+                       dz = grid->movedXyz[3*a+2] - z;
+
+                  if((dx*dx + dy*dy + dz*dz) <= distSq)
+                  {
+                     if(!StoreNeighbour(a, nNeighb, neighbours,
+                                        maxNeighb))
+                        return(-1);
+                     nNeighb++;
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   return(nNeighb);
+}
+
+
+/************************************************************************/
+/*>BOOL blAtomGridAnyWithin(ATOMGRID *grid, REAL x, REAL y, REAL z,
+                            REAL dist)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in]     *grid        The grid
+   \param[in]     x            x coordinate of the point
+   \param[in]     y            y coordinate of the point
+   \param[in]     z            z coordinate of the point
+   \param[in]     dist         Distance cutoff
+   \return                     Is any atom in the grid within dist of
+                               the point?
+
+   Tests whether any atom in the grid is within dist of the specified
+   point, returning as soon as one is found.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blAtomGridAnyWithin(ATOMGRID *grid, REAL x, REAL y, REAL z,
+                         REAL dist)
+{
+   int  lo[3], hi[3],
+        i, j, k, a;
+   REAL distSq = dist * dist;
+
+   if((grid == NULL) || (grid->natoms == 0))
+      return(FALSE);
+
+   CellRange(grid, x, y, z, dist, lo, hi);
+
+   for(k=lo[2]; k<=hi[2]; k++)
+   {
+      for(j=lo[1]; j<=hi[1]; j++)
+      {
+         for(i=lo[0]; i<=hi[0]; i++)
+         {
+            int c = CELLINDEX(grid, i, j, k);
+
+            for(a=grid->cellStart[c]; a<grid->cellStart[c+1]; a++)
+            {
+               REAL dx = grid->xyz[3*a]   - x,
+                    dy = grid->xyz[3*a+1] - y,
+                    dz = grid->xyz[3*a+2] - z;
+
+               if((grid->sortedIndex[a] >= 0) &&
+                  ((dx*dx + dy*dy + dz*dz) <= distSq))
+                  return(TRUE);
+            }
+
+            /* Atoms that have moved into this cell                     */
+            if(grid->movedHead != NULL)
+            {
+               for(a=grid->movedHead[c]; a>=0; a=grid->movedNext[a])
+               {
+                  REAL dx = grid->movedXyz[3*a]   - x,
+                       dy = grid->movedXyz[3*a+1] - y,
+                       dz = grid->movedXyz[3*a+2] - z;
+
+                  if((dx*dx + dy*dy + dz*dz) <= distSq)
+                     return(TRUE);
+               }
+            }
+         }
+      }
+   }
+
+   return(FALSE);
+}
+
+
+/************************************************************************/
+/*>BOOL blMoveAtomGridAtom(ATOMGRID *grid, int atom, REAL x, REAL y,
+                           REAL z)
+   -----------------------------------------------------------------
+*//**
+
+   \param[in,out] *grid        The grid
+   \param[in]     atom         Ordinal of the atom to move
+   \param[in]     x            New x coordinate
+   \param[in]     y            New y coordinate
+   \param[in]     z            New z coordinate
+   \return                     Success. FALSE if the new position is
+                               outside the grid (or on allocation
+                               failure) in which case the grid is
+                               unchanged and must be rebuilt
+
+   Moves an atom to a new position without rebuilding the grid. The
+   atom is unlinked from its old cell and linked into the new one so
+   the time taken does not depend on the number of atoms in the grid.
+   The first move allocates and fills the arrays used to track moved
+   atoms.
+
+-  17.10.26 Original   By: ACRM
+*/
+BOOL blMoveAtomGridAtom(ATOMGRID *grid, int atom, REAL x, REAL y, REAL z)
+{
+   REAL xoff, yoff, zoff;
+   int  c, slot,
+        *link;
+
+   if((grid == NULL) || (atom < 0) || (atom >= grid->natoms))
+      return(FALSE);
+
+   /* Check the new position is within the grid                        */
+   xoff = (x - grid->xmin) / grid->cellSize;
+   yoff = (y - grid->ymin) / grid->cellSize;
+   zoff = (z - grid->zmin) / grid->cellSize;
+   if((xoff < (REAL)0.0) || (xoff >= (REAL)grid->nx) ||
+      (yoff < (REAL)0.0) || (yoff >= (REAL)grid->ny) ||
+      (zoff < (REAL)0.0) || (zoff >= (REAL)grid->nz))
+      return(FALSE);
+   c = CELLINDEX(grid, (int)xoff, (int)yoff, (int)zoff);
+
+   if((grid->movedHead == NULL) && !InitMovedAtoms(grid))
+      return(FALSE);
+
+   /* An atom that stays in its original cell keeps its slot           */
+   slot = grid->slotOf[atom];
+   if((slot >= 0) && (c == grid->cellOf[atom]))
+   {
+      grid->xyz[3*slot]   = x;
+      grid->xyz[3*slot+1] = y;
+      grid->xyz[3*slot+2] = z;
+      return(TRUE);
+   }
+
+   /* Unlink the atom from its old cell                                */
+   if(slot >= 0)
+   {
+      grid->sortedIndex[slot] = -1;
+      grid->slotOf[atom]      = -1;
+   }
+   else
+   {
+      link = &(grid->movedHead[grid->cellOf[atom]]);
+      while(*link != atom)
+         link = &(grid->movedNext[*link]);
+      *link = grid->movedNext[atom];
+   }
+
+   /* Link it into the new cell                                        */
+   grid->movedNext[atom]    = grid->movedHead[c];
+   grid->movedHead[c]       = atom;
+   grid->cellOf[atom]       = c;
+   grid->movedXyz[3*atom]   = x;
+   grid->movedXyz[3*atom+1] = y;
+   grid->movedXyz[3*atom+2] = z;
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static int CellCoord(REAL val, REAL min, REAL cellSize, int ncells)
+   -------------------------------------------------------------------
+*//**
+
+   \param[in]     val        Coordinate
+   \param[in]     min        Grid origin in this dimension
+   \param[in]     cellSize   Cell size
+   \param[in]     ncells     Number of cells in this dimension
+   \return                   Cell number, clamped to the grid
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CellCoord(REAL val, REAL min, REAL cellSize, int ncells)
+{
+   REAL offset = (val - min) / cellSize;
+
+   if(offset < (REAL)0.0)
+      return(0);
+   if(offset >= (REAL)ncells)
+      return(ncells - 1);
+   return((int)offset);
+}
+
+
+/************************************************************************/
+/*>static void CellRange(ATOMGRID *grid, REAL x, REAL y, REAL z,
+                         REAL dist, int *lo, int *hi)
+   -------------------------------------------------------------
+*//**
+
+   \param[in]     *grid      The grid
+   \param[in]     x          x coordinate of the point
+   \param[in]     y          y coordinate of the point
+   \param[in]     z          z coordinate of the point
+   \param[in]     dist       Distance cutoff
+   \param[out]    *lo        Lowest cell in each dimension
+   \param[out]    *hi        Highest cell in each dimension
+
+   Finds the range of cells that must be searched to find atoms within
+   dist of a point. Points outside the grid are clamped to the edge
+   cells; since the range is inclusive this can only add cells to be
+   searched, never miss one.
+
+-  17.10.26 Original   By: ACRM
+*/
+static void CellRange(ATOMGRID *grid, REAL x, REAL y, REAL z, REAL dist,
+                      int *lo, int *hi)
+{
+   lo[0] = CellCoord(x-dist, grid->xmin, grid->cellSize, grid->nx);
+   lo[1] = CellCoord(y-dist, grid->ymin, grid->cellSize, grid->ny);
+   lo[2] = CellCoord(z-dist, grid->zmin, grid->cellSize, grid->nz);
+   hi[0] = CellCoord(x+dist, grid->xmin, grid->cellSize, grid->nx);
+   hi[1] = CellCoord(y+dist, grid->ymin, grid->cellSize, grid->ny);
+   hi[2] = CellCoord(z+dist, grid->zmin, grid->cellSize, grid->nz);
+}
+
+
+/************************************************************************/
+/*>static BOOL InitMovedAtoms(ATOMGRID *grid)
+   ------------------------------------------
+*//**
+
+   \param[in,out] *grid      The grid
+   \return                   Success
+
+   Allocates the arrays used to track atoms moved by 
+   blMoveAtomGridAtom() and records the slot of each atom in
+   sortedIndex.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL InitMovedAtoms(ATOMGRID *grid)
+{
+   int ncells = grid->nx * grid->ny * grid->nz,
+       i;
+
+   grid->movedXyz  = (REAL *)malloc((3*grid->natoms+1) * sizeof(REAL));
+   grid->slotOf    = (int *)malloc((grid->natoms+1) * sizeof(int));
+   grid->movedHead = (int *)malloc((ncells+1) * sizeof(int));
+   grid->movedNext = (int *)malloc((grid->natoms+1) * sizeof(int));
+   if((grid->movedXyz == NULL) || (grid->slotOf == NULL) ||
+      (grid->movedHead == NULL) || (grid->movedNext == NULL))
+   {
+      FREE(grid->movedXyz);
+      FREE(grid->slotOf);
+      FREE(grid->movedHead);
+      FREE(grid->movedNext);
+      return(FALSE);
+   }
+
+   for(i=0; i<ncells; i++)
+      grid->movedHead[i] = -1;
+   for(i=0; i<grid->natoms; i++)
+      grid->slotOf[grid->sortedIndex[i]] = i;
+
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static BOOL StoreNeighbour(int atom, int nNeighb, int **neighbours,
+                              int *maxNeighb)
+   -------------------------------------------------------------------
+*//**
+
+   \param[in]     atom         Atom ordinal to store
+   \param[in]     nNeighb      Number of neighbours already stored
+   \param[in,out] **neighbours Array of atom ordinals (reallocated as
+                               required)
+   \param[in,out] *maxNeighb   Allocated size of the neighbours array
+   \return                     Success
+
+   Stores an atom in the neighbours array of 
+   blFindAtomGridNeighbours(), growing the array if needed.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL StoreNeighbour(int atom, int nNeighb, int **neighbours,
+                           int *maxNeighb)
+{
+   if(nNeighb >= *maxNeighb)
+   {
+      int newSize = (*maxNeighb < 16) ? 32 : 2 * (*maxNeighb),
+          *tmp;
+
+      if((tmp = (int *)realloc(*neighbours, newSize * sizeof(int)))
+         == NULL)
+         return(FALSE);
+      *neighbours = tmp;
+      *maxNeighb  = newSize;
+   }
+   (*neighbours)[nNeighb] = atom;
+   return(TRUE);
+}
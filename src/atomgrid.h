@@ -0,0 +1,109 @@
+/************************************************************************/
+/**
+
+   \file       atomgrid.h
+
+   \version    V1.1
+   \date       17.10.26
+   \brief      Spatial cell grid for fast distance searches over atoms
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Added blMoveAtomGridAtom()   By: ACRM
+
+*************************************************************************/
+#ifndef _ATOMGRID_H
+#define _ATOMGRID_H
+
+/************************************************************************/
+/* Includes
+*/
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define ATOMGRID_MAXCELLFACTOR 8  /* Max cells per atom before the cell
+                                     size is increased                  */
+
+/* The grid stores the atoms sorted by cell in compressed sparse row form.
+   Atoms in cell c are sortedIndex[cellStart[c]]...
+   sortedIndex[cellStart[c+1]-1] and their coordinates are held
+   contiguously in xyz[] in the same order.
+
+   An atom moved by blMoveAtomGridAtom() leaves its slot in sortedIndex
+   (which is set to -1) and is linked into the list of moved atoms for
+   its new cell: movedHead[c], movedNext[movedHead[c]], ... with its
+   coordinates in movedXyz[] by ordinal. These arrays are NULL until
+   an atom is first moved.
+*/
+typedef struct
+{
+   REAL xmin, ymin, zmin,    /* Grid origin                             */
+        cellSize,            /* Edge length of a cubic cell             */
+        *xyz,                /* Coordinates in cell order (3 per atom)  */
+        *movedXyz;           /* Coordinates of moved atoms by ordinal   */
+   int  nx, ny, nz,          /* Number of cells in each dimension       */
+        natoms,              /* Number of atoms in the grid             */
+        *cellStart,          /* Start of each cell in sortedIndex       */
+        *sortedIndex,        /* Caller's atom ordinals in cell order    */
+        *cellOf,             /* Cell of each atom by ordinal            */
+        *slotOf,             /* Slot of each atom in sortedIndex (-1
+                                once it has moved)                      */
+        *movedHead,          /* First moved atom in each cell (or -1)   */
+        *movedNext;          /* Next moved atom in the same cell        */
+}  ATOMGRID;
+
+/************************************************************************/
+/* Prototypes
+*/
+ATOMGRID *blBuildAtomGrid(PDB **atoms, int natoms, REAL cellSize);
+ATOMGRID *blBuildAtomGridXYZ(REAL *x, REAL *y, REAL *z, int natoms,
+                             REAL cellSize);
+void blFreeAtomGrid(ATOMGRID *grid);
+int  blFindAtomGridNeighbours(ATOMGRID *grid, REAL x, REAL y, REAL z,
+                              REAL dist, int **neighbours, int *maxNeighb);
+BOOL blAtomGridAnyWithin(ATOMGRID *grid, REAL x, REAL y, REAL z,
+                         REAL dist);
+BOOL blMoveAtomGridAtom(ATOMGRID *grid, int atom, REAL x, REAL y, REAL z);
+
+#endif
@@ -0,0 +1,1531 @@
+/************************************************************************/
+/**
+
+   \file       atomsel.c
+
+   \version    V1.2
+   \date       17.10.26
+   \brief      Compiled atom selection expressions evaluated as bit masks
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+   A small selection language which combines the various ways of
+   choosing atoms that are otherwise spread across
+   blSelectAtomsPDBAsCopy(), blAtomNameMatch(), blInPDBZoneSpec() and
+   blGetPDBChainAsCopy(). An expression is compiled once into a postfix
+   program. Evaluation runs each instruction over all atoms producing a
+   bit mask with one bit per atom; the boolean operators then work a
+   whole machine word at a time.
+
+   Grammar (keywords are case insensitive):
+
+\verbatim
+   expr     := andexpr { ('or' | '|') andexpr }
+   andexpr  := notexpr { ('and' | '&') notexpr }
+   notexpr  := ('not' | '!') notexpr | primary
+   primary  := '(' expr ')'
+            |  'all' | 'none' | 'atom' | 'hetatm' | 'water'
+            |  'chain'   list          e.g. chain A,B
+            |  'resnam'  list          e.g. resnam ALA,GLY
+            |  'name'    list          e.g. name CA,C*,?G1
+            |  'element' list          e.g. element C,N
+            |  'resid'   list          e.g. resid A10-A20,B5,L27A
+            |  'resnum'  list          e.g. resnum 10-20,50
+            |  'bval'    cmp number    e.g. bval < 30
+            |  'occ'     cmp number    e.g. occ >= 0.5
+            |  'within'  number 'of' primary
+   list     := item { ',' item }
+   cmp      := '<' | '<=' | '>' | '>=' | '=' | '==' | '!='
+\endverbatim
+
+   Atom names use the same wildcards as blAtomNameMatch(). Residue
+   ranges use the same residue specifications as blParseResSpec() and
+   follow the rules of blInPDBZone().
+
+**************************************************************************
+
+   Usage:
+   ======
+
+\code
+   ATOMSEL  *sel;
+   ATOMMASK *mask;
+
+   sel  = blCompileAtomSelection("chain A and name CA and bval < 40");
+   mask = blEvalAtomSelectionPDB(sel, pdb);
+   for(p=pdb, i=0; p!=NULL; NEXT(p), i++)
+      if(ATOMMASK_ISSET(mask, i)) ...
+   blFreeAtomMask(mask);
+   blFreeAtomSelection(sel);
+\endcode
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Atom name lists are compiled to ATOMNAMEPATTERNs
+-  V1.2  17.10.26 Added blDeleteAtomMaskPDB()
+
+*************************************************************************/
+/* Doxygen
+   -------
+   #GROUP    Handling PDB Data
+   #SUBGROUP Atom selection
+
+   #FUNCTION  blAllocAtomMask()
+   Allocates a cleared atom bit mask
+
+   #FUNCTION  blFreeAtomMask()
+   Frees an atom bit mask
+
+   #FUNCTION  blClearAtomMask()
+   Clears all bits in an atom bit mask
+
+   #FUNCTION  blSetAllAtomMask()
+   Sets all bits in an atom bit mask
+
+   #FUNCTION  blCountAtomMask()
+   Counts the atoms set in an atom bit mask
+
+   #FUNCTION  blCompileAtomSelection()
+   Compiles a selection expression into a selection program
+
+   #FUNCTION  blFreeAtomSelection()
+   Frees a compiled selection program
+
+   #FUNCTION  blEvalAtomSelectionPDB()
+   Evaluates a compiled selection over a PDB linked list
+
+   #FUNCTION  blEvalAtomSelectionIndex()
+   Evaluates a compiled selection over an array of PDB pointers
+
+   #FUNCTION  blSelectAtomsByExpression()
+   Compiles and evaluates a selection expression in one call
+
+   #FUNCTION  blDeleteAtomMaskPDB()
+   Deletes the atoms set in a mask from a PDB linked list
+*/
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "SysDefs.h"
+#include "MathType.h"
+#include "macros.h"
+#include "pdb.h"
+#include "ErrStack.h"
+#include "atomgrid.h"
+#include "atomsel.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define TOK_END     0
+#define TOK_WORD    1
+#define TOK_LPAREN  2
+#define TOK_RPAREN  3
+#define TOK_COMMA   4
+#define TOK_AND     5
+#define TOK_OR      6
+#define TOK_NOT     7
+#define TOK_CMP     8
+
+#define SPECIALCHARS "(),&|!<>="
+
+typedef struct
+{
+   char    *pos;
+   ATOMSEL *sel;
+   int     type;
+   BOOL    error;
+   char    token[ATOMSEL_MAXTOKEN];
+}  SELPARSER;
+
+/* Walks a mask alongside the linked list for blDeleteAtomMaskPDB()     */
+typedef struct
+{
+   ATOMMASK *mask;
+   int      index;
+}  MASKCURSOR;
+
+/************************************************************************/
+/* Globals
+*/
+
+/************************************************************************/
+/* Prototypes
+*/
+static void NextToken(SELPARSER *ps);
+static BOOL KeywordIs(char *token, char *keyword);
+static void SelError(SELPARSER *ps, char *msg);
+static ATOMSELINSTR *NewInstr(SELPARSER *ps, int opcode);
+static void ParseOr(SELPARSER *ps);
+static void ParseAnd(SELPARSER *ps);
+static void ParseNot(SELPARSER *ps);
+static void ParsePrimary(SELPARSER *ps);
+static void ParseNameList(SELPARSER *ps, int opcode, BOOL upper);
+static void ParseRangeList(SELPARSER *ps, int opcode);
+static void ParseComparison(SELPARSER *ps, int opcode);
+static BOOL ParseNumber(char *word, REAL *value);
+static int  RangeSplit(char *item);
+static BOOL FieldMatch(char *field, char *want);
+static BOOL TestAtom(ATOMSELINSTR *instr, PDB *p);
+static void EvalLeaf(ATOMSELINSTR *instr, PDB **indx, ATOMMASK *mask);
+static BOOL EvalWithin(REAL dist, PDB **indx, ATOMMASK *mask);
+static void ClearMaskTail(ATOMMASK *mask);
+static BOOL MaskIsSet(PDB *p, APTR cursor);
+
+
+/************************************************************************/
+/*>ATOMMASK *blAllocAtomMask(int natoms)
+   -------------------------------------
+*//**
+
+   \param[in]     natoms    Number of atoms to be represented
+   \return                  Malloc'd mask with all bits clear, or NULL
+
+   Allocates an atom bit mask
+
+-  17.10.26 Original   By: ACRM
+*/
+ATOMMASK *blAllocAtomMask(int natoms)
+{
+   ATOMMASK *mask;
+
+   if((mask = (ATOMMASK *)malloc(sizeof(ATOMMASK)))==NULL)
+      return(NULL);
+
+   mask->natoms = natoms;
+   mask->nwords = ATOMMASK_NWORDS(natoms);
+   if((mask->bits = (ULONG *)calloc(mask->nwords + 1, sizeof(ULONG)))
+      ==NULL)
+   {
+      free(mask);
+      return(NULL);
+   }
+
+   return(mask);
+}
+
+
+/************************************************************************/
+/*>void blFreeAtomMask(ATOMMASK *mask)
+   -----------------------------------
+*//**
+
+   \param[in]     *mask    Mask to be freed
+
+   Frees an atom bit mask
+
+-  17.10.26 Original   By: ACRM
+*/
+void blFreeAtomMask(ATOMMASK *mask)
+{
+   if(mask != NULL)
+   {
+      FREE(mask->bits);
+      free(mask);
+   }
+}
+
+
+/************************************************************************/
+/*>void blClearAtomMask(ATOMMASK *mask)
+   ------------------------------------
+*//**
+
+   \param[in,out] *mask    Mask to be cleared
+
+   Clears all bits in an atom mask
+
+-  17.10.26 Original   By: ACRM
+*/
+void blClearAtomMask(ATOMMASK *mask)
+{
+   int i;
+   for(i=0; i<mask->nwords; i++)
+      mask->bits[i] = (ULONG)0;
+}
+
+
+/************************************************************************/
+/*>void blSetAllAtomMask(ATOMMASK *mask)
+   -------------------------------------
+*//**
+
+   \param[in,out] *mask    Mask to be set
+
+   Sets the bits for all atoms in an atom mask
+
+-  17.10.26 Original   By: ACRM
+*/
+void blSetAllAtomMask(ATOMMASK *mask)
+{
+   int i;
+   for(i=0; i<mask->nwords; i++)
+      mask->bits[i] = ~((ULONG)0);
+   ClearMaskTail(mask);
+}
+
+
+/************************************************************************/
+/*>int blCountAtomMask(ATOMMASK *mask)
+   -----------------------------------
+*//**
+
+   \param[in]     *mask    Atom mask
+   \return                 Number of atoms set in the mask
+
+   Counts the atoms set in an atom mask
+
+-  17.10.26 Original   By: ACRM
+*/
+int blCountAtomMask(ATOMMASK *mask)
+{
+   int   i, count = 0;
+   ULONG word;
+
+   for(i=0; i<mask->nwords; i++)
+   {
+      /* Clear the lowest set bit each time round                       */
+      for(word=mask->bits[i]; word; word &= (word - 1))
+         count++;
+   }
+   return(count);
+}
+
+
+/************************************************************************/
+/*>ATOMSEL *blCompileAtomSelection(char *expression)
+   -------------------------------------------------
+*//**
+
+   \param[in]     *expression   Selection expression
+   \return                      Compiled selection or NULL on error
+
+   Compiles a selection expression (see the description at the top of
+   this file for the grammar) into a postfix program that can be
+   evaluated repeatedly with blEvalAtomSelectionPDB() or
+   blEvalAtomSelectionIndex().
+
+   Syntax errors and allocation failures are reported through
+   blStoreError() and NULL is returned.
+
+-  17.10.26 Original   By: ACRM
+*/
+ATOMSEL *blCompileAtomSelection(char *expression)
+{
+   SELPARSER ps;
+   ATOMSEL   *sel;
+   int       i, depth = 0;
+
+   if((sel = (ATOMSEL *)malloc(sizeof(ATOMSEL)))==NULL)
+   {
+      blStoreError("blCompileAtomSelection", "No memory for selection");
+      return(NULL);
+   }
+   sel->program    = NULL;
+   sel->nInstr     = 0;
+   sel->maxInstr   = 0;
+   sel->stackDepth = 0;
+
+   ps.pos   = expression;
+   ps.sel   = sel;
+   ps.error = FALSE;
+
+   NextToken(&ps);
+   if(ps.type == TOK_END)
+      SelError(&ps, "Empty selection");
+   else
+      ParseOr(&ps);
+
+   if(!ps.error && (ps.type != TOK_END))
+      SelError(&ps, "Unexpected text at end of selection");
+
+   if(ps.error)
+   {
+      blFreeAtomSelection(sel);
+      return(NULL);
+   }
+
+   /* Find the depth of evaluation stack needed                         */
+   for(i=0; i<sel->nInstr; i++)
+   {
+      switch(sel->program[i].opcode)
+      {
+      case ATOMSEL_OP_AND:
+      case ATOMSEL_OP_OR:
+         depth--;
+         break;
+      case ATOMSEL_OP_NOT:
+      case ATOMSEL_OP_WITHIN:
+         break;
+      default:
+         depth++;
+         break;
+      }
+      if(depth > sel->stackDepth)
+         sel->stackDepth = depth;
+   }
+
+   return(sel);
+}
+
+
+/************************************************************************/
+/*>void blFreeAtomSelection(ATOMSEL *sel)
+   --------------------------------------
+*//**
+
+   \param[in]     *sel     Compiled selection
+
+   Frees a compiled selection
+
+-  17.10.26 Original   By: ACRM
+-  17.10.26 Frees compiled atom names   By: ACRM
+*/
+void blFreeAtomSelection(ATOMSEL *sel)
+{
+   int i, j;
+
+   if(sel == NULL)
+      return;
+
+   for(i=0; i<sel->nInstr; i++)
+   {
+      if(sel->program[i].strings != NULL)
+      {
+         for(j=0; j<sel->program[i].nstrings; j++)
+         {
+            FREE(sel->program[i].strings[j]);
+         }
+         free(sel->program[i].strings);
+      }
+      FREE(sel->program[i].patterns);
+   }
+   FREE(sel->program);
+   free(sel);
+}
+
+
+/************************************************************************/
+/*>ATOMMASK *blEvalAtomSelectionPDB(ATOMSEL *sel, PDB *pdb)
+   --------------------------------------------------------
+*//**
+
+   \param[in]     *sel     Compiled selection
+   \param[in]     *pdb     PDB linked list
+   \return                 Malloc'd atom mask or NULL on allocation
+                           failure
+
+   Evaluates a compiled selection over a PDB linked list. Bit i of the
+   returned mask is set if the i'th atom in the list is selected.
+
+-  17.10.26 Original   By: ACRM
+*/
+ATOMMASK *blEvalAtomSelectionPDB(ATOMSEL *sel, PDB *pdb)
+{
+   PDB      **indx;
+   ATOMMASK *mask;
+   int      natoms;
+
+   if((indx = blIndexPDB(pdb, &natoms))==NULL)
+      return(NULL);
+
+   mask = blEvalAtomSelectionIndex(sel, indx, natoms);
+   free(indx);
+   return(mask);
+}
+
+
+/************************************************************************/
+/*>ATOMMASK *blEvalAtomSelectionIndex(ATOMSEL *sel, PDB **indx,
+                                      int natoms)
+   -------------------------------------------------------------
+*//**
+
+   \param[in]     *sel     Compiled selection
+   \param[in]     **indx   Array of PDB pointers (e.g. from blIndexPDB())
+   \param[in]     natoms   Number of atoms in indx
+   \return                 Malloc'd atom mask or NULL on allocation
+                           failure
+
+   Evaluates a compiled selection over an array of PDB pointers. Bit i
+   of the returned mask is set if indx[i] is selected.
+
+   Each instruction is applied to all atoms at once; the result of a
+   leaf instruction is a mask pushed on the evaluation stack and the
+   boolean operators combine masks a word at a time.
+
+-  17.10.26 Original   By: ACRM
+*/
+ATOMMASK *blEvalAtomSelectionIndex(ATOMSEL *sel, PDB **indx, int natoms)
+{
+   ATOMMASK **stack,
+            *result = NULL;
+   int      i, w,
+            sp = 0;
+   BOOL     ok = TRUE;
+
+   if((sel == NULL) || (sel->stackDepth < 1))
+      return(NULL);
+
+   if((stack = (ATOMMASK **)calloc(sel->stackDepth, sizeof(ATOMMASK *)))
+      ==NULL)
+      return(NULL);
+
+   for(i=0; i<sel->stackDepth; i++)
+   {
+      if((stack[i] = blAllocAtomMask(natoms))==NULL)
+      {
+         ok = FALSE;
+         break;
+      }
+   }
+
+   for(i=0; ok && (i<sel->nInstr); i++)
+   {
+      ATOMSELINSTR *instr = &(sel->program[i]);
+      ATOMMASK     *top, *second;
+
+      switch(instr->opcode)
+      {
+      case ATOMSEL_OP_AND:
+         top    = stack[--sp];
+         second = stack[sp-1];
+         for(w=0; w<top->nwords; w++)
+            second->bits[w] &= top->bits[w];
+         break;
+      case ATOMSEL_OP_OR:
+         top    = stack[--sp];
+         second = stack[sp-1];
+         for(w=0; w<top->nwords; w++)
+            second->bits[w] |= top->bits[w];
+         break;
+      case ATOMSEL_OP_NOT:
+         top = stack[sp-1];
+         for(w=0; w<top->nwords; w++)
+            top->bits[w] = ~(top->bits[w]);
+         ClearMaskTail(top);
+         break;
+      case ATOMSEL_OP_WITHIN:
+         ok = EvalWithin(instr->value, indx, stack[sp-1]);
+         break;
+      default:
+         EvalLeaf(instr, indx, stack[sp++]);
+         break;
+      }
+   }
+
+   /* The result is the only mask left on the stack                     */
+   if(ok)
+   {
+      result   = stack[0];
+      stack[0] = NULL;
+   }
+
+   for(i=0; i<sel->stackDepth; i++)
+      blFreeAtomMask(stack[i]);
+   free(stack);
+
+   return(result);
+}
+
+
+/************************************************************************/
+/*>ATOMMASK *blSelectAtomsByExpression(PDB *pdb, char *expression)
+   ---------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb          PDB linked list
+   \param[in]     *expression   Selection expression
+   \return                      Malloc'd atom mask or NULL on error
+
+   Convenience routine to compile and evaluate a selection in one go.
+   If the same selection is to be applied to many structures, compile
+   it once with blCompileAtomSelection() instead.
+
+-  17.10.26 Original   By: ACRM
+*/
+ATOMMASK *blSelectAtomsByExpression(PDB *pdb, char *expression)
+{
+   ATOMSEL  *sel;
+   ATOMMASK *mask;
+
+   if((sel = blCompileAtomSelection(expression))==NULL)
+      return(NULL);
+   mask = blEvalAtomSelectionPDB(sel, pdb);
+   blFreeAtomSelection(sel);
+   return(mask);
+}
+
+
+/************************************************************************/
+/*>PDB *blDeleteAtomMaskPDB(PDB *pdb, ATOMMASK *mask, int *ndeleted)
+   -----------------------------------------------------------------
+*//**
+
+   \param[in]     *pdb          PDB linked list
+   \param[in]     *mask         Atoms to delete
+   \param[out]    *ndeleted     Number of atoms deleted (or NULL)
+   \return                      New start of the linked list
+
+   Deletes the atoms selected in a mask (e.g. from 
+   blSelectAtomsByExpression()) in a single pass through the linked 
+   list using blDeleteAtomsPDB(). Should be called as
+   pdb=blDeleteAtomMaskPDB(pdb, mask, &n);
+
+-  17.10.26 Original   By: ACRM
+*/
+PDB *blDeleteAtomMaskPDB(PDB *pdb, ATOMMASK *mask, int *ndeleted)
+{
+   MASKCURSOR cursor;
+
+   cursor.mask  = mask;
+   cursor.index = 0;
+   return(blDeleteAtomsPDB(pdb, MaskIsSet, (APTR)&cursor, ndeleted));
+}
+
+
+/************************************************************************/
+/*>static BOOL MaskIsSet(PDB *p, APTR cursor)
+   ------------------------------------------
+*//**
+
+   \param[in]     *p        Atom (unused)
+   \param[in,out] cursor    MASKCURSOR
+   \return                  Is the bit set for this atom?
+
+   blDeleteAtomsPDB() test for blDeleteAtomMaskPDB(). Relies on being
+   called once for each atom in order.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL MaskIsSet(PDB *p, APTR cursor)
+{
+   MASKCURSOR *c = (MASKCURSOR *)cursor;
+   int        i  = (c->index)++;
+
+   return((i < c->mask->natoms) && ATOMMASK_ISSET(c->mask, i));
+}
+
+
+/************************************************************************/
+/*>static void NextToken(SELPARSER *ps)
+   ------------------------------------
+*//**
+
+   \param[in,out] *ps     Parser state
+
+   Reads the next token from the expression into ps->token and sets
+   ps->type
+
+-  17.10.26 Original   By: ACRM
+*/
+static void NextToken(SELPARSER *ps)
+{
+   int i = 0;
+
+   while(isspace(*(ps->pos)))
+      (ps->pos)++;
+
+   ps->token[0] = '\0';
+
+   switch(*(ps->pos))
+   {
+   case '\0':
+      ps->type = TOK_END;
+      return;
+   case '(':
+      ps->type = TOK_LPAREN;
+      (ps->pos)++;
+      return;
+   case ')':
+      ps->type = TOK_RPAREN;
+      (ps->pos)++;
+      return;
+   case ',':
+      ps->type = TOK_COMMA;
+      (ps->pos)++;
+      return;
+   case '&':
+      ps->type = TOK_AND;
+      (ps->pos)++;
+      return;
+   case '|':
+      ps->type = TOK_OR;
+      (ps->pos)++;
+      return;
+   case '!':
+      if(*(ps->pos + 1) != '=')
+      {
+         ps->type = TOK_NOT;
+         (ps->pos)++;
+         return;
+      }
+      /* Fall through for != */
+   case '<':
+   case '>':
+   case '=':
+      ps->type = TOK_CMP;
+      ps->token[i++] = *(ps->pos)++;
+      if(*(ps->pos) == '=')
+         ps->token[i++] = *(ps->pos)++;
+      ps->token[i] = '\0';
+      return;
+   default:
+      break;
+   }
+
+   /* A word - runs until white space or a special character. A
+      backslash escapes the next character but is kept since atom
+      name wildcards use the same convention
+   */
+   ps->type = TOK_WORD;
+   while(*(ps->pos) && !isspace(*(ps->pos)) &&
+         (strchr(SPECIALCHARS, *(ps->pos)) == NULL))
+   {
+      if((*(ps->pos) == '\\') && *(ps->pos + 1))
+      {
+         if(i < ATOMSEL_MAXTOKEN-1)
+            ps->token[i++] = *(ps->pos);
+         (ps->pos)++;
+      }
+      if(i < ATOMSEL_MAXTOKEN-1)
+         ps->token[i++] = *(ps->pos);
+      (ps->pos)++;
+   }
+   ps->token[i] = '\0';
+}
+
+
+/************************************************************************/
+/*>static BOOL KeywordIs(char *token, char *keyword)
+   -------------------------------------------------
+*//**
+
+   \param[in]     *token    Token read from the expression
+   \param[in]     *keyword  Lower case keyword
+   \return                  Does the token match the keyword (case
+                            insensitive)?
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL KeywordIs(char *token, char *keyword)
+{
+   for(; *token && *keyword; token++, keyword++)
+   {
+      if(tolower(*token) != *keyword)
+         return(FALSE);
+   }
+   return((*token == '\0') && (*keyword == '\0'));
+}
+
+
+/************************************************************************/
+/*>static void SelError(SELPARSER *ps, char *msg)
+   ----------------------------------------------
+*//**
+
+   \param[in,out] *ps     Parser state
+   \param[in]     *msg    Error message
+
+   Records a compilation error on the error stack. Only the first error
+   is recorded.
+
+-  17.10.26 Original   By: ACRM
+*/
+static void SelError(SELPARSER *ps, char *msg)
+{
+   char buffer[ATOMSEL_MAXTOKEN + 80];
+
+   if(!ps->error)
+   {
+      sprintf(buffer, "%s at '%.40s'", msg, ps->token);
+      blStoreError("blCompileAtomSelection", buffer);
+      ps->error = TRUE;
+   }
+}
+
+
+/************************************************************************/
+/*>static ATOMSELINSTR *NewInstr(SELPARSER *ps, int opcode)
+   --------------------------------------------------------
+*//**
+
+   \param[in,out] *ps     Parser state
+   \param[in]     opcode  Opcode for the new instruction
+   \return                The new (cleared) instruction or NULL
+
+   Appends an instruction to the program being compiled
+
+-  17.10.26 Original   By: ACRM
+*/
+static ATOMSELINSTR *NewInstr(SELPARSER *ps, int opcode)
+{
+   ATOMSEL      *sel = ps->sel;
+   ATOMSELINSTR *instr;
+
+   if(ps->error)
+      return(NULL);
+
+   if(sel->nInstr >= sel->maxInstr)
+   {
+      int          newMax = (sel->maxInstr == 0) ? 16 : 2*sel->maxInstr;
+      ATOMSELINSTR *tmp;
+
+      if((tmp = (ATOMSELINSTR *)realloc(sel->program,
+                                        newMax * sizeof(ATOMSELINSTR)))
+         ==NULL)
+      {
+         SelError(ps, "No memory for selection");
+         return(NULL);
+      }
+      sel->program  = tmp;
+      sel->maxInstr = newMax;
+   }
+
+   instr = &(sel->program[(sel->nInstr)++]);
+   instr->opcode     = opcode;
+   instr->value      = (REAL)0.0;
+   instr->strings    = NULL;
+   instr->patterns   = NULL;
+   instr->nstrings   = 0;
+   instr->cmp        = ATOMSEL_CMP_EQ;
+   instr->resnum1    = 0;
+   instr->resnum2    = 0;
+   instr->chain[0]   = '\0';
+   instr->insert1[0] = '\0';
+   instr->insert2[0] = '\0';
+
+   return(instr);
+}
+
+
+/************************************************************************/
+/*>static void ParseOr(SELPARSER *ps)
+   ----------------------------------
+*//**
+
+   \param[in,out] *ps     Parser state
+
+   expr := andexpr { ('or' | '|') andexpr }
+
+-  17.10.26 Original   By: ACRM
+*/
+static void ParseOr(SELPARSER *ps)
+{
+   ParseAnd(ps);
+   while(!ps->error &&
+         ((ps->type == TOK_OR) ||
+          ((ps->type == TOK_WORD) && KeywordIs(ps->token, "or"))))
+   {
+      NextToken(ps);
+      ParseAnd(ps);
+      NewInstr(ps, ATOMSEL_OP_OR);
+   }
+}
+
+
+/************************************************************************/
+/*>static void ParseAnd(SELPARSER *ps)
+   -----------------------------------
+*//**
+
+   \param[in,out] *ps     Parser state
+
+   andexpr := notexpr { ('and' | '&') notexpr }
+
+-  17.10.26 Original   By: ACRM
+*/
+static void ParseAnd(SELPARSER *ps)
+{
+   ParseNot(ps);
+   while(!ps->error &&
+         ((ps->type == TOK_AND) ||
+          ((ps->type == TOK_WORD) && KeywordIs(ps->token, "and"))))
+   {
+      NextToken(ps);
+      ParseNot(ps);
+      NewInstr(ps, ATOMSEL_OP_AND);
+   }
+}
+
+
+/************************************************************************/
+/*>static void ParseNot(SELPARSER *ps)
+   -----------------------------------
+*//**
+
+   \param[in,out] *ps     Parser state
+
+   notexpr := ('not' | '!') notexpr | primary
+
+-  17.10.26 Original   By: ACRM
+*/
+static void ParseNot(SELPARSER *ps)
+{
+   if((ps->type == TOK_NOT) ||
+      ((ps->type == TOK_WORD) && KeywordIs(ps->token, "not")))
+   {
+      NextToken(ps);
+      ParseNot(ps);
+      NewInstr(ps, ATOMSEL_OP_NOT);
+   }
+   else
+   {
+      ParsePrimary(ps);
+   }
+}
+
+
+/************************************************************************/
+/*>static void ParsePrimary(SELPARSER *ps)
+   ---------------------------------------
+*//**
+
+   \param[in,out] *ps     Parser state
+
+   Parses a bracketed expression or a single selection keyword with
+   its arguments
+
+-  17.10.26 Original   By: ACRM
+*/
+static void ParsePrimary(SELPARSER *ps)
+{
+   ATOMSELINSTR *instr;
+   REAL         dist;
+
+   if(ps->error)
+      return;
+
+   if(ps->type == TOK_LPAREN)
+   {
+      NextToken(ps);
+      ParseOr(ps);
+      if(ps->type != TOK_RPAREN)
+      {
+         SelError(ps, "Missing )");
+         return;
+      }
+      NextToken(ps);
+      return;
+   }
+
+   if(ps->type != TOK_WORD)
+   {
+      SelError(ps, "Expected a selection keyword");
+      return;
+   }
+
+   if(KeywordIs(ps->token, "all"))
+   {
+      NewInstr(ps, ATOMSEL_OP_ALL);
+      NextToken(ps);
+   }
+   else if(KeywordIs(ps->token, "none"))
+   {
+      NewInstr(ps, ATOMSEL_OP_NONE);
+      NextToken(ps);
+   }
+   else if(KeywordIs(ps->token, "atom"))
+   {
+      NewInstr(ps, ATOMSEL_OP_ATOM);
+      NextToken(ps);
+   }
+   else if(KeywordIs(ps->token, "hetatm"))
+   {
+      NewInstr(ps, ATOMSEL_OP_HETATM);
+      NextToken(ps);
+   }
+   else if(KeywordIs(ps->token, "water"))
+   {
+      NewInstr(ps, ATOMSEL_OP_WATER);
+      NextToken(ps);
+   }
+   else if(KeywordIs(ps->token, "chain"))
+   {
+      ParseNameList(ps, ATOMSEL_OP_CHAIN, FALSE);
+   }
+   else if(KeywordIs(ps->token, "resnam"))
+   {
+      ParseNameList(ps, ATOMSEL_OP_RESNAM, TRUE);
+   }
+   else if(KeywordIs(ps->token, "name"))
+   {
+      ParseNameList(ps, ATOMSEL_OP_ATNAM, TRUE);
+   }
+   else if(KeywordIs(ps->token, "element"))
+   {
+      ParseNameList(ps, ATOMSEL_OP_ELEMENT, TRUE);
+   }
+   else if(KeywordIs(ps->token, "resid"))
+   {
+      ParseRangeList(ps, ATOMSEL_OP_RESID);
+   }
+   else if(KeywordIs(ps->token, "resnum"))
+   {
+      ParseRangeList(ps, ATOMSEL_OP_RESNUM);
+   }
+   else if(KeywordIs(ps->token, "bval"))
+   {
+      ParseComparison(ps, ATOMSEL_OP_BVAL);
+   }
+   else if(KeywordIs(ps->token, "occ"))
+   {
+      ParseComparison(ps, ATOMSEL_OP_OCC);
+   }
+   else if(KeywordIs(ps->token, "within"))
+   {
+      NextToken(ps);
+      if((ps->type != TOK_WORD) || !ParseNumber(ps->token, &dist) ||
+         (dist < (REAL)0.0))
+      {
+         SelError(ps, "Expected a distance after 'within'");
+         return;
+      }
+      NextToken(ps);
+      if((ps->type != TOK_WORD) || !KeywordIs(ps->token, "of"))
+      {
+         SelError(ps, "Expected 'of'");
+         return;
+      }
+      NextToken(ps);
+      ParsePrimary(ps);
+      if((instr = NewInstr(ps, ATOMSEL_OP_WITHIN))!=NULL)
+         instr->value = dist;
+   }
+   else
+   {
+      SelError(ps, "Unknown selection keyword");
+   }
+}
+
+
+/************************************************************************/
+/*>static void ParseNameList(SELPARSER *ps, int opcode, BOOL upper)
+   ----------------------------------------------------------------
+*//**
+
+   \param[in,out] *ps     Parser state
+   \param[in]     opcode  Opcode for the instruction
+   \param[in]     upper   Upper case the names
+
+   Parses a comma separated list of names following a keyword and
+   stores them in a single instruction
+
+-  17.10.26 Original   By: ACRM
+-  17.10.26 Compiles atom names   By: ACRM
+*/
+static void ParseNameList(SELPARSER *ps, int opcode, BOOL upper)
+{
+   ATOMSELINSTR *instr;
+   char         **tmp;
+
+   if((instr = NewInstr(ps, opcode))==NULL)
+      return;
+
+   do
+   {
+      NextToken(ps);
+      if(ps->type != TOK_WORD)
+      {
+         SelError(ps, "Expected a name");
+         return;
+      }
+
+      if((tmp = (char **)realloc(instr->strings,
+                                 (instr->nstrings + 1) * sizeof(char *)))
+         ==NULL)
+      {
+         SelError(ps, "No memory for selection");
+         return;
+      }
+      instr->strings = tmp;
+      if((instr->strings[instr->nstrings] =
+          (char *)malloc(strlen(ps->token) + 1))==NULL)
+      {
+         SelError(ps, "No memory for selection");
+         return;
+      }
+      strcpy(instr->strings[instr->nstrings], ps->token);
+      if(upper)
+         UPPER(instr->strings[instr->nstrings]);
+      (instr->nstrings)++;
+
+      NextToken(ps);
+   }  while(ps->type == TOK_COMMA);
+
+   /* Atom names are compiled so that the wildcards are only parsed once.
+      Any that can't be compiled are left to blAtomNameMatch()
+   */
+   if(opcode == ATOMSEL_OP_ATNAM)
+   {
+      int i;
+      
+      if((instr->patterns = (ATOMNAMEPATTERN *)
+          malloc(instr->nstrings * sizeof(ATOMNAMEPATTERN)))==NULL)
+      {
+         SelError(ps, "No memory for selection");
+         return;
+      }
+      for(i=0; i<instr->nstrings; i++)
+      {
+         if(!blCompileAtomNamePattern(instr->strings[i], FALSE,
+                                      &(instr->patterns[i])))
+            instr->patterns[i].nbytes = (-1);
+      }
+   }
+}
+
+
+/************************************************************************/
+/*>static void ParseRangeList(SELPARSER *ps, int opcode)
+   -----------------------------------------------------
+*//**
+
+   \param[in,out] *ps     Parser state
+   \param[in]     opcode  ATOMSEL_OP_RESID or ATOMSEL_OP_RESNUM
+
+   Parses a comma separated list of residue ranges (or single residues)
+   following a keyword. Each range becomes its own instruction and they
+   are combined with OR.
+
+-  17.10.26 Original   By: ACRM
+*/
+static void ParseRangeList(SELPARSER *ps, int opcode)
+{
+   ATOMSELINSTR *instr;
+   char         chain2[blMAXCHAINLABEL+8],
+                *second;
+   int          split,
+                nItems = 0;
+
+   do
+   {
+      NextToken(ps);
+      if(ps->type != TOK_WORD)
+      {
+         SelError(ps, "Expected a residue range");
+         return;
+      }
+      if((instr = NewInstr(ps, opcode))==NULL)
+         return;
+
+      /* Split into first and last residue                              */
+      split = RangeSplit(ps->token);
+      if(split > 0)
+      {
+         ps->token[split] = '\0';
+         second = ps->token + split + 1;
+      }
+      else
+      {
+         second = ps->token;
+      }
+
+      if(opcode == ATOMSEL_OP_RESID)
+      {
+         if(!blParseResSpec(ps->token, instr->chain, &(instr->resnum1),
+                            instr->insert1) ||
+            !blParseResSpec(second, chain2, &(instr->resnum2),
+                            instr->insert2))
+         {
+            SelError(ps, "Illegal residue specification");
+            return;
+         }
+         if(!CHAINMATCH(instr->chain, chain2))
+         {
+            SelError(ps, "Residue range spans chains");
+            return;
+         }
+      }
+      else
+      {
+         if((sscanf(ps->token, "%d", &(instr->resnum1)) != 1) ||
+            (sscanf(second,    "%d", &(instr->resnum2)) != 1))
+         {
+            SelError(ps, "Illegal residue number");
+            return;
+         }
+      }
+
+      if(nItems++)
+         NewInstr(ps, ATOMSEL_OP_OR);
+
+      NextToken(ps);
+   }  while(ps->type == TOK_COMMA);
+}
+
+
+/************************************************************************/
+/*>static void ParseComparison(SELPARSER *ps, int opcode)
+   ------------------------------------------------------
+*//**
+
+   \param[in,out] *ps     Parser state
+   \param[in]     opcode  ATOMSEL_OP_BVAL or ATOMSEL_OP_OCC
+
+   Parses a comparison operator and threshold following a keyword
+
+-  17.10.26 Original   By: ACRM
+*/
+static void ParseComparison(SELPARSER *ps, int opcode)
+{
+   ATOMSELINSTR *instr;
+   int          cmp;
+   REAL         value;
+
+   NextToken(ps);
+   if(ps->type != TOK_CMP)
+   {
+      SelError(ps, "Expected a comparison operator");
+      return;
+   }
+
+   if(!strcmp(ps->token, "<"))
+      cmp = ATOMSEL_CMP_LT;
+   else if(!strcmp(ps->token, "<="))
+      cmp = ATOMSEL_CMP_LE;
+   else if(!strcmp(ps->token, ">"))
+      cmp = ATOMSEL_CMP_GT;
+   else if(!strcmp(ps->token, ">="))
+      cmp = ATOMSEL_CMP_GE;
+   else if(!strcmp(ps->token, "!="))
+      cmp = ATOMSEL_CMP_NE;
+   else if(!strcmp(ps->token, "=") || !strcmp(ps->token, "=="))
+      cmp = ATOMSEL_CMP_EQ;
+   else
+   {
+      SelError(ps, "Illegal comparison operator");
+      return;
+   }
+
+   NextToken(ps);
+   if((ps->type != TOK_WORD) || !ParseNumber(ps->token, &value))
+   {
+      SelError(ps, "Expected a number");
+      return;
+   }
+
+   if((instr = NewInstr(ps, opcode))!=NULL)
+   {
+      instr->cmp   = cmp;
+      instr->value = value;
+   }
+   NextToken(ps);
+}
+
+
+/************************************************************************/
+/*>static BOOL ParseNumber(char *word, REAL *value)
+   ------------------------------------------------
+*//**
+
+   \param[in]     *word    Text to parse
+   \param[out]    *value   Number read
+   \return                 Was the whole of word a valid number?
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL ParseNumber(char *word, REAL *value)
+{
+   char *end;
+
+   *value = (REAL)strtod(word, &end);
+   return((end != word) && (*end == '\0'));
+}
+
+
+/************************************************************************/
+/*>static int RangeSplit(char *item)
+   ---------------------------------
+*//**
+
+   \param[in]     *item    A residue range such as A10-A20 or -5--1
+   \return                 Offset of the '-' separating the two ends
+                           or 0 if this is a single residue
+
+   A '-' is only taken to be the range separator if a digit has already
+   been seen and it does not immediately follow a '.' or another '-'.
+   This allows negative residue numbers at either end of the range.
+
+-  17.10.26 Original   By: ACRM
+*/
+static int RangeSplit(char *item)
+{
+   int  i;
+   BOOL gotDigit = FALSE;
+
+   for(i=0; item[i]; i++)
+   {
+      if(isdigit(item[i]))
+      {
+         gotDigit = TRUE;
+      }
+      else if((item[i] == '-') && gotDigit && (i > 0) &&
+              (item[i-1] != '.') && (item[i-1] != '-'))
+      {
+         return(i);
+      }
+   }
+   return(0);
+}
+
+
+/************************************************************************/
+/*>static BOOL FieldMatch(char *field, char *want)
+   -----------------------------------------------
+*//**
+
+   \param[in]     *field   Space padded field from the PDB structure
+   \param[in]     *want    Value to compare with
+   \return                 Do they match, ignoring trailing spaces?
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL FieldMatch(char *field, char *want)
+{
+   for(; *want; field++, want++)
+   {
+      if(*field != *want)
+         return(FALSE);
+   }
+   return((*field == '\0') || (*field == ' '));
+}
+
+
+/************************************************************************/
+/*>static BOOL TestAtom(ATOMSELINSTR *instr, PDB *p)
+   -------------------------------------------------
+*//**
+
+   \param[in]     *instr   Leaf instruction
+   \param[in]     *p       Atom to test
+   \return                 Does the atom satisfy the instruction?
+
+-  17.10.26 Original   By: ACRM
+-  17.10.26 Uses compiled atom names   By: ACRM
+*/
+static BOOL TestAtom(ATOMSELINSTR *instr, PDB *p)
+{
+   int  i;
+   REAL value;
+
+   switch(instr->opcode)
+   {
+   case ATOMSEL_OP_ALL:
+      return(TRUE);
+   case ATOMSEL_OP_NONE:
+      return(FALSE);
+   case ATOMSEL_OP_ATOM:
+      return(!strncmp(p->record_type, "ATOM  ", 6));
+   case ATOMSEL_OP_HETATM:
+      return(!strncmp(p->record_type, "HETATM", 6));
+   case ATOMSEL_OP_WATER:
+      return(ISWATER(p));
+   case ATOMSEL_OP_CHAIN:
+      for(i=0; i<instr->nstrings; i++)
+         if(CHAINMATCH(p->chain, instr->strings[i]))
+            return(TRUE);
+      return(FALSE);
+   case ATOMSEL_OP_RESNAM:
+      for(i=0; i<instr->nstrings; i++)
+         if(FieldMatch(p->resnam, instr->strings[i]))
+            return(TRUE);
+      return(FALSE);
+   case ATOMSEL_OP_ELEMENT:
+      for(i=0; i<instr->nstrings; i++)
+         if(FieldMatch(p->element, instr->strings[i]))
+            return(TRUE);
+      return(FALSE);
+   case ATOMSEL_OP_ATNAM:
+      for(i=0; i<instr->nstrings; i++)
+      {
+         if(instr->patterns[i].nbytes < 0)
+         {
+            if(blAtomNameMatch(p->atnam, instr->strings[i], NULL))
+               return(TRUE);
+         }
+         else if(blMatchAtomNamePatternPDB(p, &(instr->patterns[i])))
+         {
+            return(TRUE);
+         }
+      }
+      return(FALSE);
+   case ATOMSEL_OP_RESID:
+      return(blInPDBZone(p, instr->chain,
+                         instr->resnum1, instr->insert1,
+                         instr->resnum2, instr->insert2));
+   case ATOMSEL_OP_RESNUM:
+      return((p->resnum >= instr->resnum1) &&
+             (p->resnum <= instr->resnum2));
+   case ATOMSEL_OP_BVAL:
+   case ATOMSEL_OP_OCC:
+      value = (instr->opcode == ATOMSEL_OP_BVAL) ? p->bval : p->occ;
+      switch(instr->cmp)
+      {
+      case ATOMSEL_CMP_LT:
+         return(value <  instr->value);
+      case ATOMSEL_CMP_LE:
+         return(value <= instr->value);
+      case ATOMSEL_CMP_GT:
+         return(value >  instr->value);
+      case ATOMSEL_CMP_GE:
+         return(value >= instr->value);
+      case ATOMSEL_CMP_NE:
+         return(value != instr->value);
+      default:
+         return(value == instr->value);
+      }
+   default:
+      break;
+   }
+   return(FALSE);
+}
+
+
+/************************************************************************/
+/*>static void EvalLeaf(ATOMSELINSTR *instr, PDB **indx, ATOMMASK *mask)
+   ---------------------------------------------------------------------
+*//**
+
+   \param[in]     *instr   Leaf instruction
+   \param[in]     **indx   Array of atoms
+   \param[out]    *mask    Mask to fill in
+
+   Applies a leaf instruction to every atom. Bits are accumulated in a
+   local word and stored a word at a time.
+
+-  17.10.26 Original   By: ACRM
+*/
+static void EvalLeaf(ATOMSELINSTR *instr, PDB **indx, ATOMMASK *mask)
+{
+   int   w, b, i,
+         natoms = mask->natoms;
+   ULONG word;
+
+   for(w=0, i=0; w<mask->nwords; w++)
+   {
+      word = (ULONG)0;
+      for(b=0; (b<ATOMMASK_WORDBITS) && (i<natoms); b++, i++)
+      {
+         if(TestAtom(instr, indx[i]))
+            word |= ((ULONG)1 << b);
+      }
+      mask->bits[w] = word;
+   }
+}
+
+
+/************************************************************************/
+/*>static BOOL EvalWithin(REAL dist, PDB **indx, ATOMMASK *mask)
+   -------------------------------------------------------------
+*//**
+
+   \param[in]     dist     Distance cutoff
+   \param[in]     **indx   Array of atoms
+   \param[in,out] *mask    Input: atoms defining the region
+                           Output: atoms within dist of those atoms
+   \return                 Success (FALSE on allocation failure)
+
+   Replaces a mask by the set of atoms within dist of any atom in the
+   mask. The atoms in the mask are placed in a spatial grid so the cost
+   is linear in the number of atoms.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL EvalWithin(REAL dist, PDB **indx, ATOMMASK *mask)
+{
+   PDB      **centres;
+   ATOMGRID *grid;
+   int      i, w, b,
+            nCentres = 0;
+   ULONG    word;
+
+   if((centres = (PDB **)malloc((mask->natoms + 1) * sizeof(PDB *)))
+      ==NULL)
+      return(FALSE);
+
+   for(i=0; i<mask->natoms; i++)
+   {
+      if(ATOMMASK_ISSET(mask, i))
+         centres[nCentres++] = indx[i];
+   }
+
+   if((grid = blBuildAtomGrid(centres, nCentres, dist))==NULL)
+   {
+      free(centres);
+      return(FALSE);
+   }
+
+   for(w=0, i=0; w<mask->nwords; w++)
+   {
+      word = mask->bits[w];
+      for(b=0; (b<ATOMMASK_WORDBITS) && (i<mask->natoms); b++, i++)
+      {
+         if(!(word & ((ULONG)1 << b)) &&
+            blAtomGridAnyWithin(grid, indx[i]->x, indx[i]->y,
+                                indx[i]->z, dist))
+            word |= ((ULONG)1 << b);
+      }
+      mask->bits[w] = word;
+   }
+
+   blFreeAtomGrid(grid);
+   free(centres);
+   return(TRUE);
+}
+
+
+/************************************************************************/
+/*>static void ClearMaskTail(ATOMMASK *mask)
+   -----------------------------------------
+*//**
+
+   \param[in,out] *mask    Atom mask
+
+   Clears the unused bits in the last word of a mask after operations
+   such as NOT which act on whole words
+
+-  17.10.26 Original   By: ACRM
+*/
+static void ClearMaskTail(ATOMMASK *mask)
+{
+   int nused = mask->natoms % ATOMMASK_WORDBITS;
+
+   if((nused != 0) && (mask->nwords > 0))
+      mask->bits[mask->nwords - 1] &= (((ULONG)1 << nused) - 1);
+}
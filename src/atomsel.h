@@ -0,0 +1,161 @@
+/************************************************************************/
+/**
+
+   \file       atomsel.h
+
+   \version    V1.2
+   \date       17.10.26
+   \brief      Compiled atom selection expressions and atom bit masks
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Added patterns to ATOMSELINSTR
+-  V1.2  17.10.26 Added blDeleteAtomMaskPDB()
+
+*************************************************************************/
+#ifndef _ATOMSEL_H
+#define _ATOMSEL_H
+
+/************************************************************************/
+/* Includes
+*/
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+
+/* An atom mask has one bit per atom, indexed by the atom's ordinal
+   position in the PDB linked list (or index array)
+*/
+typedef struct
+{
+   ULONG *bits;
+   int   natoms,
+         nwords;
+}  ATOMMASK;
+
+#define ATOMMASK_WORDBITS     ((int)(8 * sizeof(ULONG)))
+#define ATOMMASK_NWORDS(n)    (((n) + ATOMMASK_WORDBITS - 1) /            \
+                               ATOMMASK_WORDBITS)
+#define ATOMMASK_BIT(i)       ((ULONG)1 << ((i) % ATOMMASK_WORDBITS))
+#define ATOMMASK_SET(m, i)    ((m)->bits[(i) / ATOMMASK_WORDBITS] |=      \
+                               ATOMMASK_BIT(i))
+#define ATOMMASK_UNSET(m, i)  ((m)->bits[(i) / ATOMMASK_WORDBITS] &=      \
+                               ~ATOMMASK_BIT(i))
+#define ATOMMASK_ISSET(m, i)  (((m)->bits[(i) / ATOMMASK_WORDBITS] &      \
+                                ATOMMASK_BIT(i)) ? TRUE : FALSE)
+
+/* Opcodes for the compiled selection program                           */
+#define ATOMSEL_OP_ALL         0
+#define ATOMSEL_OP_NONE        1
+#define ATOMSEL_OP_ATOM        2   /* ATOM records                      */
+#define ATOMSEL_OP_HETATM      3   /* HETATM records                    */
+#define ATOMSEL_OP_WATER       4
+#define ATOMSEL_OP_CHAIN       5   /* Chain label in list               */
+#define ATOMSEL_OP_RESNAM      6   /* Residue name in list              */
+#define ATOMSEL_OP_ATNAM       7   /* Atom name matches a wildcard      */
+#define ATOMSEL_OP_ELEMENT     8   /* Element in list                   */
+#define ATOMSEL_OP_RESID       9   /* Chain/residue/insert range        */
+#define ATOMSEL_OP_RESNUM     10   /* Residue number range, any chain   */
+#define ATOMSEL_OP_BVAL       11   /* B-value comparison                */
+#define ATOMSEL_OP_OCC        12   /* Occupancy comparison              */
+#define ATOMSEL_OP_AND        13
+#define ATOMSEL_OP_OR         14
+#define ATOMSEL_OP_NOT        15
+#define ATOMSEL_OP_WITHIN     16   /* Within distance of selection      */
+
+/* Comparison operators for ATOMSEL_OP_BVAL and ATOMSEL_OP_OCC          */
+#define ATOMSEL_CMP_LT         0
+#define ATOMSEL_CMP_LE         1
+#define ATOMSEL_CMP_GT         2
+#define ATOMSEL_CMP_GE         3
+#define ATOMSEL_CMP_EQ         4
+#define ATOMSEL_CMP_NE         5
+
+#define ATOMSEL_MAXTOKEN     160
+
+/* A single instruction of a compiled selection. Leaf instructions push
+   a mask onto the evaluation stack; AND and OR pop two and push one;
+   NOT and WITHIN replace the top of the stack
+*/
+typedef struct
+{
+   REAL value;               /* Threshold or distance                   */
+   char **strings;           /* Names for list-type instructions        */
+   ATOMNAMEPATTERN *patterns;   /* Compiled atom names. nbytes is -1 for
+                                   any that couldn't be compiled        */
+   int  opcode,              /* ATOMSEL_OP_XXXX                         */
+        cmp,                 /* ATOMSEL_CMP_XXXX                        */
+        nstrings,            /* Number of items in strings[]            */
+        resnum1,             /* Residue range                           */
+        resnum2;
+   char chain[blMAXCHAINLABEL],
+        insert1[8],
+        insert2[8];
+}  ATOMSELINSTR;
+
+typedef struct
+{
+   ATOMSELINSTR *program;    /* Postfix program                         */
+   int          nInstr,      /* Number of instructions                  */
+                maxInstr,    /* Allocated size of program[]             */
+                stackDepth;  /* Evaluation stack required               */
+}  ATOMSEL;
+
+/************************************************************************/
+/* Prototypes
+*/
+ATOMMASK *blAllocAtomMask(int natoms);
+void blFreeAtomMask(ATOMMASK *mask);
+void blClearAtomMask(ATOMMASK *mask);
+void blSetAllAtomMask(ATOMMASK *mask);
+int  blCountAtomMask(ATOMMASK *mask);
+
+ATOMSEL *blCompileAtomSelection(char *expression);
+void blFreeAtomSelection(ATOMSEL *sel);
+ATOMMASK *blEvalAtomSelectionPDB(ATOMSEL *sel, PDB *pdb);
+ATOMMASK *blEvalAtomSelectionIndex(ATOMSEL *sel, PDB **indx, int natoms);
+ATOMMASK *blSelectAtomsByExpression(PDB *pdb, char *expression);
+PDB *blDeleteAtomMaskPDB(PDB *pdb, ATOMMASK *mask, int *ndeleted);
+
+#endif
@@ -0,0 +1,105 @@
+/************************************************************************/
+/**
+
+   \file       bondgraph.h
+
+   \version    V1.1
+   \date       17.10.26
+   \brief      Compressed sparse row bond graph for PDB linked lists
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Tagged the BONDGRAPH struct for WHOLEPDB   By: ACRM
+
+*************************************************************************/
+#ifndef _BONDGRAPH_H
+#define _BONDGRAPH_H
+
+/************************************************************************/
+/* Includes
+*/
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+
+/* Used to find the index of an atom from its pointer                   */
+typedef struct
+{
+   PDB *atom;
+   int index;
+}  BONDGRAPHATOM;
+
+/* The bonds of a structure in compressed sparse row form. The atoms
+   bonded to atom i are atoms[neighbours[start[i]]] ...
+   atoms[neighbours[start[i+1]-1]], sorted by index. Each bond appears
+   in the rows of both of its atoms. There is no limit on the number of
+   bonds to an atom.
+*/
+typedef struct _bondgraph
+{
+   PDB           **atoms;    /* Atoms in linked list order              */
+   BONDGRAPHATOM *byPointer; /* Atoms sorted by pointer                 */
+   int           *start,     /* Start of each atom's row (natoms+1)     */
+                 *neighbours,/* Bonded atom indexes                     */
+                 natoms,     /* Number of atoms                         */
+                 nbonds;     /* Number of bonds (each counted once)     */
+}  BONDGRAPH;
+
+#define BONDGRAPH_DEGREE(g, i)       ((g)->start[(i)+1] - (g)->start[(i)])
+#define BONDGRAPH_NEIGHBOUR(g, i, k) ((g)->neighbours[(g)->start[(i)]+(k)])
+
+/************************************************************************/
+/* Prototypes
+*/
+BONDGRAPH *blBuildBondGraphPairs(PDB *pdb, PDB **pairs, int npairs);
+BONDGRAPH *blBuildBondGraphConect(PDB *pdb);
+BONDGRAPH *blBuildBondGraphWholePDB(WHOLEPDB *wpdb);
+BONDGRAPH *blBuildBondGraph(PDB *pdb, REAL tol);
+void blFreeBondGraph(BONDGRAPH *graph);
+int  blBondGraphAtomIndex(BONDGRAPH *graph, PDB *p);
+BOOL blBondGraphIsBonded(BONDGRAPH *graph, int i, int j);
+int  blSetConectsFromBondGraph(BONDGRAPH *graph);
+PDB **blGetConectPairsWholePDB(WHOLEPDB *wpdb, int *npairs);
+
+#endif
@@ -0,0 +1,105 @@
+/************************************************************************/
+/**
+
+   \file       coorarchive.h
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Compressed multi-model coordinate archives
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+#ifndef _COORARCHIVE_H
+#define _COORARCHIVE_H
+
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define COORARC_PRECISION ((REAL)0.001) /* Default: as in a PDB file    */
+#define COORARC_MAXSCALE  100000 /* Finest precision is 1/MAXSCALE A    */
+#define COORARC_MAXCOOR   1073741823L /* Largest quantised coordinate   */
+
+/* An archive of coordinate frames open for writing or reading. Each
+   frame is held as coordinates quantised to 1/scale Angstroms. A key
+   frame stores differences between consecutive atoms; any other frame
+   stores differences from the key frame given in keyFrame[].
+*/
+typedef struct
+{
+   FILE  *fp;
+   long  *offsets,         /* Of each frame from the start of the file;
+                              when reading, offsets[nframes] is the
+                              offset of the frame index                 */
+         *key,             /* 3*natoms quantised coords of cachedKey    */
+         *work;            /* 3*natoms quantised coords of a frame      */
+   int   *keyFrame,        /* The key frame each frame is coded against */
+         natoms,
+         nframes,
+         maxFrames,
+         cachedKey;        /* Frame held in key[] or -1                 */
+   UBYTE *buffer;          /* Encoded frame                             */
+   long  scale,            /* Quantised units per Angstrom              */
+         offset;           /* Bytes written so far                      */
+   BOOL  writing;
+}  COORARCHIVE;
+
+/************************************************************************/
+/* Prototypes
+*/
+COORARCHIVE *blCreateCoorArchive(FILE *fp, int natoms, REAL precision);
+BOOL blWriteCoorArchiveFrame(COORARCHIVE *arc, REAL *xyz);
+BOOL blWriteCoorArchiveFramePDB(COORARCHIVE *arc, PDB *pdb);
+int blWriteCoorArchiveModelsPDB(COORARCHIVE *arc, PDB *pdb);
+COORARCHIVE *blOpenCoorArchive(FILE *fp);
+BOOL blReadCoorArchiveFrame(COORARCHIVE *arc, int frame, REAL *xyz);
+BOOL blReadCoorArchiveFramePDB(COORARCHIVE *arc, int frame, PDB *pdb);
+BOOL blCloseCoorArchive(COORARCHIVE *arc);
+
+#endif
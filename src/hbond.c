@@ -4,8 +4,8 @@
 
    \file       hbond.c
    
-   \version    V1.9
-   \date       14.08.18
+   \version    V1.11
+   \date       17.10.26
    \brief      Report whether two residues are H-bonded using
                Baker & Hubbard criteria
    
@@ -68,6 +68,10 @@
 -  V1.9  14.08.18 Fixed blListAllHBonds() such that it correctly returns
                   a list of HBonds rather than just the first one it
                   finds.
+-  V1.10 17.10.26 Added blGetMaxProteinHBondDADistance() and
+                  blGetMaxProteinHBondHADistance()
+-  V1.11 17.10.26 blIsHBonded() rejects distant residues using their
+                  bounds. Added blIsHBondedResBounds()
 
 *************************************************************************/
 /* Doxygen
@@ -92,9 +96,18 @@
    Overrides the default maximum distance between donor and acceptor.
    NOTE THIS IS NOT THREAD-SAFE
 
+   #FUNCTION  blGetMaxProteinHBondDADistance()
+   Returns the maximum distance between donor and acceptor.
+
+   #FUNCTION  blGetMaxProteinHBondHADistance()
+   Returns the maximum distance between hydrogen and acceptor.
+
    #FUNCTION blListAllHBonds()
    Finds all HBonds between two specified residues
 
+   #FUNCTION blIsHBondedResBounds()
+   Determines whether 2 residues are H-bonded using their bounds
+
 */
 /************************************************************************/
 /* Includes
@@ -107,6 +120,7 @@
 #include "general.h"
 #include "angle.h"
 #include "hbond.h"
+#include "resbounds.h"
 
 /************************************************************************/
 /* Defines and macros
@@ -142,6 +156,8 @@ static BOOL FindBackboneAcceptor(PDB *res, PDB **AtomA, PDB **AtomP);
 static BOOL FindBackboneDonor(PDB *res, PDB **AtomH, PDB **AtomD);
 static BOOL FindSidechainAcceptor(PDB *res, PDB **AtomA, PDB **AtomP);
 static BOOL FindSidechainDonor(PDB *res, PDB **AtomH, PDB **AtomD);
+static BOOL MayBeHBonded(RESBOUND *rb1, RESBOUND *rb2);
+static int IsHBondedResidues(PDB *res1, PDB *res2, int type);
 
 
 /************************************************************************/
@@ -184,8 +200,93 @@ static BOOL FindSidechainDonor(PDB *res, PDB **AtomH, PDB **AtomD);
 
 -  25.01.96 Original    By: ACRM
 -  07.07.14 Use bl prefix for functions By: CTP
+-  17.10.26 Rejects residues whose bounds are too far apart before
+            looking for donors and acceptors   By: ACRM
 */
 int blIsHBonded(PDB *res1, PDB *res2, int type)
+{
+   PDBRESIDUE r1, r2;
+   RESBOUND   rb1, rb2;
+
+   if((res1 == NULL) || (res2 == NULL))
+      return(0);
+
+   blSetResBoundRange(&rb1, &r1, res1, blFindNextResidue(res1));
+   blSetResBoundRange(&rb2, &r2, res2, blFindNextResidue(res2));
+   if(!MayBeHBonded(&rb1, &rb2))
+      return(0);
+
+   return(IsHBondedResidues(res1, res2, type));
+}
+
+
+/************************************************************************/
+/*>int blIsHBondedResBounds(RESBOUND *rb1, RESBOUND *rb2, int type)
+   ----------------------------------------------------------------
+*//**
+   \param[in]   *rb1     The bounds of the first residue
+   \param[in]   *rb2     The bounds of the second residue
+   \param[in]   type     HBond type to search for
+   \return               HBond type found or 0 if none
+
+   As blIsHBonded(), but uses bounds that have already been calculated
+   with blAllocResBounds()
+
+-  17.10.26 Original   By: ACRM
+*/
+int blIsHBondedResBounds(RESBOUND *rb1, RESBOUND *rb2, int type)
+{
+   if(!MayBeHBonded(rb1, rb2))
+      return(0);
+
+   return(IsHBondedResidues(rb1->residue->start, rb2->residue->start,
+                            type));
+}
+
+
+/************************************************************************/
+/*>static BOOL MayBeHBonded(RESBOUND *rb1, RESBOUND *rb2)
+   ------------------------------------------------------
+*//**
+   \param[in]   *rb1     The bounds of the first residue
+   \param[in]   *rb2     The bounds of the second residue
+   \return               FALSE if the residues cannot be H-bonded
+
+   With explicit hydrogens an H-bond may be accepted on the
+   hydrogen-acceptor distance alone, so the larger of the two cutoffs
+   is used. blValidHBond() does not check for NULL coordinates, so
+   residues containing such atoms are never rejected.
+
+-  17.10.26 Original   By: ACRM
+*/
+static BOOL MayBeHBonded(RESBOUND *rb1, RESBOUND *rb2)
+{
+   REAL maxDist;
+
+   if(rb1->nullAtoms || rb2->nullAtoms)
+      return(TRUE);
+
+   maxDist = MAX(blGetMaxProteinHBondDADistance(),
+                 blGetMaxProteinHBondHADistance());
+   return(blResBoundsWithin(rb1, rb2, maxDist));
+}
+
+
+/************************************************************************/
+/*>static int IsHBondedResidues(PDB *res1, PDB *res2, int type)
+   ------------------------------------------------------------
+*//**
+   \param[in]     *res1     First residue
+   \param[in]     *res2     Second residue
+   \param[in]     type      HBond type to search for
+   \return                  HBond type found or 0 if none
+
+   Does the work for blIsHBonded() once the residues are known to be
+   close enough.
+
+-  17.10.26 Split from blIsHBonded()   By: ACRM
+*/
+static int IsHBondedResidues(PDB *res1, PDB *res2, int type)
 {
    PDB *AtomH,              /* The hydrogen                             */
        *AtomD,              /* The hydrogen donor                       */
@@ -782,6 +883,42 @@ void blSetMaxProteinHBondDADistance(REAL dist)
 }
 
 
+/************************************************************************/
+/*>REAL blGetMaxProteinHBondDADistance(void)
+   -----------------------------------------
+*//**
+   \return             The maximum donor-acceptor distance
+
+   Returns the maximum distance between donor and acceptor. No H-bond
+   is found between residues with no pair of atoms closer than this.
+
+-  17.10.26 Original   By: ACRM
+*/
+REAL blGetMaxProteinHBondDADistance(void)
+{
+   return((REAL)sqrt(sDADistSq));
+}
+
+
+/************************************************************************/
+/*>REAL blGetMaxProteinHBondHADistance(void)
+   -----------------------------------------
+*//**
+   \return             The maximum hydrogen-acceptor distance
+
+   Returns the maximum distance between hydrogen and acceptor. Where
+   explicit hydrogens are present, blValidHBond() accepts an H-bond on
+   this distance alone, so it may be found between residues with no
+   pair of atoms within the maximum donor-acceptor distance.
+
+-  17.10.26 Original   By: ACRM
+*/
+REAL blGetMaxProteinHBondHADistance(void)
+{
+   return((REAL)HADIST);
+}
+
+
 /************************************************************************/
 /*>HBLIST *blListAllHBonds(PDB *res1, PDB *res2)
    ----------------------------------------------
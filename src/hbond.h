@@ -3,8 +3,8 @@
 
    \file       hbond.h
    
-   \version    V1.4
-   \date       20.07.15
+   \version    V1.5
+   \date       17.10.26
    \brief      Header file for hbond determining code
    
    \copyright  (c) UCL / Dr. Andrew C. R. Martin 1996-2015
@@ -53,6 +53,8 @@
 -  V1.3  14.08.14 Moved deprecated function prototypes to deprecated.h 
                   By: CTP
 -  V1.4  20.07.15 Added blListAllHBonds()  By: ACRM
+-  V1.5  17.10.26 Added blGetMaxProteinHBondDADistance() and
+                  blGetMaxProteinHBondHADistance()
 
 *************************************************************************/
 #ifndef _hbond_h
@@ -91,6 +93,8 @@ BOOL blValidHBond(PDB *AtomH, PDB *AtomD, PDB *AtomA, PDB *AtomP);
 int blIsMCDonorHBonded(PDB *res1, PDB *res2, int type);
 int blIsMCAcceptorHBonded(PDB *res1, PDB *res2, int type);
 void blSetMaxProteinHBondDADistance(REAL dist);
+REAL blGetMaxProteinHBondDADistance(void);
+REAL blGetMaxProteinHBondHADistance(void);
 HBLIST *blListAllHBonds(PDB *p, PDB *q);
 
 /************************************************************************/
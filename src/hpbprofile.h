@@ -0,0 +1,110 @@
+/************************************************************************/
+/**
+
+   \file       hpbprofile.h
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Sliding-window hydrophobicity and hydrophobic moment
+               profiles
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+#ifndef _HPBPROFILE_H
+#define _HPBPROFILE_H
+
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include "SysDefs.h"
+#include "MathType.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define HPB_KYTEFILE      "kyte.hpb"     /* Kyte & Doolittle scale      */
+#define HPB_EISENBERGFILE "consensus.hpb" /* Eisenberg consensus scale  */
+#define HPB_MAXNAME       160    /* Max length of a scale description   */
+#define HPB_TMWINDOW      19     /* Window for transmembrane helices    */
+#define HPB_TMTHRESHOLD   ((REAL)1.6)   /* Kyte & Doolittle TM cutoff   */
+#define HPB_HELIXANGLE    ((REAL)100.0) /* Degrees per residue: helix   */
+#define HPB_STRANDANGLE   ((REAL)170.0) /* Degrees per residue: strand  */
+
+/* A hydrophobicity scale indexed by one-letter code                   */
+typedef struct
+{
+   REAL value[256];                  /* 0.0 for unknown codes           */
+   BOOL known[256];
+   char name[HPB_MAXNAME];           /* Description from the file       */
+}  HPBSCALE;
+
+/* A run of windows above the thresholds                               */
+typedef struct _hpbsegment
+{
+   struct _hpbsegment *next;
+   char *id;                         /* FASTA header or NULL            */
+   REAL maxMean,                     /* Best window mean hydrophobicity */
+        maxMoment;                   /* Best window hydrophobic moment  */
+   int  seqNum,                      /* Sequence number from 0          */
+        start,                       /* Offset of first residue from 0  */
+        stop;                        /* Offset of last residue          */
+}  HPBSEGMENT;
+
+/************************************************************************/
+/* Prototypes
+*/
+HPBSCALE *blReadHPBScale(char *filename);
+void blFreeHPBScale(HPBSCALE *scale);
+int blHPBProfile(HPBSCALE *scale, char *seq, int window, REAL angle,
+                 REAL *mean, REAL *moment);
+HPBSEGMENT *blFindHPBSegments(HPBSCALE *scale, char *seq, int window,
+                              REAL angle, REAL minMean, REAL minMoment,
+                              int *nsegs);
+HPBSEGMENT *blFindHPBSegmentsFASTA(HPBSCALE *scale, FILE *in,
+                                   int window, REAL angle,
+                                   REAL minMean, REAL minMoment,
+                                   int nthreads, int *nseqs);
+void blFreeHPBSegments(HPBSEGMENT *segs);
+void blPrintHPBSegments(FILE *out, HPBSEGMENT *segs);
+
+#endif
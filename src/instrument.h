@@ -0,0 +1,121 @@
+/************************************************************************/
+/**
+
+   \file       instrument.h
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Counters and timers for the main library operations
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+#ifndef _INSTRUMENT_H
+#define _INSTRUMENT_H
+
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include "SysDefs.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+/* Counters                                                             */
+#define BLCOUNT_LINES_PARSED     0  /* PDB file lines read              */
+#define BLCOUNT_ATOMS_ALLOCATED  1  /* Atoms stored by the PDB readers  */
+#define BLCOUNT_ATOMS_WRITTEN    2  /* Atoms written as PDB or PDBML    */
+#define BLCOUNT_PAIRS_TESTED     3  /* Neighbouring atom pairs tested   */
+#define BLCOUNT_ALIGNMENTS       4  /* Sequence alignments run          */
+#define BLCOUNT_DP_CELLS         5  /* Alignment matrix cells filled    */
+#define BLCOUNT_NUM              6
+
+/* Timers                                                               */
+#define BLTIMER_READPDB          0  /* Reading PDB and PDBML files      */
+#define BLTIMER_WRITEPDB         1  /* Writing PDB and PDBML files      */
+#define BLTIMER_CONECT           2  /* Building CONECTs / bond graphs   */
+#define BLTIMER_SECSTR           3  /* Secondary structure              */
+#define BLTIMER_ACCESS           4  /* Solvent accessibility            */
+#define BLTIMER_ALIGN            5  /* Sequence alignment               */
+#define BLTIMER_NUM              6
+
+/* Formats for blPrintInstrumentStats()                                 */
+#define INSTRUMENT_TEXT          0
+#define INSTRUMENT_JSON          1
+
+/* The library calls these macros in its hot paths. Unless it is
+   compiled with INSTRUMENT_SUPPORT, they do nothing
+*/
+#ifdef INSTRUMENT_SUPPORT
+#  define BLCOUNT(counter, n) blInstrumentCount((counter), (ULONG)(n))
+#  define BLTIMERSTART(timer) blInstrumentTimerStart(timer)
+#  define BLTIMERSTOP(timer)  blInstrumentTimerStop(timer)
+#else
+#  define BLCOUNT(counter, n)
+#  define BLTIMERSTART(timer)
+#  define BLTIMERSTOP(timer)
+#endif
+
+/* Totals for one thread or for all threads                             */
+typedef struct
+{
+   ULONG  counts[BLCOUNT_NUM],
+          calls[BLTIMER_NUM];     /* Number of timed calls              */
+   double seconds[BLTIMER_NUM];   /* Time spent in the timed calls      */
+   int    nthreads;               /* Number of threads included         */
+}  INSTRUMENTSTATS;
+
+/************************************************************************/
+/* Prototypes
+*/
+BOOL blInstrumentEnabled(void);
+void blInstrumentCount(int counter, ULONG n);
+void blInstrumentTimerStart(int timer);
+void blInstrumentTimerStop(int timer);
+void blGetInstrumentStats(INSTRUMENTSTATS *stats, BOOL thisThread);
+void blResetInstrumentStats(void);
+void blPrintInstrumentStats(FILE *fp, INSTRUMENTSTATS *stats,
+                            int format);
+char *blInstrumentCounterName(int counter);
+char *blInstrumentTimerName(int timer);
+
+#endif
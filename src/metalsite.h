@@ -0,0 +1,147 @@
+/************************************************************************/
+/**
+
+   \file       metalsite.h
+
+   \version    V1.1
+   \date       17.10.26
+   \brief      Search for metal-binding site geometries
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Added partner and resid to METALTEMPLATE   By: ACRM
+
+*************************************************************************/
+#ifndef _METALSITE_H
+#define _METALSITE_H
+
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define METALSITE_ZNFILE    "zn_sites.dat"    /* Zinc site templates    */
+#define METALSITE_CUFILE    "cu_sites.dat"    /* Copper site templates  */
+#define METALSITE_CAFILE    "ca_ef_sites.dat" /* Calcium site templates */
+#define METALSITE_MAXATOMS  4      /* Max atoms in a site template      */
+#define METALSITE_MAXNAMES  8      /* Max distinct template atom names  */
+#define METALSITE_MAXDESC   160    /* Max length of a description       */
+#define METALSITE_DEFDISTTOL ((REAL)0.5) /* Default distance tolerance  */
+#define METALSITE_DEFRMSD   ((REAL)0.3)  /* Default RMSD cutoff         */
+
+/* A site template: one atom from each of 3 or 4 residues. A site is
+   usually given by a C-alpha and a C-beta template of the same residues
+   which are partners of each other
+*/
+typedef struct
+{
+   COOR coor[METALSITE_MAXATOMS];     /* Centred on the origin          */
+   REAL dist[METALSITE_MAXATOMS][METALSITE_MAXATOMS];
+   int  natoms,
+        partner,                      /* Other template or -1           */
+        nameIndex[METALSITE_MAXATOMS]; /* Index into lib->atnams        */
+   char name[METALSITE_MAXDESC],      /* Description from the file      */
+        metal[8],                     /* Label given when read          */
+        atnam[METALSITE_MAXATOMS][8],
+        resnam[METALSITE_MAXATOMS][8],
+        resid[METALSITE_MAXATOMS][16]; /* Chain and residue number      */
+}  METALTEMPLATE;
+
+/* Templates indexed by the distance between their first two atoms     */
+typedef struct
+{
+   REAL dist;
+   int  template;
+}  METALEDGE;
+
+typedef struct
+{
+   METALTEMPLATE *templates;
+   METALEDGE     *edges;              /* Sorted by dist                 */
+   REAL          maxDist;             /* Longest template distance      */
+   int           ntemplates,
+                 natnams;
+   char          atnams[METALSITE_MAXNAMES][8];
+}  METALSITELIB;
+
+/* A match of a template to a set of residues                          */
+typedef struct _metalsitehit
+{
+   struct _metalsitehit *next;
+   PDB  *atoms[METALSITE_MAXATOMS];   /* NULL for file scans            */
+   REAL rmsd;
+   int  template,                     /* Index into METALSITELIB        */
+        natoms,
+        resnum[METALSITE_MAXATOMS];
+   char *filename,                    /* NULL for a PDB linked list     */
+        chain[METALSITE_MAXATOMS][blMAXCHAINLABEL],
+        insert[METALSITE_MAXATOMS][8],
+        resnam[METALSITE_MAXATOMS][8];
+}  METALSITEHIT;
+
+/************************************************************************/
+/* Prototypes
+*/
+METALSITELIB *blReadMetalSiteLib(METALSITELIB *lib, char *filename,
+                                 char *metal);
+METALSITELIB *blReadDefaultMetalSiteLib(void);
+void blFreeMetalSiteLib(METALSITELIB *lib);
+METALSITEHIT *blFindMetalSites(METALSITELIB *lib, PDB *pdb,
+                               REAL distTol, REAL rmsdTol,
+                               BOOL matchResnam, int *nhits);
+METALSITEHIT *blFindMetalSitesFiles(METALSITELIB *lib, char **files,
+                                    int nfiles, REAL distTol,
+                                    REAL rmsdTol, BOOL matchResnam,
+                                    int nthreads, int *nscanned);
+METALSITEHIT *blFindMetalSitesDir(METALSITELIB *lib, char *dirname,
+                                  REAL distTol, REAL rmsdTol,
+                                  BOOL matchResnam, int nthreads,
+                                  int *nscanned);
+void blFreeMetalSiteHits(METALSITEHIT *hits);
+void blPrintMetalSiteHits(FILE *out, METALSITELIB *lib,
+                          METALSITEHIT *hits);
+
+#endif
@@ -0,0 +1,153 @@
+/************************************************************************/
+/**
+
+   \file       nbenergy.h
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Non-bonded van der Waals and Coulomb energies
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+#ifndef _NBENERGY_H
+#define _NBENERGY_H
+
+/************************************************************************/
+/* Includes
+*/
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+#include "hash.h"
+#include "atomgrid.h"
+#include "pdbattrib.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define NBE_PARAMFILE   "eparams.dat"   /* Default parameter file       */
+#define NBE_CHARGEFILE  "kolluni.dat"   /* Default charge file          */
+#define NBE_DEFCUTOFF   ((REAL)8.0)     /* Default cutoff (A)           */
+#define NBE_MAXEXCL     8    /* Max exclusions for a topology atom      */
+
+/* An atom of a residue topology from the parameter file. Each name in
+   excl[] is an atom in the same residue, or in the next (+) or
+   previous (-) residue, whose non-bonded interaction with this atom is
+   excluded.
+*/
+typedef struct
+{
+   REAL charge;
+   int  type,                /* Index into NBPARAMS types[]             */
+        nexcl;
+   char resnam[8],
+        atnam[8],
+        excl[NBE_MAXEXCL][8];
+}  NBTOPATOM;
+
+/* Non-bonded parameters read from eparams.dat and (optionally) charges
+   from kolluni.dat
+*/
+typedef struct
+{
+   blATOMINFO *types;        /* NONBOND atom types                      */
+   NBTOPATOM  *top;          /* Residue topology atoms                  */
+   REAL       *charges;      /* Charges from the charge file            */
+   HASHTABLE  *topHash,      /* "RES:ATOM" to index in top[]            */
+              *chargeHash;   /* "RES:ATOM" to index in charges[]        */
+   int        ntypes,
+              ntop,
+              ncharges;
+}  NBPARAMS;
+
+/* Non-bonded energy of a PDB linked list. Per-atom energies are held
+   as columns of attribs; each atom is given half of each pair energy.
+*/
+typedef struct
+{
+   REAL       cutoff,        /* Non-bonded cutoff                       */
+              dielectric,    /* Dielectric constant                     */
+              evdw,          /* Total van der Waals energy              */
+              ecoul,         /* Total Coulomb energy                    */
+              *A,            /* Attractive (r^-6) coefficients by type  */
+              *B,            /* Repulsive (r^-12) coefficients by type  */
+              *charge,       /* Charge on each atom                     */
+              *x, *y, *z,    /* Coordinates at the last evaluation      */
+              *resVdw,       /* Van der Waals energy of each residue    */
+              *resCoul;      /* Coulomb energy of each residue          */
+   ATOMGRID   *grid;         /* Grid of x,y,z                           */
+   PDBATTRIBS *attribs;      /* Atoms and per-atom energies             */
+   int        *type,         /* Atom type of each atom (-1 if none)     */
+              *residue,      /* Residue of each atom                    */
+              *resFirst,     /* First atom of each residue              */
+              *exclStart,    /* Exclusions of atom i are excl[k] for
+                                exclStart[i] <= k < exclStart[i+1]      */
+              *excl,
+              *neighbs,      /* Workspace for grid searches             */
+              natoms,
+              nres,
+              ntypes,
+              maxNeighbs,
+              vdwCol,        /* Column of attribs for van der Waals     */
+              coulCol;       /* Column of attribs for Coulomb           */
+   char       *moved;        /* Workspace flags for updates             */
+   BOOL       distDielectric; /* Use a distance-dependent dielectric    */
+}  NBENERGY;
+
+/************************************************************************/
+/* Prototypes
+*/
+NBPARAMS *blReadNBParams(char *paramFile);
+BOOL blReadNBCharges(NBPARAMS *params, char *chargeFile);
+void blFreeNBParams(NBPARAMS *params);
+
+NBENERGY *blCreateNBEnergy(PDB *pdb, NBPARAMS *params, REAL cutoff,
+                           REAL dielectric, BOOL distDielectric);
+void blFreeNBEnergy(NBENERGY *nbe);
+BOOL blCalcNBEnergy(NBENERGY *nbe);
+BOOL blUpdateNBEnergy(NBENERGY *nbe, PDB **moved, int nmoved);
+BOOL blUpdateNBEnergyRange(NBENERGY *nbe, PDB *start, PDB *stop);
+REAL blGetNBEnergyAtom(NBENERGY *nbe, PDB *p, REAL *evdw, REAL *ecoul);
+REAL blGetNBEnergyResidue(NBENERGY *nbe, PDB *p, REAL *evdw,
+                          REAL *ecoul);
+
+#endif
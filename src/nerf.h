@@ -0,0 +1,116 @@
+/************************************************************************/
+/**
+
+   \file       nerf.h
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Build chains from internal coordinates by NeRF
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+#ifndef _NERF_H
+#define _NERF_H
+
+/************************************************************************/
+/* Includes
+*/
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define NERF_REFCOORDS "coor"  /* Default reference coordinates file    */
+
+/* Torsions (degrees of freedom) of each residue                        */
+#define NERF_PHI     0
+#define NERF_PSI     1
+#define NERF_OMEGA   2
+#define NERF_CHI1    3
+#define NERF_MAXCHI  5
+#define NERF_NDOF    (NERF_CHI1 + NERF_MAXCHI)
+
+/* Access to torsion dof of residue res                                 */
+#define NERFDOF(chain, res, dof) ((chain)->dofs[(res)*NERF_NDOF + (dof)])
+
+/* A chain in internal coordinates. Atom i is placed bonded to atom
+   ref[3*i+2], with the bond angle to ref[3*i+1] and the torsion to
+   ref[3*i]. Its torsion is torsion[i] plus dofs[dof[i]] if dof[i] is
+   not -1. The first 3 atoms have no reference atoms.
+*/
+typedef struct
+{
+   REAL *x, *y, *z,          /* Cartesian coordinates                   */
+        *bond,               /* Bond length                             */
+        *angle,              /* Bond angle                              */
+        *torsion,            /* Fixed torsion or offset from its dof    */
+        *cosAngle, *sinAngle,
+        *cosTor,   *sinTor,
+        *dofs,               /* NERF_NDOF torsions for each residue     */
+        *cosDof,   *sinDof,  /* Workspace for building                  */
+        *lastDof;            /* dofs[] when cosDof/sinDof were set      */
+   int  *ref,                /* 3 reference atoms for each atom         */
+        *dof,                /* Index into dofs[] or -1                 */
+        *dofAtom,            /* Atom whose torsion gives each dof or -1 */
+        *resFirst,           /* First atom of each residue (nres+1)     */
+        natoms,
+        nres;
+   char (*atnam)[8],         /* Atom names padded to 4 characters       */
+        (*resnam)[8];        /* Name of each residue                    */
+   BOOL anchored;            /* Keep the coordinates of the first 3
+                                atoms when building                     */
+}  NERFCHAIN;
+
+/************************************************************************/
+/* Prototypes
+*/
+NERFCHAIN *blCreateNeRFChain(char *sequence, char *refCoords);
+NERFCHAIN *blCreateNeRFChainPDB(PDB *pdb, char *refCoords);
+void blFreeNeRFChain(NERFCHAIN *chain);
+void blBuildNeRFChain(NERFCHAIN *chain, int firstRes);
+void blExtractNeRFTorsions(NERFCHAIN *chain);
+BOOL blSetNeRFChainFromPDB(NERFCHAIN *chain, PDB *pdb);
+PDB *blNeRFChainToPDB(NERFCHAIN *chain, char *chainLabel);
+
+#endif
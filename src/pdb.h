@@ -3,12 +3,12 @@
 
    \file       pdb.h
    
-   \version    V1.98
-   \date       17.11.21
+   \version    V1.109
+   \date       17.10.26
 
    \brief      Include file for PDB routines
    
-   \copyright  (c) UCL / Prof. Andrew C. R. Martin, UCL, Reading 1993-2021
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin, UCL, Reading 1993-2026
    \author     Prof. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -225,6 +225,28 @@
                   blForceExtractNotZoneSpecPDBAsCopy()
 -  V1.98 17.11.21 Added blFixSequence(), blRenumResiduesPDB(), 
                   blCreateSEQRES(), blReplacePDBHeader()
+-  V1.99 17.10.26 Added PDBREADFILTER, blDoReadPDBFiltered(), 
+                  blReadPDBFiltered() and blInitPDBReadFilter()
+-  V1.100 17.10.26 Added PDBHEADERINFO, blReadPDBHeader(), 
+                  blScanPDBHeader(), blGetHeaderInfoWholePDB() and
+                  blFreePDBHeaderInfo()
+-  V1.101 17.10.26 Added blDoReadPDBParallel() and blReadPDBParallel()
+-  V1.102 17.10.26 Added blDoReadPDBFile(), blDoReadPDBBuffer() and 
+                   blReadPDBFile()
+-  V1.103 17.10.26 Added blDecodeHybrid36(), blEncodeHybrid36(),
+                   PDBATOMNUMINDEX, blCreateAtomNumberIndex(),
+                   blFindAtomNumber() and blFreeAtomNumberIndex()
+-  V1.104 17.10.26 Added ATOMNAMEPATTERN, blCompileAtomNamePattern(),
+                   blMatchAtomNamePattern(), blMatchAtomNamePatternPDB()
+                   and blFindAtomNamePattern()
+-  V1.105 17.10.26 Added blDeleteAtomsPDB(), blDeleteAtomsAfterPDB() and
+                   blDeleteFlaggedAtomsPDB()
+-  V1.106 17.10.26 Referred to PDBATTRIBS in the extras documentation
+-  V1.107 17.10.26 Added COVALENTLINK, blFindDisulphidesPDB(),
+                   blFindCovalentLinksPDB(), blSetLinkRecordsWholePDB()
+                   and blCovalentRadius()
+-  V1.108 17.10.26 Documented that the reader flags are not thread-safe
+-  V1.109 17.10.26 Added bonds to WHOLEPDB
 
 
 *************************************************************************/
@@ -289,6 +311,10 @@ typedef struct _blAtomInfo
       ((EXTRAS *)p->extras)->flag = FALSE;
       ((EXTRAS *)p->extras)->angle = (REAL)0.0;
    }
+
+   For numeric or string data on large structures, the PDBATTRIBS
+   attribute columns in pdbattrib.h avoid one allocation per atom and
+   may be written to PDBML files.
 */
 
 /* We recommend a dimension of 8 for all the character arrays below for
@@ -374,14 +400,29 @@ typedef struct sec_entry
    char type;
 }  SECSTRUC;
 
+struct _bondgraph;
+
 typedef struct _wholepdb
 {
    PDB        *pdb;
    STRINGLIST *header;
    STRINGLIST *trailer;
+   struct _bondgraph *bonds;   /* CONECTs as a BONDGRAPH (bondgraph.h)  */
    int        natoms;
 }  WHOLEPDB;
 
+/* Controls which coordinate records blDoReadPDBFiltered() reads      */
+typedef struct
+{
+   char **chains,            /* Chain labels to read (NULL for all)     */
+        **atnams;            /* Atom names to read (NULL for all)       */
+   int  nchains,             /* Number of items in chains[]             */
+        natnams,             /* Number of items in atnams[]             */
+        modelNum;            /* Model to read (0 = all)                 */
+   BOOL atoms,               /* Read ATOM records                       */
+        hetatms;             /* Read HETATM records                     */
+}  PDBREADFILTER;
+
 typedef struct _compnd
 {
    int   molid;
@@ -452,6 +493,41 @@ typedef struct _disulphide
                       insert2[8];
 }  DISULPHIDE;
 
+/* A covalent link between residues found by blFindCovalentLinksPDB()   */
+typedef struct _covalentlink
+{
+   struct _covalentlink *next;
+   PDB                  *atom1,
+                        *atom2;
+   REAL                 distance;
+}  COVALENTLINK;
+
+/* Commonly needed header data, collected by blScanPDBHeader()         */
+typedef struct
+{
+   WHOLEPDB   *wpdb;         /* Header records from blScanPDBHeader()   */
+   SECSTRUC   *secstr;       /* HELIX/SHEET/TURN records                */
+   DISULPHIDE *disulphides;  /* SSBOND records                          */
+   char       **seqres;      /* SEQRES sequence for each chain          */
+   REAL       resolution,
+              RFactor,
+              FreeR,
+              origMatrix[3][4],
+              scaleMatrix[3][4];
+   VEC3F      unitCell,
+              cellAngles;    /* In radians                              */
+   int        strucType,     /* STRUCTURE_TYPE_XXXX                     */
+              crystFlags,    /* Return from blGetCrystWholePDB()        */
+              nSeqresChains,
+              nSecstr;
+   BOOL       gotExptl,      /* Resolution or structure type found      */
+              gotHeader;     /* HEADER record found                     */
+   char       spacegroup[16],
+              header[48],    /* Classification from HEADER              */
+              date[16],
+              pdbcode[8];
+}  PDBHEADERINFO;
+
 typedef struct
 {
    int   Total,      /* Total hydrogens                                 */
@@ -462,6 +538,39 @@ typedef struct
          T5;         /* Type 5 O-H's =N-H's                             */
 }  HADDINFO;
 
+/* Lookup of atoms by atom number from blCreateAtomNumberIndex(). When
+   the atom numbers are reasonably dense, dense[] is indexed by
+   (atnum - minAtnum); otherwise sorted[] is searched with a binary
+   search so memory stays proportional to the number of atoms
+*/
+typedef struct
+{
+   PDB *atom;
+   int atnum,
+       order;                /* Position in the linked list             */
+}  PDBATOMNUMENTRY;
+
+typedef struct
+{
+   PDB             **dense;  /* Direct lookup or NULL                   */
+   PDBATOMNUMENTRY *sorted;  /* Sorted by atnum then order, or NULL     */
+   int             natoms,
+                   minAtnum,
+                   maxAtnum;
+}  PDBATOMNUMINDEX;
+
+/* An atom name specification compiled by blCompileAtomNamePattern().
+   A name matches if ((name[i] ^ value[i]) & mask[i]) is zero for all i
+*/
+#define ATOMNAMEPATTERN_SIZE 8
+typedef struct
+{
+   UBYTE mask[ATOMNAMEPATTERN_SIZE],
+         value[ATOMNAMEPATTERN_SIZE];
+   int   nbytes;             /* Bytes with a non-zero mask              */
+   BOOL  raw;                /* Test atnam_raw rather than atnam        */
+}  ATOMNAMEPATTERN;
+
 #define CLEAR_PDB(p) strcpy(p->record_type,"      ");    \
                      p->atnum=0;                         \
                      strcpy(p->atnam,"    ");            \
@@ -620,6 +729,10 @@ typedef struct
    extern char gRSCError[80];
 #endif
 
+/* Set by the PDB readers. These are shared by all threads and set 
+   without locking, so are not meaningful if several threads read at
+   once
+*/
 #ifdef READPDB_MAIN
    BOOL gPDBPartialOcc    = FALSE;
    int  gPDBMultiNMR      = 0;
@@ -649,6 +762,19 @@ PDB *blReadPDBOccRank(FILE *fp, int *natom, int OccRank);
 PDB *blReadPDBAtomsOccRank(FILE *fp, int *natom, int OccRank);
 WHOLEPDB *blDoReadPDB(FILE *fp, BOOL AllAtoms, int OccRank, 
                       int ModelNum, BOOL DoWhole);
+WHOLEPDB *blDoReadPDBFiltered(FILE *fp, int OccRank, BOOL DoWhole,
+                              PDBREADFILTER *filter);
+PDB *blReadPDBFiltered(FILE *fp, int *natom, PDBREADFILTER *filter);
+void blInitPDBReadFilter(PDBREADFILTER *filter);
+WHOLEPDB *blDoReadPDBParallel(FILE *fp, int OccRank, BOOL DoWhole,
+                              PDBREADFILTER *filter, int nThreads);
+PDB *blReadPDBParallel(FILE *fp, int *natom, int nThreads);
+WHOLEPDB *blDoReadPDBFile(char *filename, int OccRank, BOOL DoWhole,
+                          PDBREADFILTER *filter, int nThreads);
+WHOLEPDB *blDoReadPDBBuffer(char *buffer, long length, int OccRank,
+                            BOOL DoWhole, PDBREADFILTER *filter, 
+                            int nThreads);
+PDB *blReadPDBFile(char *filename, int *natom);
 WHOLEPDB *blDoReadPDBML(FILE *fp, BOOL AllAtoms, int OccRank, 
                         int ModelNum, BOOL DoWhole);
 BOOL blCheckFileFormatPDBML(FILE *fp);
@@ -674,8 +800,14 @@ void blDeleteAtomConects(PDB *pdb);
 BOOL blCopyConects(PDB *out, PDB *in);
 BOOL blIsConected(PDB *p, PDB *q);
 BOOL blIsBonded(PDB *p, PDB *q, REAL tol);
+REAL blCovalentRadius(char *element);
 PDB *blDeleteAtomPDB(PDB *pdb, PDB *atom);
 PDB *blDeleteAtomRangePDB(PDB *pdb, PDB *start, PDB *stop);
+PDB *blDeleteAtomsPDB(PDB *pdb, BOOL (*DeleteAtom)(PDB *, APTR), 
+                      APTR data, int *ndeleted);
+int  blDeleteAtomsAfterPDB(PDB *prev, PDB *stop, 
+                           BOOL (*DeleteAtom)(PDB *, APTR), APTR data);
+PDB *blDeleteFlaggedAtomsPDB(PDB *pdb, BOOL *flags, int *ndeleted);
 BOOL blAreResiduesBonded(PDB *pdb, 
                          char *chain1, int resnum1, char *insert1,
                          char *chain2, int resnum2, char *insert2,
@@ -739,8 +871,20 @@ BOOL blGetExptlOld(FILE *fp, REAL *resolution, REAL *RFactor, REAL *FreeR,
 char *blReportStructureType(int type);
 PDB **blIndexPDB(PDB *pdb, int *natom);
 PDB **blIndexAtomNumbersPDB(PDB *pdb, int *indexSize);
+PDBATOMNUMINDEX *blCreateAtomNumberIndex(PDB *pdb);
+PDB *blFindAtomNumber(PDBATOMNUMINDEX *index, int atnum);
+void blFreeAtomNumberIndex(PDBATOMNUMINDEX *index);
+BOOL blDecodeHybrid36(char *field, int width, int *value);
+BOOL blEncodeHybrid36(int value, int width, char *field);
 DISULPHIDE *blReadDisulphidesPDB(FILE *fp, BOOL *error);
 DISULPHIDE *blReadDisulphidesWholePDB(WHOLEPDB *wpdb, BOOL *error);
+DISULPHIDE *blFindDisulphidesPDB(PDB *pdb, REAL tol, BOOL *error);
+COVALENTLINK *blFindCovalentLinksPDB(PDB *pdb, REAL tol,
+                                     DISULPHIDE **disulphides,
+                                     BOOL *error);
+BOOL blSetLinkRecordsWholePDB(WHOLEPDB *wpdb,
+                              DISULPHIDE *disulphides,
+                              COVALENTLINK *links);
 BOOL blParseResSpec(char *spec, char *chain, int *resnum, char *insert);
 void blPrintResSpecHelp(FILE *fp);
 void blBuildResSpec(PDB *p, char *resspec);
@@ -795,6 +939,12 @@ BOOL blInPDBZone(PDB *p, char *chain, int resnum1, char *insert1,
 BOOL blInPDBZoneSpec(PDB *p, char *resspec1, char *resspec2);
 BOOL blAtomNameMatch(char *atnam, char *spec, BOOL *ErrorWarn);
 BOOL blAtomNameRawMatch(char *atnam, char *spec, BOOL *ErrorWarn);
+BOOL blCompileAtomNamePattern(char *spec, BOOL raw, 
+                              ATOMNAMEPATTERN *pattern);
+BOOL blMatchAtomNamePattern(char *atnam, ATOMNAMEPATTERN *pattern);
+BOOL blMatchAtomNamePatternPDB(PDB *p, ATOMNAMEPATTERN *pattern);
+PDB *blFindAtomNamePattern(PDB *start, PDB *stop, 
+                           ATOMNAMEPATTERN *pattern);
 BOOL blLegalAtomSpec(char *spec);
 BOOL blRepOneSChain(PDB *pdb, char *ResSpec, char aa, char *ChiTable,
                     char *RefCoords);
@@ -807,6 +957,10 @@ PDB *blSelectCaPDB(PDB *pdb);
 char *blFixAtomName(char *name, REAL occup);
 
 void blFreeWholePDB(WHOLEPDB *wpdb);
+WHOLEPDB *blReadPDBHeader(FILE *fpin);
+PDBHEADERINFO *blScanPDBHeader(FILE *fp);
+PDBHEADERINFO *blGetHeaderInfoWholePDB(WHOLEPDB *wpdb);
+void blFreePDBHeaderInfo(PDBHEADERINFO *info);
 WHOLEPDB *blReadWholePDB(FILE *fpin);
 WHOLEPDB *blReadWholePDBAtoms(FILE *fpin);
 BOOL blAddCBtoGly(PDB *pdb);
@@ -0,0 +1,127 @@
+/************************************************************************/
+/**
+
+   \file       pdbattrib.h
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Typed per-atom attribute columns for a PDB linked list
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+#ifndef _PDBATTRIB_H
+#define _PDBATTRIB_H
+
+/************************************************************************/
+/* Includes
+*/
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define MAXPDBATTRIBNAME 64  /* Max length of an attribute name         */
+
+/* Attribute types. These have the same values as PDBTAGVAR_XXXX       */
+#define PDBATTRIB_REAL   0
+#define PDBATTRIB_INT    1
+#define PDBATTRIB_STRING 2
+
+/* A single named column with one value per atom                       */
+typedef struct
+{
+   REAL *reals;              /* Values if type is PDBATTRIB_REAL        */
+   int  *ints;               /* Values if type is PDBATTRIB_INT         */
+   char *strings;            /* Values if type is PDBATTRIB_STRING,
+                                each occupying width+1 characters       */
+   int  type,                /* PDBATTRIB_XXXX                          */
+        width;               /* Maximum string length                   */
+   char name[MAXPDBATTRIBNAME];
+}  PDBATTRIBCOL;
+
+/* Maps an atom pointer to its ordinal                                  */
+typedef struct
+{
+   PDB *p;
+   int ordinal;
+}  PDBATTRIBMAP;
+
+/* A set of attribute columns for the atoms of a PDB linked list. The
+   atoms are numbered by their position in the list when the table was
+   created.
+*/
+typedef struct
+{
+   PDB          **atoms;     /* Atoms in ordinal order                  */
+   PDBATTRIBMAP *map;        /* Atoms sorted by address                 */
+   PDBATTRIBCOL *cols;       /* The attribute columns                   */
+   int          natoms,
+                ncols,
+                maxcols;     /* Allocated size of cols[]                */
+}  PDBATTRIBS;
+
+/* Direct access to the value for the atom with ordinal i in column c  */
+#define PDBATTRIB_REALVAL(a, c, i)   ((a)->cols[(c)].reals[(i)])
+#define PDBATTRIB_INTVAL(a, c, i)    ((a)->cols[(c)].ints[(i)])
+#define PDBATTRIB_STRINGVAL(a, c, i) ((a)->cols[(c)].strings +           \
+                                      (i) * ((a)->cols[(c)].width + 1))
+
+/************************************************************************/
+/* Prototypes
+*/
+PDBATTRIBS *blCreatePDBAttribs(PDB *pdb);
+void blFreePDBAttribs(PDBATTRIBS *attribs);
+int  blAddPDBAttrib(PDBATTRIBS *attribs, char *name, int type, int width);
+int  blFindPDBAttrib(PDBATTRIBS *attribs, char *name);
+int  blGetPDBAttribOrdinal(PDBATTRIBS *attribs, PDB *p);
+
+BOOL blSetPDBAttribReal(PDBATTRIBS *attribs, int col, PDB *p, REAL value);
+BOOL blSetPDBAttribInt(PDBATTRIBS *attribs, int col, PDB *p, int value);
+BOOL blSetPDBAttribString(PDBATTRIBS *attribs, int col, PDB *p,
+                          char *value);
+REAL blGetPDBAttribReal(PDBATTRIBS *attribs, int col, PDB *p);
+int  blGetPDBAttribInt(PDBATTRIBS *attribs, int col, PDB *p);
+char *blGetPDBAttribString(PDBATTRIBS *attribs, int col, PDB *p);
+
+#endif
@@ -0,0 +1,142 @@
+/************************************************************************/
+/**
+
+   \file       pdbcompact.h
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Compact array representation of PDB atoms
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+#ifndef _PDBCOMPACT_H
+#define _PDBCOMPACT_H
+
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include <string.h>
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+#include "hash.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+
+/* A compact atom. Coordinates are single precision and the name fields
+   are packed: they are null-padded but not null-terminated if they fill
+   the field. Use PDBC_UNPACK() to get a terminated copy. Chain labels
+   and record types are held once in the PDBCOMPACT string table.
+*/
+typedef struct
+{
+   float          x, y, z,
+                  occ,
+                  bval;
+   int            atnum,
+                  resnum;
+   unsigned short chain,        /* Index into PDBCOMPACT strings        */
+                  record_type;  /* Index into PDBCOMPACT strings        */
+   char           atnam[4],
+                  atnam_raw[4],
+                  resnam[4],
+                  segid[4],
+                  element[2],
+                  insert,
+                  altpos,
+                  secstr;
+   signed char    formal_charge;
+}  PDBATOMC;
+
+/* An array of compact atoms in the order of the original linked list.
+   CONECT data are held in compressed sparse row form: the atoms bonded
+   to atom i are conect[conectStart[i]] ... conect[conectStart[i+1]-1]
+   (as indexes into atoms[]). conectStart is NULL if there are no 
+   CONECTs.
+*/
+typedef struct
+{
+   PDBATOMC *atoms;
+   char     **strings;       /* Interned chain labels and record types  */
+   int      *conectStart,
+            *conect,
+            natoms,
+            nstrings;
+}  PDBCOMPACT;
+
+/* Copy a packed name field into a null-terminated string              */
+#define PDBC_UNPACK(dest, src)                                           \
+   do {                                                                  \
+      memcpy((dest), (src), sizeof(src));                                \
+      (dest)[sizeof(src)] = '\0';                                        \
+   }  while(0)
+
+#define PDBC_CHAIN(c, i)       ((c)->strings[(c)->atoms[(i)].chain])
+#define PDBC_RECORDTYPE(c, i)  ((c)->strings[(c)->atoms[(i)].record_type])
+#define PDBC_NCONECT(c, i)                                               \
+   (((c)->conectStart == NULL) ? 0 :                                     \
+    ((c)->conectStart[(i)+1] - (c)->conectStart[(i)]))
+
+/************************************************************************/
+/* Prototypes
+*/
+PDBCOMPACT *blPDBToCompact(PDB *pdb);
+PDB *blCompactToPDB(PDBCOMPACT *cpdb);
+PDBCOMPACT *blReadPDBCompact(FILE *fp, int *natom);
+void blFreePDBCompact(PDBCOMPACT *cpdb);
+ULONG blPDBCompactMemory(PDBCOMPACT *cpdb);
+ULONG blPDBMemory(PDB *pdb);
+
+void blGetCofGPDBCompact(PDBCOMPACT *cpdb, VEC3F *cg);
+void blTranslatePDBCompact(PDBCOMPACT *cpdb, VEC3F tvect);
+void blApplyMatrixPDBCompact(PDBCOMPACT *cpdb, REAL matrix[3][3]);
+REAL blCalcRMSPDBCompact(PDBCOMPACT *cpdb1, PDBCOMPACT *cpdb2);
+BOOL blFitPDBCompact(PDBCOMPACT *ref, PDBCOMPACT *fit, REAL rm[3][3]);
+char *blDoPDB2SeqCompact(PDBCOMPACT *cpdb, BOOL DoAsxGlx, BOOL ProtOnly, 
+                         BOOL NoX);
+HASHTABLE *blDoPDB2SeqByChainCompact(PDBCOMPACT *cpdb, BOOL DoAsxGlx, 
+                                     BOOL ProtOnly, BOOL NoX);
+
+#endif
@@ -2,14 +2,14 @@
 /**
 
    \file       pdbtagvars.h
-   
-   \version    V0.3
-   \date       28.08.14
-   \brief      Header file for associating XML tags with additional 
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Header file for associating XML tags with additional
                variables in the PDB structure
-   
-   \copyright  (c) UCL / Dr. Andrew C. R. Martin 1988-2014
-   \author     Dr. Andrew C. R. Martin
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 1988-2026
+   \author     Prof. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
                University College London,
@@ -19,7 +19,7 @@
    \par
                andrew@bioinf.org.uk
                andrew.martin@ucl.ac.uk
-               
+
 **************************************************************************
 
    This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
@@ -29,7 +29,7 @@
    The code may be modified as required, but any modifications must be
    documented so that the person responsible can be identified.
 
-   The code may not be sold commercially or included as part of a 
+   The code may not be sold commercially or included as part of a
    commercial product except as described in the file COPYING.DOC.
 
 **************************************************************************
@@ -50,74 +50,71 @@
 -  V0.1  06.08.14 Preliminary code
 -  V0.2  25.08.14 Added blAddTagVariablesNodes() By: CTP
 -  V0.3  28.08.14 Added blAddTagVariablesColumns() By: CTP
+-  V1.0  17.10.26 Moved into the library from the pdbtagvars prototype.
+                  Added attribs and column to PDBTAGVAR,
+                  blAddPDBTagFunction(), blAddPDBAttribTag() and
+                  blClearPDBTagVars(). INIT_PDBTAGVAR() now calls
+                  blAddPDBTagFunction()   By: ACRM
 
 *************************************************************************/
+#ifndef _PDBTAGVARS_H
+#define _PDBTAGVARS_H
+
+/************************************************************************/
 /* Includes
 */
+#ifdef XML_SUPPORT
 #include <libxml/tree.h>
+#endif
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+#include "pdbattrib.h"
 
+/************************************************************************/
 /* Defines and macros
 */
 #define MAXTAGNAME 360  /* Maximum length of an XML tag name            */
 #define MAXTAGDATA 360  /* Maximum length of an XML tag data string     */
 
-typedef struct 
+/* A tag is bound either to a function or to a column of an attribute
+   table
+*/
+typedef struct
 {
    REAL (*realFunction)(PDB *);
    int (*intFunction)(PDB *);
    char *(*stringFunction)(PDB *);
+   PDBATTRIBS *attribs;      /* Attribute table (NULL for functions)    */
+   int  column;              /* Column in attribs                       */
    char tag[MAXTAGNAME];
    int  type;
 }  PDBTAGVAR;
 
-#define PDBTAGVAR_REAL   0
-#define PDBTAGVAR_INT    1
-#define PDBTAGVAR_STRING 2
+#define PDBTAGVAR_REAL   PDBATTRIB_REAL
+#define PDBTAGVAR_INT    PDBATTRIB_INT
+#define PDBTAGVAR_STRING PDBATTRIB_STRING
 
 /************************************************************************/
 /* Macro to initialize the binding between a tag name and a function that
    can extract a variable from a PDB structure. The function takes a PDB
    pointer (PDB *) as input and returns REAL, int or (char *) as specified
    by the type (PDBTAGVAR_REAL, PDBTAGVAR_INT or PDBTAGVAR_STRING). The
-   taglabel is a string specifying an XML tag that should be associated 
+   taglabel is a string specifying an XML tag that should be associated
    with the value
 
    Called as:
    INIT_PDBTAGVAR(&myFunction, type, taglabel)
 
    06.08.14  Original   By: ACRM
+   17.10.26  Now calls blAddPDBTagFunction()   By: ACRM
 */
-#define INIT_PDBTAGVAR(f, t, l)                                                  \
-do {                                                                             \
-   if(gPDBTagFunctions == NULL)                                                  \
-   {                                                                             \
-      gPDBTagFunctions=(PDBTAGVAR *)malloc(sizeof(PDBTAGVAR));                   \
-   }                                                                             \
-   else                                                                          \
-   {                                                                             \
-      gPDBTagFunctions=(PDBTAGVAR *)realloc(gPDBTagFunctions,                    \
-                    (1+gNPDBTagFunctions)*sizeof(PDBTAGVAR));                    \
-   }                                                                             \
-   if(gPDBTagFunctions==NULL) break;                                             \
-   strncpy(gPDBTagFunctions[gNPDBTagFunctions].tag, l, MAXTAGNAME);              \
-   gPDBTagFunctions[gNPDBTagFunctions].realFunction = NULL;                      \
-   gPDBTagFunctions[gNPDBTagFunctions].intFunction = NULL;                       \
-   gPDBTagFunctions[gNPDBTagFunctions].stringFunction = NULL;                    \
-   switch(t)                                                                     \
-   {                                                                             \
-   case PDBTAGVAR_REAL:                                                          \
-      gPDBTagFunctions[gNPDBTagFunctions].realFunction = (REAL (*)(PDB *))f;     \
-      break;                                                                     \
-   case PDBTAGVAR_INT:                                                           \
-      gPDBTagFunctions[gNPDBTagFunctions].intFunction = (int (*)(PDB *))f;       \
-      break;                                                                     \
-   case PDBTAGVAR_STRING:                                                        \
-      gPDBTagFunctions[gNPDBTagFunctions].stringFunction = (char * (*)(PDB *))f; \
-      break;                                                                     \
-   }                                                                             \
-   gPDBTagFunctions[gNPDBTagFunctions].type = t;                                 \
-   gNPDBTagFunctions++;                                                          \
-} while(0)
+#define INIT_PDBTAGVAR(f, t, l)                                          \
+   blAddPDBTagFunction(                                                  \
+      ((t)==PDBTAGVAR_REAL)   ? (REAL (*)(PDB *))(f)   : NULL,           \
+      ((t)==PDBTAGVAR_INT)    ? (int (*)(PDB *))(f)    : NULL,           \
+      ((t)==PDBTAGVAR_STRING) ? (char *(*)(PDB *))(f)  : NULL,           \
+      (t), (l))
 
 
 /************************************************************************/
@@ -135,9 +132,20 @@ extern int       gNPDBTagFunctions;
 /************************************************************************/
 /* Prototypes
 */
+BOOL blAddPDBTagFunction(REAL (*realFunction)(PDB *),
+                         int (*intFunction)(PDB *),
+                         char *(*stringFunction)(PDB *),
+                         int type, char *tag);
+BOOL blAddPDBAttribTag(PDBATTRIBS *attribs, int column, char *tag);
+void blClearPDBTagVars(void);
+REAL blXMLGetPDBAccess(PDB *p);
 void blPDBAddXMLAccessTag(void);
 void blPrintTagVariables(PDB *p);
 void blPrintAllTagVariables(PDB *pdb);
 
-void blAddTagVariablesNodes(PDB *pdb, xmlNodePtr atom_node);
+#ifdef XML_SUPPORT
+BOOL blAddTagVariablesNodes(PDB *pdb, xmlNodePtr atom_node);
+#endif
 char *blAddTagVariablesCols(PDB *pdb);
+
+#endif
@@ -0,0 +1,126 @@
+/************************************************************************/
+/**
+
+   \file       pdbview.h
+
+   \version    V1.1
+   \date       17.10.26
+   \brief      Zero-copy views onto a PDB linked list
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Added blCheckPDBView()
+
+*************************************************************************/
+#ifndef _PDBVIEW_H
+#define _PDBVIEW_H
+
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+#include "hash.h"
+#include "atomsel.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+
+/* A view is a subset of the atoms of a PDB linked list. The atoms are
+   referenced, not copied, and are kept in linked list order. A view
+   with atoms==NULL covers the whole linked list starting at pdb.
+*/
+typedef struct
+{
+   PDB  *pdb,                /* The underlying linked list              */
+        **atoms;             /* Selected atoms (NULL for whole list)    */
+   int  natoms;              /* Number of atoms in the view             */
+}  PDBVIEW;
+
+/* Step through the atoms of a view:
+      for(p=PDBVIEW_FIRST(view, i); p!=NULL; p=PDBVIEW_NEXT(view, p, i))
+   where the int i is the position of p within the view
+*/
+#define PDBVIEW_FIRST(v, i)                                               \
+   ((i)=0,                                                                \
+    (((v)->atoms==NULL) ? (v)->pdb :                                      \
+     (((v)->natoms > 0) ? (v)->atoms[0] : (PDB *)NULL)))
+#define PDBVIEW_NEXT(v, p, i)                                             \
+   (++(i),                                                                \
+    (((v)->atoms==NULL) ? (p)->next :                                     \
+     (((i) < (v)->natoms) ? (v)->atoms[(i)] : (PDB *)NULL)))
+
+/************************************************************************/
+/* Prototypes
+*/
+void blInitPDBView(PDBVIEW *view, PDB *pdb);
+PDBVIEW *blCreatePDBView(PDB *pdb, ATOMMASK *mask);
+PDBVIEW *blCreatePDBViewExpression(PDB *pdb, char *expression);
+void blFreePDBView(PDBVIEW *view);
+BOOL blCheckPDBView(PDBVIEW *view);
+PDB *blPDBViewAsCopy(PDBVIEW *view);
+
+PDBVIEW *blStripHPDBView(PDB *pdb);
+PDBVIEW *blStripWatersPDBView(PDB *pdb);
+PDBVIEW *blSelectAtomsPDBView(PDB *pdb, int nsel, char **sel);
+PDBVIEW *blSelectCaPDBView(PDB *pdb);
+PDBVIEW *blGetPDBChainView(PDB *pdb, char *chain);
+PDBVIEW *blExtractZonePDBView(PDB *pdb,
+                              char *chain1, int resnum1, char *insert1,
+                              char *chain2, int resnum2, char *insert2);
+PDBVIEW *blExtractNotZonePDBView(PDB *pdb,
+                                 char *chain1, int resnum1, char *insert1,
+                                 char *chain2, int resnum2, char *insert2);
+
+void blGetCofGPDBView(PDBVIEW *view, VEC3F *cg);
+REAL blCalcRMSPDBView(PDBVIEW *view1, PDBVIEW *view2);
+BOOL blFitPDBView(PDBVIEW *refView, PDBVIEW *fitView, REAL rm[3][3]);
+BOOL blCalcAccessView(PDBVIEW *view, REAL integrationAccuracy,
+                      REAL probeRadius, BOOL doAccessibility);
+int  blWritePDBView(FILE *fp, PDBVIEW *view);
+char *blDoPDB2SeqView(PDBVIEW *view, BOOL DoAsxGlx, BOOL ProtOnly,
+                      BOOL NoX);
+HASHTABLE *blDoPDB2SeqByChainView(PDBVIEW *view, BOOL DoAsxGlx,
+                                  BOOL ProtOnly, BOOL NoX);
+
+#endif
@@ -0,0 +1,110 @@
+/************************************************************************/
+/**
+
+   \file       resbounds.h
+
+   \version    V1.1
+   \date       17.10.26
+   \brief      Residue centroids and bounding spheres for coarse pruning
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+-  V1.1  17.10.26 Added nullAtoms and blSetResBoundRange()
+
+*************************************************************************/
+#ifndef _RESBOUNDS_H
+#define _RESBOUNDS_H
+
+/************************************************************************/
+/* Includes
+*/
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define RESBOUND_MAXSLACK ((REAL)0.5) /* Possible overestimate of a
+                                         radius after atom moves before
+                                         it is recalculated             */
+
+/* The coarse geometry of one residue                                  */
+typedef struct
+{
+   PDBRESIDUE *residue;
+   VEC3F      cg,                /* Centroid of the atoms                */
+              scCg;              /* Sidechain centroid (CA for Gly)      */
+   REAL       radius,            /* All the atoms lie within this of cg  */
+              slack,             /* Bound on the overestimate of radius  */
+              maxCovRad;         /* Largest covalent radius of the atoms */
+   int        natoms,            /* Atoms with real coordinates          */
+              nscAtoms,          /* ...of which in the sidechain         */
+              nullAtoms;         /* Atoms with NULL coordinates          */
+}  RESBOUND;
+
+/* The coarse layer for a whole PDBSTRUCT, in chain and residue order   */
+typedef struct
+{
+   PDBSTRUCT *pdbs;
+   RESBOUND  *residues;
+   int       nres;
+}  RESBOUNDS;
+
+/************************************************************************/
+/* Prototypes
+*/
+RESBOUNDS *blAllocResBounds(PDBSTRUCT *pdbs);
+void blFreeResBounds(RESBOUNDS *bounds);
+void blSetResBound(RESBOUND *rb);
+void blSetResBoundRange(RESBOUND *rb, PDBRESIDUE *res, PDB *start,
+                        PDB *stop);
+void blUpdateResBounds(RESBOUNDS *bounds);
+void blMoveAtomResBound(RESBOUND *rb, PDB *p, REAL x, REAL y, REAL z);
+void blTranslateResBounds(RESBOUNDS *bounds, VEC3F tvect);
+void blApplyMatrixResBounds(RESBOUNDS *bounds, REAL matrix[3][3]);
+BOOL blResBoundsWithin(RESBOUND *rb1, RESBOUND *rb2, REAL dist);
+BOOL blAreResBoundsBonded(RESBOUND *rb1, RESBOUND *rb2, REAL tol);
+int blIsHBondedResBounds(RESBOUND *rb1, RESBOUND *rb2, int type);
+PDB *blBuildAtomNeighbourPDBListResBounds(RESBOUNDS *bounds,
+                                          RESBOUND *rb,
+                                          REAL NeighbDist);
+
+#endif
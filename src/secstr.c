@@ -4,8 +4,8 @@
 
    \File       secstruc.c
    
-   \version    V1.3
-   \date       04.02.21
+   \version    V1.5
+   \date       17.10.26
    \brief      Secondary structure calculation
    
    \copyright  (c) Prof. Andrew C. R. Martin, UCL, 1988-2021
@@ -58,6 +58,9 @@
 -  V1.2   07.08.18 CalcDihedral() - Corrected size of dihatm[] to 4 
                    rather than NUM_DIHED_DATA
 -  V1.3   04.02.21 MakeTurnsAndBridges() - Corrected fabs() to abs()
+-  V1.4   17.10.26 blCalcSecStrucPDB() is timed when compiled with
+                   INSTRUMENT_SUPPORT
+-  V1.5   17.10.26 MakeHBonds() finds nearby residues with an atom grid
 
 *************************************************************************/
 /* Doxygen
@@ -82,7 +85,9 @@
 #include "SysDefs.h"
 #include "macros.h"
 #include "angle.h"
+#include "atomgrid.h"
 #include "secstr.h"
+#include "instrument.h"
 
 /************************************************************************/
 /* Defines and macros
@@ -279,9 +284,10 @@ static void FindChainBreaks(REAL ***mcCoords, BOOL **gotAtom,
                             BOOL caOnly, int seqlen, BOOL verbose);
 static void AddHydrogens(REAL ***mcCoords, BOOL **gotAtom, int *chainSize,
                          int numChains, BOOL verbose);
-static void MakeHBonds(REAL ***mcCoords, BOOL **gotAtom, int **hbond,
+static BOOL MakeHBonds(REAL ***mcCoords, BOOL **gotAtom, int **hbond,
                        REAL **hbondEnergy, int *residueTypes,
                        int *chainEnd, int seqlen, BOOL verbose);
+static int  CmpInt(const void *a, const void *b);
 static void CalcMCAngles(REAL ***mcCoords, REAL **mcAngles,
                          BOOL **gotAtom, int *chainSize, int numChains,
                          BOOL caOnly, int seqlen);
@@ -345,6 +351,7 @@ int blCalcSecStrucPDB(PDB *pdbStart, PDB *pdbStop, BOOL verbose)
    static char KnownResidueIndex[] = "ALAASXCYSASPGLUPHEGLYHISILEXXX\
 LYSLEUMETASNXXXPROGLNARGSERTHRXXXVALTRPXXXTYRGLXUNKPCAINI";
 
+   BLTIMERSTART(BLTIMER_SECSTR);
    seqlenMalloc = CountResidues(pdbStart, pdbStop);
 
    /* Allocate memory for arrays                                        */
@@ -411,8 +418,13 @@ CA-only. Secondary structure undefined.\n", pdbStart->chain[0]);
          AddHydrogens(mcCoords, gotAtom, chainSize, numChains, verbose);
       
          /* Sets hbond, hbondEnergy                                     */
-         MakeHBonds(mcCoords, gotAtom, hbond, hbondEnergy, residueTypes, 
-                    chainEnd, seqlen, verbose);
+         if(!MakeHBonds(mcCoords, gotAtom, hbond, hbondEnergy, 
+                        residueTypes, chainEnd, seqlen, verbose))
+         {
+            FREE_SECSTR_MEMORY;
+            BLTIMERSTOP(BLTIMER_SECSTR);
+            return(SECSTR_ERR_NOMEM);
+         }
       
          /* Sets mcAngles[]                                             */
          CalcMCAngles(mcCoords, mcAngles, gotAtom, chainSize, numChains, 
@@ -423,6 +435,7 @@ CA-only. Secondary structure undefined.\n", pdbStart->chain[0]);
                                  chainEnd, seqlen, verbose))
          {
             FREE_SECSTR_MEMORY;
+            BLTIMERSTOP(BLTIMER_SECSTR);
             return(SECSTR_ERR_NOMEM);
          }
       
@@ -442,6 +455,7 @@ CA-only. Secondary structure undefined.\n", pdbStart->chain[0]);
    }
    
    FREE_SECSTR_MEMORY;
+   BLTIMERSTOP(BLTIMER_SECSTR);
    return(retval);
 }
 
@@ -1709,7 +1723,7 @@ static void SetBendResidues(REAL **mcAngles, char **ssTable, int seqlen)
 
 
 /************************************************************************/
-/*>static void MakeHBonds(REAL ***mcCoords, BOOL **gotAtom, int **hbond,
+/*>static BOOL MakeHBonds(REAL ***mcCoords, BOOL **gotAtom, int **hbond,
                           REAL **hbondEnergy, int *residueTypes, 
                           int *chainEnd, int seqlen, BOOL verbose)
    ---------------------------------------------------------------------
@@ -1728,6 +1742,7 @@ static void SetBendResidues(REAL **mcAngles, char **ssTable, int seqlen)
                              the end of each chain
    \param[in]  seqlen        Sequence length
    \param[in]  verbose       Print messages
+   \return                   Success (FALSE if no memory)
 
    Identify mainchain hydrogen bonds. We allow each residue to make 2
    HBonds from C=O and 2 from N-H. We use the Kabsch and Sander energy 
@@ -1743,28 +1758,42 @@ static void SetBendResidues(REAL **mcAngles, char **ssTable, int seqlen)
 
    The calculations are optimised by making a distance check and residues
    must have at least 1 intervening residue. We also skip prolines as
-   donors!
+   donors! The CAs are placed on a grid so the distance check is only
+   made for residues that are close.
 
 -  19.05.99 Original   By: ACRM
 -  27.05.99 Standard format for messages
 -  13.07.15 Modified for BiopLib
+-  17.10.26 Finds the residues within HBOND_MAX_CA_DIST with an atom 
+            grid rather than checking every pair. Returns BOOL   By: ACRM
 */
-static void MakeHBonds(REAL ***mcCoords, BOOL **gotAtom, int **hbond,
+static BOOL MakeHBonds(REAL ***mcCoords, BOOL **gotAtom, int **hbond,
                        REAL **hbondEnergy, int *residueTypes,
                        int *chainEnd, int seqlen, BOOL verbose)
 {
+   ATOMGRID *grid = NULL;
    int  otherRes, 
         i, 
         nbonds, 
         firstChain, 
         otherChain, 
-        resCount;
+        resCount,
+        nneighbs,
+        nca        = 0,
+        maxNeighbs = 0,
+        *caRes     = NULL,
+        *resChain  = NULL,
+        *neighbs   = NULL;
    REAL distON, 
         distOH, 
         distCH, 
         distCN, 
         energy,
-        caDist;
+        caDist,
+        *caX       = NULL,
+        *caY       = NULL,
+        *caZ       = NULL;
+   BOOL ok         = TRUE;
    
 
    for(resCount=0; resCount<seqlen; resCount++)
@@ -1778,85 +1807,137 @@ static void MakeHBonds(REAL ***mcCoords, BOOL **gotAtom, int **hbond,
    nbonds     = 0;
    firstChain = 1;
 
+   caX      = (REAL *)malloc((seqlen+1) * sizeof(REAL));
+   caY      = (REAL *)malloc((seqlen+1) * sizeof(REAL));
+   caZ      = (REAL *)malloc((seqlen+1) * sizeof(REAL));
+   caRes    = (int  *)malloc((seqlen+1) * sizeof(int));
+   resChain = (int  *)malloc((seqlen+1) * sizeof(int));
+   if((caX == NULL) || (caY == NULL) || (caZ == NULL) ||
+      (caRes == NULL) || (resChain == NULL))
+   {
+      ok = FALSE;
+      goto Cleanup;
+   }
+
+   /* Record the chain of each residue and put the CAs on a grid so
+      that only residues with CAs within HBOND_MAX_CA_DIST are examined
+   */
+   otherChain = 1;
+   for(otherRes=0; otherRes<seqlen; otherRes++)
+   {
+      if(otherRes >= chainEnd[otherChain]) 
+         otherChain++;
+      resChain[otherRes] = otherChain;
+
+      if(gotAtom[ATOM_CA][otherRes])
+      {
+         caX[nca]     = mcCoords[ATOM_CA][otherRes][0];
+         caY[nca]     = mcCoords[ATOM_CA][otherRes][1];
+         caZ[nca]     = mcCoords[ATOM_CA][otherRes][2];
+         caRes[nca++] = otherRes;
+      }
+   }
+   if((nca > 0) &&
+      ((grid = blBuildAtomGridXYZ(caX, caY, caZ, nca, 
+                                  (REAL)HBOND_MAX_CA_DIST))==NULL))
+   {
+      ok = FALSE;
+      goto Cleanup;
+   }
+
    for(resCount=0; resCount<seqlen; resCount++)
    {
       if(resCount > chainEnd[firstChain]) 
          firstChain++;
       
-      /* Check both N and H are present                                 */
-      if(gotAtom[ATOM_N][resCount] && 
-         gotAtom[ATOM_H][resCount] &&
-         residueTypes[resCount] != RESTYPE_PROLINE)
+      /* Check N, H and CA are present                                  */
+      if(!gotAtom[ATOM_N][resCount]  || 
+         !gotAtom[ATOM_H][resCount]  ||
+         !gotAtom[ATOM_CA][resCount] ||
+         (residueTypes[resCount] == RESTYPE_PROLINE))
+         continue;
+
+      if((nneighbs = 
+          blFindAtomGridNeighbours(grid, mcCoords[ATOM_CA][resCount][0],
+                                   mcCoords[ATOM_CA][resCount][1],
+                                   mcCoords[ATOM_CA][resCount][2],
+                                   (REAL)HBOND_MAX_CA_DIST, &neighbs,
+                                   &maxNeighbs)) < 0)
       {
-         otherChain = 1;
-         for(otherRes=0; otherRes<seqlen; otherRes++)
-         {
-            if(otherRes >= chainEnd[otherChain]) 
-               otherChain++;
+         ok = FALSE;
+         goto Cleanup;
+      }
+
+      /* Take the residues in order so that the H-bonds are stored in
+         the same order as when all residues were scanned
+      */
+      for(i=0; i<nneighbs; i++)
+         neighbs[i] = caRes[neighbs[i]];
+      qsort(neighbs, nneighbs, sizeof(int), CmpInt);
 
-            if(((abs(resCount - otherRes) == 1) && 
-                (firstChain != otherChain))     ||  
-               abs(resCount - otherRes) >= 2) 
+      for(i=0; i<nneighbs; i++)
+      {
+         otherRes   = neighbs[i];
+         otherChain = resChain[otherRes];
+
+         if(((abs(resCount - otherRes) == 1) && 
+             (firstChain != otherChain))     ||  
+            abs(resCount - otherRes) >= 2) 
+         {
+            caDist = ATDIST(mcCoords[ATOM_CA][otherRes],
+                            mcCoords[ATOM_CA][resCount]);
+            if(caDist < HBOND_MAX_CA_DIST) 
             {
-               if(gotAtom[ATOM_CA][resCount] && 
-                  gotAtom[ATOM_CA][otherRes]) 
+               if(gotAtom[ATOM_C][otherRes] && 
+                  gotAtom[ATOM_O][otherRes]) 
                {
-                  caDist = ATDIST(mcCoords[ATOM_CA][otherRes],
-                                  mcCoords[ATOM_CA][resCount]);
-                  if(caDist < HBOND_MAX_CA_DIST) 
+                  distON = ATDIST(mcCoords[ATOM_O][otherRes],
+                                  mcCoords[ATOM_N][resCount]);
+                  distOH = ATDIST(mcCoords[ATOM_O][otherRes],
+                                  mcCoords[ATOM_H][resCount]);
+                  distCH = ATDIST(mcCoords[ATOM_C][otherRes],
+                                  mcCoords[ATOM_H][resCount]);
+                  distCN = ATDIST(mcCoords[ATOM_C][otherRes],
+                                  mcCoords[ATOM_N][resCount]);
+
+                  if(APPROXEQ(distON,0.0) || 
+                     APPROXEQ(distOH,0.0) ||
+                     APPROXEQ(distCH,0.0) || 
+                     APPROXEQ(distCN,0.0)) 
                   {
-                     if(gotAtom[ATOM_C][otherRes] && 
-                        gotAtom[ATOM_O][otherRes]) 
+                     if(verbose)
                      {
-                        distON = ATDIST(mcCoords[ATOM_O][otherRes],
-                                        mcCoords[ATOM_N][resCount]);
-                        distOH = ATDIST(mcCoords[ATOM_O][otherRes],
-                                        mcCoords[ATOM_H][resCount]);
-                        distCH = ATDIST(mcCoords[ATOM_C][otherRes],
-                                        mcCoords[ATOM_H][resCount]);
-                        distCN = ATDIST(mcCoords[ATOM_C][otherRes],
-                                        mcCoords[ATOM_N][resCount]);
-
-                        if(APPROXEQ(distON,0.0) || 
-                           APPROXEQ(distOH,0.0) ||
-                           APPROXEQ(distCH,0.0) || 
-                           APPROXEQ(distCN,0.0)) 
-                        {
-                           if(verbose)
-                           {
-                              fprintf(stderr,"Sec Struc: (warning) \
+                        fprintf(stderr,"Sec Struc: (warning) \
 Coincident atoms in hydrogen bonding, donor %4d acceptor %4d\n", 
-                                      resCount+1, otherRes+1);
-                           }
-                        }
-                        else
-                        {
-                           energy = HBOND_Q1 * HBOND_Q2 * HBOND_F * 
-                              (1.0/distON + 
-                               1.0/distCH - 
-                               1.0/distOH - 
-                               1.0/distCN);
+                                resCount+1, otherRes+1);
+                     }
+                  }
+                  else
+                  {
+                     energy = HBOND_Q1 * HBOND_Q2 * HBOND_F * 
+                        (1.0/distON + 
+                         1.0/distCH - 
+                         1.0/distOH - 
+                         1.0/distCN);
 
-                           if(energy < HBOND_ENERGY_LIMIT) 
-                           {
-                              if(verbose)
-                              {
-                                 fprintf(stderr,"Sec Struc: (warning) \
+                     if(energy < HBOND_ENERGY_LIMIT) 
+                     {
+                        if(verbose)
+                        {
+                           fprintf(stderr,"Sec Struc: (warning) \
 Atom indices %d and %d too close O-N: %8.3f C-H: %8.3f O-H: %8.3f \
 C-N: %8.3f\n", 
-                                         resCount+1, otherRes+1, 
-                                         distON, distCH, distOH, distCN);
-                              }
-                              energy = HBOND_ENERGY_LIMIT;
-                           }
-
-                           if(energy < MAX_HBOND_ENERGY) 
-                           {
-                              SetHBond(hbondEnergy, hbond, energy, 
-                                       resCount, otherRes, &nbonds,
-                                       verbose);
-                           }
+                                   resCount+1, otherRes+1, 
+                                   distON, distCH, distOH, distCN);
                         }
+                        energy = HBOND_ENERGY_LIMIT;
+                     }
+
+                     if(energy < MAX_HBOND_ENERGY) 
+                     {
+                        SetHBond(hbondEnergy, hbond, energy, 
+                                 resCount, otherRes, &nbonds,
+                                 verbose);
                      }
                   }
                }
@@ -1870,6 +1951,32 @@ C-N: %8.3f\n",
       fprintf(stderr,"Sec Struc: (info) Total Number of H-bonds: %5d\n",
               nbonds);
    }
+
+Cleanup:
+   if(grid != NULL)
+      blFreeAtomGrid(grid);
+   FREE(neighbs);
+   FREE(caX);
+   FREE(caY);
+   FREE(caZ);
+   FREE(caRes);
+   FREE(resChain);
+
+   return(ok);
+}
+
+
+/************************************************************************/
+/*>static int CmpInt(const void *a, const void *b)
+   -----------------------------------------------
+*//**
+   qsort() comparison of ints
+
+-  17.10.26 Original   By: ACRM
+*/
+static int CmpInt(const void *a, const void *b)
+{
+   return(*(int *)a - *(int *)b);
 }
 
 
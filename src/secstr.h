@@ -3,8 +3,8 @@
 
    \file       secstr.h
    
-   \version    V1.0
-   \date       10.07.15
+   \version    V1.1
+   \date       17.10.26
    \brief      Header for secondary structure calculation
    
    \copyright  (c) Dr. Andrew C. R. Martin, UCL, 1988-2015
@@ -46,6 +46,8 @@
 
    Revision History:
    =================
+-  V1.0  10.07.15 Original
+-  V1.1  17.10.26 Added SECSTR_ISHELIX() and SECSTR_ISSTRAND()   By: ACRM
 
 *************************************************************************/
 /* Includes
@@ -80,6 +82,14 @@
 #define SECSTR_3_10            'G'
 #define SECSTR_3_10_SMALL      'g'
 
+/* Tests for a helix or strand symbol as set in the secstr field of the
+   PDB structure. The lower case symbols mark the ends of an element
+*/
+#define SECSTR_ISHELIX(c)  (((c) == SECSTR_HELIX)   ||                   \
+                            ((c) == SECSTR_HELIX_SMALL))
+#define SECSTR_ISSTRAND(c) (((c) == SECSTR_SHEET)   ||                   \
+                            ((c) == SECSTR_SHEET_SMALL))
+
 #define SECSTR_ERR_NOERR       0
 #define SECSTR_ERR_NOMEM       (-1)
 
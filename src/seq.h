@@ -3,11 +3,11 @@
 
    \file       seq.h
    
-   \version    V2.18
-   \date       13.06.22
+   \version    V2.19
+   \date       17.10.26
    \brief      Header file for sequence handling
    
-   \copyright  (c) UCL / Prof. Andrew C. R. Martin 1991-2022
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 1991-2026
    \author     Prof. Andrew C. R. Martin
    \par
                Institute of Structural & Molecular Biology,
@@ -71,6 +71,7 @@
                   prototype
 -  V2.17 02.05.18 Added blFreeMDM()
 -  V2.18 13.06.22 Added blAffinealignWindow() and blAffinealignucWindow()
+-  V2.19 17.10.26 Added MDMATRIX and the functions using it   By: ACRM
 
 *************************************************************************/
 #ifndef _SEQ_H
@@ -104,6 +105,22 @@ typedef struct
         source[160];
 }  SEQINFO;
 
+/* A mutation data (scoring) matrix. Residues are looked up through
+   code[] (or codeUC[] which ignores case) to give an index into the
+   score[] table which has (size+1)*(size+1) entries. The last row and
+   column score zero and are used for residues not in the matrix
+*/
+typedef struct
+{
+   int  *score,            /* Flattened score table                     */
+        size,              /* Number of residue types                   */
+        code[256],         /* Residue character to index                */
+        codeUC[256];       /* As code[], but upcases the residue        */
+   char *aaList;           /* The residue types (NULL if numeric)       */
+}  MDMATRIX;
+
+#define blMDMATRIXCELL(mdm, i, j) ((mdm)->score[(i)*((mdm)->size+1)+(j)])
+
 extern BOOL gBioplibSeqNucleicAcid;
 
 #define blPDB2Seq(x)         blDoPDB2Seq((x), FALSE, FALSE, FALSE)
@@ -169,6 +186,36 @@ int blNumericAffineAlign(int *seq1, int length1, int *seq2, int length2,
                          int penext, int *align1, int *align2, 
                          int *align_len);
 void blSetMDMScoreWeight(char resa, char resb, REAL weight);
+MDMATRIX *blReadMDMatrix(char *mdmfile);
+MDMATRIX *blNumericReadMDMatrix(char *mdmfile);
+MDMATRIX *blAllocMDMatrix(int size, BOOL withList);
+void blFreeMDMatrix(MDMATRIX *mdm);
+MDMATRIX *blGetDefaultMDMatrix(void);
+MDMATRIX *blGetDefaultNumericMDMatrix(void);
+int blMDMatrixScore(MDMATRIX *mdm, char resa, char resb);
+int blMDMatrixScoreUC(MDMATRIX *mdm, char resa, char resb);
+int blZeroMDMatrix(MDMATRIX *mdm);
+BOOL blSetMDMatrixScoreWeight(MDMATRIX *mdm, char resa, char resb, 
+                              REAL weight);
+int blMDMatrixAffinealign(MDMATRIX *mdm, 
+                          char *seq1, int  length1, 
+                          char *seq2, int  length2, 
+                          BOOL verbose, BOOL identity,
+                          int  penalty, int penext, int window,
+                          char *align1, char *align2, int  *align_len);
+int blMDMatrixAffinealignuc(MDMATRIX *mdm, 
+                            char *seq1, int  length1, 
+                            char *seq2, int  length2, 
+                            BOOL verbose, BOOL identity,
+                            int  penalty, int penext, int window,
+                            char *align1, char *align2, int  *align_len);
+int blNumericMDMatrixAffineAlign(MDMATRIX *mdm,
+                                 int *seq1, int length1, 
+                                 int *seq2, int length2, 
+                                 BOOL verbose, BOOL identity, 
+                                 int penalty, int penext, 
+                                 int *align1, int *align2, 
+                                 int *align_len);
 void blWriteOneStringPIR(FILE *out, char *label, char *title, 
                          char *sequence,
                          char **chains, BOOL ByChain, BOOL doFasta);
@@ -0,0 +1,138 @@
+/************************************************************************/
+/**
+
+   \file       seqcluster.h
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      K-mer index and greedy redundancy clustering of
+               sequences
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+#ifndef _SEQCLUSTER_H
+#define _SEQCLUSTER_H
+
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+#include "seq.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define SEQIDX_MAXWORD   5       /* Longest k-mer                       */
+#define SEQIDX_DEFWORD   4       /* Default k-mer length                */
+#define SEQIDX_GAPOPEN   10      /* Gap penalties for the alignments    */
+#define SEQIDX_GAPEXT    2
+#define SEQCLUST_BATCH   512     /* Sequences compared at once with the
+                                    existing representatives            */
+
+/* An index of sequences. The postings are rebuilt when the index is
+   searched or clustered after sequences have been added
+*/
+typedef struct
+{
+   char **ids,
+        **chains,
+        **seqs;                  /* Upper case copies                   */
+   int  *lengths,
+        *nwords,                 /* k-mers of the 20 standard residues  */
+        *wordStart,              /* nwordTypes+1 offsets into postings  */
+        *postings,               /* Sequences containing each k-mer,
+                                    once per occurrence, in order       */
+        nseqs,
+        maxseqs,
+        maxlen,
+        wordSize,
+        nwordTypes;              /* 20^wordSize                         */
+   BOOL dirty;
+}  SEQINDEX;
+
+/* A search hit                                                        */
+typedef struct _seqhit
+{
+   struct _seqhit *next;
+   char *id,                     /* Point into the index                */
+        *chain;
+   REAL identity;                /* Over the shorter sequence           */
+   int  entry;
+}  SEQHIT;
+
+/* The result of clustering. Clusters are numbered in the order their
+   representatives were chosen: longest first
+*/
+typedef struct
+{
+   int   *cluster,               /* Cluster of each sequence            */
+         *rep,                   /* Representative of each cluster      */
+         *size,                  /* Number of members of each cluster   */
+         nseqs,
+         nclusters;
+   REAL  *identity;              /* Of each sequence to its
+                                    representative                      */
+   ULONG nalign;                 /* Alignments needed                   */
+}  SEQCLUSTERS;
+
+/************************************************************************/
+/* Prototypes
+*/
+int blSeqIndexWordSize(REAL minIdentity);
+SEQINDEX *blAllocSeqIndex(int wordSize);
+void blFreeSeqIndex(SEQINDEX *index);
+BOOL blAddSeqIndex(SEQINDEX *index, char *id, char *chain, char *seq);
+int blAddSeqIndexPDB(SEQINDEX *index, char *id, PDB *pdb);
+int blAddSeqIndexFASTA(SEQINDEX *index, FILE *fp);
+SEQHIT *blSearchSeqIndex(SEQINDEX *index, MDMATRIX *mdm, char *query,
+                         REAL minIdentity, int *nhits);
+void blFreeSeqHits(SEQHIT *hits);
+SEQCLUSTERS *blClusterSeqIndex(SEQINDEX *index, MDMATRIX *mdm,
+                               REAL minIdentity, int nthreads);
+void blFreeSeqClusters(SEQCLUSTERS *clusters);
+BOOL blPrintSeqClusters(FILE *fp, SEQINDEX *index,
+                        SEQCLUSTERS *clusters);
+
+#endif
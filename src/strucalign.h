@@ -0,0 +1,124 @@
+/************************************************************************/
+/**
+
+   \file       strucalign.h
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Sequence-independent structural alignment
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+#ifndef _STRUCALIGN_H
+#define _STRUCALIGN_H
+
+/************************************************************************/
+/* Includes
+*/
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define SA_MAXITER    20         /* Max DP/superposition cycles         */
+#define SA_GAPOPEN    ((REAL)(-0.6)) /* Gap penalty on the TM scores    */
+#define SA_SSGAP      ((REAL)(-1.0)) /* Gap penalty for the SSE seed    */
+
+/* The C-alphas of a structure ready for alignment                     */
+typedef struct
+{
+   COOR *ca;
+   PDB  **atoms;                     /* CA atoms in the linked list     */
+   char *ss;                         /* 'H', 'E' or '-' per residue     */
+   int  length;
+}  SACHAIN;
+
+/* Arrays reused from one alignment to the next                        */
+typedef struct
+{
+   REAL *score,                      /* max1 x max2                     */
+        *val;                        /* (max1+1) x (max2+1)             */
+   char *path;                       /* (max1+1) x (max2+1)             */
+   COOR *moved,                      /* max2 target coordinates         */
+        *fit1,
+        *fit2;
+   int  *map,                        /* max1 elements each              */
+        *newMap,
+        *bestMap,
+        *pairs,
+        *keep,
+        max1,
+        max2;
+}  SAWORKSPACE;
+
+/* The result of aligning a target to a query. The target is
+   superimposed with x' = rm.(x - cgTarget) + cgQuery
+*/
+typedef struct
+{
+   int   *map;            /* Caller's array of query->length elements
+                             (or NULL): the target residue aligned with
+                             each query residue or -1                   */
+   REAL  tmscore,         /* Normalized by the query length             */
+         rmsd,            /* Over all the aligned pairs                 */
+         rm[3][3];
+   VEC3F cgQuery,
+         cgTarget;
+   int   naligned;
+}  SARESULT;
+
+/************************************************************************/
+/* Prototypes
+*/
+SACHAIN *blPrepareSAChain(PDB *pdb);
+void blFreeSAChain(SACHAIN *chain);
+SAWORKSPACE *blAllocSAWorkspace(int max1, int max2);
+void blFreeSAWorkspace(SAWORKSPACE *ws);
+BOOL blStructureAlign(SACHAIN *query, SACHAIN *target, SAWORKSPACE *ws,
+                      SARESULT *result);
+int blStructureAlignLibrary(SACHAIN *query, SACHAIN **library,
+                            int nlib, SARESULT *results, int nthreads);
+void blApplySAResultPDB(PDB *pdb, SARESULT *result);
+
+#endif
@@ -0,0 +1,68 @@
+/************************************************************************/
+/**
+
+   \file       threadpool.h
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Running a worker function on a pool of threads
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+#ifndef _THREADPOOL_H
+#define _THREADPOOL_H
+
+/************************************************************************/
+/* Includes
+*/
+#include <stddef.h>
+#include "SysDefs.h"
+
+/************************************************************************/
+/* Prototypes
+*/
+void blRunThreadPool(void *(*worker)(void *), void *args, size_t argSize,
+                     int nthreads);
+int  blThreadPoolIncrement(int *counter);
+
+#endif
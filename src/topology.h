@@ -0,0 +1,123 @@
+/************************************************************************/
+/**
+
+   \file       topology.h
+
+   \version    V1.0
+   \date       17.10.26
+   \brief      Secondary structure topology strings and index
+
+   \copyright  (c) UCL / Prof. Andrew C. R. Martin 2026
+   \author     Prof. Andrew C. R. Martin
+   \par
+               Institute of Structural & Molecular Biology,
+               University College London,
+               Gower Street,
+               London.
+               WC1E 6BT.
+   \par
+               andrew@bioinf.org.uk
+               andrew.martin@ucl.ac.uk
+
+**************************************************************************
+
+   This code is NOT IN THE PUBLIC DOMAIN, but it may be copied
+   according to the conditions laid out in the accompanying file
+   COPYING.DOC.
+
+   The code may be modified as required, but any modifications must be
+   documented so that the person responsible can be identified.
+
+   The code may not be sold commercially or included as part of a
+   commercial product except as described in the file COPYING.DOC.
+
+**************************************************************************
+
+   Description:
+   ============
+
+**************************************************************************
+
+   Usage:
+   ======
+
+**************************************************************************
+
+   Revision History:
+   =================
+-  V1.0  17.10.26 Original   By: ACRM
+
+*************************************************************************/
+#ifndef _TOPOLOGY_H
+#define _TOPOLOGY_H
+
+/************************************************************************/
+/* Includes
+*/
+#include <stdio.h>
+#include "SysDefs.h"
+#include "MathType.h"
+#include "pdb.h"
+#include "seq.h"
+
+/************************************************************************/
+/* Defines and macros
+*/
+#define TOPO_MATFILE      "topmat.mat"  /* Topology scoring matrix      */
+#define TOPO_GAPOPEN      10     /* Gap penalties for the alignment     */
+#define TOPO_GAPEXT       2
+#define TOPO_MINHELIX     5      /* Shortest helix used as an SSE       */
+#define TOPO_MINSTRAND    3      /* Shortest strand used as an SSE      */
+#define TOPO_ADJACENTDIST ((REAL)7.0)  /* CA-CA distance for adjacent   */
+#define TOPO_BURIEDCOUNT  ((REAL)20.0) /* Mean CAs within 10A: buried   */
+#define TOPO_DEFLENRATIO  ((REAL)2.0)  /* Default prefilter settings    */
+#define TOPO_DEFMINSHARED ((REAL)0.3)
+#define TOPO_NKMERS       144    /* Pairs of the 12 (SSE, direction)    */
+
+/* An index of topology strings. The postings and length order are
+   rebuilt when the index is searched after entries have been added
+*/
+typedef struct
+{
+   char **ids,
+        **chains,
+        **topologies;
+   int  *lengths,
+        *order,                  /* Entries sorted by length            */
+        *kmerStart,              /* TOPO_NKMERS+1 offsets into postings */
+        *postings,               /* Entries containing each 2-mer       */
+        nentries,
+        maxentries;
+   REAL lenRatio,                /* Max ratio of entry to query length  */
+        minShared;               /* Min fraction of query 2-mers shared */
+   BOOL dirty;
+}  TOPOINDEX;
+
+/* A search hit                                                        */
+typedef struct _topohit
+{
+   struct _topohit *next;
+   char *id,                     /* Point into the index                */
+        *chain,
+        *topology;
+   REAL score;                   /* Score / query self-score            */
+   int  entry,
+        rawScore;
+}  TOPOHIT;
+
+/************************************************************************/
+/* Prototypes
+*/
+char *blTopologyStringPDB(PDB *pdbStart, PDB *pdbStop);
+TOPOINDEX *blAllocTopologyIndex(void);
+void blFreeTopologyIndex(TOPOINDEX *index);
+BOOL blAddTopologyIndex(TOPOINDEX *index, char *id, char *chain,
+                        char *topology);
+int blAddTopologyIndexPDB(TOPOINDEX *index, char *id, PDB *pdb);
+TOPOINDEX *blReadTopologyIndex(FILE *fp);
+void blWriteTopologyIndex(FILE *fp, TOPOINDEX *index);
+TOPOHIT *blSearchTopologyIndex(TOPOINDEX *index, MDMATRIX *mdm,
+                               char *query, REAL minScore, int *nhits);
+void blFreeTopologyHits(TOPOHIT *hits);
+
+#endif